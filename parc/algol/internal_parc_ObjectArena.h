@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file internal_parc_ObjectArena.h
+ * @brief The interface between `PARCObjectArena` and the PARCObject implementation.
+ *
+ * Every instance allocated from an arena is preceded by an `internal_PARCObjectArenaLink`.
+ * The instances that must be destroyed when the arena is released are kept on a list threaded through these links.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libparc_internal_parc_ObjectArena_h
+#define libparc_internal_parc_ObjectArena_h
+
+#include <parc/algol/parc_ObjectArena.h>
+
+typedef struct internal_parc_object_arena_link {
+    PARCObjectArena *arena;
+    struct internal_parc_object_arena_link *next;
+} internal_PARCObjectArenaLink;
+
+/**
+ * Allocate @p length bytes, aligned on a `sizeof(void *)` boundary, from the given arena.
+ *
+ * @param [in] arena A pointer to a valid `PARCObjectArena` instance.
+ * @param [in] length The number of bytes to allocate.
+ *
+ * @return A pointer to the allocated memory, or NULL if the arena could not obtain more memory.
+ */
+void *internal_parcObjectArena_Allocate(PARCObjectArena *arena, size_t length);
+
+/**
+ * Add the memory, previously returned by `internal_parcObjectArena_Allocate`,
+ * to the list of those finalized when its arena is released.
+ *
+ * Any thread may register memory, but each may be registered only once.
+ *
+ * @param [in] memory A pointer returned by `internal_parcObjectArena_Allocate`.
+ */
+void internal_parcObjectArena_Register(void *memory);
+
+/**
+ * Destroy the PARCObject that occupies the given memory, if it has not already been destroyed.
+ *
+ * This is implemented by the PARCObject implementation and called for each registered memory when an arena is released.
+ *
+ * @param [in] memory A pointer returned by `internal_parcObjectArena_Allocate`.
+ */
+void internal_parcObject_Finalize(void *memory);
+#endif
@@ -275,6 +275,14 @@ parcArrayList_Size(const PARCArrayList *pointerArray)
     return pointerArray->numberOfElements;
 }
 
+void
+parcArrayList_InitCursor(const PARCArrayList *array, PARCCursor *cursor)
+{
+    parcArrayList_OptionalAssertValid(array);
+
+    *cursor = (PARCCursor) { .collection = array, .position = array->array, .index = 0, .limit = array->numberOfElements };
+}
+
 void
 parcArrayList_Destroy(PARCArrayList **arrayPtr)
 {
@@ -43,6 +43,7 @@
 
 #include <parc/algol/parc_List.h>
 #include <parc/algol/parc_Iterator.h>
+#include <parc/algol/parc_Cursor.h>
 
 #ifdef PARCLibrary_DISABLE_VALIDATION
 #  define parcArrayList_OptionalAssertValid(_instance_)
@@ -430,6 +431,47 @@ void *parcArrayList_Get(const PARCArrayList *array, size_t index);
  */
 size_t parcArrayList_Size(const PARCArrayList *array);
 
+/**
+ * Initialise the given cursor to visit the elements, from first to last, of the given `PARCArrayList`.
+ *
+ * The cursor is positioned before the first element.
+ * Advance it with {@link parcArrayList_CursorNext}.
+ *
+ * @param [in] array A pointer to a valid `PARCArrayList`.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcArrayList_InitCursor(array, &cursor);
+ *     while (parcArrayList_CursorNext(&cursor)) {
+ *         void *element = parcCursor_GetElement(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcArrayList_CursorNext
+ */
+void parcArrayList_InitCursor(const PARCArrayList *array, PARCCursor *cursor);
+
+/**
+ * Advance the given cursor to the next element of its `PARCArrayList`.
+ *
+ * @param [in,out] cursor A pointer to a `PARCCursor` initialised by {@link parcArrayList_InitCursor}.
+ *
+ * @return true The cursor is at the next element.
+ * @return false There are no more elements.
+ */
+static inline bool
+parcArrayList_CursorNext(PARCCursor *cursor)
+{
+    bool result = cursor->index < cursor->limit;
+    if (result) {
+        cursor->element = ((void **) cursor->position)[cursor->index++];
+    }
+    return result;
+}
+
 /**
  * Determine if two `PARCArrayList` instances are equal.
  *
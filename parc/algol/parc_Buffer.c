@@ -61,6 +61,26 @@ struct parc_buffer {
      * If the mark is not defined then invoking the reset function causes a trap.
      */
     size_t mark;
+
+    /**
+     * True if the backing array was allocated by and for this buffer, rather than wrapped or shared with another buffer.
+     */
+    bool ownsArray;
+
+    /**
+     * The hash code of the bytes between hashCodePosition and hashCodeLimit, valid if hashCodeIsValid is true.
+     * It is remembered only while no other buffer shares the backing array,
+     * and forgotten by every function that writes to the array or gives out its address.
+     *
+     * Functions taking a const buffer update these fields, and may be called by several threads at once,
+     * so they are accessed atomically under hashCodeSequence, which is odd while a thread updates them.
+     * A reader that sees the sequence change treats the hash code as unknown.
+     */
+    unsigned int hashCodeSequence;
+    bool hashCodeIsValid;
+    size_t hashCodePosition;
+    size_t hashCodeLimit;
+    PARCHashCode hashCode;
 };
 
 static inline void
@@ -69,6 +89,77 @@ _discardMark(PARCBuffer *buffer)
     buffer->mark = SIZE_MAX;
 }
 
+/*
+ * Begin updating the remembered hash code, returning false if another thread is already updating it.
+ */
+static inline bool
+_beginHashCodeUpdate(const PARCBuffer *buffer, unsigned int *sequence)
+{
+    PARCBuffer *mutable = (PARCBuffer *) buffer;
+    *sequence = __atomic_load_n(&mutable->hashCodeSequence, __ATOMIC_RELAXED);
+    bool result = (*sequence & 1) == 0
+                  && __atomic_compare_exchange_n(&mutable->hashCodeSequence, sequence, *sequence + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    if (result) {
+        // Keep the updates from becoming visible before the odd sequence does.
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    return result;
+}
+
+static inline void
+_endHashCodeUpdate(const PARCBuffer *buffer, unsigned int sequence)
+{
+    __atomic_store_n(&((PARCBuffer *) buffer)->hashCodeSequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+static inline void
+_forgetHashCode(const PARCBuffer *buffer)
+{
+    // Nothing is remembered, which is usual while a buffer is being filled.
+    if ((__atomic_load_n(&buffer->hashCodeSequence, __ATOMIC_ACQUIRE) & 1) == 0
+        && !__atomic_load_n(&buffer->hashCodeIsValid, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    unsigned int sequence;
+    while (!_beginHashCodeUpdate(buffer, &sequence)) {
+        // Another thread is remembering a hash code, which takes only a few stores.
+    }
+    __atomic_store_n(&((PARCBuffer *) buffer)->hashCodeIsValid, false, __ATOMIC_RELAXED);
+    _endHashCodeUpdate(buffer, sequence);
+}
+
+/*
+ * The contents of a buffer can change without it knowing if its backing array was wrapped from the caller's memory,
+ * or if another buffer or the caller holds a reference to the array.
+ */
+static inline bool
+_hashCodeIsCacheable(const PARCBuffer *buffer)
+{
+    return buffer->ownsArray && parcObject_GetReferenceCount(buffer->array) == 1;
+}
+
+/*
+ * Get the remembered hash code, returning false if there is none for the buffer's current position and limit.
+ */
+static inline bool
+_getHashCode(const PARCBuffer *buffer, PARCHashCode *hashCode)
+{
+    unsigned int sequence = __atomic_load_n(&buffer->hashCodeSequence, __ATOMIC_ACQUIRE);
+    bool isValid = __atomic_load_n(&buffer->hashCodeIsValid, __ATOMIC_RELAXED);
+    size_t position = __atomic_load_n(&buffer->hashCodePosition, __ATOMIC_RELAXED);
+    size_t limit = __atomic_load_n(&buffer->hashCodeLimit, __ATOMIC_RELAXED);
+    *hashCode = __atomic_load_n(&buffer->hashCode, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return (sequence & 1) == 0
+           && __atomic_load_n(&buffer->hashCodeSequence, __ATOMIC_RELAXED) == sequence
+           && isValid
+           && position == buffer->position
+           && limit == buffer->limit
+           && _hashCodeIsCacheable(buffer);
+}
+
 static inline bool
 _markIsDiscarded(const PARCBuffer *buffer)
 {
@@ -100,6 +191,15 @@ _effectivePosition(const PARCBuffer *buffer)
     return buffer->arrayOffset + parcBuffer_Position(buffer);
 }
 
+/*
+ * The address of the byte at the buffer's position, for functions that only read the buffer's contents.
+ */
+static inline const uint8_t *
+_remainingBytes(const PARCBuffer *buffer)
+{
+    return parcByteArray_AddressOfIndex(buffer->array, _effectivePosition(buffer));
+}
+
 #ifdef PARCLibrary_DISABLE_VALIDATION
 #  define _optionalAssertInvariants(_instance_)
 #else
@@ -277,6 +377,9 @@ _parcBuffer_Init(PARCBuffer *result, PARCByteArray *array, size_t offset, size_t
     result->limit = limit;
     result->capacity = capacity;
     _discardMark(result);
+    result->ownsArray = false;
+    result->hashCodeSequence = 0;
+    result->hashCodeIsValid = false;
 
     parcBuffer_OptionalAssertValid(result);
 
@@ -378,6 +481,8 @@ parcBuffer_Resize(PARCBuffer *buffer, size_t newCapacity)
     parcByteArray_Release(&buffer->array);
 
     buffer->array = newArray;
+    buffer->ownsArray = true;
+    _forgetHashCode(buffer);
     buffer->arrayOffset = 0;
     buffer->limit = _computeNewLimit(buffer->capacity, buffer->limit, newCapacity);
     buffer->mark = _computeNewMark(buffer->mark, buffer->limit, newCapacity);
@@ -397,7 +502,9 @@ parcBuffer_Allocate(size_t capacity)
     if (array != NULL) {
         PARCBuffer *result = _parcBuffer_getInstance();
         if (result != NULL) {
-            return _parcBuffer_Init(result, array, 0, 0, capacity, capacity);
+            _parcBuffer_Init(result, array, 0, 0, capacity, capacity);
+            result->ownsArray = true;
+            return result;
         }
         parcByteArray_Release(&array);
     }
@@ -503,6 +610,13 @@ parcBuffer_Equals(const PARCBuffer *x, const PARCBuffer *y)
         return false;
     }
 
+    // Buffers with different remembered hash codes cannot be equal.
+    PARCHashCode xHashCode;
+    PARCHashCode yHashCode;
+    if (_getHashCode(x, &xHashCode) && _getHashCode(y, &yHashCode) && xHashCode != yHashCode) {
+        return false;
+    }
+
     return (parcBuffer_Compare(x, y) == 0);
 }
 
@@ -529,7 +643,7 @@ parcBuffer_Compare(const PARCBuffer *x, const PARCBuffer *y)
     int result = 0;
 
     if (count > 0) {
-        result = memcmp(parcBuffer_Overlay((PARCBuffer *) x, 0), parcBuffer_Overlay((PARCBuffer *) y, 0), count);
+        result = memcmp(_remainingBytes(x), _remainingBytes(y), count);
     }
 
     if (result == 0) {
@@ -550,12 +664,16 @@ parcBuffer_Array(const PARCBuffer *buffer)
 {
     parcBuffer_OptionalAssertValid(buffer);
 
+    _forgetHashCode(buffer);
+
     return buffer->array;
 }
 
 PARCBuffer *
 parcBuffer_Duplicate(const PARCBuffer *original)
 {
+    _forgetHashCode(original);
+
     PARCBuffer *result = _parcBuffer_getInstance();
     if (result != NULL) {
         _parcBuffer_Init(result,
@@ -573,6 +691,8 @@ parcBuffer_Duplicate(const PARCBuffer *original)
 PARCBuffer *
 parcBuffer_Slice(const PARCBuffer *original)
 {
+    _forgetHashCode(original);
+
     PARCBuffer *result = _parcBuffer_getInstance();
     if (result != NULL) {
         _parcBuffer_Init(result,
@@ -719,6 +839,7 @@ parcBuffer_Copy(const PARCBuffer *original)
                              parcBuffer_Position(original),
                              parcBuffer_Limit(original),
                              parcBuffer_Capacity(original));
+            result->ownsArray = true;
         } else {
             parcBuffer_Release(&result);
         }
@@ -757,6 +878,7 @@ parcBuffer_Overlay(PARCBuffer *buffer, size_t length)
     parcBuffer_OptionalAssertValid(buffer);
     _trapIfBufferUnderflow(buffer, length);
 
+    _forgetHashCode(buffer);
     uint8_t *result = parcByteArray_AddressOfIndex(buffer->array, _effectiveIndex(buffer, parcBuffer_Position(buffer)));
     buffer->position += length;
     return result;
@@ -824,6 +946,7 @@ parcBuffer_PutUint8(PARCBuffer *buffer, uint8_t value)
     assertTrue(parcBuffer_Remaining(buffer) >= 1,
                "Buffer overflow");
 
+    _forgetHashCode(buffer);
     parcByteArray_PutByte(buffer->array, _effectivePosition(buffer), value);
     buffer->position++;
     return buffer;
@@ -872,6 +995,7 @@ parcBuffer_PutAtIndex(PARCBuffer *buffer, size_t index, uint8_t value)
     parcBuffer_OptionalAssertValid(buffer);
     assertTrue(_effectiveIndex(buffer, index) < parcBuffer_Limit(buffer), "Buffer overflow");
 
+    _forgetHashCode(buffer);
     parcByteArray_PutByte(buffer->array, _effectiveIndex(buffer, index), value);
     return buffer;
 }
@@ -883,6 +1007,7 @@ parcBuffer_PutArray(PARCBuffer *buffer, size_t arrayLength, const uint8_t array[
     assertTrue(parcBuffer_Remaining(buffer) >= arrayLength,
                "Buffer overflow");
 
+    _forgetHashCode(buffer);
     parcByteArray_PutBytes(buffer->array, _effectivePosition(buffer), arrayLength, array);
     return parcBuffer_SetPosition(buffer, parcBuffer_Position(buffer) + arrayLength);
 }
@@ -901,6 +1026,7 @@ parcBuffer_PutBuffer(PARCBuffer *result, const PARCBuffer *buffer)
                "Buffer overflow. %zd bytes remaining, %zd required.", parcBuffer_Remaining(result), parcBuffer_Remaining(buffer));
 
     size_t length = parcBuffer_Remaining(buffer);
+    _forgetHashCode(result);
     parcByteArray_ArrayCopy(result->array, _effectivePosition(result), buffer->array, _effectivePosition(buffer), length);
     parcBuffer_SetPosition(result, parcBuffer_Position(result) + length);
     return result;
@@ -910,10 +1036,25 @@ PARCHashCode
 parcBuffer_HashCode(const PARCBuffer *buffer)
 {
     PARCHashCode result = 0;
+    if (_getHashCode(buffer, &result)) {
+        return result;
+    }
+    result = 0;
 
     size_t remaining = parcBuffer_Remaining(buffer);
     if (remaining > 0) {
-        result = parcHashCode_Hash(parcBuffer_Overlay((PARCBuffer *) buffer, 0), parcBuffer_Remaining(buffer));
+        result = parcHashCode_Hash(_remainingBytes(buffer), remaining);
+    }
+
+    // If another thread is remembering the hash code already, leave it to that thread.
+    unsigned int sequence;
+    if (_hashCodeIsCacheable(buffer) && _beginHashCodeUpdate(buffer, &sequence)) {
+        PARCBuffer *mutable = (PARCBuffer *) buffer;
+        __atomic_store_n(&mutable->hashCode, result, __ATOMIC_RELAXED);
+        __atomic_store_n(&mutable->hashCodePosition, buffer->position, __ATOMIC_RELAXED);
+        __atomic_store_n(&mutable->hashCodeLimit, buffer->limit, __ATOMIC_RELAXED);
+        __atomic_store_n(&mutable->hashCodeIsValid, true, __ATOMIC_RELAXED);
+        _endHashCodeUpdate(buffer, sequence);
     }
     return result;
 }
@@ -938,7 +1079,7 @@ parcBuffer_ToString(const PARCBuffer *buffer)
     if (remaining > 0) {
         assertNotNull(result, "parcMemory_Allocate returned NULL");
         if (result != NULL) {
-            memcpy(result, parcBuffer_Overlay((PARCBuffer *) buffer, 0), remaining);
+            memcpy(result, _remainingBytes(buffer), remaining);
         }
     }
     result[remaining] = 0;
@@ -1390,6 +1390,12 @@ PARCBuffer *parcBuffer_PutBuffer(PARCBuffer *buffer, const PARCBuffer *source);
  * Because `PARCBuffer` hash codes are content-dependent, be careful when using them as keys in `PARCHashMap`
  * and other similar data structures unless it is known that their contents will not change.
  *
+ * A buffer that allocated its own memory, and shares it with no other buffer, remembers its hash code
+ * until its contents change or its position or limit move.
+ * Writes made through the `PARCByteArray` returned by {@link parcBuffer_Array} or the memory returned by
+ * {@link parcBuffer_Overlay} are seen only if they are made before the next call to `parcBuffer_HashCode`.
+ * Threads sharing a buffer that none of them modifies may call `parcBuffer_HashCode` and {@link parcBuffer_Equals} on it concurrently.
+ *
  * The general contract of `HashCode` is:
  *
  * Whenever it is invoked on the same instance more than once during an execution of an application,
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_Cursor.h
+ * @ingroup memory
+ * @brief A position in a collection that lives on the caller's stack.
+ *
+ * A PARCCursor visits the elements of a collection without allocating memory
+ * and without calling through function pointers.
+ * The collection initialises the cursor in place and provides a `next` function which advances it,
+ * returning false when there are no more elements.
+ * Maps set both the key and the value of the entry at the cursor.
+ *
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcLinkedList_InitCursor(list, &cursor);
+ *     while (parcLinkedList_CursorNext(&cursor)) {
+ *         PARCObject *element = parcCursor_GetElement(&cursor);
+ *         ...
+ *     }
+ * }
+ * @endcode
+ *
+ * A cursor holds no reference to its collection or to the elements it visits.
+ * Modifying the collection while a cursor is in use invalidates the cursor,
+ * unless the collection documents otherwise.
+ * Use a PARCIterator to remove elements while iterating.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libparc_parc_Cursor_h
+#define libparc_parc_Cursor_h
+
+#include <stddef.h>
+
+/**
+ * The fields are private to the collection that initialised the cursor.
+ */
+typedef struct parc_cursor {
+    const void *collection;
+    void *position;
+    size_t index;
+    size_t limit;
+    void *element;
+    void *value;
+} PARCCursor;
+
+/**
+ * Get the element at the given cursor.
+ *
+ * The result is valid only after the collection's `next` function returned true.
+ *
+ * @param [in] cursor A pointer to a PARCCursor.
+ *
+ * @return The element at the cursor, which the caller does not own.
+ */
+static inline void *
+parcCursor_GetElement(const PARCCursor *cursor)
+{
+    return cursor->element;
+}
+
+/**
+ * Get the key of the map entry at the given cursor.
+ *
+ * @param [in] cursor A pointer to a PARCCursor initialised by a map.
+ *
+ * @return The key of the entry at the cursor, which the caller does not own.
+ */
+static inline void *
+parcCursor_GetKey(const PARCCursor *cursor)
+{
+    return cursor->element;
+}
+
+/**
+ * Get the value of the map entry at the given cursor.
+ *
+ * @param [in] cursor A pointer to a PARCCursor initialised by a map.
+ *
+ * @return The value of the entry at the cursor, which the caller does not own.
+ */
+static inline void *
+parcCursor_GetValue(const PARCCursor *cursor)
+{
+    return cursor->value;
+}
+#endif // libparc_parc_Cursor_h
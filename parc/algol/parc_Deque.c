@@ -33,7 +33,7 @@
 #include <LongBow/runtime.h>
 
 #include <stdio.h>
-#include <sys/queue.h>
+#include <string.h>
 
 #include <parc/algol/parc_Deque.h>
 
@@ -67,16 +67,26 @@ PARCListInterface *PARCDequeAsPARCList = &(PARCListInterface) {
     .ToArray                = (void**    (*)(const void *))                               NULL,
 };
 
-struct parc_deque_node {
-    void *element;
-    struct parc_deque_node *previous;
-    struct parc_deque_node *next;
-};
+/*
+ * The elements are kept in a ring of fixed-size blocks.
+ * The ring is addressed by position, from 0 to (number of blocks * _PARCDeque_BlockSize) - 1,
+ * and the element at index i of the deque is at position (first + i) modulo the length of the ring.
+ * Both the number of blocks and the block size are powers of 2, so the modulo is a mask.
+ *
+ * A block is allocated the first time a position in it is used and is kept until the deque is destroyed,
+ * so a deque used as a queue cycles through its blocks without allocating.
+ * When the ring is full the block map doubles, keeping every block,
+ * and at most one block's worth of elements is copied.
+ */
+#define _PARCDeque_BlockShift 6
+#define _PARCDeque_BlockSize ((size_t) 1 << _PARCDeque_BlockShift)
+#define _PARCDeque_InitialBlocks 1
 
 struct parc_deque {
     PARCObjectDescriptor object;
-    struct parc_deque_node *head;
-    struct parc_deque_node *tail;
+    void ***blocks;
+    size_t blockCount;
+    size_t first;
     size_t size;
 };
 
@@ -92,52 +102,81 @@ _defaultElementEquals(const void *x, const void *y)
     return (x == y);
 }
 
-static inline struct parc_deque_node *
-_parcDequeNode_Create(void *element, struct parc_deque_node *previous, struct parc_deque_node *next)
+static inline size_t
+_parcDeque_Capacity(const PARCDeque *deque)
 {
-    struct parc_deque_node *result = parcMemory_Allocate(sizeof(struct parc_deque_node));
-    if (result != NULL) {
-        result->element = element;
-        result->next = next;
-        result->previous = previous;
-    }
+    return deque->blockCount << _PARCDeque_BlockShift;
+}
 
-    return result;
+static inline void **
+_parcDeque_Slot(const PARCDeque *deque, size_t index)
+{
+    size_t position = (deque->first + index) & (_parcDeque_Capacity(deque) - 1);
+
+    return &deque->blocks[position >> _PARCDeque_BlockShift][position & (_PARCDeque_BlockSize - 1)];
 }
 
-static void
-_parcDequeNode_Destroy(PARCDeque *deque __attribute__((unused)), struct parc_deque_node **nodePtr)
+/*
+ * Get the slot for a new element at the given index, allocating its block if this is the first use of it.
+ */
+static inline void **
+_parcDeque_NewSlot(PARCDeque *deque, size_t index)
 {
-    struct parc_deque_node *node = *nodePtr;
+    size_t position = (deque->first + index) & (_parcDeque_Capacity(deque) - 1);
+    void ***block = &deque->blocks[position >> _PARCDeque_BlockShift];
 
-    parcMemory_Deallocate((void **) &node);
-    *nodePtr = 0;
+    if (*block == NULL) {
+        *block = parcMemory_Allocate(_PARCDeque_BlockSize * sizeof(void *));
+        trapOutOfMemoryIf(*block == NULL, "Cannot allocate a block of %zu elements for PARCDeque", _PARCDeque_BlockSize);
+    }
+
+    return &(*block)[position & (_PARCDeque_BlockSize - 1)];
 }
 
+/*
+ * Double the block map of a full deque.
+ *
+ * The blocks are laid out again in order starting at the block holding the first element.
+ * That block also holds the last elements, those before the first element, which move to a new block at the end.
+ */
 static void
-_parcDequeNode_AssertInvariants(struct parc_deque_node *node)
+_parcDeque_Grow(PARCDeque *deque)
 {
-    assertNotNull(node, "Expected non-null node pointer.");
-    if (node->next != NULL) {
-        assertTrue(node->next->previous == node, "Expected next node to point to this node.");
-    }
-    if (node->previous != NULL) {
-        assertTrue(node->previous->next == node, "Expected previous node to point to this node.");
+    size_t blockCount = (deque->blockCount == 0) ? _PARCDeque_InitialBlocks : deque->blockCount * 2;
+
+    void ***blocks = parcMemory_AllocateAndClear(blockCount * sizeof(void **));
+    trapOutOfMemoryIf(blocks == NULL, "Cannot allocate a map of %zu blocks for PARCDeque", blockCount);
+
+    size_t offset = 0;
+    if (deque->blocks != NULL) {
+        size_t head = deque->first >> _PARCDeque_BlockShift;
+        offset = deque->first & (_PARCDeque_BlockSize - 1);
+
+        for (size_t i = 0; i < deque->blockCount; i++) {
+            blocks[i] = deque->blocks[(head + i) & (deque->blockCount - 1)];
+        }
+        if (offset > 0) {
+            blocks[deque->blockCount] = parcMemory_Allocate(_PARCDeque_BlockSize * sizeof(void *));
+            trapOutOfMemoryIf(blocks[deque->blockCount] == NULL, "Cannot allocate a block of %zu elements for PARCDeque", _PARCDeque_BlockSize);
+            memcpy(blocks[deque->blockCount], blocks[0], offset * sizeof(void *));
+        }
+        parcMemory_Deallocate(&deque->blocks);
     }
+
+    deque->blocks = blocks;
+    deque->blockCount = blockCount;
+    deque->first = offset;
 }
 
 static void
 _parcDeque_AssertInvariants(const PARCDeque *deque)
 {
     assertNotNull(deque, "Parameter cannot be null.");
-    if (deque->head != NULL) {
-        assertTrue(deque->size != 0, "PARCDeque head is not-null, but size is zero.");
-        assertNotNull(deque->tail, "PARCDeque head is not-null, but tail is null.");
-        _parcDequeNode_AssertInvariants(deque->head);
-        _parcDequeNode_AssertInvariants(deque->tail);
-    } else {
-        assertNull(deque->tail, "PARCDeque head is null, but tail is not null.");
-        assertTrue(deque->size == 0, "PARCDeque head is null, but size is not zero.");
+    assertTrue(deque->size <= _parcDeque_Capacity(deque),
+               "PARCDeque size %zu exceeds its capacity %zu", deque->size, _parcDeque_Capacity(deque));
+    assertTrue((deque->blockCount & (deque->blockCount - 1)) == 0, "PARCDeque block count %zu is not a power of 2", deque->blockCount);
+    if (deque->blockCount > 0) {
+        assertTrue(deque->first < _parcDeque_Capacity(deque), "PARCDeque first position is outside the ring.");
     }
 }
 
@@ -146,49 +185,55 @@ _parcDeque_Destroy(PARCDeque **dequePtr)
 {
     PARCDeque *deque = *dequePtr;
 
-    struct parc_deque_node *next = NULL; //deque->head;
-
-    for (struct parc_deque_node *node = deque->head; node != NULL; node = next) {
-        next = node->next;
-        _parcDequeNode_Destroy(deque, &node);
+    if (deque->blocks != NULL) {
+        for (size_t i = 0; i < deque->blockCount; i++) {
+            if (deque->blocks[i] != NULL) {
+                parcMemory_Deallocate(&deque->blocks[i]);
+            }
+        }
+        parcMemory_Deallocate(&deque->blocks);
     }
 }
 
-static struct parc_deque_node *
-_parcDequeNode_Init(PARCDeque *deque __attribute__((unused)))
+typedef struct {
+    size_t index;
+    void *element;
+} _PARCDequeIterator;
+
+static _PARCDequeIterator *
+_parcDequeIterator_Init(PARCDeque *deque __attribute__((unused)))
 {
-    return NULL;
+    _PARCDequeIterator *state = parcMemory_AllocateAndClear(sizeof(_PARCDequeIterator));
+    assertNotNull(state, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_PARCDequeIterator));
+
+    return state;
 }
 
 static bool
-_parcDequeNode_Fini(PARCDeque *deque __attribute__((unused)), const struct parc_deque_node *node __attribute__((unused)))
+_parcDequeIterator_Fini(PARCDeque *deque __attribute__((unused)), _PARCDequeIterator *state)
 {
+    parcMemory_Deallocate(&state);
     return true;
 }
 
-static struct parc_deque_node *
-_parcDequeNode_Next(PARCDeque *deque __attribute__((unused)), const struct parc_deque_node *node)
+static _PARCDequeIterator *
+_parcDequeIterator_Next(PARCDeque *deque, _PARCDequeIterator *state)
 {
-    if (node == NULL) {
-        return deque->head;
-    }
-    trapOutOfBoundsIf(node->next == NULL, "No more elements.");
-    return node->next;
+    trapOutOfBoundsIf(state->index >= deque->size, "No more elements.");
+    state->element = *_parcDeque_Slot(deque, state->index++);
+    return state;
 }
 
 static bool
-_parcDequeNode_HasNext(PARCDeque *deque __attribute__((unused)), const struct parc_deque_node *node)
+_parcDequeIterator_HasNext(PARCDeque *deque, const _PARCDequeIterator *state)
 {
-    if (node == NULL) {
-        return (deque->head != NULL);
-    }
-    return (node->next != NULL);
+    return (state->index < deque->size);
 }
 
 static void *
-_parcDequeNode_Element(PARCDeque *deque __attribute__((unused)), const struct parc_deque_node *node)
+_parcDequeIterator_Element(PARCDeque *deque __attribute__((unused)), const _PARCDequeIterator *state)
 {
-    return node->element;
+    return state->element;
 }
 
 parcObject_ExtendPARCObject(PARCDeque, _parcDeque_Destroy, parcDeque_Copy, NULL, parcDeque_Equals, NULL, NULL, NULL);
@@ -200,8 +245,9 @@ _create(const PARCObjectDescriptor *interface)
 
     if (result != NULL) {
         result->object = *interface;
-        result->head = NULL;
-        result->tail = NULL;
+        result->blocks = NULL;
+        result->blockCount = 0;
+        result->first = 0;
         result->size = 0;
     }
     return result;
@@ -211,17 +257,33 @@ PARCIterator *
 parcDeque_Iterator(PARCDeque *deque)
 {
     PARCIterator *iterator = parcIterator_Create(deque,
-                                                 (void *(*)(PARCObject *))_parcDequeNode_Init,
-                                                 (bool (*)(PARCObject *, void *))_parcDequeNode_HasNext,
-                                                 (void *(*)(PARCObject *, void *))_parcDequeNode_Next,
+                                                 (void *(*)(PARCObject *))_parcDequeIterator_Init,
+                                                 (bool (*)(PARCObject *, void *))_parcDequeIterator_HasNext,
+                                                 (void *(*)(PARCObject *, void *))_parcDequeIterator_Next,
                                                  NULL,
-                                                 (void *(*)(PARCObject *, void *))_parcDequeNode_Element,
-                                                 (void  (*)(PARCObject *, void *))_parcDequeNode_Fini,
+                                                 (void *(*)(PARCObject *, void *))_parcDequeIterator_Element,
+                                                 (void  (*)(PARCObject *, void *))_parcDequeIterator_Fini,
                                                  NULL);
 
     return iterator;
 }
 
+void
+parcDeque_InitCursor(const PARCDeque *deque, PARCCursor *cursor)
+{
+    *cursor = (PARCCursor) { .collection = deque, .index = 0, .limit = deque->size };
+}
+
+bool
+parcDeque_CursorNext(PARCCursor *cursor)
+{
+    bool result = (cursor->index < cursor->limit);
+    if (result) {
+        cursor->element = *_parcDeque_Slot(cursor->collection, cursor->index++);
+    }
+    return result;
+}
+
 PARCDeque *
 parcDeque_Create(void)
 {
@@ -262,11 +324,8 @@ parcDeque_Copy(const PARCDeque *deque)
 {
     PARCDeque *result = _create(&deque->object);
 
-    struct parc_deque_node *node = deque->head;
-
-    while (node != NULL) {
-        parcDeque_Append(result, deque->object.copy(node->element));
-        node = node->next;
+    for (size_t i = 0; i < deque->size; i++) {
+        parcDeque_Append(result, deque->object.copy(*_parcDeque_Slot(deque, i)));
     }
 
     return result;
@@ -275,19 +334,11 @@ parcDeque_Copy(const PARCDeque *deque)
 PARCDeque *
 parcDeque_Append(PARCDeque *deque, void *element)
 {
-    struct parc_deque_node *node = _parcDequeNode_Create(element, deque->tail, NULL);
-
-    if (deque->tail == NULL) {
-        deque->tail = node;
-    } else {
-        deque->tail->next = node;
-        deque->tail = node;
-    }
-
-    if (deque->head == NULL) {
-        deque->head = deque->tail;
+    if (deque->size == _parcDeque_Capacity(deque)) {
+        _parcDeque_Grow(deque);
     }
 
+    *_parcDeque_NewSlot(deque, deque->size) = element;
     deque->size++;
 
     return deque;
@@ -296,21 +347,14 @@ parcDeque_Append(PARCDeque *deque, void *element)
 PARCDeque *
 parcDeque_Prepend(PARCDeque *deque, void *element)
 {
-    struct parc_deque_node *node = _parcDequeNode_Create(element, NULL, deque->head);
-
-    if (deque->head == NULL) {
-        deque->head = node;
-    } else {
-        deque->head->previous = node;
-        deque->head = node;
+    if (deque->size == _parcDeque_Capacity(deque)) {
+        _parcDeque_Grow(deque);
     }
 
-    if (deque->tail == NULL) {
-        deque->tail = deque->head;
-    }
+    deque->first = (deque->first - 1) & (_parcDeque_Capacity(deque) - 1);
+    *_parcDeque_NewSlot(deque, 0) = element;
     deque->size++;
 
-    _parcDequeNode_AssertInvariants(node);
     _parcDeque_AssertInvariants(deque);
 
     return deque;
@@ -321,17 +365,9 @@ parcDeque_RemoveFirst(PARCDeque *deque)
 {
     void *result = NULL;
 
-    if (deque->head != NULL) {
-        struct parc_deque_node *node = deque->head;
-        result = node->element;
-        if (deque->head == deque->tail) {
-            deque->head = NULL;
-            deque->tail = NULL;
-        } else {
-            deque->head = node->next;
-            deque->head->previous = NULL;
-        }
-        parcMemory_Deallocate((void **) &node);
+    if (deque->size > 0) {
+        result = *_parcDeque_Slot(deque, 0);
+        deque->first = (deque->first + 1) & (_parcDeque_Capacity(deque) - 1);
         deque->size--;
     }
 
@@ -345,13 +381,8 @@ parcDeque_RemoveLast(PARCDeque *deque)
 {
     void *result = NULL;
 
-    if (deque->tail != NULL) {
-        struct parc_deque_node *node = deque->tail;
-        deque->tail = node->previous;
-        deque->tail->next = NULL;
-
-        result = node->element;
-        parcMemory_Deallocate((void **) &node);
+    if (deque->size > 0) {
+        result = *_parcDeque_Slot(deque, deque->size - 1);
         deque->size--;
     }
 
@@ -364,9 +395,8 @@ parcDeque_PeekFirst(const PARCDeque *deque)
 {
     void *result = NULL;
 
-    if (deque->head != NULL) {
-        struct parc_deque_node *node = deque->head;
-        result = node->element;
+    if (deque->size > 0) {
+        result = *_parcDeque_Slot(deque, 0);
     }
     return result;
 }
@@ -376,9 +406,8 @@ parcDeque_PeekLast(const PARCDeque *deque)
 {
     void *result = NULL;
 
-    if (deque->tail != NULL) {
-        struct parc_deque_node *node = deque->tail;
-        result = node->element;
+    if (deque->size > 0) {
+        result = *_parcDeque_Slot(deque, deque->size - 1);
     }
     return result;
 }
@@ -401,12 +430,8 @@ parcDeque_GetAtIndex(const PARCDeque *deque, size_t index)
     if (index > (parcDeque_Size(deque) - 1)) {
         trapOutOfBounds(index, "[0, %zd]", parcDeque_Size(deque) - 1);
     }
-    struct parc_deque_node *node = deque->head;
-    while (index--) {
-        node = node->next;
-    }
 
-    return node->element;
+    return *_parcDeque_Slot(deque, index);
 }
 
 bool
@@ -421,15 +446,10 @@ parcDeque_Equals(const PARCDeque *x, const PARCDeque *y)
 
     if (x->object.equals == y->object.equals) {
         if (x->size == y->size) {
-            struct parc_deque_node *xNode = x->head;
-            struct parc_deque_node *yNode = y->head;
-
-            while (xNode != NULL) {
-                if (x->object.equals(xNode->element, yNode->element) == false) {
+            for (size_t i = 0; i < x->size; i++) {
+                if (x->object.equals(*_parcDeque_Slot(x, i), *_parcDeque_Slot(y, i)) == false) {
                     return false;
                 }
-                xNode = xNode->next;
-                yNode = yNode->next;
             }
             return true;
         }
@@ -443,15 +463,11 @@ parcDeque_Display(const PARCDeque *deque, const int indentation)
     if (deque == NULL) {
         parcDisplayIndented_PrintLine(indentation, "PARCDeque@NULL");
     } else {
-        parcDisplayIndented_PrintLine(indentation, "PARCDeque@%p {", (void *) deque);
-
-        struct parc_deque_node *node = deque->head;
+        parcDisplayIndented_PrintLine(indentation, "PARCDeque@%p { .size=%zu, .first=%zu, .blocks=%zu",
+                                      (void *) deque, deque->size, deque->first, deque->blockCount);
 
-        while (node != NULL) {
-            parcDisplayIndented_PrintLine(indentation + 1,
-                                          ".previous=%11p, %11p=%11p, .next=%11p",
-                                          node->previous, node, node->element, node->next);
-            node = node->next;
+        for (size_t i = 0; i < deque->size; i++) {
+            parcDisplayIndented_PrintLine(indentation + 1, "[%zu]=%11p", i, *_parcDeque_Slot(deque, i));
         }
 
         parcDisplayIndented_PrintLine(indentation, "}\n");
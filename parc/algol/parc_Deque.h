@@ -41,6 +41,7 @@
 #include <parc/algol/parc_List.h>
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_Iterator.h>
+#include <parc/algol/parc_Cursor.h>
 
 struct parc_deque;
 /**
@@ -73,6 +74,39 @@ PARCDeque *parcDeque_Create(void);
 
 PARCIterator *parcDeque_Iterator(PARCDeque *deque);
 
+/**
+ * Initialise the given cursor to visit the elements, from first to last, of the given `PARCDeque`.
+ *
+ * The cursor is positioned before the first element.
+ * Advance it with {@link parcDeque_CursorNext}.
+ *
+ * @param [in] deque A pointer to a valid `PARCDeque`.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcDeque_InitCursor(deque, &cursor);
+ *     while (parcDeque_CursorNext(&cursor)) {
+ *         void *element = parcCursor_GetElement(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcDeque_CursorNext
+ */
+void parcDeque_InitCursor(const PARCDeque *deque, PARCCursor *cursor);
+
+/**
+ * Advance the given cursor to the next element of its `PARCDeque`.
+ *
+ * @param [in,out] cursor A pointer to a `PARCCursor` initialised by {@link parcDeque_InitCursor}.
+ *
+ * @return true The cursor is at the next element.
+ * @return false There are no more elements.
+ */
+bool parcDeque_CursorNext(PARCCursor *cursor);
+
 /**
  * Create a PARCDeque instance that uses the {@link PARCObjectDescriptor} providing functions for element equality and copy function.
  *
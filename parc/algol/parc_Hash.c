@@ -25,8 +25,10 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 /**
- * This hash is based on FNV-1a, using different lengths.  Please see the FNV-1a
- * website for details on the algorithm: http://www.isthe.com/chongo/tech/comp/fnv
+ * The data hashes and their cumulative versions are based on FNV-1a, using different lengths.
+ * The block hashes are based on wyhash.
+ * Please see the FNV-1a website for details on the algorithm: http://www.isthe.com/chongo/tech/comp/fnv
+ * and https://github.com/wangyi-fudan/wyhash for wyhash, which is in the public domain.
  *
  * @author Ignacio Solis, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
@@ -34,6 +36,7 @@
 #include <config.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <parc/algol/parc_Hash.h>
@@ -83,16 +86,8 @@ parcObject_ImplementRelease(parcHash32Bits, PARCHash32Bits);
 /*
  * Based on 64-bit FNV-1a
  */
-uint64_t
-parcHash64_Data(const void *data, size_t len)
-{
-    // Standard FNV 64-bit offset: see http://www.isthe.com/chongo/tech/comp/fnv/#FNV-param
-    const uint64_t fnv1a_offset = 0xCBF29CE484222325ULL;
-    return parcHash64_Data_Cumulative(data, len, fnv1a_offset);
-}
-
-uint64_t
-parcHash64_Data_Cumulative(const void *data, size_t len, uint64_t lastValue)
+static uint64_t
+_parcHash64_FNV1a(const void *data, size_t len, uint64_t lastValue)
 {
     // Standard FNV 64-bit prime: see http://www.isthe.com/chongo/tech/comp/fnv/#FNV-param
     const uint64_t fnv1a_prime = 0x00000100000001B3ULL;
@@ -107,6 +102,163 @@ parcHash64_Data_Cumulative(const void *data, size_t len, uint64_t lastValue)
     return hash;
 }
 
+/*
+ * Based on 32-bit FNV-1a
+ */
+static uint32_t
+_parcHash32_FNV1a(const void *data, size_t len, uint32_t lastValue)
+{
+    // Standard FNV 32-bit prime: see http://www.isthe.com/chongo/tech/comp/fnv/#FNV-param
+    const uint32_t fnv1a_prime = 0x01000193;
+    uint32_t hash = lastValue;
+
+    const char *chardata = data;
+
+    for (size_t i = 0; i < len; i++) {
+        hash = hash ^ chardata[i];
+        hash = hash * fnv1a_prime;
+    }
+
+    return hash;
+}
+
+/*
+ * Multiply two 64-bit values, leaving the low 64 bits of the product in *a and the high 64 bits in *b.
+ */
+static inline void
+_parcHashWy_Multiply(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t) *a * *b;
+    *a = (uint64_t) product;
+    *b = (uint64_t) (product >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+    *a = lo;
+    *b = hi;
+#endif
+}
+
+static inline uint64_t
+_parcHashWy_Mix(uint64_t a, uint64_t b)
+{
+    _parcHashWy_Multiply(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t
+_parcHashWy_Read64(const uint8_t *p)
+{
+    uint64_t result;
+    memcpy(&result, p, sizeof(result));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    result = __builtin_bswap64(result);
+#endif
+    return result;
+}
+
+static inline uint64_t
+_parcHashWy_Read32(const uint8_t *p)
+{
+    uint32_t result;
+    memcpy(&result, p, sizeof(result));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    result = __builtin_bswap32(result);
+#endif
+    return result;
+}
+
+static inline uint64_t
+_parcHashWy_Read3(const uint8_t *p, size_t length)
+{
+    return (((uint64_t) p[0]) << 16) | (((uint64_t) p[length >> 1]) << 8) | p[length - 1];
+}
+
+static const uint64_t _parcHashWy_Secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+/*
+ * Based on wyhash (final version 4).
+ *
+ * Inputs up to 16 bytes are read as a few overlapping words,
+ * longer inputs are consumed 48 bytes per step in three independent lanes.
+ */
+static uint64_t
+_parcHash64_Wy(const void *data, size_t len, uint64_t seed)
+{
+    const uint64_t *secret = _parcHashWy_Secret;
+    const uint8_t *p = data;
+    uint64_t a;
+    uint64_t b;
+
+    seed ^= _parcHashWy_Mix(seed ^ secret[0], secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (_parcHashWy_Read32(p) << 32) | _parcHashWy_Read32(p + ((len >> 3) << 2));
+            b = (_parcHashWy_Read32(p + len - 4) << 32) | _parcHashWy_Read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = _parcHashWy_Read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = _parcHashWy_Mix(_parcHashWy_Read64(p) ^ secret[1], _parcHashWy_Read64(p + 8) ^ seed);
+                see1 = _parcHashWy_Mix(_parcHashWy_Read64(p + 16) ^ secret[2], _parcHashWy_Read64(p + 24) ^ see1);
+                see2 = _parcHashWy_Mix(_parcHashWy_Read64(p + 32) ^ secret[3], _parcHashWy_Read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _parcHashWy_Mix(_parcHashWy_Read64(p) ^ secret[1], _parcHashWy_Read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = _parcHashWy_Read64(p + i - 16);
+        b = _parcHashWy_Read64(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    _parcHashWy_Multiply(&a, &b);
+    return _parcHashWy_Mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+uint64_t
+parcHash64_Data(const void *data, size_t len)
+{
+    // Standard FNV 64-bit offset: see http://www.isthe.com/chongo/tech/comp/fnv/#FNV-param
+    const uint64_t fnv1a_offset = 0xCBF29CE484222325ULL;
+    return parcHash64_Data_Cumulative(data, len, fnv1a_offset);
+}
+
+uint64_t
+parcHash64_Data_Cumulative(const void *data, size_t len, uint64_t lastValue)
+{
+    return _parcHash64_FNV1a(data, len, lastValue);
+}
+
+uint64_t
+parcHash64_Block(const void *data, size_t len, uint64_t seed)
+{
+    return _parcHash64_Wy(data, len, seed);
+}
+
 uint64_t
 parcHash64_Int64(uint64_t int64)
 {
@@ -130,18 +282,14 @@ parcHash32_Data(const void *data, size_t len)
 uint32_t
 parcHash32_Data_Cumulative(const void *data, size_t len, uint32_t lastValue)
 {
-    // Standard FNV 32-bit prime: see http://www.isthe.com/chongo/tech/comp/fnv/#FNV-param
-    const uint32_t fnv1a_prime = 0x01000193;
-    uint32_t hash = lastValue;
-
-    const char *chardata = data;
-
-    for (size_t i = 0; i < len; i++) {
-        hash = hash ^ chardata[i];
-        hash = hash * fnv1a_prime;
-    }
+    return _parcHash32_FNV1a(data, len, lastValue);
+}
 
-    return hash;
+uint32_t
+parcHash32_Block(const void *data, size_t len, uint32_t seed)
+{
+    uint64_t hash = _parcHash64_Wy(data, len, seed);
+    return (uint32_t) (hash ^ (hash >> 32));
 }
 
 uint32_t
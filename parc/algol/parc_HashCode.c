@@ -31,15 +31,21 @@
 #include <config.h>
 
 #include <parc/algol/parc_HashCode.h>
+#include <parc/algol/parc_Hash.h>
 
 #if PARCHashCodeSize == 64
-static const PARCHashCode _fnv1a_prime = 0x00000100000001B3ULL;
 const PARCHashCode parcHashCode_InitialValue = 0xCBF29CE484222325ULL;
 #else
-static const PARCHashCode _fnv1a_prime = 0x01000193;
 const PARCHashCode parcHashCode_InitialValue = 0x811C9DC5;
 #endif
 
+#if PARCHashFunction == PARCHashFunction_FNV1a
+#if PARCHashCodeSize == 64
+static const PARCHashCode _fnv1a_prime = 0x00000100000001B3ULL;
+#else
+static const PARCHashCode _fnv1a_prime = 0x01000193;
+#endif
+
 PARCHashCode
 parcHashCode_HashImpl(const uint8_t *memory, size_t length, PARCHashCode initialValue)
 {
@@ -54,6 +60,17 @@ parcHashCode_HashImpl(const uint8_t *memory, size_t length, PARCHashCode initial
 
     return hash;
 }
+#else
+PARCHashCode
+parcHashCode_HashImpl(const uint8_t *memory, size_t length, PARCHashCode initialValue)
+{
+#if PARCHashCodeSize == 64
+    return parcHash64_Block(memory, length, initialValue);
+#else
+    return parcHash32_Block(memory, length, initialValue);
+#endif
+}
+#endif
 
 PARCHashCode
 parcHashCode_HashHashCode(PARCHashCode initialValue, PARCHashCode update)
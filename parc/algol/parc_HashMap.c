@@ -36,120 +36,310 @@
 #include <parc/algol/parc_Memory.h>
 
 #include "parc_HashMap.h"
-#include "parc_LinkedList.h"
 
 static const uint32_t DEFAULT_CAPACITY = 43;
 
-typedef struct PARCHashMapEntry {
+/*
+ * The map is an open-addressed table using Robin Hood hashing.
+ * Each slot holds the key, the value, the key's hash code and the slot's probe length.
+ * A probe length of 0 marks an empty slot, 1 marks an entry in its home slot,
+ * 2 an entry one slot past its home slot, and so on.
+ *
+ * The table never holds more than _PARCHashMap_MaxLoadNumerator / _PARCHashMap_MaxLoadDenominator entries per slot.
+ * When an insertion would exceed that, the current table becomes the "draining" table,
+ * a new table of twice the size becomes the current table,
+ * and every subsequent mutation moves a few slots from the draining table into the current table.
+ * This spreads the cost of the rehash across many operations instead of stopping to copy the whole table.
+ *
+ * The draining table is never shifted.
+ * Removing an entry from it leaves a tombstone (a NULL key with a non-zero probe length)
+ * so that the probe sequences of the remaining entries stay intact until they are migrated.
+ */
+#define _PARCHashMap_MaxLoadNumerator 7
+#define _PARCHashMap_MaxLoadDenominator 8
+#define _PARCHashMap_MinimumCapacity 8
+#define _PARCHashMap_MigrationStride 8
+
+typedef struct {
     PARCObject *key;
     PARCObject *value;
-} _PARCHashMapEntry;
+    PARCHashCode hashCode;
+    uint32_t probeLength;
+} _PARCHashMapSlot;
+
+typedef struct {
+    _PARCHashMapSlot *slots;
+    size_t capacity;
+    unsigned int shift;
+    size_t count;
+} _PARCHashMapTable;
 
+struct PARCHashMap {
+    _PARCHashMapTable table;
+    _PARCHashMapTable draining;
+    size_t drainIndex;
+};
 
-static bool
-_parcHashMapEntry_IsValid(_PARCHashMapEntry *hashEntry)
+static inline bool
+_parcHashMapSlot_IsOccupied(const _PARCHashMapSlot *slot)
 {
-    bool result = false;
+    return slot->key != NULL;
+}
 
-    if (hashEntry) {
-        if (parcObject_IsValid(hashEntry->key)) {
-            if (parcObject_IsValid(hashEntry->value)) {
-                result = true;
-            }
-        }
+static size_t
+_parcHashMap_CapacityFor(size_t count)
+{
+    size_t result = _PARCHashMap_MinimumCapacity;
+
+    while ((result / _PARCHashMap_MaxLoadDenominator) * _PARCHashMap_MaxLoadNumerator < count) {
+        result <<= 1;
     }
 
     return result;
 }
 
+static inline size_t
+_parcHashMapTable_Threshold(const _PARCHashMapTable *table)
+{
+    return (table->capacity / _PARCHashMap_MaxLoadDenominator) * _PARCHashMap_MaxLoadNumerator;
+}
+
+/*
+ * Fibonacci hashing: spread the bits of the hash code over the whole table
+ * so that hash codes which differ only in their high-order bits still land in different slots.
+ */
+static inline size_t
+_parcHashMapTable_HomeSlot(const _PARCHashMapTable *table, PARCHashCode hashCode)
+{
+    return (size_t) (((uint64_t) hashCode * UINT64_C(0x9E3779B97F4A7C15)) >> table->shift);
+}
+
 static void
-_parcHashMapEntry_Finalize(_PARCHashMapEntry **instancePtr)
+_parcHashMapTable_Init(_PARCHashMapTable *table, size_t capacity)
 {
-    assertNotNull(instancePtr, "Parameter must be a non-null pointer to a PARCHashMap pointer.");
-    _PARCHashMapEntry *hashMapEntry = *instancePtr;
+    unsigned int log2 = 0;
+    while (((size_t) 1 << log2) < capacity) {
+        log2++;
+    }
 
-    _parcHashMapEntry_IsValid(hashMapEntry);
+    table->capacity = (size_t) 1 << log2;
+    table->shift = 64 - log2;
+    table->count = 0;
+    table->slots = parcMemory_AllocateAndClear(table->capacity * sizeof(_PARCHashMapSlot));
+    trapOutOfMemoryIf(table->slots == NULL, "Cannot allocate %zu slots for PARCHashMap", table->capacity);
+}
 
-    parcObject_Release(&hashMapEntry->key);
-    parcObject_Release(&hashMapEntry->value);
+static void
+_parcHashMapTable_Fini(_PARCHashMapTable *table)
+{
+    if (table->slots != NULL) {
+        parcMemory_Deallocate(&table->slots);
+    }
+    table->capacity = 0;
+    table->count = 0;
 }
 
-static bool
-_parcHashMapEntry_Equals(const _PARCHashMapEntry *a, const _PARCHashMapEntry *b)
+static void
+_parcHashMapTable_ReleaseEntries(_PARCHashMapTable *table)
 {
-    return (parcObject_Equals(a->key, b->key) && parcObject_Equals(a->value, b->value));
+    for (size_t i = 0; i < table->capacity; i++) {
+        _PARCHashMapSlot *slot = &table->slots[i];
+        if (_parcHashMapSlot_IsOccupied(slot)) {
+            parcObject_Release(&slot->key);
+            parcObject_Release(&slot->value);
+        }
+    }
 }
 
+/*
+ * Insert an entry that is known not to be in the table.
+ * The table takes ownership of the references to the key and value.
+ */
+static void
+_parcHashMapTable_Insert(_PARCHashMapTable *table, PARCObject *key, PARCObject *value, PARCHashCode hashCode)
+{
+    size_t mask = table->capacity - 1;
+    size_t index = _parcHashMapTable_HomeSlot(table, hashCode);
 
-static PARCHashCode
-_parcHashMapEntry_HashCode(const _PARCHashMapEntry *entry)
+    _PARCHashMapSlot entry = { .key = key, .value = value, .hashCode = hashCode, .probeLength = 1 };
+
+    for (;;) {
+        _PARCHashMapSlot *slot = &table->slots[index];
+        if (slot->probeLength == 0) {
+            *slot = entry;
+            table->count++;
+            return;
+        }
+        // Robin Hood: the entry that is further from its home slot keeps the slot.
+        if (slot->probeLength < entry.probeLength) {
+            _PARCHashMapSlot displaced = *slot;
+            *slot = entry;
+            entry = displaced;
+        }
+        index = (index + 1) & mask;
+        entry.probeLength++;
+    }
+}
+
+static _PARCHashMapSlot *
+_parcHashMapTable_Find(const _PARCHashMapTable *table, const PARCObject *key, PARCHashCode hashCode)
 {
-    return parcObject_HashCode(entry->key);
+    if (table->count == 0) {
+        return NULL;
+    }
+
+    size_t mask = table->capacity - 1;
+    size_t index = _parcHashMapTable_HomeSlot(table, hashCode);
+
+    for (uint32_t probeLength = 1; table->slots[index].probeLength >= probeLength; probeLength++) {
+        _PARCHashMapSlot *slot = &table->slots[index];
+        if (slot->hashCode == hashCode && _parcHashMapSlot_IsOccupied(slot)) {
+            if (slot->key == key || parcObject_Equals(key, slot->key)) {
+                return slot;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
 }
 
+/*
+ * Remove the entry in the given slot, shifting the subsequent entries of the same probe sequence back by one slot.
+ */
+static void
+_parcHashMapTable_RemoveAt(_PARCHashMapTable *table, size_t index)
+{
+    size_t mask = table->capacity - 1;
 
-struct PARCHashMap {
-    PARCLinkedList **buckets;
-    unsigned int capacity;
-    unsigned int size;
-};
+    _PARCHashMapSlot *slot = &table->slots[index];
+    parcObject_Release(&slot->key);
+    parcObject_Release(&slot->value);
+
+    size_t next = (index + 1) & mask;
+    while (table->slots[next].probeLength > 1) {
+        table->slots[index] = table->slots[next];
+        table->slots[index].probeLength--;
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    table->slots[index] = (_PARCHashMapSlot) { .key = NULL, .value = NULL, .hashCode = 0, .probeLength = 0 };
+    table->count--;
+}
 
-static _PARCHashMapEntry *
-_parcHashMap_GetEntry(const PARCHashMap *hashMap, const PARCObject *key)
+/*
+ * Remove the entry in the given slot of the draining table, leaving a tombstone in its place.
+ */
+static void
+_parcHashMapTable_Bury(_PARCHashMapTable *table, _PARCHashMapSlot *slot)
 {
-    PARCHashCode keyHash = parcObject_HashCode(key);
+    parcObject_Release(&slot->key);
+    parcObject_Release(&slot->value);
+    table->count--;
+}
 
-    int bucket = keyHash % hashMap->capacity;
+static inline bool
+_parcHashMap_IsDraining(const PARCHashMap *hashMap)
+{
+    return hashMap->draining.capacity != 0;
+}
 
-    _PARCHashMapEntry *result = NULL;
+static void
+_parcHashMap_Migrate(PARCHashMap *hashMap, size_t slotCount)
+{
+    if (_parcHashMap_IsDraining(hashMap)) {
+        _PARCHashMapTable *draining = &hashMap->draining;
 
-    PARCIterator *iterator = parcLinkedList_CreateIterator(hashMap->buckets[bucket]);
+        size_t limit = hashMap->drainIndex + slotCount;
+        if (limit > draining->capacity) {
+            limit = draining->capacity;
+        }
 
-    while (parcIterator_HasNext(iterator)) {
-        _PARCHashMapEntry *entry = parcIterator_Next(iterator);
-        if (parcObject_Equals(key, entry->key)) {
-            result = entry;
-            break;
+        for (; hashMap->drainIndex < limit && draining->count > 0; hashMap->drainIndex++) {
+            _PARCHashMapSlot *slot = &draining->slots[hashMap->drainIndex];
+            if (_parcHashMapSlot_IsOccupied(slot)) {
+                _parcHashMapTable_Insert(&hashMap->table, slot->key, slot->value, slot->hashCode);
+                slot->key = NULL;
+                slot->value = NULL;
+                draining->count--;
+            }
+        }
+
+        if (draining->count == 0) {
+            _parcHashMapTable_Fini(draining);
+            hashMap->drainIndex = 0;
         }
     }
-    parcIterator_Release(&iterator);
+}
 
-    return result;
+static void
+_parcHashMap_FinishMigration(PARCHashMap *hashMap)
+{
+    _parcHashMap_Migrate(hashMap, SIZE_MAX);
 }
 
-//static parcObject_ImplementAcquire(parcHashMapEntry, _PARCHashMapEntry);
+/*
+ * Move every entry into a new table of the given capacity, immediately.
+ */
+static void
+_parcHashMap_Rehash(PARCHashMap *hashMap, size_t capacity)
+{
+    _parcHashMap_FinishMigration(hashMap);
 
-static parcObject_ImplementRelease(_parcHashMapEntry, _PARCHashMapEntry);
+    hashMap->draining = hashMap->table;
+    hashMap->drainIndex = 0;
+    _parcHashMapTable_Init(&hashMap->table, capacity);
 
-parcObject_ExtendPARCObject(_PARCHashMapEntry, _parcHashMapEntry_Finalize, NULL, NULL, _parcHashMapEntry_Equals, NULL, _parcHashMapEntry_HashCode, NULL);
+    _parcHashMap_FinishMigration(hashMap);
+}
 
-static _PARCHashMapEntry *
-_parcHashMapEntry_Create(const PARCObject *key, const PARCObject *value)
+/*
+ * Make room for one more entry, starting an incremental rehash if the current table is at its load limit.
+ */
+static void
+_parcHashMap_EnsureRoomForOne(PARCHashMap *hashMap)
 {
-    parcObject_OptionalAssertValid(key);
-    parcObject_OptionalAssertValid(value);
+    if (hashMap->table.count + 1 > _parcHashMapTable_Threshold(&hashMap->table)) {
+        // A previous rehash must be complete before starting another.
+        _parcHashMap_FinishMigration(hashMap);
 
-    _PARCHashMapEntry *result = parcObject_CreateInstance(_PARCHashMapEntry);
+        hashMap->draining = hashMap->table;
+        hashMap->drainIndex = 0;
+        _parcHashMapTable_Init(&hashMap->table, hashMap->draining.capacity * 2);
+    }
+}
 
-    result->key = parcObject_Copy(key);
-    result->value = parcObject_Acquire(value);
+static _PARCHashMapSlot *
+_parcHashMap_FindSlot(const PARCHashMap *hashMap, const PARCObject *key, PARCHashCode hashCode)
+{
+    _PARCHashMapSlot *result = _parcHashMapTable_Find(&hashMap->table, key, hashCode);
+    if (result == NULL && _parcHashMap_IsDraining(hashMap)) {
+        result = _parcHashMapTable_Find(&hashMap->draining, key, hashCode);
+    }
 
     return result;
 }
 
+static _PARCHashMapSlot *
+_parcHashMap_GetSlot(const PARCHashMap *hashMap, const PARCObject *key)
+{
+    return _parcHashMap_FindSlot(hashMap, key, parcObject_HashCode(key));
+}
+
 static void
 _parcHashMap_Finalize(PARCHashMap **instancePtr)
 {
     assertNotNull(instancePtr, "Parameter must be a non-null pointer to a PARCHashMap pointer.");
     PARCHashMap *hashMap = *instancePtr;
 
-    for (unsigned int i = 0; i < hashMap->capacity; i++) {
-        parcLinkedList_Release(&hashMap->buckets[i]);
-    }
-
-    parcMemory_Deallocate(&hashMap->buckets);
+    _parcHashMapTable_ReleaseEntries(&hashMap->table);
+    _parcHashMapTable_Fini(&hashMap->table);
 
-    /* cleanup the instance fields here */
+    if (_parcHashMap_IsDraining(hashMap)) {
+        _parcHashMapTable_ReleaseEntries(&hashMap->draining);
+        _parcHashMapTable_Fini(&hashMap->draining);
+    }
 }
 
 parcObject_ImplementAcquire(parcHashMap, PARCHashMap);
@@ -175,13 +365,9 @@ parcHashMap_CreateCapacity(unsigned int capacity)
             capacity = DEFAULT_CAPACITY;
         }
 
-        result->capacity = capacity;
-        result->size = 0;
-        result->buckets = parcMemory_Allocate(capacity * sizeof(PARCLinkedList*));
-
-        for (unsigned int i = 0; i < result->capacity; i++) {
-            result->buckets[i] = parcLinkedList_Create();
-        }
+        _parcHashMapTable_Init(&result->table, _parcHashMap_CapacityFor(capacity));
+        result->draining = (_PARCHashMapTable) { .slots = NULL, .capacity = 0, .shift = 0, .count = 0 };
+        result->drainIndex = 0;
     }
 
     return result;
@@ -195,6 +381,18 @@ parcHashMap_Create(void)
     return result;
 }
 
+static void
+_parcHashMap_CopyEntries(PARCHashMap *result, const _PARCHashMapTable *table)
+{
+    for (size_t i = 0; i < table->capacity; i++) {
+        const _PARCHashMapSlot *slot = &table->slots[i];
+        if (_parcHashMapSlot_IsOccupied(slot)) {
+            // Keys are private copies that are never modified, so they can be shared with the copy.
+            _parcHashMapTable_Insert(&result->table, parcObject_Acquire(slot->key), parcObject_Acquire(slot->value), slot->hashCode);
+        }
+    }
+}
+
 PARCHashMap *
 parcHashMap_Copy(const PARCHashMap *original)
 {
@@ -202,12 +400,15 @@ parcHashMap_Copy(const PARCHashMap *original)
 
     PARCHashMap *result = parcObject_CreateInstance(PARCHashMap);
 
-    result->capacity = original->capacity;
-    result->size = original->size;
-    result->buckets = parcMemory_Allocate(result->capacity * sizeof(PARCLinkedList*));
+    if (result != NULL) {
+        _parcHashMapTable_Init(&result->table, _parcHashMap_CapacityFor(parcHashMap_Size(original)));
+        result->draining = (_PARCHashMapTable) { .slots = NULL, .capacity = 0, .shift = 0, .count = 0 };
+        result->drainIndex = 0;
 
-    for (unsigned int i = 0; i < result->capacity; i++) {
-        result->buckets[i] = parcLinkedList_Copy(original->buckets[i]);
+        _parcHashMap_CopyEntries(result, &original->table);
+        if (_parcHashMap_IsDraining(original)) {
+            _parcHashMap_CopyEntries(result, &original->draining);
+        }
     }
 
     return result;
@@ -218,22 +419,41 @@ parcHashMap_Display(const PARCHashMap *hashMap, int indentation)
 {
     parcDisplayIndented_PrintLine(indentation, "PARCHashMap@%p {", hashMap);
 
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator((PARCHashMap *) hashMap);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(hashMap, &cursor);
 
-    while (parcIterator_HasNext(iterator)) {
-        PARCObject *keyObject = parcIterator_Next(iterator);
-        const PARCObject *valueObject = parcHashMap_Get(hashMap, keyObject);
-        char *key = parcObject_ToString(keyObject);
-        char *value = parcObject_ToString(valueObject);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcObject_ToString(parcCursor_GetKey(&cursor));
+        char *value = parcObject_ToString(parcCursor_GetValue(&cursor));
         parcDisplayIndented_PrintLine(indentation + 1, "%s -> %s", key, value);
         parcMemory_Deallocate(&key);
         parcMemory_Deallocate(&value);
     }
-    parcIterator_Release(&iterator);
 
     parcDisplayIndented_PrintLine(indentation, "}");
 }
 
+/*
+ * Return true if every entry in the given table of `x` is present in `y` with an equal value.
+ */
+static bool
+_parcHashMap_ContainsEntries(const PARCHashMap *y, const _PARCHashMapTable *table)
+{
+    for (size_t i = 0; i < table->capacity; i++) {
+        const _PARCHashMapSlot *slot = &table->slots[i];
+        if (_parcHashMapSlot_IsOccupied(slot)) {
+            _PARCHashMapSlot *other = _parcHashMapTable_Find(&y->table, slot->key, slot->hashCode);
+            if (other == NULL && _parcHashMap_IsDraining(y)) {
+                other = _parcHashMapTable_Find(&y->draining, slot->key, slot->hashCode);
+            }
+            if (other == NULL || parcObject_Equals(slot->value, other->value) == false) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 bool
 parcHashMap_Equals(const PARCHashMap *x, const PARCHashMap *y)
 {
@@ -247,16 +467,10 @@ parcHashMap_Equals(const PARCHashMap *x, const PARCHashMap *y)
         parcHashMap_OptionalAssertValid(x);
         parcHashMap_OptionalAssertValid(y);
 
-        if (x->capacity == y->capacity) {
-            if (x->size == y->size) {
-                result = true;
-                for (unsigned int i = 0; i < x->capacity; i++) {
-                    // For each item in an X bucket, it must be in the Y bucket.
-                    if (parcLinkedList_SetEquals(x->buckets[i], y->buckets[i]) == false) {
-                        result = false;
-                        break;
-                    }
-                }
+        if (parcHashMap_Size(x) == parcHashMap_Size(y)) {
+            result = _parcHashMap_ContainsEntries(y, &x->table);
+            if (result && _parcHashMap_IsDraining(x)) {
+                result = _parcHashMap_ContainsEntries(y, &x->draining);
             }
         }
     }
@@ -264,20 +478,54 @@ parcHashMap_Equals(const PARCHashMap *x, const PARCHashMap *y)
     return result;
 }
 
+static PARCHashCode
+_parcHashMapTable_HashCode(const _PARCHashMapTable *table)
+{
+    PARCHashCode result = 0;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (_parcHashMapSlot_IsOccupied(&table->slots[i])) {
+            result += table->slots[i].hashCode;
+        }
+    }
+
+    return result;
+}
+
 PARCHashCode
 parcHashMap_HashCode(const PARCHashMap *hashMap)
 {
     parcHashMap_OptionalAssertValid(hashMap);
 
-    PARCHashCode result = 0;
+    PARCHashCode result = _parcHashMapTable_HashCode(&hashMap->table);
 
-    for (unsigned int i = 0; i < hashMap->capacity; i++) {
-        result += parcLinkedList_HashCode(hashMap->buckets[i]);
+    if (_parcHashMap_IsDraining(hashMap)) {
+        result += _parcHashMapTable_HashCode(&hashMap->draining);
     }
 
     return result;
 }
 
+static bool
+_parcHashMapTable_IsValid(const _PARCHashMapTable *table)
+{
+    bool result = true;
+
+    size_t count = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        const _PARCHashMapSlot *slot = &table->slots[i];
+        if (_parcHashMapSlot_IsOccupied(slot)) {
+            if (parcObject_IsValid(slot->key) == false) {
+                result = false;
+                break;
+            }
+            count++;
+        }
+    }
+
+    return result && count == table->count;
+}
+
 bool
 parcHashMap_IsValid(const PARCHashMap *map)
 {
@@ -285,21 +533,9 @@ parcHashMap_IsValid(const PARCHashMap *map)
 
     if (map != NULL) {
         if (parcObject_IsValid(map)) {
-            result = true;
-
-            for (unsigned int i = 0; i < map->capacity; i++) {
-                if (parcLinkedList_IsValid(map->buckets[i]) == false) {
-                    result = false;
-                    break;
-                }
-                PARCIterator *iterator = parcLinkedList_CreateIterator(map->buckets[i]);
-                while (parcIterator_HasNext(iterator)) {
-                    _PARCHashMapEntry *entry = parcIterator_Next(iterator);
-                    parcObject_IsValid(entry->key);
-                    parcObject_IsValid(entry->value);
-                }
-
-                parcIterator_Release(&iterator);
+            result = _parcHashMapTable_IsValid(&map->table);
+            if (result && _parcHashMap_IsDraining(map)) {
+                result = _parcHashMapTable_IsValid(&map->draining);
             }
         }
     }
@@ -314,13 +550,12 @@ parcHashMap_ToJSON(const PARCHashMap *hashMap)
 
     PARCJSON *result = parcJSON_Create();
 
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator((PARCHashMap *) hashMap);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(hashMap, &cursor);
 
-    while (parcIterator_HasNext(iterator)) {
-        PARCObject *keyObject = parcIterator_Next(iterator);
-        const PARCObject *valueObject = parcHashMap_Get(hashMap, keyObject);
-        char *key = parcObject_ToString(keyObject);
-        PARCJSON *value = parcObject_ToJSON(valueObject);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcObject_ToString(parcCursor_GetKey(&cursor));
+        PARCJSON *value = parcObject_ToJSON(parcCursor_GetValue(&cursor));
 
         parcJSON_AddObject(result, key, value);
 
@@ -328,29 +563,23 @@ parcHashMap_ToJSON(const PARCHashMap *hashMap)
         parcJSON_Release(&value);
     }
 
-    parcIterator_Release(&iterator);
-
-
     return result;
 }
 
 PARCBufferComposer *
 parcHashMap_BuildString(const PARCHashMap *hashMap, PARCBufferComposer *composer)
 {
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator((PARCHashMap *) hashMap);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(hashMap, &cursor);
 
-    while (parcIterator_HasNext(iterator)) {
-        PARCObject *keyObject = parcIterator_Next(iterator);
-        const PARCObject *valueObject = parcHashMap_Get(hashMap, keyObject);
-        char *key = parcObject_ToString(keyObject);
-        char *value = parcObject_ToString(valueObject);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcObject_ToString(parcCursor_GetKey(&cursor));
+        char *value = parcObject_ToString(parcCursor_GetValue(&cursor));
         parcBufferComposer_Format(composer, "%s -> %s\n", key, value);
         parcMemory_Deallocate(&key);
         parcMemory_Deallocate(&value);
     }
 
-    parcIterator_Release(&iterator);
-
     return composer;
 }
 
@@ -377,9 +606,9 @@ parcHashMap_Contains(PARCHashMap *hashMap, const PARCObject *key)
 {
     PARCObject *result = NULL;
 
-    _PARCHashMapEntry *entry = _parcHashMap_GetEntry(hashMap, key);
-    if (entry != NULL) {
-        result = entry->value;
+    _PARCHashMapSlot *slot = _parcHashMap_GetSlot(hashMap, key);
+    if (slot != NULL) {
+        result = slot->value;
     }
 
     return result;
@@ -388,24 +617,24 @@ parcHashMap_Contains(PARCHashMap *hashMap, const PARCObject *key)
 bool
 parcHashMap_Remove(PARCHashMap *hashMap, const PARCObject *key)
 {
-    PARCHashCode keyHash = parcObject_HashCode(key);
-
-    int bucket = keyHash % hashMap->capacity;
-
     bool result = false;
 
-    PARCIterator *iterator = parcLinkedList_CreateIterator(hashMap->buckets[bucket]);
+    _parcHashMap_Migrate(hashMap, _PARCHashMap_MigrationStride);
+
+    PARCHashCode keyHash = parcObject_HashCode(key);
 
-    while (parcIterator_HasNext(iterator)) {
-        _PARCHashMapEntry *entry = parcIterator_Next(iterator);
-        if (parcObject_Equals(key, entry->key)) {
-            parcIterator_Remove(iterator);
-            hashMap->size--;
+    _PARCHashMapSlot *slot = _parcHashMapTable_Find(&hashMap->table, key, keyHash);
+    if (slot != NULL) {
+        _parcHashMapTable_RemoveAt(&hashMap->table, slot - hashMap->table.slots);
+        result = true;
+    } else if (_parcHashMap_IsDraining(hashMap)) {
+        slot = _parcHashMapTable_Find(&hashMap->draining, key, keyHash);
+        if (slot != NULL) {
+            _parcHashMapTable_Bury(&hashMap->draining, slot);
+            _parcHashMap_Migrate(hashMap, 0);
             result = true;
-            break;
         }
     }
-    parcIterator_Release(&iterator);
 
     return result;
 }
@@ -413,22 +642,24 @@ parcHashMap_Remove(PARCHashMap *hashMap, const PARCObject *key)
 PARCHashMap *
 parcHashMap_Put(PARCHashMap *hashMap, const PARCObject *key, const PARCObject *value)
 {
-    _PARCHashMapEntry *entry = _parcHashMap_GetEntry(hashMap, key);
+    parcObject_OptionalAssertValid(key);
+    parcObject_OptionalAssertValid(value);
 
-    if (entry != NULL) {
-        if (entry->value != value) {
-            parcObject_Release(&entry->value);
-            entry->value = parcObject_Acquire(value);
+    _parcHashMap_Migrate(hashMap, _PARCHashMap_MigrationStride);
+
+    PARCHashCode keyHash = parcObject_HashCode(key);
+
+    _PARCHashMapSlot *slot = _parcHashMap_FindSlot(hashMap, key, keyHash);
+
+    if (slot != NULL) {
+        if (slot->value != value) {
+            parcObject_Release(&slot->value);
+            slot->value = parcObject_Acquire(value);
         }
     } else {
-        entry = _parcHashMapEntry_Create(key, value);
-
-        PARCHashCode keyHash = parcObject_HashCode(key);
-        int bucket = keyHash % hashMap->capacity;
+        _parcHashMap_EnsureRoomForOne(hashMap);
 
-        parcLinkedList_Append(hashMap->buckets[bucket], entry);
-        hashMap->size++;
-        _parcHashMapEntry_Release(&entry);
+        _parcHashMapTable_Insert(&hashMap->table, parcObject_Copy(key), parcObject_Acquire(value), keyHash);
     }
 
     return hashMap;
@@ -439,9 +670,9 @@ parcHashMap_Get(const PARCHashMap *hashMap, const PARCObject *key)
 {
     PARCObject *result = NULL;
 
-    _PARCHashMapEntry *entry = _parcHashMap_GetEntry(hashMap, key);
-    if (entry != NULL) {
-        result = entry->value;
+    _PARCHashMapSlot *slot = _parcHashMap_GetSlot(hashMap, key);
+    if (slot != NULL) {
+        result = slot->value;
     }
 
     return result;
@@ -451,74 +682,122 @@ size_t
 parcHashMap_Size(const PARCHashMap *hashMap)
 {
     parcHashMap_OptionalAssertValid(hashMap);
-    return hashMap->size;
+    return hashMap->table.count + hashMap->draining.count;
+}
+
+PARCHashMap *
+parcHashMap_Reserve(PARCHashMap *hashMap, size_t count)
+{
+    size_t capacity = _parcHashMap_CapacityFor(count);
+
+    if (capacity > hashMap->table.capacity) {
+        _parcHashMap_Rehash(hashMap, capacity);
+    } else {
+        _parcHashMap_FinishMigration(hashMap);
+    }
+
+    return hashMap;
 }
 
+/*
+ * Iteration visits the draining table, if any, and then the current table.
+ *
+ * Removing an entry from the current table through an iterator shifts the rest of its probe sequence back one slot,
+ * so the iterator re-examines the slot it just removed.
+ * Starting the walk of the current table just past an empty slot guarantees that a backward shift never moves an
+ * already visited entry into the unvisited part of the table.
+ */
 typedef struct {
     PARCHashMap *map;
-    int bucket;
-    PARCIterator *listIterator;
-    _PARCHashMapEntry *current;
+    _PARCHashMapTable *table;
+    size_t start;
+    size_t step;
+    size_t index;
+    _PARCHashMapSlot *current;
 } _PARCHashMapIterator;
 
+static void
+_parcHashMapIterator_Begin(_PARCHashMapIterator *state, _PARCHashMapTable *table)
+{
+    state->table = table;
+    state->step = 0;
+    state->start = 0;
+
+    if (table == &state->map->table) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->slots[i].probeLength == 0) {
+                state->start = (i + 1) & (table->capacity - 1);
+                break;
+            }
+        }
+    }
+}
+
 static _PARCHashMapIterator *
-_parcHashMap_Init(PARCHashMap *map __attribute__((unused)))
+_parcHashMap_Init(PARCHashMap *map)
 {
     _PARCHashMapIterator *state = parcMemory_AllocateAndClear(sizeof(_PARCHashMapIterator));
 
     if (state != NULL) {
         state->map = map;
-        state->bucket = 0;
-        state->listIterator = parcLinkedList_CreateIterator(map->buckets[0]);
-
-        trapOutOfMemoryIf(state->listIterator == NULL, "Cannot create parcLinkedList_CreateIterator");
+        state->current = NULL;
+        _parcHashMapIterator_Begin(state, _parcHashMap_IsDraining(map) ? &map->draining : &map->table);
     }
 
     return state;
 }
 
 static bool
-_parcHashMap_Fini(PARCHashMap *map __attribute__((unused)), _PARCHashMapIterator *state __attribute__((unused)))
+_parcHashMap_Fini(PARCHashMap *map __attribute__((unused)), _PARCHashMapIterator *state)
 {
-    parcIterator_Release(&state->listIterator);
     parcMemory_Deallocate(&state);
     return true;
 }
 
+static bool
+_parcHashMap_HasNext(PARCHashMap *map, _PARCHashMapIterator *state)
+{
+    for (;;) {
+        _PARCHashMapTable *table = state->table;
+        while (state->step < table->capacity) {
+            size_t index = (state->start + state->step) & (table->capacity - 1);
+            if (_parcHashMapSlot_IsOccupied(&table->slots[index])) {
+                state->index = index;
+                return true;
+            }
+            state->step++;
+        }
+        if (table == &map->table) {
+            return false;
+        }
+        _parcHashMapIterator_Begin(state, &map->table);
+    }
+}
+
 static _PARCHashMapIterator *
-_parcHashMap_Next(PARCHashMap *map __attribute__((unused)), _PARCHashMapIterator *state)
+_parcHashMap_Next(PARCHashMap *map, _PARCHashMapIterator *state)
 {
-    _PARCHashMapEntry *result = parcIterator_Next(state->listIterator);
-    state->current = result;
+    bool hasNext = _parcHashMap_HasNext(map, state);
+    trapOutOfBoundsIf(hasNext == false, "No more elements in the PARCHashMap");
+
+    state->current = &state->table->slots[state->index];
+    state->step++;
+
     return state;
 }
 
 static void
-_parcHashMap_Remove(PARCHashMap *map, _PARCHashMapIterator **statePtr __attribute__((unused)))
+_parcHashMap_Remove(PARCHashMap *map, _PARCHashMapIterator **statePtr)
 {
     _PARCHashMapIterator *state = *statePtr;
 
-    parcIterator_Remove(state->listIterator);
-    map->size--;
-}
-
-static bool
-_parcHashMap_HasNext(PARCHashMap *map __attribute__((unused)), _PARCHashMapIterator *state)
-{
-    bool result = false;
-
-    if (parcIterator_HasNext(state->listIterator)) {
-        result = true;
+    if (state->table == &map->table) {
+        _parcHashMapTable_RemoveAt(state->table, state->index);
+        state->step--;
     } else {
-        while (result == false && ++state->bucket < map->capacity) {
-            parcIterator_Release(&state->listIterator);
-            state->listIterator = parcLinkedList_CreateIterator(map->buckets[state->bucket]);
-            trapOutOfMemoryIf(state->listIterator == NULL, "Cannot create parcLinkedList_CreateIterator");
-            result = parcIterator_HasNext(state->listIterator);
-        }
+        _parcHashMapTable_Bury(state->table, state->current);
     }
-
-    return result;
+    state->current = NULL;
 }
 
 static PARCObject *
@@ -563,3 +842,39 @@ parcHashMap_CreateKeyIterator(PARCHashMap *hashMap)
 
     return iterator;
 }
+
+/*
+ * A cursor walks the slots of the draining table, if any, and then those of the current table.
+ * It cannot remove entries, so unlike the iterator it need not care where a walk starts.
+ */
+void
+parcHashMap_InitCursor(const PARCHashMap *hashMap, PARCCursor *cursor)
+{
+    const _PARCHashMapTable *table = _parcHashMap_IsDraining(hashMap) ? &hashMap->draining : &hashMap->table;
+
+    *cursor = (PARCCursor) { .collection = hashMap, .position = table->slots, .index = 0, .limit = table->capacity };
+}
+
+bool
+parcHashMap_CursorNext(PARCCursor *cursor)
+{
+    const PARCHashMap *map = cursor->collection;
+
+    for (;;) {
+        const _PARCHashMapSlot *slots = cursor->position;
+        while (cursor->index < cursor->limit) {
+            const _PARCHashMapSlot *slot = &slots[cursor->index++];
+            if (_parcHashMapSlot_IsOccupied(slot)) {
+                cursor->element = slot->key;
+                cursor->value = slot->value;
+                return true;
+            }
+        }
+        if (slots == map->table.slots) {
+            return false;
+        }
+        cursor->position = map->table.slots;
+        cursor->index = 0;
+        cursor->limit = map->table.capacity;
+    }
+}
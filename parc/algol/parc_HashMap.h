@@ -40,6 +40,7 @@
 #include <parc/algol/parc_JSON.h>
 #include <parc/algol/parc_HashCode.h>
 #include <parc/algol/parc_Iterator.h>
+#include <parc/algol/parc_Cursor.h>
 
 struct PARCHashMap;
 typedef struct PARCHashMap PARCHashMap;
@@ -114,9 +115,12 @@ void parcHashMap_AssertValid(const PARCHashMap *instance);
 PARCHashMap *parcHashMap_Create(void);
 
 /**
- * Constructs an empty `PARCHashMap` with the specified number of 'buckets'.
+ * Constructs an empty `PARCHashMap` sized to hold at least @p capacity entries before it must grow.
  *
- * @param [in] capacity The number of buckets.  Must be greater than 0.
+ * The map grows automatically as entries are added,
+ * so the capacity is only a hint that avoids rehashing while the map is filled.
+ *
+ * @param [in] capacity The expected number of entries. If 0, a default capacity is used.
  *
  * @return non-NULL A pointer to a valid PARCHashMap instance.
  * @return NULL An error occurred.
@@ -546,6 +550,31 @@ bool parcHashMap_Remove(PARCHashMap *hashMap, const PARCObject *key);
  */
 size_t parcHashMap_Size(const PARCHashMap *hashMap);
 
+/**
+ * Ensure that the given `PARCHashMap` can hold at least @p count entries without growing.
+ *
+ * If the map is in the middle of an incremental resize, the resize is completed.
+ * If the map is too small to hold @p count entries, all of the entries are moved to a larger table now,
+ * rather than incrementally as entries are added.
+ * A map never shrinks as a result of this function.
+ *
+ * @param [in] hashMap A pointer to a valid PARCHashMap instance.
+ * @param [in] count The number of entries the map must be able to hold.
+ *
+ * @return The value of @p hashMap.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCHashMap *map = parcHashMap_Create();
+ *     parcHashMap_Reserve(map, 1000000);
+ *
+ *     parcHashMap_Release(&map);
+ * }
+ * @endcode
+ */
+PARCHashMap *parcHashMap_Reserve(PARCHashMap *hashMap, size_t count);
+
 /**
  * <#One Line Description#>
  *
@@ -607,4 +636,38 @@ PARCIterator *parcHashMap_CreateValueIterator(PARCHashMap *hashMap);
  * @endcode
  */
 PARCIterator *parcHashMap_CreateKeyIterator(PARCHashMap *hashMap);
+
+/**
+ * Initialise the given cursor to visit the entries, in no particular order, of the given `PARCHashMap`.
+ *
+ * The cursor is positioned before the first entry.
+ * Advance it with {@link parcHashMap_CursorNext}.
+ *
+ * @param [in] hashMap A pointer to a valid `PARCHashMap`.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcHashMap_InitCursor(hashMap, &cursor);
+ *     while (parcHashMap_CursorNext(&cursor)) {
+ *         PARCObject *key = parcCursor_GetKey(&cursor);
+ *         PARCObject *value = parcCursor_GetValue(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcHashMap_CursorNext
+ */
+void parcHashMap_InitCursor(const PARCHashMap *hashMap, PARCCursor *cursor);
+
+/**
+ * Advance the given cursor to the next entry of its `PARCHashMap`.
+ *
+ * @param [in,out] cursor A pointer to a `PARCCursor` initialised by {@link parcHashMap_InitCursor}.
+ *
+ * @return true The cursor is at the next entry.
+ * @return false There are no more entries.
+ */
+bool parcHashMap_CursorNext(PARCCursor *cursor);
 #endif
@@ -49,8 +49,10 @@ _destroy(PARCJSONArray **arrayPtr)
     PARCJSONArray *array = *arrayPtr;
     // Un-reference the JSONValue instances here because parcDeque doesn't (yet) acquire and release its own references.
 
-    for (int i = 0; i < parcDeque_Size(array->array); i++) {
-        PARCJSONValue *value = parcDeque_GetAtIndex(array->array, i);
+    PARCCursor cursor;
+    parcDeque_InitCursor(array->array, &cursor);
+    while (parcDeque_CursorNext(&cursor)) {
+        PARCJSONValue *value = parcCursor_GetElement(&cursor);
         parcJSONValue_Release(&value);
     }
     parcDeque_Release(&array->array);
@@ -146,8 +148,10 @@ parcJSONArray_BuildString(const PARCJSONArray *array, PARCBufferComposer *compos
 
     char *separator = "";
 
-    for (int i = 0; i < parcDeque_Size(array->array); i++) {
-        PARCJSONValue *value = parcDeque_GetAtIndex(array->array, i);
+    PARCCursor cursor;
+    parcDeque_InitCursor(array->array, &cursor);
+    while (parcDeque_CursorNext(&cursor)) {
+        PARCJSONValue *value = parcCursor_GetElement(&cursor);
         parcBufferComposer_PutString(composer, separator);
 
         parcJSONValue_BuildString(value, composer, compact);
@@ -300,6 +300,28 @@ parcLinkedList_CreateIterator(PARCLinkedList *list)
     return iterator;
 }
 
+void
+parcLinkedList_InitCursor(const PARCLinkedList *list, PARCCursor *cursor)
+{
+    parcLinkedList_OptionalAssertValid(list);
+
+    *cursor = (PARCCursor) { .collection = list, .position = list->head };
+}
+
+bool
+parcLinkedList_CursorNext(PARCCursor *cursor)
+{
+    _PARCLinkedListNode *node = cursor->position;
+
+    // The cursor moves past the node before returning its element, so the element may be removed.
+    bool result = (node != NULL);
+    if (result) {
+        cursor->element = node->object;
+        cursor->position = node->next;
+    }
+    return result;
+}
+
 PARCLinkedList *
 parcLinkedList_Create(void)
 {
@@ -414,12 +436,11 @@ parcLinkedList_Append(PARCLinkedList *list, const PARCObject *element)
 PARCLinkedList *
 parcLinkedList_AppendAll(PARCLinkedList *list, const PARCLinkedList *other)
 {
-    PARCIterator *iterator = parcLinkedList_CreateIterator((PARCLinkedList *) other);
-    while (parcIterator_HasNext(iterator)) {
-        PARCObject *object = parcIterator_Next(iterator);
-        parcLinkedList_Append(list, object);
+    PARCCursor cursor;
+    parcLinkedList_InitCursor(other, &cursor);
+    while (parcLinkedList_CursorNext(&cursor)) {
+        parcLinkedList_Append(list, parcCursor_GetElement(&cursor));
     }
-    parcIterator_Release(&iterator);
 
     return list;
 }
@@ -41,6 +41,7 @@
 #include <parc/algol/parc_HashCode.h>
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_Iterator.h>
+#include <parc/algol/parc_Cursor.h>
 
 struct parc_linkedlist;
 /**
@@ -98,6 +99,41 @@ void parcLinkedList_AssertValid(const PARCLinkedList *list);
  */
 PARCIterator *parcLinkedList_CreateIterator(PARCLinkedList *list);
 
+/**
+ * Initialise the given cursor to visit the elements, from first to last, of the given `PARCLinkedList`.
+ *
+ * The cursor is positioned before the first element.
+ * Advance it with {@link parcLinkedList_CursorNext}.
+ *
+ * The cursor may be used while the element it is at is removed from the list.
+ *
+ * @param [in] list A pointer to a valid `PARCLinkedList`.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcLinkedList_InitCursor(list, &cursor);
+ *     while (parcLinkedList_CursorNext(&cursor)) {
+ *         PARCObject *element = parcCursor_GetElement(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcLinkedList_CursorNext
+ */
+void parcLinkedList_InitCursor(const PARCLinkedList *list, PARCCursor *cursor);
+
+/**
+ * Advance the given cursor to the next element of its `PARCLinkedList`.
+ *
+ * @param [in,out] cursor A pointer to a `PARCCursor` initialised by {@link parcLinkedList_InitCursor}.
+ *
+ * @return true The cursor is at the next element.
+ * @return false There are no more elements.
+ */
+bool parcLinkedList_CursorNext(PARCCursor *cursor);
+
 /**
  * Acquire a new reference to an instance of `PARCLinkedList`.
  *
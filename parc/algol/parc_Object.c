@@ -50,6 +50,8 @@
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_Hash.h>
+#include <parc/algol/parc_ObjectArena.h>
+#include <parc/algol/internal_parc_ObjectArena.h>
 #include <parc/concurrent/parc_AtomicUint64.h>
 
 typedef enum {
@@ -67,17 +69,28 @@ typedef struct parc_object_locking {
 
 /**
  * This is the per-object header.
+ *
+ * Very few objects are ever locked, so the mutex and condition variable used by
+ * parcObject_Lock, parcObject_Wait and parcObject_Notify are not part of the header.
+ * They are allocated the first time the object needs them and freed when the object is.
  */
 typedef struct object_header {
     PARCReferenceCount references;
     PARCObjectDescriptor *descriptor;
     size_t objectLength;               // The number of bytes which is >= the length to store the object.
 
-    _PARCObjectLocking locking;
+    _PARCObjectLocking *locking;       // NULL until the object is first locked.
 
     unsigned char objectAlignment;    // The required aligment.  Must be a power of 2 and >= sizeof(void *).
+    unsigned char flags;              // A combination of _PARCObjectFlag values.
 } _PARCObjectHeader;
 
+typedef enum {
+    _PARCObjectFlag_Arena = 0x01,          // The object was allocated from a PARCObjectArena.
+    _PARCObjectFlag_Registered = 0x02,     // The object is on its arena's list of objects to finalize.
+    _PARCObjectFlag_ArenaFinalized = 0x04  // The object was finalized by the release of its arena.
+} _PARCObjectFlag;
+
 /**
  * Return true if the given alignment value is greater than or equal to
  * <code>sizeof(void *)</code> and is a power of 2.
@@ -146,10 +159,91 @@ _objectHeader_Descriptor(const PARCObject *object)
     return (_parcObject_Header(object)->descriptor);
 }
 
+static _PARCObjectLocking *
+_parcObjectLocking_Create(void)
+{
+    _PARCObjectLocking *result = parcMemory_Allocate(sizeof(_PARCObjectLocking));
+    trapOutOfMemoryIf(result == NULL, "Cannot allocate the locking state for a PARCObject");
+
+    pthread_mutexattr_init(&result->lockAttributes);
+    pthread_mutexattr_settype(&result->lockAttributes, PTHREAD_MUTEX_NORMAL);
+
+    pthread_mutex_init(&result->lock, &result->lockAttributes);
+
+    result->locker = (pthread_t) NULL;
+    pthread_cond_init(&result->notification, NULL);
+    result->notified = false;
+
+    return result;
+}
+
+static void
+_parcObjectLocking_Destroy(_PARCObjectLocking **lockingPtr)
+{
+    _PARCObjectLocking *locking = *lockingPtr;
+
+    pthread_cond_destroy(&locking->notification);
+    pthread_mutex_destroy(&locking->lock);
+    pthread_mutexattr_destroy(&locking->lockAttributes);
+
+    parcMemory_Deallocate(lockingPtr);
+}
+
+/*
+ * Get the locking state of the given object, if it has any.
+ */
+static inline _PARCObjectLocking *
+_objectHeader_PeekLocking(const PARCObject *object)
+{
+    return _parcObject_Header(object)->locking;
+}
+
+/*
+ * An object allocated from a PARCObjectArena that has state to free when it is finalized
+ * is registered (once) with the arena so that the arena can finalize it if it is still live when the arena is released.
+ */
+static inline void
+_objectHeader_RegisterWithArena(_PARCObjectHeader *header)
+{
+    if (header->flags & _PARCObjectFlag_Arena) {
+        unsigned char flags = __sync_fetch_and_or(&header->flags, _PARCObjectFlag_Registered);
+        if ((flags & _PARCObjectFlag_Registered) == 0) {
+            char *object = (char *) &header[1];
+            internal_parcObjectArena_Register(object - _parcObject_PrefixLength(header->objectAlignment));
+        }
+    }
+}
+
+static inline bool
+_parcObjectDescriptor_HasDestructor(const PARCObjectDescriptor *descriptor)
+{
+    return descriptor != NULL && (descriptor->destructor != NULL || descriptor->destroy != NULL);
+}
+
+/*
+ * Get the locking state of the given object, creating it if necessary.
+ *
+ * Several threads may race to create the locking state of the same object.
+ * Only one of them installs its instance, the others discard theirs and use the installed one.
+ */
 static inline _PARCObjectLocking *
 _objectHeader_Locking(const PARCObject *object)
 {
-    return &(_parcObject_Header(object)->locking);
+    _PARCObjectHeader *header = _parcObject_Header(object);
+
+    _PARCObjectLocking *result = header->locking;
+    if (result == NULL) {
+        _PARCObjectLocking *locking = _parcObjectLocking_Create();
+        if (__sync_bool_compare_and_swap(&header->locking, NULL, locking)) {
+            result = locking;
+            _objectHeader_RegisterWithArena(header);
+        } else {
+            _parcObjectLocking_Destroy(&locking);
+            result = header->locking;
+        }
+    }
+
+    return result;
 }
 
 
@@ -201,40 +295,67 @@ _parcObject_Origin(const void *object)
     return _pointerAdd(object, -_parcObject_PrefixLength(header->objectAlignment));
 }
 
-static inline PARCObjectEquals *
-_parcObject_ResolveEquals(const PARCObjectDescriptor *descriptor)
-{
-    while (descriptor->equals == NULL) {
-        descriptor = descriptor->super;
+/*
+ * Each method is the one given by the nearest descriptor, starting with the given descriptor and following its supertypes.
+ */
+static void
+_parcObjectDescriptor_ResolveMethods(const PARCObjectDescriptor *descriptor, PARCObjectMethodTable *methods)
+{
+    PARCObjectMethodTable result = { .resolved = false };
+
+    for (const PARCObjectDescriptor *d = descriptor; d != NULL; d = d->super) {
+        result.copy = (result.copy != NULL) ? result.copy : d->copy;
+        result.toString = (result.toString != NULL) ? result.toString : d->toString;
+        result.equals = (result.equals != NULL) ? result.equals : d->equals;
+        result.compare = (result.compare != NULL) ? result.compare : d->compare;
+        result.hashCode = (result.hashCode != NULL) ? result.hashCode : d->hashCode;
+        result.toJSON = (result.toJSON != NULL) ? result.toJSON : d->toJSON;
+        result.display = (result.display != NULL) ? result.display : d->display;
     }
-    return descriptor->equals;
-}
 
-static inline PARCObjectCopy *
-_parcObject_ResolveCopy(const PARCObjectDescriptor *descriptor)
-{
-    while (descriptor->copy == NULL) {
-        descriptor = descriptor->super;
-    }
-    return descriptor->copy;
+    // Assign the methods individually, leaving the resolved flag alone in case another thread has already set it.
+    methods->copy = result.copy;
+    methods->toString = result.toString;
+    methods->equals = result.equals;
+    methods->compare = result.compare;
+    methods->hashCode = result.hashCode;
+    methods->toJSON = result.toJSON;
+    methods->display = result.display;
 }
 
-static inline PARCObjectToString *
-_parcObject_ResolveToString(const PARCObjectDescriptor *descriptor)
+/*
+ * Fill in the method table of the given descriptor, if it has one and it is not already filled in.
+ *
+ * This is done when an instance is created or given a new descriptor, before any method can be dispatched through it.
+ * Threads racing to fill in the same table write the same values, so no lock is needed.
+ */
+static inline void
+_parcObjectDescriptor_PrepareMethodTable(const PARCObjectDescriptor *descriptor)
 {
-    while (descriptor->toString == NULL) {
-        descriptor = descriptor->super;
+    PARCObjectMethodTable *methods = descriptor->methods;
+    if (methods != NULL && methods->resolved == false) {
+        _parcObjectDescriptor_ResolveMethods(descriptor, methods);
+        __sync_synchronize();
+        methods->resolved = true;
     }
-    return descriptor->toString;
 }
 
-static inline PARCObjectToJSON *
-_parcObject_ResolveToJSON(const PARCObjectDescriptor *descriptor)
+/*
+ * Get the resolved methods of the given descriptor.
+ * A descriptor built without a method table has its methods resolved on every call,
+ * into a table private to the calling thread which is good until the next call.
+ */
+static inline const PARCObjectMethodTable *
+_parcObjectDescriptor_Methods(const PARCObjectDescriptor *descriptor)
 {
-    while (descriptor->toJSON == NULL) {
-        descriptor = descriptor->super;
+    static __thread PARCObjectMethodTable unattached;
+
+    const PARCObjectMethodTable *result = descriptor->methods;
+    if (result == NULL) {
+        _parcObjectDescriptor_ResolveMethods(descriptor, &unattached);
+        result = &unattached;
     }
-    return descriptor->toJSON;
+    return result;
 }
 
 static bool
@@ -338,6 +459,8 @@ _parcObject_Display(const PARCObject *object, const int indentation)
                                   object, header, header->references, header->objectAlignment, header->objectLength);
 }
 
+static PARCObjectMethodTable parcCMacro_Cat(PARCObject, _MethodTable);
+
 PARCObjectDescriptor
 parcObject_DescriptorName(PARCObject) =
 {
@@ -352,7 +475,8 @@ parcObject_DescriptorName(PARCObject) =
     .hashCode   = _parcObject_HashCode,
     .toJSON     = _parcObject_ToJSON,
     .display    = _parcObject_Display,
-    .super      = NULL
+    .super      = NULL,
+    .methods    = &parcCMacro_Cat(PARCObject, _MethodTable)
 };
 
 bool
@@ -414,15 +538,6 @@ parcObject_Acquire(const PARCObject *object)
     return (PARCObject *) object;
 }
 
-static inline PARCObjectCompare *
-_parcObject_ResolveCompare(const PARCObjectDescriptor *descriptor)
-{
-    while (descriptor->compare == NULL) {
-        descriptor = descriptor->super;
-    }
-    return descriptor->compare;
-}
-
 int
 parcObject_Compare(const PARCObject *x, const PARCObject *y)
 {
@@ -441,7 +556,7 @@ parcObject_Compare(const PARCObject *x, const PARCObject *y)
     parcObject_OptionalAssertValid(y);
 
     _PARCObjectHeader *header = _parcObject_Header(x);
-    PARCObjectCompare *compare = _parcObject_ResolveCompare(header->descriptor);
+    PARCObjectCompare *compare = _parcObjectDescriptor_Methods(header->descriptor)->compare;
     result = compare(x, y);
 
     return result;
@@ -456,7 +571,7 @@ parcObject_IsInstanceOf(const PARCObject *object, const PARCObjectDescriptor *de
         _PARCObjectHeader *header = _parcObject_Header(object);
         
         if (_parcObjectHeader_IsValid(header, object)) {
-            PARCObjectDescriptor *d = _objectHeader_Descriptor(object);
+            const PARCObjectDescriptor *d = _objectHeader_Descriptor(object);
             
             while (result == false) {
                 if (d == descriptor) {
@@ -482,7 +597,7 @@ parcObject_Equals(const PARCObject *x, const PARCObject *y)
         _PARCObjectHeader *yHeader = _parcObject_Header(y);
 
         if (xHeader->descriptor == yHeader->descriptor) {
-            PARCObjectEquals *equals = _parcObject_ResolveEquals(xHeader->descriptor);
+            PARCObjectEquals *equals = _parcObjectDescriptor_Methods(xHeader->descriptor)->equals;
             result = equals(x, y);
         }
     }
@@ -490,42 +605,24 @@ parcObject_Equals(const PARCObject *x, const PARCObject *y)
     return result;
 }
 
-static inline PARCObjectHashCode *
-_parcObject_ResolveHashCode(const PARCObjectDescriptor *descriptor)
-{
-    while (descriptor->hashCode == NULL) {
-        descriptor = descriptor->super;
-    }
-    return descriptor->hashCode;
-}
-
 PARCHashCode
 parcObject_HashCode(const PARCObject *object)
 {
     parcObject_OptionalAssertValid(object);
 
     _PARCObjectHeader *header = _parcObject_Header(object);
-    PARCObjectHashCode *hashCode = _parcObject_ResolveHashCode(header->descriptor);
+    PARCObjectHashCode *hashCode = _parcObjectDescriptor_Methods(header->descriptor)->hashCode;
 
     return hashCode(object);
 }
 
-static inline PARCObjectDisplay *
-_parcObject_ResolveDisplay(const PARCObjectDescriptor *descriptor)
-{
-    while (descriptor->display == NULL) {
-        descriptor = descriptor->super;
-    }
-    return descriptor->display;
-}
-
 void
 parcObject_Display(const PARCObject *object, const int indentation)
 {
     parcObject_OptionalAssertValid(object);
 
     _PARCObjectHeader *header = _parcObject_Header(object);
-    PARCObjectDisplay *display = _parcObject_ResolveDisplay(header->descriptor);
+    PARCObjectDisplay *display = _parcObjectDescriptor_Methods(header->descriptor)->display;
 
     display(object, indentation);
 }
@@ -536,7 +633,7 @@ parcObject_ToString(const PARCObject *object)
     parcObject_OptionalAssertValid(object);
 
     _PARCObjectHeader *header = _parcObject_Header(object);
-    PARCObjectToString *toString = _parcObject_ResolveToString(header->descriptor);
+    PARCObjectToString *toString = _parcObjectDescriptor_Methods(header->descriptor)->toString;
 
     return toString(object);
 }
@@ -547,7 +644,7 @@ parcObject_ToJSON(const PARCObject *object)
     parcObject_OptionalAssertValid(object);
 
     _PARCObjectHeader *header = _parcObject_Header(object);
-    PARCObjectToJSON *toJSON = _parcObject_ResolveToJSON(header->descriptor);
+    PARCObjectToJSON *toJSON = _parcObjectDescriptor_Methods(header->descriptor)->toJSON;
     return toJSON(object);
 }
 
@@ -585,7 +682,12 @@ parcObject_CreateInstanceImpl(const size_t objectLength, const PARCObjectDescrip
     size_t totalMemoryLength = prefixLength + objectLength;
 
     void *origin = NULL;
-    parcMemory_MemAlign(&origin, sizeof(void *), totalMemoryLength);
+    PARCObjectArena *arena = parcObjectArena_GetCurrent();
+    if (arena != NULL) {
+        origin = internal_parcObjectArena_Allocate(arena, totalMemoryLength);
+    } else {
+        parcMemory_MemAlign(&origin, sizeof(void *), totalMemoryLength);
+    }
 
     if (origin == NULL) {
         errno = ENOMEM;
@@ -599,19 +701,18 @@ parcObject_CreateInstanceImpl(const size_t objectLength, const PARCObjectDescrip
     header->objectLength = objectLength;
     header->objectAlignment = sizeof(void *);
     header->descriptor = (PARCObjectDescriptor *) descriptor;
+    header->locking = NULL;
+    header->flags = 0;
 
-    _PARCObjectLocking *locking = &header->locking;
-    if (locking != NULL) {
-        pthread_mutexattr_init(&locking->lockAttributes);
-        pthread_mutexattr_settype(&locking->lockAttributes, PTHREAD_MUTEX_NORMAL);
-
-        pthread_mutex_init(&locking->lock, &locking->lockAttributes);
-
-        locking->locker = (pthread_t) NULL;
-        pthread_cond_init(&locking->notification, NULL);
-        locking->notified = false;
+    if (arena != NULL) {
+        header->flags = _PARCObjectFlag_Arena;
+        if (_parcObjectDescriptor_HasDestructor(descriptor)) {
+            _objectHeader_RegisterWithArena(header);
+        }
     }
 
+    _parcObjectDescriptor_PrepareMethodTable(descriptor);
+
     errno = 0;
     void *result = _pointerAdd(origin, prefixLength);
     return result;
@@ -622,7 +723,7 @@ parcObject_Copy(const PARCObject *object)
 {
     parcObject_OptionalAssertValid(object);
 
-    PARCObjectCopy *copy = _parcObject_ResolveCopy(_objectHeader_Descriptor(object));
+    PARCObjectCopy *copy = _parcObjectDescriptor_Methods(_objectHeader_Descriptor(object))->copy;
     return copy(object);
 }
 
@@ -633,6 +734,13 @@ parcObject_Release(PARCObject **objectPointer)
 
     _PARCObjectHeader *header = _parcObject_Header(object);
 
+    // The release of an arena finalizes its live objects in turn,
+    // so the destructor of one may release another that has already been finalized.
+    if (header->references == 0 && (header->flags & _PARCObjectFlag_ArenaFinalized)) {
+        *objectPointer = NULL;
+        return 0;
+    }
+
     trapIllegalValueIf(header->references == 0, "PARCObject@%p references must be > 0", object);
 
     parcObject_OptionalAssertValid(object);
@@ -641,8 +749,14 @@ parcObject_Release(PARCObject **objectPointer)
 
     if (result == 0) {
         if (_parcObjectType_Destructor(header->descriptor, objectPointer)) {
-            void *origin = _parcObject_Origin(object);
-            parcMemory_Deallocate(&origin);
+            if (header->locking != NULL) {
+                _parcObjectLocking_Destroy(&header->locking);
+            }
+            // The memory of an object allocated from an arena is reclaimed when the arena is released.
+            if ((header->flags & _PARCObjectFlag_Arena) == 0) {
+                void *origin = _parcObject_Origin(object);
+                parcMemory_Deallocate(&origin);
+            }
             assertNotNull(*objectPointer, "Class implementation unnecessarily clears the object pointer.");
         } else {
             assertNull(*objectPointer, "Class implementation must clear the object pointer.");
@@ -671,11 +785,35 @@ parcObject_SetDescriptor(PARCObject *object, const PARCObjectDescriptor *descrip
     _PARCObjectHeader *header = _parcObject_Header(object);
 
     PARCObjectDescriptor *result = header->descriptor;
+    if (descriptor != NULL) {
+        _parcObjectDescriptor_PrepareMethodTable(descriptor);
+    }
     header->descriptor = (PARCObjectDescriptor *) descriptor;
 
+    if (_parcObjectDescriptor_HasDestructor(descriptor)) {
+        _objectHeader_RegisterWithArena(header);
+    }
+
     return result;
 }
 
+void
+internal_parcObject_Finalize(void *memory)
+{
+    PARCObject *object = _pointerAdd(memory, _parcObject_PrefixLength(sizeof(void *)));
+    _PARCObjectHeader *header = _parcObject_Header(object);
+
+    if (header->references > 0) {
+        header->flags |= _PARCObjectFlag_ArenaFinalized;
+        header->references = 0;
+
+        _parcObjectType_Destructor(header->descriptor, &object);
+        if (header->locking != NULL) {
+            _parcObjectLocking_Destroy(&header->locking);
+        }
+    }
+}
+
 PARCObjectDescriptor *
 parcObjectDescriptor_Create(const char *name,
                             PARCObjectDestructor *destructor,
@@ -687,11 +825,12 @@ parcObjectDescriptor_Create(const char *name,
                             PARCObjectHashCode *hashCode,
                             PARCObjectToJSON *toJSON,
                             PARCObjectDisplay *display,
-                            PARCObjectDescriptor *super)
+                            const PARCObjectDescriptor *super)
 {
     assertNotNull(super, "Supertype descriptor cannot be NULL.");
 
-    PARCObjectDescriptor *result = parcMemory_AllocateAndClear(sizeof(PARCObjectDescriptor));
+    // The method table is allocated along with the descriptor, and deallocated with it.
+    PARCObjectDescriptor *result = parcMemory_AllocateAndClear(sizeof(PARCObjectDescriptor) + sizeof(PARCObjectMethodTable));
     if (result != NULL) {
         strncpy(result->name, name, sizeof(result->name));
         result->destroy = NULL;
@@ -705,6 +844,7 @@ parcObjectDescriptor_Create(const char *name,
         result->toJSON = toJSON;
         result->display = display;
         result->super = super;
+        result->methods = (PARCObjectMethodTable *) &result[1];
     }
     return result;
 }
@@ -724,9 +864,11 @@ parcObject_Unlock(const PARCObject *object)
         _parcObjectHeader_AssertValid(header, object);
         
         if (object != NULL) {            
-            _PARCObjectLocking *locking = &header->locking;
-            locking->locker = (pthread_t) NULL;
-            result = (pthread_mutex_unlock(&locking->lock) == 0);
+            _PARCObjectLocking *locking = header->locking;
+            if (locking != NULL) {
+                locking->locker = (pthread_t) NULL;
+                result = (pthread_mutex_unlock(&locking->lock) == 0);
+            }
             
             assertTrue(result, "Attempted to unlock a unowned lock.");
         }
@@ -781,8 +923,8 @@ bool
 parcObject_IsLocked(const PARCObject *object)
 {
     parcObject_OptionalAssertValid(object);
-    _PARCObjectLocking *locking = _objectHeader_Locking(object);
-    return locking->locker != (pthread_t) NULL;
+    _PARCObjectLocking *locking = _objectHeader_PeekLocking(object);
+    return locking != NULL && locking->locker != (pthread_t) NULL;
 }
 
 void
@@ -805,10 +947,10 @@ parcObject_WaitUntil(const PARCObject *object, const struct timespec *time)
     
     parcObject_OptionalAssertValid(object);
 
-    _PARCObjectHeader *header = _parcObject_Header(object);
+    _PARCObjectLocking *locking = _objectHeader_Locking(object);
 
-    header->locking.notified = false;
-    int waitResult = pthread_cond_timedwait(&header->locking.notification, &header->locking.lock, time);
+    locking->notified = false;
+    int waitResult = pthread_cond_timedwait(&locking->notification, &locking->lock, time);
     
     if (waitResult == ETIMEDOUT) {
         result = false;
@@ -824,7 +966,7 @@ parcObject_WaitFor(const PARCObject *object, const uint64_t nanoSeconds)
     
     parcObject_OptionalAssertValid(object);
 
-    _PARCObjectHeader *header = _parcObject_Header(object);
+    _PARCObjectLocking *locking = _objectHeader_Locking(object);
     
     struct timeval now;
     gettimeofday(&now, NULL);
@@ -838,7 +980,7 @@ parcObject_WaitFor(const PARCObject *object, const uint64_t nanoSeconds)
     time.tv_sec += time.tv_nsec / 1000000000;
     time.tv_nsec = time.tv_nsec % 1000000000;
 
-    int waitResult = pthread_cond_timedwait(&header->locking.notification, &header->locking.lock, &time);
+    int waitResult = pthread_cond_timedwait(&locking->notification, &locking->lock, &time);
     
     if (waitResult == ETIMEDOUT) {
         result = false;
@@ -852,13 +994,16 @@ parcObject_Notify(const PARCObject *object)
 {
     parcObject_OptionalAssertValid(object);
 
-    _PARCObjectHeader *header = _parcObject_Header(object);
+    // An object that has never been locked cannot have any waiters.
+    _PARCObjectLocking *locking = _objectHeader_PeekLocking(object);
 
-//    trapUnexpectedStateIf(header->locking.locker == (pthread_t) NULL,
+//    trapUnexpectedStateIf(locking->locker == (pthread_t) NULL,
 //                          "You must Lock the object %p before calling parcObject_Notify", (void *) object);
 
-    header->locking.notified = true;
-    pthread_cond_signal(&header->locking.notification);
+    if (locking != NULL) {
+        locking->notified = true;
+        pthread_cond_signal(&locking->notification);
+    }
 }
 
 void
@@ -866,11 +1011,13 @@ parcObject_NotifyAll(const PARCObject *object)
 {
     parcObject_OptionalAssertValid(object);
     
-    _PARCObjectHeader *header = _parcObject_Header(object);
+    _PARCObjectLocking *locking = _objectHeader_PeekLocking(object);
     
-//    trapUnexpectedStateIf(header->locking.locker == (pthread_t) NULL,
+//    trapUnexpectedStateIf(locking->locker == (pthread_t) NULL,
 //                          "You must Lock the object %p before calling parcObject_NotifyAll", (void *) object);
     
-    header->locking.notified = true;
-    pthread_cond_broadcast(&header->locking.notification);
+    if (locking != NULL) {
+        locking->notified = true;
+        pthread_cond_broadcast(&locking->notification);
+    }
 }
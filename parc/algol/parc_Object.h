@@ -134,6 +134,26 @@ typedef void (PARCObjectDisplay)(const PARCObject *object, const int indentation
  */
 typedef PARCJSON *(PARCObjectToJSON)(const PARCObject *);
 
+/**
+ * The functions that implement a type's operations, each resolved through the chain of supertypes.
+ *
+ * A `PARCObjectDescriptor` names only the functions its type overrides and leaves the others NULL,
+ * to be inherited from its supertype.
+ * The method table holds the result of searching the supertypes once, so that dispatching an operation
+ * is a single indirect call.
+ * It is filled in when the first instance of the type is created and is not meant to be read or written by anything but the PARCObject implementation.
+ */
+typedef struct PARCObjectMethodTable {
+    bool resolved;
+    PARCObjectCopy *copy;
+    PARCObjectToString *toString;
+    PARCObjectEquals *equals;
+    PARCObjectCompare *compare;
+    PARCObjectHashCode *hashCode;
+    PARCObjectToJSON *toJSON;
+    PARCObjectDisplay *display;
+} PARCObjectMethodTable;
+
 typedef struct PARCObjectDescriptor {
     char name[32];
     PARCObjectDestroy *destroy;
@@ -146,8 +166,9 @@ typedef struct PARCObjectDescriptor {
     PARCObjectHashCode *hashCode;
     PARCObjectToJSON *toJSON;
     PARCObjectDisplay *display;
-    struct PARCObjectDescriptor *super;
+    const struct PARCObjectDescriptor *super;
     bool isLockable;
+    PARCObjectMethodTable *methods;
 } PARCObjectDescriptor;
 
 /*!
@@ -487,7 +508,8 @@ PARCObjectDescriptor *parcObject_SetDescriptor(PARCObject *object, const PARCObj
     (objectType)->hashCode = NULL, \
     (objectType)->toJSON = NULL, \
     (objectType)->display = NULL, \
-    (objectType)->super = NULL
+    (objectType)->super = NULL, \
+    (objectType)->methods = NULL
 
 /**
  * Create an allocated instance of `PARCObjectDescriptor`.
@@ -517,7 +539,7 @@ PARCObjectDescriptor *parcObjectDescriptor_Create(const char *name,
                                                   PARCObjectHashCode *hashCode,
                                                   PARCObjectToJSON *toJSON,
                                                   PARCObjectDisplay *display,
-                                                  PARCObjectDescriptor *descriptor);
+                                                  const PARCObjectDescriptor *descriptor);
 
 void parcObjectDescriptor_Destroy(PARCObjectDescriptor **descriptorPointer);
 
@@ -627,6 +649,7 @@ void parcObjectDescriptor_Destroy(PARCObjectDescriptor **descriptorPointer);
 /** \endcond */
 
 #define parcObject_Override(_subtype, _superType, ...) \
+    static PARCObjectMethodTable parcCMacro_Cat(_subtype, _MethodTable); \
     LongBowCompiler_IgnoreInitializerOverrides \
     static const PARCObjectDescriptor parcObject_DescriptorName(_subtype) = {          \
         .destroy = NULL,    \
@@ -642,6 +665,7 @@ void parcObjectDescriptor_Destroy(PARCObjectDescriptor **descriptorPointer);
         .isLockable = true, \
         .super = &parcObject_DescriptorName(_superType),    \
         .name = #_subtype,     \
+        .methods = &parcCMacro_Cat(_subtype, _MethodTable), \
         __VA_ARGS__         \
     }; \
     LongBowCompiler_WarnInitializerOverrides \
@@ -838,6 +862,9 @@ PARCObject *parcObject_CreateAndClearInstanceImpl(const size_t objectLength, con
  *
  * Implementors must avoid deadlock by attempting to lock the object a second time within the same calling thread.
  *
+ * The lock and its condition variable are allocated the first time the object is locked,
+ * and freed when the object is, so objects that are never locked do not pay for them.
+ *
  * @param [in] object A pointer to a valid `PARCObject` instance.
  *
  * @return true The lock was obtained successfully.
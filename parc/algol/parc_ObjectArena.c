@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <parc/algol/parc_ObjectArena.h>
+#include <parc/algol/internal_parc_ObjectArena.h>
+
+/*
+ * The arena is a list of blocks of memory obtained from the memory manager.
+ * Allocation advances a pointer through the first block, and starts a new block when that one is exhausted.
+ * Requests larger than a quarter of the block size are given a block of their own,
+ * placed behind the first block so that the space remaining in the first block is not wasted.
+ *
+ * Each allocation is preceded by a link which records the arena and, if the allocation is registered,
+ * chains it onto the list of allocations to be finalized when the arena is released.
+ */
+#define _PARCObjectArena_DefaultBlockSize (64 * 1024)
+#define _PARCObjectArena_MinimumBlockSize 1024
+
+typedef struct parc_object_arena_block {
+    struct parc_object_arena_block *next;
+    size_t size;
+} _PARCObjectArenaBlock;
+
+struct PARCObjectArena {
+    _PARCObjectArenaBlock *blocks;
+    char *next;                               // The next free byte in the first block.
+    char *limit;                              // The end of the first block.
+    size_t blockSize;
+    size_t count;
+    internal_PARCObjectArenaLink *registered; // The most recently registered allocation first.
+};
+
+static __thread PARCObjectArena *_parcObjectArena_Current;
+
+static inline size_t
+_parcObjectArena_Align(size_t length)
+{
+    return (length + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+static _PARCObjectArenaBlock *
+_parcObjectArena_CreateBlock(size_t size)
+{
+    _PARCObjectArenaBlock *result = parcMemory_Allocate(sizeof(_PARCObjectArenaBlock) + size);
+    if (result != NULL) {
+        result->size = size;
+        result->next = NULL;
+    }
+    return result;
+}
+
+static inline char *
+_parcObjectArenaBlock_Data(_PARCObjectArenaBlock *block)
+{
+    return (char *) &block[1];
+}
+
+/*
+ * Finalize the registered allocations in the order they were registered,
+ * so that an instance is normally destroyed before the instances it refers to.
+ */
+static void
+_parcObjectArena_FinalizeRegistered(PARCObjectArena *arena)
+{
+    internal_PARCObjectArenaLink *reversed = NULL;
+    internal_PARCObjectArenaLink *link = arena->registered;
+    while (link != NULL) {
+        internal_PARCObjectArenaLink *next = link->next;
+        link->next = reversed;
+        reversed = link;
+        link = next;
+    }
+    arena->registered = NULL;
+
+    for (link = reversed; link != NULL; link = link->next) {
+        internal_parcObject_Finalize(&link[1]);
+    }
+}
+
+static bool
+_parcObjectArena_Destructor(PARCObjectArena **instancePtr)
+{
+    PARCObjectArena *arena = *instancePtr;
+
+    assertFalse(_parcObjectArena_Current == arena, "A PARCObjectArena cannot be released while it is current.");
+
+    _parcObjectArena_FinalizeRegistered(arena);
+
+    _PARCObjectArenaBlock *block = arena->blocks;
+    while (block != NULL) {
+        _PARCObjectArenaBlock *next = block->next;
+        parcMemory_Deallocate(&block);
+        block = next;
+    }
+
+    return true;
+}
+
+parcObject_Override(PARCObjectArena, PARCObject,
+                    .destructor = (PARCObjectDestructor *) _parcObjectArena_Destructor);
+
+parcObject_ImplementAcquire(parcObjectArena, PARCObjectArena);
+
+parcObject_ImplementRelease(parcObjectArena, PARCObjectArena);
+
+void
+parcObjectArena_AssertValid(const PARCObjectArena *instance)
+{
+    assertTrue(parcObjectArena_IsValid(instance),
+               "PARCObjectArena is not valid.");
+}
+
+bool
+parcObjectArena_IsValid(const PARCObjectArena *instance)
+{
+    bool result = false;
+
+    if (instance != NULL) {
+        result = instance->blockSize >= _PARCObjectArena_MinimumBlockSize && instance->next <= instance->limit;
+    }
+
+    return result;
+}
+
+PARCObjectArena *
+parcObjectArena_CreateCapacity(size_t blockSize)
+{
+    // The arena itself must not be allocated from the current arena.
+    PARCObjectArena *current = parcObjectArena_SetCurrent(NULL);
+    PARCObjectArena *result = parcObject_CreateInstance(PARCObjectArena);
+    parcObjectArena_SetCurrent(current);
+
+    if (result != NULL) {
+        result->blocks = NULL;
+        result->next = NULL;
+        result->limit = NULL;
+        result->blockSize = _parcObjectArena_Align(blockSize < _PARCObjectArena_MinimumBlockSize ? _PARCObjectArena_MinimumBlockSize : blockSize);
+        result->count = 0;
+        result->registered = NULL;
+    }
+
+    return result;
+}
+
+PARCObjectArena *
+parcObjectArena_Create(void)
+{
+    return parcObjectArena_CreateCapacity(_PARCObjectArena_DefaultBlockSize);
+}
+
+PARCObjectArena *
+parcObjectArena_SetCurrent(PARCObjectArena *arena)
+{
+    PARCObjectArena *result = _parcObjectArena_Current;
+    _parcObjectArena_Current = arena;
+    return result;
+}
+
+PARCObjectArena *
+parcObjectArena_GetCurrent(void)
+{
+    return _parcObjectArena_Current;
+}
+
+size_t
+parcObjectArena_Size(const PARCObjectArena *arena)
+{
+    parcObjectArena_OptionalAssertValid(arena);
+
+    return arena->count;
+}
+
+void *
+internal_parcObjectArena_Allocate(PARCObjectArena *arena, size_t length)
+{
+    size_t required = sizeof(internal_PARCObjectArenaLink) + _parcObjectArena_Align(length);
+
+    char *memory;
+    if ((size_t) (arena->limit - arena->next) >= required) {
+        memory = arena->next;
+        arena->next += required;
+    } else if (required > arena->blockSize / 4) {
+        _PARCObjectArenaBlock *block = _parcObjectArena_CreateBlock(required);
+        if (block == NULL) {
+            return NULL;
+        }
+        if (arena->blocks == NULL) {
+            arena->blocks = block;
+        } else {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        }
+        memory = _parcObjectArenaBlock_Data(block);
+    } else {
+        _PARCObjectArenaBlock *block = _parcObjectArena_CreateBlock(arena->blockSize);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        arena->blocks = block;
+        memory = _parcObjectArenaBlock_Data(block);
+        arena->next = memory + required;
+        arena->limit = memory + block->size;
+    }
+
+    internal_PARCObjectArenaLink *link = (internal_PARCObjectArenaLink *) memory;
+    link->arena = arena;
+    link->next = NULL;
+    arena->count++;
+
+    return &link[1];
+}
+
+void
+internal_parcObjectArena_Register(void *memory)
+{
+    internal_PARCObjectArenaLink *link = (internal_PARCObjectArenaLink *) memory - 1;
+    PARCObjectArena *arena = link->arena;
+
+    internal_PARCObjectArenaLink *head;
+    do {
+        head = arena->registered;
+        link->next = head;
+    } while (__sync_bool_compare_and_swap(&arena->registered, head, link) == false);
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_ObjectArena.h
+ * @ingroup memory
+ * @brief A region of memory from which a thread's new PARCObject instances are allocated, and which is freed all at once.
+ *
+ * Work such as parsing a JSON document or decoding a message creates many objects that are all released together.
+ * While a `PARCObjectArena` is current on a thread, `parcObject_CreateInstance` and the other object creation functions
+ * take the memory for new instances from the arena by advancing a pointer, instead of from the memory manager.
+ *
+ * Instances allocated from an arena are reference counted like any other.
+ * Releasing the last reference runs the instance's destructor, but its memory is reclaimed only
+ * when the arena itself is released.
+ * At that time, instances that still have references and whose type has a destructor are destroyed,
+ * and the arena's memory is returned to the memory manager in a few large blocks.
+ * Instances of types without a destructor cost nothing to reclaim.
+ *
+ * No instance allocated from an arena may be used after the arena has been released.
+ *
+ * @code
+ * {
+ *     PARCObjectArena *arena = parcObjectArena_Create();
+ *     PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+ *
+ *     PARCJSON *json = parcJSON_ParseString(string);
+ *     ...
+ *     parcJSON_Release(&json);
+ *
+ *     parcObjectArena_SetCurrent(previous);
+ *     parcObjectArena_Release(&arena);
+ * }
+ * @endcode
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_ObjectArena
+#define PARCLibrary_parc_ObjectArena
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_Object.h>
+
+struct PARCObjectArena;
+typedef struct PARCObjectArena PARCObjectArena;
+
+#ifdef PARCLibrary_DISABLE_VALIDATION
+#  define parcObjectArena_OptionalAssertValid(_instance_)
+#else
+#  define parcObjectArena_OptionalAssertValid(_instance_) parcObjectArena_AssertValid(_instance_)
+#endif
+
+/**
+ * Increase the number of references to a `PARCObjectArena` instance.
+ *
+ * Note that new `PARCObjectArena` is not created,
+ * only that the given `PARCObjectArena` reference count is incremented.
+ * Discard the reference by invoking `parcObjectArena_Release`.
+ *
+ * @param [in] instance A pointer to a valid PARCObjectArena instance.
+ *
+ * @return The same value as @p instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_Create();
+ *
+ *     PARCObjectArena *b = parcObjectArena_Acquire(a);
+ *
+ *     parcObjectArena_Release(&a);
+ *     parcObjectArena_Release(&b);
+ * }
+ * @endcode
+ */
+PARCObjectArena *parcObjectArena_Acquire(const PARCObjectArena *instance);
+
+/**
+ * Assert that the given `PARCObjectArena` instance is valid.
+ *
+ * @param [in] instance A pointer to a valid PARCObjectArena instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_Create();
+ *
+ *     parcObjectArena_AssertValid(a);
+ *
+ *     parcObjectArena_Release(&a);
+ * }
+ * @endcode
+ */
+void parcObjectArena_AssertValid(const PARCObjectArena *instance);
+
+/**
+ * Create an instance of `PARCObjectArena` that obtains memory from the memory manager in blocks of a default size.
+ *
+ * The arena itself is never allocated from the current arena.
+ *
+ * @return non-NULL A pointer to a valid `PARCObjectArena` instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_Create();
+ *
+ *     parcObjectArena_Release(&a);
+ * }
+ * @endcode
+ */
+PARCObjectArena *parcObjectArena_Create(void);
+
+/**
+ * Create an instance of `PARCObjectArena` that obtains memory from the memory manager in blocks of @p blockSize bytes.
+ *
+ * Instances too large to share a block are given a block of their own.
+ *
+ * @param [in] blockSize The number of bytes in each block of memory the arena obtains.
+ *
+ * @return non-NULL A pointer to a valid `PARCObjectArena` instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_CreateCapacity(1024 * 1024);
+ *
+ *     parcObjectArena_Release(&a);
+ * }
+ * @endcode
+ */
+PARCObjectArena *parcObjectArena_CreateCapacity(size_t blockSize);
+
+/**
+ * Determine if an instance of `PARCObjectArena` is valid.
+ *
+ * Valid means the internal state of the type is consistent with its required current or future behaviour.
+ * This may include the validation of internal instances of types.
+ *
+ * @param [in] instance A pointer to a valid PARCObjectArena instance.
+ *
+ * @return true The instance is valid.
+ * @return false The instance is not valid.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_Create();
+ *
+ *     if (parcObjectArena_IsValid(a)) {
+ *         printf("Instance is valid.\n");
+ *     }
+ *
+ *     parcObjectArena_Release(&a);
+ * }
+ * @endcode
+ */
+bool parcObjectArena_IsValid(const PARCObjectArena *instance);
+
+/**
+ * Release a previously acquired reference to the given `PARCObjectArena` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * When the last reference is released, every instance allocated from the arena that has not already been destroyed
+ * is destroyed, and the arena's memory is freed.
+ * The arena must not be current on any thread when its last reference is released.
+ *
+ * @param [in,out] instancePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *a = parcObjectArena_Create();
+ *
+ *     parcObjectArena_Release(&a);
+ * }
+ * @endcode
+ */
+void parcObjectArena_Release(PARCObjectArena **instancePtr);
+
+/**
+ * Make the given `PARCObjectArena` the one from which the calling thread allocates new PARCObject instances.
+ *
+ * The thread does not acquire a reference to the arena.
+ * The caller must keep the arena valid while it is current, and must restore the previous arena,
+ * or set NULL, before the arena is released.
+ *
+ * An arena may be current on only one thread at a time.
+ *
+ * @param [in] arena A pointer to a valid `PARCObjectArena` instance, or NULL to allocate from the memory manager.
+ *
+ * @return The arena that was current on the calling thread, which may be NULL.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+ *     ...
+ *     parcObjectArena_SetCurrent(previous);
+ * }
+ * @endcode
+ */
+PARCObjectArena *parcObjectArena_SetCurrent(PARCObjectArena *arena);
+
+/**
+ * Get the `PARCObjectArena` from which the calling thread allocates new PARCObject instances.
+ *
+ * @return The current arena of the calling thread, or NULL if there is none.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcObjectArena_GetCurrent() == NULL) {
+ *         printf("New objects come from the memory manager.\n");
+ *     }
+ * }
+ * @endcode
+ */
+PARCObjectArena *parcObjectArena_GetCurrent(void);
+
+/**
+ * Get the number of PARCObject instances that have been allocated from the given `PARCObjectArena`.
+ *
+ * @param [in] arena A pointer to a valid `PARCObjectArena` instance.
+ *
+ * @return The number of instances allocated from the arena, including those that have since been released.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t count = parcObjectArena_Size(arena);
+ * }
+ * @endcode
+ */
+size_t parcObjectArena_Size(const PARCObjectArena *arena);
+#endif
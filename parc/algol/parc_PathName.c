@@ -56,8 +56,10 @@ _destroy(PARCPathName **pathNamePtr)
 {
     PARCPathName *pathName = *pathNamePtr;
 
-    for (size_t i = 0; i < parcDeque_Size(pathName->path); i++) {
-        void *name = parcDeque_GetAtIndex(pathName->path, i);
+    PARCCursor cursor;
+    parcDeque_InitCursor(pathName->path, &cursor);
+    while (parcDeque_CursorNext(&cursor)) {
+        void *name = parcCursor_GetElement(&cursor);
         parcMemory_Deallocate((void **) &name);
     }
     parcDeque_Release(&pathName->path);
@@ -251,11 +253,12 @@ parcPathName_BuildString(const PARCPathName *pathName, PARCBufferComposer *compo
         parcBufferComposer_PutString(composer, separator);
     }
 
-    size_t length = parcDeque_Size(pathName->path);
-    if (length > 0) {
-        parcBufferComposer_PutString(composer, parcDeque_GetAtIndex(pathName->path, 0));
-        for (size_t i = 1; i < length; i++) {
-            parcBufferComposer_PutStrings(composer, separator, parcDeque_GetAtIndex(pathName->path, i), NULL);
+    PARCCursor cursor;
+    parcDeque_InitCursor(pathName->path, &cursor);
+    if (parcDeque_CursorNext(&cursor)) {
+        parcBufferComposer_PutString(composer, parcCursor_GetElement(&cursor));
+        while (parcDeque_CursorNext(&cursor)) {
+            parcBufferComposer_PutStrings(composer, separator, parcCursor_GetElement(&cursor), NULL);
         }
     }
 
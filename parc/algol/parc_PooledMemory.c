@@ -0,0 +1,614 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/errno.h>
+#include <pthread.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_PooledMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
+
+/*
+ * Every block, cached or not, is preceded by a 16-byte prefix recording its size class,
+ * the distance back to the address returned by the underlying allocator, and the length requested by the caller.
+ * Keeping the prefix at 16 bytes preserves the 16-byte alignment of the underlying allocator.
+ *
+ * Cacheable blocks are grouped into size classes of 16 byte steps.
+ * A thread keeps two magazines per class, "loaded" and "previous".
+ * Allocation pops from the loaded magazine and deallocation pushes onto it.
+ * When the loaded magazine cannot satisfy the operation the thread tries the previous magazine,
+ * and only when neither can does it go to the depot, trading a whole magazine at a time.
+ * The depot keeps full and empty magazines per class, each list under its own lock.
+ *
+ * The underlying allocator is PARCStdlibMemoryAsPARCMemory.
+ */
+#define _PARCPooledMemory_Quantum 16
+#define _PARCPooledMemory_ClassCount (PARCPooledMemory_MaximumCachedSize / _PARCPooledMemory_Quantum)
+#define _PARCPooledMemory_UncachedClass UINT32_MAX
+#define _PARCPooledMemory_MagazineCapacity 32
+#define _PARCPooledMemory_DepotCapacity 64
+
+typedef struct {
+    uint32_t sizeClass;
+    uint32_t offset;            // The number of bytes from the origin of the allocation to the caller's memory.
+    uint64_t length;            // The number of bytes requested by the caller.
+} _PARCPooledMemoryPrefix;
+
+typedef struct parc_pooled_memory_magazine {
+    struct parc_pooled_memory_magazine *next;
+    size_t count;
+    void *blocks[_PARCPooledMemory_MagazineCapacity];
+} _PARCPooledMemoryMagazine;
+
+typedef struct {
+    pthread_mutex_t lock;
+    _PARCPooledMemoryMagazine *full;
+    _PARCPooledMemoryMagazine *empty;
+    size_t fullCount;
+    size_t blockCount;          // The number of blocks in the full magazines.
+} _PARCPooledMemoryDepot;
+
+typedef struct parc_pooled_memory_thread_cache {
+    struct parc_pooled_memory_thread_cache *next;
+    struct parc_pooled_memory_thread_cache *previous;
+
+    _PARCPooledMemoryMagazine *loaded[_PARCPooledMemory_ClassCount];
+    _PARCPooledMemoryMagazine *spare[_PARCPooledMemory_ClassCount];
+
+    // Only the owning thread writes these, other threads read them for statistics.
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t allocations;
+    uint64_t deallocations;
+    size_t bytesCached;         // The bytes held in this thread's magazines.
+} _PARCPooledMemoryThreadCache;
+
+static _PARCPooledMemoryDepot _parcPooledMemory_Depot[_PARCPooledMemory_ClassCount];
+
+// The caches of live threads, and the counts accumulated by threads that have exited.
+static pthread_mutex_t _parcPooledMemory_RegistryLock = PTHREAD_MUTEX_INITIALIZER;
+static _PARCPooledMemoryThreadCache *_parcPooledMemory_Registry;
+static _PARCPooledMemoryThreadCache _parcPooledMemory_Retired;
+
+static pthread_once_t _parcPooledMemory_Once = PTHREAD_ONCE_INIT;
+static pthread_key_t _parcPooledMemory_Key;
+static __thread _PARCPooledMemoryThreadCache *_parcPooledMemory_ThreadCache;
+
+static inline size_t
+_parcPooledMemory_ClassSize(uint32_t sizeClass)
+{
+    return (sizeClass + 1) * _PARCPooledMemory_Quantum;
+}
+
+static inline size_t
+_parcPooledMemory_BlockSize(uint32_t sizeClass)
+{
+    return sizeof(_PARCPooledMemoryPrefix) + _parcPooledMemory_ClassSize(sizeClass);
+}
+
+static inline uint32_t
+_parcPooledMemory_SizeClass(size_t size)
+{
+    if (size == 0 || size > PARCPooledMemory_MaximumCachedSize) {
+        return _PARCPooledMemory_UncachedClass;
+    }
+    return (uint32_t) ((size - 1) / _PARCPooledMemory_Quantum);
+}
+
+static inline _PARCPooledMemoryPrefix *
+_parcPooledMemory_Prefix(const void *memory)
+{
+    return (_PARCPooledMemoryPrefix *) memory - 1;
+}
+
+static inline void *
+_parcPooledMemory_Origin(const void *memory)
+{
+    return (char *) memory - _parcPooledMemory_Prefix(memory)->offset;
+}
+
+static void
+_parcPooledMemory_MagazineReleaseBlocks(_PARCPooledMemoryMagazine *magazine)
+{
+    for (size_t i = 0; i < magazine->count; i++) {
+        parcStdlibMemory_Deallocate(&magazine->blocks[i]);
+    }
+    magazine->count = 0;
+}
+
+static _PARCPooledMemoryMagazine *
+_parcPooledMemory_DepotTakeFull(_PARCPooledMemoryDepot *depot)
+{
+    pthread_mutex_lock(&depot->lock);
+    _PARCPooledMemoryMagazine *result = depot->full;
+    if (result != NULL) {
+        depot->full = result->next;
+        depot->fullCount--;
+        depot->blockCount -= result->count;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    return result;
+}
+
+/*
+ * Take an empty magazine from the depot, or make one.
+ */
+static _PARCPooledMemoryMagazine *
+_parcPooledMemory_DepotTakeEmpty(_PARCPooledMemoryDepot *depot)
+{
+    pthread_mutex_lock(&depot->lock);
+    _PARCPooledMemoryMagazine *result = depot->empty;
+    if (result != NULL) {
+        depot->empty = result->next;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    if (result == NULL) {
+        result = parcStdlibMemory_Allocate(sizeof(_PARCPooledMemoryMagazine));
+        if (result != NULL) {
+            result->count = 0;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Give a magazine from the given thread cache to the depot.
+ * Non-empty magazines beyond the depot's capacity are emptied back to the underlying allocator.
+ */
+static void
+_parcPooledMemory_DepotPut(_PARCPooledMemoryDepot *depot, _PARCPooledMemoryThreadCache *cache,
+                           _PARCPooledMemoryMagazine *magazine, uint32_t sizeClass)
+{
+    cache->bytesCached -= magazine->count * _parcPooledMemory_BlockSize(sizeClass);
+
+    pthread_mutex_lock(&depot->lock);
+    if (magazine->count > 0 && depot->fullCount >= _PARCPooledMemory_DepotCapacity) {
+        _parcPooledMemory_MagazineReleaseBlocks(magazine);
+    }
+    if (magazine->count > 0) {
+        magazine->next = depot->full;
+        depot->full = magazine;
+        depot->fullCount++;
+        depot->blockCount += magazine->count;
+    } else {
+        magazine->next = depot->empty;
+        depot->empty = magazine;
+    }
+    pthread_mutex_unlock(&depot->lock);
+}
+
+static void
+_parcPooledMemory_ThreadCacheFlush(_PARCPooledMemoryThreadCache *cache)
+{
+    for (uint32_t sizeClass = 0; sizeClass < _PARCPooledMemory_ClassCount; sizeClass++) {
+        _PARCPooledMemoryDepot *depot = &_parcPooledMemory_Depot[sizeClass];
+
+        if (cache->loaded[sizeClass] != NULL) {
+            _parcPooledMemory_DepotPut(depot, cache, cache->loaded[sizeClass], sizeClass);
+            cache->loaded[sizeClass] = NULL;
+        }
+        if (cache->spare[sizeClass] != NULL) {
+            _parcPooledMemory_DepotPut(depot, cache, cache->spare[sizeClass], sizeClass);
+            cache->spare[sizeClass] = NULL;
+        }
+    }
+}
+
+/*
+ * The thread-specific data destructor, invoked when a thread that used the pooled memory exits.
+ */
+static void
+_parcPooledMemory_ThreadExit(void *data)
+{
+    _PARCPooledMemoryThreadCache *cache = data;
+
+    _parcPooledMemory_ThreadCacheFlush(cache);
+
+    pthread_mutex_lock(&_parcPooledMemory_RegistryLock);
+    if (cache->previous != NULL) {
+        cache->previous->next = cache->next;
+    } else {
+        _parcPooledMemory_Registry = cache->next;
+    }
+    if (cache->next != NULL) {
+        cache->next->previous = cache->previous;
+    }
+    _parcPooledMemory_Retired.hits += cache->hits;
+    _parcPooledMemory_Retired.misses += cache->misses;
+    _parcPooledMemory_Retired.allocations += cache->allocations;
+    _parcPooledMemory_Retired.deallocations += cache->deallocations;
+    pthread_mutex_unlock(&_parcPooledMemory_RegistryLock);
+
+    _parcPooledMemory_ThreadCache = NULL;
+    free(cache);
+}
+
+static void
+_parcPooledMemory_Initialize(void)
+{
+    for (uint32_t sizeClass = 0; sizeClass < _PARCPooledMemory_ClassCount; sizeClass++) {
+        pthread_mutex_init(&_parcPooledMemory_Depot[sizeClass].lock, NULL);
+    }
+    pthread_key_create(&_parcPooledMemory_Key, _parcPooledMemory_ThreadExit);
+}
+
+static _PARCPooledMemoryThreadCache *
+_parcPooledMemory_GetThreadCache(void)
+{
+    _PARCPooledMemoryThreadCache *result = _parcPooledMemory_ThreadCache;
+
+    if (result == NULL) {
+        pthread_once(&_parcPooledMemory_Once, _parcPooledMemory_Initialize);
+
+        // The cache itself is not an allocation made on behalf of a caller, so it is not counted by the stdlib memory.
+        result = calloc(1, sizeof(_PARCPooledMemoryThreadCache));
+        trapOutOfMemoryIf(result == NULL, "Cannot allocate the pooled memory cache for this thread");
+
+        pthread_mutex_lock(&_parcPooledMemory_RegistryLock);
+        result->next = _parcPooledMemory_Registry;
+        if (result->next != NULL) {
+            result->next->previous = result;
+        }
+        _parcPooledMemory_Registry = result;
+        pthread_mutex_unlock(&_parcPooledMemory_RegistryLock);
+
+        pthread_setspecific(_parcPooledMemory_Key, result);
+        _parcPooledMemory_ThreadCache = result;
+    }
+
+    return result;
+}
+
+/*
+ * Get a cached block of the given class, or NULL if the thread and the depot have none.
+ */
+static void *
+_parcPooledMemory_CacheGet(_PARCPooledMemoryThreadCache *cache, uint32_t sizeClass)
+{
+    _PARCPooledMemoryMagazine *loaded = cache->loaded[sizeClass];
+
+    if (loaded == NULL || loaded->count == 0) {
+        _PARCPooledMemoryMagazine *spare = cache->spare[sizeClass];
+        if (spare != NULL && spare->count > 0) {
+            cache->spare[sizeClass] = loaded;
+            cache->loaded[sizeClass] = spare;
+        } else {
+            _PARCPooledMemoryDepot *depot = &_parcPooledMemory_Depot[sizeClass];
+            _PARCPooledMemoryMagazine *full = _parcPooledMemory_DepotTakeFull(depot);
+            if (full == NULL) {
+                return NULL;
+            }
+            cache->bytesCached += full->count * _parcPooledMemory_BlockSize(sizeClass);
+            if (loaded != NULL) {
+                _parcPooledMemory_DepotPut(depot, cache, loaded, sizeClass);
+            }
+            cache->loaded[sizeClass] = full;
+        }
+        loaded = cache->loaded[sizeClass];
+    }
+
+    return loaded->blocks[--loaded->count];
+}
+
+/*
+ * Keep the given block in the thread's cache.
+ * Return false if there is no room for it, in which case the caller must release it.
+ */
+static bool
+_parcPooledMemory_CachePut(_PARCPooledMemoryThreadCache *cache, uint32_t sizeClass, void *origin)
+{
+    _PARCPooledMemoryMagazine *loaded = cache->loaded[sizeClass];
+
+    if (loaded == NULL || loaded->count == _PARCPooledMemory_MagazineCapacity) {
+        _PARCPooledMemoryMagazine *spare = cache->spare[sizeClass];
+        if (spare != NULL && spare->count < _PARCPooledMemory_MagazineCapacity) {
+            cache->spare[sizeClass] = loaded;
+            cache->loaded[sizeClass] = spare;
+        } else {
+            _PARCPooledMemoryDepot *depot = &_parcPooledMemory_Depot[sizeClass];
+            _PARCPooledMemoryMagazine *empty = _parcPooledMemory_DepotTakeEmpty(depot);
+            if (empty == NULL) {
+                return false;
+            }
+            if (loaded != NULL) {
+                _parcPooledMemory_DepotPut(depot, cache, loaded, sizeClass);
+            }
+            cache->loaded[sizeClass] = empty;
+        }
+        loaded = cache->loaded[sizeClass];
+    }
+
+    loaded->blocks[loaded->count++] = origin;
+    return true;
+}
+
+static void *
+_parcPooledMemory_Format(void *origin, size_t offset, uint32_t sizeClass, size_t length)
+{
+    void *result = (char *) origin + offset;
+
+    _PARCPooledMemoryPrefix *prefix = _parcPooledMemory_Prefix(result);
+    prefix->sizeClass = sizeClass;
+    prefix->offset = (uint32_t) offset;
+    prefix->length = length;
+
+    return result;
+}
+
+/*
+ * Allocate an uncached block, aligned on the given power of 2 no smaller than the prefix.
+ */
+static void *
+_parcPooledMemory_AllocateUncached(size_t alignment, size_t size)
+{
+    void *result = NULL;
+
+    size_t offset = alignment < sizeof(_PARCPooledMemoryPrefix) ? sizeof(_PARCPooledMemoryPrefix) : alignment;
+    void *origin;
+    if (parcStdlibMemory_MemAlign(&origin, offset, offset + size) == 0) {
+        result = _parcPooledMemory_Format(origin, offset, _PARCPooledMemory_UncachedClass, size);
+    }
+
+    return result;
+}
+
+static void *
+_parcPooledMemory_Allocate(size_t alignment, size_t size)
+{
+    _PARCPooledMemoryThreadCache *cache = _parcPooledMemory_GetThreadCache();
+    void *result = NULL;
+
+    uint32_t sizeClass = _parcPooledMemory_SizeClass(size);
+    if (alignment > _PARCPooledMemory_Quantum) {
+        sizeClass = _PARCPooledMemory_UncachedClass;
+    }
+
+    if (sizeClass == _PARCPooledMemory_UncachedClass) {
+        result = _parcPooledMemory_AllocateUncached(alignment, size);
+        cache->misses++;
+    } else {
+        void *origin = _parcPooledMemory_CacheGet(cache, sizeClass);
+        if (origin != NULL) {
+            cache->bytesCached -= _parcPooledMemory_BlockSize(sizeClass);
+            cache->hits++;
+        } else {
+            origin = parcStdlibMemory_Allocate(_parcPooledMemory_BlockSize(sizeClass));
+            cache->misses++;
+        }
+        if (origin != NULL) {
+            result = _parcPooledMemory_Format(origin, sizeof(_PARCPooledMemoryPrefix), sizeClass, size);
+        }
+    }
+
+    if (result != NULL) {
+        cache->allocations++;
+    }
+
+    return result;
+}
+
+void *
+parcPooledMemory_Allocate(size_t size)
+{
+    if (size == 0) {
+        return NULL;
+    }
+
+    return _parcPooledMemory_Allocate(_PARCPooledMemory_Quantum, size);
+}
+
+void *
+parcPooledMemory_AllocateAndClear(size_t size)
+{
+    void *pointer = parcPooledMemory_Allocate(size);
+    if (pointer != NULL) {
+        memset(pointer, 0, size);
+    }
+    return pointer;
+}
+
+int
+parcPooledMemory_MemAlign(void **pointer, size_t alignment, size_t size)
+{
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    if (size == 0) {
+        return EINVAL;
+    }
+
+    *pointer = _parcPooledMemory_Allocate(alignment, size);
+
+    return (*pointer == NULL) ? ENOMEM : 0;
+}
+
+void
+parcPooledMemory_Deallocate(void **pointer)
+{
+    void *memory = *pointer;
+
+    if (memory != NULL) {
+        _PARCPooledMemoryThreadCache *cache = _parcPooledMemory_GetThreadCache();
+
+        _PARCPooledMemoryPrefix *prefix = _parcPooledMemory_Prefix(memory);
+        trapIllegalValueIf(prefix->sizeClass != _PARCPooledMemory_UncachedClass && prefix->sizeClass >= _PARCPooledMemory_ClassCount,
+                           "Memory %p was not allocated by PARCPooledMemory (or has been corrupted)", memory);
+
+        uint32_t sizeClass = prefix->sizeClass;
+        void *origin = _parcPooledMemory_Origin(memory);
+
+        if (sizeClass != _PARCPooledMemory_UncachedClass && _parcPooledMemory_CachePut(cache, sizeClass, origin)) {
+            cache->bytesCached += _parcPooledMemory_BlockSize(sizeClass);
+        } else {
+            parcStdlibMemory_Deallocate(&origin);
+        }
+
+        cache->deallocations++;
+        *pointer = NULL;
+    }
+}
+
+void *
+parcPooledMemory_Reallocate(void *pointer, size_t newSize)
+{
+    if (pointer == NULL) {
+        return parcPooledMemory_Allocate(newSize);
+    }
+    if (newSize == 0) {
+        newSize = 1;
+    }
+
+    _PARCPooledMemoryPrefix *prefix = _parcPooledMemory_Prefix(pointer);
+
+    // The block already has room for the new size.
+    if (prefix->sizeClass != _PARCPooledMemory_UncachedClass && newSize <= _parcPooledMemory_ClassSize(prefix->sizeClass)) {
+        prefix->length = newSize;
+        return pointer;
+    }
+
+    void *result = parcPooledMemory_Allocate(newSize);
+    if (result != NULL) {
+        memcpy(result, pointer, prefix->length < newSize ? prefix->length : newSize);
+        parcPooledMemory_Deallocate(&pointer);
+    }
+
+    return result;
+}
+
+char *
+parcPooledMemory_StringDuplicate(const char *string, size_t length)
+{
+    size_t actualLength = strnlen(string, length);
+
+    char *result = parcPooledMemory_Allocate(actualLength + 1);
+    if (result != NULL) {
+        memcpy(result, string, actualLength);
+        result[actualLength] = 0;
+    }
+
+    return result;
+}
+
+uint32_t
+parcPooledMemory_Outstanding(void)
+{
+    pthread_mutex_lock(&_parcPooledMemory_RegistryLock);
+    uint64_t allocations = _parcPooledMemory_Retired.allocations;
+    uint64_t deallocations = _parcPooledMemory_Retired.deallocations;
+    for (_PARCPooledMemoryThreadCache *cache = _parcPooledMemory_Registry; cache != NULL; cache = cache->next) {
+        allocations += cache->allocations;
+        deallocations += cache->deallocations;
+    }
+    pthread_mutex_unlock(&_parcPooledMemory_RegistryLock);
+
+    return (uint32_t) (allocations - deallocations);
+}
+
+void
+parcPooledMemory_GetStatistics(PARCPooledMemoryStatistics *statistics)
+{
+    pthread_once(&_parcPooledMemory_Once, _parcPooledMemory_Initialize);
+
+    pthread_mutex_lock(&_parcPooledMemory_RegistryLock);
+    statistics->hits = _parcPooledMemory_Retired.hits;
+    statistics->misses = _parcPooledMemory_Retired.misses;
+    statistics->bytesCached = 0;
+    for (_PARCPooledMemoryThreadCache *cache = _parcPooledMemory_Registry; cache != NULL; cache = cache->next) {
+        statistics->hits += cache->hits;
+        statistics->misses += cache->misses;
+        statistics->bytesCached += cache->bytesCached;
+    }
+    pthread_mutex_unlock(&_parcPooledMemory_RegistryLock);
+
+    for (uint32_t sizeClass = 0; sizeClass < _PARCPooledMemory_ClassCount; sizeClass++) {
+        _PARCPooledMemoryDepot *depot = &_parcPooledMemory_Depot[sizeClass];
+        pthread_mutex_lock(&depot->lock);
+        statistics->bytesCached += depot->blockCount * _parcPooledMemory_BlockSize(sizeClass);
+        pthread_mutex_unlock(&depot->lock);
+    }
+}
+
+void
+parcPooledMemory_Flush(void)
+{
+    _PARCPooledMemoryThreadCache *cache = _parcPooledMemory_GetThreadCache();
+    _parcPooledMemory_ThreadCacheFlush(cache);
+}
+
+void
+parcPooledMemory_Trim(void)
+{
+    pthread_once(&_parcPooledMemory_Once, _parcPooledMemory_Initialize);
+
+    for (uint32_t sizeClass = 0; sizeClass < _PARCPooledMemory_ClassCount; sizeClass++) {
+        _PARCPooledMemoryDepot *depot = &_parcPooledMemory_Depot[sizeClass];
+
+        pthread_mutex_lock(&depot->lock);
+        _PARCPooledMemoryMagazine *full = depot->full;
+        _PARCPooledMemoryMagazine *empty = depot->empty;
+        depot->full = NULL;
+        depot->empty = NULL;
+        depot->fullCount = 0;
+        depot->blockCount = 0;
+        pthread_mutex_unlock(&depot->lock);
+
+        while (full != NULL) {
+            _PARCPooledMemoryMagazine *next = full->next;
+            _parcPooledMemory_MagazineReleaseBlocks(full);
+            parcStdlibMemory_Deallocate((void **) &full);
+            full = next;
+        }
+        while (empty != NULL) {
+            _PARCPooledMemoryMagazine *next = empty->next;
+            parcStdlibMemory_Deallocate((void **) &empty);
+            empty = next;
+        }
+    }
+}
+
+PARCMemoryInterface PARCPooledMemoryAsPARCMemory = {
+    .Allocate         = (uintptr_t) parcPooledMemory_Allocate,
+    .AllocateAndClear = (uintptr_t) parcPooledMemory_AllocateAndClear,
+    .MemAlign         = (uintptr_t) parcPooledMemory_MemAlign,
+    .Deallocate       = (uintptr_t) parcPooledMemory_Deallocate,
+    .Reallocate       = (uintptr_t) parcPooledMemory_Reallocate,
+    .StringDuplicate  = (uintptr_t) parcPooledMemory_StringDuplicate,
+    .Outstanding      = (uintptr_t) parcPooledMemory_Outstanding
+};
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_PooledMemory.h
+ * @ingroup datastructures
+ *
+ * @brief A caching memory manager suitable for use by parc_Memory.[ch]
+ *
+ * Programs that create and release many small, short-lived objects spend much of their time in malloc and free.
+ * `PARCPooledMemoryAsPARCMemory` keeps released blocks of up to `PARCPooledMemory_MaximumCachedSize` bytes
+ * in per-size caches and hands them out again on the next allocation of the same size.
+ *
+ * Each thread caches blocks in its own magazines (small stacks of blocks, one pair per size),
+ * so the common allocation and deallocation paths take no locks and touch no shared cache lines.
+ * When a thread's magazine fills up or runs dry, it exchanges the whole magazine with a shared depot in one step.
+ * Magazines of threads that exit are returned to the depot.
+ *
+ * Every allocation, including every `PARCObject` instance, goes through the current memory manager,
+ * so installing this one with `parcMemory_SetInterface` pools objects without any change to their callers.
+ *
+ * @code
+ * {
+ *     parcMemory_SetInterface(&PARCPooledMemoryAsPARCMemory);
+ * }
+ * @endcode
+ *
+ * Memory must be deallocated by the same memory manager that allocated it.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libparc_parc_PooledMemory_h
+#define libparc_parc_PooledMemory_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_Memory.h>
+
+/**
+ * Allocations larger than this many bytes, or aligned on more than 16 bytes, are never cached.
+ */
+#define PARCPooledMemory_MaximumCachedSize 496
+
+extern PARCMemoryInterface PARCPooledMemoryAsPARCMemory;
+
+/**
+ * Cumulative counts of the work done by `PARCPooledMemoryAsPARCMemory`.
+ */
+typedef struct parc_pooled_memory_statistics {
+    /**
+     * The number of allocations satisfied from a cache.
+     */
+    uint64_t hits;
+    /**
+     * The number of allocations that had to be obtained from the underlying allocator.
+     */
+    uint64_t misses;
+    /**
+     * The number of bytes currently held in caches, ready for reuse.
+     */
+    size_t bytesCached;
+} PARCPooledMemoryStatistics;
+
+/**
+ * Allocate memory.
+ *
+ * @param [in] size The size of memory to allocate
+ *
+ * @return A pointer to the allocated memory, aligned on 16 bytes.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *memory = parcPooledMemory_Allocate(100);
+ *
+ *     parcPooledMemory_Deallocate(&memory);
+ * }
+ * @endcode
+ */
+void *parcPooledMemory_Allocate(size_t size);
+
+/**
+ * Allocate memory of size @p size and clear it.
+ *
+ * @param [in] size Size of memory to allocate
+ *
+ * @return A pointer to the allocated memory
+ *
+ * Example:
+ * @code
+ * {
+ *     void *memory = parcPooledMemory_AllocateAndClear(100);
+ *
+ *     parcPooledMemory_Deallocate(&memory);
+ * }
+ * @endcode
+ */
+void *parcPooledMemory_AllocateAndClear(size_t size);
+
+/**
+ * Allocate aligned memory.
+ *
+ * Allocates @p size bytes of memory such that the allocation's
+ * base address is an exact multiple of alignment,
+ * and returns the allocation in the value pointed to by @p pointer.
+ *
+ * The requested alignment must be a power of 2 greater than or equal to `sizeof(void *)`.
+ * Allocations aligned on more than 16 bytes are not cached.
+ *
+ * @param [out] pointer A pointer to a `void *` pointer that will be set to the address of the allocated memory.
+ * @param [in] alignment A power of 2 greater than or equal to `sizeof(void *)`
+ * @param [in] size The number of bytes to allocate.
+ *
+ * @return 0 Successful
+ * @return EINVAL The alignment parameter is not a power of 2 at least as large as sizeof(void *)
+ * @return ENOMEM Memory allocation error.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *allocatedMemory;
+ *
+ *     int failure = parcPooledMemory_MemAlign(&allocatedMemory, sizeof(void *), 100);
+ *     if (failure == 0) {
+ *         parcPooledMemory_Deallocate(&allocatedMemory);
+ *         // allocatedMemory is now equal to zero.
+ *     }
+ * }
+ * @endcode
+ * @see {@link parcMemory_MemAlign}
+ */
+int parcPooledMemory_MemAlign(void **pointer, size_t alignment, size_t size);
+
+/**
+ * Deallocate the memory pointed to by @p pointer
+ *
+ * Small blocks are kept in the calling thread's cache for reuse.
+ *
+ * @param [in,out] pointer A pointer to a pointer to the memory to be deallocated
+ *
+ * Example:
+ * @code
+ * {
+ *     void *memory = parcPooledMemory_Allocate(100);
+ *
+ *     parcPooledMemory_Deallocate(&memory);
+ * }
+ * @endcode
+ */
+void parcPooledMemory_Deallocate(void **pointer);
+
+/**
+ * Resizes previously allocated memory at @p pointer to @p newSize. If necessary,
+ * new memory is allocated and the content copied from the old memory to the
+ * new memory and the old memory is deallocated.
+ *
+ * @param [in,out] pointer A pointer to the memory to be reallocated.
+ * @param [in] newSize The size that the memory to be resized to.
+ *
+ * @return A pointer to the memory
+ *
+ * Example:
+ * @code
+ * {
+ *     void *memory = parcPooledMemory_Allocate(100);
+ *
+ *     memory = parcPooledMemory_Reallocate(memory, 200);
+ *
+ *     parcPooledMemory_Deallocate(&memory);
+ * }
+ * @endcode
+ */
+void *parcPooledMemory_Reallocate(void *pointer, size_t newSize);
+
+/**
+ * Allocate sufficient memory for a copy of the string @p string,
+ * copy at most n characters from the string @p string into the allocated memory,
+ * and return the pointer to allocated memory.
+ *
+ * The copied string is always null-terminated.
+ *
+ * @param [in] string A pointer to a null-terminated string.
+ * @param [in] length  The maximum allowed length of the resulting copy.
+ *
+ * @return non-NULL A pointer to allocated memory.
+ * @return NULL A an error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     char *string = "this is a string";
+ *     char *copy = parcPooledMemory_StringDuplicate(string, strlen(string));
+ *
+ *     if (copy != NULL) {
+ *         . . .
+ *         parcPooledMemory_Deallocate(&copy);
+ *     }
+ * }
+ * @endcode
+ */
+char *parcPooledMemory_StringDuplicate(const char *string, size_t length);
+
+/**
+ * Return the number of outstanding allocations managed by this allocator.
+ *
+ * Blocks held in caches are not outstanding.
+ *
+ * @return The number of memory allocations still outstanding (remaining to be deallocated).
+ *
+ * Example:
+ * @code
+ * {
+ *     uint32_t numberOfAllocations = parcPooledMemory_Outstanding();
+ * }
+ * @endcode
+ */
+uint32_t parcPooledMemory_Outstanding(void);
+
+/**
+ * Fill in @p statistics with the current hit, miss and cache size counts.
+ *
+ * The counts of other threads are read while they may be changing, so the result is approximate.
+ *
+ * @param [out] statistics A pointer to a `PARCPooledMemoryStatistics` structure.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCPooledMemoryStatistics statistics;
+ *     parcPooledMemory_GetStatistics(&statistics);
+ *     printf("hits %" PRIu64 " misses %" PRIu64 "\n", statistics.hits, statistics.misses);
+ * }
+ * @endcode
+ */
+void parcPooledMemory_GetStatistics(PARCPooledMemoryStatistics *statistics);
+
+/**
+ * Return the blocks cached by the calling thread to the shared depot.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcPooledMemory_Flush();
+ * }
+ * @endcode
+ */
+void parcPooledMemory_Flush(void);
+
+/**
+ * Release every block held in the shared depot to the underlying allocator.
+ *
+ * Blocks cached by threads other than the caller are not affected.
+ * Use `parcPooledMemory_Flush` and `parcPooledMemory_Trim` together to release all of the calling thread's blocks.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcPooledMemory_Flush();
+ *     parcPooledMemory_Trim();
+ * }
+ * @endcode
+ */
+void parcPooledMemory_Trim(void);
+#endif // libparc_parc_PooledMemory_h
@@ -37,6 +37,18 @@
  * The Heap property is a[n] <= a[2n+1] and a[k] <= a[2k+2].  We need to move things around
  * sufficiently for this property to remain true.
  *
+ * An addressable queue (parcPriorityQueue_CreateAddressable) keeps a handle with each entry that
+ * records where the entry is in the array.  Every move of an entry updates its handle, so a handle
+ * finds its entry in O(1) and DecreaseKey, IncreaseKey and RemoveHandle are a single sift of O(log n).
+ * Handles refer to slots carved out of chunks that the queue keeps until it is destroyed, so adding an
+ * element does not normally allocate.  A slot is reused for later elements, so each handle also
+ * carries the slot's generation, which changes whenever the slot is freed; a stale handle no longer
+ * matches it.
+ *
+ * The sifts of an addressable queue work for any number of children per node.  Wider heaps are
+ * shallower, but every comparison here dereferences the caller's data, so each extra child costs a
+ * cache miss rather than sharing one, and 4 children measured about 30% slower than 2.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
@@ -47,13 +59,32 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_PriorityQueue.h>
 
+#define _PARCPriorityQueue_Arity 2
+#define _PARCPriorityQueue_HandlesPerChunk 64
+
+// The index of a slot whose element is no longer in the queue.
+#define _PARCPriorityQueue_NoIndex SIZE_MAX
+
+typedef struct parc_priority_queue_slot {
+    size_t index;                               // where the entry is in the array
+    uint64_t generation;                        // incremented each time the slot is freed
+    struct parc_priority_queue_slot *nextFree;  // the free list, while the slot is not in use
+} _HandleSlot;
+
+typedef struct handle_chunk {
+    struct handle_chunk *next;
+    _HandleSlot slots[_PARCPriorityQueue_HandlesPerChunk];
+} _HandleChunk;
+
 typedef struct heap_entry {
     void *data;
+    _HandleSlot *slot;                      // NULL unless the queue is addressable
 } HeapEntry;
 
 struct parc_priority_queue {
@@ -63,6 +94,10 @@ struct parc_priority_queue {
 
     PARCPriorityQueueCompareTo *compare;
     PARCPriorityQueueDestroyer *destroyer;
+
+    bool addressable;       // entries have handles and are moved by the _sift functions
+    _HandleChunk *chunks;
+    _HandleSlot *freeSlots;
 };
 
 /**
@@ -115,9 +150,9 @@ _swap(PARCPriorityQueue *queue, size_t firstIndex, size_t secondIndex)
  *      /  \     ===>     / \
  *     9    6            9   50
  *
- * Case 2: Right child exists and r.value < n.value && l.value <= r.value
+ * Case 2: Right child exists and l.value < n.value && l.value <= r.value
  *   In this case swap(n.index, l.index) and set n.index = l.index
- *   This makes sense by transitivity that l <= r < n, so swap(n,l) satisfies the invariant.
+ *   This makes sense as l <= r and l < n, so swap(n,l) satisfies the invariant.
  *       50                6
  *      /  \     ===>     / \
  *     6    9            50  9
@@ -125,16 +160,16 @@ _swap(PARCPriorityQueue *queue, size_t firstIndex, size_t secondIndex)
 static size_t
 _trickleRightChild(PARCPriorityQueue *queue, size_t elementIndex, size_t leftChildIndex, size_t rightChildIndex)
 {
-    if (queue->compare(queue->array[rightChildIndex].data, queue->array[elementIndex].data) < 0) {
-        if (queue->compare(queue->array[rightChildIndex].data, queue->array[leftChildIndex].data) < 0) {
+    if (queue->compare(queue->array[rightChildIndex].data, queue->array[leftChildIndex].data) < 0) {
+        if (queue->compare(queue->array[rightChildIndex].data, queue->array[elementIndex].data) < 0) {
             // Case 1
             _swap(queue, rightChildIndex, elementIndex);
             elementIndex = rightChildIndex;
-        } else {
-            // Case 2
-            _swap(queue, leftChildIndex, elementIndex);
-            elementIndex = leftChildIndex;
         }
+    } else if (queue->compare(queue->array[leftChildIndex].data, queue->array[elementIndex].data) < 0) {
+        // Case 2
+        _swap(queue, leftChildIndex, elementIndex);
+        elementIndex = leftChildIndex;
     }
     return elementIndex;
 }
@@ -172,9 +207,9 @@ _trickleLeftChild(PARCPriorityQueue *queue, size_t elementIndex, size_t leftChil
  *      /  \     ===>     / \
  *     9    6            9   50
  *
- * Case 2: Right child exists and r.value < n.value && l.value <= r.value
+ * Case 2: Right child exists and l.value < n.value && l.value <= r.value
  *   In this case swap(n.index, l.index) and set n.index = l.index
- *   This makes sense by transitivity that l <= r < n, so swap(n,l) satisfies the invariant.
+ *   This makes sense as l <= r and l < n, so swap(n,l) satisfies the invariant.
  *       50                6
  *      /  \     ===>     / \
  *     6    9            50  9
@@ -212,17 +247,19 @@ _trickleDown(PARCPriorityQueue *queue, size_t elementIndex)
     while (!finished) {
         size_t rightChildIndex = _rightChildIndex(elementIndex);
         size_t leftChildIndex = _leftChildIndex(elementIndex);
+        size_t nextElementIndex = elementIndex;
 
         if (rightChildIndex < queue->size) {
             // Case 1 and Case 2
-            elementIndex = _trickleRightChild(queue, elementIndex, leftChildIndex, rightChildIndex);
+            nextElementIndex = _trickleRightChild(queue, elementIndex, leftChildIndex, rightChildIndex);
         } else if (leftChildIndex < queue->size) {
             // Case 3
-            elementIndex = _trickleLeftChild(queue, elementIndex, leftChildIndex);
-        } else {
-            // Case 4, we're done
-            finished = true;
+            nextElementIndex = _trickleLeftChild(queue, elementIndex, leftChildIndex);
         }
+
+        // Case 4, we're done if there was no child or the element did not move
+        finished = (nextElementIndex == elementIndex);
+        elementIndex = nextElementIndex;
     }
 }
 
@@ -270,6 +307,186 @@ _expand(PARCPriorityQueue *queue)
     queue->array = parcMemory_Reallocate(queue->array, sizeof(HeapEntry) * queue->capacity);
 }
 
+// ================================
+// Addressable heap
+
+/**
+ * 0-based array indexing, so the first child is at (arity * n) + 1 and the parent is at (n-1)/arity
+ */
+static size_t
+_firstChildIndexOf(size_t elementIndex)
+{
+    return _PARCPriorityQueue_Arity * elementIndex + 1;
+}
+
+static size_t
+_parentIndexOf(size_t elementIndex)
+{
+    return (elementIndex - 1) / _PARCPriorityQueue_Arity;
+}
+
+static _HandleSlot *
+_acquireSlot(PARCPriorityQueue *queue)
+{
+    if (queue->freeSlots == NULL) {
+        _HandleChunk *chunk = parcMemory_Allocate(sizeof(_HandleChunk));
+        assertNotNull(chunk, "parcMemory_Allocate(%zu) returned NULL", sizeof(_HandleChunk));
+        chunk->next = queue->chunks;
+        queue->chunks = chunk;
+        for (size_t i = 0; i < _PARCPriorityQueue_HandlesPerChunk; i++) {
+            chunk->slots[i].index = _PARCPriorityQueue_NoIndex;
+            chunk->slots[i].generation = 0;
+            chunk->slots[i].nextFree = queue->freeSlots;
+            queue->freeSlots = &chunk->slots[i];
+        }
+    }
+
+    _HandleSlot *slot = queue->freeSlots;
+    queue->freeSlots = slot->nextFree;
+    slot->nextFree = NULL;
+    return slot;
+}
+
+static void
+_releaseSlot(PARCPriorityQueue *queue, _HandleSlot *slot)
+{
+    slot->index = _PARCPriorityQueue_NoIndex;
+    slot->generation++;
+    slot->nextFree = queue->freeSlots;
+    queue->freeSlots = slot;
+}
+
+static PARCPriorityQueueHandle
+_handleOf(_HandleSlot *slot)
+{
+    return (PARCPriorityQueueHandle) { .slot = slot, .generation = slot->generation };
+}
+
+/**
+ * Put an entry at the given index and tell its slot where it is.
+ */
+static void
+_place(PARCPriorityQueue *queue, size_t elementIndex, HeapEntry entry)
+{
+    queue->array[elementIndex] = entry;
+    entry.slot->index = elementIndex;
+}
+
+/**
+ * Move the entry at elementIndex up the addressable heap until its parent is less than or equal to it.
+ *
+ * Rather than swapping at each level, the entry is held aside and each larger parent is moved
+ * down into the hole, so every level costs one comparison and one move.
+ */
+static void
+_siftUp(PARCPriorityQueue *queue, size_t elementIndex)
+{
+    HeapEntry entry = queue->array[elementIndex];
+
+    while (elementIndex > 0) {
+        size_t parentIndex = _parentIndexOf(elementIndex);
+        if (queue->compare(entry.data, queue->array[parentIndex].data) >= 0) {
+            break;
+        }
+        _place(queue, elementIndex, queue->array[parentIndex]);
+        elementIndex = parentIndex;
+    }
+
+    _place(queue, elementIndex, entry);
+}
+
+/**
+ * Move the entry at elementIndex down the addressable heap until it is less than or equal to all its children.
+ *
+ * At each level the least of the children is moved up into the hole if it is less than the entry.
+ */
+static void
+_siftDown(PARCPriorityQueue *queue, size_t elementIndex)
+{
+    HeapEntry entry = queue->array[elementIndex];
+
+    for (;;) {
+        size_t firstChildIndex = _firstChildIndexOf(elementIndex);
+        if (firstChildIndex >= queue->size) {
+            break;
+        }
+
+        size_t endIndex = firstChildIndex + _PARCPriorityQueue_Arity;
+        if (endIndex > queue->size) {
+            endIndex = queue->size;
+        }
+
+        size_t leastIndex = firstChildIndex;
+        for (size_t childIndex = firstChildIndex + 1; childIndex < endIndex; childIndex++) {
+            if (queue->compare(queue->array[childIndex].data, queue->array[leastIndex].data) < 0) {
+                leastIndex = childIndex;
+            }
+        }
+
+        if (queue->compare(queue->array[leastIndex].data, entry.data) >= 0) {
+            break;
+        }
+        _place(queue, elementIndex, queue->array[leastIndex]);
+        elementIndex = leastIndex;
+    }
+
+    _place(queue, elementIndex, entry);
+}
+
+/**
+ * Remove the entry at elementIndex, filling its place with the last entry and sifting that
+ * whichever way restores the heap property.
+ */
+static void *
+_removeAt(PARCPriorityQueue *queue, size_t elementIndex)
+{
+    HeapEntry removed = queue->array[elementIndex];
+
+    queue->size--;
+    if (elementIndex < queue->size) {
+        queue->array[elementIndex] = queue->array[queue->size];
+        if (elementIndex > 0 && queue->compare(queue->array[elementIndex].data, queue->array[_parentIndexOf(elementIndex)].data) < 0) {
+            _siftUp(queue, elementIndex);
+        } else {
+            _siftDown(queue, elementIndex);
+        }
+    }
+
+    _releaseSlot(queue, removed.slot);
+    return removed.data;
+}
+
+static void
+_assertHandle(const PARCPriorityQueue *queue, PARCPriorityQueueHandle handle)
+{
+    assertNotNull(handle.slot, "Parameter handle must refer to a slot");
+    assertTrue(queue->addressable, "The queue must be created with parcPriorityQueue_CreateAddressable");
+    trapIllegalValueIf(handle.generation != handle.slot->generation,
+                       "The handle refers to an element that has left the queue");
+    trapIllegalValueIf(handle.slot->index >= queue->size || queue->array[handle.slot->index].slot != handle.slot,
+                       "The handle does not refer to an element in this queue");
+}
+
+/**
+ * Restore the heap property of the whole array bottom-up, which is O(n) rather than the O(n log n)
+ * of adding the elements one at a time.
+ */
+static void
+_heapify(PARCPriorityQueue *queue)
+{
+    if (queue->size > 1) {
+        if (queue->addressable) {
+            for (size_t i = _parentIndexOf(queue->size - 1) + 1; i-- > 0; ) {
+                _siftDown(queue, i);
+            }
+        } else {
+            for (size_t i = _parentIndex(queue->size - 1) + 1; i-- > 0; ) {
+                _trickleDown(queue, i);
+            }
+        }
+    }
+}
+
 // ================================
 // Public API
 
@@ -310,10 +527,21 @@ parcPriorityQueue_Create(PARCPriorityQueueCompareTo *compare, PARCPriorityQueueD
     queue->size = 0;
     queue->compare = compare;
     queue->destroyer = destroyer;
+    queue->addressable = false;
+    queue->chunks = NULL;
+    queue->freeSlots = NULL;
 
     return queue;
 }
 
+PARCPriorityQueue *
+parcPriorityQueue_CreateAddressable(PARCPriorityQueueCompareTo *compare, PARCPriorityQueueDestroyer *destroyer)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(compare, destroyer);
+    queue->addressable = true;
+    return queue;
+}
+
 void
 parcPriorityQueue_Destroy(PARCPriorityQueue **queuePtr)
 {
@@ -321,6 +549,11 @@ parcPriorityQueue_Destroy(PARCPriorityQueue **queuePtr)
     assertNotNull(*queuePtr, "Double pointer must dereference to non-null");
     PARCPriorityQueue *queue = *queuePtr;
     parcPriorityQueue_Clear(queue);
+    while (queue->chunks != NULL) {
+        _HandleChunk *chunk = queue->chunks;
+        queue->chunks = chunk->next;
+        parcMemory_Deallocate((void **) &chunk);
+    }
     parcMemory_Deallocate((void **) &(queue->array));
     parcMemory_Deallocate((void **) &queue);
     *queuePtr = NULL;
@@ -332,12 +565,18 @@ parcPriorityQueue_Add(PARCPriorityQueue *queue, void *data)
     assertNotNull(queue, "Parameter queue must be non-null");
     assertNotNull(data, "Parameter data must be non-null");
 
+    if (queue->addressable) {
+        parcPriorityQueue_AddHandle(queue, data);
+        return true;
+    }
+
     if (queue->size + 1 > queue->capacity) {
         _expand(queue);
     }
 
     // insert at the end of the array
     queue->array[queue->size].data = data;
+    queue->array[queue->size].slot = NULL;
 
     // increment the size before calling bubble up so invariants are true (i.e.
     // the index we're giving to BubbleUp is within the array size.
@@ -348,6 +587,96 @@ parcPriorityQueue_Add(PARCPriorityQueue *queue, void *data)
     return true;
 }
 
+PARCPriorityQueueHandle
+parcPriorityQueue_AddHandle(PARCPriorityQueue *queue, void *data)
+{
+    assertNotNull(queue, "Parameter queue must be non-null");
+    assertNotNull(data, "Parameter data must be non-null");
+    assertTrue(queue->addressable, "The queue must be created with parcPriorityQueue_CreateAddressable");
+
+    if (queue->size + 1 > queue->capacity) {
+        _expand(queue);
+    }
+
+    _HandleSlot *slot = _acquireSlot(queue);
+    queue->array[queue->size].data = data;
+    queue->array[queue->size].slot = slot;
+    queue->size++;
+    _siftUp(queue, queue->size - 1);
+
+    return _handleOf(slot);
+}
+
+bool
+parcPriorityQueue_AddAll(PARCPriorityQueue *queue, size_t count, void *data[count], PARCPriorityQueueHandle handles[])
+{
+    assertNotNull(queue, "Parameter queue must be non-null");
+    assertTrue(count == 0 || data != NULL, "Parameter data must be non-null");
+    assertTrue(handles == NULL || queue->addressable, "Handles are only available from an addressable queue");
+
+    while (queue->size + count > queue->capacity) {
+        _expand(queue);
+    }
+
+    size_t firstIndex = queue->size;
+    for (size_t i = 0; i < count; i++) {
+        assertNotNull(data[i], "Element %zu of the data must be non-null", i);
+        HeapEntry *entry = &queue->array[queue->size++];
+        entry->data = data[i];
+        entry->slot = NULL;
+        if (queue->addressable) {
+            entry->slot = _acquireSlot(queue);
+            entry->slot->index = queue->size - 1;
+            if (handles != NULL) {
+                handles[i] = _handleOf(entry->slot);
+            }
+        }
+    }
+
+    // Rebuilding the whole heap is O(size), which is cheaper than sifting up each new element
+    // unless there are only a few of them in a large heap.
+    if (count >= firstIndex / 8) {
+        _heapify(queue);
+    } else {
+        for (size_t i = firstIndex; i < queue->size; i++) {
+            if (queue->addressable) {
+                _siftUp(queue, i);
+            } else {
+                _bubbleUp(queue, i);
+            }
+        }
+    }
+
+    return count > 0;
+}
+
+void
+parcPriorityQueue_DecreaseKey(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle)
+{
+    assertNotNull(queue, "Parameter queue must be non-null");
+    _assertHandle(queue, handle);
+
+    _siftUp(queue, handle.slot->index);
+}
+
+void
+parcPriorityQueue_IncreaseKey(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle)
+{
+    assertNotNull(queue, "Parameter queue must be non-null");
+    _assertHandle(queue, handle);
+
+    _siftDown(queue, handle.slot->index);
+}
+
+void *
+parcPriorityQueue_RemoveHandle(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle)
+{
+    assertNotNull(queue, "Parameter queue must be non-null");
+    _assertHandle(queue, handle);
+
+    return _removeAt(queue, handle.slot->index);
+}
+
 void
 parcPriorityQueue_Clear(PARCPriorityQueue *queue)
 {
@@ -357,6 +686,11 @@ parcPriorityQueue_Clear(PARCPriorityQueue *queue)
             queue->destroyer(&queue->array[i].data);
         }
     }
+    if (queue->addressable) {
+        for (size_t i = 0; i < queue->size; i++) {
+            _releaseSlot(queue, queue->array[i].slot);
+        }
+    }
 
     queue->size = 0;
 }
@@ -376,6 +710,10 @@ parcPriorityQueue_Poll(PARCPriorityQueue *queue)
 {
     assertNotNull(queue, "Parameter queue must be non-null");
     if (queue->size > 0) {
+        if (queue->addressable) {
+            return _removeAt(queue, 0);
+        }
+
         void *data = queue->array[0].data;
 
         queue->size--;
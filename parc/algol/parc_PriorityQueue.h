@@ -32,6 +32,10 @@
  * The user provides a sort function and the top item will be the minimum
  * as per the < relation.
  *
+ * A queue made with {@link parcPriorityQueue_CreateAddressable} hands out a `PARCPriorityQueueHandle`
+ * for each element, with which the element can be removed or moved after its priority changes
+ * in O(log n), without rebuilding the queue.  This suits timers that are often cancelled or rescheduled.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
@@ -41,10 +45,26 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 struct parc_priority_queue;
 typedef struct parc_priority_queue PARCPriorityQueue;
 
+struct parc_priority_queue_slot;
+/**
+ * @typedef PARCPriorityQueueHandle
+ * @brief Refers to one element of an addressable `PARCPriorityQueue`.
+ *
+ * A handle is a small value that may be copied.  Its fields are private to the queue.
+ * It stays valid while its element is in the queue.  Once the element is polled, removed or cleared
+ * the handle is stale, and using it traps with `LongBowTrapIllegalValue` even after the queue
+ * has reused its storage for a later element.
+ */
+typedef struct {
+    struct parc_priority_queue_slot *slot;
+    uint64_t generation;
+} PARCPriorityQueueHandle;
+
 typedef int (PARCPriorityQueueCompareTo)(const void *a, const void *b);
 typedef void (PARCPriorityQueueDestroyer)(void **elementPtr);
 
@@ -131,6 +151,33 @@ int parcPriorityQueue_Uint64CompareTo(const void *a, const void *b);
  */
 PARCPriorityQueue *parcPriorityQueue_Create(PARCPriorityQueueCompareTo *compare, PARCPriorityQueueDestroyer *destroyer);
 
+/**
+ * Creates a priority queue whose elements can be reached through handles.
+ *
+ * The queue behaves as one made by {@link parcPriorityQueue_Create}, and in addition {@link parcPriorityQueue_AddHandle} returns a handle through which the element
+ * can be given a new priority or removed in O(log n).
+ *
+ * @param [in] compare Defines the sort order of the priority queue
+ * @param [in] destroyer Called for Clear and Destroy operations, may be NULL.
+ *
+ * @return non-null A pointer to a `PARCPriorityQueue`
+ *
+ * Example:
+ * @code
+ * PARCPriorityQueue *timers = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+ *
+ * uint64_t expiry = 100;
+ * PARCPriorityQueueHandle handle = parcPriorityQueue_AddHandle(timers, &expiry);
+ *
+ * expiry = 50;
+ * parcPriorityQueue_DecreaseKey(timers, handle);
+ *
+ * parcPriorityQueue_RemoveHandle(timers, handle);
+ * parcPriorityQueue_Destroy(&timers);
+ * @endcode
+ */
+PARCPriorityQueue *parcPriorityQueue_CreateAddressable(PARCPriorityQueueCompareTo *compare, PARCPriorityQueueDestroyer *destroyer);
+
 
 /**
  * Destroy the queue and free remaining elements.
@@ -169,6 +216,95 @@ void parcPriorityQueue_Destroy(PARCPriorityQueue **queuePtr);
  */
 bool parcPriorityQueue_Add(PARCPriorityQueue *queue, void *data);
 
+/**
+ * Add an element to an addressable priority queue, returning its handle.
+ *
+ * The handle is valid until the element leaves the queue.
+ *
+ * @param [in,out] queue A queue made by {@link parcPriorityQueue_CreateAddressable}
+ * @param [in] data The data to add to the queue, which must be comparable and not NULL
+ *
+ * @return The handle of the new element
+ *
+ * Example:
+ * @code
+ * PARCPriorityQueueHandle handle = parcPriorityQueue_AddHandle(timers, &expiry);
+ * @endcode
+ */
+PARCPriorityQueueHandle parcPriorityQueue_AddHandle(PARCPriorityQueue *queue, void *data);
+
+/**
+ * Add many elements to the priority queue at once.
+ *
+ * When the elements are many compared to those already queued, the heap is rebuilt bottom-up,
+ * which is O(n) rather than the O(n log n) of adding them one by one.
+ *
+ * @param [in,out] queue The queue to modify
+ * @param [in] count The number of elements in @p data
+ * @param [in] data The elements to add, none of which may be NULL
+ * @param [out] handles If not NULL, receives the handle of each element.  The queue must be addressable.
+ *
+ * @return true The data structure was modified by adding the new values
+ * @return false @p count was 0
+ *
+ * Example:
+ * @code
+ * uint64_t values[] = { 60, 70, 50 };
+ * void *data[] = { &values[0], &values[1], &values[2] };
+ * parcPriorityQueue_AddAll(queue, 3, data, NULL);
+ * @endcode
+ */
+bool parcPriorityQueue_AddAll(PARCPriorityQueue *queue, size_t count, void *data[count], PARCPriorityQueueHandle handles[]);
+
+/**
+ * Restore the order of the queue after the element of the handle has come to compare lower.
+ *
+ * The caller changes the element in place, then calls this.  It is O(log n).
+ *
+ * @param [in,out] queue An addressable queue
+ * @param [in] handle The handle of an element in @p queue
+ *
+ * Example:
+ * @code
+ * expiry = now + shorterTimeout;
+ * parcPriorityQueue_DecreaseKey(timers, handle);
+ * @endcode
+ */
+void parcPriorityQueue_DecreaseKey(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle);
+
+/**
+ * Restore the order of the queue after the element of the handle has come to compare higher.
+ *
+ * The caller changes the element in place, then calls this.  It is O(log n).
+ *
+ * @param [in,out] queue An addressable queue
+ * @param [in] handle The handle of an element in @p queue
+ *
+ * Example:
+ * @code
+ * expiry = now + retransmitInterval;
+ * parcPriorityQueue_IncreaseKey(timers, handle);
+ * @endcode
+ */
+void parcPriorityQueue_IncreaseKey(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle);
+
+/**
+ * Remove the element of the handle from the queue and return it.
+ *
+ * The destroyer is not called.  The handle must not be used afterwards.  It is O(log n).
+ *
+ * @param [in,out] queue An addressable queue
+ * @param [in] handle The handle of an element in @p queue
+ *
+ * @return non-null The element that was removed
+ *
+ * Example:
+ * @code
+ * parcPriorityQueue_RemoveHandle(timers, handle);
+ * @endcode
+ */
+void *parcPriorityQueue_RemoveHandle(PARCPriorityQueue *queue, PARCPriorityQueueHandle handle);
+
 /**
  * Removes all elements, calling the data structure's destroyer on each
  *
@@ -109,17 +109,16 @@ parcProperties_Display(const PARCProperties *properties, int indentation)
     parcDisplayIndented_PrintLine(indentation, "PARCProperties@%p {", properties);
     trapCannotObtainLockIf(parcHashMap_Lock(properties->properties) == false, "Cannot lock PARCProperties object.");
 
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator(properties->properties);
-    while (parcIterator_HasNext(iterator)) {
-        char *key = parcBuffer_ToString(parcIterator_Next(iterator));
-        const char *value = parcProperties_GetProperty(properties, key);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(properties->properties, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcBuffer_ToString(parcCursor_GetKey(&cursor));
+        const char *value = parcBuffer_Overlay(parcCursor_GetValue(&cursor), 0);
         parcDisplayIndented_PrintLine(indentation + 1, "%s=%s", key, value);
 
         parcMemory_Deallocate(&key);
     }
 
-    parcIterator_Release(&iterator);
-
     parcHashMap_Unlock(properties->properties);
 
     parcDisplayIndented_PrintLine(indentation, "}");
@@ -166,16 +165,15 @@ parcProperties_ToJSON(const PARCProperties *properties)
 
     trapCannotObtainLockIf(parcHashMap_Lock(properties->properties) == false, "Cannot lock PARCProperties object.");
 
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator(properties->properties);
-    while (parcIterator_HasNext(iterator)) {
-        char *key = parcBuffer_ToString(parcIterator_Next(iterator));
-        const char *value = parcProperties_GetProperty(properties, key);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(properties->properties, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcBuffer_ToString(parcCursor_GetKey(&cursor));
+        const char *value = parcBuffer_Overlay(parcCursor_GetValue(&cursor), 0);
         parcJSON_AddString(result, key, value);
         parcMemory_Deallocate(&key);
     }
 
-    parcIterator_Release(&iterator);
-
     parcHashMap_Unlock(properties->properties);
     return result;
 }
@@ -185,16 +183,15 @@ parcProperties_BuildString(const PARCProperties *properties, PARCBufferComposer
 {
     trapCannotObtainLockIf(parcHashMap_Lock(properties->properties) == false, "Cannot lock PARCProperties object.");
 
-    PARCIterator *iterator = parcHashMap_CreateKeyIterator(properties->properties);
-    while (parcIterator_HasNext(iterator)) {
-        char *key = parcBuffer_ToString(parcIterator_Next(iterator));
-        const char *value = parcProperties_GetProperty(properties, key);
+    PARCCursor cursor;
+    parcHashMap_InitCursor(properties->properties, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        char *key = parcBuffer_ToString(parcCursor_GetKey(&cursor));
+        const char *value = parcBuffer_Overlay(parcCursor_GetValue(&cursor), 0);
         parcBufferComposer_PutStrings(composer, key, "=", value, "\n", NULL);
         parcMemory_Deallocate(&key);
     }
 
-    parcIterator_Release(&iterator);
-
     parcHashMap_Unlock(properties->properties);
     return composer;
 }
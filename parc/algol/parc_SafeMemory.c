@@ -475,7 +475,7 @@ _parcSafeMemory_FormatPrefix(PARCSafeMemoryOrigin *origin, size_t requestedLengt
 
     // This abuts the prefix to the user memory, it does not start at the beginning
     // of the aligned prefix region.
-    _MemoryPrefix *prefix = (_MemoryPrefix *) (origin + (prefixSize - sizeof(_MemoryPrefix)));
+    _MemoryPrefix *prefix = _pointerAdd(origin, prefixSize - sizeof(_MemoryPrefix));
 
     prefix->magic = _parcSafeMemory_PrefixMagic;
     prefix->requestedLength = requestedLength;
@@ -30,18 +30,367 @@
  */
 #include <config.h>
 
+#include <string.h>
+
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
 #include <parc/algol/parc_Memory.h>
 
 #include <parc/algol/parc_SortedList.h>
-#include <parc/algol/parc_LinkedList.h>
+
+/*
+ * The elements are kept in a B+-tree in which every node records the number of elements beneath it.
+ *
+ * Leaves hold the elements in order and are linked to their neighbours for iteration.
+ * Interior nodes hold their children, and every node caches the first element beneath it,
+ * so a descent compares the element being located with each child's first element.
+ * The counts make positional access, `parcSortedList_GetAtIndex`, logarithmic.
+ *
+ * Nodes are split when they are full and merged with a sibling when they fall below a quarter full.
+ */
+#define _PARCSortedList_NodeCapacity 32
+#define _PARCSortedList_NodeMinimum (_PARCSortedList_NodeCapacity / 4)
+
+typedef struct parc_sorted_list_node {
+    struct parc_sorted_list_node *parent;
+    struct parc_sorted_list_node *previous;   // The previous leaf, if this is a leaf.
+    struct parc_sorted_list_node *next;       // The next leaf, if this is a leaf.
+    PARCObject *first;                        // The first element beneath this node, or NULL if there are none.
+    size_t count;                             // The number of elements beneath this node.
+    unsigned length;                          // The number of entries in use.
+    bool isLeaf;
+    void *entries[_PARCSortedList_NodeCapacity];  // Elements in a leaf, child nodes otherwise.
+} _PARCSortedListNode;
 
 struct PARCSortedList {
-    PARCLinkedList *list;
+    _PARCSortedListNode *root;
+    _PARCSortedListNode *head;                // The first leaf.
+    _PARCSortedListNode *tail;                // The last leaf.
     PARCSortedListEntryCompareFunction compare;
 };
 
+static _PARCSortedListNode *
+_parcSortedListNode_Create(bool isLeaf)
+{
+    _PARCSortedListNode *result = parcMemory_AllocateAndClear(sizeof(_PARCSortedListNode));
+    assertNotNull(result, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_PARCSortedListNode));
+    result->isLeaf = isLeaf;
+
+    return result;
+}
+
+static void
+_parcSortedListNode_Destroy(_PARCSortedListNode **nodePtr)
+{
+    _PARCSortedListNode *node = *nodePtr;
+
+    for (unsigned i = 0; i < node->length; i++) {
+        if (node->isLeaf) {
+            parcObject_Release(&node->entries[i]);
+        } else {
+            _PARCSortedListNode *child = node->entries[i];
+            _parcSortedListNode_Destroy(&child);
+        }
+    }
+
+    parcMemory_Deallocate((void **) nodePtr);
+}
+
+static inline _PARCSortedListNode *
+_parcSortedListNode_Child(const _PARCSortedListNode *node, unsigned index)
+{
+    return node->entries[index];
+}
+
+static unsigned
+_parcSortedListNode_IndexInParent(const _PARCSortedListNode *node)
+{
+    const _PARCSortedListNode *parent = node->parent;
+    unsigned result = 0;
+    while (parent->entries[result] != node) {
+        result++;
+    }
+    return result;
+}
+
+static void
+_parcSortedListNode_AdjustCount(_PARCSortedListNode *node, ssize_t delta)
+{
+    for (; node != NULL; node = node->parent) {
+        node->count += delta;
+    }
+}
+
+/*
+ * Recompute the cached first element of the given node,
+ * and of each ancestor for which the node's subtree is the leftmost.
+ */
+static void
+_parcSortedListNode_RefreshFirst(_PARCSortedListNode *node)
+{
+    while (node != NULL) {
+        PARCObject *first = NULL;
+        if (node->length > 0) {
+            first = node->isLeaf ? node->entries[0] : _parcSortedListNode_Child(node, 0)->first;
+        }
+        node->first = first;
+
+        if (node->parent == NULL || node->parent->entries[0] != node) {
+            break;
+        }
+        node = node->parent;
+    }
+}
+
+static void
+_parcSortedListNode_InsertEntry(_PARCSortedListNode *node, unsigned index, void *entry)
+{
+    memmove(&node->entries[index + 1], &node->entries[index], (node->length - index) * sizeof(void *));
+    node->entries[index] = entry;
+    node->length++;
+}
+
+static void
+_parcSortedListNode_RemoveEntry(_PARCSortedListNode *node, unsigned index)
+{
+    memmove(&node->entries[index], &node->entries[index + 1], (node->length - index - 1) * sizeof(void *));
+    node->length--;
+    if (index == 0) {
+        _parcSortedListNode_RefreshFirst(node);
+    }
+}
+
+/*
+ * Move the upper half of a full node into a new sibling, splitting the parent first if it is also full.
+ */
+static void
+_parcSortedList_Split(PARCSortedList *list, _PARCSortedListNode *node)
+{
+    if (node->parent != NULL && node->parent->length == _PARCSortedList_NodeCapacity) {
+        _parcSortedList_Split(list, node->parent);
+    }
+
+    _PARCSortedListNode *right = _parcSortedListNode_Create(node->isLeaf);
+    unsigned half = node->length / 2;
+    right->length = node->length - half;
+    memcpy(right->entries, &node->entries[half], right->length * sizeof(void *));
+    node->length = half;
+
+    if (node->isLeaf) {
+        right->count = right->length;
+        right->previous = node;
+        right->next = node->next;
+        if (node->next != NULL) {
+            node->next->previous = right;
+        } else {
+            list->tail = right;
+        }
+        node->next = right;
+    } else {
+        for (unsigned i = 0; i < right->length; i++) {
+            _PARCSortedListNode *child = right->entries[i];
+            child->parent = right;
+            right->count += child->count;
+        }
+    }
+    node->count -= right->count;
+    _parcSortedListNode_RefreshFirst(right);
+
+    if (node->parent == NULL) {
+        _PARCSortedListNode *root = _parcSortedListNode_Create(false);
+        root->entries[0] = node;
+        root->entries[1] = right;
+        root->length = 2;
+        root->count = node->count + right->count;
+        root->first = node->first;
+        node->parent = root;
+        right->parent = root;
+        list->root = root;
+    } else {
+        right->parent = node->parent;
+        _parcSortedListNode_InsertEntry(node->parent, _parcSortedListNode_IndexInParent(node) + 1, right);
+    }
+}
+
+/*
+ * Remove an empty or merged node from its parent, and restore the balance of the parent.
+ */
+static void _parcSortedList_Rebalance(PARCSortedList *list, _PARCSortedListNode *node);
+
+static void
+_parcSortedList_Unlink(PARCSortedList *list, _PARCSortedListNode *node)
+{
+    _PARCSortedListNode *parent = node->parent;
+
+    if (node->isLeaf) {
+        if (node->previous != NULL) {
+            node->previous->next = node->next;
+        } else {
+            list->head = node->next;
+        }
+        if (node->next != NULL) {
+            node->next->previous = node->previous;
+        } else {
+            list->tail = node->previous;
+        }
+    }
+
+    _parcSortedListNode_RemoveEntry(parent, _parcSortedListNode_IndexInParent(node));
+    parcMemory_Deallocate((void **) &node);
+
+    _parcSortedList_Rebalance(list, parent);
+}
+
+/*
+ * Append the entries of the right node to the left node, and remove the right node.
+ */
+static void
+_parcSortedList_Merge(PARCSortedList *list, _PARCSortedListNode *left, _PARCSortedListNode *right)
+{
+    memcpy(&left->entries[left->length], right->entries, right->length * sizeof(void *));
+    if (!left->isLeaf) {
+        for (unsigned i = 0; i < right->length; i++) {
+            _PARCSortedListNode *child = right->entries[i];
+            child->parent = left;
+        }
+    }
+    bool wasEmpty = left->length == 0;
+    left->length += right->length;
+    left->count += right->count;
+    right->length = 0;
+    right->count = 0;
+    if (wasEmpty) {
+        _parcSortedListNode_RefreshFirst(left);
+    }
+
+    _parcSortedList_Unlink(list, right);
+}
+
+static void
+_parcSortedList_Rebalance(PARCSortedList *list, _PARCSortedListNode *node)
+{
+    if (node->parent == NULL) {
+        // An interior root with a single child is replaced by the child.
+        if (!node->isLeaf && node->length == 1) {
+            list->root = _parcSortedListNode_Child(node, 0);
+            list->root->parent = NULL;
+            parcMemory_Deallocate((void **) &node);
+        }
+    } else if (node->length == 0) {
+        _parcSortedList_Unlink(list, node);
+    } else if (node->length < _PARCSortedList_NodeMinimum) {
+        _PARCSortedListNode *parent = node->parent;
+        unsigned index = _parcSortedListNode_IndexInParent(node);
+
+        if (index > 0) {
+            _PARCSortedListNode *left = _parcSortedListNode_Child(parent, index - 1);
+            if (left->length + node->length <= _PARCSortedList_NodeCapacity) {
+                _parcSortedList_Merge(list, left, node);
+            }
+        } else if (index + 1 < parent->length) {
+            _PARCSortedListNode *right = _parcSortedListNode_Child(parent, index + 1);
+            if (node->length + right->length <= _PARCSortedList_NodeCapacity) {
+                _parcSortedList_Merge(list, node, right);
+            }
+        }
+    }
+}
+
+/*
+ * Find the leaf, and the position in it, before which the given element belongs.
+ * If `after` is true, the position follows every element that compares equal to the given element,
+ * otherwise it precedes them.
+ */
+static _PARCSortedListNode *
+_parcSortedList_Locate(const PARCSortedList *list, const PARCObject *element, bool after, unsigned *positionPtr)
+{
+    int bound = after ? 0 : 1;
+    _PARCSortedListNode *node = list->root;
+
+    while (!node->isLeaf) {
+        // Find the last child whose first element precedes the element.
+        unsigned low = 1;
+        unsigned high = node->length;
+        while (low < high) {
+            unsigned middle = low + (high - low) / 2;
+            if (list->compare(element, _parcSortedListNode_Child(node, middle)->first) >= bound) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        node = _parcSortedListNode_Child(node, low - 1);
+    }
+
+    unsigned low = 0;
+    unsigned high = node->length;
+    while (low < high) {
+        unsigned middle = low + (high - low) / 2;
+        if (list->compare(element, node->entries[middle]) >= bound) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    *positionPtr = low;
+    return node;
+}
+
+/*
+ * Find the leaf, and the position in it, of the element at the given index.
+ */
+static _PARCSortedListNode *
+_parcSortedList_LocateIndex(const PARCSortedList *list, size_t index, unsigned *positionPtr)
+{
+    _PARCSortedListNode *node = list->root;
+
+    while (!node->isLeaf) {
+        unsigned i = 0;
+        while (index >= _parcSortedListNode_Child(node, i)->count) {
+            index -= _parcSortedListNode_Child(node, i)->count;
+            i++;
+        }
+        node = _parcSortedListNode_Child(node, i);
+    }
+
+    *positionPtr = (unsigned) index;
+    return node;
+}
+
+static void
+_parcSortedList_InsertAt(PARCSortedList *list, _PARCSortedListNode *leaf, unsigned position, PARCObject *element)
+{
+    if (leaf->length == _PARCSortedList_NodeCapacity) {
+        _parcSortedList_Split(list, leaf);
+        if (position > leaf->length) {
+            position -= leaf->length;
+            leaf = leaf->next;
+        }
+    }
+
+    _parcSortedListNode_InsertEntry(leaf, position, parcObject_Acquire(element));
+    _parcSortedListNode_AdjustCount(leaf, 1);
+    if (position == 0) {
+        _parcSortedListNode_RefreshFirst(leaf);
+    }
+}
+
+/*
+ * Remove the element at the given position of the given leaf, and return the list's reference to it.
+ */
+static PARCObject *
+_parcSortedList_RemoveAt(PARCSortedList *list, _PARCSortedListNode *leaf, unsigned position)
+{
+    PARCObject *result = leaf->entries[position];
+
+    _parcSortedListNode_AdjustCount(leaf, -1);
+    _parcSortedListNode_RemoveEntry(leaf, position);
+    _parcSortedList_Rebalance(list, leaf);
+
+    return result;
+}
+
 static void
 _parcSortedList_Finalize(PARCSortedList **instancePtr)
 {
@@ -50,7 +399,7 @@ _parcSortedList_Finalize(PARCSortedList **instancePtr)
 
     parcSortedList_OptionalAssertValid(instance);
 
-    parcLinkedList_Release(&instance->list);
+    _parcSortedListNode_Destroy(&instance->root);
 }
 
 parcObject_ImplementAcquire(parcSortedList, PARCSortedList);
@@ -82,7 +431,9 @@ parcSortedList_CreateCompare(PARCSortedListEntryCompareFunction compare)
     PARCSortedList *result = parcObject_CreateInstance(PARCSortedList);
 
     if (result != NULL) {
-        result->list = parcLinkedList_Create();
+        result->root = _parcSortedListNode_Create(true);
+        result->head = result->root;
+        result->tail = result->root;
         result->compare = compare;
     }
 
@@ -92,10 +443,14 @@ parcSortedList_CreateCompare(PARCSortedListEntryCompareFunction compare)
 PARCSortedList *
 parcSortedList_Copy(const PARCSortedList *original)
 {
-    PARCSortedList *result = parcObject_CreateInstance(PARCSortedList);
+    PARCSortedList *result = parcSortedList_CreateCompare(original->compare);
 
     if (result != NULL) {
-        result->list = parcLinkedList_Copy(original->list);
+        for (_PARCSortedListNode *leaf = original->head; leaf != NULL; leaf = leaf->next) {
+            for (unsigned i = 0; i < leaf->length; i++) {
+                _parcSortedList_InsertAt(result, result->tail, result->tail->length, leaf->entries[i]);
+            }
+        }
     }
 
     return result;
@@ -104,21 +459,56 @@ parcSortedList_Copy(const PARCSortedList *original)
 void
 parcSortedList_Display(const PARCSortedList *instance, int indentation)
 {
-    parcDisplayIndented_PrintLine(indentation, "PARCSortedList@%p {", instance);
-    parcLinkedList_Display(instance->list, indentation + 1);
+    parcDisplayIndented_PrintLine(indentation, "PARCSortedList@%p { .size=%zd", instance, instance->root->count);
+    for (_PARCSortedListNode *leaf = instance->head; leaf != NULL; leaf = leaf->next) {
+        for (unsigned i = 0; i < leaf->length; i++) {
+            parcObject_Display(leaf->entries[i], indentation + 1);
+        }
+    }
     parcDisplayIndented_PrintLine(indentation, "}");
 }
 
 bool
 parcSortedList_Equals(const PARCSortedList *x, const PARCSortedList *y)
 {
-    return parcLinkedList_Equals(x->list, y->list);
+    if (x == y) {
+        return true;
+    }
+    if (x == NULL || y == NULL) {
+        return false;
+    }
+    if (x->root->count != y->root->count) {
+        return false;
+    }
+
+    _PARCSortedListNode *xLeaf = x->head;
+    unsigned xPosition = 0;
+    for (_PARCSortedListNode *yLeaf = y->head; yLeaf != NULL; yLeaf = yLeaf->next) {
+        for (unsigned i = 0; i < yLeaf->length; i++) {
+            if (xPosition == xLeaf->length) {
+                xLeaf = xLeaf->next;
+                xPosition = 0;
+            }
+            if (parcObject_Equals(xLeaf->entries[xPosition], yLeaf->entries[i]) == false) {
+                return false;
+            }
+            xPosition++;
+        }
+    }
+
+    return true;
 }
 
 PARCHashCode
 parcSortedList_HashCode(const PARCSortedList *instance)
 {
-    PARCHashCode result = parcLinkedList_HashCode(instance->list);
+    PARCHashCode result = 0;
+
+    for (_PARCSortedListNode *leaf = instance->head; leaf != NULL; leaf = leaf->next) {
+        for (unsigned i = 0; i < leaf->length; i++) {
+            result += parcObject_HashCode(leaf->entries[i]);
+        }
+    }
 
     return result;
 }
@@ -129,7 +519,7 @@ parcSortedList_IsValid(const PARCSortedList *instance)
     bool result = false;
 
     if (instance != NULL) {
-        result = true;
+        result = instance->root != NULL && instance->head != NULL && instance->tail != NULL;
     }
 
     return result;
@@ -154,40 +544,62 @@ parcSortedList_ToString(const PARCSortedList *instance)
 size_t
 parcSortedList_Size(const PARCSortedList *list)
 {
-    return parcLinkedList_Size(list->list);
+    return list->root->count;
 }
 
 PARCObject *
 parcSortedList_GetAtIndex(const PARCSortedList *list, const size_t index)
 {
-    return parcLinkedList_GetAtIndex(list->list, index);
+    trapOutOfBoundsIf(index >= list->root->count, "[0, %zd]", list->root->count);
+
+    unsigned position;
+    _PARCSortedListNode *leaf = _parcSortedList_LocateIndex(list, index, &position);
+    return leaf->entries[position];
 }
 
 PARCObject *
 parcSortedList_GetFirst(const PARCSortedList *list)
 {
-    return parcLinkedList_GetAtIndex(list->list, 0);
+    PARCObject *result = NULL;
+
+    if (list->head->length > 0) {
+        result = list->head->entries[0];
+    }
+    return result;
 }
 
 PARCObject *
 parcSortedList_GetLast(const PARCSortedList *list)
 {
-    return parcLinkedList_GetAtIndex(list->list, parcLinkedList_Size(list->list) - 1);
+    PARCObject *result = NULL;
+
+    if (list->tail->length > 0) {
+        result = list->tail->entries[list->tail->length - 1];
+    }
+    return result;
 }
 
 PARCObject *
 parcSortedList_RemoveFirst(PARCSortedList *list)
 {
-    PARCObject *result = parcLinkedList_RemoveFirst(list->list);
-    
+    PARCObject *result = NULL;
+
+    if (list->head->length > 0) {
+        result = _parcSortedList_RemoveAt(list, list->head, 0);
+    }
+
     return result;
 }
 
 PARCObject *
 parcSortedList_RemoveLast(PARCSortedList *list)
 {
-    PARCObject *result = parcLinkedList_RemoveLast(list->list);
-    
+    PARCObject *result = NULL;
+
+    if (list->tail->length > 0) {
+        result = _parcSortedList_RemoveAt(list, list->tail, list->tail->length - 1);
+    }
+
     return result;
 }
 
@@ -196,70 +608,119 @@ parcSortedList_Remove(PARCSortedList *list, const PARCObject *object)
 {
     bool result = false;
 
-    PARCIterator *iterator = parcSortedList_CreateIterator(list);
-
-    while (parcIterator_HasNext(iterator)) {
-        PARCObject *o = parcIterator_Next(iterator);
-        if (parcObject_Equals(object, o)) {
-            parcIterator_Remove(iterator);
-            result = true;
-            break;
+    if (list->root->count > 0) {
+        unsigned position;
+        _PARCSortedListNode *leaf = _parcSortedList_Locate(list, object, false, &position);
+
+        // Examine each element that compares equal to the object, in case it is not also equal to it.
+        while (leaf != NULL) {
+            if (position == leaf->length) {
+                leaf = leaf->next;
+                position = 0;
+            } else if (list->compare(object, leaf->entries[position]) != 0) {
+                break;
+            } else if (parcObject_Equals(object, leaf->entries[position])) {
+                PARCObject *element = _parcSortedList_RemoveAt(list, leaf, position);
+                parcObject_Release(&element);
+                result = true;
+                break;
+            } else {
+                position++;
+            }
         }
     }
 
-    parcIterator_Release(&iterator);
-
     return result;
 }
 
-static size_t
-_parcSortedList_GetInsertionIndex(const PARCSortedList *instance, const PARCObject *element)
+typedef struct {
+    size_t index;                   // The number of elements returned by the iterator.
+    _PARCSortedListNode *leaf;      // The leaf holding the last element returned, or NULL to locate it by index.
+    unsigned position;              // The position of the last element returned in its leaf.
+} _PARCSortedListIterator;
+
+static _PARCSortedListIterator *
+_parcSortedListIterator_Init(PARCSortedList *list __attribute__((unused)))
+{
+    _PARCSortedListIterator *state = parcMemory_AllocateAndClear(sizeof(_PARCSortedListIterator));
+    assertNotNull(state, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_PARCSortedListIterator));
+    return state;
+}
+
+static bool
+_parcSortedListIterator_HasNext(PARCSortedList *list, const _PARCSortedListIterator *state)
 {
-    ssize_t low = 0;
-    ssize_t high = parcLinkedList_Size(instance->list) - 1;
+    return state->index < list->root->count;
+}
 
-    if (high == -1) {
-        return 0;
+static _PARCSortedListIterator *
+_parcSortedListIterator_Next(PARCSortedList *list, _PARCSortedListIterator *state)
+{
+    trapOutOfBoundsIf(state->index >= list->root->count, "No more elements.");
+
+    if (state->leaf != NULL && state->position + 1 < state->leaf->length) {
+        state->position++;
+    } else if (state->leaf != NULL && state->leaf->next != NULL) {
+        state->leaf = state->leaf->next;
+        state->position = 0;
+    } else {
+        state->leaf = _parcSortedList_LocateIndex(list, state->index, &state->position);
     }
+    state->index++;
 
-    while (true) {
-        ssize_t midpoint = (low + (high - low) / 2);
-        PARCObject *e = parcLinkedList_GetAtIndex(instance->list, midpoint);
-        int signum = instance->compare(element, e);
-        if (high == low) {
-            if (signum < 0) {
-                return high;
-            } else if (signum > 0) {
-                return low + 1;
-            } else {
-                return low;
-            }
-        }
+    return state;
+}
 
-        if (signum < 0) {
-            high = midpoint;
-        } else if (signum > 0) {
-            low = midpoint + 1;
-        } else {
-            return midpoint;
-        }
-    }
+/*
+ * Removing the current element may merge leaves,
+ * so the next element is located again by its index.
+ */
+static void
+_parcSortedListIterator_Remove(PARCSortedList *list, _PARCSortedListIterator **statePtr)
+{
+    _PARCSortedListIterator *state = *statePtr;
+
+    assertNotNull(state->leaf, "The iterator has no current element.");
+
+    PARCObject *element = _parcSortedList_RemoveAt(list, state->leaf, state->position);
+    parcObject_Release(&element);
+
+    state->index--;
+    state->leaf = NULL;
+}
+
+static PARCObject *
+_parcSortedListIterator_Element(PARCSortedList *list __attribute__((unused)), const _PARCSortedListIterator *state)
+{
+    return state->leaf->entries[state->position];
+}
 
-    return -1;
+static void
+_parcSortedListIterator_Fini(PARCSortedList *list __attribute__((unused)), _PARCSortedListIterator *state)
+{
+    parcMemory_Deallocate(&state);
 }
 
 PARCIterator *
 parcSortedList_CreateIterator(PARCSortedList *instance)
 {
-    return parcLinkedList_CreateIterator(instance->list);
+    PARCIterator *iterator = parcIterator_Create(instance,
+                                                 (void *(*)(PARCObject *)) _parcSortedListIterator_Init,
+                                                 (bool  (*)(PARCObject *, void *)) _parcSortedListIterator_HasNext,
+                                                 (void *(*)(PARCObject *, void *)) _parcSortedListIterator_Next,
+                                                 (void  (*)(PARCObject *, void **)) _parcSortedListIterator_Remove,
+                                                 (void *(*)(PARCObject *, void *)) _parcSortedListIterator_Element,
+                                                 (void  (*)(PARCObject *, void *)) _parcSortedListIterator_Fini,
+                                                 NULL);
+
+    return iterator;
 }
 
 void
 parcSortedList_Add(PARCSortedList *instance, PARCObject *element)
 {
-    size_t insertionPoint = _parcSortedList_GetInsertionIndex(instance, element);
-    assertTrue(insertionPoint >= 0 && insertionPoint <= parcLinkedList_Size(instance->list),
-               "%zd is bad insertion point.  Must be >=0 and <= %zd", insertionPoint, parcLinkedList_Size(instance->list));
+    unsigned position;
+    _PARCSortedListNode *leaf = _parcSortedList_Locate(instance, element, true, &position);
 
-    parcLinkedList_InsertAtIndex(instance->list, insertionPoint, element);
+    _parcSortedList_InsertAt(instance, leaf, position, element);
 }
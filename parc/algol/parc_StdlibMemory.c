@@ -53,13 +53,8 @@ _parcStdlibMemory_rplRealloc(void *oldAlloc, size_t newSize)
         newSize = 1;
     }
 
-    char *newAlloc = malloc(newSize);
-
-    if (oldAlloc != NULL) {
-        memcpy(newAlloc, oldAlloc, newSize);
-        free(oldAlloc);
-    }
-    return newAlloc;
+    // The old size is not known here, so let realloc copy only what the old allocation holds.
+    return realloc(oldAlloc, newSize);
 }
 #endif
 
@@ -33,6 +33,7 @@
 #include <LongBow/runtime.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include "parc_TreeMap.h"
 #include "parc_ArrayList.h"
@@ -40,532 +41,665 @@
 
 #include <parc/algol/parc_Memory.h>
 
-#define RED   1
-#define BLACK 0
-
-#define ASSERT_INVARIANTS
-
-struct treemap_node;
-typedef struct treemap_node _RBNode;
-
-struct treemap_node {
-    _RBNode *leftChild;
-    _RBNode *rightChild;
-    _RBNode *parent;
-    PARCKeyValue *element;
-    int color;
-};
+/*
+ * The map is a B+-tree.
+ * Every entry is held in a leaf, and the leaves are linked in key order, so scans never climb the tree.
+ * Branches hold only keys that route a search to a child.
+ * Each node is one allocation holding many keys, so a lookup touches a few nodes rather than one node per comparison.
+ *
+ * A search for a key descends into children[i] of a branch, where i is the number of the branch's keys that are
+ * less than or equal to the key.
+ * So every key in children[i] is less than keys[i], and every key in children[i + 1] is at least keys[i].
+ * A branch holds an acquired reference to each of its keys, so a key still routes searches
+ * after its entry has been removed.
+ *
+ * Every node except the root is kept at least half full.
+ *
+ * A branch also counts the entries under each of its children,
+ * so the position of a key, and the entry at a position, are found in a single descent.
+ *
+ * A map made by SubMap, HeadMap or TailMap is a view:
+ * it has no nodes of its own, and reaches the entries of the map it was made from that lie between its bounds.
+ */
+#define _PARCTreeMap_LeafCapacity 32
+#define _PARCTreeMap_BranchCapacity 32
+
+#define _PARCTreeMap_LeafMinimum (_PARCTreeMap_LeafCapacity / 2)
+#define _PARCTreeMap_BranchMinimum (_PARCTreeMap_BranchCapacity / 2)
+
+typedef struct treemap_node {
+    bool isLeaf;
+    // The number of entries in a leaf, or the number of children of a branch.
+    size_t count;
+} _BTreeNode;
+
+typedef struct treemap_leaf {
+    _BTreeNode node;
+    struct treemap_leaf *previous;
+    struct treemap_leaf *next;
+    // keys[i] is the key of elements[i], kept here so a search need not visit each element.
+    const PARCObject *keys[_PARCTreeMap_LeafCapacity];
+    PARCKeyValue *elements[_PARCTreeMap_LeafCapacity];
+} _BTreeLeaf;
+
+typedef struct treemap_branch {
+    _BTreeNode node;
+    PARCObject *keys[_PARCTreeMap_BranchCapacity - 1];
+    _BTreeNode *children[_PARCTreeMap_BranchCapacity];
+    // counts[i] is the number of entries under children[i].
+    size_t counts[_PARCTreeMap_BranchCapacity];
+} _BTreeBranch;
 
 struct parc_treemap {
-    _RBNode *root;
-    _RBNode *nil;
-    int size;
+    _BTreeNode *root;
+    _BTreeLeaf *first;
+    _BTreeLeaf *last;
+    size_t size;
     PARCTreeMap_CustomCompare *customCompare;
-};
 
-typedef void (rbRecursiveFunc)(_RBNode *node, PARCObject *data);
+    // For a view, the map holding its entries, and the least key it holds and the key that all its keys are below.
+    // A NULL bound is no bound.
+    PARCTreeMap *backing;
+    PARCObject *lowKey;
+    PARCObject *highKey;
+};
 
-static void
-_rbNodeFree(_RBNode *node)
+static inline int
+_parcTreeMap_Compare(const PARCTreeMap *tree, const PARCObject *key1, const PARCObject *key2)
 {
-    if (node->element != NULL) {
-        parcKeyValue_Release(&(node->element));
+    int result;
+    if (tree->customCompare != NULL) {
+        result = tree->customCompare(key1, key2);
+    } else {
+        result = parcObject_Compare(key1, key2);
     }
-    parcMemory_Deallocate((void **) &node);
+    return result;
 }
 
-static void
-_rbNodeFreeRecursive(PARCTreeMap *tree, _RBNode *node)
+static _BTreeLeaf *
+_parcTreeMapLeaf_Create(void)
 {
-    if (node->leftChild != tree->nil) {
-        _rbNodeFreeRecursive(tree, node->leftChild);
-    }
-    if (node->rightChild != tree->nil) {
-        _rbNodeFreeRecursive(tree, node->rightChild);
-    }
-    // We descended on both branches, now free myself.
-    _rbNodeFree(node);
-    tree->size--;
+    _BTreeLeaf *leaf = parcMemory_Allocate(sizeof(_BTreeLeaf));
+    assertNotNull(leaf, "parcMemory_Allocate(%zu) returned NULL", sizeof(_BTreeLeaf));
+    leaf->node.isLeaf = true;
+    leaf->node.count = 0;
+    leaf->previous = NULL;
+    leaf->next = NULL;
+    return leaf;
+}
+
+static _BTreeBranch *
+_parcTreeMapBranch_Create(void)
+{
+    _BTreeBranch *branch = parcMemory_Allocate(sizeof(_BTreeBranch));
+    assertNotNull(branch, "parcMemory_Allocate(%zu) returned NULL", sizeof(_BTreeBranch));
+    branch->node.isLeaf = false;
+    branch->node.count = 0;
+    return branch;
 }
 
-// Run a function on all nodes in the tree, in order
 static void
-_rbNodeRecursiveRun(PARCTreeMap *tree, _RBNode *node, rbRecursiveFunc *func, PARCObject *data)
+_parcTreeMapNode_Destroy(_BTreeNode *node)
 {
-    if (node->leftChild != tree->nil) {
-        _rbNodeRecursiveRun(tree, node->leftChild, func, data);
+    if (node->isLeaf) {
+        _BTreeLeaf *leaf = (_BTreeLeaf *) node;
+        for (size_t i = 0; i < node->count; i++) {
+            parcKeyValue_Release(&leaf->elements[i]);
+        }
+    } else {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
+        for (size_t i = 0; i < node->count; i++) {
+            if (i > 0) {
+                parcObject_Release(&branch->keys[i - 1]);
+            }
+            _parcTreeMapNode_Destroy(branch->children[i]);
+        }
     }
-    func(node, data);
-    if (node->rightChild != tree->nil) {
-        _rbNodeRecursiveRun(tree, node->rightChild, func, data);
+    parcMemory_Deallocate(&node);
+}
+
+static size_t
+_parcTreeMapNode_Size(const _BTreeNode *node)
+{
+    size_t result = node->count;
+
+    if (!node->isLeaf) {
+        const _BTreeBranch *branch = (const _BTreeBranch *) node;
+        result = 0;
+        for (size_t i = 0; i < node->count; i++) {
+            result += branch->counts[i];
+        }
     }
+    return result;
 }
 
+/*
+ * The index of the first key in the leaf that is not less than the given key.
+ */
+static size_t
+_parcTreeMapLeaf_LowerBound(const PARCTreeMap *tree, const _BTreeLeaf *leaf, const PARCObject *key, bool *found)
+{
+    size_t low = 0;
+    size_t high = leaf->node.count;
+    *found = false;
+
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        int comparison = _parcTreeMap_Compare(tree, leaf->keys[middle], key);
+        if (comparison < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+            if (comparison == 0) {
+                *found = true;
+                break;
+            }
+        }
+    }
+    return high;
+}
 
-static _RBNode *
-_rbMinRelativeNode(const PARCTreeMap *tree, _RBNode *startNode)
+/*
+ * The index of the child of the branch that may hold the given key.
+ */
+static size_t
+_parcTreeMapBranch_ChildIndex(const PARCTreeMap *tree, const _BTreeBranch *branch, const PARCObject *key)
 {
-    _RBNode *searchNode = startNode;
+    size_t low = 0;
+    size_t high = branch->node.count - 1;
 
-    // Let's get to the bottom left
-    while (searchNode->leftChild != tree->nil) {
-        searchNode = searchNode->leftChild;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (_parcTreeMap_Compare(tree, branch->keys[middle], key) <= 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
     }
+    return low;
+}
 
-    return searchNode;
+static _BTreeLeaf *
+_parcTreeMap_FindLeaf(const PARCTreeMap *tree, const PARCObject *key)
+{
+    _BTreeNode *node = tree->root;
+    while (!node->isLeaf) {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
+        node = branch->children[_parcTreeMapBranch_ChildIndex(tree, branch, key)];
+    }
+    return (_BTreeLeaf *) node;
 }
 
-static _RBNode *
-_rbMaxRelativeNode(const PARCTreeMap *tree, _RBNode *startNode)
+/*
+ * Find the first entry with a key greater than the given key.
+ * Return its leaf and set the index of the entry in it, or return NULL if there is no such entry.
+ */
+static _BTreeLeaf *
+_parcTreeMap_FindHigher(const PARCTreeMap *tree, const PARCObject *key, size_t *index)
 {
-    _RBNode *searchNode = startNode;
+    _BTreeLeaf *leaf = _parcTreeMap_FindLeaf(tree, key);
 
-    // Let's get to the bottom left
-    while (searchNode->rightChild != tree->nil) {
-        searchNode = searchNode->rightChild;
+    bool found;
+    *index = _parcTreeMapLeaf_LowerBound(tree, leaf, key, &found);
+    if (found) {
+        (*index)++;
+    }
+    if (*index == leaf->node.count) {
+        leaf = leaf->next;
+        *index = 0;
     }
+    return leaf;
+}
+
+/*
+ * Find the first entry with a key not less than the given key.
+ * Return its leaf and set the index of the entry in it, or return NULL if there is no such entry.
+ */
+static _BTreeLeaf *
+_parcTreeMap_FindCeiling(const PARCTreeMap *tree, const PARCObject *key, size_t *index)
+{
+    _BTreeLeaf *leaf = _parcTreeMap_FindLeaf(tree, key);
 
-    return searchNode;
+    bool found;
+    *index = _parcTreeMapLeaf_LowerBound(tree, leaf, key, &found);
+    if (*index == leaf->node.count) {
+        leaf = leaf->next;
+        *index = 0;
+    }
+    return leaf;
 }
 
-static _RBNode *
-_rbNextNode(const PARCTreeMap *tree, _RBNode *node)
+/*
+ * The number of entries with keys less than the given key.
+ */
+static size_t
+_parcTreeMap_CountLess(const PARCTreeMap *tree, const PARCObject *key)
 {
-    _RBNode *searchNode = node;
-    if (searchNode->rightChild != tree->nil) {
-        searchNode = _rbMinRelativeNode(tree, searchNode->rightChild);
-    } else {
-        _RBNode *parent = searchNode->parent;
-        while (parent != tree->nil) {
-            if (parent->leftChild == searchNode) {
-                break;
-            }
-            searchNode = parent;
-            parent = searchNode->parent;
+    size_t result = 0;
+
+    _BTreeNode *node = tree->root;
+    while (!node->isLeaf) {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
+        size_t index = _parcTreeMapBranch_ChildIndex(tree, branch, key);
+        for (size_t i = 0; i < index; i++) {
+            result += branch->counts[i];
         }
-        searchNode = parent;
+        node = branch->children[index];
     }
 
-    return searchNode;
+    bool found;
+    result += _parcTreeMapLeaf_LowerBound(tree, (_BTreeLeaf *) node, key, &found);
+    return result;
 }
 
-static _RBNode *
-_rbPreviousNode(const PARCTreeMap *tree, _RBNode *node)
+/*
+ * Find the entry at the given position, which must be less than the size of the tree.
+ * Return its leaf and set the index of the entry in it.
+ */
+static _BTreeLeaf *
+_parcTreeMap_FindAtIndex(const PARCTreeMap *tree, size_t position, size_t *index)
 {
-    _RBNode *searchNode = node;
-    if (searchNode->leftChild != tree->nil) {
-        searchNode = _rbMaxRelativeNode(tree, searchNode->leftChild);
-    } else {
-        _RBNode *parent = searchNode->parent;
-        while (parent != tree->nil) {
-            if (parent->rightChild == searchNode) {
-                break;
-            }
-            searchNode = parent;
-            parent = searchNode->parent;
+    _BTreeNode *node = tree->root;
+    while (!node->isLeaf) {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
+        size_t i = 0;
+        while (position >= branch->counts[i]) {
+            position -= branch->counts[i];
+            i++;
         }
-        searchNode = parent;
+        node = branch->children[i];
     }
 
-    return searchNode;
+    *index = position;
+    return (_BTreeLeaf *) node;
 }
 
+static void
+_parcTreeMap_AssertInvariants(const PARCTreeMap *tree)
+{
+    assertNotNull(tree, "Tree is null!");
+    if (tree->backing != NULL) {
+        tree = tree->backing;
+    }
+    assertNotNull(tree->root, "Tree has a NULL root");
+    assertTrue(tree->size == 0 || tree->first->node.count > 0, "Tree size = %zd > 0 but the first leaf is empty", tree->size);
+}
 
-/**
- * Create a node
- * Set the parent and children to tree->nil.
- * If we are creating the nil node this might leave garbage there (if not preset to NULL).
+/*
+ * The map holding the entries of the given map, which is the map itself unless it is a view.
  */
-static _RBNode *
-_rbNodeCreate(PARCTreeMap *tree, int color)
+static inline PARCTreeMap *
+_parcTreeMap_Entries(const PARCTreeMap *tree)
 {
-    _RBNode *node = parcMemory_AllocateAndClear(sizeof(_RBNode));
-    assertNotNull(node, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_RBNode));
-    node->color = color;
-    node->leftChild = tree->nil;
-    node->rightChild = tree->nil;
-    node->parent = tree->nil;
-    return node;
+    return (tree->backing != NULL) ? tree->backing : (PARCTreeMap *) tree;
 }
 
-static void
-_rbNodeSetColor(_RBNode *node, uint8_t color)
+static bool
+_parcTreeMap_IsAboveLow(const PARCTreeMap *tree, const PARCObject *key)
 {
-    node->color = color;
+    return tree->lowKey == NULL || _parcTreeMap_Compare(tree, key, tree->lowKey) >= 0;
 }
 
-static int
-_rbNodeColor(const _RBNode *node)
+static bool
+_parcTreeMap_IsBelowHigh(const PARCTreeMap *tree, const PARCObject *key)
 {
-    return node->color;
+    return tree->highKey == NULL || _parcTreeMap_Compare(tree, key, tree->highKey) < 0;
 }
 
 static bool
-_rbNodeIsEqual(const PARCTreeMap *tree, const _RBNode *node, const PARCObject *key)
+_parcTreeMap_InRange(const PARCTreeMap *tree, const PARCObject *key)
 {
-    bool result = false;
-    if (node->element != NULL) {
-        if (tree->customCompare != NULL) {
-            result = (tree->customCompare(parcKeyValue_GetKey(node->element), key) == 0);
-        } else {
-            result = parcObject_Equals(parcKeyValue_GetKey(node->element), key);
-        }
-    }
-    return result;
+    return _parcTreeMap_IsAboveLow(tree, key) && _parcTreeMap_IsBelowHigh(tree, key);
 }
 
-static bool
-_rbNodeIsGreaterThan(const PARCTreeMap *tree, const _RBNode *node, const PARCObject *key)
+/*
+ * The number of entries of the backing map that precede the entries of the view.
+ */
+static size_t
+_parcTreeMap_Offset(const PARCTreeMap *tree)
 {
-    bool result = false;
-    if (node->element != NULL) {
-        if (tree->customCompare != NULL) {
-            result = (tree->customCompare(parcKeyValue_GetKey(node->element), key) > 0);
-        } else {
-            result = (parcObject_Compare(parcKeyValue_GetKey(node->element), key) > 0);
-        }
-    }
-    return result;
+    return (tree->lowKey != NULL) ? _parcTreeMap_CountLess(tree->backing, tree->lowKey) : 0;
 }
 
-static _RBNode *
-_rbFindNode(const PARCTreeMap *tree, _RBNode *startNode, const PARCObject *key)
+/*
+ * Find the first entry of the map, which may be a view.
+ * Return its leaf and set the index of the entry in it, or return NULL if the map is empty.
+ */
+static _BTreeLeaf *
+_parcTreeMap_FindFirst(const PARCTreeMap *tree, size_t *index)
 {
-    _RBNode *result = NULL;
-    _RBNode *node = startNode;
+    PARCTreeMap *entries = _parcTreeMap_Entries(tree);
+    _BTreeLeaf *result;
 
-    // Let's get to the bottom of the tree to insert.
-    while (node != tree->nil) {
-        if (_rbNodeIsEqual(tree, node, key)) {
-            result = node;
-            break;
-        } else {
-            if (_rbNodeIsGreaterThan(tree, node, key)) {
-                node = node->leftChild;
-            } else {
-                node = node->rightChild;
-            }
-        }
+    if (tree->lowKey != NULL) {
+        result = _parcTreeMap_FindCeiling(entries, tree->lowKey, index);
+    } else {
+        result = (entries->size > 0) ? entries->first : NULL;
+        *index = 0;
+    }
+    if (result != NULL && !_parcTreeMap_IsBelowHigh(tree, result->keys[*index])) {
+        result = NULL;
     }
     return result;
 }
 
-
+/*
+ * Insert the entry into the leaf, which has room for it, at the given index.
+ */
 static void
-_rbNodeUpdate(_RBNode *treeNode, _RBNode *newNode)
+_parcTreeMapLeaf_InsertAt(_BTreeLeaf *leaf, size_t index, PARCKeyValue *element)
 {
-    // Free old values
-    if (treeNode->element != NULL) {
-        parcKeyValue_Release(&treeNode->element);
-    }
-
-    treeNode->element = parcKeyValue_Acquire(newNode->element);
-    _rbNodeFree(newNode);
+    size_t move = leaf->node.count - index;
+    memmove(&leaf->keys[index + 1], &leaf->keys[index], move * sizeof(leaf->keys[0]));
+    memmove(&leaf->elements[index + 1], &leaf->elements[index], move * sizeof(leaf->elements[0]));
+    leaf->keys[index] = parcKeyValue_GetKey(element);
+    leaf->elements[index] = element;
+    leaf->node.count++;
 }
 
-static void
-_rbNodeRotateLeft(PARCTreeMap *tree, _RBNode *node)
+static PARCKeyValue *
+_parcTreeMapLeaf_RemoveAt(_BTreeLeaf *leaf, size_t index)
 {
-    _RBNode *subroot = node->rightChild;
-    node->rightChild = subroot->leftChild;
-    if (node->rightChild != tree->nil) {
-        node->rightChild->parent = node;
-    }
+    PARCKeyValue *result = leaf->elements[index];
 
-    subroot->parent = node->parent;
-    if (tree->root == node) {
-        tree->root = subroot;
-    } else {
-        if (subroot->parent->leftChild == node) {
-            // node was a left child
-            subroot->parent->leftChild = subroot;
-        } else {
-            // node was a right child
-            subroot->parent->rightChild = subroot;
-        }
-    }
+    leaf->node.count--;
+    size_t move = leaf->node.count - index;
+    memmove(&leaf->keys[index], &leaf->keys[index + 1], move * sizeof(leaf->keys[0]));
+    memmove(&leaf->elements[index], &leaf->elements[index + 1], move * sizeof(leaf->elements[0]));
 
-    subroot->leftChild = node;
-    node->parent = subroot;
+    return result;
 }
 
+/*
+ * Insert the child, and the key that routes searches to it, into the branch, which has room for them.
+ * The child will be at the given index, which is greater than zero.
+ */
 static void
-_rbNodeRotateRight(PARCTreeMap *tree, _RBNode *node)
+_parcTreeMapBranch_InsertAt(_BTreeBranch *branch, size_t index, PARCObject *key, _BTreeNode *child, size_t count)
 {
-    _RBNode *subroot = node->leftChild;
-    node->leftChild = subroot->rightChild;
-    if (node->leftChild != tree->nil) {
-        node->leftChild->parent = node;
-    }
+    size_t move = branch->node.count - index;
+    memmove(&branch->keys[index], &branch->keys[index - 1], move * sizeof(branch->keys[0]));
+    memmove(&branch->children[index + 1], &branch->children[index], move * sizeof(branch->children[0]));
+    memmove(&branch->counts[index + 1], &branch->counts[index], move * sizeof(branch->counts[0]));
+    branch->keys[index - 1] = key;
+    branch->children[index] = child;
+    branch->counts[index] = count;
+    branch->node.count++;
+}
+
+/*
+ * Remove the child at the given index, which is greater than zero, and the key that routes searches to it.
+ * The caller takes the reference to the key.
+ */
+static PARCObject *
+_parcTreeMapBranch_RemoveAt(_BTreeBranch *branch, size_t index)
+{
+    PARCObject *result = branch->keys[index - 1];
+
+    branch->node.count--;
+    size_t move = branch->node.count - index;
+    memmove(&branch->keys[index - 1], &branch->keys[index], move * sizeof(branch->keys[0]));
+    memmove(&branch->children[index], &branch->children[index + 1], move * sizeof(branch->children[0]));
+    memmove(&branch->counts[index], &branch->counts[index + 1], move * sizeof(branch->counts[0]));
+
+    return result;
+}
 
-    subroot->parent = node->parent;
-    if (tree->root == node) {
-        tree->root = subroot;
+static _BTreeLeaf *
+_parcTreeMapLeaf_Split(PARCTreeMap *tree, _BTreeLeaf *leaf)
+{
+    _BTreeLeaf *right = _parcTreeMapLeaf_Create();
+
+    size_t half = leaf->node.count / 2;
+    right->node.count = leaf->node.count - half;
+    memcpy(right->keys, &leaf->keys[half], right->node.count * sizeof(leaf->keys[0]));
+    memcpy(right->elements, &leaf->elements[half], right->node.count * sizeof(leaf->elements[0]));
+    leaf->node.count = half;
+
+    right->previous = leaf;
+    right->next = leaf->next;
+    if (leaf->next != NULL) {
+        leaf->next->previous = right;
     } else {
-        if (subroot->parent->leftChild == node) {
-            // node was a left child
-            subroot->parent->leftChild = subroot;
-        } else {
-            // node was a right child
-            subroot->parent->rightChild = subroot;
-        }
+        tree->last = right;
     }
+    leaf->next = right;
 
-    subroot->rightChild = node;
-    node->parent = subroot;
+    return right;
 }
 
-static void
-_rbNodeFix(PARCTreeMap *tree, _RBNode *startNode)
-{
-    _RBNode *node = startNode;
-    _RBNode *uncle;
-    while (_rbNodeColor(node->parent) == RED) {
-        if (node->parent->parent->leftChild == node->parent) {
-            uncle = node->parent->parent->rightChild;
-            if (_rbNodeColor(uncle) == RED) {
-                // My dad and uncle are red. Switch dad to black.
-                // Switch grandpa to red and start there.
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(uncle, BLACK);
-                _rbNodeSetColor(node->parent->parent, RED);
-                node = node->parent->parent;
-            } else {
-                if (node->parent->rightChild == node) {
-                    node = node->parent;
-                    _rbNodeRotateLeft(tree, node);
-                }
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(node->parent->parent, RED);
-                _rbNodeRotateRight(tree, node->parent->parent);
-            }
+/*
+ * Insert the entry into the subtree rooted at the given node.
+ * If the node had to be split, return the new node that follows it and set the key that routes searches to the new node.
+ */
+static _BTreeNode *
+_parcTreeMapNode_Put(PARCTreeMap *tree, _BTreeNode *node, PARCKeyValue *element, PARCObject **separator)
+{
+    _BTreeNode *result = NULL;
+    const PARCObject *key = parcKeyValue_GetKey(element);
+
+    if (node->isLeaf) {
+        _BTreeLeaf *leaf = (_BTreeLeaf *) node;
+
+        bool found;
+        size_t index = _parcTreeMapLeaf_LowerBound(tree, leaf, key, &found);
+        if (found) {
+            // The entry replaces both the key and the value of the one it matches.
+            parcKeyValue_Release(&leaf->elements[index]);
+            leaf->keys[index] = key;
+            leaf->elements[index] = element;
         } else {
-            uncle = node->parent->parent->leftChild;
-            if (_rbNodeColor(uncle) == RED) {
-                // My dad and uncle are red. Switch dad to black.
-                // Switch grandpa to red and start there.
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(uncle, BLACK);
-                _rbNodeSetColor(node->parent->parent, RED);
-                node = node->parent->parent;
-            } else {
-                if (node->parent->leftChild == node) {
-                    node = node->parent;
-                    _rbNodeRotateRight(tree, node);
+            if (node->count == _PARCTreeMap_LeafCapacity) {
+                _BTreeLeaf *right = _parcTreeMapLeaf_Split(tree, leaf);
+                if (index > leaf->node.count) {
+                    index -= leaf->node.count;
+                    leaf = right;
                 }
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(node->parent->parent, RED);
-                _rbNodeRotateLeft(tree, node->parent->parent);
+                result = &right->node;
             }
+            _parcTreeMapLeaf_InsertAt(leaf, index, element);
+            if (result != NULL) {
+                *separator = parcObject_Acquire(((_BTreeLeaf *) result)->keys[0]);
+            }
+            tree->size++;
         }
-    }
-    _rbNodeSetColor(tree->root, BLACK);
-}
+    } else {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
 
-static void
-_rbNodeAssertNodeInvariants(_RBNode *node, PARCObject *data)
-{
-    PARCTreeMap *tree = (PARCTreeMap *) data;
-    assertNotNull(node->parent, "Node has NULL parent");
-    assertNotNull(node->leftChild, "Left child NULL");
-    assertNotNull(node->rightChild, "Richt child NULL");
-    if (node != tree->root) {
-        assertTrue(node->parent != tree->nil, "Paren't can't be nill for node!");
-        // Don't need to compare to parent, they compared to us
-    }
-    assertNotNull(node->element, "We have a null element!!");
-    assertNotNull(parcKeyValue_GetKey(node->element), "We have a null key!!");
-    assertNotNull(parcKeyValue_GetValue(node->element), "We have a null value!!");
-    if (node->leftChild != tree->nil) {
-        if (tree->customCompare != NULL) {
-            assertTrue(tree->customCompare(parcKeyValue_GetKey(node->element), parcKeyValue_GetKey(node->leftChild->element)) > 0, "Left child not smaller?");
-        } else {
-            assertTrue(parcObject_Compare(parcKeyValue_GetKey(node->element), parcKeyValue_GetKey(node->leftChild->element)) > 0, "Left child not smaller?");
-        }
-    }
-    if (node->rightChild != tree->nil) {
-        if (tree->customCompare != NULL) {
-            assertTrue(tree->customCompare(parcKeyValue_GetKey(node->element), parcKeyValue_GetKey(node->rightChild->element)) < 0, "Right child not bigger?");
-        } else {
-            assertTrue(parcObject_Compare(parcKeyValue_GetKey(node->element), parcKeyValue_GetKey(node->rightChild->element)) < 0, "Right child not bigger?");
-        }
-    }
-}
+        size_t index = _parcTreeMapBranch_ChildIndex(tree, branch, key);
+        size_t size = tree->size;
+        PARCObject *childSeparator;
+        _BTreeNode *child = _parcTreeMapNode_Put(tree, branch->children[index], element, &childSeparator);
+        branch->counts[index] += tree->size - size;
 
-static
-void
-_rbNodeAssertTreeInvariants(const PARCTreeMap *tree)
-{
-    assertNotNull(tree, "Tree is null!");
-    assertTrue(tree->size >= 0, "Tree has negative size");
-    if (tree->size != 0) {
-        assertTrue(tree->root != tree->nil, "Tree size = %d > 0 but root is nil", tree->size);
-        assertNotNull(tree->root, "Tree size > 0 but root is NULL");
-#ifdef ASSERT_INVARIANTS
-        _rbNodeRecursiveRun((PARCTreeMap *) tree, tree->root, _rbNodeAssertNodeInvariants, (PARCObject *) tree);
-#endif
-    }
-}
+        if (child != NULL) {
+            size_t childCount = _parcTreeMapNode_Size(child);
+            branch->counts[index] -= childCount;
 
-static void
-_rbNodeFixDelete(PARCTreeMap *tree, _RBNode *node)
-{
-    _RBNode *fixNode;
-
-    while ((node != tree->root) && (_rbNodeColor(node) == BLACK)) {
-        _rbNodeAssertTreeInvariants(tree);
-        if (node == node->parent->leftChild) {
-            fixNode = node->parent->rightChild;
-            if (_rbNodeColor(fixNode) == RED) {
-                _rbNodeSetColor(fixNode, BLACK);
-                _rbNodeSetColor(node->parent, RED);
-                _rbNodeRotateLeft(tree, node->parent);
-                fixNode = node->parent->rightChild;
-            }
-            if ((_rbNodeColor(fixNode->leftChild) == BLACK) &&
-                (_rbNodeColor(fixNode->rightChild) == BLACK)) {
-                _rbNodeSetColor(fixNode, RED);
-                node = node->parent;
+            if (node->count < _PARCTreeMap_BranchCapacity) {
+                _parcTreeMapBranch_InsertAt(branch, index + 1, childSeparator, child, childCount);
             } else {
-                if (_rbNodeColor(fixNode->rightChild) == BLACK) {
-                    _rbNodeSetColor(fixNode->leftChild, BLACK);
-                    _rbNodeSetColor(fixNode, RED);
-                    _rbNodeRotateRight(tree, fixNode);
-                    fixNode = node->parent->rightChild;
-                }
-                _rbNodeSetColor(fixNode, _rbNodeColor(node->parent));
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(fixNode->rightChild, BLACK);
-                _rbNodeRotateLeft(tree, node->parent);
-                node = tree->root;
-            }
-        } else {
-            fixNode = node->parent->leftChild;
-            if (_rbNodeColor(fixNode) == RED) {
-                _rbNodeSetColor(fixNode, BLACK);
-                _rbNodeSetColor(node->parent, RED);
-                _rbNodeRotateRight(tree, node->parent);
-                fixNode = node->parent->leftChild;
-            }
-            if ((_rbNodeColor(fixNode->leftChild) == BLACK) &&
-                (_rbNodeColor(fixNode->rightChild) == BLACK)) {
-                _rbNodeSetColor(fixNode, RED);
-                node = node->parent;
-            } else {
-                if (_rbNodeColor(fixNode->leftChild) == BLACK) {
-                    _rbNodeSetColor(fixNode->rightChild, BLACK);
-                    _rbNodeSetColor(fixNode, RED);
-                    _rbNodeRotateLeft(tree, fixNode);
-                    fixNode = node->parent->leftChild;
-                }
-                _rbNodeSetColor(fixNode, _rbNodeColor(node->parent));
-                _rbNodeSetColor(node->parent, BLACK);
-                _rbNodeSetColor(fixNode->leftChild, BLACK);
-                _rbNodeRotateRight(tree, node->parent);
-                node = tree->root;
+                // Lay out the overfull branch, then share its children between it and a new branch.
+                PARCObject *keys[_PARCTreeMap_BranchCapacity];
+                _BTreeNode *children[_PARCTreeMap_BranchCapacity + 1];
+                size_t counts[_PARCTreeMap_BranchCapacity + 1];
+                memcpy(keys, branch->keys, index * sizeof(keys[0]));
+                memcpy(children, branch->children, (index + 1) * sizeof(children[0]));
+                memcpy(counts, branch->counts, (index + 1) * sizeof(counts[0]));
+                keys[index] = childSeparator;
+                children[index + 1] = child;
+                counts[index + 1] = childCount;
+                memcpy(&keys[index + 1], &branch->keys[index], (node->count - 1 - index) * sizeof(keys[0]));
+                memcpy(&children[index + 2], &branch->children[index + 1], (node->count - 1 - index) * sizeof(children[0]));
+                memcpy(&counts[index + 2], &branch->counts[index + 1], (node->count - 1 - index) * sizeof(counts[0]));
+
+                _BTreeBranch *right = _parcTreeMapBranch_Create();
+                size_t total = node->count + 1;
+                size_t half = total / 2;
+
+                memcpy(branch->keys, keys, (half - 1) * sizeof(keys[0]));
+                memcpy(branch->children, children, half * sizeof(children[0]));
+                memcpy(branch->counts, counts, half * sizeof(counts[0]));
+                branch->node.count = half;
+
+                memcpy(right->keys, &keys[half], (total - half - 1) * sizeof(keys[0]));
+                memcpy(right->children, &children[half], (total - half) * sizeof(children[0]));
+                memcpy(right->counts, &counts[half], (total - half) * sizeof(counts[0]));
+                right->node.count = total - half;
+
+                *separator = keys[half - 1];
+                result = &right->node;
             }
         }
     }
 
-    _rbNodeSetColor(node, BLACK);
+    return result;
 }
 
-// Remove the node from the tree.
-// The node must be part of a tree (with parents and children)
+/*
+ * Refill the child at the given index of the branch, which has fallen below half full,
+ * from a neighbouring child, or merge it with one.
+ */
 static void
-_rbNodeRemove(PARCTreeMap *tree, _RBNode *node)
-{
-    _rbNodeAssertTreeInvariants(tree);
-    _RBNode *fixupNode;
-    int deleteNodeColor = _rbNodeColor(node);
-    if (node->leftChild == tree->nil) {
-        if (node->rightChild == tree->nil) {
-            // ---- We have no children ----
-            if (tree->root == node) {
-                tree->root = tree->nil;
-            } else {
-                if (node->parent->leftChild == node) {
-                    node->parent->leftChild = tree->nil;
-                } else {
-                    node->parent->rightChild = tree->nil;
-                }
-            }
-            fixupNode = tree->nil;
-            fixupNode->parent = node->parent;
+_parcTreeMapBranch_Rebalance(PARCTreeMap *tree, _BTreeBranch *branch, size_t index)
+{
+    _BTreeNode *child = branch->children[index];
+    _BTreeNode *left = (index > 0) ? branch->children[index - 1] : NULL;
+    _BTreeNode *right = (index + 1 < branch->node.count) ? branch->children[index + 1] : NULL;
+    size_t minimum = child->isLeaf ? _PARCTreeMap_LeafMinimum : _PARCTreeMap_BranchMinimum;
+
+    if (left != NULL && left->count > minimum) {
+        if (child->isLeaf) {
+            _BTreeLeaf *from = (_BTreeLeaf *) left;
+            _BTreeLeaf *to = (_BTreeLeaf *) child;
+            _parcTreeMapLeaf_InsertAt(to, 0, _parcTreeMapLeaf_RemoveAt(from, from->node.count - 1));
+            parcObject_Release(&branch->keys[index - 1]);
+            branch->keys[index - 1] = parcObject_Acquire(to->keys[0]);
+            branch->counts[index - 1]--;
+            branch->counts[index]++;
         } else {
-            // ---- We only have right child, move up ----
-            if (tree->root == node) {
-                tree->root = node->rightChild;
-            } else {
-                if (node->parent->leftChild == node) {
-                    node->parent->leftChild = node->rightChild;
-                } else {
-                    node->parent->rightChild = node->rightChild;
-                }
-            }
-            fixupNode = node->rightChild;
-            node->rightChild->parent = node->parent;
+            _BTreeBranch *from = (_BTreeBranch *) left;
+            _BTreeBranch *to = (_BTreeBranch *) child;
+            memmove(&to->keys[1], &to->keys[0], (to->node.count - 1) * sizeof(to->keys[0]));
+            memmove(&to->children[1], &to->children[0], to->node.count * sizeof(to->children[0]));
+            memmove(&to->counts[1], &to->counts[0], to->node.count * sizeof(to->counts[0]));
+            to->keys[0] = branch->keys[index - 1];
+            to->children[0] = from->children[from->node.count - 1];
+            to->counts[0] = from->counts[from->node.count - 1];
+            to->node.count++;
+            branch->keys[index - 1] = from->keys[from->node.count - 2];
+            branch->counts[index - 1] -= to->counts[0];
+            branch->counts[index] += to->counts[0];
+            from->node.count--;
+        }
+    } else if (right != NULL && right->count > minimum) {
+        if (child->isLeaf) {
+            _BTreeLeaf *from = (_BTreeLeaf *) right;
+            _BTreeLeaf *to = (_BTreeLeaf *) child;
+            _parcTreeMapLeaf_InsertAt(to, to->node.count, _parcTreeMapLeaf_RemoveAt(from, 0));
+            parcObject_Release(&branch->keys[index]);
+            branch->keys[index] = parcObject_Acquire(from->keys[0]);
+            branch->counts[index]++;
+            branch->counts[index + 1]--;
+        } else {
+            _BTreeBranch *from = (_BTreeBranch *) right;
+            _BTreeBranch *to = (_BTreeBranch *) child;
+            to->keys[to->node.count - 1] = branch->keys[index];
+            to->children[to->node.count] = from->children[0];
+            to->counts[to->node.count] = from->counts[0];
+            branch->counts[index] += from->counts[0];
+            branch->counts[index + 1] -= from->counts[0];
+            to->node.count++;
+            branch->keys[index] = from->keys[0];
+            from->node.count--;
+            memmove(&from->keys[0], &from->keys[1], (from->node.count - 1) * sizeof(from->keys[0]));
+            memmove(&from->children[0], &from->children[1], from->node.count * sizeof(from->children[0]));
+            memmove(&from->counts[0], &from->counts[1], from->node.count * sizeof(from->counts[0]));
         }
     } else {
-        if (node->rightChild == tree->nil) {
-            // ---- We only have left child, move up ----
-            if (tree->root == node) {
-                tree->root = node->leftChild;
+        // Neither neighbour can spare anything, so merge the child with one of them.
+        if (left == NULL) {
+            left = child;
+            index++;
+        }
+        _BTreeNode *merged = branch->children[index];
+        branch->counts[index - 1] += branch->counts[index];
+        PARCObject *separator = _parcTreeMapBranch_RemoveAt(branch, index);
+
+        if (left->isLeaf) {
+            _BTreeLeaf *to = (_BTreeLeaf *) left;
+            _BTreeLeaf *from = (_BTreeLeaf *) merged;
+            memcpy(&to->keys[to->node.count], from->keys, from->node.count * sizeof(to->keys[0]));
+            memcpy(&to->elements[to->node.count], from->elements, from->node.count * sizeof(to->elements[0]));
+            to->node.count += from->node.count;
+
+            to->next = from->next;
+            if (from->next != NULL) {
+                from->next->previous = to;
             } else {
-                if (node->parent->leftChild == node) {
-                    node->parent->leftChild = node->leftChild;
-                } else {
-                    node->parent->rightChild = node->leftChild;
-                }
+                tree->last = to;
             }
-            node->leftChild->parent = node->parent;
-            fixupNode = node->leftChild;
+            parcObject_Release(&separator);
         } else {
-            // ---- We have 2 children, move our successor to our location ----
-            _RBNode *successor = node->rightChild;
-            while (successor->leftChild != tree->nil) {
-                successor = successor->leftChild;
-            }
-            deleteNodeColor = _rbNodeColor(successor);
-
-            // Remove successor, it has no left child
-            if (successor == successor->parent->leftChild) {
-                successor->parent->leftChild = successor->rightChild;
-            } else {
-                successor->parent->rightChild = successor->rightChild;
-            }
-            successor->rightChild->parent = successor->parent;
-
-            fixupNode = successor->rightChild;
-
-            if (node->parent == tree->nil) {
-                tree->root = successor;
-            } else if (node->parent->leftChild == node) {
-                node->parent->leftChild = successor;
-            } else {
-                node->parent->rightChild = successor;
-            }
-            successor->parent = node->parent;
-            successor->leftChild = node->leftChild;
-            node->leftChild->parent = successor;
-            successor->rightChild = node->rightChild;
-            node->rightChild->parent = successor;
+            _BTreeBranch *to = (_BTreeBranch *) left;
+            _BTreeBranch *from = (_BTreeBranch *) merged;
+            to->keys[to->node.count - 1] = separator;
+            memcpy(&to->keys[to->node.count], from->keys, (from->node.count - 1) * sizeof(to->keys[0]));
+            memcpy(&to->children[to->node.count], from->children, from->node.count * sizeof(to->children[0]));
+            memcpy(&to->counts[to->node.count], from->counts, from->node.count * sizeof(to->counts[0]));
+            to->node.count += from->node.count;
+        }
+        parcMemory_Deallocate(&merged);
+    }
+}
 
-            _rbNodeSetColor(successor, _rbNodeColor(node));
+/*
+ * Remove the entry with the given key from the subtree rooted at the given node, and return it.
+ */
+static PARCKeyValue *
+_parcTreeMapNode_Remove(PARCTreeMap *tree, _BTreeNode *node, const PARCObject *key)
+{
+    PARCKeyValue *result = NULL;
 
-            if (successor->parent == tree->nil) {
-                tree->root = successor;
+    if (node->isLeaf) {
+        _BTreeLeaf *leaf = (_BTreeLeaf *) node;
+        bool found;
+        size_t index = _parcTreeMapLeaf_LowerBound(tree, leaf, key, &found);
+        if (found) {
+            result = _parcTreeMapLeaf_RemoveAt(leaf, index);
+            tree->size--;
+        }
+    } else {
+        _BTreeBranch *branch = (_BTreeBranch *) node;
+        size_t index = _parcTreeMapBranch_ChildIndex(tree, branch, key);
+        _BTreeNode *child = branch->children[index];
+
+        result = _parcTreeMapNode_Remove(tree, child, key);
+        if (result != NULL) {
+            branch->counts[index]--;
+            size_t minimum = child->isLeaf ? _PARCTreeMap_LeafMinimum : _PARCTreeMap_BranchMinimum;
+            if (child->count < minimum) {
+                _parcTreeMapBranch_Rebalance(tree, branch, index);
             }
         }
     }
-    tree->size--;
 
-    // Fix the red-blackness
-    _rbNodeAssertTreeInvariants(tree);
-    if (deleteNodeColor == BLACK) {
-        _rbNodeFixDelete(tree, fixupNode);
+    return result;
+}
+
+static PARCKeyValue *
+_parcTreeMap_RemoveEntry(PARCTreeMap *tree, const PARCObject *key)
+{
+    PARCKeyValue *result = _parcTreeMapNode_Remove(tree, tree->root, key);
+
+    // A root branch left with a single child is replaced by that child.
+    while (!tree->root->isLeaf && tree->root->count == 1) {
+        _BTreeNode *root = tree->root;
+        tree->root = ((_BTreeBranch *) root)->children[0];
+        parcMemory_Deallocate(&root);
     }
-    _rbNodeAssertTreeInvariants(tree);
+
+    return result;
 }
 
 static void
@@ -573,15 +707,20 @@ _parcTreeMap_Destroy(PARCTreeMap **treePointer)
 {
     assertNotNull(treePointer, "pointer to pointer to tree can't be null");
     assertNotNull(*treePointer, "pointer to tree can't be null");
-    _rbNodeAssertTreeInvariants(*treePointer);
+    _parcTreeMap_AssertInvariants(*treePointer);
 
-    if ((*treePointer)->size > 0) {
-        // If we have any elements in the tree, free them
-        _rbNodeFreeRecursive(*treePointer, (*treePointer)->root);
+    PARCTreeMap *tree = *treePointer;
+    if (tree->backing != NULL) {
+        parcTreeMap_Release(&tree->backing);
+        if (tree->lowKey != NULL) {
+            parcObject_Release(&tree->lowKey);
+        }
+        if (tree->highKey != NULL) {
+            parcObject_Release(&tree->highKey);
+        }
+    } else {
+        _parcTreeMapNode_Destroy(tree->root);
     }
-
-    // Free the nil element
-    parcMemory_Deallocate((void **) &((*treePointer)->nil));
 }
 
 
@@ -596,13 +735,14 @@ parcTreeMap_CreateCustom(PARCTreeMap_CustomCompare *customCompare)
 {
     PARCTreeMap *tree = parcObject_CreateInstance(PARCTreeMap);
     assertNotNull(tree, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(PARCTreeMap));
-    tree->nil = _rbNodeCreate(tree, BLACK);
-    tree->nil->leftChild = tree->nil;
-    tree->nil->rightChild = tree->nil;
-    tree->nil->parent = tree->nil;
-    tree->root = tree->nil;
+    tree->first = _parcTreeMapLeaf_Create();
+    tree->last = tree->first;
+    tree->root = &tree->first->node;
     tree->customCompare = customCompare;
     tree->size = 0;
+    tree->backing = NULL;
+    tree->lowKey = NULL;
+    tree->highKey = NULL;
     return tree;
 }
 
@@ -612,76 +752,137 @@ parcTreeMap_Create(void)
     return parcTreeMap_CreateCustom(NULL);
 }
 
-void
-parcTreeMap_Put(PARCTreeMap *tree, const PARCObject *key, const PARCObject *value)
+PARCTreeMap *
+parcTreeMap_CreateFromSorted(PARCTreeMap_CustomCompare *customCompare, size_t count,
+                             const PARCObject *keys[count], const PARCObject *values[count])
 {
-    assertNotNull(tree, "Tree can't be NULL");
-    assertNotNull(key, "Key can't be NULL");
-    assertNotNull(value, "Value can't be NULL");
+    PARCTreeMap *tree = parcTreeMap_CreateCustom(customCompare);
 
-    _RBNode *newNode = _rbNodeCreate(tree, RED);
-    _RBNode *parent = tree->nil;
-    _RBNode *node;
+    if (count > 0) {
+        for (size_t i = 1; i < count; i++) {
+            assertTrue(_parcTreeMap_Compare(tree, keys[i - 1], keys[i]) < 0, "The keys must be in strictly ascending order at index %zd", i);
+        }
+        parcMemory_Deallocate(&tree->root);
+
+        // Share the entries evenly between as few leaves as will hold them, so that every leaf is at least half full.
+        size_t nodeCount = (count + _PARCTreeMap_LeafCapacity - 1) / _PARCTreeMap_LeafCapacity;
+        _BTreeNode **nodes = parcMemory_Allocate(nodeCount * sizeof(_BTreeNode *));
+        const PARCObject **lowest = parcMemory_Allocate(nodeCount * sizeof(PARCObject *));
+        size_t *sizes = parcMemory_Allocate(nodeCount * sizeof(size_t));
+        assertNotNull(nodes, "parcMemory_Allocate(%zu) returned NULL", nodeCount * sizeof(_BTreeNode *));
+        assertNotNull(lowest, "parcMemory_Allocate(%zu) returned NULL", nodeCount * sizeof(PARCObject *));
+        assertNotNull(sizes, "parcMemory_Allocate(%zu) returned NULL", nodeCount * sizeof(size_t));
+
+        _BTreeLeaf *previous = NULL;
+        size_t next = 0;
+        for (size_t i = 0; i < nodeCount; i++) {
+            _BTreeLeaf *leaf = _parcTreeMapLeaf_Create();
+            size_t entries = count / nodeCount + (i < count % nodeCount ? 1 : 0);
+            for (size_t j = 0; j < entries; j++, next++) {
+                leaf->elements[j] = parcKeyValue_Create(keys[next], values[next]);
+                leaf->keys[j] = parcKeyValue_GetKey(leaf->elements[j]);
+            }
+            leaf->node.count = entries;
 
-    // Set the value for the created node
-    PARCKeyValue *element = parcKeyValue_Create(key, value);
-    newNode->element = element;
-
-    // Start at the top
-    node = tree->root;
-
-    // Let's get to the bottom of the tree to insert.
-    while (node != tree->nil) {
-        parent = node;
-        if (_rbNodeIsEqual(tree, node, key)) {
-            // We're trying to insert the same value
-            _rbNodeUpdate(node, newNode);
-            return;
-        } else {
-            if (_rbNodeIsGreaterThan(tree, node, key)) {
-                // The key is smaller
-                node = node->leftChild;
+            leaf->previous = previous;
+            if (previous != NULL) {
+                previous->next = leaf;
             } else {
-                node = node->rightChild;
+                tree->first = leaf;
             }
+            previous = leaf;
+
+            nodes[i] = &leaf->node;
+            lowest[i] = leaf->keys[0];
+            sizes[i] = entries;
         }
-    }
+        tree->last = previous;
+        tree->size = count;
+
+        // Build each level of branches over the one below, in place, until one node remains.
+        while (nodeCount > 1) {
+            size_t branchCount = (nodeCount + _PARCTreeMap_BranchCapacity - 1) / _PARCTreeMap_BranchCapacity;
+            next = 0;
+            for (size_t i = 0; i < branchCount; i++) {
+                _BTreeBranch *branch = _parcTreeMapBranch_Create();
+                size_t children = nodeCount / branchCount + (i < nodeCount % branchCount ? 1 : 0);
+                const PARCObject *lowestKey = lowest[next];
+                size_t size = 0;
+                for (size_t j = 0; j < children; j++, next++) {
+                    if (j > 0) {
+                        branch->keys[j - 1] = parcObject_Acquire(lowest[next]);
+                    }
+                    branch->children[j] = nodes[next];
+                    branch->counts[j] = sizes[next];
+                    size += sizes[next];
+                }
+                branch->node.count = children;
 
-    // We're at the bottom.
-    // node is nil (a leaf)
-    newNode->parent = parent;
-    if (parent == tree->nil) {
-        // nil is our parent, we are the root
-        tree->root = newNode;
-    } else {
-        if (_rbNodeIsGreaterThan(tree, parent, key)) {
-            parent->leftChild = newNode;
-        } else {
-            parent->rightChild = newNode;
+                nodes[i] = &branch->node;
+                lowest[i] = lowestKey;
+                sizes[i] = size;
+            }
+            nodeCount = branchCount;
         }
+        tree->root = nodes[0];
+
+        parcMemory_Deallocate(&nodes);
+        parcMemory_Deallocate(&lowest);
+        parcMemory_Deallocate(&sizes);
     }
 
-    // We have inserted one node.
-    tree->size++;
+    return tree;
+}
+
+void
+parcTreeMap_Put(PARCTreeMap *tree, const PARCObject *key, const PARCObject *value)
+{
+    assertNotNull(tree, "Tree can't be NULL");
+    assertNotNull(key, "Key can't be NULL");
+    assertNotNull(value, "Value can't be NULL");
+
+    if (tree->backing != NULL) {
+        assertTrue(_parcTreeMap_InRange(tree, key), "The key is outside the range of the view");
+        tree = tree->backing;
+    }
+
+    PARCKeyValue *element = parcKeyValue_Create(key, value);
 
-    // We have a correct tree. But we need to regain the red-black property.
-    _rbNodeFix(tree, newNode);
+    PARCObject *separator;
+    _BTreeNode *right = _parcTreeMapNode_Put(tree, tree->root, element, &separator);
+
+    if (right != NULL) {
+        // The root was split, so the tree grows a level.
+        _BTreeBranch *root = _parcTreeMapBranch_Create();
+        root->children[0] = tree->root;
+        root->children[1] = right;
+        root->keys[0] = separator;
+        root->counts[1] = _parcTreeMapNode_Size(right);
+        root->counts[0] = tree->size - root->counts[1];
+        root->node.count = 2;
+        tree->root = &root->node;
+    }
 
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 }
 
 PARCObject *
 parcTreeMap_Get(PARCTreeMap *tree, const PARCObject *key)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
     PARCObject *result = NULL;
 
-    _RBNode *node = _rbFindNode(tree, tree->root, key);
+    if (_parcTreeMap_InRange(tree, key)) {
+        PARCTreeMap *entries = _parcTreeMap_Entries(tree);
+        _BTreeLeaf *leaf = _parcTreeMap_FindLeaf(entries, key);
+        bool found;
+        size_t index = _parcTreeMapLeaf_LowerBound(entries, leaf, key, &found);
 
-    if (node != NULL) {
-        result = parcKeyValue_GetValue(node->element);
+        if (found) {
+            result = parcKeyValue_GetValue(leaf->elements[index]);
+        }
     }
 
     return result;
@@ -693,21 +894,21 @@ parcTreeMap_Remove(PARCTreeMap *tree, const PARCObject *key)
 {
     assertNotNull(tree, "Tree can't be NULL");
     assertNotNull(key, "Key can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
     PARCObject *result = NULL;
 
-    _RBNode *node = _rbFindNode(tree, tree->root, key);
-
-    if (node != NULL) {
-        _rbNodeRemove(tree, node);
-        result = parcObject_Acquire(parcKeyValue_GetValue(node->element));
-        _rbNodeFree(node);
+    PARCKeyValue *element = NULL;
+    if (_parcTreeMap_InRange(tree, key)) {
+        element = _parcTreeMap_RemoveEntry(_parcTreeMap_Entries(tree), key);
     }
 
-    // We didn't find the node
+    if (element != NULL) {
+        result = parcObject_Acquire(parcKeyValue_GetValue(element));
+        parcKeyValue_Release(&element);
+    }
 
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
     return result;
 }
@@ -719,34 +920,38 @@ parcTreeMap_RemoveAndRelease(PARCTreeMap *tree, const PARCObject *key)
     assertNotNull(tree, "Tree can't be NULL");
     assertNotNull(key, "Key can't be NULL");
 
-    _RBNode *node = _rbFindNode(tree, tree->root, key);
+    PARCKeyValue *element = NULL;
+    if (_parcTreeMap_InRange(tree, key)) {
+        element = _parcTreeMap_RemoveEntry(_parcTreeMap_Entries(tree), key);
+    }
 
-    if (node != NULL) {
-        _rbNodeRemove(tree, node);
-        _rbNodeFree(node);
+    if (element != NULL) {
+        parcKeyValue_Release(&element);
     }
 
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 }
 
 PARCKeyValue *
 parcTreeMap_GetLastEntry(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
-    _RBNode *node = tree->root;
+    _parcTreeMap_AssertInvariants(tree);
 
-    if (tree->size == 0) {
-        // We don't have any entries
-        return NULL;
+    PARCKeyValue *result = NULL;
+
+    PARCTreeMap *entries = _parcTreeMap_Entries(tree);
+    if (tree->highKey != NULL) {
+        result = parcTreeMap_GetLowerEntry(entries, tree->highKey);
+    } else if (entries->size > 0) {
+        result = entries->last->elements[entries->last->node.count - 1];
     }
 
-    // Let's get to the bottom right of the tree to find the largest
-    while (node->rightChild != tree->nil) {
-        node = node->rightChild;
+    if (result != NULL && !_parcTreeMap_IsAboveLow(tree, parcKeyValue_GetKey(result))) {
+        result = NULL;
     }
 
-    return node->element;
+    return result;
 }
 
 PARCObject *
@@ -766,16 +971,17 @@ PARCKeyValue *
 parcTreeMap_GetFirstEntry(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
-    if (tree->size == 0) {
-        // We don't have any entries
-        return NULL;
-    }
+    PARCKeyValue *result = NULL;
 
-    _RBNode *node = _rbMinRelativeNode(tree, tree->root);
+    size_t index;
+    _BTreeLeaf *leaf = _parcTreeMap_FindFirst(tree, &index);
+    if (leaf != NULL) {
+        result = leaf->elements[index];
+    }
 
-    return node->element;
+    return result;
 }
 
 PARCObject *
@@ -796,12 +1002,15 @@ parcTreeMap_GetHigherEntry(const PARCTreeMap *tree, const PARCObject *key)
 {
     PARCKeyValue *result = NULL;
 
-    _RBNode *node = _rbFindNode(tree, tree->root, key);
-    if (node != NULL) {
-        node = _rbNextNode(tree, node);
-        if (node != NULL) {
-            result = node->element;
-        }
+    size_t index;
+    _BTreeLeaf *leaf;
+    if (_parcTreeMap_IsAboveLow(tree, key)) {
+        leaf = _parcTreeMap_FindHigher(_parcTreeMap_Entries(tree), key, &index);
+    } else {
+        leaf = _parcTreeMap_FindFirst(tree, &index);
+    }
+    if (leaf != NULL && _parcTreeMap_IsBelowHigh(tree, leaf->keys[index])) {
+        result = leaf->elements[index];
     }
 
     return result;
@@ -825,12 +1034,20 @@ parcTreeMap_GetLowerEntry(const PARCTreeMap *tree, const PARCObject *key)
 {
     PARCKeyValue *result = NULL;
 
-    _RBNode *node = _rbFindNode(tree, tree->root, key);
-    if (node != NULL) {
-        node = _rbPreviousNode(tree, node);
-        if (node != NULL) {
-            result = node->element;
-        }
+    if (!_parcTreeMap_IsBelowHigh(tree, key)) {
+        key = tree->highKey;
+    }
+
+    PARCTreeMap *entries = _parcTreeMap_Entries(tree);
+    _BTreeLeaf *leaf = _parcTreeMap_FindLeaf(entries, key);
+    bool found;
+    size_t index = _parcTreeMapLeaf_LowerBound(entries, leaf, key, &found);
+    if (index == 0) {
+        leaf = leaf->previous;
+        index = (leaf != NULL) ? leaf->node.count : 0;
+    }
+    if (leaf != NULL && _parcTreeMap_IsAboveLow(tree, leaf->keys[index - 1])) {
+        result = leaf->elements[index - 1];
     }
 
     return result;
@@ -854,161 +1071,204 @@ size_t
 parcTreeMap_Size(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
-    return tree->size;
+    size_t result = tree->size;
+
+    if (tree->backing != NULL) {
+        size_t low = _parcTreeMap_Offset(tree);
+        size_t high = (tree->highKey != NULL) ? _parcTreeMap_CountLess(tree->backing, tree->highKey) : tree->backing->size;
+        result = (high > low) ? high - low : 0;
+    }
+
+    return result;
 }
 
-static void
-_rbAddKeyToList(_RBNode *node, PARCList *list)
+PARCKeyValue *
+parcTreeMap_GetAtIndex(const PARCTreeMap *tree, size_t index)
 {
-    parcList_Add(list, parcObject_Acquire(parcKeyValue_GetKey(node->element)));
+    size_t size = parcTreeMap_Size(tree);
+    trapOutOfBoundsIf(index >= size, "Index must be within the range [0, %zu)", size);
+
+    size_t position;
+    _BTreeLeaf *leaf = _parcTreeMap_FindAtIndex(_parcTreeMap_Entries(tree), _parcTreeMap_Offset(tree) + index, &position);
+
+    return leaf->elements[position];
 }
 
-static void
-_rbAddalueToList(_RBNode *node, PARCList *list)
+size_t
+parcTreeMap_Rank(const PARCTreeMap *tree, const PARCObject *key)
+{
+    assertNotNull(tree, "Tree can't be NULL");
+    assertNotNull(key, "Key can't be NULL");
+
+    size_t result = 0;
+
+    if (_parcTreeMap_IsAboveLow(tree, key)) {
+        if (_parcTreeMap_IsBelowHigh(tree, key)) {
+            result = _parcTreeMap_CountLess(_parcTreeMap_Entries(tree), key) - _parcTreeMap_Offset(tree);
+        } else {
+            result = parcTreeMap_Size(tree);
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Make a view of the entries of the given map, which may itself be a view, with keys in the range [lowKey, highKey).
+ */
+static PARCTreeMap *
+_parcTreeMap_CreateView(const PARCTreeMap *tree, const PARCObject *lowKey, const PARCObject *highKey)
 {
-    parcList_Add(list, parcObject_Acquire(parcKeyValue_GetValue(node->element)));
+    assertNotNull(tree, "Tree can't be NULL");
+    _parcTreeMap_AssertInvariants(tree);
+
+    // The view keeps within the bounds of the map it is made from.
+    if (lowKey == NULL || !_parcTreeMap_IsAboveLow(tree, lowKey)) {
+        lowKey = tree->lowKey;
+    }
+    if (highKey == NULL || (tree->highKey != NULL && _parcTreeMap_Compare(tree, highKey, tree->highKey) > 0)) {
+        highKey = tree->highKey;
+    }
+
+    PARCTreeMap *result = parcObject_CreateInstance(PARCTreeMap);
+    assertNotNull(result, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(PARCTreeMap));
+    result->root = NULL;
+    result->first = NULL;
+    result->last = NULL;
+    result->size = 0;
+    result->customCompare = tree->customCompare;
+    result->backing = parcTreeMap_Acquire(_parcTreeMap_Entries(tree));
+    result->lowKey = (lowKey != NULL) ? parcObject_Acquire(lowKey) : NULL;
+    result->highKey = (highKey != NULL) ? parcObject_Acquire(highKey) : NULL;
+
+    return result;
 }
 
-static void
-_rbAddElementToList(_RBNode *node, PARCList *list)
+PARCTreeMap *
+parcTreeMap_SubMap(const PARCTreeMap *tree, const PARCObject *fromKey, const PARCObject *toKey)
+{
+    assertNotNull(fromKey, "From key can't be NULL");
+    assertNotNull(toKey, "To key can't be NULL");
+    assertTrue(_parcTreeMap_Compare(tree, fromKey, toKey) <= 0, "The from key must not be greater than the to key");
+
+    return _parcTreeMap_CreateView(tree, fromKey, toKey);
+}
+
+PARCTreeMap *
+parcTreeMap_HeadMap(const PARCTreeMap *tree, const PARCObject *toKey)
 {
-    parcList_Add(list, parcObject_Acquire(node->element));
+    assertNotNull(toKey, "To key can't be NULL");
+
+    return _parcTreeMap_CreateView(tree, NULL, toKey);
 }
 
-PARCList *
-parcTreeMap_AcquireKeys(const PARCTreeMap *tree)
+PARCTreeMap *
+parcTreeMap_TailMap(const PARCTreeMap *tree, const PARCObject *fromKey)
 {
-    assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    assertNotNull(fromKey, "From key can't be NULL");
 
-    PARCList *keys = parcList(parcArrayList_Create_Capacity((bool (*)(void *x, void *y))parcObject_Equals,
-                                                            (void (*)(void **))parcObject_Release, tree->size),
-                              PARCArrayListAsPARCList);
+    return _parcTreeMap_CreateView(tree, fromKey, NULL);
+}
 
-    if (tree->size > 0) {
-        _rbNodeRecursiveRun((PARCTreeMap *) tree, tree->root, (rbRecursiveFunc *) _rbAddKeyToList, keys);
-    }
-    return keys;
+static PARCList *
+_parcTreeMap_CreateList(size_t capacity)
+{
+    return parcList(parcArrayList_Create_Capacity((bool (*)(void *x, void *y))parcObject_Equals,
+                                                  (void (*)(void **))parcObject_Release, capacity),
+                    PARCArrayListAsPARCList);
 }
 
 PARCList *
-parcTreeMap_AcquireValues(const PARCTreeMap *tree)
+parcTreeMap_AcquireKeys(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
-    PARCList *values = parcList(parcArrayList_Create_Capacity((bool (*)(void *x, void *y))parcObject_Equals,
-                                                              (void (*)(void **))parcObject_Release, tree->size),
-                                PARCArrayListAsPARCList);
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(tree, &cursor);
 
-    if (tree->size > 0) {
-        _rbNodeRecursiveRun((PARCTreeMap *) tree, tree->root, (rbRecursiveFunc *) _rbAddalueToList, values);
+    PARCList *keys = _parcTreeMap_CreateList(cursor.limit);
+    while (parcTreeMap_CursorNext(&cursor)) {
+        parcList_Add(keys, parcObject_Acquire(parcCursor_GetKey(&cursor)));
     }
-    return values;
+    return keys;
 }
 
-static PARCList *
-_parcTreeMap_Elements(const PARCTreeMap *tree)
+PARCList *
+parcTreeMap_AcquireValues(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
+    _parcTreeMap_AssertInvariants(tree);
 
-    PARCList *elements = parcList(parcArrayList_Create_Capacity((bool (*)(void *x, void *y))parcObject_Equals,
-                                                                (void (*)(void **))parcObject_Release, tree->size),
-                                  PARCArrayListAsPARCList);
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(tree, &cursor);
 
-    if (tree->size > 0) {
-        _rbNodeRecursiveRun((PARCTreeMap *) tree, tree->root, (rbRecursiveFunc *) _rbAddElementToList, elements);
+    PARCList *values = _parcTreeMap_CreateList(cursor.limit);
+    while (parcTreeMap_CursorNext(&cursor)) {
+        parcList_Add(values, parcObject_Acquire(parcCursor_GetValue(&cursor)));
     }
-    return elements;
+    return values;
 }
 
 bool
 parcTreeMap_Equals(const PARCTreeMap *tree1, const PARCTreeMap *tree2)
 {
-    _rbNodeAssertTreeInvariants(tree1);
-    _rbNodeAssertTreeInvariants(tree2);
+    _parcTreeMap_AssertInvariants(tree1);
+    _parcTreeMap_AssertInvariants(tree2);
     assertNotNull(tree1, "Tree can't be NULL");
     assertNotNull(tree2, "Tree can't be NULL");
 
-    bool result = false;
+    PARCCursor cursor1;
+    PARCCursor cursor2;
+    parcTreeMap_InitCursor(tree1, &cursor1);
+    parcTreeMap_InitCursor(tree2, &cursor2);
 
-    PARCList *keys1 = parcTreeMap_AcquireKeys(tree1);
-    PARCList *keys2 = parcTreeMap_AcquireKeys(tree2);
-    size_t length1 = parcList_Size(keys1);
-    size_t length2 = parcList_Size(keys2);
+    bool result = (cursor1.limit == cursor2.limit);
 
-    if (length1 == length2) {
-        result = true;
-        for (size_t i = 0; i < length1; i++) {
-            if (!parcObject_Equals(parcList_GetAtIndex(keys1, i), parcList_GetAtIndex(keys2, i))) {
-                result = false;
-                break;
-            }
-        }
-        if (result) {
-            PARCList *values1 = parcTreeMap_AcquireValues(tree1);
-            PARCList *values2 = parcTreeMap_AcquireValues(tree2);
-            size_t s1 = parcList_Size(values1);
-            size_t s2 = parcList_Size(values2);
-            if (s1 == s2) {
-                for (size_t i = 0; i < s1; i++) {
-                    PARCObject *value1 = parcList_GetAtIndex(values1, i);
-                    PARCObject *value2 = parcList_GetAtIndex(values2, i);
-                    if (!parcObject_Equals(value1, value2)) {
-                        result = false;
-                        break;
-                    }
-                }
-            }
-            parcList_Release(&values1);
-            parcList_Release(&values2);
-        }
+    while (result && parcTreeMap_CursorNext(&cursor1) && parcTreeMap_CursorNext(&cursor2)) {
+        result = parcObject_Equals(parcCursor_GetKey(&cursor1), parcCursor_GetKey(&cursor2))
+                 && parcObject_Equals(parcCursor_GetValue(&cursor1), parcCursor_GetValue(&cursor2));
     }
 
-    parcList_Release(&keys1);
-    parcList_Release(&keys2);
     return result;
 }
 
 
 /*
- * This is a simple implementation of Copy that goes through the list of keys and values.
+ * The entries are visited in order, so the copy is bulk loaded rather than built by a Put for each entry.
+ * The copy of a view is a map holding copies of just the entries of the view.
  */
 PARCTreeMap *
 parcTreeMap_Copy(const PARCTreeMap *sourceTree)
 {
-    _rbNodeAssertTreeInvariants(sourceTree);
+    _parcTreeMap_AssertInvariants(sourceTree);
     assertNotNull(sourceTree, "Tree can't be NULL");
 
-    PARCObject *keySource;
-    PARCObject *keyCopy;
-    PARCObject *valueSource;
-    PARCObject *valueCopy;
-
-    PARCTreeMap *treeCopy = parcTreeMap_CreateCustom(sourceTree->customCompare);
-
-    PARCList *keys = parcTreeMap_AcquireKeys(sourceTree);
-    PARCList *values = parcTreeMap_AcquireValues(sourceTree);
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(sourceTree, &cursor);
 
-    size_t total_keys = parcList_Size(keys);
+    size_t count = cursor.limit;
+    PARCObject **keys = parcMemory_Allocate((count + 1) * sizeof(PARCObject *));
+    PARCObject **values = parcMemory_Allocate((count + 1) * sizeof(PARCObject *));
+    assertNotNull(keys, "parcMemory_Allocate(%zu) returned NULL", (count + 1) * sizeof(PARCObject *));
+    assertNotNull(values, "parcMemory_Allocate(%zu) returned NULL", (count + 1) * sizeof(PARCObject *));
 
-    for (size_t i = 0; i < total_keys; i++) {
-        keySource = parcList_GetAtIndex(keys, i);
-        valueSource = parcList_GetAtIndex(values, i);
+    for (size_t i = 0; parcTreeMap_CursorNext(&cursor); i++) {
+        keys[i] = parcObject_Copy(parcCursor_GetKey(&cursor));
+        values[i] = parcObject_Copy(parcCursor_GetValue(&cursor));
+    }
 
-        keyCopy = parcObject_Copy(keySource);
-        valueCopy = parcObject_Copy(valueSource);
+    PARCTreeMap *treeCopy = parcTreeMap_CreateFromSorted(sourceTree->customCompare, count,
+                                                         (const PARCObject **) keys, (const PARCObject **) values);
 
-        parcTreeMap_Put(treeCopy, keyCopy, valueCopy);
-        parcObject_Release(&keyCopy);
-        parcObject_Release(&valueCopy);
+    for (size_t i = 0; i < count; i++) {
+        parcObject_Release(&keys[i]);
+        parcObject_Release(&values[i]);
     }
-
-    parcList_Release(&keys);
-    parcList_Release(&values);
+    parcMemory_Deallocate(&keys);
+    parcMemory_Deallocate(&values);
 
     return treeCopy;
 }
@@ -1017,8 +1277,9 @@ parcTreeMap_Copy(const PARCTreeMap *sourceTree)
 
 typedef struct {
     PARCTreeMap *map;
-    PARCList *list;
-    size_t currentIndex;
+    _BTreeLeaf *leaf;
+    size_t index;
+    size_t remaining;
     PARCKeyValue *currentElement;
 } _PARCTreeMapIterator;
 
@@ -1029,10 +1290,9 @@ _parcTreeMapIterator_Init(PARCTreeMap *map)
 
     if (state != NULL) {
         state->map = map;
-        state->list = _parcTreeMap_Elements(map);
-        state->currentIndex = 0;
-        state->currentElement = parcList_GetAtIndex(state->list, 0);
-        trapOutOfMemoryIf(state->list == NULL, "Cannot create parcList");
+        state->leaf = _parcTreeMap_FindFirst(map, &state->index);
+        state->remaining = (state->leaf != NULL) ? parcTreeMap_Size(map) : 0;
+        state->currentElement = NULL;
     }
 
     return state;
@@ -1041,7 +1301,6 @@ _parcTreeMapIterator_Init(PARCTreeMap *map)
 static bool
 _parcTreeMapIterator_Fini(PARCTreeMap *map __attribute__((unused)), _PARCTreeMapIterator *state __attribute__((unused)))
 {
-    parcList_Release(&state->list);
     parcMemory_Deallocate(&state);
     return true;
 }
@@ -1049,23 +1308,38 @@ _parcTreeMapIterator_Fini(PARCTreeMap *map __attribute__((unused)), _PARCTreeMap
 static _PARCTreeMapIterator *
 _parcTreeMapIterator_Next(PARCTreeMap *map __attribute__((unused)), _PARCTreeMapIterator *state)
 {
-    state->currentElement = parcList_GetAtIndex(state->list, state->currentIndex);
-    ++state->currentIndex;
+    state->currentElement = state->leaf->elements[state->index];
+    state->remaining--;
+    if (++state->index == state->leaf->node.count) {
+        state->leaf = state->leaf->next;
+        state->index = 0;
+    }
     return state;
 }
 
+/*
+ * Removing the entry may move the entries that follow it between leaves,
+ * so the iterator finds its place again from the removed key.
+ */
 static void
 _parcTreeMapIterator_Remove(PARCTreeMap *map, _PARCTreeMapIterator **statePtr)
 {
     _PARCTreeMapIterator *state = *statePtr;
 
-    parcTreeMap_RemoveAndRelease(map, parcKeyValue_GetKey(state->currentElement));
+    PARCObject *key = parcObject_Acquire(parcKeyValue_GetKey(state->currentElement));
+    parcTreeMap_RemoveAndRelease(map, key);
+    state->currentElement = NULL;
+
+    if (state->remaining > 0) {
+        state->leaf = _parcTreeMap_FindHigher(_parcTreeMap_Entries(map), key, &state->index);
+    }
+    parcObject_Release(&key);
 }
 
 static bool
 _parcTreeMapIterator_HasNext(PARCTreeMap *map __attribute__((unused)), _PARCTreeMapIterator *state)
 {
-    return (parcList_Size(state->list) > state->currentIndex);
+    return (state->remaining > 0);
 }
 
 static PARCObject *
@@ -1131,3 +1405,58 @@ parcTreeMap_CreateKeyValueIterator(PARCTreeMap *treeMap)
 
     return iterator;
 }
+
+void
+parcTreeMap_InitCursor(const PARCTreeMap *tree, PARCCursor *cursor)
+{
+    assertNotNull(tree, "Tree can't be NULL");
+
+    size_t index = 0;
+    _BTreeLeaf *first = _parcTreeMap_FindFirst(tree, &index);
+    size_t limit = (first != NULL) ? parcTreeMap_Size(tree) : 0;
+
+    *cursor = (PARCCursor) { .collection = tree, .position = first, .index = index, .limit = limit };
+}
+
+void
+parcTreeMap_InitCursorFrom(const PARCTreeMap *tree, const PARCObject *fromKey, PARCCursor *cursor)
+{
+    assertNotNull(tree, "Tree can't be NULL");
+    assertNotNull(fromKey, "From key can't be NULL");
+
+    size_t index = 0;
+    _BTreeLeaf *first = NULL;
+    size_t limit = parcTreeMap_Size(tree) - parcTreeMap_Rank(tree, fromKey);
+
+    if (limit > 0) {
+        if (_parcTreeMap_IsAboveLow(tree, fromKey)) {
+            first = _parcTreeMap_FindCeiling(_parcTreeMap_Entries(tree), fromKey, &index);
+        } else {
+            first = _parcTreeMap_FindFirst(tree, &index);
+        }
+    }
+
+    *cursor = (PARCCursor) { .collection = tree, .position = first, .index = index, .limit = limit };
+}
+
+/*
+ * The cursor counts down the entries it has left to visit, so a view needs no comparison with its bounds.
+ */
+bool
+parcTreeMap_CursorNext(PARCCursor *cursor)
+{
+    _BTreeLeaf *leaf = cursor->position;
+
+    bool result = (cursor->limit > 0);
+    if (result) {
+        PARCKeyValue *element = leaf->elements[cursor->index];
+        cursor->element = (PARCObject *) leaf->keys[cursor->index];
+        cursor->value = parcKeyValue_GetValue(element);
+        cursor->limit--;
+        if (++cursor->index == leaf->node.count) {
+            cursor->position = leaf->next;
+            cursor->index = 0;
+        }
+    }
+    return result;
+}
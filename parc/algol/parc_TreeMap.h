@@ -27,7 +27,17 @@
 /**
  * @file parc_TreeMap.h
  * @ingroup datastructures
- * @brief A Red-Black tree containing PARCObject keys and values.
+ * @brief A B+-tree containing PARCObject keys and values.
+ *
+ * The entries are held in the leaves of the tree, each leaf holding many entries in key order,
+ * so lookups visit few nodes and ordered scans read the leaves in sequence.
+ *
+ * The tree counts the entries under each node, so the entry at a position, and the position of a key,
+ * are found in O(log n) time.
+ *
+ * {@link parcTreeMap_SubMap}, {@link parcTreeMap_HeadMap} and {@link parcTreeMap_TailMap} make views of a range of keys.
+ * A view is a `PARCTreeMap` that holds no entries of its own:
+ * it reads and changes the entries of the map it was made from, and sees changes made to that map.
  *
  * The map is sorted according to the natural ordering of its keys,
  * or by a comparator function provided at creation time, depending on which constructor is used.
@@ -44,6 +54,7 @@
 #include "parc_KeyValue.h"
 #include "parc_List.h"
 #include "parc_Iterator.h"
+#include "parc_Cursor.h"
 
 struct parc_treemap;
 typedef struct parc_treemap PARCTreeMap;
@@ -101,7 +112,7 @@ PARCTreeMap *parcTreeMap_Create(void);
  *
  * @param [in] customCompare A cusom function to compare keys  (required)
  * @return NULL Error allocating memory
- * @return Non-NULL An initialized RedBlack tree
+ * @return Non-NULL An initialized TreeMap
  *
  * Example:
  * @code
@@ -118,6 +129,37 @@ PARCTreeMap *parcTreeMap_Create(void);
  */
 PARCTreeMap *parcTreeMap_CreateCustom(PARCTreeMap_CustomCompare *customCompare);
 
+/**
+ * Create a `PARCTreeMap` holding the given keys and values, which are in ascending order of their keys.
+ *
+ * The tree is built directly from the sorted entries in O(n) time, rather than by a Put for each entry.
+ * Each key and value is acquired by the new tree.
+ *
+ * @param [in] customCompare A custom function to compare keys, or NULL to use parcObject_Compare.
+ * @param [in] count The number of keys and values.
+ * @param [in] keys An array of `count` keys, in strictly ascending order.
+ * @param [in] values An array of `count` values, where `values[i]` is the value of `keys[i]`.
+ *
+ * @return NULL Error allocating memory
+ * @return Non-NULL An initialized TreeMap
+ *
+ * Example:
+ * @code
+ * {
+ *      const PARCObject *keys[] = { ... };
+ *      const PARCObject *values[] = { ... };
+ *
+ *      PARCTreeMap *tree = parcTreeMap_CreateFromSorted(NULL, sizeof(keys) / sizeof(keys[0]), keys, values);
+ *
+ *      ...
+ *
+ *      parcTreeMap_Release(&tree);
+ * }
+ * @endcode
+ */
+PARCTreeMap *parcTreeMap_CreateFromSorted(PARCTreeMap_CustomCompare *customCompare, size_t count,
+                                          const PARCObject *keys[count], const PARCObject *values[count]);
+
 /**
  * Acquire a reference to a `PARCTreeMap`.
  *
@@ -340,6 +382,7 @@ PARCKeyValue *parcTreeMap_GetLastEntry(const PARCTreeMap *tree);
  * Get the next largest key from a `PARCTreeMap`. The returned key
  * will still be owned by the tree.  If the tree is empty or the
  * supplied key is the largest, the function will return NULL
+ * The supplied key need not be in the tree.
  *
  * @param [in] tree A pointer to an initialized `PARCTreeMap`.
  * @return A pointer to the next key. You do not own this value (it's still in the tree).
@@ -369,7 +412,7 @@ PARCObject *parcTreeMap_GetHigherKey(const PARCTreeMap *tree, const PARCObject *
  * Get the entry with the next largest key from a `PARCTreeMap`. The
  * returned entry will still be owned by the tree.  If the tree is
  * empty or the supplied key is the largest, the function will return
- * NULL.
+ * NULL. The supplied key need not be in the tree.
  *
  * @param [in] tree A pointer to an initialized `PARCTreeMap`.
  * @return A pointer to the next entry (a PARCKeyValue). The caller
@@ -400,6 +443,7 @@ PARCKeyValue *parcTreeMap_GetHigherEntry(const PARCTreeMap *tree, const PARCObje
  * Get the previous key from a `PARCTreeMap`. The returned key will
  * still be owned by the tree.  If the tree is empty or the supplied
  * key is the smallest in the tree, the function will return NULL.
+ * The supplied key need not be in the tree.
  *
  * @param [in] tree A pointer to an initialized `PARCTreeMap`.
  * @param [in] key A pointer to an key
@@ -431,6 +475,7 @@ PARCObject *parcTreeMap_GetLowerKey(const PARCTreeMap *tree, const PARCObject *k
  * Get the entry with the next smallest key from a `PARCTreeMap`. The returned entry (a PARCKeyValue) will
  * still be owned by the tree.  If the tree is empty or the supplied
  * key is the smallest in the tree, the function will return NULL.
+ * The supplied key need not be in the tree.
  *
  * @param [in] tree A pointer to an initialized `PARCTreeMap`.
  * @param [in] key A pointer to an key
@@ -541,6 +586,147 @@ void parcTreeMap_RemoveAndRelease(PARCTreeMap *tree, const PARCObject *key);
  */
 size_t parcTreeMap_Size(const PARCTreeMap *tree);
 
+/**
+ * Get the entry at the given position, in ascending order of keys, of a `PARCTreeMap`.
+ *
+ * The returned entry will still be owned by the tree.
+ * This takes O(log n) time.
+ *
+ * @param [in] tree A pointer to an initialized `PARCTreeMap`.
+ * @param [in] index The position of the entry, which must be less than the size of the tree.
+ *
+ * @return A pointer to the entry (a PARCKeyValue). The caller does not own this return.
+ *
+ * @throws trapOutOfBounds If the index is not less than the size of the tree.
+ *
+ * Example:
+ * @code
+ * {
+ *      PARCTreeMap * tree1 = parcTreeMap_Create(.....);
+ *
+ *      ...
+ *
+ *      PARCKeyValue *median = parcTreeMap_GetAtIndex(tree1, parcTreeMap_Size(tree1) / 2);
+ *
+ *      parcTreeMap_Release(&tree1);
+ * }
+ * @endcode
+ */
+PARCKeyValue *parcTreeMap_GetAtIndex(const PARCTreeMap *tree, size_t index);
+
+/**
+ * Get the number of keys in a `PARCTreeMap` that are less than the given key.
+ *
+ * If the key is in the tree this is its position, as used by {@link parcTreeMap_GetAtIndex}.
+ * The key need not be in the tree.
+ * This takes O(log n) time.
+ *
+ * @param [in] tree A pointer to an initialized `PARCTreeMap`.
+ * @param [in] key A pointer to a key.
+ *
+ * @return The number of keys in the tree that are less than the given key.
+ *
+ * Example:
+ * @code
+ * {
+ *      PARCTreeMap * tree1 = parcTreeMap_Create(.....);
+ *
+ *      ...
+ *
+ *      size_t below = parcTreeMap_Rank(tree1, someKey);
+ *      double percentile = 100.0 * below / parcTreeMap_Size(tree1);
+ *
+ *      parcTreeMap_Release(&tree1);
+ * }
+ * @endcode
+ */
+size_t parcTreeMap_Rank(const PARCTreeMap *tree, const PARCObject *key);
+
+/**
+ * Make a view of the entries of a `PARCTreeMap` with keys from `fromKey`, inclusive, to `toKey`, exclusive.
+ *
+ * The view copies nothing.
+ * It reads the entries of the given tree, and sees later changes to them.
+ * Entries put into the view are put into the given tree, and must have keys within the range of the view.
+ * A view of a view is a view of the same tree, with the range of keys the two have in common.
+ *
+ * The view acquires a reference to the tree and to the keys, and must be released with {@link parcTreeMap_Release}.
+ *
+ * @param [in] tree A pointer to an initialized `PARCTreeMap`.
+ * @param [in] fromKey The least key of the view.
+ * @param [in] toKey The key that all keys of the view are less than. It must not be less than `fromKey`.
+ *
+ * @return A pointer to a new `PARCTreeMap` that is a view of the given tree.
+ *
+ * Example:
+ * @code
+ * {
+ *      PARCTreeMap *view = parcTreeMap_SubMap(tree, fromKey, toKey);
+ *
+ *      PARCCursor cursor;
+ *      parcTreeMap_InitCursor(view, &cursor);
+ *      while (parcTreeMap_CursorNext(&cursor)) {
+ *          ...
+ *      }
+ *
+ *      parcTreeMap_Release(&view);
+ * }
+ * @endcode
+ * @see parcTreeMap_HeadMap
+ * @see parcTreeMap_TailMap
+ */
+PARCTreeMap *parcTreeMap_SubMap(const PARCTreeMap *tree, const PARCObject *fromKey, const PARCObject *toKey);
+
+/**
+ * Make a view of the entries of a `PARCTreeMap` with keys less than `toKey`.
+ *
+ * @param [in] tree A pointer to an initialized `PARCTreeMap`.
+ * @param [in] toKey The key that all keys of the view are less than.
+ *
+ * @return A pointer to a new `PARCTreeMap` that is a view of the given tree.
+ *
+ * Example:
+ * @code
+ * {
+ *      PARCTreeMap *view = parcTreeMap_HeadMap(tree, toKey);
+ *
+ *      size_t below = parcTreeMap_Size(view);
+ *
+ *      parcTreeMap_Release(&view);
+ * }
+ * @endcode
+ * @see parcTreeMap_SubMap
+ */
+PARCTreeMap *parcTreeMap_HeadMap(const PARCTreeMap *tree, const PARCObject *toKey);
+
+/**
+ * Make a view of the entries of a `PARCTreeMap` with keys not less than `fromKey`.
+ *
+ * An iterator made from the view starts at `fromKey`.
+ *
+ * @param [in] tree A pointer to an initialized `PARCTreeMap`.
+ * @param [in] fromKey The least key of the view.
+ *
+ * @return A pointer to a new `PARCTreeMap` that is a view of the given tree.
+ *
+ * Example:
+ * @code
+ * {
+ *      PARCTreeMap *view = parcTreeMap_TailMap(tree, fromKey);
+ *      PARCIterator *iterator = parcTreeMap_CreateKeyIterator(view);
+ *      parcTreeMap_Release(&view);
+ *
+ *      while (parcIterator_HasNext(iterator)) {
+ *          PARCObject *key = parcIterator_Next(iterator);
+ *      }
+ *
+ *      parcIterator_Release(&iterator);
+ * }
+ * @endcode
+ * @see parcTreeMap_SubMap
+ */
+PARCTreeMap *parcTreeMap_TailMap(const PARCTreeMap *tree, const PARCObject *fromKey);
+
 /**
  * Get a PARCList of the keys from a `PARCTreeMap`.  All keys will be
  * valid keys in the `PARCTreeMap`.  The caller will own the list of
@@ -724,4 +910,63 @@ PARCIterator *parcTreeMap_CreateValueIterator(PARCTreeMap *tree);
  * @endcode
  */
 PARCIterator *parcTreeMap_CreateKeyValueIterator(PARCTreeMap *tree);
+
+/**
+ * Initialise the given cursor to visit the entries, in ascending order of their keys, of the given `PARCTreeMap`.
+ *
+ * The cursor is positioned before the first entry.
+ * Advance it with {@link parcTreeMap_CursorNext}.
+ *
+ * @param [in] tree A pointer to a valid `PARCTreeMap`.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcTreeMap_InitCursor(tree, &cursor);
+ *     while (parcTreeMap_CursorNext(&cursor)) {
+ *         PARCObject *key = parcCursor_GetKey(&cursor);
+ *         PARCObject *value = parcCursor_GetValue(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcTreeMap_CursorNext
+ */
+void parcTreeMap_InitCursor(const PARCTreeMap *tree, PARCCursor *cursor);
+
+/**
+ * Initialise the given cursor to visit the entries of the given `PARCTreeMap` with keys not less than `fromKey`,
+ * in ascending order of their keys.
+ *
+ * The cursor is positioned before the first such entry, which is found in O(log n) time.
+ * Advance it with {@link parcTreeMap_CursorNext}.
+ *
+ * @param [in] tree A pointer to a valid `PARCTreeMap`.
+ * @param [in] fromKey The least key to visit. It need not be in the tree.
+ * @param [out] cursor A pointer to the `PARCCursor` to initialise.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCursor cursor;
+ *     parcTreeMap_InitCursorFrom(tree, fromKey, &cursor);
+ *     while (parcTreeMap_CursorNext(&cursor)) {
+ *         PARCObject *key = parcCursor_GetKey(&cursor);
+ *     }
+ * }
+ * @endcode
+ * @see parcTreeMap_CursorNext
+ */
+void parcTreeMap_InitCursorFrom(const PARCTreeMap *tree, const PARCObject *fromKey, PARCCursor *cursor);
+
+/**
+ * Advance the given cursor to the next entry of its `PARCTreeMap`.
+ *
+ * @param [in,out] cursor A pointer to a `PARCCursor` initialised by {@link parcTreeMap_InitCursor}.
+ *
+ * @return true The cursor is at the next entry.
+ * @return false There are no more entries.
+ */
+bool parcTreeMap_CursorNext(PARCCursor *cursor);
 #endif // libparc_parc_TreeMap_h
@@ -84,6 +84,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, PARC_ArrayList_InsertAtIndex_First);
     LONGBOW_RUN_TEST_CASE(Global, PARC_ArrayList_InsertAtIndex_Last);
     LONGBOW_RUN_TEST_CASE(Global, PARC_ArrayList_IsEmpty);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_ArrayList_InitCursor);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -348,6 +349,30 @@ LONGBOW_TEST_CASE(Global, PARC_ArrayList_Get)
     parcArrayList_Destroy(&array);
 }
 
+LONGBOW_TEST_CASE(Global, PARC_ArrayList_InitCursor)
+{
+    PARCArrayList *array = parcArrayList_Create(NULL);
+
+    PARCCursor cursor;
+    parcArrayList_InitCursor(array, &cursor);
+    assertFalse(parcArrayList_CursorNext(&cursor), "Expected no elements in an empty list");
+
+    for (size_t i = 0; i < 100; i++) {
+        parcArrayList_Add(array, (void *) i);
+    }
+
+    parcArrayList_InitCursor(array, &cursor);
+    size_t expected = 0;
+    while (parcArrayList_CursorNext(&cursor)) {
+        size_t actual = (size_t) parcCursor_GetElement(&cursor);
+        assertTrue(expected == actual, "Expected %zu, actual %zu", expected, actual);
+        expected++;
+    }
+    assertTrue(expected == 100, "Expected to visit 100 elements, actual %zu", expected);
+
+    parcArrayList_Destroy(&array);
+}
+
 LONGBOW_TEST_CASE(Global, PARC_ArrayList_New)
 {
     PARCArrayList *array = parcArrayList_Create(parcArrayList_StdlibFreeFunction);
@@ -31,6 +31,8 @@
 #include <config.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <sys/time.h>
+#include <pthread.h>
 #include <inttypes.h>
 
 #include <LongBow/unit-test.h>
@@ -244,6 +246,14 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HasRemaining);
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode);
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_ZeroRemaining);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Remembered);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Put);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Position);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Overlay);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Duplicate);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_HashCode_Wrap);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_Equals_HashCode);
+    LONGBOW_RUN_TEST_CASE(Global, parcBuffer_Equals_HashCode_Concurrent);
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_Mark);
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_Resize_Growing);
     LONGBOW_RUN_TEST_CASE(Global, parcBuffer_Resize_Growing_AtLimit);
@@ -1064,6 +1074,175 @@ LONGBOW_TEST_CASE(Global, parcBuffer_HashCode)
     parcBuffer_Release(&buffer2);
 }
 
+static PARCHashCode
+_uncachedHashCode(const PARCBuffer *buffer)
+{
+    PARCBuffer *copy = parcBuffer_Copy(buffer);
+    PARCHashCode result = parcHashCode_Hash(parcBuffer_Overlay(copy, 0), parcBuffer_Remaining(copy));
+    parcBuffer_Release(&copy);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Remembered)
+{
+    PARCBuffer *buffer = parcBuffer_AllocateCString("Hello World");
+
+    PARCHashCode expected = parcBuffer_HashCode(buffer);
+    assertTrue(buffer->hashCodeIsValid, "Expected the hash code to be remembered.");
+    assertTrue(buffer->hashCode == expected, "Expected the remembered hash code to be the computed one.");
+
+    // Overwrite the remembered value to show that the next call uses it.
+    buffer->hashCode = expected + 1;
+    PARCHashCode actual = parcBuffer_HashCode(buffer);
+    assertTrue(actual == expected + 1, "Expected the remembered hash code to be returned.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Put)
+{
+    PARCBuffer *buffer = parcBuffer_AllocateCString("Hello World");
+    PARCHashCode before = parcBuffer_HashCode(buffer);
+
+    parcBuffer_PutAtIndex(buffer, 0, 'J');
+    PARCHashCode after = parcBuffer_HashCode(buffer);
+    assertTrue(after != before, "Expected the hash code to change when the contents change.");
+    assertTrue(after == _uncachedHashCode(buffer), "Expected the hash code of the new contents.");
+
+    parcBuffer_PutUint8(buffer, 'K');
+    parcBuffer_SetPosition(buffer, 0);
+    assertTrue(parcBuffer_HashCode(buffer) == _uncachedHashCode(buffer), "Expected the hash code of the new contents.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Position)
+{
+    PARCBuffer *buffer = parcBuffer_AllocateCString("Hello World");
+    PARCHashCode whole = parcBuffer_HashCode(buffer);
+
+    parcBuffer_GetUint8(buffer);
+    PARCHashCode rest = parcBuffer_HashCode(buffer);
+    assertTrue(rest != whole, "Expected the hash code to depend on the position.");
+    assertTrue(rest == _uncachedHashCode(buffer), "Expected the hash code of the remaining bytes.");
+
+    parcBuffer_SetLimit(buffer, 5);
+    assertTrue(parcBuffer_HashCode(buffer) == _uncachedHashCode(buffer), "Expected the hash code of the remaining bytes.");
+
+    parcBuffer_Rewind(buffer);
+    parcBuffer_SetLimit(buffer, parcBuffer_Capacity(buffer) - 1);
+    assertTrue(parcBuffer_HashCode(buffer) == whole, "Expected the original hash code.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Overlay)
+{
+    PARCBuffer *buffer = parcBuffer_AllocateCString("Hello World");
+    PARCHashCode before = parcBuffer_HashCode(buffer);
+
+    char *bytes = parcBuffer_Overlay(buffer, 0);
+    bytes[0] = 'J';
+
+    assertTrue(parcBuffer_HashCode(buffer) != before, "Expected a write through the overlay to be seen.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Duplicate)
+{
+    PARCBuffer *buffer = parcBuffer_AllocateCString("Hello World");
+    PARCHashCode before = parcBuffer_HashCode(buffer);
+
+    PARCBuffer *duplicate = parcBuffer_Duplicate(buffer);
+    parcBuffer_PutAtIndex(duplicate, 0, 'J');
+    assertTrue(parcBuffer_HashCode(buffer) != before, "Expected a write through a duplicate to be seen.");
+    parcBuffer_Release(&duplicate);
+
+    PARCHashCode after = parcBuffer_HashCode(buffer);
+    assertTrue(after == _uncachedHashCode(buffer), "Expected the hash code of the new contents.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_Wrap)
+{
+    char string[] = "Hello World";
+    PARCBuffer *buffer = parcBuffer_WrapCString(string);
+    PARCHashCode before = parcBuffer_HashCode(buffer);
+
+    string[0] = 'J';
+    assertTrue(parcBuffer_HashCode(buffer) != before, "Expected a write to the wrapped memory to be seen.");
+
+    parcBuffer_Release(&buffer);
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_Equals_HashCode)
+{
+    PARCBuffer *x = parcBuffer_AllocateCString("Hello World");
+    PARCBuffer *y = parcBuffer_AllocateCString("Hello World");
+    PARCBuffer *z = parcBuffer_AllocateCString("Hello Earth");
+
+    parcBuffer_HashCode(x);
+    parcBuffer_HashCode(y);
+    parcBuffer_HashCode(z);
+
+    assertTrue(parcBuffer_Equals(x, y), "Expected equal buffers with equal hash codes to be equal.");
+    assertFalse(parcBuffer_Equals(x, z), "Expected buffers with different hash codes to be unequal.");
+
+    parcBuffer_Release(&x);
+    parcBuffer_Release(&y);
+    parcBuffer_Release(&z);
+}
+
+typedef struct {
+    PARCBuffer *x;
+    PARCBuffer *y;
+    PARCHashCode expected;
+    int failures;
+} _SharedBuffers;
+
+/*
+ * Hash and compare the shared buffers, and make each forget its hash code now and then, without changing them.
+ */
+static void *
+_hashSharedBuffers(void *parameter)
+{
+    _SharedBuffers *shared = parameter;
+    for (int i = 0; i < 5000; i++) {
+        if (parcBuffer_HashCode(shared->x) != shared->expected || !parcBuffer_Equals(shared->x, shared->y)) {
+            __atomic_add_fetch(&shared->failures, 1, __ATOMIC_RELAXED);
+        }
+        if (i % 7 == 0) {
+            PARCBuffer *duplicate = parcBuffer_Duplicate((i % 2 == 0) ? shared->x : shared->y);
+            parcBuffer_Release(&duplicate);
+        }
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, parcBuffer_Equals_HashCode_Concurrent)
+{
+    _SharedBuffers shared = {
+        .x = parcBuffer_AllocateCString("Hello World"),
+        .y = parcBuffer_AllocateCString("Hello World"),
+        .failures = 0
+    };
+    shared.expected = _uncachedHashCode(shared.x);
+
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, _hashSharedBuffers, &shared);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    assertTrue(shared.failures == 0, "Expected equal buffers with equal hash codes, %d failures", shared.failures);
+
+    parcBuffer_Release(&shared.x);
+    parcBuffer_Release(&shared.y);
+}
+
 LONGBOW_TEST_CASE(Global, parcBuffer_HashCode_ZeroRemaining)
 {
     uint8_t array[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
@@ -1475,6 +1654,7 @@ LONGBOW_TEST_CASE(Static, _digittoint)
 LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
 {
     LONGBOW_RUN_TEST_CASE(Performance, parcBuffer_Create);
+    LONGBOW_RUN_TEST_CASE(Performance, parcBuffer_HashCode_Rate);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Performance)
@@ -1505,6 +1685,30 @@ LONGBOW_TEST_CASE(Performance, parcBuffer_Create)
     }
 }
 
+LONGBOW_TEST_CASE(Performance, parcBuffer_HashCode_Rate)
+{
+    size_t sizes[] = { 16, 64, 256, 1024 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        PARCBuffer *buffer = parcBuffer_Allocate(sizes[i]);
+        memset(parcBuffer_Overlay(buffer, 0), 'x', sizes[i]);
+
+        struct timeval t0, t1, elapsed;
+        PARCHashCode sum = 0;
+        gettimeofday(&t0, NULL);
+        for (int j = 0; j < 1000000; j++) {
+            sum += parcBuffer_HashCode(buffer);
+        }
+        gettimeofday(&t1, NULL);
+
+        timersub(&t1, &t0, &elapsed);
+        double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+        printf("%4zd bytes, 1000000 calls, sec = %.3f, calls/sec = %.0f (%" PRIPARCHashCode ")\n", sizes[i], sec, 1000000 / sec, sum);
+
+        parcBuffer_Release(&buffer);
+    }
+}
+
 int
 main(int argc, char *argv[argc])
 {
@@ -25,6 +25,8 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "../parc_Deque.c"
+
+#include <sys/time.h>
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_StdlibMemory.h>
@@ -138,6 +140,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_RemoveFirst);
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_RemoveFirst_SingleElement);
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_RemoveLast);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_RemoveLast_SingleElement);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_Remove_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_Prepend_Many);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_AppendPrepend_Many);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_Queue_ReusesBlocks);
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_Size);
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_Equals);
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_Copy);
@@ -145,6 +152,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_Display_NULL);
 
     LONGBOW_RUN_TEST_CASE(Global, parcDeque_Iterator);
+    LONGBOW_RUN_TEST_CASE(Global, parcDeque_InitCursor);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -229,8 +237,7 @@ LONGBOW_TEST_CASE(Global, parcDeque_Prepend_One)
 
     assertTrue(deque == actual, "Expected parcDeque_Append to return its argument.");
     assertTrue(parcDeque_Size(deque) == 1, "Expected size of 1, actual %zd", parcDeque_Size(deque));
-    assertTrue(deque->head != NULL, "Expected head to be not null.");
-    assertTrue(deque->head == deque->tail, "Expected head to be equal to the tail.");
+    assertTrue(parcDeque_PeekFirst(deque) == parcDeque_PeekLast(deque), "Expected the first element to be the last.");
 
     parcDeque_Release(&deque);
 }
@@ -316,6 +323,85 @@ LONGBOW_TEST_CASE(Global, parcDeque_RemoveLast)
     parcDeque_Release(&deque);
 }
 
+LONGBOW_TEST_CASE(Global, parcDeque_Remove_Empty)
+{
+    PARCDeque *deque = parcDeque_Create();
+
+    assertNull(parcDeque_RemoveFirst(deque), "Expected NULL from an empty deque");
+    assertNull(parcDeque_RemoveLast(deque), "Expected NULL from an empty deque");
+    assertNull(parcDeque_PeekFirst(deque), "Expected NULL from an empty deque");
+    assertNull(parcDeque_PeekLast(deque), "Expected NULL from an empty deque");
+
+    parcDeque_Append(deque, "element");
+    parcDeque_RemoveLast(deque);
+    assertNull(parcDeque_RemoveFirst(deque), "Expected NULL from an emptied deque");
+
+    parcDeque_Release(&deque);
+}
+
+LONGBOW_TEST_CASE(Global, parcDeque_Prepend_Many)
+{
+    PARCDeque *deque = parcDeque_Create();
+
+    for (size_t i = 0; i < 1000; i++) {
+        parcDeque_Prepend(deque, (void *) i);
+    }
+
+    assertTrue(parcDeque_Size(deque) == 1000, "Expected size of 1000, actual %zd", parcDeque_Size(deque));
+    for (size_t i = 0; i < 1000; i++) {
+        size_t actual = (size_t) parcDeque_GetAtIndex(deque, i);
+        assertTrue(actual == 999 - i, "Expected %zd at index %zd, actual %zd", 999 - i, i, actual);
+    }
+
+    parcDeque_Release(&deque);
+}
+
+LONGBOW_TEST_CASE(Global, parcDeque_AppendPrepend_Many)
+{
+    PARCDeque *deque = parcDeque_Create();
+
+    // Grow the deque while its first element is in the middle of a block.
+    for (size_t i = 1; i <= 500; i++) {
+        parcDeque_Append(deque, (void *) (1000 + i));
+        parcDeque_Prepend(deque, (void *) (1000 - i));
+    }
+
+    assertTrue(parcDeque_Size(deque) == 1000, "Expected size of 1000, actual %zd", parcDeque_Size(deque));
+    for (size_t i = 0; i < 500; i++) {
+        size_t actual = (size_t) parcDeque_GetAtIndex(deque, i);
+        assertTrue(actual == 500 + i, "Expected %zd at index %zd, actual %zd", 500 + i, i, actual);
+        actual = (size_t) parcDeque_GetAtIndex(deque, 500 + i);
+        assertTrue(actual == 1001 + i, "Expected %zd at index %zd, actual %zd", 1001 + i, 500 + i, actual);
+    }
+
+    for (size_t i = 0; i < 500; i++) {
+        assertTrue((size_t) parcDeque_RemoveFirst(deque) == 500 + i, "Expected %zd first", 500 + i);
+        assertTrue((size_t) parcDeque_RemoveLast(deque) == 1500 - i, "Expected %zd last", 1500 - i);
+    }
+    assertTrue(parcDeque_IsEmpty(deque), "Expected an empty deque");
+
+    parcDeque_Release(&deque);
+}
+
+LONGBOW_TEST_CASE(Global, parcDeque_Queue_ReusesBlocks)
+{
+    PARCDeque *deque = parcDeque_Create();
+
+    for (size_t i = 0; i < 10; i++) {
+        parcDeque_Append(deque, (void *) i);
+    }
+
+    size_t outstanding = parcMemory_Outstanding();
+    for (size_t i = 10; i < 100000; i++) {
+        parcDeque_Append(deque, (void *) i);
+        size_t actual = (size_t) parcDeque_RemoveFirst(deque);
+        assertTrue(actual == i - 10, "Expected %zd, actual %zd", i - 10, actual);
+    }
+    assertTrue(parcMemory_Outstanding() == outstanding, "Expected a queue of constant length to allocate nothing");
+
+    parcDeque_Release(&deque);
+}
+
 LONGBOW_TEST_CASE(Global, parcDeque_RemoveLast_SingleElement)
 {
     char *expectedFirst = "expected 1st";
@@ -482,9 +568,34 @@ LONGBOW_TEST_CASE(Global, parcDeque_Iterator)
     parcDeque_Release(&x);
 }
 
+LONGBOW_TEST_CASE(Global, parcDeque_InitCursor)
+{
+    PARCDeque *x = parcDeque_Create();
+
+    PARCCursor cursor;
+    parcDeque_InitCursor(x, &cursor);
+    assertFalse(parcDeque_CursorNext(&cursor), "Expected no elements in an empty deque");
+
+    for (size_t i = 0; i < 100; i++) {
+        parcDeque_Append(x, (void *) i);
+    }
+
+    parcDeque_InitCursor(x, &cursor);
+    size_t expected = 0;
+    while (parcDeque_CursorNext(&cursor)) {
+        size_t actual = (size_t) parcCursor_GetElement(&cursor);
+        assertTrue(expected == actual, "Expected %zd, actual %zd", expected, actual);
+        expected++;
+    }
+    assertTrue(expected == 100, "Expected to visit 100 elements, actual %zd", expected);
+
+    parcDeque_Release(&x);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
-    LONGBOW_RUN_TEST_CASE(Local, _parcDequeNode_Create);
+    LONGBOW_RUN_TEST_CASE(Local, _parcDeque_Grow);
+    LONGBOW_RUN_TEST_CASE(Local, _parcDeque_Grow_Wrapped);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -502,14 +613,51 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
-LONGBOW_TEST_CASE(Local, _parcDequeNode_Create)
+LONGBOW_TEST_CASE(Local, _parcDeque_Grow)
+{
+    PARCDeque *deque = parcDeque_Create();
+    assertTrue(deque->blockCount == 0, "Expected an empty deque to have no blocks");
+
+    for (size_t i = 0; i < _PARCDeque_BlockSize; i++) {
+        parcDeque_Append(deque, (void *) i);
+    }
+    assertTrue(deque->blockCount == _PARCDeque_InitialBlocks, "Expected %d block, actual %zd", _PARCDeque_InitialBlocks, deque->blockCount);
+
+    parcDeque_Append(deque, (void *) _PARCDeque_BlockSize);
+    assertTrue(deque->blockCount == 2 * _PARCDeque_InitialBlocks, "Expected the block map to double, actual %zd", deque->blockCount);
+    _parcDeque_AssertInvariants(deque);
+
+    for (size_t i = 0; i <= _PARCDeque_BlockSize; i++) {
+        assertTrue((size_t) parcDeque_GetAtIndex(deque, i) == i, "Expected %zd at index %zd", i, i);
+    }
+
+    parcDeque_Release(&deque);
+}
+
+LONGBOW_TEST_CASE(Local, _parcDeque_Grow_Wrapped)
 {
-    void *element = "element";
-    struct parc_deque_node *previous = NULL;
-    struct parc_deque_node *next = NULL;
+    PARCDeque *deque = parcDeque_Create();
+
+    // Fill one block so that the first element is three positions before its end, and the ring wraps.
+    for (size_t i = 0; i < _PARCDeque_BlockSize - 3; i++) {
+        parcDeque_Append(deque, (void *) (i + 3));
+    }
+    for (size_t i = 0; i < 3; i++) {
+        parcDeque_Prepend(deque, (void *) (2 - i));
+    }
+    assertTrue(deque->first == _PARCDeque_BlockSize - 3, "Expected the first element at position %zd, actual %zd",
+               _PARCDeque_BlockSize - 3, deque->first);
+    assertTrue(deque->size == _parcDeque_Capacity(deque), "Expected a full ring");
+
+    parcDeque_Append(deque, (void *) _PARCDeque_BlockSize);
+    _parcDeque_AssertInvariants(deque);
+
+    for (size_t i = 0; i <= _PARCDeque_BlockSize; i++) {
+        assertTrue((size_t) parcDeque_GetAtIndex(deque, i) == i, "Expected %zd at index %zd, actual %zd",
+                   i, i, (size_t) parcDeque_GetAtIndex(deque, i));
+    }
 
-    struct parc_deque_node *actual = _parcDequeNode_Create(element, previous, next);
-    _parcDequeNode_Destroy(NULL, &actual);
+    parcDeque_Release(&deque);
 }
 
 LONGBOW_TEST_FIXTURE(Errors)
@@ -557,6 +705,8 @@ LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
     LONGBOW_RUN_TEST_CASE(Performance, parcQueue_Append);
     LONGBOW_RUN_TEST_CASE(Performance, parcQueue_N2);
     LONGBOW_RUN_TEST_CASE(Performance, parcQueue_Iterator);
+    LONGBOW_RUN_TEST_CASE(Performance, parcQueue_InitCursor);
+    LONGBOW_RUN_TEST_CASE(Performance, parcQueue_VersusNodes);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Performance)
@@ -621,6 +771,148 @@ LONGBOW_TEST_CASE(Performance, parcQueue_Iterator)
     parcDeque_Release(&x);
 }
 
+LONGBOW_TEST_CASE(Performance, parcQueue_InitCursor)
+{
+    PARCDeque *x = parcDeque_Create();
+    for (size_t i = 0; i < 100000; i++) {
+        parcDeque_Append(x, (void *) i);
+    }
+
+    PARCCursor cursor;
+    parcDeque_InitCursor(x, &cursor);
+    size_t expected = 0;
+    while (parcDeque_CursorNext(&cursor)) {
+        size_t actual = (size_t) parcCursor_GetElement(&cursor);
+        assertTrue(expected == actual, "Expected %zd, actual %zd", expected, actual);
+        expected++;
+    }
+
+    parcDeque_Release(&x);
+}
+
+/*
+ * The previous PARCDeque layout: a doubly-linked list with a node allocated for every element.
+ */
+typedef struct _node {
+    void *element;
+    struct _node *previous;
+    struct _node *next;
+} _Node;
+
+typedef struct {
+    _Node *head;
+    _Node *tail;
+    size_t size;
+} _NodeDeque;
+
+static void
+_nodeDeque_Append(_NodeDeque *deque, void *element)
+{
+    _Node *node = parcMemory_Allocate(sizeof(_Node));
+    *node = (_Node) { .element = element, .previous = deque->tail, .next = NULL };
+    if (deque->tail == NULL) {
+        deque->head = node;
+    } else {
+        deque->tail->next = node;
+    }
+    deque->tail = node;
+    deque->size++;
+}
+
+static void *
+_nodeDeque_RemoveFirst(_NodeDeque *deque)
+{
+    _Node *node = deque->head;
+    void *result = node->element;
+    deque->head = node->next;
+    if (deque->head == NULL) {
+        deque->tail = NULL;
+    } else {
+        deque->head->previous = NULL;
+    }
+    parcMemory_Deallocate(&node);
+    deque->size--;
+    return result;
+}
+
+static void *
+_nodeDeque_GetAtIndex(const _NodeDeque *deque, size_t index)
+{
+    _Node *node = deque->head;
+    while (index--) {
+        node = node->next;
+    }
+    return node->element;
+}
+
+static void
+_performanceReport(const char *name, const char *operation, size_t count, struct timeval *t0, struct timeval *t1)
+{
+    struct timeval elapsed;
+    timersub(t1, t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%-6s %-12s: %zu elements, nsec/op = %.1f\n", name, operation, count, sec * 1E9 / count);
+}
+
+LONGBOW_TEST_CASE(Performance, parcQueue_VersusNodes)
+{
+    const size_t count = 1000000;
+    const size_t indexed = 10000;
+    struct timeval t0, t1;
+
+    _NodeDeque nodes = { .head = NULL, .tail = NULL, .size = 0 };
+    PARCDeque *blocks = parcDeque_Create();
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        _nodeDeque_Append(&nodes, (void *) i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("nodes", "append", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        parcDeque_Append(blocks, (void *) i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("blocks", "append", count, &t0, &t1);
+
+    // Indexing the node layout is O(n), so use fewer elements for it.
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < indexed; i++) {
+        assertTrue((size_t) _nodeDeque_GetAtIndex(&nodes, i) == i, "Expected %zd", i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("nodes", "get at index", indexed, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        assertTrue((size_t) parcDeque_GetAtIndex(blocks, i) == i, "Expected %zd", i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("blocks", "get at index", count, &t0, &t1);
+
+    // Use each as a queue of constant length.
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        _nodeDeque_Append(&nodes, _nodeDeque_RemoveFirst(&nodes));
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("nodes", "queue", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        parcDeque_Append(blocks, parcDeque_RemoveFirst(blocks));
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("blocks", "queue", count, &t0, &t1);
+
+    while (nodes.size > 0) {
+        _nodeDeque_RemoveFirst(&nodes);
+    }
+    parcDeque_Release(&blocks);
+}
+
 int
 main(int argc, char *argv[])
 {
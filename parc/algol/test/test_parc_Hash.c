@@ -28,6 +28,8 @@
 
 #include <LongBow/testing.h>
 #include <stdio.h>
+#include <inttypes.h>
+#include <sys/time.h>
 
 #include <parc/algol/parc_SafeMemory.h>
 
@@ -38,6 +40,7 @@ LONGBOW_TEST_RUNNER(parc_Hash)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -67,6 +70,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Data);
     LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Int32);
     LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Int64);
+    LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Data_Cumulative);
+    LONGBOW_RUN_TEST_CASE(Global, parc_Hash32_Data_Cumulative);
+    LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Data_Cumulative_EverySplit);
+    LONGBOW_RUN_TEST_CASE(Global, parc_Hash64_Block);
+    LONGBOW_RUN_TEST_CASE(Global, parc_Hash32_Block);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -240,8 +248,84 @@ LONGBOW_TEST_CASE(Global, parc_Hash64_Int64)
     assertTrue(hash1 == hash3, "Hash different for same content");
 }
 
+LONGBOW_TEST_CASE(Global, parc_Hash64_Data_Cumulative)
+{
+    char *data = "1234567890abcdefghij";
+
+    uint64_t first = parcHash64_Data(data, 10);
+    uint64_t hash1 = parcHash64_Data_Cumulative(&data[10], 10, first);
+    uint64_t hash2 = parcHash64_Data_Cumulative(&data[10], 10, first);
+    uint64_t other = parcHash64_Data_Cumulative(&data[10], 10, first + 1);
+
+    assertTrue(hash1 == hash2, "Hash different for the same content and previous hash");
+    assertTrue(hash1 != first, "Expected the cumulative hash to differ from the previous hash");
+    assertTrue(hash1 != other, "Expected the cumulative hash to depend on the previous hash");
+    assertTrue(hash1 == parcHash64_Data(data, 20), "Expected the cumulative hash to equal the hash of all the data");
+}
+
+LONGBOW_TEST_CASE(Global, parc_Hash32_Data_Cumulative)
+{
+    char *data = "1234567890abcdefghij";
+
+    uint32_t first = parcHash32_Data(data, 10);
+    uint32_t hash1 = parcHash32_Data_Cumulative(&data[10], 10, first);
+    uint32_t hash2 = parcHash32_Data_Cumulative(&data[10], 10, first);
+    uint32_t other = parcHash32_Data_Cumulative(&data[10], 10, first + 1);
+
+    assertTrue(hash1 == hash2, "Hash different for the same content and previous hash");
+    assertTrue(hash1 != first, "Expected the cumulative hash to differ from the previous hash");
+    assertTrue(hash1 != other, "Expected the cumulative hash to depend on the previous hash");
+    assertTrue(hash1 == parcHash32_Data(data, 20), "Expected the cumulative hash to equal the hash of all the data");
+}
+
+LONGBOW_TEST_CASE(Global, parc_Hash64_Data_Cumulative_EverySplit)
+{
+    char data[100];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (char) (i * 37);
+    }
+
+    uint64_t whole = parcHash64_Data(data, sizeof(data));
+    for (size_t split = 0; split <= sizeof(data); split++) {
+        uint64_t first = parcHash64_Data(data, split);
+        uint64_t actual = parcHash64_Data_Cumulative(&data[split], sizeof(data) - split, first);
+        assertTrue(actual == whole, "Expected the cumulative hash split at %zd to equal the hash of all the data", split);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parc_Hash64_Block)
+{
+    char *data = "Hello World";
+
+    uint64_t hash1 = parcHash64_Block(data, strlen(data), 0);
+    uint64_t hash2 = parcHash64_Block(data, strlen(data), 0);
+    uint64_t other = parcHash64_Block(data, strlen(data), 1);
+
+    assertTrue(hash1 != 0, "Hash is 0, unlikely");
+    assertTrue(hash1 == hash2, "Hash different for same content");
+    assertTrue(hash1 != other, "Expected the hash to depend on the seed");
+    assertTrue(hash1 != parcHash64_Data(data, strlen(data)), "Expected the block hash to differ from FNV-1a");
+}
+
+LONGBOW_TEST_CASE(Global, parc_Hash32_Block)
+{
+    char *data = "Hello World";
+
+    uint32_t hash1 = parcHash32_Block(data, strlen(data), 0);
+    uint32_t hash2 = parcHash32_Block(data, strlen(data), 0);
+    uint32_t other = parcHash32_Block(data, strlen(data), 1);
+
+    assertTrue(hash1 != 0, "Hash is 0, unlikely");
+    assertTrue(hash1 == hash2, "Hash different for same content");
+    assertTrue(hash1 != other, "Expected the hash to depend on the seed");
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
+    LONGBOW_RUN_TEST_CASE(Local, _parcHash64_FNV1a_Cumulative);
+    LONGBOW_RUN_TEST_CASE(Local, _parcHash64_Wy_EveryByte);
+    LONGBOW_RUN_TEST_CASE(Local, _parcHash64_Wy_Seed);
+    LONGBOW_RUN_TEST_CASE(Local, _parcHash64_Wy_Avalanche);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -254,6 +338,194 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+static uint64_t
+_xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/*
+ * Flip each bit of many random keys of the given length and count how often each bit of the hash changes.
+ * Return the largest deviation, over all input and output bits, from the ideal probability of 0.5.
+ */
+static double
+_avalancheBias(uint64_t (*hash)(const void *, size_t, uint64_t), size_t keyLength, int samples)
+{
+    uint8_t key[64];
+    size_t inputBits = keyLength * 8;
+    uint32_t *flips = calloc(inputBits * 64, sizeof(uint32_t));
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (int sample = 0; sample < samples; sample++) {
+        for (size_t i = 0; i < keyLength; i++) {
+            key[i] = (uint8_t) _xorshift64(&state);
+        }
+        uint64_t original = hash(key, keyLength, 0);
+        for (size_t bit = 0; bit < inputBits; bit++) {
+            key[bit / 8] ^= (uint8_t) (1 << (bit % 8));
+            uint64_t changed = original ^ hash(key, keyLength, 0);
+            key[bit / 8] ^= (uint8_t) (1 << (bit % 8));
+            for (int out = 0; out < 64; out++) {
+                flips[bit * 64 + out] += (changed >> out) & 1;
+            }
+        }
+    }
+
+    double worst = 0.0;
+    for (size_t i = 0; i < inputBits * 64; i++) {
+        double bias = (double) flips[i] / samples - 0.5;
+        bias = bias < 0 ? -bias : bias;
+        worst = bias > worst ? bias : worst;
+    }
+    free(flips);
+    return worst;
+}
+
+LONGBOW_TEST_CASE(Local, _parcHash64_FNV1a_Cumulative)
+{
+    char *data = "1234567890abcdefghij";
+
+    uint64_t first = _parcHash64_FNV1a(data, 10, 0xCBF29CE484222325ULL);
+    uint64_t cumulative = _parcHash64_FNV1a(&data[10], 10, first);
+    uint64_t whole = _parcHash64_FNV1a(data, 20, 0xCBF29CE484222325ULL);
+
+    assertTrue(cumulative == whole, "Expected the FNV-1a cumulative hash to equal the hash of all the data");
+}
+
+LONGBOW_TEST_CASE(Local, _parcHash64_Wy_EveryByte)
+{
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) i;
+    }
+
+    // Exercise every path through the function: short, 16 byte steps, and 48 byte steps with a remainder.
+    for (size_t length = 0; length <= sizeof(data); length++) {
+        uint64_t expected = _parcHash64_Wy(data, length, 0);
+        if (length > 0) {
+            assertTrue(expected != _parcHash64_Wy(data, length - 1, 0), "Expected different hashes for lengths %zd and %zd", length, length - 1);
+        }
+        for (size_t i = 0; i < length; i++) {
+            data[i] ^= 0x80;
+            uint64_t actual = _parcHash64_Wy(data, length, 0);
+            data[i] ^= 0x80;
+            assertTrue(expected != actual, "Expected byte %zd of %zd to change the hash", i, length);
+        }
+    }
+}
+
+LONGBOW_TEST_CASE(Local, _parcHash64_Wy_Seed)
+{
+    char *data = "Hello World";
+
+    uint64_t hash1 = _parcHash64_Wy(data, strlen(data), 0);
+    uint64_t hash2 = _parcHash64_Wy(data, strlen(data), 1);
+    uint64_t hash3 = _parcHash64_Wy(data, strlen(data), 0);
+
+    assertTrue(hash1 != hash2, "Expected different seeds to produce different hashes");
+    assertTrue(hash1 == hash3, "Expected the same seed to produce the same hash");
+}
+
+LONGBOW_TEST_CASE(Local, _parcHash64_Wy_Avalanche)
+{
+    size_t lengths[] = { 3, 8, 16, 40, 64 };
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        double bias = _avalancheBias(_parcHash64_Wy, lengths[i], 1000);
+        assertTrue(bias < 0.1, "Expected every input bit to change each output bit about half the time, worst bias %f for %zd byte keys",
+                   bias, lengths[i]);
+    }
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, _parcHash64_Throughput);
+    LONGBOW_RUN_TEST_CASE(Performance, _parcHash64_Quality);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static double
+_throughput(uint64_t (*hash)(const void *, size_t, uint64_t), const uint8_t *data, size_t length)
+{
+    size_t iterations = (256 * 1024 * 1024) / length;
+    uint64_t sum = 0;
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (size_t i = 0; i < iterations; i++) {
+        sum += hash(data, length, sum);
+    }
+    struct timeval end;
+    gettimeofday(&end, NULL);
+    timersub(&end, &start, &end);
+
+    double seconds = end.tv_sec + end.tv_usec / 1000000.0;
+    return (double) iterations * length / seconds / (1024 * 1024 * 1024);
+}
+
+LONGBOW_TEST_CASE(Performance, _parcHash64_Throughput)
+{
+    static uint8_t data[4096];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 31);
+    }
+
+    size_t lengths[] = { 8, 16, 32, 64, 256, 1024, 4096 };
+    printf("%8s %12s %12s\n", "length", "FNV-1a GB/s", "wyhash GB/s");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        printf("%8zd %12.2f %12.2f\n", lengths[i],
+               _throughput(_parcHash64_FNV1a, data, lengths[i]),
+               _throughput(_parcHash64_Wy, data, lengths[i]));
+    }
+}
+
+LONGBOW_TEST_CASE(Performance, _parcHash64_Quality)
+{
+    size_t lengths[] = { 4, 8, 16, 32, 64 };
+    printf("Worst avalanche bias (0 is ideal, 0.5 is an output bit independent of an input bit)\n");
+    printf("%8s %12s %12s\n", "length", "FNV-1a", "wyhash");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        printf("%8zd %12.3f %12.3f\n", lengths[i],
+               _avalancheBias(_parcHash64_FNV1a, lengths[i], 10000),
+               _avalancheBias(_parcHash64_Wy, lengths[i], 10000));
+    }
+
+    // Sequential integer keys into a power-of-two table, as PARCHashMap uses them.
+    const size_t buckets = 1024;
+    const size_t keys = buckets * 16;
+    uint32_t *fnvCounts = calloc(buckets, sizeof(uint32_t));
+    uint32_t *wyCounts = calloc(buckets, sizeof(uint32_t));
+    for (uint64_t key = 0; key < keys; key++) {
+        fnvCounts[_parcHash64_FNV1a(&key, sizeof(key), 0xCBF29CE484222325ULL) & (buckets - 1)]++;
+        wyCounts[_parcHash64_Wy(&key, sizeof(key), 0xCBF29CE484222325ULL) & (buckets - 1)]++;
+    }
+    double fnvChiSquared = 0;
+    double wyChiSquared = 0;
+    double expected = (double) keys / buckets;
+    for (size_t i = 0; i < buckets; i++) {
+        fnvChiSquared += (fnvCounts[i] - expected) * (fnvCounts[i] - expected) / expected;
+        wyChiSquared += (wyCounts[i] - expected) * (wyCounts[i] - expected) / expected;
+    }
+    printf("Chi-squared of %zd sequential keys in %zd buckets (about %zd is ideal): FNV-1a %.1f wyhash %.1f\n",
+           keys, buckets, buckets - 1, fnvChiSquared, wyChiSquared);
+    free(fnvCounts);
+    free(wyCounts);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -30,7 +30,10 @@
  */
 #include "../parc_HashMap.c"
 
+#include <sys/time.h>
+
 #include <LongBow/unit-test.h>
+#include <parc/algol/parc_LinkedList.h>
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_StdlibMemory.h>
 
@@ -46,6 +49,7 @@ LONGBOW_TEST_RUNNER(parc_HashMap)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(ObjectContract);
     LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -109,18 +113,20 @@ LONGBOW_TEST_CASE(CreateAcquireRelease, CreateCapacityNominal)
     assertNotNull(instance, "Expeced non-null result from parcHashMap_Create();");
     parcObjectTesting_AssertAcquireReleaseContract(parcHashMap_Acquire, instance);
 
-    //Make sure all the buckets exist
-    PARCBuffer *key = parcBuffer_WrapCString("key");
+    size_t initialCapacity = instance->table.capacity;
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
     PARCBuffer *value = parcBuffer_WrapCString("value");
-    _PARCHashMapEntry *entry = _parcHashMapEntry_Create(key, value);
-    for (size_t i = 0; i < CAPACITY; ++i) {
-        parcLinkedList_Append(instance->buckets[i], entry);
-        ++instance->size;
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        parcBuffer_PutUint32(key, i);
+        parcHashMap_Put(instance, parcBuffer_Flip(key), value);
     }
-    _parcHashMapEntry_Release(&entry);
     parcBuffer_Release(&key);
     parcBuffer_Release(&value);
 
+    assertTrue(instance->table.capacity == initialCapacity,
+               "Expected a map created with capacity %zd to hold that many entries without growing", CAPACITY);
+
     parcHashMap_Release(&instance);
     assertNull(instance, "Expeced null result from parcHashMap_Release();");
 }
@@ -313,6 +319,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcHashMap_KeyIterator_HasNext);
     LONGBOW_RUN_TEST_CASE(Global, parcHashMap_KeyIterator_Next);
     LONGBOW_RUN_TEST_CASE(Global, parcHashMap_KeyIterator_Remove);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_Grow);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_Grow_RemoveWhileDraining);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_Grow_IterateWhileDraining);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_Reserve);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_InitCursor);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_InitCursor_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcHashMap_InitCursor_Draining);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -695,9 +708,221 @@ LONGBOW_TEST_CASE(Global, parcHashMap_KeyIterator_Remove)
     parcHashMap_Release(&instance);
 }
 
+static PARCBuffer *
+_uint32Key(PARCBuffer *key, uint32_t i)
+{
+    parcBuffer_SetPosition(key, 0);
+    parcBuffer_PutUint32(key, i);
+    return parcBuffer_Flip(key);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_Grow)
+{
+    const uint32_t count = 5000;
+    PARCHashMap *instance = parcHashMap_CreateCapacity(1);
+    size_t initialCapacity = instance->table.capacity;
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+    for (uint32_t i = 0; i < count; i++) {
+        parcHashMap_Put(instance, _uint32Key(key, i), value);
+    }
+
+    assertTrue(parcHashMap_Size(instance) == count, "Expected %u, actual %zd", count, parcHashMap_Size(instance));
+    assertTrue(instance->table.capacity > initialCapacity, "Expected the map to grow");
+    assertTrue(parcHashMap_IsValid(instance), "Expected a valid PARCHashMap");
+
+    for (uint32_t i = 0; i < count; i++) {
+        assertTrue(parcHashMap_Get(instance, _uint32Key(key, i)) == value, "Expected to find key %u", i);
+    }
+    assertNull(parcHashMap_Get(instance, _uint32Key(key, count)), "Expected not to find key %u", count);
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_Grow_RemoveWhileDraining)
+{
+    const uint32_t count = 3000;
+    PARCHashMap *instance = parcHashMap_CreateCapacity(1);
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+    for (uint32_t i = 0; i < count; i++) {
+        parcHashMap_Put(instance, _uint32Key(key, i), value);
+        // Remove every third key as soon as possible, which often finds it still in the draining table.
+        if (i % 3 == 0) {
+            assertTrue(parcHashMap_Remove(instance, _uint32Key(key, i)), "Expected to remove key %u", i);
+        }
+    }
+    assertTrue(parcHashMap_IsValid(instance), "Expected a valid PARCHashMap");
+
+    for (uint32_t i = 0; i < count; i++) {
+        const PARCObject *actual = parcHashMap_Get(instance, _uint32Key(key, i));
+        if (i % 3 == 0) {
+            assertNull(actual, "Expected key %u to be removed", i);
+        } else {
+            assertTrue(actual == value, "Expected to find key %u", i);
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        parcHashMap_Remove(instance, _uint32Key(key, i));
+    }
+    assertTrue(parcHashMap_Size(instance) == 0, "Expected 0, actual %zd", parcHashMap_Size(instance));
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_Grow_IterateWhileDraining)
+{
+    PARCHashMap *instance = parcHashMap_CreateCapacity(100);
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+
+    // Fill the map until an incremental resize is in progress.
+    uint32_t count = 0;
+    while (_parcHashMap_IsDraining(instance) == false) {
+        parcHashMap_Put(instance, _uint32Key(key, count++), value);
+    }
+    parcHashMap_Put(instance, _uint32Key(key, count++), value);
+    assertTrue(_parcHashMap_IsDraining(instance), "Expected the map to be resizing");
+
+    size_t visited = 0;
+    PARCIterator *iterator = parcHashMap_CreateKeyIterator(instance);
+    while (parcIterator_HasNext(iterator)) {
+        PARCBuffer *actual = parcIterator_Next(iterator);
+        assertTrue(parcHashMap_Get(instance, actual) == value, "Expected each iterated key to be in the map");
+        visited++;
+        if (visited % 2 == 0) {
+            parcIterator_Remove(iterator);
+        }
+    }
+    parcIterator_Release(&iterator);
+
+    assertTrue(visited == count, "Expected to visit %u keys, actual %zd", count, visited);
+    assertTrue(parcHashMap_Size(instance) == count - count / 2,
+               "Expected %u, actual %zd", count - count / 2, parcHashMap_Size(instance));
+    assertTrue(parcHashMap_IsValid(instance), "Expected a valid PARCHashMap");
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_InitCursor)
+{
+    const uint32_t count = 100;
+    PARCHashMap *instance = parcHashMap_Create();
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        PARCBuffer *value = parcBuffer_Flip(parcBuffer_PutUint32(parcBuffer_Allocate(sizeof(uint32_t)), i));
+        parcHashMap_Put(instance, _uint32Key(key, i), value);
+        parcBuffer_Release(&value);
+    }
+
+    bool seen[100] = { false };
+    PARCCursor cursor;
+    parcHashMap_InitCursor(instance, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        uint32_t actualKey = parcBuffer_GetUint32(parcCursor_GetKey(&cursor));
+        uint32_t actualValue = parcBuffer_GetUint32(parcCursor_GetValue(&cursor));
+        parcBuffer_Rewind(parcCursor_GetKey(&cursor));
+        parcBuffer_Rewind(parcCursor_GetValue(&cursor));
+
+        assertTrue(actualKey == actualValue, "Expected the value %u with its key, actual %u", actualKey, actualValue);
+        assertFalse(seen[actualKey], "Expected to visit key %u once", actualKey);
+        seen[actualKey] = true;
+    }
+    assertFalse(parcHashMap_CursorNext(&cursor), "Expected a finished cursor to stay finished");
+
+    for (uint32_t i = 0; i < count; i++) {
+        assertTrue(seen[i], "Expected to visit key %u", i);
+    }
+
+    parcBuffer_Release(&key);
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_InitCursor_Empty)
+{
+    PARCHashMap *instance = parcHashMap_Create();
+
+    PARCCursor cursor;
+    parcHashMap_InitCursor(instance, &cursor);
+    assertFalse(parcHashMap_CursorNext(&cursor), "Expected no entries in an empty map");
+
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_InitCursor_Draining)
+{
+    PARCHashMap *instance = parcHashMap_CreateCapacity(100);
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+
+    uint32_t count = 0;
+    while (_parcHashMap_IsDraining(instance) == false) {
+        parcHashMap_Put(instance, _uint32Key(key, count++), value);
+    }
+    parcHashMap_Put(instance, _uint32Key(key, count++), value);
+    assertTrue(_parcHashMap_IsDraining(instance), "Expected the map to be resizing");
+
+    size_t visited = 0;
+    PARCCursor cursor;
+    parcHashMap_InitCursor(instance, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        assertTrue(parcHashMap_Get(instance, parcCursor_GetKey(&cursor)) == value, "Expected each key to be in the map");
+        assertTrue(parcCursor_GetValue(&cursor) == value, "Expected each entry to have its value");
+        visited++;
+    }
+    assertTrue(visited == count, "Expected to visit %u keys, actual %zd", count, visited);
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcHashMap_Reserve)
+{
+    const uint32_t count = 2000;
+    PARCHashMap *instance = parcHashMap_Create();
+
+    PARCBuffer *key = parcBuffer_Allocate(sizeof(uint32_t));
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+    for (uint32_t i = 0; i < 100; i++) {
+        parcHashMap_Put(instance, _uint32Key(key, i), value);
+    }
+
+    parcHashMap_Reserve(instance, count);
+    size_t reservedCapacity = instance->table.capacity;
+    assertFalse(_parcHashMap_IsDraining(instance), "Expected parcHashMap_Reserve to complete any resize");
+
+    for (uint32_t i = 0; i < count; i++) {
+        parcHashMap_Put(instance, _uint32Key(key, i), value);
+    }
+
+    assertTrue(instance->table.capacity == reservedCapacity, "Expected no growth after parcHashMap_Reserve");
+    assertTrue(parcHashMap_Size(instance) == count, "Expected %u, actual %zd", count, parcHashMap_Size(instance));
+
+    parcHashMap_Reserve(instance, 1);
+    assertTrue(instance->table.capacity == reservedCapacity, "Expected parcHashMap_Reserve never to shrink the map");
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcHashMap_Release(&instance);
+}
+
 LONGBOW_TEST_FIXTURE(Static)
 {
-    LONGBOW_RUN_TEST_CASE(Static, parcHashMapEntry);
+    LONGBOW_RUN_TEST_CASE(Static, _parcHashMap_CapacityFor);
+    LONGBOW_RUN_TEST_CASE(Static, _parcHashMapTable_RemoveAt);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Static)
@@ -715,16 +940,265 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Static)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
-LONGBOW_TEST_CASE(Static, parcHashMapEntry)
+LONGBOW_TEST_CASE(Static, _parcHashMap_CapacityFor)
 {
-    PARCBuffer *key = parcBuffer_WrapCString("key1");
-    PARCBuffer *value = parcBuffer_WrapCString("value1");
+    for (size_t count = 0; count < 100000; count = count * 2 + 1) {
+        size_t capacity = _parcHashMap_CapacityFor(count);
+        assertTrue((capacity & (capacity - 1)) == 0, "Expected a power of 2, actual %zd", capacity);
+        assertTrue(capacity * _PARCHashMap_MaxLoadNumerator / _PARCHashMap_MaxLoadDenominator >= count,
+                   "Expected capacity %zd to hold %zd entries", capacity, count);
+    }
+}
 
-    _PARCHashMapEntry *instance = _parcHashMapEntry_Create(key, value);
-    parcBuffer_Release(&key);
-    parcBuffer_Release(&value);
+LONGBOW_TEST_CASE(Static, _parcHashMapTable_RemoveAt)
+{
+    _PARCHashMapTable table;
+    _parcHashMapTable_Init(&table, 8);
+
+    // Give every entry the same hash code so they form one probe sequence.
+    PARCBuffer *keys[5];
+    for (int i = 0; i < 5; i++) {
+        keys[i] = parcBuffer_Allocate(1);
+        _parcHashMapTable_Insert(&table, keys[i], parcBuffer_Acquire(keys[i]), 42);
+    }
+
+    size_t home = _parcHashMapTable_HomeSlot(&table, 42);
+    _parcHashMapTable_RemoveAt(&table, (home + 1) & 7);
+
+    assertTrue(table.count == 4, "Expected 4 entries, actual %zd", table.count);
+    for (uint32_t i = 0; i < 4; i++) {
+        assertTrue(table.slots[(home + i) & 7].probeLength == i + 1,
+                   "Expected the probe sequence to be shifted back without gaps");
+    }
+    assertTrue(table.slots[(home + 4) & 7].probeLength == 0, "Expected the end of the sequence to be empty");
+
+    _parcHashMapTable_ReleaseEntries(&table);
+    _parcHashMapTable_Fini(&table);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcHashMap_PutGet_OpenAddressing);
+    LONGBOW_RUN_TEST_CASE(Performance, parcHashMap_PutGet_Chained);
+    LONGBOW_RUN_TEST_CASE(Performance, parcHashMap_Iterate);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define PERFORMANCE_KEY_COUNT 1000000
+
+static PARCBuffer **
+_performanceKeys(void)
+{
+    PARCBuffer **keys = parcMemory_Allocate(PERFORMANCE_KEY_COUNT * sizeof(PARCBuffer *));
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        keys[i] = parcBuffer_Allocate(sizeof(uint32_t));
+        parcBuffer_Flip(parcBuffer_PutUint32(keys[i], i * 2654435761u));
+    }
+    return keys;
+}
+
+static void
+_performanceKeysRelease(PARCBuffer ***keysPtr)
+{
+    PARCBuffer **keys = *keysPtr;
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcBuffer_Release(&keys[i]);
+    }
+    parcMemory_Deallocate(keysPtr);
+}
+
+static void
+_performanceReport(const char *name, const char *operation, uint32_t count, struct timeval *t0, struct timeval *t1)
+{
+    struct timeval elapsed;
+    timersub(t1, t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%s %s: %u keys, sec = %.3f, nsec/op = %.1f\n", name, operation, count, sec, sec * 1E9 / count);
+}
+
+LONGBOW_TEST_CASE(Performance, parcHashMap_PutGet_OpenAddressing)
+{
+    PARCBuffer **keys = _performanceKeys();
+    PARCHashMap *map = parcHashMap_Create();
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcHashMap_Put(map, keys[i], keys[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("open addressing", "put", PERFORMANCE_KEY_COUNT, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        assertTrue(parcHashMap_Get(map, keys[i]) == keys[i], "Expected to find key %u", i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("open addressing", "get", PERFORMANCE_KEY_COUNT, &t0, &t1);
+
+    parcHashMap_Release(&map);
+    _performanceKeysRelease(&keys);
+}
+
+/*
+ * The previous PARCHashMap layout: a fixed array of PARCLinkedList buckets holding key/value entry objects.
+ */
+typedef struct {
+    PARCObject *key;
+    PARCObject *value;
+} _ChainedEntry;
+
+static void
+_chainedEntry_Finalize(_ChainedEntry **entryPtr)
+{
+    parcObject_Release(&(*entryPtr)->key);
+    parcObject_Release(&(*entryPtr)->value);
+}
+
+parcObject_ExtendPARCObject(_ChainedEntry, _chainedEntry_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
+typedef struct {
+    PARCLinkedList **buckets;
+    unsigned int capacity;
+} _ChainedMap;
+
+static _ChainedEntry *
+_chainedMap_GetEntryWithCursor(const _ChainedMap *map, const PARCObject *key)
+{
+    _ChainedEntry *result = NULL;
+
+    PARCCursor cursor;
+    parcLinkedList_InitCursor(map->buckets[parcObject_HashCode(key) % map->capacity], &cursor);
+    while (parcLinkedList_CursorNext(&cursor)) {
+        _ChainedEntry *entry = parcCursor_GetElement(&cursor);
+        if (parcObject_Equals(key, entry->key)) {
+            result = entry;
+            break;
+        }
+    }
+
+    return result;
+}
+
+static _ChainedEntry *
+_chainedMap_GetEntry(const _ChainedMap *map, const PARCObject *key)
+{
+    _ChainedEntry *result = NULL;
+
+    PARCIterator *iterator = parcLinkedList_CreateIterator(map->buckets[parcObject_HashCode(key) % map->capacity]);
+    while (parcIterator_HasNext(iterator)) {
+        _ChainedEntry *entry = parcIterator_Next(iterator);
+        if (parcObject_Equals(key, entry->key)) {
+            result = entry;
+            break;
+        }
+    }
+    parcIterator_Release(&iterator);
+
+    return result;
+}
+
+static void
+_chainedMap_Put(_ChainedMap *map, const PARCObject *key, const PARCObject *value)
+{
+    _ChainedEntry *entry = _chainedMap_GetEntry(map, key);
+    if (entry == NULL) {
+        entry = parcObject_CreateInstance(_ChainedEntry);
+        entry->key = parcObject_Copy(key);
+        entry->value = parcObject_Acquire(value);
+        parcLinkedList_Append(map->buckets[parcObject_HashCode(key) % map->capacity], entry);
+        parcObject_Release((PARCObject **) &entry);
+    }
+}
+
+LONGBOW_TEST_CASE(Performance, parcHashMap_PutGet_Chained)
+{
+    PARCBuffer **keys = _performanceKeys();
+
+    _ChainedMap map = { .capacity = DEFAULT_CAPACITY };
+    map.buckets = parcMemory_Allocate(map.capacity * sizeof(PARCLinkedList *));
+    for (unsigned int i = 0; i < map.capacity; i++) {
+        map.buckets[i] = parcLinkedList_Create();
+    }
+
+    // The chained layout never grows, so use a hundredth of the keys to keep the run time reasonable.
+    const uint32_t count = PERFORMANCE_KEY_COUNT / 100;
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        _chainedMap_Put(&map, keys[i], keys[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("chained", "put", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        assertTrue(_chainedMap_GetEntry(&map, keys[i])->value == keys[i], "Expected to find key %u", i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("chained", "get", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        assertTrue(_chainedMap_GetEntryWithCursor(&map, keys[i])->value == keys[i], "Expected to find key %u", i);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("chained", "get with cursor", count, &t0, &t1);
+
+    for (unsigned int i = 0; i < map.capacity; i++) {
+        parcLinkedList_Release(&map.buckets[i]);
+    }
+    parcMemory_Deallocate(&map.buckets);
+    _performanceKeysRelease(&keys);
+}
+
+LONGBOW_TEST_CASE(Performance, parcHashMap_Iterate)
+{
+    PARCBuffer **keys = _performanceKeys();
+    PARCHashMap *map = parcHashMap_Create();
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcHashMap_Put(map, keys[i], keys[i]);
+    }
+
+    // Visiting the keys and then getting each value is how the map displayed itself before it had cursors.
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    uint32_t count = 0;
+    PARCIterator *iterator = parcHashMap_CreateKeyIterator(map);
+    while (parcIterator_HasNext(iterator)) {
+        PARCObject *key = parcIterator_Next(iterator);
+        assertNotNull(parcHashMap_Get(map, key), "Expected each key to have a value");
+        count++;
+    }
+    parcIterator_Release(&iterator);
+    gettimeofday(&t1, NULL);
+    _performanceReport("iterator", "visit and get", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    count = 0;
+    PARCCursor cursor;
+    parcHashMap_InitCursor(map, &cursor);
+    while (parcHashMap_CursorNext(&cursor)) {
+        assertNotNull(parcCursor_GetValue(&cursor), "Expected each key to have a value");
+        count++;
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("cursor", "visit", count, &t0, &t1);
 
-    _parcHashMapEntry_Release(&instance);
+    parcHashMap_Release(&map);
+    _performanceKeysRelease(&keys);
 }
 
 int
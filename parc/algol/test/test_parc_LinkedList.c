@@ -30,6 +30,8 @@
  */
 #include "../parc_LinkedList.c"
 
+#include <sys/time.h>
+
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_StdlibMemory.h>
@@ -163,6 +165,8 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_CreateIterator_RemoveHead);
     LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_CreateIterator_RemoveMiddle);
     LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_CreateIterator_RemoveTail);
+    LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_InitCursor);
+    LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_InitCursor_Remove);
 
     LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_SetEquals_True);
     LONGBOW_RUN_TEST_CASE(Global, parcLinkedList_SetEquals_False);
@@ -866,6 +870,66 @@ LONGBOW_TEST_CASE(Global, parcLinkedList_CreateIterator)
     parcLinkedList_Release(&x);
 }
 
+LONGBOW_TEST_CASE(Global, parcLinkedList_InitCursor)
+{
+    PARCLinkedList *x = parcLinkedList_Create();
+
+    PARCCursor cursor;
+    parcLinkedList_InitCursor(x, &cursor);
+    assertFalse(parcLinkedList_CursorNext(&cursor), "Expected no elements in an empty list");
+
+    uint32_t expectedCount = 10;
+    for (uint32_t i = 0; i < expectedCount; i++) {
+        PARCBuffer *object = parcBuffer_Allocate(sizeof(int));
+        parcBuffer_PutUint32(object, i);
+        parcBuffer_Flip(object);
+        parcLinkedList_Append(x, object);
+        parcBuffer_Release(&object);
+    }
+
+    parcLinkedList_InitCursor(x, &cursor);
+    uint32_t expected = 0;
+    while (parcLinkedList_CursorNext(&cursor)) {
+        PARCBuffer *buffer = parcCursor_GetElement(&cursor);
+        uint32_t actual = parcBuffer_GetUint32(buffer);
+        assertTrue(expected == actual, "Expected %d, actual %d", expected, actual);
+        expected++;
+    }
+    assertTrue(expected == expectedCount, "Expected to visit %u elements, actual %u", expectedCount, expected);
+
+    parcLinkedList_Release(&x);
+}
+
+LONGBOW_TEST_CASE(Global, parcLinkedList_InitCursor_Remove)
+{
+    PARCLinkedList *x = parcLinkedList_Create();
+
+    for (uint32_t i = 0; i < 10; i++) {
+        PARCBuffer *object = parcBuffer_Flip(parcBuffer_PutUint32(parcBuffer_Allocate(sizeof(uint32_t)), i));
+        parcLinkedList_Append(x, object);
+        parcBuffer_Release(&object);
+    }
+
+    // Removing the element at the cursor leaves the cursor able to continue.
+    PARCCursor cursor;
+    parcLinkedList_InitCursor(x, &cursor);
+    uint32_t expected = 0;
+    while (parcLinkedList_CursorNext(&cursor)) {
+        PARCBuffer *buffer = parcCursor_GetElement(&cursor);
+        assertTrue(parcBuffer_GetUint32(buffer) == expected, "Expected %u", expected);
+        parcBuffer_Rewind(buffer);
+        if (expected % 2 == 0) {
+            parcLinkedList_Remove(x, buffer);
+        }
+        expected++;
+    }
+
+    assertTrue(expected == 10, "Expected to visit 10 elements, actual %u", expected);
+    assertTrue(parcLinkedList_Size(x) == 5, "Expected 5 elements to remain, actual %zu", parcLinkedList_Size(x));
+
+    parcLinkedList_Release(&x);
+}
+
 LONGBOW_TEST_CASE(Global, parcLinkedList_CreateIterator_Remove)
 {
     PARCLinkedList *x = parcLinkedList_Create();
@@ -1117,6 +1181,7 @@ LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
     LONGBOW_RUN_TEST_CASE(Performance, parcLinkedList_Append);
     LONGBOW_RUN_TEST_CASE(Performance, parcLinkedList_N2);
     LONGBOW_RUN_TEST_CASE(Performance, parcLinkedList_CreateIterator);
+    LONGBOW_RUN_TEST_CASE(Performance, parcLinkedList_InitCursor);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Performance)
@@ -1195,6 +1260,50 @@ LONGBOW_TEST_CASE(Performance, parcLinkedList_CreateIterator)
 }
 
 
+LONGBOW_TEST_CASE(Performance, parcLinkedList_InitCursor)
+{
+    PARCLinkedList *x = parcLinkedList_Create();
+
+    // A list that fits in the cache measures the cost of stepping rather than of missing the cache.
+    uint32_t expectedCount = 10000;
+    for (uint32_t i = 0; i < expectedCount; i++) {
+        PARCBuffer *object = parcBuffer_Allocate(sizeof(int));
+        parcBuffer_PutUint32(object, i);
+        parcBuffer_Flip(object);
+        parcLinkedList_Append(x, object);
+        parcBuffer_Release(&object);
+    }
+
+    struct timeval t0, t1, elapsed;
+    gettimeofday(&t0, NULL);
+    size_t count = 0;
+    for (int pass = 0; pass < 1000; pass++) {
+        PARCIterator *iterator = parcLinkedList_CreateIterator(x);
+        while (parcIterator_HasNext(iterator)) {
+            count += (parcIterator_Next(iterator) != NULL);
+        }
+        parcIterator_Release(&iterator);
+    }
+    gettimeofday(&t1, NULL);
+    timersub(&t1, &t0, &elapsed);
+    printf("iterator: %zu elements, nsec/element = %.2f\n", count, (elapsed.tv_sec * 1E9 + elapsed.tv_usec * 1E3) / count);
+
+    gettimeofday(&t0, NULL);
+    count = 0;
+    for (int pass = 0; pass < 1000; pass++) {
+        PARCCursor cursor;
+        parcLinkedList_InitCursor(x, &cursor);
+        while (parcLinkedList_CursorNext(&cursor)) {
+            count += (parcCursor_GetElement(&cursor) != NULL);
+        }
+    }
+    gettimeofday(&t1, NULL);
+    timersub(&t1, &t0, &elapsed);
+    printf("cursor:   %zu elements, nsec/element = %.2f\n", count, (elapsed.tv_sec * 1E9 + elapsed.tv_usec * 1E3) / count);
+
+    parcLinkedList_Release(&x);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -124,6 +124,13 @@ parcObject_ExtendPARCObject(_DummyObjectNoHash,
                             NULL,
                             _dummy_ToJSON);
 
+// Subtypes of _DummyObject that override nothing, inheriting every method through their supertypes.
+typedef _dummy_object _DummyObjectChild;
+parcObject_Override(_DummyObjectChild, _DummyObject);
+
+typedef _dummy_object _DummyObjectGrandchild;
+parcObject_Override(_DummyObjectGrandchild, _DummyObjectChild);
+
 static bool
 _meta_destructor_true(PARCObject **objPtr)
 {
@@ -234,6 +241,7 @@ LONGBOW_TEST_FIXTURE(Static)
     LONGBOW_RUN_TEST_CASE(Static, _objectHeaderIsValid_InvalidAlignment);
     LONGBOW_RUN_TEST_CASE(Static, _objectHeaderIsValid_InvalidLength);
     LONGBOW_RUN_TEST_CASE(Static, _parcObject_PrefixLength);
+    LONGBOW_RUN_TEST_CASE(Static, _parcObject_HeaderIsCompact);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Static)
@@ -309,6 +317,16 @@ LONGBOW_TEST_CASE(Static, _parcObject_PrefixLength)
     }
 }
 
+LONGBOW_TEST_CASE(Static, _parcObject_HeaderIsCompact)
+{
+    // The locking state is allocated on demand, the header only holds a pointer to it.
+    assertTrue(sizeof(_PARCObjectHeader) < sizeof(_PARCObjectLocking),
+               "Expected the header (%zu bytes) to be smaller than the locking state (%zu bytes)",
+               sizeof(_PARCObjectHeader), sizeof(_PARCObjectLocking));
+    assertTrue(_parcObject_PrefixLength(sizeof(void *)) <= 5 * sizeof(void *),
+               "Expected the object prefix to be at most 5 words, actual %zu bytes", _parcObject_PrefixLength(sizeof(void *)));
+}
+
 LONGBOW_TEST_FIXTURE(AcquireRelease)
 {
     LONGBOW_RUN_TEST_CASE(AcquireRelease, parcObject_Acquire);
@@ -908,6 +926,8 @@ LONGBOW_TEST_FIXTURE(Locking)
     LONGBOW_RUN_TEST_CASE(Locking, parcObject_TryLock_Unlock);
     LONGBOW_RUN_TEST_CASE(Locking, parcObject_TryLock_AlreadyLockedSameThread);
     LONGBOW_RUN_TEST_CASE(Locking, parcObject_Lock_Unlock);
+    LONGBOW_RUN_TEST_CASE(Locking, parcObject_Lock_AllocatesOnDemand);
+    LONGBOW_RUN_TEST_CASE(Locking, parcObject_Lock_Contended);
 }
 static uint32_t initialAllocations;
 
@@ -975,6 +995,61 @@ LONGBOW_TEST_CASE(Locking, parcObject_Lock_Unlock)
     assertFalse(actual, "Expected parcObject_IsLocked to be false.");
 }
 
+LONGBOW_TEST_CASE(Locking, parcObject_Lock_AllocatesOnDemand)
+{
+    _DummyObject *dummy = longBowTestCase_GetClipBoardData(testCase);
+    _PARCObjectHeader *header = _parcObject_Header(dummy);
+
+    assertNull(header->locking, "Expected a new object to have no locking state.");
+
+    assertFalse(parcObject_IsLocked(dummy), "Expected parcObject_IsLocked to be false.");
+    parcObject_Notify(dummy);
+    parcObject_NotifyAll(dummy);
+    assertNull(header->locking, "Expected IsLocked and Notify not to create the locking state.");
+
+    uint32_t before = parcMemory_Outstanding();
+    assertTrue(parcObject_Lock(dummy), "Expected parcObject_Lock to succeed.");
+    assertNotNull(header->locking, "Expected parcObject_Lock to create the locking state.");
+    assertTrue(parcMemory_Outstanding() == before + 1, "Expected the locking state to be one allocation.");
+
+    assertTrue(parcObject_Unlock(dummy), "Expected parcObject_Unlock to succeed.");
+}
+
+#define CONTENDED_THREADS 4
+#define CONTENDED_ITERATIONS 1000
+
+static void *
+_contendedIncrement(void *data)
+{
+    _DummyObject *dummy = data;
+
+    for (int i = 0; i < CONTENDED_ITERATIONS; i++) {
+        parcObject_Lock(dummy);
+        dummy->val++;
+        parcObject_Unlock(dummy);
+    }
+
+    return data;
+}
+
+LONGBOW_TEST_CASE(Locking, parcObject_Lock_Contended)
+{
+    _DummyObject *dummy = longBowTestCase_GetClipBoardData(testCase);
+    dummy->val = 0;
+
+    // The threads race to create the locking state of an object that has never been locked.
+    pthread_t threads[CONTENDED_THREADS];
+    for (int i = 0; i < CONTENDED_THREADS; i++) {
+        pthread_create(&threads[i], NULL, _contendedIncrement, dummy);
+    }
+    for (int i = 0; i < CONTENDED_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    assertTrue(dummy->val == CONTENDED_THREADS * CONTENDED_ITERATIONS,
+               "Expected %d, actual %d", CONTENDED_THREADS * CONTENDED_ITERATIONS, dummy->val);
+}
+
 LONGBOW_TEST_CASE_EXPECTS(Locking, parcObject_TryLock_AlreadyLockedSameThread, .event = &LongBowTrapCannotObtainLockEvent)
 {
     _DummyObject *dummy = longBowTestCase_GetClipBoardData(testCase);
@@ -1207,6 +1282,8 @@ LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
     LONGBOW_RUN_TEST_CASE(Performance, parcObject_CreateRelease);
     LONGBOW_RUN_TEST_CASE(Performance, parcObject_Create);
     LONGBOW_RUN_TEST_CASE(Performance, parcObject_AcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Performance, parcObject_CreateRelease_Rate);
+    LONGBOW_RUN_TEST_CASE(Performance, parcObject_Equals_Rate);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Performance)
@@ -1285,6 +1362,60 @@ LONGBOW_TEST_CASE(Performance, parcObject_Create)
     }
 }
 
+#define SMALL_OBJECT_SIZE 16
+
+LONGBOW_TEST_CASE(Performance, parcObject_CreateRelease_Rate)
+{
+    struct timeval t0, t1, elapsed;
+
+    gettimeofday(&t0, NULL);
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        PARCObject *object = parcObject_CreateInstanceImpl(SMALL_OBJECT_SIZE, &PARCObject_Descriptor);
+        parcObject_Release(&object);
+    }
+    gettimeofday(&t1, NULL);
+
+    timersub(&t1, &t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("header = %zu bytes, prefix = %zu bytes, %d objects of %d bytes, sec = %.3f, objects/sec = %.0f\n",
+           sizeof(_PARCObjectHeader), _parcObject_PrefixLength(sizeof(void *)),
+           OBJECT_COUNT, SMALL_OBJECT_SIZE, sec, OBJECT_COUNT / sec);
+}
+
+#define EQUALS_COUNT 20000000
+
+static void
+_parcObject_MeasureEquals(const char *name, const PARCObject *x, const PARCObject *y)
+{
+    struct timeval t0, t1, elapsed;
+    size_t equal = 0;
+
+    gettimeofday(&t0, NULL);
+    for (int i = 0; i < EQUALS_COUNT; i++) {
+        equal += parcObject_Equals(x, y);
+    }
+    gettimeofday(&t1, NULL);
+
+    timersub(&t1, &t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%-24s %d calls, sec = %.3f, calls/sec = %.0f (%zd equal)\n", name, EQUALS_COUNT, sec, EQUALS_COUNT / sec, equal);
+}
+
+LONGBOW_TEST_CASE(Performance, parcObject_Equals_Rate)
+{
+    _DummyObject *x = parcObject_CreateAndClearInstance(_DummyObject);
+    _DummyObject *y = parcObject_CreateAndClearInstance(_DummyObject);
+    _parcObject_MeasureEquals("_DummyObject", x, y);
+    parcObject_Release((PARCObject **) &x);
+    parcObject_Release((PARCObject **) &y);
+
+    _DummyObjectGrandchild *gx = parcObject_CreateAndClearInstance(_DummyObjectGrandchild);
+    _DummyObjectGrandchild *gy = parcObject_CreateAndClearInstance(_DummyObjectGrandchild);
+    _parcObject_MeasureEquals("_DummyObjectGrandchild", gx, gy);
+    parcObject_Release((PARCObject **) &gx);
+    parcObject_Release((PARCObject **) &gy);
+}
+
 LONGBOW_TEST_FIXTURE(Meta)
 {
     LONGBOW_RUN_TEST_CASE(Meta, _metaDestructor_True);
@@ -1292,6 +1423,9 @@ LONGBOW_TEST_FIXTURE(Meta)
     LONGBOW_RUN_TEST_CASE(Meta, _metaDestructor_None);
 
     LONGBOW_RUN_TEST_CASE(Meta, parcObjectDescriptor_Create);
+    LONGBOW_RUN_TEST_CASE(Meta, parcObjectDescriptor_MethodTable);
+    LONGBOW_RUN_TEST_CASE(Meta, parcObjectDescriptor_MethodTable_Created);
+    LONGBOW_RUN_TEST_CASE(Meta, parcObjectDescriptor_MethodTable_None);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Meta)
@@ -1329,6 +1463,62 @@ LONGBOW_TEST_CASE(Meta, parcObjectDescriptor_Create)
     assertNull(interface, "Expected parcObjectDescriptor_Destroy to NULL the input pointer");
 }
 
+LONGBOW_TEST_CASE(Meta, parcObjectDescriptor_MethodTable)
+{
+    const PARCObjectDescriptor *descriptor = &parcObject_DescriptorName(_DummyObjectGrandchild);
+
+    _DummyObjectGrandchild *x = parcObject_CreateAndClearInstance(_DummyObjectGrandchild);
+    _DummyObjectGrandchild *y = parcObject_CreateAndClearInstance(_DummyObjectGrandchild);
+
+    assertTrue(descriptor->methods->resolved, "Expected the method table to be resolved when an instance is created.");
+    assertTrue(parcObject_Equals(x, y), "Expected the inherited equals function to be called.");
+    assertTrue(descriptor->methods->equals == parcObject_DescriptorName(_DummyObject).equals,
+               "Expected the equals function of the nearest supertype that defines one.");
+    assertTrue(descriptor->methods->hashCode == parcObject_DescriptorName(_DummyObject).hashCode,
+               "Expected the hashCode function of the nearest supertype that defines one.");
+    assertTrue(descriptor->methods->display == parcObject_DescriptorName(PARCObject).display,
+               "Expected the display function of PARCObject.");
+
+    parcObject_Release((PARCObject **) &x);
+    parcObject_Release((PARCObject **) &y);
+}
+
+LONGBOW_TEST_CASE(Meta, parcObjectDescriptor_MethodTable_Created)
+{
+    PARCObjectDescriptor *descriptor =
+        parcObjectDescriptor_Create("Meta", NULL, NULL, NULL, NULL, _meta_equals, NULL, NULL, NULL, NULL,
+                                    (PARCObjectDescriptor *) &parcObject_DescriptorName(_DummyObject));
+
+    _DummyObject *x = parcObject_CreateAndClearInstanceImpl(sizeof(_DummyObject), descriptor);
+    _DummyObject *y = parcObject_CreateAndClearInstanceImpl(sizeof(_DummyObject), descriptor);
+    y->calledCount = 1;
+
+    assertTrue(parcObject_Equals(x, y), "Expected the overriding equals function to compare only the val field.");
+    assertTrue(descriptor->methods->equals == _meta_equals, "Expected the descriptor's own equals function.");
+    assertTrue(descriptor->methods->compare == parcObject_DescriptorName(_DummyObject).compare,
+               "Expected the inherited compare function.");
+
+    parcObject_Release((PARCObject **) &x);
+    parcObject_Release((PARCObject **) &y);
+    parcObjectDescriptor_Destroy(&descriptor);
+}
+
+LONGBOW_TEST_CASE(Meta, parcObjectDescriptor_MethodTable_None)
+{
+    // A descriptor constructed by hand may have no method table, in which case the methods are resolved on every call.
+    PARCObjectDescriptor descriptor = parcObject_DescriptorName(_DummyObjectChild);
+    descriptor.methods = NULL;
+
+    _DummyObject *x = parcObject_CreateAndClearInstanceImpl(sizeof(_DummyObject), &descriptor);
+    _DummyObject *y = parcObject_CreateAndClearInstanceImpl(sizeof(_DummyObject), &descriptor);
+
+    assertTrue(parcObject_Equals(x, y), "Expected the inherited equals function to be called.");
+    assertTrue(parcObject_HashCode(x) == 1337, "Expected the inherited hashCode function to be called.");
+
+    parcObject_Release((PARCObject **) &x);
+    parcObject_Release((PARCObject **) &y);
+}
+
 LONGBOW_TEST_CASE(Meta, _metaDestructor_True)
 {
     PARCObjectDescriptor *interface =
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+
+#include "../parc_ObjectArena.c"
+
+#include <sys/time.h>
+#include <inttypes.h>
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/testing/parc_ObjectTesting.h>
+#include <parc/testing/parc_MemoryTesting.h>
+
+LONGBOW_TEST_RUNNER(test_parc_ObjectArena)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(test_parc_ObjectArena)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(test_parc_ObjectArena)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(CreateAcquireRelease)
+{
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateRelease);
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateCapacity);
+}
+
+static uint32_t _createAcquireRelease_outstanding;
+
+LONGBOW_TEST_FIXTURE_SETUP(CreateAcquireRelease)
+{
+    _createAcquireRelease_outstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(CreateAcquireRelease)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(_createAcquireRelease_outstanding, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateRelease)
+{
+    PARCObjectArena *instance = parcObjectArena_Create();
+    assertNotNull(instance, "Expected non-null result from parcObjectArena_Create();");
+
+    parcObjectTesting_AssertAcquireReleaseContract(parcObjectArena_Acquire, instance);
+
+    parcObjectArena_Release(&instance);
+    assertNull(instance, "Expected null result from parcObjectArena_Release();");
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateCapacity)
+{
+    PARCObjectArena *instance = parcObjectArena_CreateCapacity(1);
+    parcObjectArena_AssertValid(instance);
+    assertTrue(instance->blockSize == _PARCObjectArena_MinimumBlockSize,
+               "Expected the minimum block size %d, actual %zd", _PARCObjectArena_MinimumBlockSize, instance->blockSize);
+    assertTrue(parcObjectArena_Size(instance) == 0, "Expected a new arena to be empty.");
+
+    parcObjectArena_Release(&instance);
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_IsValid);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_SetCurrent);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Allocate);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Allocate_Large);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Release_Finalizes);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Release_AfterObjectRelease);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Release_Nested);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_Lock);
+    LONGBOW_RUN_TEST_CASE(Global, parcObjectArena_JSON);
+}
+
+static uint32_t _global_outstanding;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    _global_outstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(_global_outstanding, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+typedef struct {
+    int *finalized;
+} _TestObject;
+
+static bool
+_testObject_Destructor(_TestObject **instancePtr)
+{
+    (*(*instancePtr)->finalized)++;
+    return true;
+}
+
+parcObject_Override(_TestObject, PARCObject,
+                    .destructor = (PARCObjectDestructor *) _testObject_Destructor);
+
+typedef struct {
+    int value;
+} _PlainObject;
+
+parcObject_ExtendPARCObject(_PlainObject, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static _TestObject *
+_testObject_Create(int *finalized)
+{
+    _TestObject *result = parcObject_CreateInstance(_TestObject);
+    result->finalized = finalized;
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_IsValid)
+{
+    PARCObjectArena *instance = parcObjectArena_Create();
+    assertTrue(parcObjectArena_IsValid(instance), "Expected parcObjectArena_Create to result in a valid instance.");
+
+    parcObjectArena_Release(&instance);
+    assertFalse(parcObjectArena_IsValid(instance), "Expected parcObjectArena_Release to result in an invalid instance.");
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_SetCurrent)
+{
+    PARCObjectArena *outer = parcObjectArena_Create();
+    PARCObjectArena *inner = parcObjectArena_Create();
+
+    assertNull(parcObjectArena_GetCurrent(), "Expected no current arena.");
+
+    assertNull(parcObjectArena_SetCurrent(outer), "Expected no previous arena.");
+    assertTrue(parcObjectArena_GetCurrent() == outer, "Expected the outer arena to be current.");
+
+    // An arena created while another is current is not allocated from it.
+    PARCObjectArena *nested = parcObjectArena_Create();
+    assertTrue(parcObjectArena_Size(outer) == 0, "Expected an arena not to be allocated from the current arena.");
+    assertTrue(parcObjectArena_GetCurrent() == outer, "Expected parcObjectArena_Create to leave the current arena unchanged.");
+
+    assertTrue(parcObjectArena_SetCurrent(inner) == outer, "Expected the previous arena to be the outer arena.");
+    assertTrue(parcObjectArena_SetCurrent(outer) == inner, "Expected the previous arena to be the inner arena.");
+    assertTrue(parcObjectArena_SetCurrent(NULL) == outer, "Expected the previous arena to be the outer arena.");
+
+    parcObjectArena_Release(&nested);
+    parcObjectArena_Release(&inner);
+    parcObjectArena_Release(&outer);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Allocate)
+{
+    PARCObjectArena *arena = parcObjectArena_CreateCapacity(_PARCObjectArena_MinimumBlockSize);
+    uint32_t outstanding = parcMemory_Outstanding();
+
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    PARCObject *objects[100];
+    for (int i = 0; i < 100; i++) {
+        objects[i] = parcObject_CreateAndClearInstance(_PlainObject);
+        assertTrue(((uintptr_t) objects[i] & (sizeof(void *) - 1)) == 0, "Expected object %d to be aligned, actual %p", i, objects[i]);
+    }
+    parcObjectArena_SetCurrent(previous);
+
+    assertTrue(parcObjectArena_Size(arena) == 100, "Expected 100 objects, actual %zd", parcObjectArena_Size(arena));
+
+    // One hundred small objects fit in a handful of blocks.
+    uint32_t blocks = parcMemory_Outstanding() - outstanding;
+    assertTrue(blocks > 0 && blocks < 100, "Expected a few blocks for 100 objects, actual %u", blocks);
+
+    for (int i = 0; i < 100; i++) {
+        parcObject_AssertValid(objects[i]);
+        parcObject_Release(&objects[i]);
+    }
+
+    parcObjectArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Allocate_Large)
+{
+    PARCObjectArena *arena = parcObjectArena_CreateCapacity(_PARCObjectArena_MinimumBlockSize);
+
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    PARCObject *small = parcObject_CreateAndClearInstance(_PlainObject);
+    char *first = arena->next;
+    PARCBuffer *large = parcBuffer_Allocate(_PARCObjectArena_MinimumBlockSize);
+    parcObjectArena_SetCurrent(previous);
+
+    // The large allocation is not taken from the current block.
+    assertTrue(arena->next - first < _PARCObjectArena_MinimumBlockSize / 4,
+               "Expected the current block to be retained.");
+
+    parcBuffer_PutUint8(large, 1);
+    parcObject_Release(&small);
+    parcBuffer_Release(&large);
+
+    parcObjectArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Release_Finalizes)
+{
+    int finalized = 0;
+
+    PARCObjectArena *arena = parcObjectArena_Create();
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    for (int i = 0; i < 10; i++) {
+        _testObject_Create(&finalized);
+    }
+    parcObjectArena_SetCurrent(previous);
+
+    assertTrue(finalized == 0, "Expected no objects to be finalized, actual %d", finalized);
+
+    parcObjectArena_Release(&arena);
+    assertTrue(finalized == 10, "Expected 10 objects to be finalized, actual %d", finalized);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Release_AfterObjectRelease)
+{
+    int finalized = 0;
+
+    PARCObjectArena *arena = parcObjectArena_Create();
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    _TestObject *object = _testObject_Create(&finalized);
+    parcObjectArena_SetCurrent(previous);
+
+    _TestObject *reference = parcObject_Acquire(object);
+    parcObject_Release((PARCObject **) &reference);
+    assertTrue(finalized == 0, "Expected the object not to be finalized, actual %d", finalized);
+    parcObject_Release((PARCObject **) &object);
+    assertTrue(finalized == 1, "Expected the object to be finalized once, actual %d", finalized);
+
+    parcObjectArena_Release(&arena);
+    assertTrue(finalized == 1, "Expected the object to be finalized once, actual %d", finalized);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Release_Nested)
+{
+    PARCObjectArena *arena = parcObjectArena_Create();
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+
+    // Each PARCBuffer refers to a PARCByteArray, and both refer to memory that is not in the arena.
+    PARCBuffer *released = parcBuffer_WrapCString("released");
+    PARCBuffer *live = parcBuffer_WrapCString("live");
+    PARCBuffer *slice = parcBuffer_Slice(live);
+    parcObjectArena_SetCurrent(previous);
+
+    assertTrue(parcBuffer_Equals(slice, live), "Expected the slice to equal the buffer it was taken from");
+    assertTrue(parcObjectArena_Size(arena) >= 5, "Expected at least 5 objects, actual %zd", parcObjectArena_Size(arena));
+
+    parcBuffer_Release(&released);
+
+    // The live buffer and its slice are finalized, along with the array they share, when the arena is released.
+    parcObjectArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_Lock)
+{
+    PARCObjectArena *arena = parcObjectArena_Create();
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    PARCObject *locked = parcObject_CreateAndClearInstance(_PlainObject);
+    PARCObject *live = parcObject_CreateAndClearInstance(_PlainObject);
+    parcObjectArena_SetCurrent(previous);
+
+    assertTrue(parcObject_Lock(locked), "Expected to lock an object allocated from an arena.");
+    parcObject_Unlock(locked);
+    parcObject_Release(&locked);
+
+    // The locking state of a live object is freed when the arena is released.
+    assertTrue(parcObject_Lock(live), "Expected to lock an object allocated from an arena.");
+    parcObject_Unlock(live);
+
+    parcObjectArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, parcObjectArena_JSON)
+{
+    const char *string = "{ \"string\" : \"foo\", \"array\" : [ 1, 2, 3 ], \"object\" : { \"null\" : null, \"true\" : true } }";
+
+    PARCJSON *expected = parcJSON_ParseString(string);
+
+    PARCObjectArena *arena = parcObjectArena_Create();
+    PARCObjectArena *previous = parcObjectArena_SetCurrent(arena);
+    PARCJSON *actual = parcJSON_ParseString(string);
+    parcObjectArena_SetCurrent(previous);
+
+    assertTrue(parcJSON_Equals(expected, actual), "Expected a JSON object parsed in an arena to be equal to one parsed outside.");
+
+    parcJSON_Release(&actual);
+    parcJSON_Release(&expected);
+    parcObjectArena_Release(&arena);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcJSON_ParseString_Rate);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define PARSE_COUNT 100000
+#define PARSE_PER_ARENA 100
+
+static const char *_performanceJSON =
+    "{ \"name\" : \"/parc/algol/arena\", \"lifetime\" : 4000, \"flags\" : [ true, false, null ], "
+    "\"links\" : [ { \"name\" : \"a\", \"cost\" : 1 }, { \"name\" : \"b\", \"cost\" : 2 }, { \"name\" : \"c\", \"cost\" : 3 } ] }";
+
+static uint64_t
+_parseRate(bool useArena, bool releaseEach)
+{
+    struct timeval start;
+    gettimeofday(&start, NULL);
+
+    for (int i = 0; i < PARSE_COUNT / PARSE_PER_ARENA; i++) {
+        PARCObjectArena *arena = NULL;
+        PARCObjectArena *previous = NULL;
+        if (useArena) {
+            arena = parcObjectArena_Create();
+            previous = parcObjectArena_SetCurrent(arena);
+        }
+        for (int j = 0; j < PARSE_PER_ARENA; j++) {
+            PARCJSON *json = parcJSON_ParseString(_performanceJSON);
+            if (releaseEach) {
+                parcJSON_Release(&json);
+            }
+        }
+        if (useArena) {
+            parcObjectArena_SetCurrent(previous);
+            parcObjectArena_Release(&arena);
+        }
+    }
+
+    struct timeval end;
+    gettimeofday(&end, NULL);
+    timersub(&end, &start, &end);
+
+    uint64_t usec = end.tv_sec * 1000000 + end.tv_usec;
+    return (uint64_t) PARSE_COUNT * 1000000 / (usec == 0 ? 1 : usec);
+}
+
+LONGBOW_TEST_CASE(Performance, parcJSON_ParseString_Rate)
+{
+    printf("parcJSON_ParseString %" PRIu64 " parses/sec\n", _parseRate(false, true));
+    printf("parcJSON_ParseString in a PARCObjectArena %" PRIu64 " parses/sec\n", _parseRate(true, true));
+    printf("parcJSON_ParseString in a PARCObjectArena, released with the arena %" PRIu64 " parses/sec\n", _parseRate(true, false));
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_parc_ObjectArena);
+    int exitStatus = LONGBOW_TEST_MAIN(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
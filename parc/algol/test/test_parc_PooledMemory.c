@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+
+#include "../parc_PooledMemory.c"
+
+#include <sys/time.h>
+#include <inttypes.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Buffer.h>
+
+LONGBOW_TEST_RUNNER(test_parc_PooledMemory)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Threads);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(test_parc_PooledMemory)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(test_parc_PooledMemory)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Allocate);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Allocate_Reuse);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Allocate_Large);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_AllocateAndClear);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_MemAlign);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_MemAlign_BadAlignment);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_MemAlign_BadSize);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Reallocate);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Reallocate_NULL);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_StringDuplicate);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_Deallocate_Overflow);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_FlushTrim);
+    LONGBOW_RUN_TEST_CASE(Global, parcPooledMemory_PARCObject);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstanding = parcPooledMemory_Outstanding();
+    if (outstanding != 0) {
+        printf("%s leaks %u allocations.\n", longBowTestCase_GetFullName(testCase), outstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    parcPooledMemory_Flush();
+    parcPooledMemory_Trim();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static void
+_test_SetMemory(unsigned char *memory, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        memory[i] = i;
+    }
+}
+
+static void
+_test_CheckMemory(unsigned char *memory, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        assertTrue(memory[i] == (i % 256), "memory failed to check at index %zd", i);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Allocate)
+{
+    for (size_t size = 1; size <= PARCPooledMemory_MaximumCachedSize; size++) {
+        unsigned char *result = parcPooledMemory_Allocate(size);
+        assertNotNull(result, "parcPooledMemory_Allocate failed: NULL result.");
+        assertTrue(((uintptr_t) result & (_PARCPooledMemory_Quantum - 1)) == 0,
+                   "Expected %d byte alignment, actual %p", _PARCPooledMemory_Quantum, (void *) result);
+        _test_SetMemory(result, size);
+        _test_CheckMemory(result, size);
+        assertTrue(parcPooledMemory_Outstanding() == 1,
+                   "Expected 1 outstanding allocation, actual %d", parcPooledMemory_Outstanding());
+        parcPooledMemory_Deallocate((void **) &result);
+        assertNull(result, "Expected parcPooledMemory_Deallocate to set the pointer to NULL");
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Allocate_Reuse)
+{
+    PARCPooledMemoryStatistics before;
+    PARCPooledMemoryStatistics after;
+
+    void *first = parcPooledMemory_Allocate(100);
+    void *expected = first;
+    parcPooledMemory_Deallocate(&first);
+
+    parcPooledMemory_GetStatistics(&before);
+    assertTrue(before.bytesCached > 0, "Expected the released block to be cached");
+
+    // Any size in the same class is satisfied by the cached block.
+    void *second = parcPooledMemory_Allocate(97);
+    parcPooledMemory_GetStatistics(&after);
+
+    assertTrue(second == expected, "Expected the cached block %p to be reused, actual %p", expected, second);
+    assertTrue(after.hits == before.hits + 1, "Expected 1 more hit, actual %" PRIu64, after.hits - before.hits);
+    assertTrue(after.misses == before.misses, "Expected no more misses, actual %" PRIu64, after.misses - before.misses);
+
+    parcPooledMemory_Deallocate(&second);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Allocate_Large)
+{
+    PARCPooledMemoryStatistics before;
+    PARCPooledMemoryStatistics after;
+    size_t size = PARCPooledMemory_MaximumCachedSize + 1;
+
+    parcPooledMemory_GetStatistics(&before);
+    unsigned char *result = parcPooledMemory_Allocate(size);
+    _test_SetMemory(result, size);
+    _test_CheckMemory(result, size);
+    parcPooledMemory_Deallocate((void **) &result);
+    parcPooledMemory_GetStatistics(&after);
+
+    assertTrue(after.bytesCached == before.bytesCached, "Expected a large allocation not to be cached");
+    assertTrue(after.misses == before.misses + 1, "Expected 1 more miss, actual %" PRIu64, after.misses - before.misses);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_AllocateAndClear)
+{
+    size_t size = 300;
+
+    // Leave a dirty block in the cache.
+    unsigned char *dirty = parcPooledMemory_Allocate(size);
+    memset(dirty, 0xff, size);
+    parcPooledMemory_Deallocate((void **) &dirty);
+
+    unsigned char *result = parcPooledMemory_AllocateAndClear(size);
+    assertNotNull(result, "parcPooledMemory_AllocateAndClear failed: NULL result.");
+
+    for (size_t i = 0; i < size; i++) {
+        assertTrue(result[i] == 0, "parcPooledMemory_AllocateAndClear failed to zero memory at index %zd", i);
+    }
+    parcPooledMemory_Deallocate((void **) &result);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_MemAlign)
+{
+    size_t alignments[] = { sizeof(void *), 16, 64, 4096 };
+
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++) {
+        void *result;
+        int failure = parcPooledMemory_MemAlign(&result, alignments[i], 100);
+        assertTrue(failure == 0, "parcPooledMemory_MemAlign failed with %d", failure);
+        assertTrue(((uintptr_t) result & (alignments[i] - 1)) == 0,
+                   "Expected %zd byte alignment, actual %p", alignments[i], result);
+        _test_SetMemory(result, 100);
+        _test_CheckMemory(result, 100);
+        parcPooledMemory_Deallocate(&result);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_MemAlign_BadAlignment)
+{
+    void *result;
+
+    int failure = parcPooledMemory_MemAlign(&result, 3, 100);
+    assertTrue(failure == EINVAL, "parcPooledMemory_MemAlign failed to report bad aligment specification");
+    assertTrue(parcPooledMemory_Outstanding() == 0,
+               "Expected 0 outstanding allocations, actual %d", parcPooledMemory_Outstanding());
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_MemAlign_BadSize)
+{
+    void *result;
+
+    int failure = parcPooledMemory_MemAlign(&result, sizeof(void *), 0);
+    assertTrue(failure == EINVAL, "parcPooledMemory_MemAlign failed to report bad size specification");
+    assertTrue(parcPooledMemory_Outstanding() == 0,
+               "Expected 0 outstanding allocations, actual %d", parcPooledMemory_Outstanding());
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Reallocate)
+{
+    size_t size = 40;
+
+    unsigned char *result = parcPooledMemory_Allocate(size);
+    _test_SetMemory(result, size);
+
+    // Within the same size class.
+    unsigned char *same = parcPooledMemory_Reallocate(result, 48);
+    assertTrue(same == result, "Expected a reallocation within the size class to keep the block");
+
+    // Into a larger class, then into an uncached block, then back down.
+    result = parcPooledMemory_Reallocate(same, 200);
+    _test_CheckMemory(result, size);
+    _test_SetMemory(result, 200);
+    result = parcPooledMemory_Reallocate(result, 2000);
+    _test_CheckMemory(result, 200);
+    result = parcPooledMemory_Reallocate(result, 20);
+    _test_CheckMemory(result, 20);
+
+    assertTrue(parcPooledMemory_Outstanding() == 1,
+               "Expected 1 outstanding allocation, actual %d", parcPooledMemory_Outstanding());
+    parcPooledMemory_Deallocate((void **) &result);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Reallocate_NULL)
+{
+    unsigned char *result = parcPooledMemory_Reallocate(NULL, 100);
+    _test_SetMemory(result, 100);
+    _test_CheckMemory(result, 100);
+
+    assertTrue(parcPooledMemory_Outstanding() == 1,
+               "Expected 1 outstanding allocation, actual %d", parcPooledMemory_Outstanding());
+    parcPooledMemory_Deallocate((void **) &result);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_StringDuplicate)
+{
+    char *expected = "Hello World";
+    char *actual = parcPooledMemory_StringDuplicate(expected, strlen(expected));
+
+    assertTrue(expected != actual, "Expected a distinct pointer unequal to the original string");
+    assertTrue(strcmp(expected, actual) == 0, "Expected strings to be equal. '%s' vs '%s'", expected, actual);
+
+    parcPooledMemory_Deallocate((void **) &actual);
+
+    actual = parcPooledMemory_StringDuplicate(expected, 5);
+    assertTrue(strcmp("Hello", actual) == 0, "Expected 'Hello', actual '%s'", actual);
+    parcPooledMemory_Deallocate((void **) &actual);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_Deallocate_Overflow)
+{
+    // Release more blocks of one size than the thread's magazines hold, so whole magazines move to the depot.
+    size_t count = _PARCPooledMemory_MagazineCapacity * 5;
+    void **blocks = parcStdlibMemory_Allocate(count * sizeof(void *));
+
+    for (size_t i = 0; i < count; i++) {
+        blocks[i] = parcPooledMemory_Allocate(64);
+    }
+    for (size_t i = 0; i < count; i++) {
+        parcPooledMemory_Deallocate(&blocks[i]);
+    }
+
+    PARCPooledMemoryStatistics before;
+    PARCPooledMemoryStatistics after;
+    parcPooledMemory_GetStatistics(&before);
+    assertTrue(before.bytesCached >= count * _parcPooledMemory_BlockSize(_parcPooledMemory_SizeClass(64)),
+               "Expected all %zd blocks to be cached, actual %zd bytes", count, before.bytesCached);
+
+    for (size_t i = 0; i < count; i++) {
+        blocks[i] = parcPooledMemory_Allocate(64);
+    }
+    parcPooledMemory_GetStatistics(&after);
+    assertTrue(after.hits == before.hits + count,
+               "Expected %zd more hits, actual %" PRIu64, count, after.hits - before.hits);
+
+    for (size_t i = 0; i < count; i++) {
+        parcPooledMemory_Deallocate(&blocks[i]);
+    }
+    parcStdlibMemory_Deallocate((void **) &blocks);
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_FlushTrim)
+{
+    uint32_t stdlibOutstanding = parcStdlibMemory_Outstanding();
+
+    void *memory = parcPooledMemory_Allocate(200);
+    parcPooledMemory_Deallocate(&memory);
+
+    PARCPooledMemoryStatistics statistics;
+    parcPooledMemory_GetStatistics(&statistics);
+    assertTrue(statistics.bytesCached > 0, "Expected the released block to be cached");
+
+    parcPooledMemory_Flush();
+    parcPooledMemory_GetStatistics(&statistics);
+    assertTrue(statistics.bytesCached > 0, "Expected the flushed block to be cached in the depot");
+
+    parcPooledMemory_Trim();
+    parcPooledMemory_GetStatistics(&statistics);
+    assertTrue(statistics.bytesCached == 0, "Expected nothing cached, actual %zd bytes", statistics.bytesCached);
+    assertTrue(parcStdlibMemory_Outstanding() <= stdlibOutstanding,
+               "Expected the underlying allocations to be released, actual %u", parcStdlibMemory_Outstanding());
+}
+
+LONGBOW_TEST_CASE(Global, parcPooledMemory_PARCObject)
+{
+    const PARCMemoryInterface *previous = parcMemory_SetInterface(&PARCPooledMemoryAsPARCMemory);
+
+    PARCBuffer *buffer = parcBuffer_Allocate(10);
+    PARCObject *expected = buffer;
+    parcBuffer_Release(&buffer);
+
+    PARCPooledMemoryStatistics before;
+    PARCPooledMemoryStatistics after;
+    parcPooledMemory_GetStatistics(&before);
+
+    buffer = parcBuffer_Allocate(10);
+    parcPooledMemory_GetStatistics(&after);
+
+    assertTrue((PARCObject *) buffer == expected, "Expected the released object's memory to be reused");
+    assertTrue(after.misses == before.misses, "Expected no misses, actual %" PRIu64, after.misses - before.misses);
+
+    parcBuffer_Release(&buffer);
+    parcMemory_SetInterface(previous);
+}
+
+LONGBOW_TEST_FIXTURE(Threads)
+{
+    LONGBOW_RUN_TEST_CASE(Threads, parcPooledMemory_CrossThreadDeallocate);
+    LONGBOW_RUN_TEST_CASE(Threads, parcPooledMemory_ThreadExit);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Threads)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Threads)
+{
+    uint32_t outstanding = parcPooledMemory_Outstanding();
+    if (outstanding != 0) {
+        printf("%s leaks %u allocations.\n", longBowTestCase_GetFullName(testCase), outstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define THREAD_BLOCK_COUNT 1000
+
+static void *
+_allocateBlocks(void *data)
+{
+    void **blocks = data;
+    for (int i = 0; i < THREAD_BLOCK_COUNT; i++) {
+        blocks[i] = parcPooledMemory_Allocate(1 + (i % PARCPooledMemory_MaximumCachedSize));
+        memset(blocks[i], i, 1 + (i % PARCPooledMemory_MaximumCachedSize));
+    }
+    return NULL;
+}
+
+static void *
+_deallocateBlocks(void *data)
+{
+    void **blocks = data;
+    for (int i = 0; i < THREAD_BLOCK_COUNT; i++) {
+        parcPooledMemory_Deallocate(&blocks[i]);
+    }
+    return NULL;
+}
+
+static void *
+_allocateAndDeallocateBlocks(void *data)
+{
+    _allocateBlocks(data);
+    _deallocateBlocks(data);
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Threads, parcPooledMemory_CrossThreadDeallocate)
+{
+    void *blocks[THREAD_BLOCK_COUNT];
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, _allocateBlocks, blocks);
+    pthread_join(thread, NULL);
+
+    assertTrue(parcPooledMemory_Outstanding() == THREAD_BLOCK_COUNT,
+               "Expected %d outstanding allocations, actual %u", THREAD_BLOCK_COUNT, parcPooledMemory_Outstanding());
+
+    pthread_create(&thread, NULL, _deallocateBlocks, blocks);
+    pthread_join(thread, NULL);
+
+    // The blocks released by the second thread are available to this one.
+    PARCPooledMemoryStatistics before;
+    PARCPooledMemoryStatistics after;
+    parcPooledMemory_GetStatistics(&before);
+    void *memory = parcPooledMemory_Allocate(100);
+    parcPooledMemory_GetStatistics(&after);
+    assertTrue(after.hits == before.hits + 1, "Expected the depot to supply a block");
+    parcPooledMemory_Deallocate(&memory);
+}
+
+LONGBOW_TEST_CASE(Threads, parcPooledMemory_ThreadExit)
+{
+    void *blocks[4][THREAD_BLOCK_COUNT];
+    pthread_t threads[4];
+
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, _allocateAndDeallocateBlocks, blocks[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Every exited thread returned its magazines to the depot, which Trim empties.
+    parcPooledMemory_Flush();
+    parcPooledMemory_Trim();
+
+    PARCPooledMemoryStatistics statistics;
+    parcPooledMemory_GetStatistics(&statistics);
+    assertTrue(statistics.bytesCached == 0, "Expected nothing cached, actual %zd bytes", statistics.bytesCached);
+    assertTrue(statistics.hits + statistics.misses >= 4 * THREAD_BLOCK_COUNT,
+               "Expected the exited threads' counts to be retained");
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcObject_CreateRelease_Rate);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define OBJECT_COUNT 2000000
+#define OBJECT_LIVE 64
+
+typedef struct {
+    int count;
+} _TestObject;
+
+parcObject_ExtendPARCObject(_TestObject, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static void *
+_createRelease(void *data)
+{
+    PARCObject *live[OBJECT_LIVE] = { NULL };
+
+    // Keep a few objects alive at a time, releasing them out of order as real programs do.
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        int slot = (i * 7) % OBJECT_LIVE;
+        if (live[slot] != NULL) {
+            parcObject_Release(&live[slot]);
+        }
+        live[slot] = parcObject_CreateInstance(_TestObject);
+    }
+    for (int i = 0; i < OBJECT_LIVE; i++) {
+        if (live[i] != NULL) {
+            parcObject_Release(&live[i]);
+        }
+    }
+    return NULL;
+}
+
+static void
+_measureCreateRelease(const char *name, const PARCMemoryInterface *memory, int threadCount)
+{
+    const PARCMemoryInterface *previous = parcMemory_SetInterface(memory);
+    pthread_t threads[threadCount];
+    struct timeval t0, t1, elapsed;
+
+    gettimeofday(&t0, NULL);
+    for (int i = 0; i < threadCount; i++) {
+        pthread_create(&threads[i], NULL, _createRelease, NULL);
+    }
+    for (int i = 0; i < threadCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    gettimeofday(&t1, NULL);
+
+    timersub(&t1, &t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%-8s threads = %d, sec = %.3f, objects/sec = %.0f\n",
+           name, threadCount, sec, threadCount * OBJECT_COUNT / sec);
+
+    parcMemory_SetInterface(previous);
+}
+
+LONGBOW_TEST_CASE(Performance, parcObject_CreateRelease_Rate)
+{
+    for (int threadCount = 1; threadCount <= 4; threadCount *= 2) {
+        _measureCreateRelease("stdlib", &PARCStdlibMemoryAsPARCMemory, threadCount);
+        _measureCreateRelease("pooled", &PARCPooledMemoryAsPARCMemory, threadCount);
+    }
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_parc_PooledMemory);
+    int exitStatus = LONGBOW_TEST_MAIN(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -29,9 +29,11 @@
 // This permits internal static functions to be visible to this Test Framework.
 #include <config.h>
 #include <inttypes.h>
+#include <sys/time.h>
 
 #include "../parc_PriorityQueue.c"
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
 #include <LongBow/unit-test.h>
 
 LONGBOW_TEST_RUNNER(parc_PriorityQueue)
@@ -41,6 +43,8 @@ LONGBOW_TEST_RUNNER(parc_PriorityQueue)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Addressable);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -59,6 +63,8 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_Add);
     LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_Add_Expand);
+    LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_AddAll);
+    LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_AddAll_Few);
     LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_Clear);
     LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_Clear_Destroy);
     LONGBOW_RUN_TEST_CASE(Global, parcPriorityQueue_Create);
@@ -111,6 +117,78 @@ LONGBOW_TEST_CASE(Global, parcPriorityQueue_Add_Expand)
     parcPriorityQueue_Destroy(&queue);
 }
 
+/**
+ * Check the heap property of every entry, and that every handle knows where its entry is.
+ */
+static void
+_assertHeap(const PARCPriorityQueue *queue)
+{
+    size_t arity = queue->addressable ? _PARCPriorityQueue_Arity : 2;
+    for (size_t i = 1; i < queue->size; i++) {
+        size_t parent = (i - 1) / arity;
+        assertTrue(queue->compare(queue->array[parent].data, queue->array[i].data) <= 0,
+                   "Entry %zu is less than its parent %zu", i, parent);
+    }
+    for (size_t i = 0; i < queue->size; i++) {
+        if (queue->addressable) {
+            assertTrue(queue->array[i].slot->index == i, "The handle of entry %zu has index %zu", i, queue->array[i].slot->index);
+        } else {
+            assertNull(queue->array[i].slot, "Entry %zu of a binary heap has a handle", i);
+        }
+    }
+}
+
+static void
+_assertPollsInOrder(PARCPriorityQueue *queue, size_t count)
+{
+    assertTrue(parcPriorityQueue_Size(queue) == count, "Wrong size got %zu expected %zu", parcPriorityQueue_Size(queue), count);
+    uint64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t *value = parcPriorityQueue_Poll(queue);
+        assertTrue(*value >= previous, "Polled %" PRIu64 " after %" PRIu64, *value, previous);
+        previous = *value;
+    }
+    assertNull(parcPriorityQueue_Poll(queue), "Queue should be empty");
+}
+
+LONGBOW_TEST_CASE(Global, parcPriorityQueue_AddAll)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 1000;
+    uint64_t values[count];
+    void *data[count];
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (i * 7919) % 1009;
+        data[i] = &values[i];
+    }
+
+    assertFalse(parcPriorityQueue_AddAll(queue, 0, data, NULL), "Adding nothing should not change the queue");
+    assertTrue(parcPriorityQueue_AddAll(queue, count, data, NULL), "Adding should change the queue");
+    _assertHeap(queue);
+    _assertPollsInOrder(queue, count);
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Global, parcPriorityQueue_AddAll_Few)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 1000;
+    uint64_t values[count + 3];
+    void *data[count + 3];
+    for (size_t i = 0; i < count + 3; i++) {
+        values[i] = (count + 3 - i) * 3;
+        data[i] = &values[i];
+    }
+
+    // Few elements added to a large heap are sifted up one at a time.
+    parcPriorityQueue_AddAll(queue, count, data, NULL);
+    parcPriorityQueue_AddAll(queue, 3, &data[count], NULL);
+    _assertHeap(queue);
+    _assertPollsInOrder(queue, count + 3);
+
+    parcPriorityQueue_Destroy(&queue);
+}
 
 LONGBOW_TEST_CASE(Global, parcPriorityQueue_Clear)
 {
@@ -235,6 +313,8 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleLeftChild_False);
     LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case1_True);
     LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case2_True);
+    LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case2_OnlyLeftLess);
+    LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleDown_InPlace);
     LONGBOW_RUN_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case1_False);
 }
 
@@ -470,9 +550,9 @@ LONGBOW_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case1_False)
 /**
  * Tests the TRUE case
  *
- * Case 2: Right child exists and r.value < n.value && l.value <= r.value
+ * Case 2: Right child exists and l.value < n.value && l.value <= r.value
  *   In this case swap(n.index, l.index) and set n.index = l.index
- *   This makes sense by transitivity that l <= r < n, so swap(n,l) satisfies the invariant.
+ *   This makes sense as l <= r and l < n, so swap(n,l) satisfies the invariant.
  *       50                6
  *      /  \     ===>     / \
  *     6    9            50  9
@@ -493,6 +573,473 @@ LONGBOW_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case2_True)
     parcPriorityQueue_Destroy(&queue);
 }
 
+/**
+ * Case 2 where only the left child is less than the node
+ *       50                6
+ *      /  \     ===>     / \
+ *     6    60           50  60
+ */
+LONGBOW_TEST_CASE(Local, parcPriorityQueue_TrickleRightChild_Case2_OnlyLeftLess)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    uint64_t data[] = { 50, 6, 60 };
+
+    queue->array[0].data = &data[0];
+    queue->array[1].data = &data[1];
+    queue->array[2].data = &data[2];
+    queue->size = 3;
+
+    size_t nextElementIndex = _trickleRightChild(queue, 0, 1, 2);
+    assertTrue(nextElementIndex == 1, "nextElementIndex should have been left 1, got %zu\n", nextElementIndex);
+    assertTrue(queue->array[0].data == &data[1], "Element 6 did not make it to the root");
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+/**
+ * An element that already satisfies the invariant stays where it is, and TrickleDown returns.
+ */
+LONGBOW_TEST_CASE(Local, parcPriorityQueue_TrickleDown_InPlace)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    uint64_t data[] = { 5, 70, 50, 71, 72, 55 };
+
+    queue->size = 6;
+    for (int i = 0; i < queue->size; i++) {
+        queue->array[i].data = &data[i];
+    }
+
+    _trickleDown(queue, 0);
+    for (int i = 0; i < queue->size; i++) {
+        assertTrue(queue->array[i].data == &data[i], "Element %d moved", i);
+    }
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_FIXTURE(Addressable)
+{
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_CreateAddressable);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_AddHandle);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_AddAll_Handles);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_DecreaseKey);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_IncreaseKey);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_RemoveHandle);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_RemoveHandle_Stale);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_RemoveHandle_Reused);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_Clear_RecyclesHandles);
+    LONGBOW_RUN_TEST_CASE(Addressable, parcPriorityQueue_Random);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Addressable)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Addressable)
+{
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_CreateAddressable)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    uint64_t data[] = { 60, 70, 50, 71, 72, 55 };
+    size_t count = 6;
+
+    for (int i = 0; i < count; i++) {
+        parcPriorityQueue_Add(queue, &data[i]);
+    }
+    _assertHeap(queue);
+
+    uint64_t *test = parcPriorityQueue_Peek(queue);
+    assertTrue(*test == 50, "Wrong head element, expected 50 got %" PRIu64, *test);
+    _assertPollsInOrder(queue, count);
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_AddHandle)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 300;
+    uint64_t values[count];
+    PARCPriorityQueueHandle handles[count];
+
+    for (size_t i = 0; i < count; i++) {
+        values[i] = count - i;
+        handles[i] = parcPriorityQueue_AddHandle(queue, &values[i]);
+    }
+    _assertHeap(queue);
+
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(queue->array[handles[i].slot->index].data == &values[i], "Handle %zu does not refer to its element", i);
+    }
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_AddAll_Handles)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 500;
+    uint64_t values[count];
+    void *data[count];
+    PARCPriorityQueueHandle handles[count];
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (i * 7919) % 499;
+        data[i] = &values[i];
+    }
+
+    parcPriorityQueue_AddAll(queue, count, data, handles);
+    _assertHeap(queue);
+
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(queue->array[handles[i].slot->index].data == &values[i], "Handle %zu does not refer to its element", i);
+    }
+    _assertPollsInOrder(queue, count);
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_DecreaseKey)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 100;
+    uint64_t values[count];
+    PARCPriorityQueueHandle handles[count];
+    for (size_t i = 0; i < count; i++) {
+        values[i] = 10 + i;
+        handles[i] = parcPriorityQueue_AddHandle(queue, &values[i]);
+    }
+
+    values[count - 1] = 1;
+    parcPriorityQueue_DecreaseKey(queue, handles[count - 1]);
+    _assertHeap(queue);
+
+    assertTrue(parcPriorityQueue_Peek(queue) == &values[count - 1], "The decreased element should be at the head");
+    _assertPollsInOrder(queue, count);
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_IncreaseKey)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 100;
+    uint64_t values[count];
+    PARCPriorityQueueHandle handles[count];
+    for (size_t i = 0; i < count; i++) {
+        values[i] = 10 + i;
+        handles[i] = parcPriorityQueue_AddHandle(queue, &values[i]);
+    }
+
+    values[0] = 1000;
+    parcPriorityQueue_IncreaseKey(queue, handles[0]);
+    _assertHeap(queue);
+
+    assertTrue(parcPriorityQueue_Peek(queue) == &values[1], "The next least element should be at the head");
+    for (size_t i = 1; i < count; i++) {
+        parcPriorityQueue_Poll(queue);
+    }
+    assertTrue(parcPriorityQueue_Poll(queue) == &values[0], "The increased element should be polled last");
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_RemoveHandle)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 200;
+    uint64_t values[count];
+    PARCPriorityQueueHandle handles[count];
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (i * 37) % count;
+        handles[i] = parcPriorityQueue_AddHandle(queue, &values[i]);
+    }
+
+    // Remove every third element, which takes entries from the root, the middle and the leaves.
+    size_t removed = 0;
+    for (size_t i = 0; i < count; i += 3) {
+        void *data = parcPriorityQueue_RemoveHandle(queue, handles[i]);
+        assertTrue(data == &values[i], "RemoveHandle returned the wrong element");
+        values[i] = UINT64_MAX;
+        removed++;
+        _assertHeap(queue);
+    }
+
+    size_t remaining = count - removed;
+    assertTrue(parcPriorityQueue_Size(queue) == remaining, "Wrong size got %zu expected %zu", parcPriorityQueue_Size(queue), remaining);
+    for (size_t i = 0; i < remaining; i++) {
+        uint64_t *value = parcPriorityQueue_Poll(queue);
+        assertTrue(*value != UINT64_MAX, "Polled an element that was removed");
+    }
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_CASE_EXPECTS(Addressable, parcPriorityQueue_RemoveHandle_Stale, .event = &LongBowTrapIllegalValue)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    uint64_t value = 1;
+    PARCPriorityQueueHandle handle = parcPriorityQueue_AddHandle(queue, &value);
+    parcPriorityQueue_Poll(queue);
+
+    parcPriorityQueue_RemoveHandle(queue, handle);
+}
+
+LONGBOW_TEST_CASE_EXPECTS(Addressable, parcPriorityQueue_RemoveHandle_Reused, .event = &LongBowTrapIllegalValue)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    uint64_t values[] = { 1, 2 };
+    PARCPriorityQueueHandle handle = parcPriorityQueue_AddHandle(queue, &values[0]);
+    parcPriorityQueue_Poll(queue);
+
+    // The new element is given the slot of the old one, so only the generation tells the handles apart.
+    PARCPriorityQueueHandle reused = parcPriorityQueue_AddHandle(queue, &values[1]);
+    assertTrue(reused.slot == handle.slot, "Expected the slot to be reused");
+
+    parcPriorityQueue_RemoveHandle(queue, handle);
+}
+
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_Clear_RecyclesHandles)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, parcPriorityQueue_ParcFreeDestroyer);
+    const size_t count = 150;
+
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t *value = parcMemory_Allocate(sizeof(uint64_t));
+            *value = i;
+            parcPriorityQueue_AddHandle(queue, value);
+        }
+        uint32_t outstanding = parcMemory_Outstanding();
+        parcPriorityQueue_Clear(queue);
+        assertTrue(parcMemory_Outstanding() == outstanding - count, "Clear should only free the elements");
+    }
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+/**
+ * Mix every operation at random and check the heap after each one.
+ */
+LONGBOW_TEST_CASE(Addressable, parcPriorityQueue_Random)
+{
+    PARCPriorityQueue *queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    const size_t count = 500;
+    uint64_t values[count];
+    PARCPriorityQueueHandle handles[count];
+    for (size_t i = 0; i < count; i++) {
+        handles[i] = (PARCPriorityQueueHandle) { NULL, 0 };
+    }
+
+    srandom(1);
+    for (size_t step = 0; step < 20000; step++) {
+        size_t i = random() % count;
+        if (handles[i].slot == NULL) {
+            values[i] = random() % 1000;
+            handles[i] = parcPriorityQueue_AddHandle(queue, &values[i]);
+        } else {
+            switch (random() % 4) {
+                case 0:
+                    values[i] /= 2;
+                    parcPriorityQueue_DecreaseKey(queue, handles[i]);
+                    break;
+                case 1:
+                    values[i] += random() % 1000;
+                    parcPriorityQueue_IncreaseKey(queue, handles[i]);
+                    break;
+                case 2:
+                    parcPriorityQueue_RemoveHandle(queue, handles[i]);
+                    handles[i] = (PARCPriorityQueueHandle) { NULL, 0 };
+                    break;
+                default: {
+                    uint64_t *head = parcPriorityQueue_Poll(queue);
+                    handles[head - values] = (PARCPriorityQueueHandle) { NULL, 0 };
+                    break;
+                }
+            }
+        }
+        if (step % 97 == 0) {
+            _assertHeap(queue);
+        }
+    }
+    _assertHeap(queue);
+
+    parcPriorityQueue_Destroy(&queue);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcPriorityQueue_Schedule);
+    LONGBOW_RUN_TEST_CASE(Performance, parcPriorityQueue_AddAll);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static void
+_performanceReport(const char *name, const char *operation, size_t count, struct timeval *t0, struct timeval *t1)
+{
+    struct timeval elapsed;
+    timersub(t1, t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%-11s %-12s: %zu operations, nsec/op = %.1f\n", name, operation, count, sec * 1E9 / count);
+}
+
+/**
+ * Cancelling from a binary heap means draining it and adding back everything but the cancelled element.
+ */
+static void
+_binaryCancel(PARCPriorityQueue *queue, void *cancelled, void **scratch)
+{
+    size_t kept = 0;
+    void *data;
+    while ((data = parcPriorityQueue_Poll(queue)) != NULL) {
+        if (data != cancelled) {
+            scratch[kept++] = data;
+        }
+    }
+    parcPriorityQueue_AddAll(queue, kept, scratch, NULL);
+}
+
+/**
+ * A timer wheel workload: a standing population of timers, some of which are rescheduled or cancelled.
+ */
+LONGBOW_TEST_CASE(Performance, parcPriorityQueue_Schedule)
+{
+    const size_t count = 100000;
+    const size_t operations = 1000000;
+    const size_t cancels = 100;
+    struct timeval t0, t1;
+
+    uint64_t *values = parcMemory_Allocate(count * sizeof(uint64_t));
+    void **data = parcMemory_Allocate(count * sizeof(void *));
+    PARCPriorityQueueHandle *handles = parcMemory_Allocate(count * sizeof(PARCPriorityQueueHandle));
+
+    PARCPriorityQueue *binary = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    PARCPriorityQueue *addressable = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+
+    // Expire the earliest timer and schedule it again later.
+    srandom(1);
+    for (size_t i = 0; i < count; i++) {
+        values[i] = random();
+        parcPriorityQueue_Add(binary, &values[i]);
+    }
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < operations; i++) {
+        uint64_t *head = parcPriorityQueue_Poll(binary);
+        *head += random() % 1000000;
+        parcPriorityQueue_Add(binary, head);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("binary", "poll+add", operations, &t0, &t1);
+
+    srandom(1);
+    for (size_t i = 0; i < count; i++) {
+        values[i] = random();
+        handles[i] = parcPriorityQueue_AddHandle(addressable, &values[i]);
+    }
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < operations; i++) {
+        uint64_t *head = parcPriorityQueue_Poll(addressable);
+        *head += random() % 1000000;
+        handles[head - values] = parcPriorityQueue_AddHandle(addressable, head);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("addressable", "poll+add", operations, &t0, &t1);
+
+    // Push a random timer further out.
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < operations; i++) {
+        size_t index = random() % count;
+        values[index] += random() % 1000000;
+        parcPriorityQueue_IncreaseKey(addressable, handles[index]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("addressable", "reschedule", operations, &t0, &t1);
+
+    // Cancel random timers.
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < cancels; i++) {
+        _binaryCancel(binary, &values[random() % count], data);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("binary", "cancel", cancels, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        parcPriorityQueue_RemoveHandle(addressable, handles[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("addressable", "cancel", count, &t0, &t1);
+
+    parcPriorityQueue_Destroy(&binary);
+    parcPriorityQueue_Destroy(&addressable);
+    parcMemory_Deallocate((void **) &handles);
+    parcMemory_Deallocate((void **) &data);
+    parcMemory_Deallocate((void **) &values);
+}
+
+LONGBOW_TEST_CASE(Performance, parcPriorityQueue_AddAll)
+{
+    const size_t count = 1000000;
+    struct timeval t0, t1;
+
+    uint64_t *values = parcMemory_Allocate(count * sizeof(uint64_t));
+    void **data = parcMemory_Allocate(count * sizeof(void *));
+    srandom(1);
+    for (size_t i = 0; i < count; i++) {
+        values[i] = random();
+        data[i] = &values[i];
+    }
+
+    PARCPriorityQueue *queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        parcPriorityQueue_Add(queue, data[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("binary", "add", count, &t0, &t1);
+    parcPriorityQueue_Destroy(&queue);
+
+    queue = parcPriorityQueue_Create(parcPriorityQueue_Uint64CompareTo, NULL);
+    gettimeofday(&t0, NULL);
+    parcPriorityQueue_AddAll(queue, count, data, NULL);
+    gettimeofday(&t1, NULL);
+    _performanceReport("binary", "add all", count, &t0, &t1);
+    parcPriorityQueue_Destroy(&queue);
+
+    queue = parcPriorityQueue_CreateAddressable(parcPriorityQueue_Uint64CompareTo, NULL);
+    gettimeofday(&t0, NULL);
+    parcPriorityQueue_AddAll(queue, count, data, NULL);
+    gettimeofday(&t1, NULL);
+    _performanceReport("addressable", "add all", count, &t0, &t1);
+    parcPriorityQueue_Destroy(&queue);
+
+    parcMemory_Deallocate((void **) &data);
+    parcMemory_Deallocate((void **) &values);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -222,6 +222,7 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, parcSafeMemory_Allocate);
     LONGBOW_RUN_TEST_CASE(Global, parcSafeMemory_MemAlign);
+    LONGBOW_RUN_TEST_CASE(Global, parcSafeMemory_MemAlign_CacheLine);
 
     LONGBOW_RUN_TEST_CASE(Global, PARCSafeMemory_Realloc_Larger);
     LONGBOW_RUN_TEST_CASE(Global, PARCSafeMemory_Realloc_Smaller);
@@ -400,6 +401,22 @@ LONGBOW_TEST_CASE(Global, parcSafeMemory_MemAlign)
     parcSafeMemory_Deallocate(&memory);
 }
 
+LONGBOW_TEST_CASE(Global, parcSafeMemory_MemAlign_CacheLine)
+{
+    void *memory;
+    size_t size = 100;
+
+    int failure = parcSafeMemory_MemAlign(&memory, 64, size);
+    assertTrue(failure == 0,
+               "parcSafeMemory_MemAlign failed: %d", failure);
+
+    assertTrue(((uintptr_t) memory % 64) == 0,
+               "Expected memory aligned on 64 bytes, actual %p", memory);
+    assertTrue(_parcSafeMemory_GetState(memory) == PARCSafeMemoryState_OK,
+               "Memory did not validate.");
+    parcSafeMemory_Deallocate(&memory);
+}
+
 LONGBOW_TEST_CASE(Global, parcSafeMemory_ReportAllocation)
 {
     void *memory;
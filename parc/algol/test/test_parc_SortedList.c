@@ -30,6 +30,9 @@
  */
 #include "../parc_SortedList.c"
 
+#include <sys/time.h>
+#include <inttypes.h>
+
 #include <LongBow/testing.h>
 #include <LongBow/debugging.h>
 #include <parc/algol/parc_Memory.h>
@@ -47,6 +50,7 @@ LONGBOW_TEST_RUNNER(parc_SortedList)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -244,6 +248,16 @@ LONGBOW_TEST_FIXTURE(Specialization)
     LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_RemoveFirst);
     LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_RemoveFirst_SingleElement);
     LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_RemoveLast);
+
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Empty);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Add_Many);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Add_Stable);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Remove_Many);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Remove_Duplicates);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_RemoveFirst_Many);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_RemoveLast_Many);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Iterator_Remove);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcSortedList_Copy_Many);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Specialization)
@@ -513,6 +527,329 @@ LONGBOW_TEST_CASE(Specialization, parcSortedList_RemoveLast_SingleElement)
     parcSortedList_Release(&deque);
 }
 
+static PARCBuffer *
+_createValue(uint64_t value)
+{
+    return parcBuffer_Flip(parcBuffer_PutUint64(parcBuffer_Allocate(sizeof(uint64_t)), value));
+}
+
+static uint64_t
+_getValue(const PARCObject *object)
+{
+    return parcBuffer_GetUint64(parcBuffer_Rewind((PARCBuffer *) object));
+}
+
+/*
+ * Check the structure of the tree beneath the given node, returning the number of elements it holds.
+ */
+static size_t
+_assertNodeIsValid(const PARCSortedList *list, const _PARCSortedListNode *node, _PARCSortedListNode **expectedLeaf)
+{
+    assertTrue(node->length > 0 || node == list->root, "Expected only the root to be empty.");
+    assertTrue(node->length <= _PARCSortedList_NodeCapacity, "Node overflow %u", node->length);
+
+    size_t count = 0;
+    if (node->isLeaf) {
+        assertTrue(node == *expectedLeaf, "Expected the leaves to be linked in order.");
+        *expectedLeaf = node->next;
+        for (unsigned i = 0; i < node->length; i++) {
+            if (i > 0) {
+                assertTrue(list->compare(node->entries[i - 1], node->entries[i]) <= 0, "Expected the elements of a leaf to be in order.");
+            }
+        }
+        if (node->next != NULL && node->length > 0) {
+            assertTrue(list->compare(node->entries[node->length - 1], node->next->entries[0]) <= 0, "Expected the leaves to be in order.");
+            assertTrue(node->next->previous == node, "Expected the leaves to be doubly linked.");
+        }
+        count = node->length;
+    } else {
+        for (unsigned i = 0; i < node->length; i++) {
+            _PARCSortedListNode *child = node->entries[i];
+            assertTrue(child->parent == node, "Expected the child's parent to be this node.");
+            count += _assertNodeIsValid(list, child, expectedLeaf);
+        }
+    }
+
+    PARCObject *first = node->length == 0 ? NULL : (node->isLeaf ? node->entries[0] : ((_PARCSortedListNode *) node->entries[0])->first);
+    assertTrue(node->first == first, "Expected the cached first element to be the first element.");
+    assertTrue(node->count == count, "Expected a count of %zd, actual %zd", count, node->count);
+
+    return count;
+}
+
+static void
+_assertListIsValid(const PARCSortedList *list, size_t expectedSize)
+{
+    _PARCSortedListNode *expectedLeaf = list->head;
+    assertNull(list->root->parent, "Expected the root to have no parent.");
+    size_t count = _assertNodeIsValid(list, list->root, &expectedLeaf);
+    assertNull(expectedLeaf, "Expected the last leaf to be the tail.");
+    assertTrue(count == expectedSize, "Expected %zd elements, actual %zd", expectedSize, count);
+    assertTrue(parcSortedList_Size(list) == expectedSize, "Expected size %zd, actual %zd", expectedSize, parcSortedList_Size(list));
+}
+
+/*
+ * Add the values 0 through count - 1 in a scrambled order.
+ */
+static PARCSortedList *
+_createScrambled(size_t count)
+{
+    PARCSortedList *list = parcSortedList_Create();
+    for (size_t i = 0; i < count; i++) {
+        PARCBuffer *value = _createValue((i * 7919) % count);
+        parcSortedList_Add(list, value);
+        parcBuffer_Release(&value);
+    }
+    return list;
+}
+
+#define MANY 2000
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Empty)
+{
+    PARCSortedList *list = parcSortedList_Create();
+
+    assertNull(parcSortedList_GetFirst(list), "Expected NULL from an empty list.");
+    assertNull(parcSortedList_GetLast(list), "Expected NULL from an empty list.");
+    assertNull(parcSortedList_RemoveFirst(list), "Expected NULL from an empty list.");
+    assertNull(parcSortedList_RemoveLast(list), "Expected NULL from an empty list.");
+
+    PARCBuffer *value = _createValue(1);
+    assertFalse(parcSortedList_Remove(list, value), "Expected nothing to be removed from an empty list.");
+    parcBuffer_Release(&value);
+
+    _assertListIsValid(list, 0);
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Add_Many)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+    _assertListIsValid(list, MANY);
+    assertFalse(list->root->isLeaf, "Expected the tree to have more than one level.");
+
+    for (size_t i = 0; i < MANY; i++) {
+        uint64_t actual = _getValue(parcSortedList_GetAtIndex(list, i));
+        assertTrue(actual == i, "Expected %zd at index %zd, actual %" PRIu64, i, i, actual);
+    }
+
+    PARCIterator *iterator = parcSortedList_CreateIterator(list);
+    for (size_t i = 0; i < MANY; i++) {
+        assertTrue(parcIterator_HasNext(iterator), "Expected another element at %zd", i);
+        uint64_t actual = _getValue(parcIterator_Next(iterator));
+        assertTrue(actual == i, "Expected %zd, actual %" PRIu64, i, actual);
+    }
+    assertFalse(parcIterator_HasNext(iterator), "Expected no more elements.");
+    parcIterator_Release(&iterator);
+
+    parcSortedList_Release(&list);
+}
+
+static int
+_compareFirstByte(const PARCObject *a, const PARCObject *b)
+{
+    return (int) parcBuffer_GetAtIndex(a, 0) - (int) parcBuffer_GetAtIndex(b, 0);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Add_Stable)
+{
+    PARCSortedList *list = parcSortedList_CreateCompare(_compareFirstByte);
+
+    // Elements that compare equal remain in the order in which they were added.
+    for (uint64_t i = 0; i < MANY; i++) {
+        PARCBuffer *value = _createValue(((MANY - i) % 4) << 56 | i);
+        parcSortedList_Add(list, value);
+        parcBuffer_Release(&value);
+    }
+    _assertListIsValid(list, MANY);
+
+    uint64_t previous = 0;
+    for (size_t i = 0; i < MANY; i++) {
+        uint64_t actual = _getValue(parcSortedList_GetAtIndex(list, i));
+        if (i > 0 && (actual >> 56) == (previous >> 56)) {
+            assertTrue((actual & 0xFFFF) > (previous & 0xFFFF), "Expected equal elements in the order they were added.");
+        }
+        previous = actual;
+    }
+
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Remove_Many)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+
+    size_t size = MANY;
+    for (size_t i = 0; i < MANY; i++) {
+        uint64_t value = (i * 4099) % MANY;
+        PARCBuffer *element = _createValue(value);
+        assertTrue(parcSortedList_Remove(list, element), "Expected %" PRIu64 " to be removed", value);
+        assertFalse(parcSortedList_Remove(list, element), "Expected %" PRIu64 " to be removed only once", value);
+        parcBuffer_Release(&element);
+        size--;
+        if (i % 97 == 0) {
+            _assertListIsValid(list, size);
+        }
+    }
+    _assertListIsValid(list, 0);
+    assertTrue(list->root->isLeaf, "Expected an empty tree to have a single level.");
+
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Remove_Duplicates)
+{
+    PARCSortedList *list = parcSortedList_Create();
+    PARCBuffer *value = _createValue(42);
+
+    for (size_t i = 0; i < 100; i++) {
+        parcSortedList_Add(list, value);
+    }
+    _assertListIsValid(list, 100);
+
+    for (size_t i = 100; i > 0; i--) {
+        assertTrue(parcSortedList_Remove(list, value), "Expected a duplicate to be removed.");
+        _assertListIsValid(list, i - 1);
+    }
+    assertTrue(parcObject_GetReferenceCount(value) == 1, "Expected the list to release every reference.");
+
+    parcBuffer_Release(&value);
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_RemoveFirst_Many)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+
+    for (size_t i = 0; i < MANY; i++) {
+        assertTrue(_getValue(parcSortedList_GetFirst(list)) == i, "Expected %zd to be first.", i);
+        PARCBuffer *first = parcSortedList_RemoveFirst(list);
+        assertTrue(_getValue(first) == i, "Expected %zd to be removed first.", i);
+        parcBuffer_Release(&first);
+        if (i % 97 == 0) {
+            _assertListIsValid(list, MANY - i - 1);
+        }
+    }
+    _assertListIsValid(list, 0);
+
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_RemoveLast_Many)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+
+    for (size_t i = MANY; i > 0; i--) {
+        assertTrue(_getValue(parcSortedList_GetLast(list)) == i - 1, "Expected %zd to be last.", i - 1);
+        PARCBuffer *last = parcSortedList_RemoveLast(list);
+        assertTrue(_getValue(last) == i - 1, "Expected %zd to be removed last.", i - 1);
+        parcBuffer_Release(&last);
+        if (i % 97 == 0) {
+            _assertListIsValid(list, i - 1);
+        }
+    }
+    _assertListIsValid(list, 0);
+
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Iterator_Remove)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+
+    // Remove the odd values while iterating.
+    PARCIterator *iterator = parcSortedList_CreateIterator(list);
+    size_t expected = 0;
+    while (parcIterator_HasNext(iterator)) {
+        uint64_t actual = _getValue(parcIterator_Next(iterator));
+        assertTrue(actual == expected, "Expected %zd, actual %" PRIu64, expected, actual);
+        if (actual % 2 == 1) {
+            parcIterator_Remove(iterator);
+        }
+        expected++;
+    }
+    parcIterator_Release(&iterator);
+
+    _assertListIsValid(list, MANY / 2);
+    for (size_t i = 0; i < MANY / 2; i++) {
+        assertTrue(_getValue(parcSortedList_GetAtIndex(list, i)) == 2 * i, "Expected %zd at index %zd", 2 * i, i);
+    }
+
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcSortedList_Copy_Many)
+{
+    PARCSortedList *list = _createScrambled(MANY);
+    PARCSortedList *copy = parcSortedList_Copy(list);
+
+    _assertListIsValid(copy, MANY);
+    assertTrue(parcSortedList_Equals(list, copy), "Expected the copy to be equal to the original.");
+    assertTrue(parcSortedList_HashCode(list) == parcSortedList_HashCode(copy), "Expected equal hash codes.");
+
+    PARCBuffer *first = parcSortedList_RemoveFirst(copy);
+    assertFalse(parcSortedList_Equals(list, copy), "Expected the lists to differ.");
+    parcSortedList_Add(copy, first);
+    assertTrue(parcSortedList_Equals(list, copy), "Expected the lists to be equal again.");
+
+    parcBuffer_Release(&first);
+    parcSortedList_Release(&copy);
+    parcSortedList_Release(&list);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcSortedList_AddRemoveFirst_Rate);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Performance, parcSortedList_AddRemoveFirst_Rate)
+{
+    for (size_t size = 1000; size <= 100000; size *= 10) {
+        PARCBuffer **values = parcMemory_Allocate(size * sizeof(PARCBuffer *));
+        for (size_t i = 0; i < size; i++) {
+            values[i] = _createValue((i * 7919) % size);
+        }
+
+        PARCSortedList *list = parcSortedList_Create();
+
+        struct timeval start;
+        gettimeofday(&start, NULL);
+        for (size_t i = 0; i < size; i++) {
+            parcSortedList_Add(list, values[i]);
+        }
+        struct timeval added;
+        gettimeofday(&added, NULL);
+        for (size_t i = 0; i < size; i++) {
+            PARCBuffer *first = parcSortedList_RemoveFirst(list);
+            parcBuffer_Release(&first);
+        }
+        struct timeval end;
+        gettimeofday(&end, NULL);
+
+        timersub(&end, &added, &end);
+        timersub(&added, &start, &added);
+        printf("%7zd elements: Add %.3f usec/op, RemoveFirst %.3f usec/op\n", size,
+               (added.tv_sec * 1000000.0 + added.tv_usec) / size,
+               (end.tv_sec * 1000000.0 + end.tv_usec) / size);
+
+        parcSortedList_Release(&list);
+        for (size_t i = 0; i < size; i++) {
+            parcBuffer_Release(&values[i]);
+        }
+        parcMemory_Deallocate(&values);
+    }
+}
+
 int
 main(int argc, char *argv[argc])
 {
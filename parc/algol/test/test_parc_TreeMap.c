@@ -31,7 +31,10 @@
 #include <fcntl.h>
 #include <time.h>
 
+#include <sys/time.h>
+
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
 #include <LongBow/unit-test.h>
 
 #include "../parc_TreeMap.c"
@@ -101,6 +104,7 @@ LONGBOW_TEST_RUNNER(PARC_TreeMap)
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
     LONGBOW_RUN_TEST_FIXTURE(Stress);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 LONGBOW_TEST_RUNNER_SETUP(PARC_TreeMap)
@@ -180,6 +184,25 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_KeyIterator);
     LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_Remove_Using_Iterator);
     LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_Remove_Element_Using_Iterator);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_InitCursor);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_InitCursor_Empty);
+
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_CreateFromSorted);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_CreateFromSorted_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_HigherLower_NotInTree);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_PutRemove_Many);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_Remove_Using_Iterator_Many);
+
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_GetAtIndex);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_GetAtIndex_OutOfBounds);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_Rank);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_InitCursorFrom);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_SubMap);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_SubMap_Changes);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_HeadMap);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_TailMap_Iterator);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_View_OfView);
+    LONGBOW_RUN_TEST_CASE(Global, PARC_TreeMap_View_Copy);
 }
 
 #define N_TEST_ELEMENTS 42
@@ -232,33 +255,77 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
-static
-int
-recursiveCheckBlackDepth(const PARCTreeMap *tree, const _RBNode *node)
+/*
+ * Check the subtree rooted at the given node, in which every key is at least `low` and less than `high`
+ * (either bound may be NULL), and return its height.
+ */
+static size_t
+checkNode(const PARCTreeMap *tree, const _BTreeNode *node, const PARCObject *low, const PARCObject *high, size_t *entries)
 {
-    assertNotNull(tree, "Null tree?\n");
-    assertNotNull(node, "Null node?\n");
-    if (node == tree->nil) {
-        return 0;
+    size_t result = 0;
+
+    if (node != tree->root) {
+        size_t minimum = node->isLeaf ? _PARCTreeMap_LeafMinimum : _PARCTreeMap_BranchMinimum;
+        assertTrue(node->count >= minimum, "Node is less than half full: %zd", node->count);
     }
-    int right_depth = recursiveCheckBlackDepth(tree, node->rightChild);
-    int left_depth = recursiveCheckBlackDepth(tree, node->leftChild);
-    assertTrue(right_depth == left_depth, "Wrong depth!!\n");
-    if (_rbNodeColor(node) == BLACK) {
-        return right_depth + 1;
+
+    if (node->isLeaf) {
+        const _BTreeLeaf *leaf = (const _BTreeLeaf *) node;
+        assertTrue(node->count <= _PARCTreeMap_LeafCapacity, "Leaf is overfull: %zd", node->count);
+        for (size_t i = 0; i < node->count; i++) {
+            assertTrue(leaf->keys[i] == parcKeyValue_GetKey(leaf->elements[i]), "Leaf key %zd is not the key of its element", i);
+            if (i > 0) {
+                assertTrue(_parcTreeMap_Compare(tree, leaf->keys[i - 1], leaf->keys[i]) < 0, "Leaf keys out of order at %zd", i);
+            }
+        }
+        if (node->count > 0) {
+            assertTrue(low == NULL || _parcTreeMap_Compare(tree, low, leaf->keys[0]) <= 0, "Leaf key below its bound");
+            assertTrue(high == NULL || _parcTreeMap_Compare(tree, leaf->keys[node->count - 1], high) < 0, "Leaf key above its bound");
+        }
+        *entries += node->count;
+    } else {
+        const _BTreeBranch *branch = (const _BTreeBranch *) node;
+        assertTrue(node->count >= 2 && node->count <= _PARCTreeMap_BranchCapacity, "Branch has %zd children", node->count);
+        for (size_t i = 0; i < node->count; i++) {
+            const PARCObject *childLow = (i == 0) ? low : branch->keys[i - 1];
+            const PARCObject *childHigh = (i == node->count - 1) ? high : branch->keys[i];
+            size_t before = *entries;
+            size_t height = checkNode(tree, branch->children[i], childLow, childHigh, entries);
+            assertTrue(branch->counts[i] == *entries - before, "Branch counts %zd entries under child %zd, actual %zd",
+                       branch->counts[i], i, *entries - before);
+            assertTrue(i == 0 || height == result, "Children of a branch have different heights");
+            result = height;
+        }
+        result++;
     }
-    return right_depth;
+
+    return result;
 }
 
 static
 void
-rbCheckTree(const PARCTreeMap *tree)
+checkTree(const PARCTreeMap *tree)
 {
     assertNotNull(tree, "Tree can't be NULL");
-    _rbNodeAssertTreeInvariants(tree);
-    if (tree->size > 0) {
-        recursiveCheckBlackDepth(tree, tree->root);
+    _parcTreeMap_AssertInvariants(tree);
+
+    size_t entries = 0;
+    checkNode(tree, tree->root, NULL, NULL, &entries);
+    assertTrue(entries == tree->size, "Expected %zd entries in the leaves, actual %zd", tree->size, entries);
+
+    // The leaves are linked in order, in both directions.
+    size_t linked = 0;
+    const _BTreeLeaf *previous = NULL;
+    for (const _BTreeLeaf *leaf = tree->first; leaf != NULL; leaf = leaf->next) {
+        assertTrue(leaf->previous == previous, "Leaf has the wrong previous leaf");
+        if (previous != NULL && previous->node.count > 0 && leaf->node.count > 0) {
+            assertTrue(_parcTreeMap_Compare(tree, previous->keys[previous->node.count - 1], leaf->keys[0]) < 0, "Leaves out of order");
+        }
+        linked += leaf->node.count;
+        previous = leaf;
     }
+    assertTrue(previous == tree->last, "The last linked leaf is not the last leaf");
+    assertTrue(linked == tree->size, "Expected %zd entries in the linked leaves, actual %zd", tree->size, linked);
 }
 
 LONGBOW_TEST_CASE(Global, PARC_TreeMap_Remove_Ordered)
@@ -1353,6 +1420,40 @@ LONGBOW_TEST_CASE(Global, PARC_TreeMap_ValueIterator)
     parcIterator_Release(&it);
 }
 
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_InitCursor)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCTreeMap *tree1 = data->testMap1;
+
+    int idx1[15] = { 8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7, 9, 11, 13, 15 };
+
+    for (int i = 0; i < 15; i++) {
+        parcTreeMap_Put(tree1, data->k[idx1[i]], data->v[idx1[i]]);
+    }
+
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(tree1, &cursor);
+
+    int idx = 1;
+    while (parcTreeMap_CursorNext(&cursor)) {
+        _Int *key = parcCursor_GetKey(&cursor);
+        _Int *value = parcCursor_GetValue(&cursor);
+        assertTrue(_int_Equals(key, data->k[idx]), "Expected key %d got %d", data->k[idx]->value, key->value);
+        assertTrue(_int_Equals(value, data->v[idx]), "Expected value %d got %d", data->v[idx]->value, value->value);
+        idx++;
+    }
+    assertTrue(idx == 16, "Expected to visit 15 entries, actual %d", idx - 1);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_InitCursor_Empty)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(data->testMap1, &cursor);
+    assertFalse(parcTreeMap_CursorNext(&cursor), "Expected no entries in an empty tree");
+}
+
 LONGBOW_TEST_CASE(Global, PARC_TreeMap_KeyIterator)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -1454,9 +1555,431 @@ LONGBOW_TEST_CASE(Global, PARC_TreeMap_Remove_Element_Using_Iterator)
     assertTrue(parcTreeMap_Equals(tree1, tree2), "Expect the trees to be equal after remove.");
 }
 
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_CreateFromSorted)
+{
+    // Counts that fill one leaf, overflow it, and need more than one level of branches.
+    size_t counts[] = { 1, _PARCTreeMap_LeafCapacity, _PARCTreeMap_LeafCapacity + 1, 1000, 5000 };
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        size_t count = counts[c];
+        _Int **keys = parcMemory_Allocate(count * sizeof(_Int *));
+        for (size_t i = 0; i < count; i++) {
+            keys[i] = _int_Create((int) (2 * i));
+        }
+
+        PARCTreeMap *tree = parcTreeMap_CreateFromSorted((PARCTreeMap_CustomCompare *) _int_Compare, count,
+                                                         (const PARCObject **) keys, (const PARCObject **) keys);
+        checkTree(tree);
+        assertTrue(parcTreeMap_Size(tree) == count, "Expected size %zd, actual %zd", count, parcTreeMap_Size(tree));
+
+        PARCCursor cursor;
+        parcTreeMap_InitCursor(tree, &cursor);
+        for (size_t i = 0; parcTreeMap_CursorNext(&cursor); i++) {
+            assertTrue(parcCursor_GetKey(&cursor) == keys[i], "Expected key %zd in order", i);
+        }
+
+        // The tree must accept further changes.
+        _Int *odd = _int_Create(1);
+        parcTreeMap_Put(tree, odd, odd);
+        for (size_t i = 0; i < count; i += 2) {
+            parcTreeMap_RemoveAndRelease(tree, keys[i]);
+        }
+        checkTree(tree);
+        assertTrue(parcTreeMap_Get(tree, odd) == odd, "Expected to get the added entry");
+        _int_Release(&odd);
+
+        parcTreeMap_Release(&tree);
+        for (size_t i = 0; i < count; i++) {
+            _int_Release(&keys[i]);
+        }
+        parcMemory_Deallocate(&keys);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_CreateFromSorted_Empty)
+{
+    PARCTreeMap *tree = parcTreeMap_CreateFromSorted(NULL, 0, NULL, NULL);
+    checkTree(tree);
+    assertTrue(parcTreeMap_Size(tree) == 0, "Expected an empty tree");
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_HigherLower_NotInTree)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCTreeMap *tree1 = data->testMap2;
+
+    for (int i = 0; i < N_TEST_ELEMENTS; i += 2) {
+        parcTreeMap_Put(tree1, data->k[i], data->v[i]);
+    }
+
+    for (int i = 1; i < N_TEST_ELEMENTS - 1; i += 2) {
+        _Int *higher = parcTreeMap_GetHigherKey(tree1, data->k[i]);
+        assertTrue(_int_Equals(higher, data->k[i + 1]), "Expected %d, actual %d", i + 1, higher->value);
+        _Int *lower = parcTreeMap_GetLowerKey(tree1, data->k[i]);
+        assertTrue(_int_Equals(lower, data->k[i - 1]), "Expected %d, actual %d", i - 1, lower->value);
+    }
+    assertNull(parcTreeMap_GetHigherKey(tree1, data->k[N_TEST_ELEMENTS - 1]), "Expected no key above the largest");
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_PutRemove_Many)
+{
+    const int range = 2000;
+    PARCTreeMap *tree = parcTreeMap_CreateCustom((PARCTreeMap_CustomCompare *) _int_Compare);
+    bool present[range];
+    memset(present, 0, sizeof(present));
+    size_t expected = 0;
+
+    _Int *key = _int_Create(0);
+    for (int i = 0; i < 20000; i++) {
+        _int_Set(key, (int) (random() % range));
+        if (random() % 100 < 55) {
+            parcTreeMap_Put(tree, key, key);
+            if (!present[key->value]) {
+                present[key->value] = true;
+                expected++;
+            }
+            // The tree holds the key, so the next one must be a new object.
+            _int_Release(&key);
+            key = _int_Create(0);
+        } else {
+            PARCObject *value = parcTreeMap_Remove(tree, key);
+            assertTrue((value != NULL) == present[key->value], "Remove of %d disagrees with the model", key->value);
+            if (value != NULL) {
+                parcObject_Release(&value);
+                present[key->value] = false;
+                expected--;
+            }
+        }
+        if (i % 500 == 0) {
+            checkTree(tree);
+        }
+        assertTrue(parcTreeMap_Size(tree) == expected, "Expected size %zd, actual %zd", expected, parcTreeMap_Size(tree));
+    }
+    checkTree(tree);
+
+    while (parcTreeMap_Size(tree) > 0) {
+        parcTreeMap_RemoveAndRelease(tree, parcTreeMap_GetFirstKey(tree));
+    }
+    checkTree(tree);
+
+    _int_Release(&key);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_Remove_Using_Iterator_Many)
+{
+    const int count = 1000;
+    PARCTreeMap *tree = parcTreeMap_CreateCustom((PARCTreeMap_CustomCompare *) _int_Compare);
+    for (int i = 0; i < count; i++) {
+        _Int *key = _int_Create(i);
+        parcTreeMap_Put(tree, key, key);
+        _int_Release(&key);
+    }
+
+    // Removing entries rebalances the leaves under the iterator.
+    PARCIterator *it = parcTreeMap_CreateKeyIterator(tree);
+    for (int expected = 0; parcIterator_HasNext(it); expected++) {
+        _Int *key = parcIterator_Next(it);
+        assertTrue(key->value == expected, "Expected %d, actual %d", expected, key->value);
+        if (expected % 3 != 0) {
+            parcIterator_Remove(it);
+        }
+    }
+    parcIterator_Release(&it);
+
+    checkTree(tree);
+    assertTrue(parcTreeMap_Size(tree) == (count + 2) / 3, "Expected %d entries, actual %zd", (count + 2) / 3, parcTreeMap_Size(tree));
+
+    parcTreeMap_Release(&tree);
+}
+
+/*
+ * Make a tree holding the even keys 0, 2, ... 2 * (count - 1), each its own value.
+ */
+static PARCTreeMap *
+_createEvenTree(int count)
+{
+    PARCTreeMap *tree = parcTreeMap_CreateCustom((PARCTreeMap_CustomCompare *) _int_Compare);
+    for (int i = 0; i < count; i++) {
+        _Int *key = _int_Create(2 * i);
+        parcTreeMap_Put(tree, key, key);
+        _int_Release(&key);
+    }
+    return tree;
+}
+
+static int
+_keyValue(PARCKeyValue *entry)
+{
+    return ((_Int *) parcKeyValue_GetKey(entry))->value;
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_GetAtIndex)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+
+    for (int i = 0; i < 1000; i++) {
+        int actual = _keyValue(parcTreeMap_GetAtIndex(tree, i));
+        assertTrue(actual == 2 * i, "Expected %d at index %d, actual %d", 2 * i, i, actual);
+    }
+
+    // Remove the first half of the keys, so that the counts of the branches change.
+    _Int *key = _int_Create(0);
+    for (int i = 0; i < 500; i++) {
+        parcTreeMap_RemoveAndRelease(tree, _int_Set(key, 2 * i));
+    }
+    checkTree(tree);
+    for (int i = 0; i < 500; i++) {
+        int actual = _keyValue(parcTreeMap_GetAtIndex(tree, i));
+        assertTrue(actual == 1000 + 2 * i, "Expected %d at index %d, actual %d", 1000 + 2 * i, i, actual);
+    }
+
+    _int_Release(&key);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE_EXPECTS(Global, PARC_TreeMap_GetAtIndex_OutOfBounds, .event = &LongBowTrapOutOfBounds)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    parcTreeMap_Put(data->testMap2, data->k[1], data->v[1]);
+
+    parcTreeMap_GetAtIndex(data->testMap2, 1);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_Rank)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+
+    _Int *key = _int_Create(0);
+    for (int i = 0; i < 1000; i++) {
+        size_t actual = parcTreeMap_Rank(tree, _int_Set(key, 2 * i));
+        assertTrue(actual == i, "Expected the rank of %d to be %d, actual %zd", 2 * i, i, actual);
+        actual = parcTreeMap_Rank(tree, _int_Set(key, 2 * i + 1));
+        assertTrue(actual == i + 1, "Expected the rank of %d to be %d, actual %zd", 2 * i + 1, i + 1, actual);
+    }
+    assertTrue(parcTreeMap_Rank(tree, _int_Set(key, -1)) == 0, "Expected no keys below -1");
+
+    _int_Release(&key);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_InitCursorFrom)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *from = _int_Create(0);
+    int starts[] = { -5, 0, 501, 1000, 1998, 1999 };
+
+    for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        _int_Set(from, starts[s]);
+        int expected = (starts[s] < 0) ? 0 : starts[s] + (starts[s] % 2);
+
+        PARCCursor cursor;
+        parcTreeMap_InitCursorFrom(tree, from, &cursor);
+        while (parcTreeMap_CursorNext(&cursor)) {
+            _Int *key = parcCursor_GetKey(&cursor);
+            assertTrue(key->value == expected, "Expected %d, actual %d", expected, key->value);
+            expected += 2;
+        }
+        assertTrue(expected == 2000, "Expected the cursor to stop after the last key, at %d", expected);
+    }
+
+    _int_Release(&from);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_SubMap)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *from = _int_Create(100);
+    _Int *to = _int_Create(301);
+    _Int *key = _int_Create(0);
+
+    PARCTreeMap *view = parcTreeMap_SubMap(tree, from, to);
+
+    assertTrue(parcTreeMap_Size(view) == 101, "Expected 101 entries, actual %zd", parcTreeMap_Size(view));
+    assertTrue(_keyValue(parcTreeMap_GetFirstEntry(view)) == 100, "Expected the first key to be 100");
+    assertTrue(_keyValue(parcTreeMap_GetLastEntry(view)) == 300, "Expected the last key to be 300");
+    assertNull(parcTreeMap_Get(view, _int_Set(key, 98)), "Expected no entry below the view");
+    assertNull(parcTreeMap_Get(view, _int_Set(key, 302)), "Expected no entry above the view");
+    assertNotNull(parcTreeMap_Get(view, _int_Set(key, 200)), "Expected an entry in the view");
+
+    assertTrue(_keyValue(parcTreeMap_GetHigherEntry(view, _int_Set(key, 0))) == 100, "Expected the key above 0 to be 100");
+    assertNull(parcTreeMap_GetHigherEntry(view, _int_Set(key, 300)), "Expected no key above 300");
+    assertTrue(_keyValue(parcTreeMap_GetLowerEntry(view, _int_Set(key, 1000))) == 300, "Expected the key below 1000 to be 300");
+    assertNull(parcTreeMap_GetLowerEntry(view, _int_Set(key, 100)), "Expected no key below 100");
+
+    assertTrue(_keyValue(parcTreeMap_GetAtIndex(view, 0)) == 100, "Expected the key at index 0 to be 100");
+    assertTrue(_keyValue(parcTreeMap_GetAtIndex(view, 100)) == 300, "Expected the key at index 100 to be 300");
+    assertTrue(parcTreeMap_Rank(view, _int_Set(key, 150)) == 25, "Expected 25 keys below 150");
+    assertTrue(parcTreeMap_Rank(view, _int_Set(key, 0)) == 0, "Expected no keys below 0");
+    assertTrue(parcTreeMap_Rank(view, _int_Set(key, 1000)) == 101, "Expected every key below 1000");
+
+    int expected = 100;
+    PARCCursor cursor;
+    parcTreeMap_InitCursor(view, &cursor);
+    while (parcTreeMap_CursorNext(&cursor)) {
+        _Int *actual = parcCursor_GetKey(&cursor);
+        assertTrue(actual->value == expected, "Expected %d, actual %d", expected, actual->value);
+        expected += 2;
+    }
+    assertTrue(expected == 302, "Expected the cursor to stop at the end of the view, at %d", expected);
+
+    PARCList *keys = parcTreeMap_AcquireKeys(view);
+    assertTrue(parcList_Size(keys) == 101, "Expected 101 keys, actual %zd", parcList_Size(keys));
+    parcList_Release(&keys);
+
+    parcTreeMap_Release(&view);
+    _int_Release(&key);
+    _int_Release(&from);
+    _int_Release(&to);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_SubMap_Changes)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *from = _int_Create(100);
+    _Int *to = _int_Create(200);
+    _Int *key = _int_Create(0);
+
+    PARCTreeMap *view = parcTreeMap_SubMap(tree, from, to);
+    assertTrue(parcTreeMap_Size(view) == 50, "Expected 50 entries, actual %zd", parcTreeMap_Size(view));
+
+    // Changes to the tree are seen in the view.
+    parcTreeMap_RemoveAndRelease(tree, _int_Set(key, 100));
+    parcTreeMap_RemoveAndRelease(tree, _int_Set(key, 0));
+    assertTrue(parcTreeMap_Size(view) == 49, "Expected 49 entries, actual %zd", parcTreeMap_Size(view));
+    assertTrue(_keyValue(parcTreeMap_GetFirstEntry(view)) == 102, "Expected the first key to be 102");
+
+    // Changes to the view are made to the tree.
+    _Int *odd = _int_Create(101);
+    parcTreeMap_Put(view, odd, odd);
+    assertTrue(parcTreeMap_Get(tree, odd) == odd, "Expected the tree to hold the entry put into the view");
+    _int_Release(&odd);
+
+    assertNull(parcTreeMap_Remove(view, _int_Set(key, 500)), "Expected a key outside the view not to be removed");
+    assertNotNull(parcTreeMap_Get(tree, key), "Expected the tree to keep a key outside the view");
+
+    PARCObject *value = parcTreeMap_Remove(view, _int_Set(key, 150));
+    assertNotNull(value, "Expected a key in the view to be removed");
+    parcObject_Release(&value);
+    assertNull(parcTreeMap_Get(tree, key), "Expected the tree to lose the key removed from the view");
+    assertTrue(parcTreeMap_Size(tree) == 998, "Expected 998 entries, actual %zd", parcTreeMap_Size(tree));
+
+    // Removing through an iterator of the view empties just the view.
+    PARCIterator *it = parcTreeMap_CreateKeyIterator(view);
+    while (parcIterator_HasNext(it)) {
+        parcIterator_Next(it);
+        parcIterator_Remove(it);
+    }
+    parcIterator_Release(&it);
+    assertTrue(parcTreeMap_Size(view) == 0, "Expected an empty view, actual %zd", parcTreeMap_Size(view));
+    assertNull(parcTreeMap_GetFirstEntry(view), "Expected no first entry of an empty view");
+    assertNull(parcTreeMap_GetLastEntry(view), "Expected no last entry of an empty view");
+    assertTrue(parcTreeMap_Size(tree) == 949, "Expected 949 entries, actual %zd", parcTreeMap_Size(tree));
+    checkTree(tree);
+
+    parcTreeMap_Release(&view);
+    _int_Release(&key);
+    _int_Release(&from);
+    _int_Release(&to);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_HeadMap)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *to = _int_Create(500);
+
+    PARCTreeMap *view = parcTreeMap_HeadMap(tree, to);
+    assertTrue(parcTreeMap_Size(view) == 250, "Expected 250 entries, actual %zd", parcTreeMap_Size(view));
+    assertTrue(_keyValue(parcTreeMap_GetFirstEntry(view)) == 0, "Expected the first key to be 0");
+    assertTrue(_keyValue(parcTreeMap_GetLastEntry(view)) == 498, "Expected the last key to be 498");
+    assertNull(parcTreeMap_Get(view, to), "Expected the bound itself to be outside the view");
+
+    parcTreeMap_Release(&view);
+    _int_Release(&to);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_TailMap_Iterator)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *from = _int_Create(1501);
+
+    PARCTreeMap *view = parcTreeMap_TailMap(tree, from);
+    PARCIterator *it = parcTreeMap_CreateKeyIterator(view);
+    parcTreeMap_Release(&view);
+
+    int expected = 1502;
+    while (parcIterator_HasNext(it)) {
+        _Int *key = parcIterator_Next(it);
+        assertTrue(key->value == expected, "Expected %d, actual %d", expected, key->value);
+        expected += 2;
+    }
+    assertTrue(expected == 2000, "Expected the iterator to reach the last key, at %d", expected);
+    parcIterator_Release(&it);
+
+    _int_Release(&from);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_View_OfView)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *a = _int_Create(100);
+    _Int *b = _int_Create(300);
+    _Int *c = _int_Create(500);
+
+    PARCTreeMap *tail = parcTreeMap_TailMap(tree, b);
+    PARCTreeMap *both = parcTreeMap_HeadMap(tail, c);
+    assertTrue(parcTreeMap_Size(both) == 100, "Expected keys 300 to 498, actual size %zd", parcTreeMap_Size(both));
+
+    // The bounds of a view of a view are within those of the first view.
+    PARCTreeMap *wider = parcTreeMap_SubMap(both, a, c);
+    assertTrue(parcTreeMap_Size(wider) == 100, "Expected keys 300 to 498, actual size %zd", parcTreeMap_Size(wider));
+    assertTrue(_keyValue(parcTreeMap_GetFirstEntry(wider)) == 300, "Expected the first key to be 300");
+
+    PARCTreeMap *disjoint = parcTreeMap_HeadMap(tail, a);
+    assertTrue(parcTreeMap_Size(disjoint) == 0, "Expected an empty view, actual size %zd", parcTreeMap_Size(disjoint));
+    assertNull(parcTreeMap_GetFirstEntry(disjoint), "Expected no first entry of an empty view");
+
+    parcTreeMap_Release(&disjoint);
+    parcTreeMap_Release(&wider);
+    parcTreeMap_Release(&both);
+    parcTreeMap_Release(&tail);
+    _int_Release(&a);
+    _int_Release(&b);
+    _int_Release(&c);
+    parcTreeMap_Release(&tree);
+}
+
+LONGBOW_TEST_CASE(Global, PARC_TreeMap_View_Copy)
+{
+    PARCTreeMap *tree = _createEvenTree(1000);
+    _Int *from = _int_Create(100);
+    _Int *to = _int_Create(200);
+
+    PARCTreeMap *view = parcTreeMap_SubMap(tree, from, to);
+    PARCTreeMap *copy = parcTreeMap_Copy(view);
+    checkTree(copy);
+
+    assertTrue(parcTreeMap_Size(copy) == 50, "Expected 50 entries, actual %zd", parcTreeMap_Size(copy));
+    assertTrue(parcTreeMap_Equals(view, copy), "Expected the copy to equal the view");
+    assertFalse(parcTreeMap_Equals(tree, copy), "Expected the copy not to equal the whole tree");
+
+    parcTreeMap_Release(&copy);
+    parcTreeMap_Release(&view);
+    _int_Release(&from);
+    _int_Release(&to);
+    parcTreeMap_Release(&tree);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
     //LONGBOW_RUN_TEST_CASE(Local, PARC_TreeMap_EnsureRemaining_NonEmpty);
+    LONGBOW_RUN_TEST_CASE(Local, _parcTreeMapNode_Put_Split);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -1469,6 +1992,29 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+LONGBOW_TEST_CASE(Local, _parcTreeMapNode_Put_Split)
+{
+    PARCTreeMap *tree = parcTreeMap_CreateCustom((PARCTreeMap_CustomCompare *) _int_Compare);
+
+    for (int i = 0; i < _PARCTreeMap_LeafCapacity; i++) {
+        _Int *key = _int_Create(i);
+        parcTreeMap_Put(tree, key, key);
+        _int_Release(&key);
+    }
+    assertTrue(tree->root->isLeaf, "Expected a full leaf to remain the root");
+
+    _Int *key = _int_Create(_PARCTreeMap_LeafCapacity);
+    parcTreeMap_Put(tree, key, key);
+    _int_Release(&key);
+
+    assertFalse(tree->root->isLeaf, "Expected the root to be split");
+    assertTrue(tree->root->count == 2, "Expected the root to have 2 children, actual %zd", tree->root->count);
+    assertTrue(tree->first->next == tree->last, "Expected two linked leaves");
+    checkTree(tree);
+
+    parcTreeMap_Release(&tree);
+}
+
 LONGBOW_TEST_FIXTURE(Stress)
 {
     // LongBow could use a command line option to enable/disable tests
@@ -1521,7 +2067,7 @@ LONGBOW_TEST_CASE(Stress, PARC_TreeMap_ExerciseRandomSeededSmall)
                 deletes++;
                 parcTreeMap_Remove(tree, (void *) item);
             }
-            rbCheckTree(tree);
+            checkTree(tree);
         }
 
         parcTreeMap_Release(&tree);
@@ -1560,12 +2106,127 @@ LONGBOW_TEST_CASE(Stress, PARC_TreeMap_ExerciseRandomSeeded)
             deletes++;
             parcTreeMap_Remove(tree1, (void *) item);
         }
-        rbCheckTree(tree1);
+        checkTree(tree1);
     }
 
     parcTreeMap_Release(&tree1);
 }
 
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, PARC_TreeMap_LookupAndScan);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static void
+_performanceReport(const char *operation, size_t count, struct timeval *t0, struct timeval *t1)
+{
+    struct timeval elapsed;
+    timersub(t1, t0, &elapsed);
+    double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+    printf("%-16s: %zu entries, nsec/op = %.1f\n", operation, count, sec * 1E9 / count);
+}
+
+LONGBOW_TEST_CASE(Performance, PARC_TreeMap_LookupAndScan)
+{
+    const size_t count = 1 << 20;
+    struct timeval t0, t1;
+
+    _Int **keys = parcMemory_Allocate(count * sizeof(_Int *));
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = _int_Create((int) i);
+    }
+    // Insert and look up in a random order.
+    size_t *order = parcMemory_Allocate(count * sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    for (size_t i = count - 1; i > 0; i--) {
+        size_t j = random() % (i + 1);
+        size_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    PARCTreeMap *tree = parcTreeMap_CreateCustom((PARCTreeMap_CustomCompare *) _int_Compare);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        parcTreeMap_Put(tree, keys[order[i]], keys[order[i]]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("put", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        PARCObject *value = parcTreeMap_Get(tree, keys[order[i]]);
+        assertTrue(value == keys[order[i]], "Expected the value for key %zd", order[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("get", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count - 1; i++) {
+        PARCObject *key = parcTreeMap_GetHigherKey(tree, keys[order[i]]);
+        assertTrue(key == keys[order[i] + 1], "Expected the key after %zd", order[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("get higher key", count - 1, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(parcTreeMap_Rank(tree, keys[order[i]]) == order[i], "Expected the rank of %zd", order[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("rank", count, &t0, &t1);
+
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(parcKeyValue_GetKey(parcTreeMap_GetAtIndex(tree, order[i])) == keys[order[i]], "Expected key %zd", order[i]);
+    }
+    gettimeofday(&t1, NULL);
+    _performanceReport("get at index", count, &t0, &t1);
+
+    size_t visited = 0;
+    gettimeofday(&t0, NULL);
+    for (int pass = 0; pass < 10; pass++) {
+        PARCCursor cursor;
+        parcTreeMap_InitCursor(tree, &cursor);
+        while (parcTreeMap_CursorNext(&cursor)) {
+            visited++;
+        }
+    }
+    gettimeofday(&t1, NULL);
+    assertTrue(visited == 10 * count, "Expected to visit every entry");
+    _performanceReport("cursor scan", visited, &t0, &t1);
+
+    parcTreeMap_Release(&tree);
+
+    gettimeofday(&t0, NULL);
+    tree = parcTreeMap_CreateFromSorted((PARCTreeMap_CustomCompare *) _int_Compare, count,
+                                        (const PARCObject **) keys, (const PARCObject **) keys);
+    gettimeofday(&t1, NULL);
+    _performanceReport("create sorted", count, &t0, &t1);
+    parcTreeMap_Release(&tree);
+
+    for (size_t i = 0; i < count; i++) {
+        _int_Release(&keys[i]);
+    }
+    parcMemory_Deallocate(&keys);
+    parcMemory_Deallocate(&order);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -0,0 +1,43 @@
+/*
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ * Copyright 2015 Palo Alto Research Center, Inc. (PARC), a Xerox company.  All Rights Reserved.
+ * The content of this file, whole or in part, is subject to licensing terms.
+ * If distributing this software, include this License Header Notice in each
+ * file and provide the accompanying LICENSE file.
+ */
+/**
+ * @file internal_parc_ScheduledTask.h
+ * @brief The interface between `PARCScheduledTask` and the `PARCScheduledThreadPool` that queues it.
+ *
+ * While a `PARCScheduledTask` waits in a pool's queue, its link records the pool and the task's position in the queue,
+ * so that cancelling the task can remove it from the queue directly.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016 Palo Alto Research Center, Inc. (PARC), A Xerox Company.  All Rights Reserved.
+ */
+#ifndef libparc_internal_parc_ScheduledTask_h
+#define libparc_internal_parc_ScheduledTask_h
+
+#include <stddef.h>
+
+#include <parc/concurrent/parc_ScheduledTask.h>
+
+struct PARCScheduledThreadPool;
+
+typedef struct internal_parc_scheduled_task_link {
+    // The pool whose queue holds the task, or NULL if the task is not queued. Only that pool may modify the link, under its lock.
+    // The link holds a reference to the pool, and the pool clears it while also holding the task's lock.
+    struct PARCScheduledThreadPool *pool;
+    // The task's position in the pool's queue.
+    size_t index;
+} internal_PARCScheduledTaskLink;
+
+/**
+ * Get the link that a `PARCScheduledThreadPool` uses to find the given task in its queue.
+ *
+ * @param [in] task A pointer to a valid `PARCScheduledTask` instance.
+ *
+ * @return A pointer to the task's link, valid for the lifetime of the task.
+ */
+internal_PARCScheduledTaskLink *internal_parcScheduledTask_GetLink(PARCScheduledTask *task);
+#endif
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <pthread.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_DisplayIndented.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_BufferComposer.h>
+
+#include <parc/concurrent/parc_ConcurrentHashMap.h>
+
+/*
+ * The map is a power-of-two array of segments.
+ * The high-order bits of a key's scrambled hash code select its segment,
+ * and each segment is a Robin Hood open-addressed table guarded by its own reader/writer lock.
+ *
+ * Each segment occupies its own cache lines so that threads working in different segments
+ * do not invalidate each other's copy of a lock.
+ *
+ * When a segment reaches its load limit it rehashes into a table twice the size while holding its write lock.
+ * Only the keys in that one segment are unavailable during the rehash.
+ */
+#define _PARCConcurrentHashMap_DefaultCapacity 64
+#define _PARCConcurrentHashMap_DefaultConcurrency 64
+#define _PARCConcurrentHashMap_MaximumSegmentBits 16
+#define _PARCConcurrentHashMap_MinimumSegmentCapacity 8
+#define _PARCConcurrentHashMap_MaxLoadNumerator 7
+#define _PARCConcurrentHashMap_MaxLoadDenominator 8
+
+typedef struct {
+    PARCObject *key;
+    PARCObject *value;
+    PARCHashCode hashCode;
+    uint32_t probeLength;
+} _PARCConcurrentHashMapSlot;
+
+typedef struct {
+    pthread_rwlock_t lock;
+    _PARCConcurrentHashMapSlot *slots;
+    size_t capacity;
+    unsigned int shift;
+    size_t count;
+} __attribute__((aligned(LEVEL1_DCACHE_LINESIZE))) _PARCConcurrentHashMapSegment;
+
+struct PARCConcurrentHashMap {
+    _PARCConcurrentHashMapSegment *segments;
+    size_t segmentCount;
+    unsigned int segmentBits;
+};
+
+static unsigned int
+_parcConcurrentHashMap_Log2(size_t value)
+{
+    unsigned int result = 0;
+    while (((size_t) 1 << result) < value) {
+        result++;
+    }
+    return result;
+}
+
+static inline size_t
+_parcConcurrentHashMapSegment_Threshold(const _PARCConcurrentHashMapSegment *segment)
+{
+    return (segment->capacity / _PARCConcurrentHashMap_MaxLoadDenominator) * _PARCConcurrentHashMap_MaxLoadNumerator;
+}
+
+/*
+ * The segment index is taken from the high-order bits of one multiplicative scramble of the hash code,
+ * and the home slot within the segment from the high-order bits of another,
+ * so that the keys of one segment are still spread across all of its slots.
+ */
+static inline _PARCConcurrentHashMapSegment *
+_parcConcurrentHashMap_Segment(const PARCConcurrentHashMap *map, PARCHashCode hashCode)
+{
+    size_t index = 0;
+    if (map->segmentBits > 0) {
+        index = (size_t) (((uint64_t) hashCode * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - map->segmentBits));
+    }
+    return &map->segments[index];
+}
+
+static inline size_t
+_parcConcurrentHashMapSegment_HomeSlot(const _PARCConcurrentHashMapSegment *segment, PARCHashCode hashCode)
+{
+    return (size_t) (((uint64_t) hashCode * UINT64_C(0xC2B2AE3D27D4EB4F)) >> segment->shift);
+}
+
+static void
+_parcConcurrentHashMapSegment_AllocateSlots(_PARCConcurrentHashMapSegment *segment, size_t capacity)
+{
+    unsigned int log2 = _parcConcurrentHashMap_Log2(capacity);
+
+    segment->capacity = (size_t) 1 << log2;
+    segment->shift = 64 - log2;
+    segment->count = 0;
+    segment->slots = parcMemory_AllocateAndClear(segment->capacity * sizeof(_PARCConcurrentHashMapSlot));
+    trapOutOfMemoryIf(segment->slots == NULL, "Cannot allocate %zu slots for PARCConcurrentHashMap", segment->capacity);
+}
+
+static void
+_parcConcurrentHashMapSegment_Init(_PARCConcurrentHashMapSegment *segment, size_t capacity)
+{
+    pthread_rwlock_init(&segment->lock, NULL);
+    _parcConcurrentHashMapSegment_AllocateSlots(segment, capacity);
+}
+
+static void
+_parcConcurrentHashMapSegment_Fini(_PARCConcurrentHashMapSegment *segment)
+{
+    for (size_t i = 0; i < segment->capacity; i++) {
+        _PARCConcurrentHashMapSlot *slot = &segment->slots[i];
+        if (slot->probeLength != 0) {
+            parcObject_Release(&slot->key);
+            parcObject_Release(&slot->value);
+        }
+    }
+    parcMemory_Deallocate(&segment->slots);
+    pthread_rwlock_destroy(&segment->lock);
+}
+
+/*
+ * Insert an entry that is known not to be in the segment, which must have room for it.
+ * The segment takes ownership of the references to the key and value.
+ */
+static void
+_parcConcurrentHashMapSegment_Place(_PARCConcurrentHashMapSegment *segment, PARCObject *key, PARCObject *value, PARCHashCode hashCode)
+{
+    size_t mask = segment->capacity - 1;
+    size_t index = _parcConcurrentHashMapSegment_HomeSlot(segment, hashCode);
+
+    _PARCConcurrentHashMapSlot entry = { .key = key, .value = value, .hashCode = hashCode, .probeLength = 1 };
+
+    for (;;) {
+        _PARCConcurrentHashMapSlot *slot = &segment->slots[index];
+        if (slot->probeLength == 0) {
+            *slot = entry;
+            segment->count++;
+            return;
+        }
+        if (slot->probeLength < entry.probeLength) {
+            _PARCConcurrentHashMapSlot displaced = *slot;
+            *slot = entry;
+            entry = displaced;
+        }
+        index = (index + 1) & mask;
+        entry.probeLength++;
+    }
+}
+
+static void
+_parcConcurrentHashMapSegment_Grow(_PARCConcurrentHashMapSegment *segment)
+{
+    _PARCConcurrentHashMapSlot *slots = segment->slots;
+    size_t capacity = segment->capacity;
+
+    _parcConcurrentHashMapSegment_AllocateSlots(segment, capacity * 2);
+
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].probeLength != 0) {
+            _parcConcurrentHashMapSegment_Place(segment, slots[i].key, slots[i].value, slots[i].hashCode);
+        }
+    }
+
+    parcMemory_Deallocate(&slots);
+}
+
+static void
+_parcConcurrentHashMapSegment_Insert(_PARCConcurrentHashMapSegment *segment, PARCObject *key, PARCObject *value, PARCHashCode hashCode)
+{
+    if (segment->count + 1 > _parcConcurrentHashMapSegment_Threshold(segment)) {
+        _parcConcurrentHashMapSegment_Grow(segment);
+    }
+    _parcConcurrentHashMapSegment_Place(segment, key, value, hashCode);
+}
+
+static _PARCConcurrentHashMapSlot *
+_parcConcurrentHashMapSegment_Find(const _PARCConcurrentHashMapSegment *segment, const PARCObject *key, PARCHashCode hashCode)
+{
+    size_t mask = segment->capacity - 1;
+    size_t index = _parcConcurrentHashMapSegment_HomeSlot(segment, hashCode);
+
+    for (uint32_t probeLength = 1; segment->slots[index].probeLength >= probeLength; probeLength++) {
+        _PARCConcurrentHashMapSlot *slot = &segment->slots[index];
+        if (slot->hashCode == hashCode) {
+            if (slot->key == key || parcObject_Equals(key, slot->key)) {
+                return slot;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/*
+ * Unlink the entry in the given slot, shifting the rest of its probe sequence back by one slot.
+ * The caller takes ownership of the entry's key and value references.
+ */
+static void
+_parcConcurrentHashMapSegment_RemoveAt(_PARCConcurrentHashMapSegment *segment, size_t index)
+{
+    size_t mask = segment->capacity - 1;
+
+    size_t next = (index + 1) & mask;
+    while (segment->slots[next].probeLength > 1) {
+        segment->slots[index] = segment->slots[next];
+        segment->slots[index].probeLength--;
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    segment->slots[index] = (_PARCConcurrentHashMapSlot) { .key = NULL, .value = NULL, .hashCode = 0, .probeLength = 0 };
+    segment->count--;
+}
+
+static PARCConcurrentHashMap *
+_parcConcurrentHashMap_Init(PARCConcurrentHashMap *map, size_t capacity, size_t concurrencyLevel)
+{
+    if (concurrencyLevel == 0) {
+        concurrencyLevel = _PARCConcurrentHashMap_DefaultConcurrency;
+    }
+
+    map->segmentBits = _parcConcurrentHashMap_Log2(concurrencyLevel);
+    if (map->segmentBits > _PARCConcurrentHashMap_MaximumSegmentBits) {
+        map->segmentBits = _PARCConcurrentHashMap_MaximumSegmentBits;
+    }
+    map->segmentCount = (size_t) 1 << map->segmentBits;
+
+    size_t segmentCapacity = _PARCConcurrentHashMap_MinimumSegmentCapacity;
+    size_t perSegment = (capacity + map->segmentCount - 1) / map->segmentCount;
+    while ((segmentCapacity / _PARCConcurrentHashMap_MaxLoadDenominator) * _PARCConcurrentHashMap_MaxLoadNumerator < perSegment) {
+        segmentCapacity <<= 1;
+    }
+
+    void *segments;
+    int failure = parcMemory_MemAlign(&segments, LEVEL1_DCACHE_LINESIZE, map->segmentCount * sizeof(_PARCConcurrentHashMapSegment));
+    trapOutOfMemoryIf(failure != 0, "Cannot allocate %zu segments for PARCConcurrentHashMap", map->segmentCount);
+    map->segments = segments;
+
+    for (size_t i = 0; i < map->segmentCount; i++) {
+        _parcConcurrentHashMapSegment_Init(&map->segments[i], segmentCapacity);
+    }
+
+    return map;
+}
+
+static void
+_parcConcurrentHashMap_Finalize(PARCConcurrentHashMap **instancePtr)
+{
+    assertNotNull(instancePtr, "Parameter must be a non-null pointer to a PARCConcurrentHashMap pointer.");
+    PARCConcurrentHashMap *map = *instancePtr;
+
+    parcConcurrentHashMap_OptionalAssertValid(map);
+
+    for (size_t i = 0; i < map->segmentCount; i++) {
+        _parcConcurrentHashMapSegment_Fini(&map->segments[i]);
+    }
+    parcMemory_Deallocate(&map->segments);
+}
+
+parcObject_ImplementAcquire(parcConcurrentHashMap, PARCConcurrentHashMap);
+
+parcObject_ImplementRelease(parcConcurrentHashMap, PARCConcurrentHashMap);
+
+parcObject_ExtendPARCObject(PARCConcurrentHashMap, _parcConcurrentHashMap_Finalize, parcConcurrentHashMap_Copy,
+                            parcConcurrentHashMap_ToString, NULL, NULL, NULL, NULL);
+
+void
+parcConcurrentHashMap_AssertValid(const PARCConcurrentHashMap *instance)
+{
+    assertTrue(parcConcurrentHashMap_IsValid(instance),
+               "PARCConcurrentHashMap is not valid.");
+}
+
+PARCConcurrentHashMap *
+parcConcurrentHashMap_CreateCapacity(size_t capacity, size_t concurrencyLevel)
+{
+    PARCConcurrentHashMap *result = parcObject_CreateInstance(PARCConcurrentHashMap);
+
+    if (result != NULL) {
+        _parcConcurrentHashMap_Init(result, capacity, concurrencyLevel);
+    }
+
+    return result;
+}
+
+PARCConcurrentHashMap *
+parcConcurrentHashMap_Create(void)
+{
+    return parcConcurrentHashMap_CreateCapacity(_PARCConcurrentHashMap_DefaultCapacity, _PARCConcurrentHashMap_DefaultConcurrency);
+}
+
+PARCConcurrentHashMap *
+parcConcurrentHashMap_Copy(const PARCConcurrentHashMap *original)
+{
+    parcConcurrentHashMap_OptionalAssertValid(original);
+
+    PARCConcurrentHashMap *result = parcConcurrentHashMap_CreateCapacity(0, original->segmentCount);
+
+    for (size_t i = 0; i < original->segmentCount; i++) {
+        _PARCConcurrentHashMapSegment *from = &original->segments[i];
+        _PARCConcurrentHashMapSegment *to = &result->segments[i];
+
+        pthread_rwlock_rdlock(&from->lock);
+        for (size_t j = 0; j < from->capacity; j++) {
+            _PARCConcurrentHashMapSlot *slot = &from->slots[j];
+            if (slot->probeLength != 0) {
+                _parcConcurrentHashMapSegment_Insert(to, parcObject_Copy(slot->key), parcObject_Acquire(slot->value), slot->hashCode);
+            }
+        }
+        pthread_rwlock_unlock(&from->lock);
+    }
+
+    return result;
+}
+
+void
+parcConcurrentHashMap_Display(const PARCConcurrentHashMap *map, int indentation)
+{
+    parcDisplayIndented_PrintLine(indentation, "PARCConcurrentHashMap@%p {", map);
+    for (size_t i = 0; i < map->segmentCount; i++) {
+        _PARCConcurrentHashMapSegment *segment = &map->segments[i];
+        pthread_rwlock_rdlock(&segment->lock);
+        parcDisplayIndented_PrintLine(indentation + 1, "segment[%zu] { .count=%zu .capacity=%zu }", i, segment->count, segment->capacity);
+        pthread_rwlock_unlock(&segment->lock);
+    }
+    parcDisplayIndented_PrintLine(indentation, "}");
+}
+
+bool
+parcConcurrentHashMap_IsValid(const PARCConcurrentHashMap *map)
+{
+    bool result = false;
+
+    if (map != NULL) {
+        result = map->segments != NULL && map->segmentCount == ((size_t) 1 << map->segmentBits);
+    }
+
+    return result;
+}
+
+PARCBufferComposer *
+parcConcurrentHashMap_BuildString(const PARCConcurrentHashMap *map, PARCBufferComposer *composer)
+{
+    parcBufferComposer_Format(composer, "PARCConcurrentHashMap@%p { .segments=%zu .size=%zu }",
+                              (void *) map, map->segmentCount, parcConcurrentHashMap_Size(map));
+
+    return composer;
+}
+
+char *
+parcConcurrentHashMap_ToString(const PARCConcurrentHashMap *map)
+{
+    char *result = NULL;
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    if (composer != NULL) {
+        parcConcurrentHashMap_BuildString(map, composer);
+        result = parcBufferComposer_ToString(composer);
+        parcBufferComposer_Release(&composer);
+    }
+
+    return result;
+}
+
+PARCConcurrentHashMap *
+parcConcurrentHashMap_Put(PARCConcurrentHashMap *map, const PARCObject *key, const PARCObject *value)
+{
+    parcObject_OptionalAssertValid(key);
+    parcObject_OptionalAssertValid(value);
+
+    PARCHashCode hashCode = parcObject_HashCode(key);
+    _PARCConcurrentHashMapSegment *segment = _parcConcurrentHashMap_Segment(map, hashCode);
+
+    PARCObject *previous = NULL;
+
+    pthread_rwlock_wrlock(&segment->lock);
+    _PARCConcurrentHashMapSlot *slot = _parcConcurrentHashMapSegment_Find(segment, key, hashCode);
+    if (slot != NULL) {
+        previous = slot->value;
+        slot->value = parcObject_Acquire(value);
+    } else {
+        _parcConcurrentHashMapSegment_Insert(segment, parcObject_Copy(key), parcObject_Acquire(value), hashCode);
+    }
+    pthread_rwlock_unlock(&segment->lock);
+
+    // Release the displaced value outside of the lock, its finalizer may be arbitrarily expensive.
+    if (previous != NULL) {
+        parcObject_Release(&previous);
+    }
+
+    return map;
+}
+
+PARCObject *
+parcConcurrentHashMap_Get(const PARCConcurrentHashMap *map, const PARCObject *key)
+{
+    PARCObject *result = NULL;
+
+    PARCHashCode hashCode = parcObject_HashCode(key);
+    _PARCConcurrentHashMapSegment *segment = _parcConcurrentHashMap_Segment(map, hashCode);
+
+    pthread_rwlock_rdlock(&segment->lock);
+    _PARCConcurrentHashMapSlot *slot = _parcConcurrentHashMapSegment_Find(segment, key, hashCode);
+    if (slot != NULL) {
+        result = parcObject_Acquire(slot->value);
+    }
+    pthread_rwlock_unlock(&segment->lock);
+
+    return result;
+}
+
+PARCObject *
+parcConcurrentHashMap_ComputeIfAbsent(PARCConcurrentHashMap *map, const PARCObject *key,
+                                      PARCConcurrentHashMap_MappingFunction *mappingFunction, void *parameter)
+{
+    PARCObject *result = parcConcurrentHashMap_Get(map, key);
+
+    if (result == NULL) {
+        PARCHashCode hashCode = parcObject_HashCode(key);
+        _PARCConcurrentHashMapSegment *segment = _parcConcurrentHashMap_Segment(map, hashCode);
+
+        pthread_rwlock_wrlock(&segment->lock);
+        // Another thread may have created the value between the read and the write lock.
+        _PARCConcurrentHashMapSlot *slot = _parcConcurrentHashMapSegment_Find(segment, key, hashCode);
+        if (slot != NULL) {
+            result = parcObject_Acquire(slot->value);
+        } else {
+            result = mappingFunction(key, parameter);
+            if (result != NULL) {
+                _parcConcurrentHashMapSegment_Insert(segment, parcObject_Copy(key), parcObject_Acquire(result), hashCode);
+            }
+        }
+        pthread_rwlock_unlock(&segment->lock);
+    }
+
+    return result;
+}
+
+bool
+parcConcurrentHashMap_Remove(PARCConcurrentHashMap *map, const PARCObject *key)
+{
+    PARCObject *removedKey = NULL;
+    PARCObject *removedValue = NULL;
+
+    PARCHashCode hashCode = parcObject_HashCode(key);
+    _PARCConcurrentHashMapSegment *segment = _parcConcurrentHashMap_Segment(map, hashCode);
+
+    pthread_rwlock_wrlock(&segment->lock);
+    _PARCConcurrentHashMapSlot *slot = _parcConcurrentHashMapSegment_Find(segment, key, hashCode);
+    if (slot != NULL) {
+        removedKey = slot->key;
+        removedValue = slot->value;
+        _parcConcurrentHashMapSegment_RemoveAt(segment, slot - segment->slots);
+    }
+    pthread_rwlock_unlock(&segment->lock);
+
+    bool result = false;
+    if (removedKey != NULL) {
+        parcObject_Release(&removedKey);
+        parcObject_Release(&removedValue);
+        result = true;
+    }
+
+    return result;
+}
+
+bool
+parcConcurrentHashMap_Contains(const PARCConcurrentHashMap *map, const PARCObject *key)
+{
+    PARCHashCode hashCode = parcObject_HashCode(key);
+    _PARCConcurrentHashMapSegment *segment = _parcConcurrentHashMap_Segment(map, hashCode);
+
+    pthread_rwlock_rdlock(&segment->lock);
+    bool result = _parcConcurrentHashMapSegment_Find(segment, key, hashCode) != NULL;
+    pthread_rwlock_unlock(&segment->lock);
+
+    return result;
+}
+
+size_t
+parcConcurrentHashMap_Size(const PARCConcurrentHashMap *map)
+{
+    parcConcurrentHashMap_OptionalAssertValid(map);
+
+    size_t result = 0;
+    for (size_t i = 0; i < map->segmentCount; i++) {
+        _PARCConcurrentHashMapSegment *segment = &map->segments[i];
+        pthread_rwlock_rdlock(&segment->lock);
+        result += segment->count;
+        pthread_rwlock_unlock(&segment->lock);
+    }
+
+    return result;
+}
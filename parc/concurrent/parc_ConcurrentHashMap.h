@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_ConcurrentHashMap.h
+ * @brief A map of PARCObject keys to PARCObject values that is safe to share between threads.
+ *
+ * The map is divided into a power-of-two number of independent segments.
+ * Each segment is an open-addressed hash table guarded by its own reader/writer lock,
+ * and a key always lives in the segment selected by its hash code.
+ * Readers of different segments never touch the same lock,
+ * and readers of the same segment proceed in parallel with each other.
+ * A segment that fills up grows while holding only its own write lock,
+ * so the rest of the map remains available while it does.
+ *
+ * Keys are compared with `parcObject_HashCode` and `parcObject_Equals`.
+ * Like `PARCHashMap`, the map stores a copy of each key and a reference to each value.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_ConcurrentHashMap
+#define PARCLibrary_parc_ConcurrentHashMap
+#include <stdbool.h>
+
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_HashCode.h>
+#include <parc/algol/parc_Object.h>
+
+struct PARCConcurrentHashMap;
+typedef struct PARCConcurrentHashMap PARCConcurrentHashMap;
+
+/**
+ * The signature of the function invoked by `parcConcurrentHashMap_ComputeIfAbsent` to create a missing value.
+ *
+ * @param [in] key The key for which a value is needed.
+ * @param [in] parameter The parameter given to `parcConcurrentHashMap_ComputeIfAbsent`.
+ *
+ * @return A new reference to the value to associate with @p key, or NULL to leave the map unchanged.
+ */
+typedef PARCObject *(PARCConcurrentHashMap_MappingFunction)(const PARCObject *key, void *parameter);
+
+/**
+ * Increase the number of references to a `PARCConcurrentHashMap` instance.
+ *
+ * Note that new `PARCConcurrentHashMap` is not created,
+ * only that the given `PARCConcurrentHashMap` reference count is incremented.
+ * Discard the reference by invoking `parcConcurrentHashMap_Release`.
+ *
+ * @param [in] instance A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * @return The same value as @p instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     PARCConcurrentHashMap *b = parcConcurrentHashMap_Acquire(a);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ *     parcConcurrentHashMap_Release(&b);
+ * }
+ * @endcode
+ */
+PARCConcurrentHashMap *parcConcurrentHashMap_Acquire(const PARCConcurrentHashMap *instance);
+
+#ifdef PARCLibrary_DISABLE_VALIDATION
+#  define parcConcurrentHashMap_OptionalAssertValid(_instance_)
+#else
+#  define parcConcurrentHashMap_OptionalAssertValid(_instance_) parcConcurrentHashMap_AssertValid(_instance_)
+#endif
+
+/**
+ * Assert that the given `PARCConcurrentHashMap` instance is valid.
+ *
+ * @param [in] instance A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     parcConcurrentHashMap_AssertValid(a);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+void parcConcurrentHashMap_AssertValid(const PARCConcurrentHashMap *instance);
+
+/**
+ * Create an instance of `PARCConcurrentHashMap` with a default capacity and concurrency level.
+ *
+ * @return non-NULL A pointer to a valid PARCConcurrentHashMap instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+PARCConcurrentHashMap *parcConcurrentHashMap_Create(void);
+
+/**
+ * Create an instance of `PARCConcurrentHashMap` sized for the given number of entries.
+ *
+ * The map is divided into at least @p concurrencyLevel segments (rounded up to a power of two),
+ * each with its own lock.
+ * A concurrency level close to the number of threads that update the map keeps them from contending for the same lock.
+ *
+ * @param [in] capacity The number of entries the map is expected to hold.
+ * @param [in] concurrencyLevel The expected number of concurrent writers. Zero selects the default.
+ *
+ * @return non-NULL A pointer to a valid PARCConcurrentHashMap instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_CreateCapacity(10000, 16);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+PARCConcurrentHashMap *parcConcurrentHashMap_CreateCapacity(size_t capacity, size_t concurrencyLevel);
+
+/**
+ * Create an independent copy the given `PARCConcurrentHashMap`
+ *
+ * A new map is created as a complete copy of the original.
+ * Each segment of the original is read-locked while it is copied,
+ * so the copy is consistent per segment but not necessarily a snapshot of the whole map.
+ *
+ * @param [in] original A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * @return NULL Memory could not be allocated.
+ * @return non-NULL A pointer to a new `PARCConcurrentHashMap` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     PARCConcurrentHashMap *copy = parcConcurrentHashMap_Copy(a);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ *     parcConcurrentHashMap_Release(&copy);
+ * }
+ * @endcode
+ */
+PARCConcurrentHashMap *parcConcurrentHashMap_Copy(const PARCConcurrentHashMap *original);
+
+/**
+ * Print a human readable representation of the given `PARCConcurrentHashMap`.
+ *
+ * @param [in] instance A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] indentation The indentation level to use for printing.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     parcConcurrentHashMap_Display(a, 0);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+void parcConcurrentHashMap_Display(const PARCConcurrentHashMap *instance, int indentation);
+
+/**
+ * Determine if an instance of `PARCConcurrentHashMap` is valid.
+ *
+ * Valid means the internal state of the type is consistent with its required current or future behaviour.
+ * This may include the validation of internal instances of types.
+ *
+ * @param [in] instance A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * @return true The instance is valid.
+ * @return false The instance is not valid.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     if (parcConcurrentHashMap_IsValid(a)) {
+ *         printf("Instance is valid.\n");
+ *     }
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+bool parcConcurrentHashMap_IsValid(const PARCConcurrentHashMap *instance);
+
+/**
+ * Release a previously acquired reference to the given `PARCConcurrentHashMap` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * If the invocation causes the last reference to the instance to be released,
+ * the instance is deallocated and the instance's implementation will perform
+ * additional cleanup and release other privately held references.
+ *
+ * @param [in,out] instancePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ * }
+ * @endcode
+ */
+void parcConcurrentHashMap_Release(PARCConcurrentHashMap **instancePtr);
+
+/**
+ * Append a representation of the specified `PARCConcurrentHashMap` instance to the given `PARCBufferComposer`.
+ *
+ * @param [in] map A pointer to a valid `PARCConcurrentHashMap` instance.
+ * @param [in,out] composer A pointer to a valid `PARCBufferComposer` instance.
+ *
+ * @return The value of @p composer.
+ */
+PARCBufferComposer *parcConcurrentHashMap_BuildString(const PARCConcurrentHashMap *map, PARCBufferComposer *composer);
+
+/**
+ * Produce a null-terminated string representation of the specified `PARCConcurrentHashMap`.
+ *
+ * The result must be freed by the caller via {@link parcMemory_Deallocate}.
+ *
+ * @param [in] instance A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * @return NULL Cannot allocate memory.
+ * @return non-NULL A pointer to an allocated, null-terminated C string that must be deallocated via {@link parcMemory_Deallocate}.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCConcurrentHashMap *a = parcConcurrentHashMap_Create();
+ *
+ *     char *string = parcConcurrentHashMap_ToString(a);
+ *
+ *     parcConcurrentHashMap_Release(&a);
+ *
+ *     parcMemory_Deallocate(&string);
+ * }
+ * @endcode
+ */
+char *parcConcurrentHashMap_ToString(const PARCConcurrentHashMap *instance);
+
+/**
+ * Associate @p value with @p key, replacing any previous value.
+ *
+ * The map stores a copy of @p key and acquires a reference to @p value.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] key A pointer to a valid PARCObject key.
+ * @param [in] value A pointer to a valid PARCObject value.
+ *
+ * @return The value of @p map.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcConcurrentHashMap_Put(map, key, value);
+ * }
+ * @endcode
+ */
+PARCConcurrentHashMap *parcConcurrentHashMap_Put(PARCConcurrentHashMap *map, const PARCObject *key, const PARCObject *value);
+
+/**
+ * Get the value associated with @p key.
+ *
+ * Because another thread may remove or replace the entry at any time,
+ * the result is a new reference that the caller must release.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] key A pointer to a valid PARCObject key.
+ *
+ * @return NULL The map has no value for @p key.
+ * @return non-NULL A new reference to the value associated with @p key.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObject *value = parcConcurrentHashMap_Get(map, key);
+ *     if (value != NULL) {
+ *         ...
+ *         parcObject_Release(&value);
+ *     }
+ * }
+ * @endcode
+ */
+PARCObject *parcConcurrentHashMap_Get(const PARCConcurrentHashMap *map, const PARCObject *key);
+
+/**
+ * Get the value associated with @p key, creating it with @p mappingFunction if there is none.
+ *
+ * The mapping function is invoked at most once per absent key,
+ * with the key's segment write-locked so that no other thread can create a competing value.
+ * It must not use @p map.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] key A pointer to a valid PARCObject key.
+ * @param [in] mappingFunction The function that produces a new reference to the value for an absent key.
+ * @param [in] parameter An arbitrary value passed to @p mappingFunction.
+ *
+ * @return NULL The key was absent and @p mappingFunction returned NULL.
+ * @return non-NULL A new reference to the value associated with @p key, which the caller must release.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCObject *value = parcConcurrentHashMap_ComputeIfAbsent(map, key, _createValue, NULL);
+ *     ...
+ *     parcObject_Release(&value);
+ * }
+ * @endcode
+ */
+PARCObject *parcConcurrentHashMap_ComputeIfAbsent(PARCConcurrentHashMap *map, const PARCObject *key,
+                                                  PARCConcurrentHashMap_MappingFunction *mappingFunction, void *parameter);
+
+/**
+ * Remove the entry for @p key, if any.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] key A pointer to a valid PARCObject key.
+ *
+ * @return true The entry was removed.
+ * @return false The map has no entry for @p key.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcConcurrentHashMap_Remove(map, key)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool parcConcurrentHashMap_Remove(PARCConcurrentHashMap *map, const PARCObject *key);
+
+/**
+ * Determine if the map has an entry for @p key.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ * @param [in] key A pointer to a valid PARCObject key.
+ *
+ * @return true The map has an entry for @p key.
+ * @return false The map has no entry for @p key.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcConcurrentHashMap_Contains(map, key)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool parcConcurrentHashMap_Contains(const PARCConcurrentHashMap *map, const PARCObject *key);
+
+/**
+ * Get the number of entries in the map.
+ *
+ * The segments are counted one at a time,
+ * so while other threads are modifying the map the result is only an estimate.
+ *
+ * @param [in] map A pointer to a valid PARCConcurrentHashMap instance.
+ *
+ * @return The number of entries in the map.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t size = parcConcurrentHashMap_Size(map);
+ * }
+ * @endcode
+ */
+size_t parcConcurrentHashMap_Size(const PARCConcurrentHashMap *map);
+#endif
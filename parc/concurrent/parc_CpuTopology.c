@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * The topology is read afresh on every call, as CPUs can be taken offline and brought back while a program runs.
+ * Callers that place many threads should read it once and keep the sets they need.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <config.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#if __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <parc/concurrent/parc_CpuTopology.h>
+
+// The largest CPU number a PARCBitVector can hold.
+#define _PARCCpuTopology_MaximumCpu 8191
+
+// The number of nodes the memory policy mask can name.
+#define _PARCCpuTopology_MaximumNodes 1024
+
+#define _PARCCpuTopology_CpuDirectory "/sys/devices/system/cpu"
+#define _PARCCpuTopology_NodeDirectory "/sys/devices/system/node"
+
+/*
+ * Read a short sysfs file into the given buffer, which is nul-terminated.
+ */
+static bool
+_parcCpuTopology_ReadFile(const char *path, char *buffer, size_t length)
+{
+    bool result = false;
+
+    FILE *file = fopen(path, "r");
+    if (file != NULL) {
+        size_t count = fread(buffer, 1, length - 1, file);
+        buffer[count] = 0;
+        result = ferror(file) == 0;
+        fclose(file);
+    }
+    return result;
+}
+
+static PARCBitVector *
+_parcCpuTopology_ReadCpuList(const char *path)
+{
+    PARCBitVector *result = NULL;
+
+    // A list of 8192 single CPUs is about 40 kilobytes, but sysfs lists are ranges and rarely longer than a line.
+    char buffer[4096];
+    if (_parcCpuTopology_ReadFile(path, buffer, sizeof(buffer))) {
+        result = parcCpuTopology_ParseCpuList(buffer);
+    }
+    return result;
+}
+
+static int
+_parcCpuTopology_ReadInteger(const char *path)
+{
+    int result = -1;
+
+    char buffer[32];
+    if (_parcCpuTopology_ReadFile(path, buffer, sizeof(buffer))) {
+        char *end;
+        long value = strtol(buffer, &end, 10);
+        if (end != buffer && value >= 0 && value <= INT32_MAX) {
+            result = (int) value;
+        }
+    }
+    return result;
+}
+
+static bool
+_parcCpuTopology_IsOnline(int cpu)
+{
+    bool result = false;
+
+    if (cpu >= 0 && cpu <= _PARCCpuTopology_MaximumCpu) {
+        PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+        result = parcBitVector_Get(online, cpu) == 1;
+        parcBitVector_Release(&online);
+    }
+    return result;
+}
+
+PARCBitVector *
+parcCpuTopology_ParseCpuList(const char *list)
+{
+    assertNotNull(list, "The list must not be NULL.");
+
+    PARCBitVector *result = parcBitVector_Create();
+
+    const char *p = list;
+    while (isspace((unsigned char) *p)) {
+        p++;
+    }
+    while (*p != 0 && result != NULL) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p || !isdigit((unsigned char) *p)) {
+            parcBitVector_Release(&result);
+            break;
+        }
+        p = end;
+        if (*p == '-') {
+            p++;
+            if (!isdigit((unsigned char) *p)) {
+                parcBitVector_Release(&result);
+                break;
+            }
+            last = strtol(p, &end, 10);
+            p = end;
+        }
+        if (first > last || last > _PARCCpuTopology_MaximumCpu) {
+            parcBitVector_Release(&result);
+            break;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            parcBitVector_Set(result, (unsigned) cpu);
+        }
+
+        if (*p == ',') {
+            p++;
+            if (!isdigit((unsigned char) *p)) {
+                parcBitVector_Release(&result);
+            }
+        } else {
+            while (isspace((unsigned char) *p)) {
+                p++;
+            }
+            if (*p != 0) {
+                parcBitVector_Release(&result);
+            }
+        }
+    }
+
+    return result;
+}
+
+PARCBitVector *
+parcCpuTopology_GetOnlineCpus(void)
+{
+    PARCBitVector *result = NULL;
+#if __linux__
+    result = _parcCpuTopology_ReadCpuList(_PARCCpuTopology_CpuDirectory "/online");
+#endif
+    if (result == NULL) {
+        result = parcBitVector_Create();
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < count && cpu <= _PARCCpuTopology_MaximumCpu; cpu++) {
+            parcBitVector_Set(result, (unsigned) cpu);
+        }
+    }
+    return result;
+}
+
+unsigned
+parcCpuTopology_GetNodeCount(void)
+{
+    unsigned result = 0;
+#if __linux__
+    PARCBitVector *nodes = _parcCpuTopology_ReadCpuList(_PARCCpuTopology_NodeDirectory "/online");
+    if (nodes != NULL) {
+        result = parcBitVector_NumberOfBitsSet(nodes);
+        parcBitVector_Release(&nodes);
+    }
+#endif
+    return result == 0 ? 1 : result;
+}
+
+PARCBitVector *
+parcCpuTopology_GetNodeCpus(unsigned node)
+{
+    PARCBitVector *result = NULL;
+#if __linux__
+    char path[128];
+    snprintf(path, sizeof(path), _PARCCpuTopology_NodeDirectory "/node%u/cpulist", node);
+    result = _parcCpuTopology_ReadCpuList(path);
+
+    if (result == NULL && access(_PARCCpuTopology_NodeDirectory, F_OK) == 0) {
+        // The kernel knows about nodes, and this is not one of them.
+        result = parcBitVector_Create();
+    }
+#endif
+    if (result == NULL) {
+        result = (node == 0) ? parcCpuTopology_GetOnlineCpus() : parcBitVector_Create();
+    }
+    return result;
+}
+
+int
+parcCpuTopology_GetNodeOfCpu(int cpu)
+{
+    int result = -1;
+
+    if (_parcCpuTopology_IsOnline(cpu)) {
+        result = 0;
+#if __linux__
+        // The CPU's directory has a link named for its node.
+        char path[128];
+        snprintf(path, sizeof(path), _PARCCpuTopology_CpuDirectory "/cpu%d", cpu);
+        DIR *directory = opendir(path);
+        if (directory != NULL) {
+            struct dirent *entry;
+            while ((entry = readdir(directory)) != NULL) {
+                int node;
+                char trailing;
+                if (sscanf(entry->d_name, "node%d%c", &node, &trailing) == 1 && node >= 0) {
+                    result = node;
+                    break;
+                }
+            }
+            closedir(directory);
+        }
+#endif
+    }
+    return result;
+}
+
+int
+parcCpuTopology_GetPackageOfCpu(int cpu)
+{
+    int result = -1;
+#if __linux__
+    if (cpu >= 0) {
+        char path[128];
+        snprintf(path, sizeof(path), _PARCCpuTopology_CpuDirectory "/cpu%d/topology/physical_package_id", cpu);
+        result = _parcCpuTopology_ReadInteger(path);
+    }
+#endif
+    return result;
+}
+
+int
+parcCpuTopology_GetCoreOfCpu(int cpu)
+{
+    int result = -1;
+#if __linux__
+    if (cpu >= 0) {
+        char path[128];
+        snprintf(path, sizeof(path), _PARCCpuTopology_CpuDirectory "/cpu%d/topology/core_id", cpu);
+        result = _parcCpuTopology_ReadInteger(path);
+    }
+#endif
+    return result;
+}
+
+int
+parcCpuTopology_GetCurrentCpu(void)
+{
+    int result = -1;
+#if __linux__
+    result = sched_getcpu();
+#endif
+    return result;
+}
+
+bool
+parcCpuTopology_AdviseNode(void *memory, size_t length, int node)
+{
+    bool result = false;
+#if __linux__ && defined(SYS_mbind)
+    if (node >= 0 && node < _PARCCpuTopology_MaximumNodes) {
+        uintptr_t pageSize = (uintptr_t) sysconf(_SC_PAGESIZE);
+        uintptr_t start = ((uintptr_t) memory + pageSize - 1) & ~(pageSize - 1);
+        uintptr_t end = ((uintptr_t) memory + length) & ~(pageSize - 1);
+
+        if (start < end) {
+            unsigned long mask[_PARCCpuTopology_MaximumNodes / (8 * sizeof(unsigned long))] = { 0 };
+            mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+
+            // The kernel reads one bit fewer than it is told the mask holds.
+            long status = syscall(SYS_mbind, start, end - start, MPOL_PREFERRED, mask, _PARCCpuTopology_MaximumNodes + 1, MPOL_MF_MOVE);
+            result = (status == 0);
+        }
+    }
+#endif
+    return result;
+}
+
+void *
+parcCpuTopology_AllocateOnNode(size_t size, int node)
+{
+    void *result = NULL;
+
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t length = (size + pageSize - 1) & ~(pageSize - 1);
+    if (parcMemory_MemAlign(&result, pageSize, length == 0 ? pageSize : length) == 0) {
+        parcCpuTopology_AdviseNode(result, length, node);
+    } else {
+        result = NULL;
+    }
+    return result;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_CpuTopology.h
+ * @ingroup threading
+ * @brief Discover how the processors of this machine are arranged, and place memory near them.
+ *
+ * CPUs are numbered as the operating system numbers them, and sets of CPUs are `PARCBitVector` instances
+ * with one bit per CPU.  The same sets are given to {@link parcThread_SetAffinity} and
+ * {@link parcThreadPool_CreateWithAffinity} to keep threads on chosen CPUs.
+ *
+ * On Linux the topology is read from `/sys/devices/system/cpu` and `/sys/devices/system/node`.
+ * Elsewhere, or when those files cannot be read, every online CPU is reported as belonging to node 0.
+ *
+ * A NUMA node is a group of CPUs and the memory attached to them.  Memory on another node costs more to reach,
+ * so a thread pinned to one node should work on memory allocated there.  The kernel normally places a page on the
+ * node of the thread that first touches it; {@link parcCpuTopology_AdviseNode} asks for a node explicitly.
+ *
+ * @code
+ * {
+ *     // Pin a pipeline stage next to the reactor thread that feeds it.
+ *     int node = parcCpuTopology_GetNodeOfCpu(parcCpuTopology_GetCurrentCpu());
+ *     PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(node);
+ *
+ *     PARCBitVector *cpuSets[] = { cpus, cpus };
+ *     PARCThreadPool *pool = parcThreadPool_CreateWithAffinity(2, cpuSets);
+ *     parcBitVector_Release(&cpus);
+ * }
+ * @endcode
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_CpuTopology
+#define PARCLibrary_parc_CpuTopology
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_BitVector.h>
+
+/**
+ * Parse a list of CPUs in the form used by Linux, for example "0-3,8,10-11".
+ *
+ * @param [in] list A nul-terminated string of comma separated CPU numbers and ranges.  Trailing white space is ignored.
+ *
+ * @return non-NULL A `PARCBitVector` with a bit set for each CPU in the list, which must be released.
+ * @return NULL The list is malformed.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *cpus = parcCpuTopology_ParseCpuList("0-3,8");
+ *
+ *     parcBitVector_Release(&cpus);
+ * }
+ * @endcode
+ */
+PARCBitVector *parcCpuTopology_ParseCpuList(const char *list);
+
+/**
+ * Get the set of CPUs that are online.
+ *
+ * @return non-NULL A `PARCBitVector` with a bit set for each online CPU, which must be released.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *cpus = parcCpuTopology_GetOnlineCpus();
+ *     unsigned count = parcBitVector_NumberOfBitsSet(cpus);
+ *
+ *     parcBitVector_Release(&cpus);
+ * }
+ * @endcode
+ */
+PARCBitVector *parcCpuTopology_GetOnlineCpus(void);
+
+/**
+ * Get the number of NUMA nodes.
+ *
+ * Nodes are numbered from 0, but the numbers need not be contiguous on every machine.
+ *
+ * @return The number of nodes, which is at least 1.
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned nodes = parcCpuTopology_GetNodeCount();
+ * }
+ * @endcode
+ */
+unsigned parcCpuTopology_GetNodeCount(void);
+
+/**
+ * Get the set of CPUs on the given NUMA node.
+ *
+ * @param [in] node A node number.
+ *
+ * @return non-NULL A `PARCBitVector` with a bit set for each CPU on @p node, which must be released.
+ *                  The set is empty if there is no such node.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(0);
+ *
+ *     parcBitVector_Release(&cpus);
+ * }
+ * @endcode
+ */
+PARCBitVector *parcCpuTopology_GetNodeCpus(unsigned node);
+
+/**
+ * Get the NUMA node of the given CPU.
+ *
+ * @param [in] cpu A CPU number.
+ *
+ * @return The node number, or -1 if @p cpu is not online.
+ *
+ * Example:
+ * @code
+ * {
+ *     int node = parcCpuTopology_GetNodeOfCpu(0);
+ * }
+ * @endcode
+ */
+int parcCpuTopology_GetNodeOfCpu(int cpu);
+
+/**
+ * Get the physical package, or socket, of the given CPU.
+ *
+ * @param [in] cpu A CPU number.
+ *
+ * @return The package number, or -1 if it is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     int package = parcCpuTopology_GetPackageOfCpu(0);
+ * }
+ * @endcode
+ */
+int parcCpuTopology_GetPackageOfCpu(int cpu);
+
+/**
+ * Get the core of the given CPU within its package.
+ *
+ * CPUs that are hardware threads of one core report the same package and core.
+ *
+ * @param [in] cpu A CPU number.
+ *
+ * @return The core number, or -1 if it is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     int core = parcCpuTopology_GetCoreOfCpu(0);
+ * }
+ * @endcode
+ */
+int parcCpuTopology_GetCoreOfCpu(int cpu);
+
+/**
+ * Get the CPU that the calling thread is running on.
+ *
+ * Unless the thread is pinned to a single CPU, the answer may be out of date as soon as it is returned.
+ *
+ * @return The CPU number, or -1 if it is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     int cpu = parcCpuTopology_GetCurrentCpu();
+ * }
+ * @endcode
+ */
+int parcCpuTopology_GetCurrentCpu(void);
+
+/**
+ * Ask that the pages wholly within the given memory be placed on the given NUMA node.
+ *
+ * This is a hint.  Pages already in use are moved if the kernel permits it, and pages touched later are allocated on
+ * @p node while it has free memory, and elsewhere after that.  Only whole pages are affected, so memory that is to be
+ * advised should be allocated with page alignment, as {@link parcCpuTopology_AllocateOnNode} does.
+ *
+ * @param [in] memory The start of the memory.
+ * @param [in] length The length of the memory in bytes.
+ * @param [in] node A node number.
+ *
+ * @return true The kernel accepted the hint.
+ * @return false The hint is not supported on this platform, the memory contains no whole page, or @p node does not exist.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcCpuTopology_AdviseNode(buffer, length, 1);
+ * }
+ * @endcode
+ */
+bool parcCpuTopology_AdviseNode(void *memory, size_t length, int node);
+
+/**
+ * Allocate page aligned memory through the current `PARCMemoryInterface`, and ask that it be placed on the given NUMA node.
+ *
+ * The memory is deallocated with `parcMemory_Deallocate`.
+ * The placement is a hint, as described for {@link parcCpuTopology_AdviseNode}; the allocation succeeds whether or not it is taken.
+ *
+ * @param [in] size The number of bytes to allocate.
+ * @param [in] node A node number.
+ *
+ * @return non-NULL A pointer to the allocated memory.
+ * @return NULL The memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *buffer = parcCpuTopology_AllocateOnNode(1 << 20, 0);
+ *
+ *     parcMemory_Deallocate(&buffer);
+ * }
+ * @endcode
+ */
+void *parcCpuTopology_AllocateOnNode(size_t size, int node);
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Event.h>
+#include <parc/algol/parc_LinkedList.h>
+
+#include <parc/concurrent/parc_Executor.h>
+#include <parc/concurrent/parc_Notifier.h>
+
+struct PARCExecutor {
+    void *instance;
+    const PARCExecutorInterface *interface;
+};
+
+static void
+_parcExecutor_Finalize(PARCExecutor **executorPtr)
+{
+    PARCExecutor *executor = *executorPtr;
+    (executor->interface->Release)(&executor->instance);
+}
+
+parcObject_ExtendPARCObject(PARCExecutor, _parcExecutor_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(parcExecutor, PARCExecutor);
+
+parcObject_ImplementRelease(parcExecutor, PARCExecutor);
+
+PARCExecutor *
+parcExecutor_Create(void *instance, const PARCExecutorInterface *interface)
+{
+    PARCExecutor *result = parcObject_CreateInstance(PARCExecutor);
+    assertNotNull(result, "parcObject_CreateInstance returned NULL");
+
+    result->instance = instance;
+    result->interface = interface;
+
+    return result;
+}
+
+bool
+parcExecutor_Execute(PARCExecutor *executor, PARCFutureTask *task)
+{
+    return (executor->interface->Execute)(executor->instance, task);
+}
+
+/*
+ * Tasks for a PARCEventScheduler wait in a queue.  Adding one notifies a PARCNotifier whose socket is a read event
+ * on the scheduler, and the event's callback runs everything in the queue on the scheduler's thread.
+ */
+typedef struct {
+    PARCLinkedList *queue;
+    PARCNotifier *notifier;
+    PARCEvent *event;
+} _PARCExecutorEventQueue;
+
+static void
+_parcExecutorEventQueue_Finalize(_PARCExecutorEventQueue **instancePtr)
+{
+    _PARCExecutorEventQueue *eventQueue = *instancePtr;
+
+    parcEvent_Stop(eventQueue->event);
+    parcEvent_Destroy(&eventQueue->event);
+
+    PARCFutureTask *task;
+    while ((task = parcLinkedList_RemoveFirst(eventQueue->queue)) != NULL) {
+        parcFutureTask_Cancel(task, false);
+        parcFutureTask_Release(&task);
+    }
+    parcLinkedList_Release(&eventQueue->queue);
+    parcNotifier_Release(&eventQueue->notifier);
+}
+
+parcObject_ExtendPARCObject(_PARCExecutorEventQueue, _parcExecutorEventQueue_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static void
+_parcExecutorEventQueue_Dispatch(int fd, PARCEventType type, void *user_data)
+{
+    _PARCExecutorEventQueue *eventQueue = user_data;
+
+    parcNotifier_PauseEvents(eventQueue->notifier);
+
+    for (;;) {
+        PARCFutureTask *task = NULL;
+        if (parcLinkedList_Lock(eventQueue->queue)) {
+            task = parcLinkedList_RemoveFirst(eventQueue->queue);
+            parcLinkedList_Unlock(eventQueue->queue);
+        }
+        if (task == NULL) {
+            break;
+        }
+        parcFutureTask_Run(task);
+        parcFutureTask_Release(&task);
+    }
+
+    parcNotifier_StartEvents(eventQueue->notifier);
+}
+
+static bool
+_parcExecutorEventQueue_Execute(_PARCExecutorEventQueue *eventQueue, PARCFutureTask *task)
+{
+    bool result = false;
+
+    if (parcLinkedList_Lock(eventQueue->queue)) {
+        parcLinkedList_Append(eventQueue->queue, task);
+        parcLinkedList_Unlock(eventQueue->queue);
+        result = true;
+    }
+    if (result) {
+        parcNotifier_Notify(eventQueue->notifier);
+    }
+
+    return result;
+}
+
+static const PARCExecutorInterface *PARCEventSchedulerAsPARCExecutor = &(PARCExecutorInterface) {
+    .Execute = (bool (*)(void *, PARCFutureTask *))_parcExecutorEventQueue_Execute,
+    .Release = (void (*)(void **))parcObject_Release
+};
+
+PARCExecutor *
+parcExecutor_CreateForEventScheduler(PARCEventScheduler *scheduler)
+{
+    _PARCExecutorEventQueue *eventQueue = parcObject_CreateInstance(_PARCExecutorEventQueue);
+    assertNotNull(eventQueue, "parcObject_CreateInstance returned NULL");
+
+    eventQueue->queue = parcLinkedList_Create();
+    eventQueue->notifier = parcNotifier_Create();
+    eventQueue->event = parcEvent_Create(scheduler, parcNotifier_Socket(eventQueue->notifier),
+                                         PARCEventType_Read | PARCEventType_Persist,
+                                         _parcExecutorEventQueue_Dispatch, eventQueue);
+    parcEvent_Start(eventQueue->event);
+
+    return parcExecutor_Create(eventQueue, PARCEventSchedulerAsPARCExecutor);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_Executor.h
+ * @ingroup threading
+ * @brief Something that runs a `PARCFutureTask`.
+ *
+ * A `PARCExecutor` hides where and when a task runs, so that code which only needs a task to be run,
+ * such as a continuation registered with {@link parcFutureTask_Then}, can be given a thread pool,
+ * an event loop, or anything else that implements the interface.
+ *
+ * Like `PARCOutputStream`, a `PARCExecutor` pairs an instance with a `PARCExecutorInterface`.
+ * {@link parcThreadPool_AsExecutor} runs tasks on a `PARCThreadPool`,
+ * and {@link parcExecutor_CreateForEventScheduler} runs them on the thread dispatching a `PARCEventScheduler`.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_Executor
+#define PARCLibrary_parc_Executor
+#include <stdbool.h>
+
+#include <parc/algol/parc_EventScheduler.h>
+#include <parc/concurrent/parc_FutureTask.h>
+
+struct PARCExecutor;
+typedef struct PARCExecutor PARCExecutor;
+
+typedef struct PARCExecutorInterface {
+    /**
+     * Arrange for the task to be run, acquiring a reference to it if the run is deferred.
+     *
+     * @return true The task was accepted.
+     * @return false The task was rejected and will not be run.
+     */
+    bool (*Execute)(void *instance, PARCFutureTask *task);
+
+    void (*Release)(void **instancePtr);
+} PARCExecutorInterface;
+
+/**
+ * Create a `PARCExecutor` from an instance and the `PARCExecutorInterface` that operates on it.
+ *
+ * The executor takes ownership of the given reference to @p instance,
+ * which is released through the interface when the executor is finalized.
+ *
+ * @param [in] instance A pointer to the instance given to the functions of @p interface.
+ * @param [in] interface A pointer to a `PARCExecutorInterface`.
+ *
+ * @return non-NULL A pointer to a valid `PARCExecutor` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     static const PARCExecutorInterface myQueueAsExecutor = {
+ *         .Execute = (bool (*)(void *, PARCFutureTask *))myQueue_Execute,
+ *         .Release = (void (*)(void **))myQueue_Release
+ *     };
+ *     PARCExecutor *executor = parcExecutor_Create(myQueue_Acquire(queue), &myQueueAsExecutor);
+ *
+ *     parcExecutor_Release(&executor);
+ * }
+ * @endcode
+ */
+PARCExecutor *parcExecutor_Create(void *instance, const PARCExecutorInterface *interface);
+
+/**
+ * Create a `PARCExecutor` that runs tasks on the thread dispatching the given `PARCEventScheduler`.
+ *
+ * Tasks may be given to the executor from any thread.  They are queued, and a `PARCNotifier` registered with
+ * the scheduler wakes its event loop, which runs them in the order they were given.
+ *
+ * Libevent is not thread-safe, so create and release the executor either on the thread dispatching the scheduler,
+ * or while no thread is dispatching it.  The scheduler must outlive the executor.
+ * Tasks still queued when the executor is finalized are cancelled.
+ *
+ * @param [in] scheduler A pointer to a valid `PARCEventScheduler`.
+ *
+ * @return non-NULL A pointer to a valid `PARCExecutor` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCEventScheduler *scheduler = parcEventScheduler_Create();
+ *     PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+ *
+ *     PARCFutureTask *next = parcFutureTask_Then(task, _handleResult, executor);
+ *     parcEventScheduler_Start(scheduler, PARCEventSchedulerDispatchType_Blocking);
+ *
+ *     parcFutureTask_Release(&next);
+ *     parcExecutor_Release(&executor);
+ *     parcEventScheduler_Destroy(&scheduler);
+ * }
+ * @endcode
+ */
+PARCExecutor *parcExecutor_CreateForEventScheduler(PARCEventScheduler *scheduler);
+
+/**
+ * Increase the number of references to a `PARCExecutor` instance.
+ *
+ * @param [in] executor A pointer to a valid `PARCExecutor` instance.
+ *
+ * @return The same value as @p executor.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCExecutor *reference = parcExecutor_Acquire(executor);
+ *
+ *     parcExecutor_Release(&reference);
+ * }
+ * @endcode
+ */
+PARCExecutor *parcExecutor_Acquire(const PARCExecutor *executor);
+
+/**
+ * Release a previously acquired reference to the given `PARCExecutor` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * @param [in,out] executorPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+ *
+ *     parcExecutor_Release(&executor);
+ * }
+ * @endcode
+ */
+void parcExecutor_Release(PARCExecutor **executorPtr);
+
+/**
+ * Give a task to the executor to run.
+ *
+ * @param [in] executor A pointer to a valid `PARCExecutor` instance.
+ * @param [in] task A pointer to a valid `PARCFutureTask` instance.
+ *
+ * @return true The task was accepted.
+ * @return false The task was rejected, for example because a thread pool has been shut down.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcExecutor_Execute(executor, task)) {
+ *         PARCFutureTaskResult result = parcFutureTask_Get(task, PARCTimeout_Never);
+ *     }
+ * }
+ * @endcode
+ */
+bool parcExecutor_Execute(PARCExecutor *executor, PARCFutureTask *task);
+#endif
@@ -31,12 +31,54 @@
 #include <config.h>
 #include <stdio.h>
 
+#include <LongBow/runtime.h>
+
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_Execution.h>
 
 #include <parc/concurrent/parc_FutureTask.h>
+#include <parc/concurrent/parc_Executor.h>
+
+/*
+ * Counts the completions of the tasks given to parcFutureTask_WhenAll or parcFutureTask_WhenAny,
+ * and runs the combined task when `remaining` reaches zero.
+ *
+ * This is a PARCObject held by the combined task, as its parameter, and by each continuation that counts an arrival.
+ * The combined task is held in turn until every one of the `outstanding` continuations has arrived or been discarded,
+ * which breaks the cycle between the two.
+ */
+typedef struct {
+    int remaining;
+    int outstanding;
+    bool isAny;
+    PARCFutureTask *first;
+    PARCFutureTask *task;
+} _PARCFutureTaskWhen;
+
+parcObject_ExtendPARCObject(_PARCFutureTaskWhen, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementAcquire(_parcFutureTaskWhen, _PARCFutureTaskWhen);
+
+static parcObject_ImplementRelease(_parcFutureTaskWhen, _PARCFutureTaskWhen);
+
+/*
+ * Something to do when a task completes: run `continuation` on `executor`, or count an arrival at `when`.
+ *
+ * A continuation created by parcFutureTask_Then is given the completed task as its parameter only when it is dispatched.
+ * Until then it holds no reference to the task, so a task that never completes is not kept alive by its own continuations.
+ */
+typedef struct _PARCFutureTaskContinuation {
+    PARCFutureTask *continuation;
+    PARCExecutor *executor;
+    bool passTask;
+    _PARCFutureTaskWhen *when;
+    struct _PARCFutureTaskContinuation *next;
+} _PARCFutureTaskContinuation;
+
+// Marks the list of continuations of a completed task, so that later ones are dispatched at once.
+#define _PARCFutureTask_Completed ((_PARCFutureTaskContinuation *) 1)
 
 struct PARCFutureTask {
     void *(*function)(PARCFutureTask *task, void *parameter);
@@ -45,6 +87,9 @@ struct PARCFutureTask {
     bool isRunning;
     bool isDone;
     bool isCancelled;
+
+    // A lock-free stack, most recent first, so that adding a continuation never waits for the task to finish running.
+    _PARCFutureTaskContinuation *continuations;
 };
 
 static void
@@ -54,6 +99,109 @@ _parcFutureTask_Initialise(PARCFutureTask *futureTask)
     futureTask->isDone = false;
     futureTask->isCancelled = false;
     futureTask->isRunning = false;
+
+    // A task that is reset may complete again.
+    _PARCFutureTaskContinuation *completed = _PARCFutureTask_Completed;
+    __atomic_compare_exchange_n(&futureTask->continuations, &completed, NULL, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static void
+_parcFutureTaskContinuation_Destroy(_PARCFutureTaskContinuation **continuationPtr)
+{
+    _PARCFutureTaskContinuation *continuation = *continuationPtr;
+
+    if (continuation->continuation != NULL) {
+        parcFutureTask_Release(&continuation->continuation);
+    }
+    if (continuation->executor != NULL) {
+        parcExecutor_Release(&continuation->executor);
+    }
+    if (continuation->when != NULL) {
+        _parcFutureTaskWhen_Release(&continuation->when);
+    }
+    parcMemory_Deallocate(continuationPtr);
+}
+
+static void
+_parcFutureTaskWhen_Leave(_PARCFutureTaskWhen *when)
+{
+    if (__atomic_sub_fetch(&when->outstanding, 1, __ATOMIC_ACQ_REL) == 0) {
+        parcFutureTask_Release(&when->task);
+    }
+}
+
+static void
+_parcFutureTaskWhen_Arrive(_PARCFutureTaskWhen *when, PARCFutureTask *task)
+{
+    if (task != NULL) {
+        PARCFutureTask *none = NULL;
+        __atomic_compare_exchange_n(&when->first, &none, task, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+    if (__atomic_sub_fetch(&when->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+        parcFutureTask_Run(when->task);
+    }
+    _parcFutureTaskWhen_Leave(when);
+}
+
+static void
+_parcFutureTask_Dispatch(PARCFutureTask *task, _PARCFutureTaskContinuation *continuation)
+{
+    if (continuation->passTask) {
+        continuation->continuation->parameter = parcFutureTask_Acquire(task);
+    }
+
+    if (continuation->when != NULL) {
+        _parcFutureTaskWhen_Arrive(continuation->when, task);
+    } else if (continuation->executor == NULL) {
+        parcFutureTask_Run(continuation->continuation);
+    } else if (!parcExecutor_Execute(continuation->executor, continuation->continuation)) {
+        // A rejected continuation is cancelled, so that anything waiting on it still completes.
+        parcFutureTask_Cancel(continuation->continuation, false);
+    }
+    _parcFutureTaskContinuation_Destroy(&continuation);
+}
+
+/*
+ * Add a continuation, or dispatch it at once if the task has already completed.
+ */
+static void
+_parcFutureTask_AddContinuation(PARCFutureTask *task, _PARCFutureTaskContinuation *continuation)
+{
+    _PARCFutureTaskContinuation *head = __atomic_load_n(&task->continuations, __ATOMIC_ACQUIRE);
+    do {
+        if (head == _PARCFutureTask_Completed) {
+            _parcFutureTask_Dispatch(task, continuation);
+            return;
+        }
+        continuation->next = head;
+    } while (!__atomic_compare_exchange_n(&task->continuations, &head, continuation, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+/*
+ * Mark the task completed and dispatch its continuations, in the order they were added.
+ * Call this after the result is set, without holding the task's lock.
+ */
+static void
+_parcFutureTask_Complete(PARCFutureTask *task)
+{
+    _PARCFutureTaskContinuation *list = __atomic_exchange_n(&task->continuations, _PARCFutureTask_Completed, __ATOMIC_ACQ_REL);
+    if (list == _PARCFutureTask_Completed) {
+        return;
+    }
+
+    _PARCFutureTaskContinuation *reversed = NULL;
+    while (list != NULL) {
+        _PARCFutureTaskContinuation *next = list->next;
+        list->next = reversed;
+        reversed = list;
+        list = next;
+    }
+
+    while (reversed != NULL) {
+        _PARCFutureTaskContinuation *next = reversed->next;
+        _parcFutureTask_Dispatch(task, reversed);
+        reversed = next;
+    }
 }
 
 static bool
@@ -65,6 +213,19 @@ _parcFutureTask_Destructor(PARCFutureTask **instancePtr)
     if (parcObject_IsInstanceOf(task->parameter, &PARCObject_Descriptor)) {
         parcObject_Release(&task->parameter);
     }
+
+    // Continuations of a task that never completed are discarded without running.
+    _PARCFutureTaskContinuation *continuation = task->continuations;
+    if (continuation != _PARCFutureTask_Completed) {
+        while (continuation != NULL) {
+            _PARCFutureTaskContinuation *next = continuation->next;
+            if (continuation->when != NULL) {
+                _parcFutureTaskWhen_Leave(continuation->when);
+            }
+            _parcFutureTaskContinuation_Destroy(&continuation);
+            continuation = next;
+        }
+    }
     
     return true;
 }
@@ -102,6 +263,7 @@ parcFutureTask_Create(void *(*function)(PARCFutureTask *task, void *parameter),
     if (result != NULL) {
         result->function = function;
         result->parameter = parameter;
+        result->continuations = NULL;
         _parcFutureTask_Initialise(result);
     }
 
@@ -212,6 +374,10 @@ parcFutureTask_Cancel(PARCFutureTask *task, bool mayInterruptIfRunning)
         
         parcObject_Unlock(task);
     }
+
+    if (result) {
+        _parcFutureTask_Complete(task);
+    }
     
     return result;
 }
@@ -230,24 +396,22 @@ parcFutureTask_Get(const PARCFutureTask *futureTask, const PARCTimeout *timeout)
             result.value = futureTask->result;
         }
     } else {
-        result.execution = PARCExecution_Interrupted;
-        result.value = 0;
-        
         parcObject_Lock(futureTask);
-        while (!futureTask->isDone) {
-            if (parcTimeout_IsNever(timeout)) {
+        if (parcTimeout_IsNever(timeout)) {
+            while (!futureTask->isDone) {
                 parcObject_Wait(futureTask);
-                result.execution = PARCExecution_OK;
-                result.value = futureTask->result;
-                break;
-            } else {
-                if (parcObject_WaitFor(futureTask, parcTimeout_InNanoSeconds(timeout))) {
-                    result.execution = PARCExecution_OK;
-                    result.value = futureTask->result;
-                    break;
-                }
+            }
+        } else if (!futureTask->isDone) {
+            if (parcObject_WaitFor(futureTask, parcTimeout_InNanoSeconds(timeout)) && !futureTask->isDone) {
+                result.execution = PARCExecution_Interrupted;
             }
         }
+
+        // The task may have completed before this was called, which is usual for a task with continuations.
+        if (futureTask->isDone) {
+            result.execution = PARCExecution_OK;
+            result.value = futureTask->result;
+        }
         parcObject_Unlock(futureTask);
     }
     
@@ -279,16 +443,23 @@ _parcFutureTask_Execute(PARCFutureTask *task)
 void *
 parcFutureTask_Run(PARCFutureTask *task)
 {
+    bool completed = false;
+
     if (parcFutureTask_Lock(task)) {
         if (!task->isCancelled) {
             task->result = _parcFutureTask_Execute(task);
             task->isDone = true;
             parcFutureTask_Notify(task);
+            completed = true;
         }
         parcFutureTask_Unlock(task);
     } else {
         trapCannotObtainLock("Cannot lock PARCFutureTask");
     }
+
+    if (completed) {
+        _parcFutureTask_Complete(task);
+    }
     return task->result;
 }
 
@@ -316,3 +487,81 @@ parcFutureTask_Reset(PARCFutureTask *task)
 {
     _parcFutureTask_Initialise(task);
 }
+
+static _PARCFutureTaskContinuation *
+_parcFutureTaskContinuation_Create(PARCFutureTask *continuation, PARCExecutor *executor, bool passTask, _PARCFutureTaskWhen *when)
+{
+    _PARCFutureTaskContinuation *result = parcMemory_Allocate(sizeof(_PARCFutureTaskContinuation));
+    assertNotNull(result, "parcMemory_Allocate(%zu) returned NULL", sizeof(_PARCFutureTaskContinuation));
+
+    result->continuation = (continuation == NULL) ? NULL : parcFutureTask_Acquire(continuation);
+    result->executor = (executor == NULL) ? NULL : parcExecutor_Acquire(executor);
+    result->passTask = passTask;
+    result->when = (when == NULL) ? NULL : _parcFutureTaskWhen_Acquire(when);
+    result->next = NULL;
+
+    return result;
+}
+
+void
+parcFutureTask_OnCompletion(PARCFutureTask *task, PARCFutureTask *continuation, PARCExecutor *executor)
+{
+    _parcFutureTask_AddContinuation(task, _parcFutureTaskContinuation_Create(continuation, executor, false, NULL));
+}
+
+PARCFutureTask *
+parcFutureTask_Then(PARCFutureTask *task, void *(*function)(PARCFutureTask *task, void *parameter), PARCExecutor *executor)
+{
+    PARCFutureTask *result = parcFutureTask_Create(function, NULL);
+
+    _parcFutureTask_AddContinuation(task, _parcFutureTaskContinuation_Create(result, executor, true, NULL));
+
+    return result;
+}
+
+static void *
+_parcFutureTaskWhen_Value(PARCFutureTask *task, void *parameter)
+{
+    _PARCFutureTaskWhen *when = parameter;
+    return when->isAny ? when->first : NULL;
+}
+
+static PARCFutureTask *
+_parcFutureTask_When(PARCFutureTask *const tasks[], size_t count, int required, bool isAny)
+{
+    _PARCFutureTaskWhen *when = parcObject_CreateInstance(_PARCFutureTaskWhen);
+    assertNotNull(when, "parcObject_CreateInstance returned NULL");
+
+    PARCFutureTask *result = parcFutureTask_Create(_parcFutureTaskWhen_Value, when);
+
+    // Registering counts as one more arrival, made below once every task has its continuation,
+    // so the combined task cannot run, nor be released by `when`, part way through the loop.
+    when->remaining = required + 1;
+    when->outstanding = (int) count + 1;
+    when->isAny = isAny;
+    when->first = NULL;
+    when->task = parcFutureTask_Acquire(result);
+
+    for (size_t i = 0; i < count; i++) {
+        _parcFutureTask_AddContinuation(tasks[i], _parcFutureTaskContinuation_Create(NULL, NULL, false, when));
+    }
+
+    _parcFutureTaskWhen_Arrive(when, NULL);
+    _parcFutureTaskWhen_Release(&when);
+
+    return result;
+}
+
+PARCFutureTask *
+parcFutureTask_WhenAll(PARCFutureTask *const tasks[], size_t count)
+{
+    return _parcFutureTask_When(tasks, count, (int) count, false);
+}
+
+PARCFutureTask *
+parcFutureTask_WhenAny(PARCFutureTask *const tasks[], size_t count)
+{
+    assertTrue(count > 0, "parcFutureTask_WhenAny requires at least one task");
+
+    return _parcFutureTask_When(tasks, count, 1, true);
+}
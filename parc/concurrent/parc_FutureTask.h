@@ -44,6 +44,11 @@
  * but invoking `parcFutureTask_GetAndReset` invokes the associated function and resets the task to the initial state,
  * permitting a future call to `parcFutureTask_Get` or `parcFutureTask_GetAndReset` the run the associated function again.
  *
+ * Rather than block in `parcFutureTask_Get`, a computation that depends on a task can be registered to run when it completes,
+ * with `parcFutureTask_Then` or `parcFutureTask_OnCompletion`, on a `PARCExecutor` such as a thread pool or an event loop.
+ * `parcFutureTask_WhenAll` and `parcFutureTask_WhenAny` combine several tasks into one.
+ * No thread waits for any of these: the thread that completes a task dispatches its continuations.
+ *
  * @author Glenn Scott, Computing Science Laboratory, PARC
  * @copyright 2016 Palo Alto Research Center, Inc. (PARC), A Xerox Company.  All Rights Reserved.
  */
@@ -60,6 +65,8 @@
 struct PARCFutureTask;
 typedef struct PARCFutureTask PARCFutureTask;
 
+struct PARCExecutor;
+
 typedef struct PARCFutureTaskResult {
     void *value;
     PARCExecution *execution;
@@ -667,4 +674,120 @@ bool parcFutureTask_RunAndReset(PARCFutureTask *futureTask);
  */
 void parcFutureTask_Reset(PARCFutureTask *task);
 
+/**
+ * Run a task when the given task completes, either by running or by being cancelled.
+ *
+ * If @p task has already completed, @p continuation is dispatched at once, on the calling thread.
+ * Otherwise it is dispatched by the thread that completes @p task.
+ * Continuations are dispatched in the order they were added.
+ *
+ * If @p executor is NULL, @p continuation runs on the dispatching thread, so it should be short.
+ * If @p executor rejects @p continuation, it is cancelled, so that its own continuations still run.
+ *
+ * A task holds a reference to each of its continuations, and to their executors, until it completes.
+ * The continuations of a task that is released without completing are discarded.
+ *
+ * @param [in] task A pointer to a valid `PARCFutureTask` instance.
+ * @param [in] continuation A pointer to the `PARCFutureTask` to run when @p task completes.
+ * @param [in] executor A pointer to the `PARCExecutor` on which to run @p continuation, or NULL.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCFutureTask *logger = parcFutureTask_Create(_logCompletion, NULL);
+ *     parcFutureTask_OnCompletion(task, logger, NULL);
+ *     parcFutureTask_Release(&logger);
+ * }
+ * @endcode
+ */
+void parcFutureTask_OnCompletion(PARCFutureTask *task, PARCFutureTask *continuation, struct PARCExecutor *executor);
+
+/**
+ * Create a task that runs the given function when the given task completes.
+ *
+ * When it runs, the new task's parameter is @p task, so @p function can collect its result with
+ * `parcFutureTask_Get(parameter, PARCTimeout_Immediate)` without waiting,
+ * or check whether it was cancelled with `parcFutureTask_IsCancelled(parameter)`.
+ *
+ * The new task can itself be followed, so pipelines of any depth can be built without blocking a thread.
+ * It is dispatched as described in {@link parcFutureTask_OnCompletion}.
+ *
+ * @param [in] task A pointer to a valid `PARCFutureTask` instance.
+ * @param [in] function The function to run when @p task completes.
+ * @param [in] executor A pointer to the `PARCExecutor` on which to run @p function, or NULL to run it on the completing thread.
+ *
+ * @return non-NULL A pointer to a new `PARCFutureTask`, which must be released.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+ *
+ *     PARCFutureTask *parse = parcFutureTask_Then(fetch, _parse, executor);
+ *     PARCFutureTask *store = parcFutureTask_Then(parse, _store, executor);
+ *     parcThreadPool_Execute(pool, fetch);
+ *
+ *     PARCFutureTaskResult result = parcFutureTask_Get(store, PARCTimeout_Never);
+ *
+ *     parcFutureTask_Release(&store);
+ *     parcFutureTask_Release(&parse);
+ *     parcExecutor_Release(&executor);
+ * }
+ * @endcode
+ */
+PARCFutureTask *parcFutureTask_Then(PARCFutureTask *task, void *(*function)(PARCFutureTask *task, void *parameter),
+                                    struct PARCExecutor *executor);
+
+/**
+ * Create a task that completes when all of the given tasks have completed.
+ *
+ * A cancelled task counts as completed.  The result value of the new task is NULL;
+ * collect the results of the given tasks with `parcFutureTask_Get`.
+ * The new task completes on the thread that completes the last of the given tasks,
+ * or at once if they have all completed already, or if @p count is 0.
+ *
+ * If one of the given tasks is released without completing, the new task never completes.
+ *
+ * @param [in] tasks An array of pointers to valid `PARCFutureTask` instances.
+ * @param [in] count The number of elements in @p tasks.
+ *
+ * @return non-NULL A pointer to a new `PARCFutureTask`, which must be released.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCFutureTask *all = parcFutureTask_WhenAll((PARCFutureTask *[]) { a, b, c }, 3);
+ *     PARCFutureTask *report = parcFutureTask_Then(all, _report, executor);
+ *
+ *     parcFutureTask_Release(&report);
+ *     parcFutureTask_Release(&all);
+ * }
+ * @endcode
+ */
+PARCFutureTask *parcFutureTask_WhenAll(PARCFutureTask *const tasks[], size_t count);
+
+/**
+ * Create a task that completes when the first of the given tasks completes.
+ *
+ * A cancelled task counts as completed.  The result value of the new task is
+ * the given task that completed first, which is valid for as long as the caller holds a reference to it.
+ *
+ * @param [in] tasks An array of pointers to valid `PARCFutureTask` instances.
+ * @param [in] count The number of elements in @p tasks, which must be at least 1.
+ *
+ * @return non-NULL A pointer to a new `PARCFutureTask`, which must be released.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCFutureTask *any = parcFutureTask_WhenAny((PARCFutureTask *[]) { primary, backup }, 2);
+ *
+ *     PARCFutureTask *first = parcFutureTask_Get(any, PARCTimeout_Never).value;
+ *
+ *     parcFutureTask_Release(&any);
+ * }
+ * @endcode
+ */
+PARCFutureTask *parcFutureTask_WhenAny(PARCFutureTask *const tasks[], size_t count);
+
 #endif
@@ -32,54 +32,101 @@
 #include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
 
+#if __linux__
+#include <sys/eventfd.h>
+#endif
+
 #include <LongBow/runtime.h>
 
 #include <parc/concurrent/parc_Notifier.h>
 #include <parc/algol/parc_Object.h>
 
-#ifdef __GNUC__
-#define ATOMIC_ADD_AND_FETCH(ptr, increment)      __sync_add_and_fetch(ptr, increment)
-#define ATOMIC_BOOL_CAS(ptr, oldvalue, newvalue)  __sync_bool_compare_and_swap(ptr, oldvalue, newvalue)
-#define ATOMIC_FETCH(ptr)                         ATOMIC_ADD_AND_FETCH(ptr, 0)
-#define ATOMIC_SET(ptr, oldvalue, newvalue)       ATOMIC_BOOL_CAS(ptr, oldvalue, newvalue)
-#else
-#error "Only GNUC supported, we need atomic operations"
-#endif
+/*
+ * The state word decides, without a system call, whether a notification must reach the file descriptor.
+ *
+ * Armed: the consumer is waiting on the descriptor, so the next notification is written to it.
+ * Signalled: the descriptor has been written, or the consumer is paused and will look for work anyway.
+ * Pending: set alongside Signalled when notifications arrive after the consumer paused.
+ *
+ * Only the first notification after the consumer re-arms makes a system call.  Later ones are a load,
+ * or at most one compare-and-swap to record that something is pending.
+ */
+#define _PARCNotifierState_Armed     0
+#define _PARCNotifierState_Signalled 1
+#define _PARCNotifierState_Pending   2
 
 struct parc_notifier {
-    volatile int paused;
-
-    // If the notifications are paused and there is an event,
-    // we indicate that we skipped a notify
-    volatile int skippedNotify;
+    volatile uint32_t state;
 
+#if __linux__
+    // An eventfd: one descriptor, and repeated writes coalesce into its counter.
+    int fd;
+#else
 #define PARCNotifierWriteFd 1
 #define PARCNotifierReadFd 0
     int fds[2];
+#endif
 };
 
+#if __linux__
+static bool
+_parcNotifier_Open(PARCNotifier *notifier)
+{
+    notifier->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notifier->fd < 0) {
+        perror("eventfd error");
+        return false;
+    }
+    return true;
+}
+
 static void
-_parcNotifier_Finalize(PARCNotifier **notifierPtr)
+_parcNotifier_Close(PARCNotifier *notifier)
 {
-    PARCNotifier *notifier = *notifierPtr;
+    if (notifier->fd >= 0) {
+        close(notifier->fd);
+    }
+}
 
-    close(notifier->fds[0]);
-    close(notifier->fds[1]);
+static int
+_parcNotifier_ReadFd(const PARCNotifier *notifier)
+{
+    return notifier->fd;
 }
 
-parcObject_ExtendPARCObject(PARCNotifier, _parcNotifier_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+static void
+_parcNotifier_Signal(PARCNotifier *notifier)
+{
+    uint64_t one = 1;
+    ssize_t written;
+    do {
+        written = write(notifier->fd, &one, sizeof(one));
+    } while (written < 0 && errno == EINTR);
+    assertTrue(written == sizeof(one), "Error writing to eventfd %d: %s", notifier->fd, strerror(errno));
+}
 
+static void
+_parcNotifier_Drain(PARCNotifier *notifier)
+{
+    // A single read returns and resets the whole counter.
+    uint64_t count;
+    while (read(notifier->fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+        ;
+    }
+}
+#else
 static bool
-_parcNotifier_MakeNonblocking(PARCNotifier *notifier)
+_parcNotifier_MakeNonblocking(int fd)
 {
-    // set the read side to be non-blocking
-    int flags = fcntl(notifier->fds[PARCNotifierReadFd], F_GETFL, 0);
-    if (flags == 0) {
-        if (fcntl(notifier->fds[PARCNotifierReadFd], F_SETFL, flags | O_NONBLOCK) == 0) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) {
+        if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0) {
             return true;
         }
     }
@@ -87,18 +134,65 @@ _parcNotifier_MakeNonblocking(PARCNotifier *notifier)
     return false;
 }
 
+static bool
+_parcNotifier_Open(PARCNotifier *notifier)
+{
+    int failure = pipe(notifier->fds);
+    assertFalse(failure, "Error on pipe: %s", strerror(errno));
+
+    return _parcNotifier_MakeNonblocking(notifier->fds[PARCNotifierReadFd]);
+}
+
+static void
+_parcNotifier_Close(PARCNotifier *notifier)
+{
+    close(notifier->fds[PARCNotifierReadFd]);
+    close(notifier->fds[PARCNotifierWriteFd]);
+}
+
+static int
+_parcNotifier_ReadFd(const PARCNotifier *notifier)
+{
+    return notifier->fds[PARCNotifierReadFd];
+}
+
+static void
+_parcNotifier_Signal(PARCNotifier *notifier)
+{
+    uint8_t one = 1;
+    ssize_t written;
+    do {
+        written = write(notifier->fds[PARCNotifierWriteFd], &one, 1);
+        assertTrue(written >= 0 || errno == EINTR, "Error writing to socket %d: %s", notifier->fds[PARCNotifierWriteFd], strerror(errno));
+    } while (written <= 0);
+}
+
+static void
+_parcNotifier_Drain(PARCNotifier *notifier)
+{
+    uint8_t buffer[16];
+    while (read(notifier->fds[PARCNotifierReadFd], &buffer, 16) > 0) {
+        ;
+    }
+}
+#endif
+
+static void
+_parcNotifier_Finalize(PARCNotifier **notifierPtr)
+{
+    _parcNotifier_Close(*notifierPtr);
+}
+
+parcObject_ExtendPARCObject(PARCNotifier, _parcNotifier_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
 PARCNotifier *
 parcNotifier_Create(void)
 {
     PARCNotifier *notifier = parcObject_CreateInstance(PARCNotifier);
     if (notifier) {
-        notifier->paused = false;
-        notifier->skippedNotify = false;
-
-        int failure = pipe(notifier->fds);
-        assertFalse(failure, "Error on pipe: %s", strerror(errno));
+        notifier->state = _PARCNotifierState_Armed;
 
-        if (!_parcNotifier_MakeNonblocking(notifier)) {
+        if (!_parcNotifier_Open(notifier)) {
             parcObject_Release((void **) &notifier);
         }
     }
@@ -114,48 +208,46 @@ parcObject_ImplementRelease(parcNotifier, PARCNotifier);
 int
 parcNotifier_Socket(PARCNotifier *notifier)
 {
-    return notifier->fds[PARCNotifierReadFd];
+    return _parcNotifier_ReadFd(notifier);
 }
 
 bool
 parcNotifier_Notify(PARCNotifier *notifier)
 {
-    if (ATOMIC_BOOL_CAS(&notifier->paused, 0, 1)) {
-        // old value was "0" so we need to send a notification
-        uint8_t one = 1;
-        ssize_t written;
-        do {
-            written = write(notifier->fds[PARCNotifierWriteFd], &one, 1);
-            assertTrue(written >= 0, "Error writing to socket %d: %s", notifier->fds[PARCNotifierWriteFd], strerror(errno));
-        } while (written == 0);
-
-        return true;
-    } else {
-        // we're paused, so count up the pauses
-        ATOMIC_ADD_AND_FETCH(&notifier->skippedNotify, 1);
-        return false;
+    uint32_t state = __atomic_load_n(&notifier->state, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        if (state == _PARCNotifierState_Armed) {
+            if (__atomic_compare_exchange_n(&notifier->state, &state, _PARCNotifierState_Signalled,
+                                            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                _parcNotifier_Signal(notifier);
+                return true;
+            }
+        } else if (state & _PARCNotifierState_Pending) {
+            // The consumer already knows to look again.
+            return false;
+        } else if (__atomic_compare_exchange_n(&notifier->state, &state, state | _PARCNotifierState_Pending,
+                                               false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
     }
 }
 
 void
 parcNotifier_PauseEvents(PARCNotifier *notifier)
 {
-    // reset the skipped counter so we count from now until the StartEvents call
-    notifier->skippedNotify = 0;
-    ATOMIC_BOOL_CAS(&notifier->paused, 0, 1);
+    // Forget pending notifications: the consumer is about to look for work, and will see everything published before this.
+    __atomic_store_n(&notifier->state, _PARCNotifierState_Signalled, __ATOMIC_SEQ_CST);
 
-    // now clear out the socket
-    uint8_t buffer[16];
-    while (read(notifier->fds[PARCNotifierReadFd], &buffer, 16) > 0) {
-        ;
-    }
+    _parcNotifier_Drain(notifier);
 }
 
 void
 parcNotifier_StartEvents(PARCNotifier *notifier)
 {
-    ATOMIC_BOOL_CAS(&notifier->paused, 1, 0);
-    if (notifier->skippedNotify) {
+    // Re-arm and collect, in one step, whatever arrived while paused, so no notification can fall in between.
+    uint32_t previous = __atomic_exchange_n(&notifier->state, _PARCNotifierState_Armed, __ATOMIC_SEQ_CST);
+    if (previous & _PARCNotifierState_Pending) {
         // we missed some notifications, so re-signal ourself
         parcNotifier_Notify(notifier);
     }
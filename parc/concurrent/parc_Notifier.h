@@ -62,6 +62,10 @@
  * parcNotifier_PauseEvents() and parcRingBuffer1x1_Get() calls, then on parcNotifier_StartEvents()
  * an extra event will be triggered, even though the ring buffer is empty.
  *
+ * Only the first notification after parcNotifier_StartEvents() makes a system call.  While the
+ * consumer is paused, or already has an event waiting, parcNotifier_Notify() stays in userspace.
+ * On Linux the notifier is an eventfd, so it uses a single file descriptor; elsewhere it is a pipe.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
@@ -124,7 +128,7 @@ void parcNotifier_Release(PARCNotifier **notifier);
  * Fetches the notification socket
  *
  * The notification socket may be used in select() or poll() or similar
- * functions.  You should not read or write to the socket.
+ * functions, or given to a `PARCEvent` as a read event.  You should not read or write to the socket.
  *
  * @param [in] notifier The instance of `PARCNotifier`
  *
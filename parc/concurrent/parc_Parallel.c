@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * A parallel operation is a job: a count of chunks, a shared counter from which threads claim the next chunk,
+ * and a count of the chunks completed.  The calling thread gives the pool a few helper tasks that each claim chunks
+ * until none remain, claims chunks itself, and then waits for the chunks the helpers are still processing.
+ *
+ * A helper that runs late finds no chunks left and returns at once.  It holds a reference to the job,
+ * so the job outlives it even after the calling thread has returned.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Iterator.h>
+
+#include <parc/concurrent/parc_Parallel.h>
+#include <parc/concurrent/parc_FutureTask.h>
+
+// With an automatic grain, how many chunks to make for each thread, so that uneven chunks still balance.
+#define _PARCParallel_ChunksPerThread 8
+
+// The fewest elements parcParallel_Sort gives to one qsort when choosing the grain automatically.
+#define _PARCParallel_MinimumSortGrain 4096
+
+typedef struct _PARCParallelJob _PARCParallelJob;
+
+struct _PARCParallelJob {
+    size_t count;
+    size_t grain;
+    size_t chunks;
+
+    void (*runChunk)(_PARCParallelJob *job, size_t chunk, size_t begin, size_t end);
+    void *function;
+    void *context;
+    void **partials;
+
+    volatile size_t next;
+    volatile size_t completed;
+};
+
+parcObject_ExtendPARCObject(_PARCParallelJob, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static size_t
+_parcParallel_Threads(const PARCThreadPool *pool)
+{
+    return (pool == NULL) ? 1 : (size_t) parcThreadPool_GetMaximumPoolSize(pool) + 1;
+}
+
+static size_t
+_parcParallel_Grain(const PARCThreadPool *pool, size_t count, size_t grain)
+{
+    if (grain == 0) {
+        size_t chunks = _parcParallel_Threads(pool) * _PARCParallel_ChunksPerThread;
+        grain = (count + chunks - 1) / chunks;
+    }
+    return (grain == 0) ? 1 : grain;
+}
+
+/*
+ * Claim and process chunks until none remain.
+ */
+static void
+_parcParallelJob_Work(_PARCParallelJob *job)
+{
+    for (;;) {
+        size_t chunk = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (chunk >= job->chunks) {
+            return;
+        }
+
+        size_t begin = chunk * job->grain;
+        size_t end = (begin + job->grain < job->count) ? begin + job->grain : job->count;
+        job->runChunk(job, chunk, begin, end);
+
+        if (__atomic_add_fetch(&job->completed, 1, __ATOMIC_ACQ_REL) == job->chunks) {
+            parcObject_Lock(job);
+            parcObject_NotifyAll(job);
+            parcObject_Unlock(job);
+        }
+    }
+}
+
+static void *
+_parcParallelJob_Helper(PARCFutureTask *task, void *parameter)
+{
+    _parcParallelJob_Work(parameter);
+    return NULL;
+}
+
+static void
+_parcParallelJob_Run(PARCThreadPool *pool, _PARCParallelJob *job)
+{
+    if (job->chunks == 0) {
+        return;
+    }
+
+    if (pool != NULL && job->chunks > 1) {
+        size_t helpers = job->chunks - 1;
+        if (helpers > (size_t) parcThreadPool_GetMaximumPoolSize(pool)) {
+            helpers = (size_t) parcThreadPool_GetMaximumPoolSize(pool);
+        }
+
+        for (size_t i = 0; i < helpers; i++) {
+            PARCFutureTask *task = parcFutureTask_Create(_parcParallelJob_Helper, job);
+            bool accepted = parcThreadPool_Execute(pool, task);
+            parcFutureTask_Release(&task);
+            if (!accepted) {
+                break;
+            }
+        }
+    }
+
+    _parcParallelJob_Work(job);
+
+    if (__atomic_load_n(&job->completed, __ATOMIC_ACQUIRE) < job->chunks) {
+        parcObject_Lock(job);
+        while (__atomic_load_n(&job->completed, __ATOMIC_ACQUIRE) < job->chunks) {
+            parcObject_Wait(job);
+        }
+        parcObject_Unlock(job);
+    }
+}
+
+static _PARCParallelJob *
+_parcParallelJob_Create(const PARCThreadPool *pool, size_t count, size_t grain,
+                        void (*runChunk)(_PARCParallelJob *, size_t, size_t, size_t), void *function, void *context)
+{
+    _PARCParallelJob *result = parcObject_CreateInstance(_PARCParallelJob);
+    assertNotNull(result, "parcObject_CreateInstance returned NULL");
+
+    result->count = count;
+    result->grain = _parcParallel_Grain(pool, count, grain);
+    result->chunks = (count + result->grain - 1) / result->grain;
+    result->runChunk = runChunk;
+    result->function = function;
+    result->context = context;
+    result->partials = NULL;
+    result->next = 0;
+    result->completed = 0;
+
+    return result;
+}
+
+static void
+_parcParallel_ForChunk(_PARCParallelJob *job, size_t chunk, size_t begin, size_t end)
+{
+    PARCParallelRangeFunction *function = job->function;
+    function(begin, end, job->context);
+}
+
+void
+parcParallel_For(PARCThreadPool *pool, size_t count, size_t grain, PARCParallelRangeFunction *function, void *context)
+{
+    _PARCParallelJob *job = _parcParallelJob_Create(pool, count, grain, _parcParallel_ForChunk, function, context);
+
+    _parcParallelJob_Run(pool, job);
+
+    parcObject_Release((PARCObject **) &job);
+}
+
+typedef struct {
+    void **elements;
+    PARCParallelElementFunction *function;
+    void *context;
+} _PARCParallelForEach;
+
+static void
+_parcParallel_ForEachRange(size_t begin, size_t end, void *context)
+{
+    _PARCParallelForEach *forEach = context;
+    for (size_t i = begin; i < end; i++) {
+        forEach->function(forEach->elements[i], forEach->context);
+    }
+}
+
+static void
+_parcParallel_ForEachArray(PARCThreadPool *pool, void **elements, size_t count, PARCParallelElementFunction *function, void *context)
+{
+    _PARCParallelForEach forEach = { .elements = elements, .function = function, .context = context };
+
+    parcParallel_For(pool, count, 0, _parcParallel_ForEachRange, &forEach);
+}
+
+void
+parcParallel_ForEachArrayList(PARCThreadPool *pool, const PARCArrayList *list, PARCParallelElementFunction *function, void *context)
+{
+    size_t count = parcArrayList_Size(list);
+    if (count == 0) {
+        return;
+    }
+
+    void **elements = parcMemory_Allocate(count * sizeof(void *));
+    assertNotNull(elements, "parcMemory_Allocate(%zu) returned NULL", count * sizeof(void *));
+    for (size_t i = 0; i < count; i++) {
+        elements[i] = parcArrayList_Get(list, i);
+    }
+
+    _parcParallel_ForEachArray(pool, elements, count, function, context);
+
+    parcMemory_Deallocate(&elements);
+}
+
+void
+parcParallel_ForEachLinkedList(PARCThreadPool *pool, const PARCLinkedList *list, PARCParallelElementFunction *function, void *context)
+{
+    size_t count = parcLinkedList_Size(list);
+    if (count == 0) {
+        return;
+    }
+
+    void **elements = parcMemory_Allocate(count * sizeof(void *));
+    assertNotNull(elements, "parcMemory_Allocate(%zu) returned NULL", count * sizeof(void *));
+
+    PARCCursor cursor;
+    parcLinkedList_InitCursor(list, &cursor);
+    for (size_t i = 0; i < count && parcLinkedList_CursorNext(&cursor); i++) {
+        elements[i] = parcCursor_GetElement(&cursor);
+    }
+
+    _parcParallel_ForEachArray(pool, elements, count, function, context);
+
+    parcMemory_Deallocate(&elements);
+}
+
+typedef struct {
+    PARCParallelMapFunction *map;
+    PARCParallelReduceFunction *reduce;
+} _PARCParallelMapReduce;
+
+static void
+_parcParallel_MapChunk(_PARCParallelJob *job, size_t chunk, size_t begin, size_t end)
+{
+    _PARCParallelMapReduce *mapReduce = job->function;
+    job->partials[chunk] = mapReduce->map(begin, end, job->context);
+}
+
+void *
+parcParallel_MapReduce(PARCThreadPool *pool, size_t count, size_t grain,
+                       PARCParallelMapFunction *map, PARCParallelReduceFunction *reduce, void *context)
+{
+    if (count == 0) {
+        return NULL;
+    }
+
+    _PARCParallelMapReduce mapReduce = { .map = map, .reduce = reduce };
+    _PARCParallelJob *job = _parcParallelJob_Create(pool, count, grain, _parcParallel_MapChunk, &mapReduce, context);
+
+    job->partials = parcMemory_Allocate(job->chunks * sizeof(void *));
+    assertNotNull(job->partials, "parcMemory_Allocate(%zu) returned NULL", job->chunks * sizeof(void *));
+
+    _parcParallelJob_Run(pool, job);
+
+    void *result = job->partials[0];
+    for (size_t i = 1; i < job->chunks; i++) {
+        result = reduce(result, job->partials[i], context);
+    }
+
+    parcMemory_Deallocate(&job->partials);
+    parcObject_Release((PARCObject **) &job);
+
+    return result;
+}
+
+typedef struct {
+    uint8_t *base;
+    uint8_t *work;
+    size_t count;
+    size_t size;
+    size_t grain;
+    size_t width;
+    int (*compare)(const void *, const void *);
+} _PARCParallelSort;
+
+static void
+_parcParallel_SortRange(size_t begin, size_t end, void *context)
+{
+    _PARCParallelSort *sort = context;
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        size_t first = chunk * sort->grain;
+        size_t last = (first + sort->grain < sort->count) ? first + sort->grain : sort->count;
+        qsort(sort->base + first * sort->size, last - first, sort->size, sort->compare);
+    }
+}
+
+/*
+ * Merge each pair of adjacent sorted runs of `width` elements from `base` into `work`.
+ */
+static void
+_parcParallel_MergeRange(size_t begin, size_t end, void *context)
+{
+    _PARCParallelSort *sort = context;
+    const size_t size = sort->size;
+
+    for (size_t pair = begin; pair < end; pair++) {
+        size_t left = pair * 2 * sort->width;
+        size_t middle = (left + sort->width < sort->count) ? left + sort->width : sort->count;
+        size_t right = (middle + sort->width < sort->count) ? middle + sort->width : sort->count;
+
+        size_t i = left;
+        size_t j = middle;
+        uint8_t *output = sort->work + left * size;
+
+        while (i < middle && j < right) {
+            if (sort->compare(sort->base + j * size, sort->base + i * size) < 0) {
+                memcpy(output, sort->base + j++ * size, size);
+            } else {
+                memcpy(output, sort->base + i++ * size, size);
+            }
+            output += size;
+        }
+        memcpy(output, sort->base + i * size, (middle - i) * size);
+        output += (middle - i) * size;
+        memcpy(output, sort->base + j * size, (right - j) * size);
+    }
+}
+
+void
+parcParallel_Sort(PARCThreadPool *pool, void *base, size_t count, size_t size, int (*compare)(const void *, const void *))
+{
+    size_t grain = _parcParallel_Grain(pool, count, 0);
+    if (grain < _PARCParallel_MinimumSortGrain) {
+        grain = _PARCParallel_MinimumSortGrain;
+    }
+
+    if (pool == NULL || count <= grain) {
+        qsort(base, count, size, compare);
+        return;
+    }
+
+    _PARCParallelSort sort = {
+        .base = base,
+        .work = parcMemory_Allocate(count * size),
+        .count = count,
+        .size = size,
+        .grain = grain,
+        .compare = compare
+    };
+    assertNotNull(sort.work, "parcMemory_Allocate(%zu) returned NULL", count * size);
+
+    size_t runs = (count + grain - 1) / grain;
+    parcParallel_For(pool, runs, 1, _parcParallel_SortRange, &sort);
+
+    for (sort.width = grain; sort.width < count; sort.width *= 2) {
+        size_t pairs = (count + 2 * sort.width - 1) / (2 * sort.width);
+        parcParallel_For(pool, pairs, 1, _parcParallel_MergeRange, &sort);
+
+        uint8_t *swap = sort.base;
+        sort.base = sort.work;
+        sort.work = swap;
+    }
+
+    // After an odd number of rounds the sorted elements are in the working memory.
+    if (sort.base != base) {
+        memcpy(base, sort.base, count * size);
+        sort.work = sort.base;
+    }
+    parcMemory_Deallocate(&sort.work);
+}
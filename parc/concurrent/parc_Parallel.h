@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_Parallel.h
+ * @ingroup threading
+ * @brief Parallel loops, map-reduce and sorting on a `PARCThreadPool`.
+ *
+ * Each function divides a range of indexes `[0, count)` into chunks of consecutive indexes,
+ * and the calling thread and the threads of the pool take chunks until none remain.
+ * The function returns when every chunk has been processed.
+ *
+ * The calling thread works on chunks too, so these functions make progress even if every thread of the pool is busy,
+ * and they may be called from a task running on the same pool.
+ *
+ * The grain is the number of indexes in a chunk.  A grain of 0 chooses one automatically, making several chunks for
+ * each thread so that uneven chunks still balance.  Give an explicit grain when each index is very cheap,
+ * so that a chunk is worth the cost of handing it to another thread.
+ *
+ * @code
+ * {
+ *     // Hash many buffers.
+ *     static void
+ *     _hashRange(size_t begin, size_t end, void *context)
+ *     {
+ *         struct batch *batch = context;
+ *         for (size_t i = begin; i < end; i++) {
+ *             batch->hashes[i] = parcCryptoHasher_Hash(batch->hashers[i], batch->buffers[i]);
+ *         }
+ *     }
+ *
+ *     parcParallel_For(pool, batch->count, 0, _hashRange, batch);
+ * }
+ * @endcode
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_Parallel
+#define PARCLibrary_parc_Parallel
+#include <stddef.h>
+
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/algol/parc_LinkedList.h>
+#include <parc/concurrent/parc_ThreadPool.h>
+
+/**
+ * Process the indexes `[begin, end)`.
+ */
+typedef void (PARCParallelRangeFunction)(size_t begin, size_t end, void *context);
+
+/**
+ * Process one element of a collection.
+ */
+typedef void (PARCParallelElementFunction)(void *element, void *context);
+
+/**
+ * Compute a partial result for the indexes `[begin, end)`.
+ */
+typedef void *(PARCParallelMapFunction)(size_t begin, size_t end, void *context);
+
+/**
+ * Combine the partial results of two adjacent ranges, @p left preceding @p right, into one.
+ *
+ * The function owns both partial results, and must free any it does not return.
+ */
+typedef void *(PARCParallelReduceFunction)(void *left, void *right, void *context);
+
+/**
+ * Call @p function on chunks of the indexes `[0, count)`, in parallel.
+ *
+ * @p function is called concurrently on different chunks, and must be safe to do so.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool` to share the work with, or NULL to do it all on the calling thread.
+ * @param [in] count The number of indexes.
+ * @param [in] grain The number of indexes in a chunk, or 0 to choose automatically.
+ * @param [in] function The function to call on each chunk.
+ * @param [in] context Passed to @p function.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcParallel_For(pool, count, 0, _verifyRange, signatures);
+ * }
+ * @endcode
+ */
+void parcParallel_For(PARCThreadPool *pool, size_t count, size_t grain, PARCParallelRangeFunction *function, void *context);
+
+/**
+ * Call @p function on each element of a `PARCArrayList`, in parallel.
+ *
+ * The list must not be modified until this function returns.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool`, or NULL.
+ * @param [in] list A pointer to a valid `PARCArrayList`.
+ * @param [in] function The function to call on each element.
+ * @param [in] context Passed to @p function.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcParallel_ForEachArrayList(pool, buffers, _hashBuffer, hashes);
+ * }
+ * @endcode
+ */
+void parcParallel_ForEachArrayList(PARCThreadPool *pool, const PARCArrayList *list, PARCParallelElementFunction *function, void *context);
+
+/**
+ * Call @p function on each element of a `PARCLinkedList`, in parallel.
+ *
+ * A linked list cannot be divided without walking it, so the elements are first copied to an array,
+ * on the calling thread.  The list must not be modified until this function returns.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool`, or NULL.
+ * @param [in] list A pointer to a valid `PARCLinkedList`.
+ * @param [in] function The function to call on each element.
+ * @param [in] context Passed to @p function.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcParallel_ForEachLinkedList(pool, signatures, _verify, verifier);
+ * }
+ * @endcode
+ */
+void parcParallel_ForEachLinkedList(PARCThreadPool *pool, const PARCLinkedList *list, PARCParallelElementFunction *function, void *context);
+
+/**
+ * Compute a result over the indexes `[0, count)` by mapping chunks in parallel and reducing their partial results.
+ *
+ * The partial results are reduced in the order of their chunks, so @p reduce need only be associative, not commutative.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool`, or NULL.
+ * @param [in] count The number of indexes.
+ * @param [in] grain The number of indexes in a chunk, or 0 to choose automatically.
+ * @param [in] map The function computing the partial result of a chunk.
+ * @param [in] reduce The function combining two partial results.
+ * @param [in] context Passed to @p map and @p reduce.
+ *
+ * @return The reduction of the partial results of all the chunks, or NULL if @p count is 0.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t *total = parcParallel_MapReduce(pool, count, 0, _sumRange, _addSums, values);
+ * }
+ * @endcode
+ */
+void *parcParallel_MapReduce(PARCThreadPool *pool, size_t count, size_t grain,
+                             PARCParallelMapFunction *map, PARCParallelReduceFunction *reduce, void *context);
+
+/**
+ * Sort an array in place, in parallel.
+ *
+ * Chunks of the array are sorted with `qsort`, and then merged pairwise in parallel rounds.
+ * The sort is not stable.  It needs working memory the size of the array.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool`, or NULL.
+ * @param [in,out] base A pointer to the first element of the array.
+ * @param [in] count The number of elements.
+ * @param [in] size The size in bytes of each element.
+ * @param [in] compare A function returning less than, equal to, or greater than zero
+ *                     as its first argument is less than, equal to, or greater than its second.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcParallel_Sort(pool, keys, count, sizeof(uint64_t), _compareKeys);
+ * }
+ * @endcode
+ */
+void parcParallel_Sort(PARCThreadPool *pool, void *base, size_t count, size_t size, int (*compare)(const void *, const void *));
+#endif
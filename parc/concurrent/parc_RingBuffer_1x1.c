@@ -77,9 +77,21 @@
  * put x1          0    65534   15 + 65534 -     0 = 13 - 65535 = 13 - ( 0) = 13
  * ...
  *
- * If (writer_head + 1) & ring_mask == reader_tail, then the ring is full.
+ * If writer_head - reader_tail == ring_mask, then the ring is full.
  * If writer_head == reader_tail, then the ring is empty.
  *
+ * The producer publishes writer_head with a release store after writing the buffer, and the consumer
+ * publishes reader_tail with a release store after reading it.  Each side reads the other's index with an
+ * acquire load, so the buffer contents are always visible before the index that covers them.
+ *
+ * writer_head and reader_tail are on separate cache lines.  Each side also keeps a private copy of the
+ * other side's index, and only reloads the shared one when the copy says the ring is full (for the
+ * producer) or empty (for the consumer).  In steady state a Put or Get touches only its own cache line
+ * and the buffer.
+ *
+ * PutBatch and GetBatch move up to N items and publish the index once, so the other side sees one
+ * cache line transfer per batch rather than one per item.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
@@ -98,34 +110,23 @@
 
 #include <parc/concurrent/parc_RingBuffer_1x1.h>
 
-#ifdef __GNUC__
-
-// on x86 or x86_64, simple assignment will work
-#if (__x86_64__ || __i386__)
-#define ATOMIC_ADD_AND_FETCH(ptr, increment)      __sync_add_and_fetch(ptr, increment)
-#define ATOMIC_BOOL_CAS(ptr, oldvalue, newvalue)  __sync_bool_compare_and_swap(ptr, oldvalue, newvalue)
-#define ATOMIC_FETCH(ptr)                        *(ptr)
-#define ATOMIC_SET(ptr, oldvalue, newvalue)      *(ptr) = newvalue
-#else
-#define ATOMIC_ADD_AND_FETCH(ptr, increment)      __sync_add_and_fetch(ptr, increment)
-#define ATOMIC_BOOL_CAS(ptr, oldvalue, newvalue)  __sync_bool_compare_and_swap(ptr, oldvalue, newvalue)
-#define ATOMIC_FETCH(ptr)                         ATOMIC_ADD_AND_FETCH(ptr, 0)
-#define ATOMIC_SET(ptr, oldvalue, newvalue)       ATOMIC_BOOL_CAS(ptr, oldvalue, newvalue)
-#endif
-
-#else
-#error "Only GNUC supported, we need atomic operations"
-#endif
-
 struct parc_ringbuffer_1x1 {
-    // LP64     LP32
-    volatile uint32_t writer_head;          //  0- 3       0
-    volatile uint32_t reader_tail;          //  4- 7       4
-    uint32_t elements;                      //  8-11       8
-    uint32_t ring_mask;                     // 12-15      12
-
-    RingBufferEntryDestroyer *destroyer;    // 16-23      16
-    void **buffer;                          // 24-31      24
+    // Read-only after create.
+    uint32_t elements;
+    uint32_t ring_mask;
+    RingBufferEntryDestroyer *destroyer;
+    void **buffer;
+
+    // Written only by the producer.
+    uint8_t padding0[LEVEL1_DCACHE_LINESIZE];
+    volatile uint32_t writer_head;
+    uint32_t writer_cached_reader_tail;
+    uint8_t padding1[LEVEL1_DCACHE_LINESIZE - 2 * sizeof(uint32_t)];
+
+    // Written only by the consumer.
+    volatile uint32_t reader_tail;
+    uint32_t reader_cached_writer_head;
+    uint8_t padding2[LEVEL1_DCACHE_LINESIZE - 2 * sizeof(uint32_t)];
 };
 
 static bool
@@ -160,7 +161,9 @@ _create(uint32_t elements, RingBufferEntryDestroyer *destroyer)
     assertNotNull((ring->buffer), "parcMemory_AllocateAndClear() failed to allocate array of %u pointers", elements);
 
     ring->writer_head = 0;
+    ring->writer_cached_reader_tail = 0;
     ring->reader_tail = 0;
+    ring->reader_cached_writer_head = 0;
     ring->elements = elements;
     ring->destroyer = destroyer;
     ring->ring_mask = elements - 1;
@@ -180,69 +183,172 @@ parcObject_ImplementAcquire(parcRingBuffer1x1, PARCRingBuffer1x1);
 
 parcObject_ImplementRelease(parcRingBuffer1x1, PARCRingBuffer1x1);
 
-/**
- * Put is protected by the writer mutex.  This means that the tail mutex could
- * actually increase while this is happening. That's ok.  Increasing the tail
- * just means there is _more_ room in the ring.  We only modify writer_head.
+/*
+ * The number of free slots the producer can see, reloading reader_tail only if the cached copy shows fewer than wanted.
  */
+static uint32_t
+_parcRingBuffer1x1_Free(PARCRingBuffer1x1 *ring, uint32_t writer_head, uint32_t wanted)
+{
+    uint32_t free = ring->ring_mask - (writer_head - ring->writer_cached_reader_tail);
+    if (free < wanted) {
+        ring->writer_cached_reader_tail = __atomic_load_n(&ring->reader_tail, __ATOMIC_ACQUIRE);
+        free = ring->ring_mask - (writer_head - ring->writer_cached_reader_tail);
+    }
+    return free;
+}
+
+/*
+ * The number of items the consumer can see, reloading writer_head only if the cached copy shows fewer than wanted.
+ */
+static uint32_t
+_parcRingBuffer1x1_Available(PARCRingBuffer1x1 *ring, uint32_t reader_tail, uint32_t wanted)
+{
+    uint32_t available = ring->reader_cached_writer_head - reader_tail;
+    if (available < wanted) {
+        ring->reader_cached_writer_head = __atomic_load_n(&ring->writer_head, __ATOMIC_ACQUIRE);
+        available = ring->reader_cached_writer_head - reader_tail;
+    }
+    return available;
+}
+
 bool
 parcRingBuffer1x1_Put(PARCRingBuffer1x1 *ring, void *data)
 {
-    // Our speculative operation
-    // The consumer modifies reader_tail, so make sure that's an atomic read.
-    // only the prodcuer modifies writer_head, so there's only us
-
+    // only the producer modifies writer_head, so there's only us
     uint32_t writer_head = ring->writer_head;
-    uint32_t reader_tail = ATOMIC_FETCH(&ring->reader_tail);
-
-    uint32_t writer_next = (writer_head + 1) & ring->ring_mask;
 
     // ring is full
-    if (writer_next == reader_tail) {
+    if (_parcRingBuffer1x1_Free(ring, writer_head, 1) == 0) {
         return false;
     }
 
-    assertNull(ring->buffer[writer_head], "Ring index %u is not null!", writer_head);
-    ring->buffer[writer_head] = data;
+    uint32_t index = writer_head & ring->ring_mask;
+    assertNull(ring->buffer[index], "Ring index %u is not null!", index);
+    ring->buffer[index] = data;
 
-    // we're using this just for atomic write to the integer
-    ATOMIC_SET(&ring->writer_head, writer_head, writer_next);
+    __atomic_store_n(&ring->writer_head, writer_head + 1, __ATOMIC_RELEASE);
 
     return true;
 }
 
+uint32_t
+parcRingBuffer1x1_PutBatch(PARCRingBuffer1x1 *ring, void *const data[], uint32_t count)
+{
+    uint32_t writer_head = ring->writer_head;
+
+    uint32_t free = _parcRingBuffer1x1_Free(ring, writer_head, count);
+    if (count > free) {
+        count = free;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = (writer_head + i) & ring->ring_mask;
+        assertNull(ring->buffer[index], "Ring index %u is not null!", index);
+        ring->buffer[index] = data[i];
+    }
+
+    if (count > 0) {
+        __atomic_store_n(&ring->writer_head, writer_head + count, __ATOMIC_RELEASE);
+    }
+
+    return count;
+}
+
 bool
 parcRingBuffer1x1_Get(PARCRingBuffer1x1 *ring, void **outputDataPtr)
 {
-    // do our speculative operation.
-    // The producer modifies writer_head, so make sure that's an atomic read.
     // only the consumer modifies reader_tail, so there's only us
-
-    uint32_t writer_head = ATOMIC_FETCH(&ring->writer_head); // native type assignment is atomic
     uint32_t reader_tail = ring->reader_tail;
-    uint32_t reader_next = (reader_tail + 1) & ring->ring_mask;
 
     // ring is empty
-    if (writer_head == reader_tail) {
+    if (_parcRingBuffer1x1_Available(ring, reader_tail, 1) == 0) {
         return false;
     }
 
-    // now try to commit it
-    ATOMIC_SET(&ring->reader_tail, reader_tail, reader_next);
-
-    *outputDataPtr = ring->buffer[reader_tail];
+    uint32_t index = reader_tail & ring->ring_mask;
+    *outputDataPtr = ring->buffer[index];
 
     // for sanity's sake
-    ring->buffer[reader_tail] = NULL;
+    ring->buffer[index] = NULL;
+
+    // Publish only after the slot has been read, or the producer could overwrite it.
+    __atomic_store_n(&ring->reader_tail, reader_tail + 1, __ATOMIC_RELEASE);
 
     return true;
 }
 
+uint32_t
+parcRingBuffer1x1_GetBatch(PARCRingBuffer1x1 *ring, void *outputData[], uint32_t maximum)
+{
+    uint32_t reader_tail = ring->reader_tail;
+
+    uint32_t count = _parcRingBuffer1x1_Available(ring, reader_tail, maximum);
+    if (count > maximum) {
+        count = maximum;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = (reader_tail + i) & ring->ring_mask;
+        outputData[i] = ring->buffer[index];
+        ring->buffer[index] = NULL;
+    }
+
+    if (count > 0) {
+        __atomic_store_n(&ring->reader_tail, reader_tail + count, __ATOMIC_RELEASE);
+    }
+
+    return count;
+}
+
+typedef struct {
+    PARCRingBuffer1x1 *ring;
+    void *data;
+    void **outputDataPtr;
+} _parcRingBuffer1x1Attempt;
+
+static bool
+_parcRingBuffer1x1_AttemptPut(void *context)
+{
+    _parcRingBuffer1x1Attempt *attempt = context;
+    return parcRingBuffer1x1_Put(attempt->ring, attempt->data);
+}
+
+static bool
+_parcRingBuffer1x1_AttemptGet(void *context)
+{
+    _parcRingBuffer1x1Attempt *attempt = context;
+    return parcRingBuffer1x1_Get(attempt->ring, attempt->outputDataPtr);
+}
+
+bool
+parcRingBuffer1x1_PutWait(PARCRingBuffer1x1 *ring, void *data, PARCWaitStrategy *strategy, const PARCTimeout *timeout)
+{
+    _parcRingBuffer1x1Attempt attempt = { .ring = ring, .data = data };
+
+    bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotFull, _parcRingBuffer1x1_AttemptPut, &attempt, timeout);
+    if (result) {
+        parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotEmpty);
+    }
+    return result;
+}
+
+bool
+parcRingBuffer1x1_GetWait(PARCRingBuffer1x1 *ring, void **outputDataPtr, PARCWaitStrategy *strategy, const PARCTimeout *timeout)
+{
+    _parcRingBuffer1x1Attempt attempt = { .ring = ring, .outputDataPtr = outputDataPtr };
+
+    bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _parcRingBuffer1x1_AttemptGet, &attempt, timeout);
+    if (result) {
+        parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotFull);
+    }
+    return result;
+}
+
 uint32_t
 parcRingBuffer1x1_Remaining(PARCRingBuffer1x1 *ring)
 {
-    uint32_t writer_head = ATOMIC_FETCH(&ring->writer_head);
-    uint32_t reader_tail = ATOMIC_FETCH(&ring->reader_tail);
+    uint32_t writer_head = __atomic_load_n(&ring->writer_head, __ATOMIC_ACQUIRE);
+    uint32_t reader_tail = __atomic_load_n(&ring->reader_tail, __ATOMIC_ACQUIRE);
 
     return (ring->ring_mask + reader_tail - writer_head) & ring->ring_mask;
 }
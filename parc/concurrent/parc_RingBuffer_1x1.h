@@ -44,6 +44,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <parc/concurrent/parc_Timeout.h>
+#include <parc/concurrent/parc_WaitStrategy.h>
+
 struct parc_ringbuffer_1x1;
 typedef struct parc_ringbuffer_1x1 PARCRingBuffer1x1;
 
@@ -119,6 +122,34 @@ void parcRingBuffer1x1_Release(PARCRingBuffer1x1 **ringPtr);
  */
 bool parcRingBuffer1x1_Put(PARCRingBuffer1x1 *ring, void *data);
 
+/**
+ * Non-blocking attempt to put up to @p count items on the ring.
+ *
+ * The items are put in order, as if by successive calls to {@link parcRingBuffer1x1_Put}, but
+ * the consumer is shown them all at once.  If the ring does not have room for all of them,
+ * as many as fit are put.
+ *
+ * @param [in,out] ring The instance of `PARCRingBuffer1x1` on which to put the @p data.
+ * @param [in] data An array of @p count items to put on the @p ring.
+ * @param [in] count The number of items in @p data.
+ *
+ * @return The number of items put, from 0 to @p count.  The first that many elements of @p data are on the ring.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *items[16];
+ *     uint32_t count = fillItems(items, 16);
+ *
+ *     uint32_t put = 0;
+ *     while (put < count) {
+ *         put += parcRingBuffer1x1_PutBatch(ring, &items[put], count - put);
+ *     }
+ * }
+ * @endcode
+ */
+uint32_t parcRingBuffer1x1_PutBatch(PARCRingBuffer1x1 *ring, void *const data[], uint32_t count);
+
 /**
  * Gets the next item off the ring, or returns false if would have blocked.
  *
@@ -137,6 +168,31 @@ bool parcRingBuffer1x1_Put(PARCRingBuffer1x1 *ring, void *data);
  */
 bool parcRingBuffer1x1_Get(PARCRingBuffer1x1 *ring, void **outputDataPtr);
 
+/**
+ * Gets up to @p maximum items off the ring without blocking.
+ *
+ * The items are returned in order, as if by successive calls to {@link parcRingBuffer1x1_Get}, but
+ * the producer is given back their space all at once.
+ *
+ * @param [in] ring The ring buffer
+ * @param [out] outputData An array of at least @p maximum elements to receive the items.
+ * @param [in] maximum The largest number of items to get.
+ *
+ * @return The number of items returned in @p outputData, from 0 to @p maximum.  0 means the ring was empty.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *items[16];
+ *     uint32_t count = parcRingBuffer1x1_GetBatch(ring, items, 16);
+ *     for (uint32_t i = 0; i < count; i++) {
+ *         process(items[i]);
+ *     }
+ * }
+ * @endcode
+ */
+uint32_t parcRingBuffer1x1_GetBatch(PARCRingBuffer1x1 *ring, void *outputData[], uint32_t maximum);
+
 /**
  * Returns the remaining capacity of the ring
  *
@@ -153,4 +209,53 @@ bool parcRingBuffer1x1_Get(PARCRingBuffer1x1 *ring, void **outputDataPtr);
  * @endcode
  */
 uint32_t parcRingBuffer1x1_Remaining(PARCRingBuffer1x1 *ring);
+
+/**
+ * Put an item on the ring, waiting for room if the ring is full.
+ *
+ * Between attempts the thread waits as @p strategy directs.  After the item is put,
+ * any consumer parked in {@link parcRingBuffer1x1_GetWait} with the same @p strategy is woken.
+ *
+ * @param [in,out] ring The instance of `PARCRingBuffer1x1` on which to put the @p data.
+ * @param [in] data The data to put on the @p ring.
+ * @param [in] strategy The `PARCWaitStrategy` shared by the users of @p ring.
+ * @param [in] timeout The longest time to wait, or `PARCTimeout_Never`.
+ *
+ * @return `true` Data was put on the queue
+ * @return `false` The timeout expired while the queue was full
+ *
+ * Example:
+ * @code
+ * {
+ *     parcRingBuffer1x1_PutWait(ring, item, strategy, PARCTimeout_Never);
+ * }
+ * @endcode
+ */
+bool parcRingBuffer1x1_PutWait(PARCRingBuffer1x1 *ring, void *data, PARCWaitStrategy *strategy, const PARCTimeout *timeout);
+
+/**
+ * Get the next item off the ring, waiting for one if the ring is empty.
+ *
+ * Between attempts the thread waits as @p strategy directs.  After the item is taken,
+ * any producer parked in {@link parcRingBuffer1x1_PutWait} with the same @p strategy is woken.
+ *
+ * @param [in] ring The ring buffer
+ * @param [out] outputDataPtr The output pointer
+ * @param [in] strategy The `PARCWaitStrategy` shared by the users of @p ring.
+ * @param [in] timeout The longest time to wait, or `PARCTimeout_Never`.
+ *
+ * @return `true` Data returned in the output argument
+ * @return `false` The timeout expired while the ring was empty, no data returned.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *item;
+ *     if (parcRingBuffer1x1_GetWait(ring, &item, strategy, parcTimeout_MilliSeconds(10))) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool parcRingBuffer1x1_GetWait(PARCRingBuffer1x1 *ring, void **outputDataPtr, PARCWaitStrategy *strategy, const PARCTimeout *timeout);
 #endif // libparc_parc_RingBuffer_1x1_h
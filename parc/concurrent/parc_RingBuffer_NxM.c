@@ -27,7 +27,25 @@
 /**
  * A thread-safe fixed size ring buffer.
  *
- * The multiple producer, multiple consumer version uses a pthread mutex around a NxM ring buffer.
+ * The multiple producer, multiple consumer version is lock-free, along the lines of Dmitry Vyukov's
+ * bounded MPMC queue.  Each cell carries a sequence number next to its data pointer.
+ *
+ * enqueue_position is the next position a producer will claim and dequeue_position is the next position
+ * a consumer will claim.  Like the 1x1 ring, both are unbounded uint32_t counters that are masked with
+ * (elements-1) to find the cell.
+ *
+ * A cell's sequence number says whose turn it is.  For the position p that maps to the cell:
+ *     sequence == p      the cell is empty and the producer of p may fill it
+ *     sequence == p + 1  the cell holds the item for p and the consumer of p may take it
+ * After the consumer of p takes the item it sets sequence to p + elements, which hands the cell to the
+ * producer one lap later.
+ *
+ * A producer or consumer claims its position with a compare-and-swap on the shared counter, and only
+ * then touches the cell, so threads contend on a single counter per side and never on a lock.  The two
+ * counters are on separate cache lines so that producers and consumers do not share a line.
+ *
+ * To keep the same capacity as the 1x1 ring, (elements-1) items, a producer also requires that the cell
+ * after its own has been emptied from the previous lap.
  *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
@@ -36,9 +54,6 @@
 #include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
-#include <errno.h>
-#include <string.h>
 
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_Object.h>
@@ -47,37 +62,28 @@
 #include <parc/concurrent/parc_RingBuffer_1x1.h>
 #include <parc/concurrent/parc_RingBuffer_NxM.h>
 
-struct parc_ringbuffer_NxM {
-    PARCRingBuffer1x1 *onebyone;
-
-    // This protectes the overall data structure for Acquire and Release
-    pthread_mutex_t allocation_mutex;
-
-    pthread_mutex_t writer_mutex;
-    pthread_mutex_t reader_mutex;
+typedef struct {
+    volatile uint32_t sequence;
+    void *data;
+} _PARCRingBufferNxMCell;
 
+struct parc_ringbuffer_NxM {
+    _PARCRingBufferNxMCell *cells;
+    uint32_t elements;
+    uint32_t ring_mask;
     RingBufferEntryDestroyer *destroyer;
-};
 
-/*
- * Attemps a lock and returns false if we cannot get it.
- *
- * @endcode
- */
-static bool
-_lock(pthread_mutex_t *mutex)
-{
-    int failure = pthread_mutex_lock(mutex);
-    assertFalse(failure, "Error locking mutex: (%d) %s\n", errno, strerror(errno));
-    return true;
-}
+    uint8_t padding0[LEVEL1_DCACHE_LINESIZE];
+    volatile uint32_t enqueue_position;
+    uint8_t padding1[LEVEL1_DCACHE_LINESIZE - sizeof(uint32_t)];
+    volatile uint32_t dequeue_position;
+    uint8_t padding2[LEVEL1_DCACHE_LINESIZE - sizeof(uint32_t)];
+};
 
 static bool
-_unlock(pthread_mutex_t *mutex)
+_isPowerOfTwo(uint32_t x)
 {
-    int failure = pthread_mutex_unlock(mutex);
-    assertFalse(failure, "Error unlocking mutex: (%d) %s\n", errno, strerror(errno));
-    return true;
+    return ((x != 0) && !(x & (x - 1)));
 }
 
 static void
@@ -91,10 +97,9 @@ _destroy(PARCRingBufferNxM **ringptr)
             ring->destroyer(&ptr);
         }
     }
-    parcRingBuffer1x1_Release(&ring->onebyone);
+    parcMemory_Deallocate((void **) &ring->cells);
 }
 
-
 parcObject_ExtendPARCObject(PARCRingBufferNxM, _destroy, NULL, NULL, NULL, NULL, NULL, NULL);
 
 static PARCRingBufferNxM *
@@ -103,78 +108,154 @@ _create(uint32_t elements, RingBufferEntryDestroyer *destroyer)
     PARCRingBufferNxM *ring = parcObject_CreateInstance(PARCRingBufferNxM);
     assertNotNull(ring, "parcObject_Create returned NULL");
 
-    ring->onebyone = parcRingBuffer1x1_Create(elements, destroyer);
+    ring->cells = parcMemory_Allocate(sizeof(_PARCRingBufferNxMCell) * elements);
+    assertNotNull(ring->cells, "parcMemory_Allocate() failed to allocate array of %u cells", elements);
+
+    for (uint32_t i = 0; i < elements; i++) {
+        ring->cells[i].sequence = i;
+        ring->cells[i].data = NULL;
+    }
+
+    ring->elements = elements;
+    ring->ring_mask = elements - 1;
     ring->destroyer = destroyer;
-    pthread_mutex_init(&ring->allocation_mutex, NULL);
-    pthread_mutex_init(&ring->writer_mutex, NULL);
-    pthread_mutex_init(&ring->reader_mutex, NULL);
+    ring->enqueue_position = 0;
+    ring->dequeue_position = 0;
     return ring;
 }
 
 PARCRingBufferNxM *
 parcRingBufferNxM_Create(uint32_t elements, RingBufferEntryDestroyer *destroyer)
 {
+    assertTrue(_isPowerOfTwo(elements), "Parameter elements must be a power of 2, got %u", elements);
     return _create(elements, destroyer);
 }
 
 PARCRingBufferNxM *
 parcRingBufferNxM_Acquire(PARCRingBufferNxM *ring)
 {
-    PARCRingBufferNxM *acquired;
-
-    _lock(&ring->allocation_mutex);
-    acquired = parcObject_Acquire(ring);
-    _unlock(&ring->allocation_mutex);
-
-    return acquired;
+    return parcObject_Acquire(ring);
 }
 
 void
 parcRingBufferNxM_Release(PARCRingBufferNxM **ringPtr)
 {
-    PARCRingBufferNxM *ring = *ringPtr;
-    _lock(&ring->allocation_mutex);
     parcObject_Release((void **) ringPtr);
-    _unlock(&ring->allocation_mutex);
 }
 
-/**
- * Put is protected by the writer mutex.  This means that the tail mutex could
- * actually increase while this is happening. That's ok.  Increasing the tail
- * just means there is _more_ room in the ring.  We only modify writer_head.
- */
 bool
 parcRingBufferNxM_Put(PARCRingBufferNxM *ring, void *data)
 {
-    // **** LOCK
-    _lock(&ring->writer_mutex);
-    bool success = parcRingBuffer1x1_Put(ring->onebyone, data);
-    // **** UNLOCK
-    _unlock(&ring->writer_mutex);
-    return success;
+    uint32_t position = __atomic_load_n(&ring->enqueue_position, __ATOMIC_RELAXED);
+
+    for (;;) {
+        _PARCRingBufferNxMCell *cell = &ring->cells[position & ring->ring_mask];
+        int32_t difference = (int32_t) (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - position);
+
+        if (difference == 0) {
+            // The next cell must not still hold an item from the previous lap, or the ring would be full.
+            _PARCRingBufferNxMCell *next = &ring->cells[(position + 1) & ring->ring_mask];
+            if ((int32_t) (__atomic_load_n(&next->sequence, __ATOMIC_ACQUIRE) - (position + 1)) < 0) {
+                return false;
+            }
+            if (__atomic_compare_exchange_n(&ring->enqueue_position, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->data = data;
+                __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            // The failed compare-and-swap reloaded position.
+        } else if (difference < 0) {
+            // The cell still holds an item from the previous lap: the ring is full.
+            return false;
+        } else {
+            // Another producer has claimed this position.
+            position = __atomic_load_n(&ring->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
 }
 
 bool
 parcRingBufferNxM_Get(PARCRingBufferNxM *ring, void **outputDataPtr)
 {
-    // **** LOCK
-    _lock(&ring->reader_mutex);
-    bool success = parcRingBuffer1x1_Get(ring->onebyone, outputDataPtr);
-    // **** UNLOCK
-    _unlock(&ring->reader_mutex);
-    return success;
+    uint32_t position = __atomic_load_n(&ring->dequeue_position, __ATOMIC_RELAXED);
+
+    for (;;) {
+        _PARCRingBufferNxMCell *cell = &ring->cells[position & ring->ring_mask];
+        int32_t difference = (int32_t) (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (position + 1));
+
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeue_position, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *outputDataPtr = cell->data;
+                __atomic_store_n(&cell->sequence, position + ring->elements, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The producer of this position has not filled the cell: the ring is empty.
+            return false;
+        } else {
+            // Another consumer has claimed this position.
+            position = __atomic_load_n(&ring->dequeue_position, __ATOMIC_RELAXED);
+        }
+    }
 }
 
-uint32_t
-parcRingBufferNxM_Remaining(PARCRingBufferNxM *ring)
+typedef struct {
+    PARCRingBufferNxM *ring;
+    void *data;
+    void **outputDataPtr;
+} _parcRingBufferNxMAttempt;
+
+static bool
+_parcRingBufferNxM_AttemptPut(void *context)
+{
+    _parcRingBufferNxMAttempt *attempt = context;
+    return parcRingBufferNxM_Put(attempt->ring, attempt->data);
+}
+
+static bool
+_parcRingBufferNxM_AttemptGet(void *context)
+{
+    _parcRingBufferNxMAttempt *attempt = context;
+    return parcRingBufferNxM_Get(attempt->ring, attempt->outputDataPtr);
+}
+
+bool
+parcRingBufferNxM_PutWait(PARCRingBufferNxM *ring, void *data, PARCWaitStrategy *strategy, const PARCTimeout *timeout)
+{
+    _parcRingBufferNxMAttempt attempt = { .ring = ring, .data = data };
+
+    bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotFull, _parcRingBufferNxM_AttemptPut, &attempt, timeout);
+    if (result) {
+        parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotEmpty);
+    }
+    return result;
+}
+
+bool
+parcRingBufferNxM_GetWait(PARCRingBufferNxM *ring, void **outputDataPtr, PARCWaitStrategy *strategy, const PARCTimeout *timeout)
 {
-    _lock(&ring->writer_mutex);
-    _lock(&ring->reader_mutex);
+    _parcRingBufferNxMAttempt attempt = { .ring = ring, .outputDataPtr = outputDataPtr };
 
-    uint32_t remaining = parcRingBuffer1x1_Remaining(ring->onebyone);
+    bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _parcRingBufferNxM_AttemptGet, &attempt, timeout);
+    if (result) {
+        parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotFull);
+    }
+    return result;
+}
 
-    _unlock(&ring->reader_mutex);
-    _unlock(&ring->writer_mutex);
+uint32_t
+parcRingBufferNxM_Remaining(PARCRingBufferNxM *ring)
+{
+    // Read the consumer side first so that a concurrent Get can only make the result an underestimate.
+    uint32_t dequeue = __atomic_load_n(&ring->dequeue_position, __ATOMIC_ACQUIRE);
+    uint32_t enqueue = __atomic_load_n(&ring->enqueue_position, __ATOMIC_ACQUIRE);
 
-    return remaining;
+    int32_t used = (int32_t) (enqueue - dequeue);
+    if (used < 0) {
+        used = 0;
+    }
+    if ((uint32_t) used >= ring->ring_mask) {
+        return 0;
+    }
+    return ring->ring_mask - (uint32_t) used;
 }
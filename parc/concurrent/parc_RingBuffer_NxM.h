@@ -30,7 +30,8 @@
  * @brief A multiple producer, multiple consumer ring buffer
  *
  * This is useful for synchronizing one or more producers with one or more consumers.
- * The implementation may use locks.
+ * The implementation is lock-free.  Producers and consumers each claim a position with a single
+ * compare-and-swap, and a thread that finds the ring full or empty returns `false` at once.
  *
  * Complies with the PARCRingBuffer generic facade.
  *
@@ -44,6 +45,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <parc/concurrent/parc_RingBuffer_1x1.h>
+#include <parc/concurrent/parc_Timeout.h>
+#include <parc/concurrent/parc_WaitStrategy.h>
 
 struct parc_ringbuffer_NxM;
 /**
@@ -76,7 +79,7 @@ PARCRingBufferNxM *parcRingBufferNxM_Create(uint32_t elements, RingBufferEntryDe
 /**
  * A reference counted copy of the buffer.
  *
- * A RING WITHOUT LOCKS CAN ONLY HAVE 2 REFERENCES.
+ * Any number of producers and consumers may hold references.
  *
  * @param [in] ring A pointer to the `PARCRingBufferNxM` to be acquired.
  *
@@ -156,4 +159,53 @@ bool parcRingBufferNxM_Get(PARCRingBufferNxM *ring, void **outputDataPtr);
  * @endcode
  */
 uint32_t parcRingBufferNxM_Remaining(PARCRingBufferNxM *ring);
+
+/**
+ * Put an item on the ring, waiting for room if the ring is full.
+ *
+ * Between attempts the thread waits as @p strategy directs.  After the item is put,
+ * any consumer parked in {@link parcRingBufferNxM_GetWait} with the same @p strategy is woken.
+ *
+ * @param [in,out] ring The instance of `PARCRingBufferNxM` on which to put the @p data.
+ * @param [in] data The data to put on the @p ring.
+ * @param [in] strategy The `PARCWaitStrategy` shared by the users of @p ring.
+ * @param [in] timeout The longest time to wait, or `PARCTimeout_Never`.
+ *
+ * @return `true` Data was put on the queue
+ * @return `false` The timeout expired while the queue was full
+ *
+ * Example:
+ * @code
+ * {
+ *     parcRingBufferNxM_PutWait(ring, item, strategy, PARCTimeout_Never);
+ * }
+ * @endcode
+ */
+bool parcRingBufferNxM_PutWait(PARCRingBufferNxM *ring, void *data, PARCWaitStrategy *strategy, const PARCTimeout *timeout);
+
+/**
+ * Get the next item off the ring, waiting for one if the ring is empty.
+ *
+ * Between attempts the thread waits as @p strategy directs.  After the item is taken,
+ * any producer parked in {@link parcRingBufferNxM_PutWait} with the same @p strategy is woken.
+ *
+ * @param [in] ring The ring buffer
+ * @param [out] outputDataPtr The output pointer
+ * @param [in] strategy The `PARCWaitStrategy` shared by the users of @p ring.
+ * @param [in] timeout The longest time to wait, or `PARCTimeout_Never`.
+ *
+ * @return `true` Data returned in the output argument
+ * @return `false` The timeout expired while the ring was empty, no data returned.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *item;
+ *     if (parcRingBufferNxM_GetWait(ring, &item, strategy, parcTimeout_MilliSeconds(10))) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool parcRingBufferNxM_GetWait(PARCRingBufferNxM *ring, void **outputDataPtr, PARCWaitStrategy *strategy, const PARCTimeout *timeout);
 #endif // libparc_parc_RingBuffer_NxM_h
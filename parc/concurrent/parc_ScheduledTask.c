@@ -18,11 +18,14 @@
 #include <parc/algol/parc_Time.h>
 
 #include <parc/concurrent/parc_ScheduledTask.h>
+#include <parc/concurrent/parc_ScheduledThreadPool.h>
 #include <parc/concurrent/parc_FutureTask.h>
+#include <parc/concurrent/internal_parc_ScheduledTask.h>
 
 struct PARCScheduledTask {
     PARCFutureTask *task;
     uint64_t executionTime;
+    internal_PARCScheduledTaskLink link;
 };
 
 static bool
@@ -65,6 +68,8 @@ parcScheduledTask_Create(PARCFutureTask *task, uint64_t executionTime)
     if (result != NULL) {
         result->task = parcFutureTask_Acquire(task);
         result->executionTime = executionTime;
+        result->link.pool = NULL;
+        result->link.index = 0;
     }
 
     return result;
@@ -73,7 +78,23 @@ parcScheduledTask_Create(PARCFutureTask *task, uint64_t executionTime)
 int
 parcScheduledTask_Compare(const PARCScheduledTask *instance, const PARCScheduledTask *other)
 {
+    if (instance == other) {
+        return 0;
+    }
+    if (instance == NULL) {
+        return -1;
+    }
+    if (other == NULL) {
+        return +1;
+    }
+
     int result = 0;
+
+    if (instance->executionTime < other->executionTime) {
+        result = -1;
+    } else if (instance->executionTime > other->executionTime) {
+        result = 1;
+    }
     
     return result;
 }
@@ -163,7 +184,33 @@ parcScheduledTask_GetExecutionTime(const PARCScheduledTask *task)
 bool
 parcScheduledTask_Cancel(PARCScheduledTask *task, bool mayInterruptIfRunning)
 {
-    return parcFutureTask_Cancel(task->task, mayInterruptIfRunning);
+    bool result = parcFutureTask_Cancel(task->task, mayInterruptIfRunning);
+
+    if (result) {
+        // The link holds a reference to the pool until the pool clears it under this task's lock,
+        // so the pool cannot be destroyed between reading the link and acquiring it.
+        PARCScheduledThreadPool *pool = NULL;
+        if (parcObject_Lock(task)) {
+            if (task->link.pool != NULL) {
+                pool = parcScheduledThreadPool_Acquire(task->link.pool);
+            }
+            parcObject_Unlock(task);
+        }
+        if (pool != NULL) {
+            if (parcScheduledThreadPool_GetRemoveOnCancelPolicy(pool)) {
+                parcScheduledThreadPool_Remove(pool, task);
+            }
+            parcScheduledThreadPool_Release(&pool);
+        }
+    }
+
+    return result;
+}
+
+internal_PARCScheduledTaskLink *
+internal_parcScheduledTask_GetLink(PARCScheduledTask *task)
+{
+    return &task->link;
 }
 
 PARCFutureTaskResult
@@ -102,6 +102,7 @@ PARCScheduledTask *parcScheduledTask_Create(PARCFutureTask *task, uint64_t execu
  *
  * Returns a negative integer, zero, or a positive integer as @p instance
  * is less than, equal to, or greater than @p other.
+ * Tasks are ordered by their execution time.
  *
  * @param [in] instance A pointer to a valid PARCScheduledTask instance.
  * @param [in] other A pointer to a valid PARCScheduledTask instance.
@@ -366,18 +367,24 @@ char *parcScheduledTask_ToString(const PARCScheduledTask *instance);
 uint64_t parcScheduledTask_GetExecutionTime(const PARCScheduledTask *task);
 
 /**
- * Attempts to cancel execution of this task.
+ * Attempt to cancel the execution of this task.
  *
- * <#Paragraphs Of Explanation#>
+ * If the task is waiting in a `PARCScheduledThreadPool` whose remove-on-cancel policy is set (the default),
+ * it is removed from the pool's queue immediately.
  *
- * @param [<#in#> | <#out#> | <#in,out#>] <#name#> <#description#>
+ * @param [in] task A pointer to a valid `PARCScheduledTask` instance.
+ * @param [in] mayInterruptIfRunning Interrupting a running task is not supported.
  *
- * @return <#value#> <#explanation#>
+ * @return true The task was cancelled.
+ * @return false The task is running and could not be cancelled.
  *
  * Example:
  * @code
  * {
- *     <#example#>
+ *     PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(500));
+ *
+ *     parcScheduledTask_Cancel(scheduled, false);
+ *     parcScheduledTask_Release(&scheduled);
  * }
  * @endcode
  */
@@ -30,6 +30,7 @@
  */
 #include <config.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
@@ -42,44 +43,177 @@
 #include <parc/concurrent/parc_ScheduledThreadPool.h>
 #include <parc/concurrent/parc_Thread.h>
 #include <parc/concurrent/parc_ThreadPool.h>
+#include <parc/concurrent/internal_parc_ScheduledTask.h>
+
+/*
+ * The scheduled tasks are kept in an indexed 4-ary min-heap ordered by execution time.
+ * A 4-ary heap is half the height of a binary heap and the children of a node share a cache line or two,
+ * and each task's link records its position so that a cancelled task is removed in O(log n).
+ *
+ * A single timer thread waits on the pool for the earliest execution time and hands due tasks to the PARCThreadPool.
+ */
+#define _PARCScheduledThreadPool_Arity 4
+#define _PARCScheduledThreadPool_InitialCapacity 64
+
+typedef struct {
+    uint64_t executionTime;
+    PARCScheduledTask *task;
+    internal_PARCScheduledTaskLink *link;
+} _PARCScheduledThreadPoolEntry;
 
 struct PARCScheduledThreadPool {
     bool continueExistingPeriodicTasksAfterShutdown;
     bool executeExistingDelayedTasksAfterShutdown;
     bool removeOnCancel;
-    PARCSortedList *workQueue;
+    bool isShutdown;
+    _PARCScheduledThreadPoolEntry *queue;
+    size_t queueSize;
+    size_t queueCapacity;
     PARCThread *workerThread;
     PARCThreadPool *threadPool;
     int poolSize;
 };
 
+static void
+_parcScheduledThreadPool_Place(PARCScheduledThreadPool *pool, size_t index, _PARCScheduledThreadPoolEntry entry)
+{
+    pool->queue[index] = entry;
+    entry.link->index = index;
+}
+
+static void
+_parcScheduledThreadPool_SiftUp(PARCScheduledThreadPool *pool, size_t index, _PARCScheduledThreadPoolEntry entry)
+{
+    while (index > 0) {
+        size_t parent = (index - 1) / _PARCScheduledThreadPool_Arity;
+        if (pool->queue[parent].executionTime <= entry.executionTime) {
+            break;
+        }
+        _parcScheduledThreadPool_Place(pool, index, pool->queue[parent]);
+        index = parent;
+    }
+    _parcScheduledThreadPool_Place(pool, index, entry);
+}
+
+static void
+_parcScheduledThreadPool_SiftDown(PARCScheduledThreadPool *pool, size_t index, _PARCScheduledThreadPoolEntry entry)
+{
+    for (;;) {
+        size_t first = index * _PARCScheduledThreadPool_Arity + 1;
+        if (first >= pool->queueSize) {
+            break;
+        }
+        size_t last = first + _PARCScheduledThreadPool_Arity;
+        if (last > pool->queueSize) {
+            last = pool->queueSize;
+        }
+
+        size_t earliest = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (pool->queue[child].executionTime < pool->queue[earliest].executionTime) {
+                earliest = child;
+            }
+        }
+        if (entry.executionTime <= pool->queue[earliest].executionTime) {
+            break;
+        }
+        _parcScheduledThreadPool_Place(pool, index, pool->queue[earliest]);
+        index = earliest;
+    }
+    _parcScheduledThreadPool_Place(pool, index, entry);
+}
+
+/*
+ * Add the task to the queue, which takes the caller's reference. The pool must be locked.
+ */
+static void
+_parcScheduledThreadPool_Insert(PARCScheduledThreadPool *pool, PARCScheduledTask *task)
+{
+    if (pool->queueSize == pool->queueCapacity) {
+        // Copy explicitly: the stdlib fallback for parcMemory_Reallocate copies newSize bytes from the old block.
+        _PARCScheduledThreadPoolEntry *queue = parcMemory_Allocate(pool->queueCapacity * 2 * sizeof(_PARCScheduledThreadPoolEntry));
+        assertNotNull(queue, "parcMemory_Allocate(%zu) returned NULL", pool->queueCapacity * 2 * sizeof(_PARCScheduledThreadPoolEntry));
+        memcpy(queue, pool->queue, pool->queueSize * sizeof(_PARCScheduledThreadPoolEntry));
+        parcMemory_Deallocate(&pool->queue);
+        pool->queue = queue;
+        pool->queueCapacity *= 2;
+    }
+
+    _PARCScheduledThreadPoolEntry entry = {
+        .executionTime = parcScheduledTask_GetExecutionTime(task),
+        .task          = task,
+        .link          = internal_parcScheduledTask_GetLink(task)
+    };
+    // The link holds a reference to the pool, so that a task cancelled from another thread can safely reach it.
+    __atomic_store_n(&entry.link->pool, parcScheduledThreadPool_Acquire(pool), __ATOMIC_RELEASE);
+
+    _parcScheduledThreadPool_SiftUp(pool, pool->queueSize++, entry);
+}
+
+/*
+ * Remove the task at the given position in the queue, returning the queue's reference to it. The pool must be locked.
+ * The caller must hold its own reference to the pool, as the link's reference is released here.
+ */
+static PARCScheduledTask *
+_parcScheduledThreadPool_RemoveAt(PARCScheduledThreadPool *pool, size_t index)
+{
+    _PARCScheduledThreadPoolEntry removed = pool->queue[index];
+    _PARCScheduledThreadPoolEntry last = pool->queue[--pool->queueSize];
+
+    if (index < pool->queueSize) {
+        if (index > 0 && last.executionTime < pool->queue[(index - 1) / _PARCScheduledThreadPool_Arity].executionTime) {
+            _parcScheduledThreadPool_SiftUp(pool, index, last);
+        } else {
+            _parcScheduledThreadPool_SiftDown(pool, index, last);
+        }
+    }
+
+    // parcScheduledTask_Cancel acquires the pool from the link while holding the task's lock.
+    PARCScheduledThreadPool *reference = removed.link->pool;
+    if (parcObject_Lock(removed.task)) {
+        __atomic_store_n(&removed.link->pool, NULL, __ATOMIC_RELEASE);
+        parcObject_Unlock(removed.task);
+    }
+    parcScheduledThreadPool_Release(&reference);
+
+    return removed.task;
+}
+
+/*
+ * Release every task still in the queue. The pool must be locked, or no longer shared.
+ */
+static void
+_parcScheduledThreadPool_DrainQueue(PARCScheduledThreadPool *pool)
+{
+    while (pool->queueSize > 0) {
+        PARCScheduledTask *task = _parcScheduledThreadPool_RemoveAt(pool, pool->queueSize - 1);
+        parcScheduledTask_Release(&task);
+    }
+}
+
 static void *
 _workerThread(PARCThread *thread, PARCScheduledThreadPool *pool)
 {
-    while (parcThread_IsCancelled(thread) == false) {
-        if (parcSortedList_Lock(pool->workQueue)) {
-            if (parcSortedList_Size(pool->workQueue) > 0) {
-                PARCScheduledTask *task = parcSortedList_GetFirst(pool->workQueue);
-                int64_t executionDelay = parcScheduledTask_GetExecutionTime(task) - parcTime_NowNanoseconds();
-                if (task != NULL && executionDelay <= 0) {
-                    parcSortedList_RemoveFirst(pool->workQueue);
-                    parcSortedList_Unlock(pool->workQueue);
-                    printf("move to threadpool references=%lld\n", parcObject_GetReferenceCount(task));
+    if (parcObject_Lock(pool)) {
+        while (parcThread_IsCancelled(thread) == false) {
+            if (pool->queueSize == 0) {
+                parcObject_Wait(pool);
+            } else {
+                int64_t executionDelay = (int64_t) (pool->queue[0].executionTime - parcTime_NowNanoseconds());
+                if (executionDelay <= 0) {
+                    PARCScheduledTask *task = _parcScheduledThreadPool_RemoveAt(pool, 0);
+                    parcObject_Unlock(pool);
+
                     parcThreadPool_Execute(pool->threadPool, parcScheduledTask_GetTask(task));
                     parcScheduledTask_Release(&task);
-                    parcSortedList_Lock(pool->workQueue);
-                    
-                    parcSortedList_Notify(pool->workQueue);
+
+                    parcObject_Lock(pool);
                 } else {
-                    printf("wait for %lld\n", executionDelay);
-                    parcSortedList_WaitFor(pool->workQueue, executionDelay);
+                    parcObject_WaitFor(pool, executionDelay);
                 }
-            } else {
-                printf("wait until something to do\n");
-                parcSortedList_Wait(pool->workQueue);
             }
         }
-        parcSortedList_Unlock(pool->workQueue);
+        parcObject_Unlock(pool);
     }
     
     return NULL;
@@ -93,12 +227,9 @@ _parcScheduledThreadPool_Destructor(PARCScheduledThreadPool **instancePtr)
     parcThreadPool_Release(&pool->threadPool);
     
     parcThread_Release(&pool->workerThread);
-    
-    if (parcObject_Lock(pool->workQueue)) {
-        parcSortedList_Release(&pool->workQueue);
-    } else {
-        assertTrue(false, "Cannot lock the work queue.");
-    }
+
+    _parcScheduledThreadPool_DrainQueue(pool);
+    parcMemory_Deallocate(&pool->queue);
     
     return true;
 }
@@ -132,8 +263,12 @@ parcScheduledThreadPool_Create(int poolSize)
     
     if (result != NULL) {
         result->poolSize = poolSize;
-        result->workQueue = parcSortedList_Create();
+        result->queueSize = 0;
+        result->queueCapacity = _PARCScheduledThreadPool_InitialCapacity;
+        result->queue = parcMemory_Allocate(result->queueCapacity * sizeof(_PARCScheduledThreadPoolEntry));
+        assertNotNull(result->queue, "parcMemory_Allocate(%zu) returned NULL", result->queueCapacity * sizeof(_PARCScheduledThreadPoolEntry));
         result->threadPool = parcThreadPool_Create(poolSize);
+        result->isShutdown = false;
         
         result->continueExistingPeriodicTasksAfterShutdown = false;
         result->executeExistingDelayedTasksAfterShutdown = false;
@@ -234,7 +369,10 @@ parcScheduledThreadPool_ToString(const PARCScheduledThreadPool *instance)
 void
 parcScheduledThreadPool_Execute(PARCScheduledThreadPool *pool, PARCFutureTask *command)
 {
-    
+    PARCScheduledTask *scheduledTask = parcScheduledThreadPool_Schedule(pool, command, PARCTimeout_Immediate);
+    if (scheduledTask != NULL) {
+        parcScheduledTask_Release(&scheduledTask);
+    }
 }
 
 bool
@@ -252,7 +390,16 @@ parcScheduledThreadPool_GetExecuteExistingDelayedTasksAfterShutdownPolicy(PARCSc
 PARCSortedList *
 parcScheduledThreadPool_GetQueue(const PARCScheduledThreadPool *pool)
 {
-    return pool->workQueue;
+    PARCSortedList *result = parcSortedList_Create();
+
+    if (parcObject_Lock(pool)) {
+        for (size_t i = 0; i < pool->queueSize; i++) {
+            parcSortedList_Add(result, pool->queue[i].task);
+        }
+        parcObject_Unlock(pool);
+    }
+
+    return result;
 }
 
 bool
@@ -267,14 +414,47 @@ parcScheduledThreadPool_Schedule(PARCScheduledThreadPool *pool, PARCFutureTask *
     uint64_t executionTime = parcTime_NowNanoseconds() + parcTimeout_InNanoSeconds(delay);
     
     PARCScheduledTask *scheduledTask = parcScheduledTask_Create(task, executionTime);
+    PARCScheduledTask *result = NULL;
     
-    if (parcSortedList_Lock(pool->workQueue)) {
-        parcSortedList_Add(pool->workQueue, scheduledTask);
-        parcScheduledTask_Release(&scheduledTask);
-        parcSortedList_Notify(pool->workQueue);
-        parcSortedList_Unlock(pool->workQueue);
+    if (parcObject_Lock(pool)) {
+        if (pool->isShutdown) {
+            parcScheduledTask_Release(&scheduledTask);
+        } else {
+            // The timer thread may run and release the queue's reference as soon as the pool is unlocked.
+            result = parcScheduledTask_Acquire(scheduledTask);
+            _parcScheduledThreadPool_Insert(pool, scheduledTask);
+            // The timer thread need only wake up when the earliest execution time changes.
+            if (internal_parcScheduledTask_GetLink(scheduledTask)->index == 0) {
+                parcObject_Notify(pool);
+            }
+        }
+        parcObject_Unlock(pool);
     }
-    return scheduledTask;
+    return result;
+}
+
+bool
+parcScheduledThreadPool_Remove(PARCScheduledThreadPool *pool, PARCScheduledTask *task)
+{
+    PARCScheduledTask *removed = NULL;
+
+    if (parcObject_Lock(pool)) {
+        internal_PARCScheduledTaskLink *link = internal_parcScheduledTask_GetLink(task);
+        if (link->pool == pool) {
+            bool wasFirst = (link->index == 0);
+            removed = _parcScheduledThreadPool_RemoveAt(pool, link->index);
+            if (wasFirst) {
+                parcObject_Notify(pool);
+            }
+        }
+        parcObject_Unlock(pool);
+    }
+
+    bool result = (removed != NULL);
+    if (removed != NULL) {
+        parcScheduledTask_Release(&removed);
+    }
+    return result;
 }
 
 PARCScheduledTask *
@@ -304,7 +484,7 @@ parcScheduledThreadPool_SetExecuteExistingDelayedTasksAfterShutdownPolicy(PARCSc
 void
 parcScheduledThreadPool_SetRemoveOnCancelPolicy(PARCScheduledThreadPool *pool, bool value)
 {
-    
+    pool->removeOnCancel = value;
 }
 
 void
@@ -342,19 +522,21 @@ parcScheduledThreadPool_ShutdownNow(PARCScheduledThreadPool *pool)
 {
     parcThread_Cancel(pool->workerThread);
     
-    parcThreadPool_ShutdownNow(pool->threadPool);
-    
-    // Wake them all up so they detect that they are cancelled.
+    // Wake the timer thread so it detects that it is cancelled.
     if (parcObject_Lock(pool)) {
+        pool->isShutdown = true;
         parcObject_NotifyAll(pool);
         parcObject_Unlock(pool);
     }
-    if (parcObject_Lock(pool->workQueue)) {
-        parcObject_NotifyAll(pool->workQueue);
-        parcObject_Unlock(pool->workQueue);
-    }
     
     parcThread_Join(pool->workerThread);
+
+    parcThreadPool_ShutdownNow(pool->threadPool);
+
+    if (parcObject_Lock(pool)) {
+        _parcScheduledThreadPool_DrainQueue(pool);
+        parcObject_Unlock(pool);
+    }
     
     return NULL;
 }
@@ -362,9 +544,5 @@ parcScheduledThreadPool_ShutdownNow(PARCScheduledThreadPool *pool)
 PARCScheduledTask *
 parcScheduledThreadPool_Submit(PARCScheduledThreadPool *pool, PARCFutureTask *task)
 {
-    PARCScheduledTask *scheduledTask = parcScheduledTask_Create(task, 0);
-    
-    parcSortedList_Add(pool->workQueue, scheduledTask);
-
-    return scheduledTask;
+    return parcScheduledThreadPool_Schedule(pool, task, PARCTimeout_Immediate);
 }
@@ -385,7 +385,9 @@ bool parcScheduledThreadPool_GetContinueExistingPeriodicTasksAfterShutdownPolicy
 bool parcScheduledThreadPool_GetExecuteExistingDelayedTasksAfterShutdownPolicy(PARCScheduledThreadPool *pool);
 
 /**
- * Returns the task queue used by this executor.
+ * Returns a new list of the tasks waiting to be executed, ordered by execution time.
+ *
+ * The list is a snapshot; the caller must release it with `parcSortedList_Release`.
  */
 PARCSortedList *parcScheduledThreadPool_GetQueue(const PARCScheduledThreadPool *pool);
 
@@ -396,9 +398,36 @@ bool parcScheduledThreadPool_GetRemoveOnCancelPolicy(const PARCScheduledThreadPo
 
 /**
  * Creates and executes a one-shot action that becomes enabled after the given delay.
+ *
+ * Scheduling takes O(log n) time for n waiting tasks.
+ * The caller must release the returned `PARCScheduledTask` with `parcScheduledTask_Release`, as for `parcScheduledTask_Create`.
+ * The pool holds its own reference while the task waits.
+ *
+ * @return non-NULL A pointer to the `PARCScheduledTask`, which the caller must release.
+ * @return NULL The pool has been shut down.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(500));
+ *
+ *     parcScheduledTask_Cancel(scheduled, false);
+ *     parcScheduledTask_Release(&scheduled);
+ * }
+ * @endcode
  */
 PARCScheduledTask *parcScheduledThreadPool_Schedule(PARCScheduledThreadPool *pool, PARCFutureTask *task, const PARCTimeout *delay);
 
+/**
+ * Removes the given task from the queue of tasks waiting to be executed, in O(log n) time.
+ *
+ * `parcScheduledTask_Cancel` does this automatically when the pool's remove-on-cancel policy is set.
+ *
+ * @return true The task was waiting and has been removed.
+ * @return false The task was not waiting in this pool.
+ */
+bool parcScheduledThreadPool_Remove(PARCScheduledThreadPool *pool, PARCScheduledTask *task);
+
 /**
  * Creates and executes a periodic action that becomes enabled first after the given initial delay, and subsequently with the given period; that is executions will commence after initialDelay then initialDelay+period, then initialDelay + 2 * period, and so on.
  */
@@ -435,7 +464,9 @@ void parcScheduledThreadPool_Shutdown(PARCScheduledThreadPool *pool);
 PARCList *parcScheduledThreadPool_ShutdownNow(PARCScheduledThreadPool *pool);
 
 /**
- * Submits a PARCFutureTask task for execution and returns the PARCFutureTask representing that task.
+ * Submits a PARCFutureTask task for execution and returns the PARCScheduledTask representing that task.
+ *
+ * The caller must release the result, which is NULL if the pool has been shut down.
  */
 PARCScheduledTask *parcScheduledThreadPool_Submit(PARCScheduledThreadPool *pool, PARCFutureTask *task);
 
@@ -28,22 +28,35 @@
  * @author Glenn Scott, Computing Science Laboratory, PARC
  * @copyright 2016 Palo Alto Research Center, Inc. (PARC), A Xerox Company.  All Rights Reserved.
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <config.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
 #include <parc/algol/parc_Memory.h>
 
 #include <parc/concurrent/parc_Thread.h>
+#include <parc/concurrent/parc_CpuTopology.h>
+
+// The number of CPUs parcThread_GetAffinity asks the system about, which is as many as a PARCBitVector can hold.
+#define _PARCThread_MaximumCpus 8192
 
 struct PARCThread {
     void *(*run)(PARCThread *, PARCObject *param);
     PARCObject *argument;
     bool isCancelled;
     bool isRunning;
+    bool isJoinable;
     pthread_t thread;
+    // The name, limited to the 15 characters Linux allows.  Empty if the thread has not been named.
+    char name[16];
+    PARCBitVector *affinity;
 };
 
 static bool
@@ -54,6 +67,14 @@ _parcThread_Destructor(PARCThread **instancePtr)
     
     thread->isCancelled = true;
     parcThread_Join(thread);
+
+    // A thread that was never started still holds the reference to its argument.
+    if (thread->argument != NULL) {
+        parcObject_Release(&thread->argument);
+    }
+    if (thread->affinity != NULL) {
+        parcBitVector_Release(&thread->affinity);
+    }
     
     return true;
 }
@@ -92,6 +113,7 @@ parcThread_Create(void *(*runFunction)(PARCThread *, PARCObject *), PARCObject *
         result->argument = parcObject_Acquire(parameter);
         result->isCancelled = false;
         result->isRunning = false;
+        result->isJoinable = false;
     }
 
     return result;
@@ -167,14 +189,64 @@ parcThread_ToJSON(const PARCThread *thread)
 char *
 parcThread_ToString(const PARCThread *thread)
 {
-    char *result = parcMemory_Format("PARCThread@%p{.id=%p, .isCancelled=%s}", thread, thread->thread, thread->isCancelled ? "true" : "false");
+    char *result = parcMemory_Format("PARCThread@%p{.id=%p, .name=\"%s\", .isCancelled=%s}",
+                                     thread, thread->thread, thread->name, thread->isCancelled ? "true" : "false");
+
+    return result;
+}
 
+static bool
+_parcThread_ApplyName(PARCThread *thread)
+{
+    bool result = false;
+#if __linux__
+    result = pthread_setname_np(thread->thread, thread->name) == 0;
+#elif __APPLE__
+    // A thread can name only itself.
+    if (pthread_equal(pthread_self(), thread->thread)) {
+        result = pthread_setname_np(thread->name) == 0;
+    }
+#endif
+    return result;
+}
+
+static bool
+_parcThread_ApplyAffinity(PARCThread *thread)
+{
+    bool result = false;
+#if __linux__
+    int count = 0;
+    for (int cpu = parcBitVector_NextBitSet(thread->affinity, 0); cpu >= 0; cpu = parcBitVector_NextBitSet(thread->affinity, cpu + 1)) {
+        count = cpu + 1;
+    }
+    if (count > 0) {
+        cpu_set_t *set = CPU_ALLOC(count);
+        size_t size = CPU_ALLOC_SIZE(count);
+        CPU_ZERO_S(size, set);
+        for (int cpu = parcBitVector_NextBitSet(thread->affinity, 0); cpu >= 0; cpu = parcBitVector_NextBitSet(thread->affinity, cpu + 1)) {
+            CPU_SET_S(cpu, size, set);
+        }
+        result = pthread_setaffinity_np(thread->thread, size, set) == 0;
+        CPU_FREE(set);
+    }
+#endif
     return result;
 }
 
 static void *
 _parcThread_Run(PARCThread *thread)
 {
+    // Wait for parcThread_Start to record this thread's handle, then take on the name and CPUs it was given.
+    if (parcThread_Lock(thread)) {
+        if (thread->affinity != NULL) {
+            _parcThread_ApplyAffinity(thread);
+        }
+        if (thread->name[0] != 0) {
+            _parcThread_ApplyName(thread);
+        }
+        parcThread_Unlock(thread);
+    }
+
     thread->isRunning = true;
     thread->run(thread, thread->argument);
     thread->isRunning = false;
@@ -194,7 +266,10 @@ void
 parcThread_Start(PARCThread *thread)
 {
     PARCThread *parameter = parcThread_Acquire(thread);
+    parcThread_Lock(thread);
+    thread->isJoinable = true;
     pthread_create(&thread->thread, NULL, (void *(*)(void *)) _parcThread_Run, parameter);
+    parcThread_Unlock(thread);
 }
 
 PARCObject *
@@ -235,5 +310,91 @@ parcThread_IsCancelled(const PARCThread *thread)
 void
 parcThread_Join(PARCThread *thread)
 {
-    pthread_join(thread->thread, NULL);
+    // A started thread can be joined only once.
+    if (__sync_bool_compare_and_swap(&thread->isJoinable, true, false)) {
+        if (pthread_equal(pthread_self(), thread->thread)) {
+            // The thread released its last reference to itself, so nothing else will wait for it.
+            pthread_detach(thread->thread);
+        } else {
+            pthread_join(thread->thread, NULL);
+        }
+    }
+}
+
+void
+parcThread_SetName(PARCThread *thread, const char *name)
+{
+    assertNotNull(name, "The name must not be NULL.");
+
+    if (parcThread_Lock(thread)) {
+        strncpy(thread->name, name, sizeof(thread->name) - 1);
+        thread->name[sizeof(thread->name) - 1] = 0;
+        if (thread->isJoinable) {
+            _parcThread_ApplyName(thread);
+        }
+        parcThread_Unlock(thread);
+    }
+}
+
+const char *
+parcThread_GetName(const PARCThread *thread)
+{
+    return thread->name[0] == 0 ? NULL : thread->name;
+}
+
+bool
+parcThread_SetAffinity(PARCThread *thread, const PARCBitVector *cpus)
+{
+    assertNotNull(cpus, "The set of CPUs must not be NULL.");
+
+    bool result = false;
+#if __linux__
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    bool anyOnline = false;
+    for (int cpu = parcBitVector_NextBitSet(cpus, 0); cpu >= 0 && !anyOnline; cpu = parcBitVector_NextBitSet(cpus, cpu + 1)) {
+        anyOnline = parcBitVector_Get(online, cpu) == 1;
+    }
+    parcBitVector_Release(&online);
+
+    if (anyOnline && parcThread_Lock(thread)) {
+        if (thread->affinity != NULL) {
+            parcBitVector_Release(&thread->affinity);
+        }
+        thread->affinity = parcBitVector_Copy(cpus);
+        result = thread->isJoinable ? _parcThread_ApplyAffinity(thread) : true;
+        parcThread_Unlock(thread);
+    }
+#endif
+    return result;
+}
+
+PARCBitVector *
+parcThread_GetAffinity(const PARCThread *thread)
+{
+    PARCBitVector *result = NULL;
+
+    PARCThread *mutable = (PARCThread *) thread;
+    if (parcThread_Lock(mutable)) {
+#if __linux__
+        if (thread->isJoinable) {
+            int count = _PARCThread_MaximumCpus;
+            cpu_set_t *set = CPU_ALLOC(count);
+            size_t size = CPU_ALLOC_SIZE(count);
+            if (pthread_getaffinity_np(thread->thread, size, set) == 0) {
+                result = parcBitVector_Create();
+                for (int cpu = 0; cpu < count; cpu++) {
+                    if (CPU_ISSET_S(cpu, size, set)) {
+                        parcBitVector_Set(result, cpu);
+                    }
+                }
+            }
+            CPU_FREE(set);
+        }
+#endif
+        if (result == NULL && thread->affinity != NULL) {
+            result = parcBitVector_Copy(thread->affinity);
+        }
+        parcThread_Unlock(mutable);
+    }
+    return result;
 }
@@ -39,6 +39,7 @@
 
 #include <parc/algol/parc_JSON.h>
 #include <parc/algol/parc_HashCode.h>
+#include <parc/algol/parc_BitVector.h>
 
 struct PARCThread;
 typedef struct PARCThread PARCThread;
@@ -610,4 +611,89 @@ int parcThread_GetId(const PARCThread *thread);
  * @endcode
  */
 void parcThread_Join(PARCThread *thread);
+
+/**
+ * Set the name of the given thread, as shown by debuggers, `top -H` and `/proc/<pid>/task/<tid>/comm`.
+ *
+ * Linux allows 15 characters, so a longer name is truncated.
+ * A name set before `parcThread_Start` is applied as the thread begins to run.
+ *
+ * @param [in] thread A pointer to a valid `PARCThread` instance.
+ * @param [in] name A nul-terminated string.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCThread *thread = parcThread_Create(_run, parameter);
+ *     parcThread_SetName(thread, "reactor");
+ *     parcThread_Start(thread);
+ * }
+ * @endcode
+ */
+void parcThread_SetName(PARCThread *thread, const char *name);
+
+/**
+ * Get the name given to the thread with `parcThread_SetName`.
+ *
+ * @param [in] thread A pointer to a valid `PARCThread` instance.
+ *
+ * @return non-NULL The name, which belongs to @p thread.
+ * @return NULL The thread has not been named.
+ *
+ * Example:
+ * @code
+ * {
+ *     const char *name = parcThread_GetName(thread);
+ * }
+ * @endcode
+ */
+const char *parcThread_GetName(const PARCThread *thread);
+
+/**
+ * Restrict the given thread to run only on the given CPUs.
+ *
+ * A set given before `parcThread_Start` is applied as the thread begins to run, before it calls its run function.
+ * A set given afterwards is applied at once.
+ * CPUs are numbered as in {@link parcCpuTopology_GetOnlineCpus}.
+ *
+ * @param [in] thread A pointer to a valid `PARCThread` instance.
+ * @param [in] cpus A set of CPUs, which is copied.
+ *
+ * @return true The thread runs, or will run, only on @p cpus.
+ * @return false None of @p cpus is online, the system refused, or threads cannot be pinned on this platform.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *cpus = parcCpuTopology_ParseCpuList("2-3");
+ *     parcThread_SetAffinity(thread, cpus);
+ *     parcBitVector_Release(&cpus);
+ *
+ *     parcThread_Start(thread);
+ * }
+ * @endcode
+ */
+bool parcThread_SetAffinity(PARCThread *thread, const PARCBitVector *cpus);
+
+/**
+ * Get the set of CPUs the given thread may run on.
+ *
+ * For a running thread this asks the system.  For a thread not yet started it is the set given to `parcThread_SetAffinity`.
+ *
+ * @param [in] thread A pointer to a valid `PARCThread` instance.
+ *
+ * @return non-NULL A `PARCBitVector` of CPUs, which must be released.
+ * @return NULL The set is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *cpus = parcThread_GetAffinity(thread);
+ *     if (cpus != NULL) {
+ *         parcBitVector_Release(&cpus);
+ *     }
+ * }
+ * @endcode
+ */
+PARCBitVector *parcThread_GetAffinity(const PARCThread *thread);
 #endif
@@ -30,10 +30,13 @@
  */
 #include <config.h>
 #include <stdio.h>
+#include <sched.h>
+#include <sys/time.h>
 
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
 #include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Time.h>
 
 #include <parc/algol/parc_SortedList.h>
 #include <parc/algol/parc_LinkedList.h>
@@ -42,68 +45,614 @@
 #include <parc/concurrent/parc_ThreadPool.h>
 #include <parc/concurrent/parc_Thread.h>
 
+/*
+ * Each worker owns a Chase-Lev work-stealing deque
+ * (D. Chase and Y. Lev, "Dynamic Circular Work-Stealing Deque," SPAA 2005,
+ * using the memory orderings given by N. M. Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models," PPoPP 2013).
+ *
+ * The owning worker pushes and takes tasks at the bottom without locking, while idle workers steal from the top.
+ * Tasks submitted from outside the pool go to a shared injection queue which workers drain in small batches.
+ */
+#define _PARCThreadPool_InitialDequeCapacity 64
+
+/*
+ * The largest number of tasks a worker moves from the injection queue to its own deque at once.
+ * A pool with a bounded queue moves none, as its capacity counts only the tasks in the injection queue.
+ */
+#define _PARCThreadPool_InjectionBatch 32
+
+/*
+ * A worker with local work still polls the injection queue every this many tasks, so external submitters are not starved.
+ */
+#define _PARCThreadPool_InjectionInterval 61
+
+/*
+ * While tasks are in flight elsewhere an idle worker yields this many times before it backs off
+ * for _PARCThreadPool_IdleBackOff nanoseconds, so spinning workers do not starve busy ones of the processor.
+ */
+#define _PARCThreadPool_IdleSpins 16
+#define _PARCThreadPool_IdleBackOff 50000
+
+/*
+ * How long a worker beyond the core pool size waits for work before it stops, unless set with parcThreadPool_SetKeepAliveTime.
+ */
+#define _PARCThreadPool_DefaultKeepAlive 60000000000ULL
+
+typedef struct _parcThreadPoolDequeArray {
+    struct _parcThreadPoolDequeArray *previous;
+    long mask;
+    PARCFutureTask *tasks[];
+} _PARCThreadPoolDequeArray;
+
+typedef struct {
+    long top;
+    char padding[LEVEL1_DCACHE_LINESIZE - sizeof(long)];
+    long bottom;
+    _PARCThreadPoolDequeArray *array;
+} _PARCThreadPoolDeque;
+
+/*
+ * A worker slot is Empty until a thread is started in it.  A worker that stops for lack of work leaves its slot Retired,
+ * and its thread is joined when the slot is used again or the pool stops.
+ */
+typedef enum {
+    _PARCThreadPoolWorkerState_Empty,
+    _PARCThreadPoolWorkerState_Running,
+    _PARCThreadPoolWorkerState_Retired
+} _PARCThreadPoolWorkerState;
+
+typedef struct {
+    PARCThreadPool *pool;
+    PARCThread *thread;
+    _PARCThreadPoolWorkerState state;
+    // The task the worker was started for, which it runs before looking for others.
+    PARCFutureTask *firstTask;
+    // The CPUs that any thread started in this slot runs on, or NULL.
+    PARCBitVector *cpus;
+    // When the worker last found no task, or 0 while it is busy.
+    uint64_t idleSince;
+    unsigned int seed;
+    unsigned int ticks;
+    unsigned int idleSpins;
+    // True if the worker was given CPUs to run on, and so should keep its memory near them.
+    bool isPinned;
+    // True once a pinned worker has moved the deque near its CPUs, which are the same for every thread in the slot.
+    bool isRelocated;
+    _PARCThreadPoolDeque deque;
+} _PARCThreadPoolWorker;
+
 struct PARCThreadPool {
     bool continueExistingPeriodicTasksAfterShutdown;
     bool executeExistingDelayedTasksAfterShutdown;
     bool removeOnCancel;
     PARCLinkedList *workQueue;
-    PARCLinkedList *threads;
+    _PARCThreadPoolWorker *workers;
+    // The number of worker slots, which is the maximum pool size given when the pool was created.
+    int workerSlots;
+    // The number of running workers.  It changes only while the pool is locked.
     int poolSize;
+    int corePoolSize;
     int maximumPoolSize;
+    int largestPoolSize;
+    PARCTimeout keepAlive;
+    bool keepAliveIsNever;
+    bool allowCoreThreadTimeOut;
     long taskCount;
     bool isShutdown;
     bool isTerminated;
     bool isTerminating;
 
+    // The number of tasks submitted but not yet taken by a worker.
+    size_t pending;
+    // The number of tasks in the injection queue.
+    size_t injected;
+    // The number of tasks being run.
+    size_t running;
+    // The number of workers waiting on the pool for work.
+    size_t sleepers;
+
+    // The largest number of tasks the injection queue holds.
+    size_t queueCapacity;
+    PARCThreadPoolRejectionPolicy rejectionPolicy;
+    // How long a submitter waits for room under PARCThreadPoolRejectionPolicy_Block.
+    PARCTimeout blockTimeout;
+    bool blockIsNever;
+    // The number of submitters waiting on the work queue for room.
+    size_t blockedSubmitters;
+    uint64_t rejectedTaskCount;
+
     PARCAtomicUint64 *completedTaskCount;
 };
 
-static void *
-_workerThread(PARCThread *thread, PARCThreadPool *pool)
+static __thread _PARCThreadPoolWorker *_parcThreadPool_CurrentWorker;
+
+static _PARCThreadPoolDequeArray *
+_parcThreadPoolDequeArray_Create(long capacity)
+{
+    _PARCThreadPoolDequeArray *result = parcMemory_Allocate(sizeof(_PARCThreadPoolDequeArray) + capacity * sizeof(PARCFutureTask *));
+    assertNotNull(result, "parcMemory_Allocate(%zu) returned NULL", sizeof(_PARCThreadPoolDequeArray) + capacity * sizeof(PARCFutureTask *));
+    result->previous = NULL;
+    result->mask = capacity - 1;
+    return result;
+}
+
+static void
+_parcThreadPoolDeque_Init(_PARCThreadPoolDeque *deque)
+{
+    deque->top = 0;
+    deque->bottom = 0;
+    deque->array = _parcThreadPoolDequeArray_Create(_PARCThreadPool_InitialDequeCapacity);
+}
+
+static void
+_parcThreadPoolDeque_Fini(_PARCThreadPoolDeque *deque)
 {
-    while (parcThread_IsCancelled(thread) == false) {
+    // Arrays replaced by a larger one are kept until now, as a thief may still have been reading them.
+    _PARCThreadPoolDequeArray *array = deque->array;
+    while (array != NULL) {
+        _PARCThreadPoolDequeArray *previous = array->previous;
+        parcMemory_Deallocate(&array);
+        array = previous;
+    }
+    deque->array = NULL;
+}
+
+/*
+ * Copy the tasks into a new array of the given capacity, allocated by the calling thread, and put it in place.
+ * Only the owning worker may replace the array.
+ */
+static _PARCThreadPoolDequeArray *
+_parcThreadPoolDeque_Replace(_PARCThreadPoolDeque *deque, _PARCThreadPoolDequeArray *array, long top, long bottom, long capacity)
+{
+    _PARCThreadPoolDequeArray *result = _parcThreadPoolDequeArray_Create(capacity);
+    result->previous = array;
+    for (long i = top; i < bottom; i++) {
+        result->tasks[i & result->mask] = __atomic_load_n(&array->tasks[i & array->mask], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&deque->array, result, __ATOMIC_RELEASE);
+    return result;
+}
+
+static _PARCThreadPoolDequeArray *
+_parcThreadPoolDeque_Grow(_PARCThreadPoolDeque *deque, _PARCThreadPoolDequeArray *array, long top, long bottom)
+{
+    return _parcThreadPoolDeque_Replace(deque, array, top, bottom, 2 * (array->mask + 1));
+}
+
+/*
+ * Move the tasks to an array allocated by the calling worker, which the kernel places on the worker's NUMA node.
+ */
+static void
+_parcThreadPoolDeque_Relocate(_PARCThreadPoolDeque *deque)
+{
+    _PARCThreadPoolDequeArray *array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    _parcThreadPoolDeque_Replace(deque, array, top, bottom, array->mask + 1);
+}
+
+/*
+ * Only the owning worker may push.
+ */
+static void
+_parcThreadPoolDeque_Push(_PARCThreadPoolDeque *deque, PARCFutureTask *task)
+{
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    _PARCThreadPoolDequeArray *array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+
+    if (bottom - top > array->mask) {
+        array = _parcThreadPoolDeque_Grow(deque, array, top, bottom);
+    }
+    __atomic_store_n(&array->tasks[bottom & array->mask], task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Only the owning worker may take, which removes the most recently pushed task.
+ */
+static PARCFutureTask *
+_parcThreadPoolDeque_Take(_PARCThreadPoolDeque *deque)
+{
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    _PARCThreadPoolDequeArray *array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    PARCFutureTask *result = NULL;
+    if (top <= bottom) {
+        result = __atomic_load_n(&array->tasks[bottom & array->mask], __ATOMIC_RELAXED);
+        if (top == bottom) {
+            // This is the last task, so race any thieves for it.
+            if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                result = NULL;
+            }
+            __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+    } else {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return result;
+}
+
+/*
+ * Any worker may steal, which removes the least recently pushed task.
+ * Returns NULL if the deque is empty or another thread took the task first.
+ */
+static PARCFutureTask *
+_parcThreadPoolDeque_Steal(_PARCThreadPoolDeque *deque)
+{
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    PARCFutureTask *result = NULL;
+    if (top < bottom) {
+        _PARCThreadPoolDequeArray *array = __atomic_load_n(&deque->array, __ATOMIC_ACQUIRE);
+        result = __atomic_load_n(&array->tasks[top & array->mask], __ATOMIC_RELAXED);
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            result = NULL;
+        }
+    }
+    return result;
+}
+
+/*
+ * Called by a worker without local work, this takes a share of the injection queue,
+ * leaving all but the first task in the worker's own deque where other workers may steal them.
+ * From a bounded queue it takes only one task, so that the tasks still waiting stay within the queue's capacity.
+ */
+static PARCFutureTask *
+_parcThreadPool_TakeInjected(PARCThreadPool *pool, _PARCThreadPoolWorker *worker)
+{
+    PARCFutureTask *result = NULL;
+
+    if (__atomic_load_n(&pool->injected, __ATOMIC_ACQUIRE) > 0) {
         if (parcLinkedList_Lock(pool->workQueue)) {
-            PARCFutureTask *task = parcLinkedList_RemoveFirst(pool->workQueue);
-            if (task != NULL) {
-                parcLinkedList_Unlock(pool->workQueue);
-                parcFutureTask_Run(task);
-                parcFutureTask_Release(&task);
-                parcAtomicUint64_Increment(pool->completedTaskCount);
-                parcLinkedList_Lock(pool->workQueue);
-
-                parcLinkedList_Notify(pool->workQueue);
+            size_t size = parcLinkedList_Size(pool->workQueue);
+            if (size > 0) {
+                size_t workers = (size_t) __atomic_load_n(&pool->poolSize, __ATOMIC_RELAXED);
+                workers = (workers == 0) ? 1 : workers;
+                size_t share = (size + workers - 1) / workers;
+                size_t batch = (pool->queueCapacity == PARCThreadPool_UnboundedQueue) ? _PARCThreadPool_InjectionBatch : 1;
+                if (share > batch) {
+                    share = batch;
+                }
+                result = parcLinkedList_RemoveFirst(pool->workQueue);
+                for (size_t i = 1; i < share; i++) {
+                    _parcThreadPoolDeque_Push(&worker->deque, parcLinkedList_RemoveFirst(pool->workQueue));
+                }
+                __atomic_sub_fetch(&pool->injected, share, __ATOMIC_RELEASE);
+                if (pool->blockedSubmitters > 0) {
+                    parcLinkedList_NotifyAll(pool->workQueue);
+                }
+            }
+            parcLinkedList_Unlock(pool->workQueue);
+        }
+    }
+
+    return result;
+}
+
+static PARCFutureTask *
+_parcThreadPool_Steal(PARCThreadPool *pool, _PARCThreadPoolWorker *thief)
+{
+    PARCFutureTask *result = NULL;
+
+    // Start from a random victim so that thieves spread out over the pool.
+    thief->seed ^= thief->seed << 13;
+    thief->seed ^= thief->seed >> 17;
+    thief->seed ^= thief->seed << 5;
+    int start = (int) (thief->seed % (unsigned int) pool->workerSlots);
+
+    // A slot without a running worker has an empty deque.
+    for (int i = 0; i < pool->workerSlots && result == NULL; i++) {
+        _PARCThreadPoolWorker *victim = &pool->workers[(start + i) % pool->workerSlots];
+        if (victim != thief) {
+            result = _parcThreadPoolDeque_Steal(&victim->deque);
+        }
+    }
+
+    return result;
+}
+
+static PARCFutureTask *
+_parcThreadPool_FindTask(PARCThreadPool *pool, _PARCThreadPoolWorker *worker)
+{
+    PARCFutureTask *result = worker->firstTask;
+    worker->firstTask = NULL;
+
+    if (result == NULL && ++worker->ticks % _PARCThreadPool_InjectionInterval == 0) {
+        result = _parcThreadPool_TakeInjected(pool, worker);
+    }
+    if (result == NULL) {
+        result = _parcThreadPoolDeque_Take(&worker->deque);
+    }
+    if (result == NULL) {
+        result = _parcThreadPool_TakeInjected(pool, worker);
+    }
+    if (result == NULL) {
+        result = _parcThreadPool_Steal(pool, worker);
+    }
+
+    if (result != NULL) {
+        // Count the task as running before it stops being pending, so the pool never appears idle while it holds a task.
+        __atomic_add_fetch(&pool->running, 1, __ATOMIC_SEQ_CST);
+        __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return result;
+}
+
+static bool
+_parcThreadPool_IsQuiescent(const PARCThreadPool *pool)
+{
+    return __atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) == 0 && __atomic_load_n(&pool->running, __ATOMIC_SEQ_CST) == 0;
+}
+
+static void
+_parcThreadPool_RunTask(PARCThreadPool *pool, PARCFutureTask *task)
+{
+    parcFutureTask_Run(task);
+    parcFutureTask_Release(&task);
+    parcAtomicUint64_Increment(pool->completedTaskCount);
+
+    __atomic_sub_fetch(&pool->running, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->isTerminating, __ATOMIC_ACQUIRE) && _parcThreadPool_IsQuiescent(pool)) {
+        // Wake anyone in parcThreadPool_AwaitTermination.
+        if (parcLinkedList_Lock(pool->workQueue)) {
+            parcLinkedList_NotifyAll(pool->workQueue);
+            parcLinkedList_Unlock(pool->workQueue);
+        }
+    }
+}
+
+/*
+ * True if an idle worker may stop once the keep-alive time passes.  The pool must be locked.
+ */
+static bool
+_parcThreadPool_MayTimeOut(const PARCThreadPool *pool)
+{
+    return pool->poolSize > pool->maximumPoolSize
+           || (pool->keepAliveIsNever == false && (pool->allowCoreThreadTimeOut || pool->poolSize > pool->corePoolSize));
+}
+
+/*
+ * Stop counting the worker as running, unless a task has arrived.  The pool must be locked.
+ *
+ * A submitter increments `pending` before it reads `poolSize`, and this reads `pending` after decrementing `poolSize`,
+ * so either the worker sees the new task and stays, or the submitter sees that it must start a worker.
+ */
+static bool
+_parcThreadPool_Retire(PARCThreadPool *pool, _PARCThreadPoolWorker *worker)
+{
+    __atomic_sub_fetch(&pool->poolSize, 1, __ATOMIC_SEQ_CST);
+    bool result = __atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) == 0;
+    if (result) {
+        worker->state = _PARCThreadPoolWorkerState_Retired;
+    } else {
+        __atomic_add_fetch(&pool->poolSize, 1, __ATOMIC_SEQ_CST);
+    }
+    return result;
+}
+
+/*
+ * Wait on the pool until there may be work to do.
+ * Returns false if the worker has been idle for the keep-alive time and has retired.
+ *
+ * A submitter increments `pending` before it reads `sleepers`, and an idle worker increments `sleepers` before it reads `pending`,
+ * so either the worker sees the new task or the submitter sees the sleeping worker and notifies it.
+ */
+static bool
+_parcThreadPool_Idle(PARCThreadPool *pool, _PARCThreadPoolWorker *worker)
+{
+    bool result = true;
+
+    if (__atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) > 0 && ++worker->idleSpins < _PARCThreadPool_IdleSpins) {
+        // A task is being added, or is in a deque this worker lost a race for.
+        sched_yield();
+    } else if (parcThreadPool_Lock(pool)) {
+        __atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (parcThread_IsCancelled(worker->thread) == false) {
+            if (__atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) > 0) {
+                parcObject_WaitFor(pool, _PARCThreadPool_IdleBackOff);
+            } else if (_parcThreadPool_MayTimeOut(pool) == false) {
+                parcThreadPool_Wait(pool);
             } else {
-                parcLinkedList_Wait(pool->workQueue);                
+                uint64_t now = parcTime_NowNanoseconds();
+                if (worker->idleSince == 0) {
+                    worker->idleSince = now;
+                }
+                uint64_t idle = now - worker->idleSince;
+                if (pool->poolSize > pool->maximumPoolSize || idle >= pool->keepAlive) {
+                    result = (_parcThreadPool_Retire(pool, worker) == false);
+                } else {
+                    parcObject_WaitFor(pool, pool->keepAlive - idle);
+                }
             }
         }
-        parcLinkedList_Unlock(pool->workQueue);
+        __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        parcThreadPool_Unlock(pool);
+        worker->idleSpins = 0;
+    }
+
+    return result;
+}
+
+static void
+_parcThreadPool_WakeWorker(PARCThreadPool *pool)
+{
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        if (parcThreadPool_Lock(pool)) {
+            parcThreadPool_Notify(pool);
+            parcThreadPool_Unlock(pool);
+        }
+    }
+}
+
+static void *
+_workerThread(PARCThread *thread, PARCThreadPool *pool)
+{
+    // The slot was filled while the pool was locked.
+    _PARCThreadPoolWorker *worker = NULL;
+    if (parcThreadPool_Lock(pool)) {
+        for (int i = 0; i < pool->workerSlots && worker == NULL; i++) {
+            if (pool->workers[i].thread == thread) {
+                worker = &pool->workers[i];
+            }
+        }
+        parcThreadPool_Unlock(pool);
+    }
+    assertNotNull(worker, "PARCThread %p is not a worker of PARCThreadPool %p", (void *) thread, (void *) pool);
+
+    _parcThreadPool_CurrentWorker = worker;
+
+    if (worker->isPinned && !worker->isRelocated) {
+        // The initial array was allocated by the thread that created the pool, possibly on another NUMA node.
+        _parcThreadPoolDeque_Relocate(&worker->deque);
+        worker->isRelocated = true;
     }
-   
+
+    bool isRunning = true;
+    while (isRunning && parcThread_IsCancelled(thread) == false) {
+        PARCFutureTask *task = _parcThreadPool_FindTask(pool, worker);
+        if (task != NULL) {
+            worker->idleSpins = 0;
+            worker->idleSince = 0;
+            _parcThreadPool_RunTask(pool, task);
+        } else {
+            isRunning = _parcThreadPool_Idle(pool, worker);
+        }
+    }
+
+    _parcThreadPool_CurrentWorker = NULL;
+
     return NULL;
 }
 
+/*
+ * Start a thread in a free slot, which runs the given task, if any, first.  The pool must be locked.
+ */
+static bool
+_parcThreadPool_StartWorker(PARCThreadPool *pool, PARCFutureTask *firstTask)
+{
+    _PARCThreadPoolWorker *worker = NULL;
+    for (int i = 0; i < pool->workerSlots && worker == NULL; i++) {
+        if (pool->workers[i].state != _PARCThreadPoolWorkerState_Running) {
+            worker = &pool->workers[i];
+        }
+    }
+
+    if (worker != NULL) {
+        if (worker->thread != NULL) {
+            // A retired worker has left, or is about to leave, its run function.
+            parcThread_Join(worker->thread);
+            parcThread_Release(&worker->thread);
+        }
+
+        PARCThread *thread = parcThread_Create((void *(*)(PARCThread *, PARCObject *)) _workerThread, (PARCObject *) pool);
+        char name[16];
+        snprintf(name, sizeof(name), "PARCPool-%d", (int) (worker - pool->workers));
+        parcThread_SetName(thread, name);
+        worker->isPinned = (worker->cpus != NULL) && parcThread_SetAffinity(thread, worker->cpus);
+
+        worker->thread = thread;
+        worker->firstTask = firstTask;
+        worker->idleSince = 0;
+        worker->idleSpins = 0;
+        worker->state = _PARCThreadPoolWorkerState_Running;
+
+        int size = __atomic_add_fetch(&pool->poolSize, 1, __ATOMIC_SEQ_CST);
+        if (size > pool->largestPoolSize) {
+            pool->largestPoolSize = size;
+        }
+
+        parcThread_Start(thread);
+    }
+
+    return worker != NULL;
+}
+
+/*
+ * Start a worker if the pool has fewer than the core pool size, or if `core` is false, the maximum pool size.
+ * Once the pool is shut down, a worker may be started only to run tasks that are already queued.
+ */
+static bool
+_parcThreadPool_AddWorker(PARCThreadPool *pool, PARCFutureTask *firstTask, bool core)
+{
+    bool result = false;
+
+    if (parcThreadPool_Lock(pool)) {
+        int bound = core ? pool->corePoolSize : pool->maximumPoolSize;
+        bool isAccepting = (pool->isTerminating == false) || (firstTask == NULL);
+        if (pool->isTerminated == false && isAccepting && pool->poolSize < bound) {
+            result = _parcThreadPool_StartWorker(pool, firstTask);
+        }
+        parcThreadPool_Unlock(pool);
+    }
+
+    return result;
+}
+
+/*
+ * Release the tasks that no worker will run.
+ */
 static void
-_parcThreadPool_CancelAll(const PARCThreadPool *pool)
+_parcThreadPool_DrainAll(PARCThreadPool *pool)
 {
-    PARCIterator *iterator = parcLinkedList_CreateIterator(pool->threads);
-    
-    while (parcIterator_HasNext(iterator)) {
-        PARCThread *thread = parcIterator_Next(iterator);
-        parcThread_Cancel(thread);
+    for (int i = 0; i < pool->workerSlots; i++) {
+        PARCFutureTask *task;
+        while ((task = _parcThreadPoolDeque_Take(&pool->workers[i].deque)) != NULL) {
+            parcFutureTask_Release(&task);
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+        }
+        if (pool->workers[i].firstTask != NULL) {
+            parcFutureTask_Release(&pool->workers[i].firstTask);
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    if (parcLinkedList_Lock(pool->workQueue)) {
+        while (parcLinkedList_Size(pool->workQueue) > 0) {
+            PARCFutureTask *task = parcLinkedList_RemoveFirst(pool->workQueue);
+            parcFutureTask_Release(&task);
+            __atomic_sub_fetch(&pool->injected, 1, __ATOMIC_RELEASE);
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+        }
+        parcLinkedList_NotifyAll(pool->workQueue);
+        parcLinkedList_Unlock(pool->workQueue);
     }
-    parcIterator_Release(&iterator);
 }
 
+/*
+ * Cancel and join every worker, then discard the tasks they left behind. Only the first call has any effect.
+ */
 static void
-_parcThreadPool_JoinAll(const PARCThreadPool *pool)
+_parcThreadPool_StopWorkers(PARCThreadPool *pool)
 {
-    PARCIterator *iterator = parcLinkedList_CreateIterator(pool->threads);
-    
-    while (parcIterator_HasNext(iterator)) {
-        PARCThread *thread = parcIterator_Next(iterator);
-        parcThread_Join(thread);
+    if (__atomic_exchange_n(&pool->isTerminated, true, __ATOMIC_SEQ_CST) == false) {
+        // No worker is started once the pool is terminated, so the slots stay as they are seen here.
+        if (parcThreadPool_Lock(pool)) {
+            for (int i = 0; i < pool->workerSlots; i++) {
+                if (pool->workers[i].thread != NULL) {
+                    parcThread_Cancel(pool->workers[i].thread);
+                }
+            }
+            // Wake the idle workers so they detect that they are cancelled.
+            parcThreadPool_NotifyAll(pool);
+            parcThreadPool_Unlock(pool);
+        }
+
+        for (int i = 0; i < pool->workerSlots; i++) {
+            if (pool->workers[i].thread != NULL) {
+                parcThread_Join(pool->workers[i].thread);
+            }
+        }
+        _parcThreadPool_DrainAll(pool);
     }
-    parcIterator_Release(&iterator);
 }
 
 static bool
@@ -111,19 +660,26 @@ _parcThreadPool_Destructor(PARCThreadPool **instancePtr)
 {
     assertNotNull(instancePtr, "Parameter must be a non-null pointer to a PARCThreadPool pointer.");
     PARCThreadPool *pool = *instancePtr;
-    
-    if (pool->isShutdown == false) {
-        _parcThreadPool_CancelAll(pool);
-        _parcThreadPool_JoinAll(pool);
+
+    _parcThreadPool_StopWorkers(pool);
+    // Catch any task added by a submitter that raced with the workers stopping.
+    _parcThreadPool_DrainAll(pool);
+
+    for (int i = 0; i < pool->workerSlots; i++) {
+        _PARCThreadPoolWorker *worker = &pool->workers[i];
+        _parcThreadPoolDeque_Fini(&worker->deque);
+        if (worker->thread != NULL) {
+            parcThread_Release(&worker->thread);
+        }
+        if (worker->cpus != NULL) {
+            parcBitVector_Release(&worker->cpus);
+        }
     }
+    parcMemory_Deallocate(&pool->workers);
 
     parcAtomicUint64_Release(&pool->completedTaskCount);
-    parcLinkedList_Release(&pool->threads);
-    
-    if (parcObject_Lock(pool->workQueue)) {
-        parcLinkedList_Release(&pool->workQueue);
-    }
-    
+    parcLinkedList_Release(&pool->workQueue);
+
     return true;
 }
 
@@ -150,41 +706,96 @@ parcThreadPool_AssertValid(const PARCThreadPool *instance)
 }
 
 
-PARCThreadPool *
-parcThreadPool_Create(int poolSize)
+static PARCThreadPool *
+_parcThreadPool_Create(int corePoolSize, int maximumPoolSize, size_t queueCapacity, PARCBitVector *const cpuSets[])
 {
+    assertTrue(maximumPoolSize > 0, "The maximum pool size must be greater than zero, actual %d", maximumPoolSize);
+    assertTrue(corePoolSize >= 0 && corePoolSize <= maximumPoolSize,
+               "The core pool size must be between 0 and the maximum pool size %d, actual %d", maximumPoolSize, corePoolSize);
+    assertTrue(queueCapacity > 0, "The queue capacity must be greater than zero.");
+
     PARCThreadPool *result = parcObject_CreateInstance(PARCThreadPool);
     
     if (result != NULL) {
-        result->poolSize = poolSize;
-        result->maximumPoolSize = poolSize;
+        result->workerSlots = maximumPoolSize;
+        result->poolSize = 0;
+        result->corePoolSize = corePoolSize;
+        result->maximumPoolSize = maximumPoolSize;
+        result->largestPoolSize = 0;
+        result->keepAlive = _PARCThreadPool_DefaultKeepAlive;
+        result->keepAliveIsNever = false;
+        result->allowCoreThreadTimeOut = false;
         result->taskCount = 0;
         result->isShutdown = false;
         result->isTerminated = false;
         result->isTerminating = false;
         result->workQueue = parcLinkedList_Create();
-        result->threads = parcLinkedList_Create();
+        result->pending = 0;
+        result->injected = 0;
+        result->running = 0;
+        result->sleepers = 0;
+
+        result->queueCapacity = queueCapacity;
+        result->rejectionPolicy = PARCThreadPoolRejectionPolicy_Reject;
+        result->blockTimeout = 0;
+        result->blockIsNever = true;
+        result->blockedSubmitters = 0;
+        result->rejectedTaskCount = 0;
         
         result->completedTaskCount = parcAtomicUint64_Create(0);
         
         result->continueExistingPeriodicTasksAfterShutdown = false;
         result->executeExistingDelayedTasksAfterShutdown = false;
         result->removeOnCancel = true;
-        
-        if (parcObject_Lock(result)) {
-            for (int i = 0; i < poolSize; i++) {
-                PARCThread *thread = parcThread_Create((void *(*)(PARCThread *, PARCObject *)) _workerThread, (PARCObject *) result);
-                parcLinkedList_Append(result->threads, thread);
-                parcThread_Start(thread);
-                parcThread_Release(&thread);
-            }
-            parcObject_Unlock(result);
+
+        result->workers = parcMemory_AllocateAndClear(maximumPoolSize * sizeof(_PARCThreadPoolWorker));
+        assertNotNull(result->workers, "parcMemory_AllocateAndClear(%zu) returned NULL", maximumPoolSize * sizeof(_PARCThreadPoolWorker));
+
+        // Every slot must be in place before any worker starts, as workers steal from each other.
+        for (int i = 0; i < maximumPoolSize; i++) {
+            _PARCThreadPoolWorker *worker = &result->workers[i];
+            worker->pool = result;
+            worker->thread = NULL;
+            worker->state = _PARCThreadPoolWorkerState_Empty;
+            worker->firstTask = NULL;
+            worker->cpus = (cpuSets != NULL && cpuSets[i] != NULL) ? parcBitVector_Copy(cpuSets[i]) : NULL;
+            worker->idleSince = 0;
+            worker->seed = 2654435761U * (i + 1);
+            worker->ticks = 0;
+            worker->idleSpins = 0;
+            worker->isPinned = false;
+            worker->isRelocated = false;
+            _parcThreadPoolDeque_Init(&worker->deque);
         }
     }
     
     return result;
 }
 
+PARCThreadPool *
+parcThreadPool_Create(int poolSize)
+{
+    PARCThreadPool *result = _parcThreadPool_Create(poolSize, poolSize, PARCThreadPool_UnboundedQueue, NULL);
+    parcThreadPool_PrestartAllCoreThreads(result);
+    return result;
+}
+
+PARCThreadPool *
+parcThreadPool_CreateWithAffinity(int poolSize, PARCBitVector *const cpuSets[])
+{
+    assertNotNull(cpuSets, "The CPU sets must not be NULL.");
+
+    PARCThreadPool *result = _parcThreadPool_Create(poolSize, poolSize, PARCThreadPool_UnboundedQueue, cpuSets);
+    parcThreadPool_PrestartAllCoreThreads(result);
+    return result;
+}
+
+PARCThreadPool *
+parcThreadPool_CreateBounded(int corePoolSize, int maximumPoolSize, size_t queueCapacity)
+{
+    return _parcThreadPool_Create(corePoolSize, maximumPoolSize, queueCapacity, NULL);
+}
+
 int
 parcThreadPool_Compare(const PARCThreadPool *instance, const PARCThreadPool *other)
 {
@@ -196,7 +807,15 @@ parcThreadPool_Compare(const PARCThreadPool *instance, const PARCThreadPool *oth
 PARCThreadPool *
 parcThreadPool_Copy(const PARCThreadPool *original)
 {
-    PARCThreadPool *result = parcThreadPool_Create(original->poolSize);
+    PARCThreadPool *result = _parcThreadPool_Create(original->corePoolSize, original->maximumPoolSize, original->queueCapacity, NULL);
+
+    result->keepAlive = original->keepAlive;
+    result->keepAliveIsNever = original->keepAliveIsNever;
+    result->allowCoreThreadTimeOut = original->allowCoreThreadTimeOut;
+    result->rejectionPolicy = original->rejectionPolicy;
+    result->blockTimeout = original->blockTimeout;
+    result->blockIsNever = original->blockIsNever;
+    parcThreadPool_PrestartAllCoreThreads(result);
     
     return result;
 }
@@ -220,7 +839,7 @@ parcThreadPool_Equals(const PARCThreadPool *x, const PARCThreadPool *y)
         result = false;
     } else {
         /* perform instance specific equality tests here. */
-        if (x->poolSize == y->poolSize) {
+        if (x->corePoolSize == y->corePoolSize && x->maximumPoolSize == y->maximumPoolSize && x->queueCapacity == y->queueCapacity) {
             result = true;
         }
     }
@@ -268,23 +887,35 @@ parcThreadPool_ToString(const PARCThreadPool *instance)
     return result;
 }
 
-/**
- * Sets the policy governing whether core threads may time out and terminate if no tasks arrive within the keep-alive time, being replaced if needed when new tasks arrive.
- */
 void
 parcThreadPool_SetAllowCoreThreadTimeOut(PARCThreadPool *pool, bool value)
 {
-
+    if (parcThreadPool_Lock(pool)) {
+        pool->allowCoreThreadTimeOut = value;
+        // Wake the idle workers, so that each one reconsiders whether it should stop.
+        parcThreadPool_NotifyAll(pool);
+        parcThreadPool_Unlock(pool);
+    }
 }
 
-/**
- * Returns true if this pool allows core threads to time out and terminate if no tasks arrive within the keepAlive time, being replaced if needed when new tasks arrive.
- */
 bool
 parcThreadPool_GetAllowsCoreThreadTimeOut(const PARCThreadPool *pool)
 {
-    
-    return false;
+    return pool->allowCoreThreadTimeOut;
+}
+
+/*
+ * Compute the absolute time, on the clock used by pthread_cond_timedwait, at which the timeout expires.
+ */
+static struct timespec
+_parcThreadPool_Deadline(const PARCTimeout *timeout)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    uint64_t nanoSeconds = (uint64_t) now.tv_usec * 1000 + parcTimeout_InNanoSeconds(timeout);
+
+    struct timespec result = { .tv_sec = now.tv_sec + nanoSeconds / 1000000000, .tv_nsec = nanoSeconds % 1000000000 };
+    return result;
 }
 
 bool
@@ -293,18 +924,27 @@ parcThreadPool_AwaitTermination(PARCThreadPool *pool, PARCTimeout *timeout)
     bool result = false;
     
     if (pool->isTerminating) {
+        struct timespec deadline = { 0, 0 };
+        if (!parcTimeout_IsNever(timeout)) {
+            deadline = _parcThreadPool_Deadline(timeout);
+        }
+
         if (parcLinkedList_Lock(pool->workQueue)) {
-            while (parcLinkedList_Size(pool->workQueue) > 0) {
+            bool timedOut = false;
+            while (!_parcThreadPool_IsQuiescent(pool) && !timedOut) {
                 if (parcTimeout_IsNever(timeout)) {
                     parcLinkedList_Wait(pool->workQueue);
                 } else {
-                    // This is not accurate as this will continue the delay, rather than keep a cumulative amount of delay.
-                    uint64_t delay = parcTimeout_InNanoSeconds(timeout);
-                    parcLinkedList_WaitFor(pool->workQueue, delay);
+                    timedOut = !parcLinkedList_WaitUntil(pool->workQueue, &deadline);
                 }
             }
+            result = _parcThreadPool_IsQuiescent(pool);
             parcLinkedList_Unlock(pool->workQueue);
         }
+
+        if (result) {
+            _parcThreadPool_StopWorkers(pool);
+        }
     }
     
     return result;
@@ -315,34 +955,200 @@ parcThreadPool_AwaitTermination(PARCThreadPool *pool, PARCTimeout *timeout)
  */
 //protected void	beforeExecute(Thread t, Runnable r)
 
+/*
+ * Start a worker whose first task is the given one.
+ */
+static bool
+_parcThreadPool_AddWorkerFor(PARCThreadPool *pool, PARCFutureTask *task, bool core)
+{
+    PARCFutureTask *reference = parcFutureTask_Acquire(task);
+    bool result = _parcThreadPool_AddWorker(pool, reference, core);
+    if (result == false) {
+        parcFutureTask_Release(&reference);
+    }
+    return result;
+}
+
+/*
+ * Append the task to the injection queue if it has room.
+ */
+static bool
+_parcThreadPool_Offer(PARCThreadPool *pool, PARCFutureTask *task)
+{
+    bool result = false;
+
+    if (parcLinkedList_Lock(pool->workQueue)) {
+        if (parcLinkedList_Size(pool->workQueue) < pool->queueCapacity) {
+            parcLinkedList_Append(pool->workQueue, task);
+            __atomic_add_fetch(&pool->injected, 1, __ATOMIC_RELEASE);
+            result = true;
+        }
+        parcLinkedList_Unlock(pool->workQueue);
+    }
+
+    return result;
+}
+
+/*
+ * Append the task to the full injection queue after cancelling the task that has waited longest.
+ */
+static bool
+_parcThreadPool_DiscardOldest(PARCThreadPool *pool, PARCFutureTask *task)
+{
+    bool result = false;
+    PARCFutureTask *oldest = NULL;
+
+    if (parcLinkedList_Lock(pool->workQueue)) {
+        if (parcLinkedList_Size(pool->workQueue) >= pool->queueCapacity) {
+            oldest = parcLinkedList_RemoveFirst(pool->workQueue);
+            __atomic_sub_fetch(&pool->injected, 1, __ATOMIC_RELEASE);
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+        }
+        parcLinkedList_Append(pool->workQueue, task);
+        __atomic_add_fetch(&pool->injected, 1, __ATOMIC_RELEASE);
+        result = true;
+        parcLinkedList_Unlock(pool->workQueue);
+    }
+
+    if (oldest != NULL) {
+        // Cancelling completes the task, so anything waiting for it, or continuing from it, is not left waiting.
+        parcFutureTask_Cancel(oldest, false);
+        parcFutureTask_Release(&oldest);
+        __atomic_add_fetch(&pool->rejectedTaskCount, 1, __ATOMIC_RELAXED);
+    }
+
+    return result;
+}
+
+/*
+ * Wait for the injection queue to have room for the task, until the pool's block timeout expires or the pool is shut down.
+ */
+static bool
+_parcThreadPool_OfferWait(PARCThreadPool *pool, PARCFutureTask *task)
+{
+    bool result = false;
+
+    struct timespec deadline = { 0, 0 };
+    if (pool->blockIsNever == false) {
+        deadline = _parcThreadPool_Deadline(&pool->blockTimeout);
+    }
+
+    if (parcLinkedList_Lock(pool->workQueue)) {
+        pool->blockedSubmitters++;
+        bool timedOut = false;
+        while (parcLinkedList_Size(pool->workQueue) >= pool->queueCapacity && !timedOut
+               && __atomic_load_n(&pool->isTerminating, __ATOMIC_ACQUIRE) == false) {
+            if (pool->blockIsNever) {
+                parcLinkedList_Wait(pool->workQueue);
+            } else {
+                timedOut = !parcLinkedList_WaitUntil(pool->workQueue, &deadline);
+            }
+        }
+        if (parcLinkedList_Size(pool->workQueue) < pool->queueCapacity && __atomic_load_n(&pool->isTerminating, __ATOMIC_ACQUIRE) == false) {
+            parcLinkedList_Append(pool->workQueue, task);
+            __atomic_add_fetch(&pool->injected, 1, __ATOMIC_RELEASE);
+            result = true;
+        }
+        pool->blockedSubmitters--;
+        parcLinkedList_Unlock(pool->workQueue);
+    }
+
+    return result;
+}
+
+/*
+ * Give a task from outside the pool to a new core worker, the injection queue, or a new worker beyond the core,
+ * in that order of preference, as java.util.concurrent.ThreadPoolExecutor does.
+ * If none will take it, apply the rejection policy.
+ */
+static bool
+_parcThreadPool_Submit(PARCThreadPool *pool, PARCFutureTask *task)
+{
+    bool result = false;
+
+    if (__atomic_load_n(&pool->poolSize, __ATOMIC_SEQ_CST) < pool->corePoolSize) {
+        result = _parcThreadPool_AddWorkerFor(pool, task, true);
+    }
+    if (result == false) {
+        bool queued = _parcThreadPool_Offer(pool, task);
+        if (queued == false) {
+            result = _parcThreadPool_AddWorkerFor(pool, task, false);
+            if (result == false) {
+                if (pool->rejectionPolicy == PARCThreadPoolRejectionPolicy_DiscardOldest) {
+                    queued = _parcThreadPool_DiscardOldest(pool, task);
+                } else if (pool->rejectionPolicy == PARCThreadPoolRejectionPolicy_Block) {
+                    queued = _parcThreadPool_OfferWait(pool, task);
+                }
+            }
+        }
+        if (queued) {
+            // Every worker may have retired since this submitter last looked.
+            if (__atomic_load_n(&pool->poolSize, __ATOMIC_SEQ_CST) == 0) {
+                _parcThreadPool_AddWorker(pool, NULL, false);
+            }
+            result = true;
+        }
+    }
+
+    return result;
+}
+
 bool
 parcThreadPool_Execute(PARCThreadPool *pool, PARCFutureTask *task)
 {
     bool result = false;
-    
-    if (parcThreadPool_Lock(pool)) {
-        if (pool->isTerminated == false && pool->isTerminating == false) {
-            parcThreadPool_Unlock(pool);
-            if (parcLinkedList_Lock(pool->workQueue)) {
-                parcLinkedList_Append(pool->workQueue, task);
-                parcLinkedList_Notify(pool->workQueue);
-                parcLinkedList_Unlock(pool->workQueue);
-                result = true;
-            }
+
+    _PARCThreadPoolWorker *worker = _parcThreadPool_CurrentWorker;
+    bool isWorker = (worker != NULL && worker->pool == pool);
+
+    // After a shutdown, running tasks may still add work so that recursive computations can finish.
+    if (__atomic_load_n(&pool->isTerminated, __ATOMIC_ACQUIRE) == false
+        && (isWorker || __atomic_load_n(&pool->isTerminating, __ATOMIC_ACQUIRE) == false)) {
+        __atomic_add_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+
+        if (isWorker) {
+            // A worker's own deque is not bounded, as a task waiting for its children must be able to add them.
+            _parcThreadPoolDeque_Push(&worker->deque, parcFutureTask_Acquire(task));
+            result = true;
         } else {
-            parcThreadPool_Unlock(pool);
+            result = _parcThreadPool_Submit(pool, task);
+        }
+
+        if (result) {
+            __atomic_add_fetch(&pool->taskCount, 1, __ATOMIC_RELAXED);
+            _parcThreadPool_WakeWorker(pool);
+        } else {
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+
+            if (__atomic_load_n(&pool->isTerminating, __ATOMIC_ACQUIRE) == false) {
+                __atomic_add_fetch(&pool->rejectedTaskCount, 1, __ATOMIC_RELAXED);
+                if (pool->rejectionPolicy == PARCThreadPoolRejectionPolicy_CallerRuns) {
+                    parcFutureTask_Run(task);
+                    result = true;
+                }
+            }
         }
     }
     
     return result;
 }
 
+static const PARCExecutorInterface *PARCThreadPoolAsPARCExecutor = &(PARCExecutorInterface) {
+    .Execute = (bool (*)(void *, PARCFutureTask *))parcThreadPool_Execute,
+    .Release = (void (*)(void **))parcThreadPool_Release
+};
+
+PARCExecutor *
+parcThreadPool_AsExecutor(PARCThreadPool *pool)
+{
+    return parcExecutor_Create(parcThreadPool_Acquire(pool), PARCThreadPoolAsPARCExecutor);
+}
+
 int
 parcThreadPool_GetActiveCount(const PARCThreadPool *pool)
 {
-    return pool->poolSize;
+    return (int) __atomic_load_n(&pool->running, __ATOMIC_RELAXED);
 }
-
 uint64_t
 parcThreadPool_GetCompletedTaskCount(const PARCThreadPool *pool)
 {
@@ -352,19 +1158,19 @@ parcThreadPool_GetCompletedTaskCount(const PARCThreadPool *pool)
 int
 parcThreadPool_GetCorePoolSize(const PARCThreadPool *pool)
 {
-    return pool->poolSize;
+    return pool->corePoolSize;
 }
 
 PARCTimeout *
 parcThreadPool_GetKeepAliveTime(const PARCThreadPool *pool)
 {
-    return PARCTimeout_Never;
+    return pool->keepAliveIsNever ? PARCTimeout_Never : (PARCTimeout *) &pool->keepAlive;
 }
 
 int
 parcThreadPool_GetLargestPoolSize(const PARCThreadPool *pool)
 {
-    return pool->poolSize;
+    return pool->largestPoolSize;
 }
 
 int
@@ -376,7 +1182,7 @@ parcThreadPool_GetMaximumPoolSize(const PARCThreadPool *pool)
 int
 parcThreadPool_GetPoolSize(const PARCThreadPool *pool)
 {
-    return pool->poolSize;
+    return __atomic_load_n(&pool->poolSize, __ATOMIC_RELAXED);
 }
 
 PARCLinkedList
@@ -385,15 +1191,36 @@ PARCLinkedList
     return pool->workQueue;
 }
 
-///**
-// * Returns the current handler for unexecutable tasks.
-// */
-//RejectedExecutionHandler parcThreadPool_GetRejectedExecutionHandler(PARCThreadPool *pool);
+size_t
+parcThreadPool_GetQueueCapacity(const PARCThreadPool *pool)
+{
+    return pool->queueCapacity;
+}
+
+void
+parcThreadPool_SetRejectionPolicy(PARCThreadPool *pool, PARCThreadPoolRejectionPolicy policy, const PARCTimeout *timeout)
+{
+    pool->blockIsNever = parcTimeout_IsNever(timeout);
+    pool->blockTimeout = pool->blockIsNever ? 0 : parcTimeout_InNanoSeconds(timeout);
+    pool->rejectionPolicy = policy;
+}
+
+PARCThreadPoolRejectionPolicy
+parcThreadPool_GetRejectionPolicy(const PARCThreadPool *pool)
+{
+    return pool->rejectionPolicy;
+}
+
+uint64_t
+parcThreadPool_GetRejectedTaskCount(const PARCThreadPool *pool)
+{
+    return __atomic_load_n(&pool->rejectedTaskCount, __ATOMIC_RELAXED);
+}
 
 long
 parcThreadPool_GetTaskCount(const PARCThreadPool *pool)
 {
-    return pool->taskCount;
+    return __atomic_load_n(&pool->taskCount, __ATOMIC_RELAXED);
 }
 
 /**
@@ -425,16 +1252,17 @@ parcThreadPool_IsTerminating(const PARCThreadPool *pool)
 int
 parcThreadPool_PrestartAllCoreThreads(PARCThreadPool *pool)
 {
-    return 0;
+    int result = 0;
+    while (_parcThreadPool_AddWorker(pool, NULL, true)) {
+        result++;
+    }
+    return result;
 }
 
-/**
- * Starts a core thread, causing it to idly wait for work.
- */
 bool
 parcThreadPool_PrestartCoreThread(PARCThreadPool *pool)
 {
-    return 0;
+    return _parcThreadPool_AddWorker(pool, NULL, true);
 }
 
 /**
@@ -455,31 +1283,49 @@ parcThreadPool_Remove(PARCThreadPool *pool, PARCFutureTask *task)
     return false;
 }
 
-/**
- * Sets the core number of threads.
- */
 void
 parcThreadPool_SetCorePoolSize(PARCThreadPool *pool, int corePoolSize)
 {
+    assertTrue(corePoolSize >= 0 && corePoolSize <= pool->maximumPoolSize,
+               "The core pool size must be between 0 and the maximum pool size %d, actual %d", pool->maximumPoolSize, corePoolSize);
 
+    if (parcThreadPool_Lock(pool)) {
+        pool->corePoolSize = corePoolSize;
+
+        // Start enough new core workers to take the queued tasks, and let any excess idle workers time out.
+        size_t queued = __atomic_load_n(&pool->injected, __ATOMIC_ACQUIRE);
+        while (pool->poolSize < corePoolSize && queued-- > 0 && pool->isTerminated == false) {
+            _parcThreadPool_StartWorker(pool, NULL);
+        }
+        parcThreadPool_NotifyAll(pool);
+        parcThreadPool_Unlock(pool);
+    }
 }
 
-/**
- * Sets the time limit for which threads may remain idle before being terminated.
- */
 void
 parcThreadPool_SetKeepAliveTime(PARCThreadPool *pool, PARCTimeout *timeout)
 {
-
+    if (parcThreadPool_Lock(pool)) {
+        pool->keepAliveIsNever = parcTimeout_IsNever(timeout);
+        pool->keepAlive = pool->keepAliveIsNever ? 0 : parcTimeout_InNanoSeconds(timeout);
+        parcThreadPool_NotifyAll(pool);
+        parcThreadPool_Unlock(pool);
+    }
 }
 
-/**
- * Sets the maximum allowed number of threads.
- */
 void
 parcThreadPool_SetMaximumPoolSize(PARCThreadPool *pool, int maximumPoolSize)
 {
+    assertTrue(maximumPoolSize > 0 && maximumPoolSize >= pool->corePoolSize && maximumPoolSize <= pool->workerSlots,
+               "The maximum pool size must be at least the core pool size %d and at most %d, actual %d",
+               pool->corePoolSize, pool->workerSlots, maximumPoolSize);
 
+    if (parcThreadPool_Lock(pool)) {
+        // Workers beyond the new maximum stop as soon as they are idle.
+        pool->maximumPoolSize = maximumPoolSize;
+        parcThreadPool_NotifyAll(pool);
+        parcThreadPool_Unlock(pool);
+    }
 }
 
 ///**
@@ -500,7 +1346,13 @@ parcThreadPool_SetMaximumPoolSize(PARCThreadPool *pool, int maximumPoolSize)
 void
 parcThreadPool_Shutdown(PARCThreadPool *pool)
 {
-    pool->isTerminating = true;
+    pool->isShutdown = true;
+    __atomic_store_n(&pool->isTerminating, true, __ATOMIC_SEQ_CST);
+
+    if (parcLinkedList_Lock(pool->workQueue)) {
+        parcLinkedList_NotifyAll(pool->workQueue);
+        parcLinkedList_Unlock(pool->workQueue);
+    }
 }
 
 /**
@@ -510,24 +1362,9 @@ PARCLinkedList *
 parcThreadPool_ShutdownNow(PARCThreadPool *pool)
 {
     parcThreadPool_Shutdown(pool);
-    
-    // Cause all of the worker threads to exit.
-    _parcThreadPool_CancelAll(pool);
-    
-    // Wake them all up so they detect that they are cancelled.
-    if (parcThreadPool_Lock(pool)) {
-        pool->isTerminating = true;
-        parcThreadPool_NotifyAll(pool);
-        parcThreadPool_Unlock(pool);
-    }
-    
-    if (parcLinkedList_Lock(pool->workQueue)) {
-        parcLinkedList_NotifyAll(pool->workQueue);
-        parcLinkedList_Unlock(pool->workQueue);
-    }
-    // Join with all of them, thereby cleaning up all of them.
-    _parcThreadPool_JoinAll(pool);
-    
-    pool->isTerminated = true;
+
+    // Cancel and join all of the worker threads, releasing the tasks they did not run.
+    _parcThreadPool_StopWorkers(pool);
+
     return NULL;
 }
@@ -36,16 +36,49 @@
 #ifndef PARCLibrary_parc_ThreadPool
 #define PARCLibrary_parc_ThreadPool
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <parc/algol/parc_JSON.h>
 #include <parc/algol/parc_HashCode.h>
 #include <parc/algol/parc_LinkedList.h>
+#include <parc/algol/parc_BitVector.h>
 #include <parc/concurrent/parc_Timeout.h>
 #include <parc/concurrent/parc_FutureTask.h>
+#include <parc/concurrent/parc_Executor.h>
 
 struct PARCThreadPool;
 typedef struct PARCThreadPool PARCThreadPool;
 
+/**
+ * A queue capacity meaning that the queue of tasks waiting for a worker is not bounded.
+ */
+#define PARCThreadPool_UnboundedQueue SIZE_MAX
+
+/**
+ * @typedef PARCThreadPoolRejectionPolicy
+ * @brief What `parcThreadPool_Execute` does with a task when the queue is full and the pool has its maximum number of workers.
+ */
+typedef enum {
+    /**
+     * Refuse the task: `parcThreadPool_Execute` returns false.
+     */
+    PARCThreadPoolRejectionPolicy_Reject,
+    /**
+     * Run the task in the thread that called `parcThreadPool_Execute`.
+     * This slows the submitter to the rate at which the pool completes tasks.
+     */
+    PARCThreadPoolRejectionPolicy_CallerRuns,
+    /**
+     * Cancel the task that has waited longest in the queue, and queue the new task in its place.
+     */
+    PARCThreadPoolRejectionPolicy_DiscardOldest,
+    /**
+     * Wait for room in the queue, for up to the timeout given to `parcThreadPool_SetRejectionPolicy`.
+     * The task is refused if the timeout expires or the pool is shut down first.
+     */
+    PARCThreadPoolRejectionPolicy_Block
+} PARCThreadPoolRejectionPolicy;
+
 /**
  * Increase the number of references to a `PARCThreadPool` instance.
  *
@@ -100,7 +133,14 @@ void parcThreadPool_AssertValid(const PARCThreadPool *instance);
 /**
  * Create an instance of PARCThreadPool
  *
- * <#Paragraphs Of Explanation#>
+ * The pool starts @p poolSize worker threads.
+ * Each worker keeps its own deque of tasks, running the most recently added first,
+ * and a worker that runs out of tasks steals the oldest task from another worker.
+ * Tasks executed from outside the pool are placed on a shared queue that the workers take from in batches.
+ *
+ * The pool must be shut down with `parcThreadPool_ShutdownNow` or `parcThreadPool_AwaitTermination` before its last reference is released.
+ *
+ * @param [in] poolSize The number of worker threads, which must be greater than zero.
  *
  * @return non-NULL A pointer to a valid PARCThreadPool instance.
  * @return NULL An error occurred.
@@ -116,6 +156,81 @@ void parcThreadPool_AssertValid(const PARCThreadPool *instance);
  */
 PARCThreadPool *parcThreadPool_Create(int poolSize);
 
+/**
+ * Create an instance of PARCThreadPool whose workers each run only on a given set of CPUs.
+ *
+ * The pool is as created by {@link parcThreadPool_Create}, but worker `i` is pinned to the CPUs in `cpuSets[i]`
+ * before it takes any task.  A NULL entry leaves that worker free to run anywhere.
+ * A pinned worker allocates its own deque, so that its memory is on the NUMA node of the CPUs it runs on.
+ *
+ * Every pool names its workers `PARCPool-0`, `PARCPool-1`, and so on, as shown by debuggers and `top -H`.
+ *
+ * Pinning a pipeline stage to the CPUs of the node where the reactor thread that feeds it runs keeps the data they share
+ * in one cache hierarchy.  The sets are usually built with the functions of `parc_CpuTopology.h`.
+ * A set none of whose CPUs is online, or any set on a platform without thread affinity, leaves its worker unpinned.
+ *
+ * @param [in] poolSize The number of worker threads, which must be greater than zero.
+ * @param [in] cpuSets An array of @p poolSize pointers to sets of CPUs, or NULL.  The sets are copied.
+ *
+ * @return non-NULL A pointer to a valid PARCThreadPool instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     int cpu = parcCpuTopology_GetCurrentCpu();
+ *     PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(parcCpuTopology_GetNodeOfCpu(cpu));
+ *     PARCBitVector *cpuSets[] = { cpus, cpus, cpus, cpus };
+ *
+ *     PARCThreadPool *pool = parcThreadPool_CreateWithAffinity(4, cpuSets);
+ *     parcBitVector_Release(&cpus);
+ *
+ *     parcThreadPool_ShutdownNow(pool);
+ *     parcThreadPool_Release(&pool);
+ * }
+ * @endcode
+ */
+PARCThreadPool *parcThreadPool_CreateWithAffinity(int poolSize, PARCBitVector *const cpuSets[]);
+
+/**
+ * Create an instance of PARCThreadPool that grows and shrinks with its load, and holds a bounded number of waiting tasks.
+ *
+ * The pool starts with no workers.  A task executed from outside the pool goes
+ *
+ * * to a new worker, while there are fewer than @p corePoolSize workers;
+ * * otherwise to the queue, while it holds fewer than @p queueCapacity tasks;
+ * * otherwise to a new worker, while there are fewer than @p maximumPoolSize workers;
+ * * otherwise it is rejected, as `parcThreadPool_SetRejectionPolicy` determines.  By default, `parcThreadPool_Execute` returns false.
+ *
+ * A worker beyond the core pool size stops once it has found no work for the keep-alive time, 60 seconds by default.
+ * Tasks executed by a task running in the pool go to the worker's own deque, which is not bounded.
+ *
+ * @param [in] corePoolSize The number of workers kept even when idle, which may be zero.
+ * @param [in] maximumPoolSize The largest number of workers, which must be at least 1 and at least @p corePoolSize.
+ * @param [in] queueCapacity The largest number of tasks waiting for a worker, which must be at least 1,
+ *                           or `PARCThreadPool_UnboundedQueue`.
+ *
+ * @return non-NULL A pointer to a valid PARCThreadPool instance.
+ * @return NULL An error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCThreadPool *pool = parcThreadPool_CreateBounded(2, 8, 1000);
+ *     parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_Block, parcTimeout_MilliSeconds(100));
+ *
+ *     if (parcThreadPool_Execute(pool, task) == false) {
+ *         // The pool stayed full for 100 milliseconds.
+ *     }
+ *
+ *     parcThreadPool_Shutdown(pool);
+ *     parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+ *     parcThreadPool_Release(&pool);
+ * }
+ * @endcode
+ */
+PARCThreadPool *parcThreadPool_CreateBounded(int corePoolSize, int maximumPoolSize, size_t queueCapacity);
+
 /**
  * Compares @p instance with @p other for order.
  *
@@ -512,6 +627,8 @@ parcObject_ImplementIsLocked(parcThreadPool, PARCThreadPool);
 
 /**
  * Sets the policy governing whether core threads may time out and terminate if no tasks arrive within the keep-alive time, being replaced if needed when new tasks arrive.
+ *
+ * The last worker never stops while tasks are waiting, and a worker is started again for a task executed when there are none.
  */
 void parcThreadPool_SetAllowCoreThreadTimeOut(PARCThreadPool *pool, bool value);
 
@@ -522,14 +639,38 @@ bool parcThreadPool_GetAllowsCoreThreadTimeOut(const PARCThreadPool *pool);
 
 /**
  * Blocks until all tasks have completed execution after a shutdown request, or the timeout occurs, whichever happens first.
+ *
+ * @return true All tasks completed and the worker threads have been stopped.
+ * @return false The timeout occurred or the pool was not shut down.
  */
 bool parcThreadPool_AwaitTermination(PARCThreadPool *pool, PARCTimeout *timeout);
 
 /**
  * Executes the given task sometime in the future.
+ *
+ * A task executed by a task running in the same pool goes to the current worker's own deque,
+ * where it runs next on that worker unless another, idle, worker steals it first.
+ * After `parcThreadPool_Shutdown` only such tasks are accepted, so that running computations can finish.
+ *
+ * A task executed from outside the pool is given to a worker or queued as described for `parcThreadPool_CreateBounded`.
+ * If the pool is full, the rejection policy decides what happens to it.
+ *
+ * @return true The task was accepted, or under `PARCThreadPoolRejectionPolicy_CallerRuns`, has been run.
+ * @return false The pool is shut down, or it was full and the task was rejected.
  */
 bool parcThreadPool_Execute(PARCThreadPool *pool, PARCFutureTask *task);
 
+/**
+ * Create a `PARCExecutor` that gives tasks to this pool with `parcThreadPool_Execute`.
+ *
+ * The executor holds a reference to the pool.
+ * A continuation dispatched by a task completing on one of the pool's workers goes to that worker's own deque,
+ * so a pipeline of continuations tends to stay on one thread.
+ *
+ * @return non-NULL A pointer to a valid `PARCExecutor` instance, which must be released.
+ */
+PARCExecutor *parcThreadPool_AsExecutor(PARCThreadPool *pool);
+
 /**
  * Returns the approximate number of threads that are actively executing tasks.
  */
@@ -566,10 +707,42 @@ int parcThreadPool_GetMaximumPoolSize(const PARCThreadPool *pool);
 int parcThreadPool_GetPoolSize(const PARCThreadPool *pool);
 
 /**
- * Returns the task queue used by this executor.
+ * Returns the queue of tasks executed from outside the pool and not yet taken by a worker.
  */
 PARCLinkedList *parcThreadPool_GetQueue(const PARCThreadPool *pool);
 
+/**
+ * Returns the largest number of tasks the queue holds, which is `PARCThreadPool_UnboundedQueue` if it is not bounded.
+ */
+size_t parcThreadPool_GetQueueCapacity(const PARCThreadPool *pool);
+
+/**
+ * Sets what `parcThreadPool_Execute` does with a task when the queue is full and the pool has its maximum number of workers.
+ *
+ * @param [in] pool A pointer to a valid `PARCThreadPool` instance.
+ * @param [in] policy The rejection policy.
+ * @param [in] timeout How long `PARCThreadPoolRejectionPolicy_Block` waits for room.  The other policies ignore it.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_CallerRuns, PARCTimeout_Never);
+ * }
+ * @endcode
+ */
+void parcThreadPool_SetRejectionPolicy(PARCThreadPool *pool, PARCThreadPoolRejectionPolicy policy, const PARCTimeout *timeout);
+
+/**
+ * Returns the rejection policy.
+ */
+PARCThreadPoolRejectionPolicy parcThreadPool_GetRejectionPolicy(const PARCThreadPool *pool);
+
+/**
+ * Returns the number of tasks that were rejected because the pool was full, including those discarded from the queue
+ * and those run by their submitters.
+ */
+uint64_t parcThreadPool_GetRejectedTaskCount(const PARCThreadPool *pool);
+
 /**
  * Returns the approximate total number of tasks that have ever been scheduled for execution.
  */
@@ -612,16 +785,24 @@ bool parcThreadPool_Remove(PARCThreadPool *pool, PARCFutureTask *task);
 
 /**
  * Sets the core number of threads.
+ *
+ * If the new value is larger, new threads are started to run any queued tasks.
+ * If it is smaller, the excess threads stop once they have been idle for the keep-alive time.
  */
 void parcThreadPool_SetCorePoolSize(PARCThreadPool *pool, int corePoolSize);
 
 /**
  * Sets the time limit for which threads may remain idle before being terminated.
+ *
+ * `PARCTimeout_Never` keeps idle threads indefinitely.
  */
 void parcThreadPool_SetKeepAliveTime(PARCThreadPool *pool, PARCTimeout *timeout);
 
 /**
  * Sets the maximum allowed number of threads.
+ *
+ * The maximum cannot be raised above the maximum pool size the pool was created with.
+ * If it is lowered, the excess threads stop as soon as they are idle.
  */
 void parcThreadPool_SetMaximumPoolSize(PARCThreadPool *pool, int maximumPoolSize);
 
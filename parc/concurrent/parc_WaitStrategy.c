@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Each condition has an event: a sequence number, which a signaller increments, and a count of the threads asleep on it.
+ *
+ * A thread parks by reading the sequence number, counting itself as a sleeper, trying once more, and then sleeping
+ * for as long as the sequence number is unchanged.  A signaller publishes its change, and only then looks at the
+ * count of sleepers; if there are any, it increments the sequence number and wakes them.  Both sides separate the
+ * store from the load with a full fence, so either the parking thread's last attempt sees the change, or the signaller
+ * sees the sleeper.  In the second case the sequence number has moved on, so the sleep returns at once if it has not
+ * begun.
+ *
+ * On Linux the sleep is a futex wait on the sequence number.  Elsewhere it is a condition variable.
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#if __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Time.h>
+
+#include <parc/concurrent/parc_WaitStrategy.h>
+
+// Attempts that spin before the thread yields (SpinThenYield) or begins to yield (Park).
+#define _PARCWaitStrategy_Spins 100
+
+// Attempts that yield before a Park thread sleeps.
+#define _PARCWaitStrategy_Yields 10
+
+// How many spinning attempts pass between checks of the clock.
+#define _PARCWaitStrategy_ClockInterval 64
+
+typedef struct {
+    volatile uint32_t sequence;
+    volatile uint32_t sleepers;
+#if !__linux__
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+#endif
+    uint8_t padding[LEVEL1_DCACHE_LINESIZE];
+} _PARCWaitStrategyEvent;
+
+struct PARCWaitStrategy {
+    PARCWaitStrategyKind kind;
+    _PARCWaitStrategyEvent events[2];
+};
+
+static inline void
+_parcWaitStrategy_Relax(void)
+{
+#if (__x86_64__ || __i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+#if __linux__
+static void
+_parcWaitStrategy_Sleep(_PARCWaitStrategyEvent *event, uint32_t sequence, uint64_t deadline)
+{
+    struct timespec timeout;
+    struct timespec *timeoutPtr = NULL;
+
+    if (deadline != 0) {
+        uint64_t now = parcTime_NowNanoseconds();
+        if (now >= deadline) {
+            return;
+        }
+        timeout.tv_sec = (deadline - now) / 1000000000ULL;
+        timeout.tv_nsec = (deadline - now) % 1000000000ULL;
+        timeoutPtr = &timeout;
+    }
+
+    // Returns at once, with EAGAIN, if the sequence number has already changed.
+    syscall(SYS_futex, &event->sequence, FUTEX_WAIT_PRIVATE, sequence, timeoutPtr, NULL, 0);
+}
+
+static void
+_parcWaitStrategy_Wake(_PARCWaitStrategyEvent *event)
+{
+    syscall(SYS_futex, &event->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+#else
+static void
+_parcWaitStrategy_Sleep(_PARCWaitStrategyEvent *event, uint32_t sequence, uint64_t deadline)
+{
+    pthread_mutex_lock(&event->mutex);
+    if (event->sequence == sequence) {
+        if (deadline == 0) {
+            pthread_cond_wait(&event->condition, &event->mutex);
+        } else {
+            // parcTime_NowNanoseconds reads the realtime clock, which is what pthread_cond_timedwait expects.
+            struct timespec abstime = { .tv_sec = deadline / 1000000000ULL, .tv_nsec = deadline % 1000000000ULL };
+            pthread_cond_timedwait(&event->condition, &event->mutex, &abstime);
+        }
+    }
+    pthread_mutex_unlock(&event->mutex);
+}
+
+static void
+_parcWaitStrategy_Wake(_PARCWaitStrategyEvent *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    pthread_cond_broadcast(&event->condition);
+    pthread_mutex_unlock(&event->mutex);
+}
+#endif
+
+/*
+ * Register as a sleeper, make a last attempt, and sleep if it fails.
+ */
+static bool
+_parcWaitStrategy_Park(_PARCWaitStrategyEvent *event, PARCWaitStrategyAttempt *attempt, void *context, uint64_t deadline)
+{
+    uint32_t sequence = __atomic_load_n(&event->sequence, __ATOMIC_ACQUIRE);
+    __atomic_add_fetch(&event->sleepers, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    bool result = attempt(context);
+    if (result == false) {
+        _parcWaitStrategy_Sleep(event, sequence, deadline);
+    }
+
+    __atomic_sub_fetch(&event->sleepers, 1, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+static void
+_parcWaitStrategy_Finalize(PARCWaitStrategy **instancePtr)
+{
+#if !__linux__
+    PARCWaitStrategy *strategy = *instancePtr;
+    for (int i = 0; i < 2; i++) {
+        pthread_mutex_destroy(&strategy->events[i].mutex);
+        pthread_cond_destroy(&strategy->events[i].condition);
+    }
+#endif
+}
+
+parcObject_ExtendPARCObject(PARCWaitStrategy, _parcWaitStrategy_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(parcWaitStrategy, PARCWaitStrategy);
+
+parcObject_ImplementRelease(parcWaitStrategy, PARCWaitStrategy);
+
+PARCWaitStrategy *
+parcWaitStrategy_Create(PARCWaitStrategyKind kind)
+{
+    PARCWaitStrategy *result = parcObject_CreateInstance(PARCWaitStrategy);
+    assertNotNull(result, "parcObject_CreateInstance returned NULL");
+
+    result->kind = kind;
+    for (int i = 0; i < 2; i++) {
+        result->events[i].sequence = 0;
+        result->events[i].sleepers = 0;
+#if !__linux__
+        pthread_mutex_init(&result->events[i].mutex, NULL);
+        pthread_cond_init(&result->events[i].condition, NULL);
+#endif
+    }
+
+    return result;
+}
+
+PARCWaitStrategyKind
+parcWaitStrategy_GetKind(const PARCWaitStrategy *strategy)
+{
+    return strategy->kind;
+}
+
+bool
+parcWaitStrategy_Await(PARCWaitStrategy *strategy, PARCWaitStrategyCondition condition,
+                       PARCWaitStrategyAttempt *attempt, void *context, const PARCTimeout *timeout)
+{
+    if (attempt(context)) {
+        return true;
+    }
+    if (parcTimeout_IsImmediate(timeout)) {
+        return false;
+    }
+
+    // A deadline of 0 means there is none.
+    uint64_t deadline = parcTimeout_IsNever(timeout) ? 0 : parcTime_NowNanoseconds() + parcTimeout_InNanoSeconds(timeout);
+    _PARCWaitStrategyEvent *event = &strategy->events[condition];
+
+    for (unsigned round = 1; ; round++) {
+        bool spinning = strategy->kind == PARCWaitStrategyKind_BusySpin || round < _PARCWaitStrategy_Spins;
+
+        if (deadline != 0 && (!spinning || round % _PARCWaitStrategy_ClockInterval == 0)) {
+            if (parcTime_NowNanoseconds() >= deadline) {
+                return false;
+            }
+        }
+
+        if (spinning) {
+            _parcWaitStrategy_Relax();
+        } else if (strategy->kind == PARCWaitStrategyKind_SpinThenYield || round < _PARCWaitStrategy_Spins + _PARCWaitStrategy_Yields) {
+            sched_yield();
+        } else if (_parcWaitStrategy_Park(event, attempt, context, deadline)) {
+            return true;
+        }
+
+        if (attempt(context)) {
+            return true;
+        }
+    }
+}
+
+void
+parcWaitStrategy_Signal(PARCWaitStrategy *strategy, PARCWaitStrategyCondition condition)
+{
+    if (strategy->kind == PARCWaitStrategyKind_Park) {
+        _PARCWaitStrategyEvent *event = &strategy->events[condition];
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&event->sleepers, __ATOMIC_RELAXED) > 0) {
+            __atomic_add_fetch(&event->sequence, 1, __ATOMIC_SEQ_CST);
+            _parcWaitStrategy_Wake(event);
+        }
+    }
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file parc_WaitStrategy.h
+ * @ingroup threading
+ * @brief How a thread waits for a non-blocking data structure to become ready.
+ *
+ * The ring buffers are non-blocking: a Put on a full ring or a Get on an empty ring returns `false` at once.
+ * A `PARCWaitStrategy` turns such an operation into a blocking one, by retrying it until it succeeds or a timeout expires,
+ * and decides what the thread does between attempts.
+ *
+ * * `PARCWaitStrategyKind_BusySpin` retries continuously.  It gives the lowest latency, but the waiting thread uses a whole CPU.
+ * * `PARCWaitStrategyKind_SpinThenYield` retries a few times, then calls `sched_yield()` between attempts.
+ *   Other threads can run, but the waiting thread still never sleeps.
+ * * `PARCWaitStrategyKind_Park` spins and yields briefly, then sleeps until another thread signals that the
+ *   structure has changed.  A signaller makes a system call only if some thread is actually asleep, so a busy
+ *   queue costs no system calls at all.  On Linux the sleep is a futex wait.
+ *
+ * Every thread that uses one queue should share one `PARCWaitStrategy`, and every operation on the queue should go
+ * through the waiting variants (for example {@link parcRingBuffer1x1_PutWait} and {@link parcRingBuffer1x1_GetWait}),
+ * which signal the strategy after they succeed.  A non-blocking operation does not signal, so it will not wake a parked thread.
+ *
+ * @code
+ * {
+ *     PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(1024, NULL);
+ *     PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+ *
+ *     // producer
+ *     parcRingBuffer1x1_PutWait(ring, item, strategy, PARCTimeout_Never);
+ *
+ *     // consumer
+ *     void *item;
+ *     if (parcRingBuffer1x1_GetWait(ring, &item, strategy, parcTimeout_MilliSeconds(100))) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ *
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef PARCLibrary_parc_WaitStrategy
+#define PARCLibrary_parc_WaitStrategy
+#include <stdbool.h>
+
+#include <parc/concurrent/parc_Timeout.h>
+
+struct PARCWaitStrategy;
+typedef struct PARCWaitStrategy PARCWaitStrategy;
+
+/**
+ * @typedef PARCWaitStrategyKind
+ * @brief What a waiting thread does between attempts.
+ */
+typedef enum {
+    PARCWaitStrategyKind_BusySpin,
+    PARCWaitStrategyKind_SpinThenYield,
+    PARCWaitStrategyKind_Park
+} PARCWaitStrategyKind;
+
+/**
+ * @typedef PARCWaitStrategyCondition
+ * @brief The change a thread is waiting for.
+ *
+ * Threads waiting for one condition are not woken by signals for the other,
+ * so a producer waiting for room is not disturbed by other producers adding items.
+ */
+typedef enum {
+    PARCWaitStrategyCondition_NotEmpty,
+    PARCWaitStrategyCondition_NotFull
+} PARCWaitStrategyCondition;
+
+/**
+ * A non-blocking attempt at an operation.
+ *
+ * @param [in] context The context given to {@link parcWaitStrategy_Await}.
+ *
+ * @return true The operation succeeded.
+ * @return false The operation would have blocked.
+ */
+typedef bool (PARCWaitStrategyAttempt)(void *context);
+
+/**
+ * Create a `PARCWaitStrategy` of the given kind.
+ *
+ * @param [in] kind What a waiting thread does between attempts.
+ *
+ * @return non-NULL A pointer to a valid `PARCWaitStrategy` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+ *
+ *     parcWaitStrategy_Release(&strategy);
+ * }
+ * @endcode
+ */
+PARCWaitStrategy *parcWaitStrategy_Create(PARCWaitStrategyKind kind);
+
+/**
+ * Increase the number of references to a `PARCWaitStrategy` instance.
+ *
+ * @param [in] strategy A pointer to a valid `PARCWaitStrategy` instance.
+ *
+ * @return The same value as @p strategy.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+ *     PARCWaitStrategy *reference = parcWaitStrategy_Acquire(strategy);
+ *
+ *     parcWaitStrategy_Release(&strategy);
+ *     parcWaitStrategy_Release(&reference);
+ * }
+ * @endcode
+ */
+PARCWaitStrategy *parcWaitStrategy_Acquire(const PARCWaitStrategy *strategy);
+
+/**
+ * Release a previously acquired reference to the given `PARCWaitStrategy` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * @param [in,out] strategyPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_BusySpin);
+ *
+ *     parcWaitStrategy_Release(&strategy);
+ * }
+ * @endcode
+ */
+void parcWaitStrategy_Release(PARCWaitStrategy **strategyPtr);
+
+/**
+ * Get the kind of the given `PARCWaitStrategy`.
+ *
+ * @param [in] strategy A pointer to a valid `PARCWaitStrategy` instance.
+ *
+ * @return The `PARCWaitStrategyKind` given when the instance was created.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+ *     PARCWaitStrategyKind kind = parcWaitStrategy_GetKind(strategy);
+ *
+ *     parcWaitStrategy_Release(&strategy);
+ * }
+ * @endcode
+ */
+PARCWaitStrategyKind parcWaitStrategy_GetKind(const PARCWaitStrategy *strategy);
+
+/**
+ * Repeat an attempt until it succeeds or the timeout expires.
+ *
+ * @p attempt is called at once, and again each time the strategy decides to retry.
+ * A parked thread is woken by {@link parcWaitStrategy_Signal} for the same @p condition.
+ *
+ * @param [in] strategy A pointer to a valid `PARCWaitStrategy` instance.
+ * @param [in] condition The condition that would let @p attempt succeed.
+ * @param [in] attempt The non-blocking operation to attempt.
+ * @param [in] context Passed to @p attempt.
+ * @param [in] timeout The longest time to wait.  `PARCTimeout_Never` waits until @p attempt succeeds,
+ *                     and `PARCTimeout_Immediate` makes a single attempt.
+ *
+ * @return true @p attempt succeeded.
+ * @return false The timeout expired first.
+ *
+ * Example:
+ * @code
+ * {
+ *     bool success = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _tryGet, &context, PARCTimeout_Never);
+ * }
+ * @endcode
+ */
+bool parcWaitStrategy_Await(PARCWaitStrategy *strategy, PARCWaitStrategyCondition condition,
+                            PARCWaitStrategyAttempt *attempt, void *context, const PARCTimeout *timeout);
+
+/**
+ * Wake the threads parked waiting for the given condition.
+ *
+ * Call this after changing the data structure in a way that may let a waiting attempt succeed.
+ * If no thread is parked this costs a memory fence and a load, and makes no system call.
+ * For the spinning kinds it does nothing.
+ *
+ * @param [in] strategy A pointer to a valid `PARCWaitStrategy` instance.
+ * @param [in] condition The condition that may now hold.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcRingBuffer1x1_Put(ring, item)) {
+ *         parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotEmpty);
+ *     }
+ * }
+ * @endcode
+ */
+void parcWaitStrategy_Signal(PARCWaitStrategy *strategy, PARCWaitStrategyCondition condition);
+#endif
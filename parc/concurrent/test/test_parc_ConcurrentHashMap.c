@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_ConcurrentHashMap.c"
+
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
+#include <parc/concurrent/parc_AtomicUint32.h>
+
+#include <parc/testing/parc_ObjectTesting.h>
+#include <parc/testing/parc_MemoryTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_ConcurrentHashMap)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
+    LONGBOW_RUN_TEST_FIXTURE(ObjectContract);
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Threads);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_ConcurrentHashMap)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_ConcurrentHashMap)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static PARCBuffer *
+_uint32Key(uint32_t value)
+{
+    return parcBuffer_Flip(parcBuffer_PutUint32(parcBuffer_Allocate(sizeof(uint32_t)), value));
+}
+
+LONGBOW_TEST_FIXTURE(CreateAcquireRelease)
+{
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateRelease);
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateCapacity);
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateCapacity_ConcurrencyLevel);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(CreateAcquireRelease)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(CreateAcquireRelease)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateRelease)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    assertNotNull(instance, "Expected non-null result from parcConcurrentHashMap_Create();");
+    parcObjectTesting_AssertAcquireReleaseContract(parcConcurrentHashMap_Acquire, instance);
+
+    parcConcurrentHashMap_Release(&instance);
+    assertNull(instance, "Expected null result from parcConcurrentHashMap_Release();");
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateCapacity)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_CreateCapacity(0, 0);
+    assertNotNull(instance, "Expected non-null result from parcConcurrentHashMap_CreateCapacity();");
+    assertTrue(instance->segmentCount == _PARCConcurrentHashMap_DefaultConcurrency,
+               "Expected the default concurrency level %d, actual %zu", _PARCConcurrentHashMap_DefaultConcurrency, instance->segmentCount);
+
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateCapacity_ConcurrencyLevel)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_CreateCapacity(1000, 5);
+    assertTrue(instance->segmentCount == 8, "Expected the concurrency level to be rounded up to 8, actual %zu", instance->segmentCount);
+
+    for (size_t i = 0; i < instance->segmentCount; i++) {
+        _PARCConcurrentHashMapSegment *segment = &instance->segments[i];
+        assertTrue(_parcConcurrentHashMapSegment_Threshold(segment) * instance->segmentCount >= 1000,
+                   "Expected segment %zu to be sized for its share of the capacity", i);
+        assertTrue(((uintptr_t) segment % LEVEL1_DCACHE_LINESIZE) == 0, "Expected segment %zu to be cache line aligned", i);
+    }
+
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_FIXTURE(ObjectContract)
+{
+    LONGBOW_RUN_TEST_CASE(ObjectContract, parcConcurrentHashMap_Copy);
+    LONGBOW_RUN_TEST_CASE(ObjectContract, parcConcurrentHashMap_Display);
+    LONGBOW_RUN_TEST_CASE(ObjectContract, parcConcurrentHashMap_IsValid);
+    LONGBOW_RUN_TEST_CASE(ObjectContract, parcConcurrentHashMap_ToString);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(ObjectContract)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(ObjectContract)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(ObjectContract, parcConcurrentHashMap_Copy)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    for (uint32_t i = 0; i < 100; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        parcConcurrentHashMap_Put(instance, key, key);
+        parcBuffer_Release(&key);
+    }
+
+    PARCConcurrentHashMap *copy = parcConcurrentHashMap_Copy(instance);
+    assertTrue(parcConcurrentHashMap_Size(copy) == 100, "Expected 100 entries in the copy, actual %zu", parcConcurrentHashMap_Size(copy));
+
+    for (uint32_t i = 0; i < 100; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        PARCBuffer *value = parcConcurrentHashMap_Get(copy, key);
+        assertTrue(parcBuffer_Equals(key, value), "Expected the copy to contain key %u", i);
+        parcBuffer_Release(&value);
+        parcBuffer_Release(&key);
+    }
+
+    parcConcurrentHashMap_Release(&instance);
+    parcConcurrentHashMap_Release(&copy);
+}
+
+LONGBOW_TEST_CASE(ObjectContract, parcConcurrentHashMap_Display)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_CreateCapacity(10, 2);
+    parcConcurrentHashMap_Display(instance, 0);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(ObjectContract, parcConcurrentHashMap_IsValid)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    assertTrue(parcConcurrentHashMap_IsValid(instance), "Expected parcConcurrentHashMap_Create to result in a valid instance.");
+
+    parcConcurrentHashMap_Release(&instance);
+    assertFalse(parcConcurrentHashMap_IsValid(instance), "Expected parcConcurrentHashMap_Release to result in an invalid instance.");
+}
+
+LONGBOW_TEST_CASE(ObjectContract, parcConcurrentHashMap_ToString)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+
+    char *string = parcConcurrentHashMap_ToString(instance);
+    assertNotNull(string, "Expected non-NULL result from parcConcurrentHashMap_ToString");
+
+    parcMemory_Deallocate(&string);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_PutGet);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_Put_Replace);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_Get_Missing);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_Contains);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_Remove);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_Grow);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_ComputeIfAbsent);
+    LONGBOW_RUN_TEST_CASE(Global, parcConcurrentHashMap_ComputeIfAbsent_NULL);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_PutGet)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+    PARCBuffer *value = parcBuffer_WrapCString("value");
+
+    parcConcurrentHashMap_Put(instance, key, value);
+
+    PARCBuffer *actual = parcConcurrentHashMap_Get(instance, key);
+    assertTrue(actual == value, "Expected the value that was put.");
+    parcBuffer_Release(&actual);
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_Put_Replace)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+    PARCBuffer *value1 = parcBuffer_WrapCString("value1");
+    PARCBuffer *value2 = parcBuffer_WrapCString("value2");
+
+    parcConcurrentHashMap_Put(instance, key, value1);
+    parcConcurrentHashMap_Put(instance, key, value2);
+
+    PARCBuffer *actual = parcConcurrentHashMap_Get(instance, key);
+    assertTrue(actual == value2, "Expected the replacement value.");
+    assertTrue(parcConcurrentHashMap_Size(instance) == 1, "Expected 1 entry, actual %zu", parcConcurrentHashMap_Size(instance));
+    parcBuffer_Release(&actual);
+
+    parcBuffer_Release(&key);
+    parcBuffer_Release(&value1);
+    parcBuffer_Release(&value2);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_Get_Missing)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+
+    PARCObject *actual = parcConcurrentHashMap_Get(instance, key);
+    assertNull(actual, "Expected NULL for a missing key.");
+
+    parcBuffer_Release(&key);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_Contains)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+
+    assertFalse(parcConcurrentHashMap_Contains(instance, key), "Expected an empty map not to contain the key.");
+    parcConcurrentHashMap_Put(instance, key, key);
+    assertTrue(parcConcurrentHashMap_Contains(instance, key), "Expected the map to contain the key.");
+
+    parcBuffer_Release(&key);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_Remove)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_CreateCapacity(0, 1);
+
+    for (uint32_t i = 0; i < 200; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        parcConcurrentHashMap_Put(instance, key, key);
+        parcBuffer_Release(&key);
+    }
+
+    for (uint32_t i = 0; i < 200; i += 2) {
+        PARCBuffer *key = _uint32Key(i);
+        assertTrue(parcConcurrentHashMap_Remove(instance, key), "Expected to remove key %u", i);
+        assertFalse(parcConcurrentHashMap_Remove(instance, key), "Expected key %u to be gone", i);
+        parcBuffer_Release(&key);
+    }
+
+    assertTrue(parcConcurrentHashMap_Size(instance) == 100, "Expected 100 entries, actual %zu", parcConcurrentHashMap_Size(instance));
+    for (uint32_t i = 0; i < 200; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        assertTrue(parcConcurrentHashMap_Contains(instance, key) == (i % 2 == 1), "Wrong membership for key %u", i);
+        parcBuffer_Release(&key);
+    }
+
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_Grow)
+{
+    const uint32_t count = 3000;
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_CreateCapacity(0, 4);
+
+    for (uint32_t i = 0; i < count; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        parcConcurrentHashMap_Put(instance, key, key);
+        parcBuffer_Release(&key);
+    }
+
+    assertTrue(parcConcurrentHashMap_Size(instance) == count, "Expected %u entries, actual %zu", count, parcConcurrentHashMap_Size(instance));
+    for (size_t i = 0; i < instance->segmentCount; i++) {
+        _PARCConcurrentHashMapSegment *segment = &instance->segments[i];
+        assertTrue(segment->count <= _parcConcurrentHashMapSegment_Threshold(segment),
+                   "Expected segment %zu to stay within its load limit", i);
+        assertTrue(segment->count > 0, "Expected every segment to receive keys");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        assertTrue(parcConcurrentHashMap_Contains(instance, key), "Expected to find key %u", i);
+        parcBuffer_Release(&key);
+    }
+
+    parcConcurrentHashMap_Release(&instance);
+}
+
+static PARCObject *
+_createValue(const PARCObject *key, void *parameter)
+{
+    PARCAtomicUint32 *calls = parameter;
+    parcAtomicUint32_Increment(calls);
+    return parcBuffer_Copy((const PARCBuffer *) key);
+}
+
+static PARCObject *
+_createNothing(const PARCObject *key __attribute__((unused)), void *parameter __attribute__((unused)))
+{
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_ComputeIfAbsent)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCAtomicUint32 *calls = parcAtomicUint32_Create(0);
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+
+    PARCBuffer *first = parcConcurrentHashMap_ComputeIfAbsent(instance, key, _createValue, calls);
+    PARCBuffer *second = parcConcurrentHashMap_ComputeIfAbsent(instance, key, _createValue, calls);
+
+    assertTrue(first == second, "Expected the second call to return the value created by the first.");
+    assertTrue(parcAtomicUint32_GetValue(calls) == 1, "Expected the mapping function to be called once, actual %u",
+               parcAtomicUint32_GetValue(calls));
+
+    parcBuffer_Release(&first);
+    parcBuffer_Release(&second);
+    parcBuffer_Release(&key);
+    parcAtomicUint32_Release(&calls);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_CASE(Global, parcConcurrentHashMap_ComputeIfAbsent_NULL)
+{
+    PARCConcurrentHashMap *instance = parcConcurrentHashMap_Create();
+    PARCBuffer *key = parcBuffer_WrapCString("key");
+
+    PARCObject *actual = parcConcurrentHashMap_ComputeIfAbsent(instance, key, _createNothing, NULL);
+    assertNull(actual, "Expected NULL when the mapping function produces nothing.");
+    assertFalse(parcConcurrentHashMap_Contains(instance, key), "Expected the map to remain empty.");
+
+    parcBuffer_Release(&key);
+    parcConcurrentHashMap_Release(&instance);
+}
+
+LONGBOW_TEST_FIXTURE(Threads)
+{
+    LONGBOW_RUN_TEST_CASE(Threads, DisjointPutGetRemove);
+    LONGBOW_RUN_TEST_CASE(Threads, ComputeIfAbsent_Once);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Threads)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Threads)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define THREAD_COUNT 4
+#define KEYS_PER_THREAD 500
+
+typedef struct {
+    PARCConcurrentHashMap *map;
+    PARCAtomicUint32 *calls;
+    uint32_t first;
+    uint32_t count;
+    bool passed;
+} _ThreadState;
+
+static void *
+_putGetRemove(void *parameter)
+{
+    _ThreadState *state = parameter;
+    state->passed = true;
+
+    for (uint32_t i = state->first; i < state->first + state->count; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        parcConcurrentHashMap_Put(state->map, key, key);
+        parcBuffer_Release(&key);
+    }
+    for (uint32_t i = state->first; i < state->first + state->count; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        PARCBuffer *value = parcConcurrentHashMap_Get(state->map, key);
+        if (value == NULL || !parcBuffer_Equals(key, value)) {
+            state->passed = false;
+        }
+        if (value != NULL) {
+            parcBuffer_Release(&value);
+        }
+        // Leave the odd keys behind for the main thread to check.
+        if (i % 2 == 0 && !parcConcurrentHashMap_Remove(state->map, key)) {
+            state->passed = false;
+        }
+        parcBuffer_Release(&key);
+    }
+
+    return NULL;
+}
+
+static void *
+_computeIfAbsent(void *parameter)
+{
+    _ThreadState *state = parameter;
+    state->passed = true;
+
+    for (uint32_t i = 0; i < state->count; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        PARCBuffer *value = parcConcurrentHashMap_ComputeIfAbsent(state->map, key, _createValue, state->calls);
+        if (value == NULL || !parcBuffer_Equals(key, value)) {
+            state->passed = false;
+        }
+        if (value != NULL) {
+            parcBuffer_Release(&value);
+        }
+        parcBuffer_Release(&key);
+    }
+
+    return NULL;
+}
+
+static void
+_runThreads(void *(*function)(void *), _ThreadState *states)
+{
+    pthread_t threads[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_create(&threads[i], NULL, function, &states[i]);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        assertTrue(states[i].passed, "Thread %d observed an inconsistent map", i);
+    }
+}
+
+LONGBOW_TEST_CASE(Threads, DisjointPutGetRemove)
+{
+    PARCConcurrentHashMap *map = parcConcurrentHashMap_CreateCapacity(0, 2);
+
+    _ThreadState states[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        states[i] = (_ThreadState) { .map = map, .first = i * KEYS_PER_THREAD, .count = KEYS_PER_THREAD };
+    }
+    _runThreads(_putGetRemove, states);
+
+    assertTrue(parcConcurrentHashMap_Size(map) == THREAD_COUNT * KEYS_PER_THREAD / 2,
+               "Expected %d entries, actual %zu", THREAD_COUNT * KEYS_PER_THREAD / 2, parcConcurrentHashMap_Size(map));
+    for (uint32_t i = 0; i < THREAD_COUNT * KEYS_PER_THREAD; i++) {
+        PARCBuffer *key = _uint32Key(i);
+        assertTrue(parcConcurrentHashMap_Contains(map, key) == (i % 2 == 1), "Wrong membership for key %u", i);
+        parcBuffer_Release(&key);
+    }
+
+    parcConcurrentHashMap_Release(&map);
+}
+
+LONGBOW_TEST_CASE(Threads, ComputeIfAbsent_Once)
+{
+    PARCConcurrentHashMap *map = parcConcurrentHashMap_CreateCapacity(0, 2);
+    PARCAtomicUint32 *calls = parcAtomicUint32_Create(0);
+
+    _ThreadState states[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        states[i] = (_ThreadState) { .map = map, .calls = calls, .count = KEYS_PER_THREAD };
+    }
+    _runThreads(_computeIfAbsent, states);
+
+    assertTrue(parcAtomicUint32_GetValue(calls) == KEYS_PER_THREAD,
+               "Expected exactly one value to be created per key, actual %u", parcAtomicUint32_GetValue(calls));
+
+    parcAtomicUint32_Release(&calls);
+    parcConcurrentHashMap_Release(&map);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, ReadScaling_ConcurrentHashMap);
+    LONGBOW_RUN_TEST_CASE(Performance, ReadScaling_LockedHashMap);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define PERFORMANCE_KEY_COUNT (1 << 16)
+#define PERFORMANCE_READS_PER_THREAD 200000
+#define PERFORMANCE_MAX_THREADS 32
+
+typedef struct {
+    void *map;
+    PARCBuffer **keys;
+    uint32_t seed;
+} _ReaderState;
+
+static void *
+_concurrentReader(void *parameter)
+{
+    _ReaderState *state = parameter;
+    uint32_t x = state->seed;
+
+    for (int i = 0; i < PERFORMANCE_READS_PER_THREAD; i++) {
+        x = x * 1664525u + 1013904223u;
+        PARCObject *value = parcConcurrentHashMap_Get(state->map, state->keys[x % PERFORMANCE_KEY_COUNT]);
+        parcObject_Release(&value);
+    }
+
+    return NULL;
+}
+
+static void *
+_lockedReader(void *parameter)
+{
+    _ReaderState *state = parameter;
+    uint32_t x = state->seed;
+
+    for (int i = 0; i < PERFORMANCE_READS_PER_THREAD; i++) {
+        x = x * 1664525u + 1013904223u;
+        parcHashMap_Lock(state->map);
+        parcHashMap_Get(state->map, state->keys[x % PERFORMANCE_KEY_COUNT]);
+        parcHashMap_Unlock(state->map);
+    }
+
+    return NULL;
+}
+
+/*
+ * Run the reader with 1, 2, 4, ... PERFORMANCE_MAX_THREADS threads and report the aggregate read throughput
+ * and the speed-up over a single thread.
+ * Scaling is bounded by the number of available processors.
+ */
+static void
+_readScaling(const char *name, void *map, PARCBuffer **keys, void *(*reader)(void *))
+{
+    double baseline = 0.0;
+
+    for (int threadCount = 1; threadCount <= PERFORMANCE_MAX_THREADS; threadCount *= 2) {
+        pthread_t threads[PERFORMANCE_MAX_THREADS];
+        _ReaderState states[PERFORMANCE_MAX_THREADS];
+
+        struct timeval t0, t1, elapsed;
+        gettimeofday(&t0, NULL);
+        for (int i = 0; i < threadCount; i++) {
+            states[i] = (_ReaderState) { .map = map, .keys = keys, .seed = (uint32_t) i + 1 };
+            pthread_create(&threads[i], NULL, reader, &states[i]);
+        }
+        for (int i = 0; i < threadCount; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        gettimeofday(&t1, NULL);
+
+        timersub(&t1, &t0, &elapsed);
+        double sec = elapsed.tv_sec + elapsed.tv_usec * 1E-6;
+        double opsPerSecond = (double) threadCount * PERFORMANCE_READS_PER_THREAD / sec;
+        if (threadCount == 1) {
+            baseline = opsPerSecond;
+        }
+        printf("%s: threads = %2d, sec = %.3f, reads/sec = %.0f, speed-up = %.2f\n",
+               name, threadCount, sec, opsPerSecond, opsPerSecond / baseline);
+    }
+}
+
+static PARCBuffer **
+_performanceKeys(void)
+{
+    PARCBuffer **keys = parcMemory_Allocate(PERFORMANCE_KEY_COUNT * sizeof(PARCBuffer *));
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        keys[i] = _uint32Key(i * 2654435761u);
+    }
+    return keys;
+}
+
+static void
+_performanceKeysRelease(PARCBuffer ***keysPtr)
+{
+    PARCBuffer **keys = *keysPtr;
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcBuffer_Release(&keys[i]);
+    }
+    parcMemory_Deallocate(keysPtr);
+}
+
+LONGBOW_TEST_CASE(Performance, ReadScaling_ConcurrentHashMap)
+{
+    PARCBuffer **keys = _performanceKeys();
+    PARCConcurrentHashMap *map = parcConcurrentHashMap_CreateCapacity(PERFORMANCE_KEY_COUNT, PERFORMANCE_MAX_THREADS * 4);
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcConcurrentHashMap_Put(map, keys[i], keys[i]);
+    }
+
+    _readScaling("PARCConcurrentHashMap", map, keys, _concurrentReader);
+
+    parcConcurrentHashMap_Release(&map);
+    _performanceKeysRelease(&keys);
+}
+
+LONGBOW_TEST_CASE(Performance, ReadScaling_LockedHashMap)
+{
+    PARCBuffer **keys = _performanceKeys();
+    PARCHashMap *map = parcHashMap_CreateCapacity(PERFORMANCE_KEY_COUNT);
+    for (uint32_t i = 0; i < PERFORMANCE_KEY_COUNT; i++) {
+        parcHashMap_Put(map, keys[i], keys[i]);
+    }
+
+    _readScaling("locked PARCHashMap", map, keys, _lockedReader);
+
+    parcHashMap_Release(&map);
+    _performanceKeysRelease(&keys);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_ConcurrentHashMap);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_CpuTopology.c"
+
+#include <stdlib.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/testing/parc_MemoryTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_CpuTopology)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_CpuTopology)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_CpuTopology)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_ParseCpuList);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_ParseCpuList_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_ParseCpuList_Malformed);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetOnlineCpus);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetNodeCount);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetNodeCpus);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetNodeCpus_NoSuchNode);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetNodeOfCpu);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetPackageOfCpu);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_GetCurrentCpu);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_AdviseNode_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, parcCpuTopology_AllocateOnNode);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_ParseCpuList)
+{
+    PARCBitVector *cpus = parcCpuTopology_ParseCpuList("0-3,8,10-11\n");
+    assertNotNull(cpus, "Expected a well formed list to parse.");
+
+    PARCBitVector *expected = parcBitVector_Create();
+    unsigned bits[] = { 0, 1, 2, 3, 8, 10, 11 };
+    for (size_t i = 0; i < sizeof(bits) / sizeof(bits[0]); i++) {
+        parcBitVector_Set(expected, bits[i]);
+    }
+    assertTrue(parcBitVector_Equals(cpus, expected), "Expected %s, actual %s",
+               parcBitVector_ToString(expected), parcBitVector_ToString(cpus));
+
+    parcBitVector_Release(&expected);
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_ParseCpuList_Empty)
+{
+    // An empty list, as in /sys/devices/system/cpu/offline when every CPU is online.
+    PARCBitVector *cpus = parcCpuTopology_ParseCpuList("\n");
+    assertNotNull(cpus, "Expected an empty list to parse.");
+    assertTrue(parcBitVector_NumberOfBitsSet(cpus) == 0, "Expected no CPUs, actual %u", parcBitVector_NumberOfBitsSet(cpus));
+
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_ParseCpuList_Malformed)
+{
+    const char *lists[] = { "a", "-1", "3-1", "1,", "1-", "1 2", "0-8192", "1,,2", NULL };
+
+    for (int i = 0; lists[i] != NULL; i++) {
+        PARCBitVector *cpus = parcCpuTopology_ParseCpuList(lists[i]);
+        assertNull(cpus, "Expected \"%s\" to be rejected.", lists[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetOnlineCpus)
+{
+    PARCBitVector *cpus = parcCpuTopology_GetOnlineCpus();
+
+    long expected = sysconf(_SC_NPROCESSORS_ONLN);
+    assertTrue(parcBitVector_NumberOfBitsSet(cpus) == expected,
+               "Expected %ld online CPUs, actual %u", expected, parcBitVector_NumberOfBitsSet(cpus));
+
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetNodeCount)
+{
+    unsigned count = parcCpuTopology_GetNodeCount();
+    assertTrue(count >= 1, "Expected at least one node, actual %u", count);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetNodeCpus)
+{
+    // Every online CPU belongs to exactly one node, and each node's CPUs say they belong to it.
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    PARCBitVector *all = parcBitVector_Create();
+
+    unsigned total = 0;
+    for (unsigned node = 0; node < parcCpuTopology_GetNodeCount(); node++) {
+        PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(node);
+        for (int cpu = parcBitVector_NextBitSet(cpus, 0); cpu >= 0; cpu = parcBitVector_NextBitSet(cpus, cpu + 1)) {
+            assertTrue(parcCpuTopology_GetNodeOfCpu(cpu) == (int) node,
+                       "Expected CPU %d to be on node %u, actual %d", cpu, node, parcCpuTopology_GetNodeOfCpu(cpu));
+        }
+        total += parcBitVector_NumberOfBitsSet(cpus);
+        parcBitVector_SetVector(all, cpus);
+        parcBitVector_Release(&cpus);
+    }
+
+    assertTrue(parcBitVector_Equals(all, online), "Expected the nodes to hold every online CPU, actual %s", parcBitVector_ToString(all));
+    assertTrue(total == parcBitVector_NumberOfBitsSet(online), "Expected no CPU to be on two nodes.");
+
+    parcBitVector_Release(&all);
+    parcBitVector_Release(&online);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetNodeCpus_NoSuchNode)
+{
+    PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(4000);
+    assertTrue(parcBitVector_NumberOfBitsSet(cpus) == 0, "Expected no CPUs on a node that does not exist.");
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetNodeOfCpu)
+{
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    int cpu = parcBitVector_NextBitSet(online, 0);
+    parcBitVector_Release(&online);
+
+    assertTrue(parcCpuTopology_GetNodeOfCpu(cpu) >= 0, "Expected an online CPU to have a node.");
+    assertTrue(parcCpuTopology_GetNodeOfCpu(-1) == -1, "Expected -1 for a CPU that does not exist.");
+    assertTrue(parcCpuTopology_GetNodeOfCpu(_PARCCpuTopology_MaximumCpu) == -1, "Expected -1 for a CPU that is not online.");
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetPackageOfCpu)
+{
+    int cpu = parcCpuTopology_GetCurrentCpu();
+#if __linux__
+    assertTrue(parcCpuTopology_GetPackageOfCpu(cpu) >= 0, "Expected CPU %d to be in a package.", cpu);
+    assertTrue(parcCpuTopology_GetCoreOfCpu(cpu) >= 0, "Expected CPU %d to have a core.", cpu);
+#endif
+    assertTrue(parcCpuTopology_GetPackageOfCpu(-1) == -1, "Expected -1 for a CPU that does not exist.");
+    assertTrue(parcCpuTopology_GetCoreOfCpu(-1) == -1, "Expected -1 for a CPU that does not exist.");
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_GetCurrentCpu)
+{
+    int cpu = parcCpuTopology_GetCurrentCpu();
+#if __linux__
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    assertTrue(cpu >= 0 && parcBitVector_Get(online, cpu) == 1, "Expected to be running on an online CPU, actual %d", cpu);
+    parcBitVector_Release(&online);
+#else
+    assertTrue(cpu == -1, "Expected -1 where the current CPU cannot be known, actual %d", cpu);
+#endif
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_AdviseNode_Invalid)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    char *memory = parcMemory_Allocate(2 * pageSize);
+
+    assertFalse(parcCpuTopology_AdviseNode(memory, 2 * pageSize, -1), "Expected a negative node to be refused.");
+    assertFalse(parcCpuTopology_AdviseNode(memory, 2 * pageSize, _PARCCpuTopology_MaximumNodes), "Expected a node beyond the mask to be refused.");
+    // Less than a page holds no whole page, wherever it starts.
+    assertFalse(parcCpuTopology_AdviseNode(memory + 1, pageSize - 2, 0), "Expected memory without a whole page to be refused.");
+
+    parcMemory_Deallocate(&memory);
+}
+
+LONGBOW_TEST_CASE(Global, parcCpuTopology_AllocateOnNode)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    int node = parcCpuTopology_GetNodeOfCpu(parcCpuTopology_GetCurrentCpu());
+
+    char *memory = parcCpuTopology_AllocateOnNode(3 * pageSize + 1, node < 0 ? 0 : node);
+    assertNotNull(memory, "Expected memory to be allocated.");
+    assertTrue(((uintptr_t) memory % pageSize) == 0, "Expected page aligned memory, actual %p", (void *) memory);
+
+    memset(memory, 0x5A, 3 * pageSize + 1);
+    assertTrue(memory[3 * pageSize] == 0x5A, "Expected the whole allocation to be usable.");
+
+    parcMemory_Deallocate(&memory);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_CpuTopology);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
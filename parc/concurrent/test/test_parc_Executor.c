@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_Executor.c"
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/concurrent/parc_ThreadPool.h>
+
+#include <parc/testing/parc_MemoryTesting.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_Executor)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
+    LONGBOW_RUN_TEST_FIXTURE(Specialization);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_Executor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_Executor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(CreateAcquireRelease)
+{
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateRelease);
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateForEventScheduler);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(CreateAcquireRelease)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(CreateAcquireRelease)
+{
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// An executor that runs each task at once, on the calling thread, and counts them.
+static bool
+_inline_Execute(int *count, PARCFutureTask *task)
+{
+    (*count)++;
+    parcFutureTask_Run(task);
+    return true;
+}
+
+static void
+_inline_Release(int **countPtr)
+{
+    parcMemory_Deallocate(countPtr);
+}
+
+static const PARCExecutorInterface _inlineAsExecutor = {
+    .Execute = (bool (*)(void *, PARCFutureTask *))_inline_Execute,
+    .Release = (void (*)(void **))_inline_Release
+};
+
+static void *
+_function(PARCFutureTask *task, void *parameter)
+{
+    return parameter;
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateRelease)
+{
+    int *count = parcMemory_AllocateAndClear(sizeof(int));
+    PARCExecutor *executor = parcExecutor_Create(count, &_inlineAsExecutor);
+    assertNotNull(executor, "Expected non-null result from parcExecutor_Create");
+
+    parcObjectTesting_AssertAcquireReleaseContract(parcExecutor_Acquire, executor);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    assertTrue(parcExecutor_Execute(executor, task), "Expected the task to be accepted.");
+    assertTrue(parcFutureTask_IsDone(task), "Expected the task to have run.");
+    assertTrue(*count == 1, "Expected the interface to be called once, actual %d", *count);
+
+    parcFutureTask_Release(&task);
+    parcExecutor_Release(&executor);
+    assertNull(executor, "Expected null result from parcExecutor_Release();");
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateForEventScheduler)
+{
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+    assertNotNull(executor, "Expected non-null result from parcExecutor_CreateForEventScheduler");
+
+    parcObjectTesting_AssertAcquireReleaseContract(parcExecutor_Acquire, executor);
+
+    parcExecutor_Release(&executor);
+    parcEventScheduler_Destroy(&scheduler);
+}
+
+LONGBOW_TEST_FIXTURE(Specialization)
+{
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_ThreadPool);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_ThreadPool_Shutdown);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_EventScheduler);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_EventScheduler_Threads);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_EventScheduler_Release);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcExecutor_EventScheduler_Then);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Specialization)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Specialization)
+{
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_ThreadPool)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(2);
+    PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    assertTrue(parcExecutor_Execute(executor, task), "Expected the pool to accept the task.");
+
+    PARCFutureTaskResult result = parcFutureTask_Get(task, PARCTimeout_Never);
+    assertTrue(result.value == _function, "Expected the task to have run on the pool.");
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    parcFutureTask_Release(&task);
+    parcExecutor_Release(&executor);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_ThreadPool_Shutdown)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(1);
+    PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    assertFalse(parcExecutor_Execute(executor, task), "Expected a shut down pool to reject the task.");
+
+    parcFutureTask_Release(&task);
+    parcExecutor_Release(&executor);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_EventScheduler)
+{
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    assertTrue(parcExecutor_Execute(executor, task), "Expected the task to be accepted.");
+    assertFalse(parcFutureTask_IsDone(task), "The task should wait for the scheduler to dispatch.");
+
+    parcEventScheduler_Start(scheduler, PARCEventSchedulerDispatchType_NonBlocking);
+    assertTrue(parcFutureTask_IsDone(task), "Expected the scheduler to run the task.");
+
+    parcFutureTask_Release(&task);
+    parcExecutor_Release(&executor);
+    parcEventScheduler_Destroy(&scheduler);
+}
+
+typedef struct {
+    PARCExecutor *executor;
+    PARCFutureTask **tasks;
+    int count;
+} _Producer;
+
+static void *
+_produce(void *parameter)
+{
+    _Producer *producer = parameter;
+    for (int i = 0; i < producer->count; i++) {
+        parcExecutor_Execute(producer->executor, producer->tasks[i]);
+    }
+    return NULL;
+}
+
+static int _completed;
+
+static void *
+_count(PARCFutureTask *task, void *parameter)
+{
+    _completed++;
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_EventScheduler_Threads)
+{
+    const int count = 200;
+
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+
+    _completed = 0;
+    PARCFutureTask *tasks[count];
+    for (int i = 0; i < count; i++) {
+        tasks[i] = parcFutureTask_Create(_count, NULL);
+    }
+
+    _Producer producer = { .executor = executor, .tasks = tasks, .count = count };
+    pthread_t thread;
+    pthread_create(&thread, NULL, _produce, &producer);
+
+    // Only this thread runs the tasks, so `_completed` needs no synchronisation.
+    while (_completed < count) {
+        parcEventScheduler_Start(scheduler, PARCEventSchedulerDispatchType_LoopOnce);
+    }
+    pthread_join(thread, NULL);
+
+    for (int i = 0; i < count; i++) {
+        assertTrue(parcFutureTask_IsDone(tasks[i]), "Expected task %d to have run.", i);
+        parcFutureTask_Release(&tasks[i]);
+    }
+    parcExecutor_Release(&executor);
+    parcEventScheduler_Destroy(&scheduler);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_EventScheduler_Release)
+{
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    parcExecutor_Execute(executor, task);
+    parcExecutor_Release(&executor);
+
+    assertTrue(parcFutureTask_IsCancelled(task), "Expected a task still queued at release to be cancelled.");
+
+    parcFutureTask_Release(&task);
+    parcEventScheduler_Destroy(&scheduler);
+}
+
+static void *
+_currentThread(PARCFutureTask *task, void *parameter)
+{
+    return (void *) pthread_self();
+}
+
+LONGBOW_TEST_CASE(Specialization, parcExecutor_EventScheduler_Then)
+{
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCExecutor *executor = parcExecutor_CreateForEventScheduler(scheduler);
+    PARCThreadPool *pool = parcThreadPool_Create(1);
+
+    PARCFutureTask *task = parcFutureTask_Create(_currentThread, NULL);
+    PARCFutureTask *next = parcFutureTask_Then(task, _currentThread, executor);
+    parcThreadPool_Execute(pool, task);
+
+    while (!parcFutureTask_IsDone(next)) {
+        parcEventScheduler_Start(scheduler, PARCEventSchedulerDispatchType_LoopOnce);
+    }
+
+    pthread_t worker = (pthread_t) parcFutureTask_Get(task, PARCTimeout_Immediate).value;
+    pthread_t dispatcher = (pthread_t) parcFutureTask_Get(next, PARCTimeout_Immediate).value;
+    assertFalse(pthread_equal(worker, pthread_self()), "Expected the task to run on the pool.");
+    assertTrue(pthread_equal(dispatcher, pthread_self()), "Expected the continuation to run on the scheduler's thread.");
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+    parcThreadPool_Release(&pool);
+    parcExecutor_Release(&executor);
+    parcEventScheduler_Destroy(&scheduler);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_Executor);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
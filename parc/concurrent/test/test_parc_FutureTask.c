@@ -20,6 +20,9 @@
 #include <parc/testing/parc_MemoryTesting.h>
 #include <parc/testing/parc_ObjectTesting.h>
 
+#include <parc/algol/parc_Time.h>
+#include <parc/concurrent/parc_ThreadPool.h>
+
 LONGBOW_TEST_RUNNER(parc_FutureTask)
 {
     // The following Test Fixtures will run their corresponding Test Cases.
@@ -28,6 +31,8 @@ LONGBOW_TEST_RUNNER(parc_FutureTask)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(Object);
     LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Continuation);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -211,6 +216,8 @@ LONGBOW_TEST_FIXTURE(Specialization)
 {
     LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_Cancel);
     LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_Get);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_Get_AlreadyDone);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_Get_Timeout);
     LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_IsCancelled);
     LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_IsDone);
     LONGBOW_RUN_TEST_CASE(Specialization, parcFutureTask_Run);
@@ -254,6 +261,32 @@ LONGBOW_TEST_CASE(Specialization, parcFutureTask_Get)
     parcFutureTask_Release(&task);
 }
 
+LONGBOW_TEST_CASE(Specialization, parcFutureTask_Get_AlreadyDone)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_function, NULL);
+    parcFutureTask_Run(task);
+
+    PARCFutureTaskResult never = parcFutureTask_Get(task, PARCTimeout_Never);
+    assertTrue(parcExecution_Is(never.execution, PARCExecution_OK), "Expected OK, actual %s",
+               parcExecution_GetMessage(never.execution));
+
+    PARCFutureTaskResult timed = parcFutureTask_Get(task, parcTimeout_MilliSeconds(10));
+    assertTrue(parcExecution_Is(timed.execution, PARCExecution_OK), "Expected OK, actual %s",
+               parcExecution_GetMessage(timed.execution));
+
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcFutureTask_Get_Timeout)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_function, NULL);
+
+    PARCFutureTaskResult result = parcFutureTask_Get(task, parcTimeout_MilliSeconds(10));
+    assertFalse(parcExecution_Is(result.execution, PARCExecution_OK), "Expected the wait to end without a result");
+
+    parcFutureTask_Release(&task);
+}
+
 LONGBOW_TEST_CASE(Specialization, parcFutureTask_IsCancelled)
 {
     PARCFutureTask *task = parcFutureTask_Create(_function, _function);
@@ -301,6 +334,379 @@ LONGBOW_TEST_CASE(Specialization, parcFutureTask_RunAndReset)
     parcFutureTask_Release(&task);
 }
 
+LONGBOW_TEST_FIXTURE(Continuation)
+{
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then_AlreadyDone);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then_Cancelled);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then_Unfinished);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then_ThreadPool);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_Then_Rejected);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_OnCompletion_Order);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_WhenAll);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_WhenAll_Empty);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_WhenAll_ThreadPool);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_WhenAny);
+    LONGBOW_RUN_TEST_CASE(Continuation, parcFutureTask_WhenAny_Unfinished);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Continuation)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Continuation)
+{
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static void *
+_value(PARCFutureTask *task, void *parameter)
+{
+    return (void *) 1;
+}
+
+// A continuation: one more than the result of the task it follows.
+static void *
+_increment(PARCFutureTask *task, void *parameter)
+{
+    PARCFutureTaskResult previous = parcFutureTask_Get(parameter, PARCTimeout_Immediate);
+    assertTrue(parcExecution_Is(previous.execution, PARCExecution_OK), "Expected the previous task to be done.");
+
+    return (void *) ((uintptr_t) previous.value + 1);
+}
+
+static void *
+_isCancelled(PARCFutureTask *task, void *parameter)
+{
+    return (void *) (uintptr_t) parcFutureTask_IsCancelled(parameter);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *next = parcFutureTask_Then(task, _increment, NULL);
+
+    assertFalse(parcFutureTask_IsDone(next), "A continuation should not run before its task.");
+
+    parcFutureTask_Run(task);
+
+    PARCFutureTaskResult result = parcFutureTask_Get(next, PARCTimeout_Immediate);
+    assertTrue(parcExecution_Is(result.execution, PARCExecution_OK), "Expected the continuation to have run.");
+    assertTrue((uintptr_t) result.value == 2, "Expected 2, actual %" PRIuPTR, (uintptr_t) result.value);
+
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then_AlreadyDone)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+    parcFutureTask_Run(task);
+
+    PARCFutureTask *next = parcFutureTask_Then(task, _increment, NULL);
+
+    assertTrue(parcFutureTask_IsDone(next), "A continuation of a completed task should run at once.");
+
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then_Cancelled)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *next = parcFutureTask_Then(task, _isCancelled, NULL);
+
+    parcFutureTask_Cancel(task, false);
+
+    PARCFutureTaskResult result = parcFutureTask_Get(next, PARCTimeout_Immediate);
+    assertTrue(parcExecution_Is(result.execution, PARCExecution_OK), "Cancelling a task should run its continuations.");
+    assertTrue(result.value == (void *) 1, "Expected the continuation to see the task was cancelled.");
+
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then_Unfinished)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *next = parcFutureTask_Then(task, _increment, NULL);
+    PARCFutureTask *last = parcFutureTask_Then(next, _increment, NULL);
+
+    // Releasing a task that never completed discards its continuations.
+    parcFutureTask_Release(&last);
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then_ThreadPool)
+{
+    const int stages = 50;
+
+    PARCThreadPool *pool = parcThreadPool_Create(2);
+    PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+
+    PARCFutureTask *first = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *last = parcFutureTask_Acquire(first);
+    for (int i = 0; i < stages; i++) {
+        PARCFutureTask *next = parcFutureTask_Then(last, _increment, executor);
+        parcFutureTask_Release(&last);
+        last = next;
+    }
+
+    parcThreadPool_Execute(pool, first);
+
+    PARCFutureTaskResult result = parcFutureTask_Get(last, PARCTimeout_Never);
+    assertTrue((uintptr_t) result.value == stages + 1, "Expected %d, actual %" PRIuPTR, stages + 1, (uintptr_t) result.value);
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    parcFutureTask_Release(&last);
+    parcFutureTask_Release(&first);
+    parcExecutor_Release(&executor);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_Then_Rejected)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(1);
+    PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *next = parcFutureTask_Then(task, _increment, executor);
+    PARCFutureTask *last = parcFutureTask_Then(next, _isCancelled, NULL);
+
+    parcFutureTask_Run(task);
+
+    assertTrue(parcFutureTask_IsCancelled(next), "A continuation rejected by its executor should be cancelled.");
+    PARCFutureTaskResult result = parcFutureTask_Get(last, PARCTimeout_Immediate);
+    assertTrue(result.value == (void *) 1, "The continuations of a rejected continuation should still run.");
+
+    parcFutureTask_Release(&last);
+    parcFutureTask_Release(&next);
+    parcFutureTask_Release(&task);
+    parcExecutor_Release(&executor);
+    parcThreadPool_Release(&pool);
+}
+
+static PARCFutureTask *_order[4];
+static int _orderCount;
+
+static void *
+_record(PARCFutureTask *task, void *parameter)
+{
+    _order[_orderCount++] = task;
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_OnCompletion_Order)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_value, NULL);
+
+    PARCFutureTask *continuations[4];
+
+    _orderCount = 0;
+    for (int i = 0; i < 4; i++) {
+        continuations[i] = parcFutureTask_Create(_record, NULL);
+        parcFutureTask_OnCompletion(task, continuations[i], NULL);
+    }
+
+    parcFutureTask_Run(task);
+
+    assertTrue(_orderCount == 4, "Expected 4 continuations to run, actual %d", _orderCount);
+    for (int i = 0; i < 4; i++) {
+        assertTrue(_order[i] == continuations[i], "Expected continuations to run in the order they were added, at %d", i);
+        parcFutureTask_Release(&continuations[i]);
+    }
+
+    parcFutureTask_Release(&task);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_WhenAll)
+{
+    PARCFutureTask *tasks[3];
+    for (int i = 0; i < 3; i++) {
+        tasks[i] = parcFutureTask_Create(_value, NULL);
+    }
+    parcFutureTask_Run(tasks[1]);
+
+    PARCFutureTask *all = parcFutureTask_WhenAll(tasks, 3);
+
+    parcFutureTask_Run(tasks[0]);
+    assertFalse(parcFutureTask_IsDone(all), "Expected WhenAll to wait for every task.");
+    parcFutureTask_Cancel(tasks[2], false);
+    assertTrue(parcFutureTask_IsDone(all), "Expected WhenAll to complete with the last task.");
+
+    parcFutureTask_Release(&all);
+    for (int i = 0; i < 3; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_WhenAll_Empty)
+{
+    PARCFutureTask *all = parcFutureTask_WhenAll(NULL, 0);
+
+    assertTrue(parcFutureTask_IsDone(all), "Expected WhenAll of no tasks to be complete.");
+
+    parcFutureTask_Release(&all);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_WhenAll_ThreadPool)
+{
+    const int count = 20;
+
+    PARCThreadPool *pool = parcThreadPool_Create(3);
+    PARCFutureTask *tasks[count];
+    for (int i = 0; i < count; i++) {
+        tasks[i] = parcFutureTask_Create(_value, NULL);
+    }
+
+    PARCFutureTask *all = parcFutureTask_WhenAll(tasks, count);
+    for (int i = 0; i < count; i++) {
+        parcThreadPool_Execute(pool, tasks[i]);
+    }
+
+    PARCFutureTaskResult result = parcFutureTask_Get(all, PARCTimeout_Never);
+    assertTrue(parcExecution_Is(result.execution, PARCExecution_OK), "Expected WhenAll to complete.");
+    for (int i = 0; i < count; i++) {
+        assertTrue(parcFutureTask_IsDone(tasks[i]), "Expected task %d to be done when WhenAll completes.", i);
+    }
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    parcFutureTask_Release(&all);
+    for (int i = 0; i < count; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_WhenAny)
+{
+    PARCFutureTask *tasks[3];
+    for (int i = 0; i < 3; i++) {
+        tasks[i] = parcFutureTask_Create(_value, NULL);
+    }
+
+    PARCFutureTask *any = parcFutureTask_WhenAny(tasks, 3);
+    assertFalse(parcFutureTask_IsDone(any), "Expected WhenAny to wait for a task.");
+
+    parcFutureTask_Run(tasks[2]);
+    parcFutureTask_Run(tasks[0]);
+
+    PARCFutureTaskResult result = parcFutureTask_Get(any, PARCTimeout_Immediate);
+    assertTrue(parcExecution_Is(result.execution, PARCExecution_OK), "Expected WhenAny to complete with the first task.");
+    assertTrue(result.value == tasks[2], "Expected the first task to complete, %p, actual %p", (void *) tasks[2], result.value);
+
+    parcFutureTask_Release(&any);
+    for (int i = 0; i < 3; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Continuation, parcFutureTask_WhenAny_Unfinished)
+{
+    PARCFutureTask *tasks[2];
+    for (int i = 0; i < 2; i++) {
+        tasks[i] = parcFutureTask_Create(_value, NULL);
+    }
+
+    PARCFutureTask *any = parcFutureTask_WhenAny(tasks, 2);
+    parcFutureTask_Run(tasks[0]);
+
+    // The other task is released without completing, which must still free the shared state.
+    parcFutureTask_Release(&any);
+    for (int i = 0; i < 2; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, Pipeline_Then);
+    LONGBOW_RUN_TEST_CASE(Performance, Pipeline_Get);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define _PipelineStages 100000
+
+// A pipeline of dependent stages, each added as a continuation of the one before.
+LONGBOW_TEST_CASE(Performance, Pipeline_Then)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+    PARCExecutor *executor = parcThreadPool_AsExecutor(pool);
+
+    uint64_t start = parcTime_NowNanoseconds();
+
+    PARCFutureTask *first = parcFutureTask_Create(_value, NULL);
+    PARCFutureTask *last = parcFutureTask_Acquire(first);
+    for (int i = 0; i < _PipelineStages; i++) {
+        PARCFutureTask *next = parcFutureTask_Then(last, _increment, executor);
+        parcFutureTask_Release(&last);
+        last = next;
+    }
+    parcThreadPool_Execute(pool, first);
+    parcFutureTask_Get(last, PARCTimeout_Never);
+
+    uint64_t elapsed = parcTime_NowNanoseconds() - start;
+    printf("Then: %d stages in %" PRIu64 " us, %.2f us per stage\n", _PipelineStages, elapsed / 1000, (double) elapsed / 1000 / _PipelineStages);
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    parcFutureTask_Release(&last);
+    parcFutureTask_Release(&first);
+    parcExecutor_Release(&executor);
+    parcThreadPool_Release(&pool);
+}
+
+// The same pipeline, with a coordinating thread that waits for each stage before submitting the next.
+LONGBOW_TEST_CASE(Performance, Pipeline_Get)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+
+    uint64_t start = parcTime_NowNanoseconds();
+
+    PARCFutureTask *last = parcFutureTask_Create(_value, NULL);
+    parcThreadPool_Execute(pool, last);
+    for (int i = 0; i < _PipelineStages; i++) {
+        parcFutureTask_Get(last, PARCTimeout_Never);
+        PARCFutureTask *next = parcFutureTask_Create(_increment, last);
+        parcFutureTask_Release(&last);
+        last = next;
+        parcThreadPool_Execute(pool, last);
+    }
+    parcFutureTask_Get(last, PARCTimeout_Never);
+
+    uint64_t elapsed = parcTime_NowNanoseconds() - start;
+    printf("Get: %d stages in %" PRIu64 " us, %.2f us per stage\n", _PipelineStages, elapsed / 1000, (double) elapsed / 1000 / _PipelineStages);
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    parcFutureTask_Release(&last);
+    parcThreadPool_Release(&pool);
+}
+
 int
 main(int argc, char *argv[argc])
 {
@@ -38,6 +38,9 @@
 #include <poll.h>
 
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_EventScheduler.h>
+#include <parc/algol/parc_Event.h>
+#include <parc/algol/parc_Time.h>
 #include <LongBow/unit-test.h>
 
 LONGBOW_TEST_RUNNER(parc_Notifier)
@@ -45,7 +48,9 @@ LONGBOW_TEST_RUNNER(parc_Notifier)
     // The following Test Fixtures will run their corresponding Test Cases.
     // Test Fixtures are run in the order specified, but all tests should be idempotent.
     // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -70,6 +75,10 @@ LONGBOW_TEST_FIXTURE(Global)
 
     LONGBOW_RUN_TEST_CASE(Global, parcNotifier_Notify_First);
     LONGBOW_RUN_TEST_CASE(Global, parcNotifier_Notify_Twice);
+    LONGBOW_RUN_TEST_CASE(Global, parcNotifier_Notify_Readable);
+    LONGBOW_RUN_TEST_CASE(Global, parcNotifier_PauseEvents_Drains);
+    LONGBOW_RUN_TEST_CASE(Global, parcNotifier_StartEvents_Pending);
+    LONGBOW_RUN_TEST_CASE(Global, parcNotifier_EventScheduler);
 
     LONGBOW_RUN_TEST_CASE(Global, parcNotifier_ThreadedTest);
 }
@@ -122,7 +131,7 @@ consumer(void *p)
             data->notificationsReceived++;
             parcNotifier_PauseEvents(data->notifier);
             usleep(rand() % 1024 + 1024);
-            printf("skipped = %d\n", data->notifier->skippedNotify);
+            printf("state = %u\n", data->notifier->state);
             parcNotifier_StartEvents(data->notifier);
         }
     }
@@ -153,14 +162,33 @@ producer(void *p)
     pthread_exit((void *) NULL);
 }
 
+static bool
+_isReadable(PARCNotifier *notifier)
+{
+    struct pollfd pfd = { .fd = parcNotifier_Socket(notifier), .events = POLLIN };
+    return poll(&pfd, 1, 0) == 1;
+}
+
 LONGBOW_TEST_CASE(Global, parcNotifier_Acquire)
 {
-    testUnimplemented("");
+    PARCNotifier *notifier = parcNotifier_Create();
+    PARCNotifier *reference = parcNotifier_Acquire(notifier);
+
+    assertTrue(notifier == reference, "Expected the same instance, got %p and %p", (void *) notifier, (void *) reference);
+
+    parcNotifier_Release(&reference);
+    parcNotifier_Release(&notifier);
 }
 
 LONGBOW_TEST_CASE(Global, parcNotifier_Create_Release)
 {
-    testUnimplemented("");
+    PARCNotifier *notifier = parcNotifier_Create();
+    assertNotNull(notifier, "parcNotifier_Create returned NULL");
+    assertTrue(parcNotifier_Socket(notifier) >= 0, "Expected a valid socket, got %d", parcNotifier_Socket(notifier));
+    assertFalse(_isReadable(notifier), "A new notifier should not be readable");
+
+    parcNotifier_Release(&notifier);
+    assertNull(notifier, "parcNotifier_Release did not NULL the pointer");
 }
 
 LONGBOW_TEST_CASE(Global, parcNotifier_PauseEvent_NotPaused)
@@ -168,8 +196,8 @@ LONGBOW_TEST_CASE(Global, parcNotifier_PauseEvent_NotPaused)
     PARCNotifier *notifier = parcNotifier_Create();
 
     parcNotifier_PauseEvents(notifier);
-    assertTrue(notifier->paused == 1, "Not paused, got %d expected %d", notifier->paused, 1);
-    assertTrue(notifier->skippedNotify == 0, "Wrong skipped, got %d expected %d", notifier->skippedNotify, 0);
+    assertTrue(notifier->state == _PARCNotifierState_Signalled, "Not paused, got %u expected %u",
+               notifier->state, _PARCNotifierState_Signalled);
 
     parcNotifier_Release(&notifier);
 }
@@ -183,8 +211,8 @@ LONGBOW_TEST_CASE(Global, parcNotifier_PauseEvent_AlreadyPaused)
     // now pause again
     parcNotifier_PauseEvents(notifier);
 
-    assertTrue(notifier->paused == 1, "Not paused, got %d expected %d", notifier->paused, 1);
-    assertTrue(notifier->skippedNotify == 0, "Wrong skipped, got %d expected %d", notifier->skippedNotify, 0);
+    assertTrue(notifier->state == _PARCNotifierState_Signalled, "Not paused, got %u expected %u",
+               notifier->state, _PARCNotifierState_Signalled);
 
     parcNotifier_Release(&notifier);
 }
@@ -220,7 +248,17 @@ LONGBOW_TEST_CASE(Global, parcNotifier_ThreadedTest)
 
 LONGBOW_TEST_CASE(Global, parcNotifier_StartEvents)
 {
-    testUnimplemented("unimplemented");
+    PARCNotifier *notifier = parcNotifier_Create();
+
+    parcNotifier_PauseEvents(notifier);
+    parcNotifier_StartEvents(notifier);
+
+    assertTrue(notifier->state == _PARCNotifierState_Armed, "Not armed, got %u expected %u",
+               notifier->state, _PARCNotifierState_Armed);
+    assertFalse(_isReadable(notifier), "Nothing was notified, so the socket should not be readable");
+    assertTrue(parcNotifier_Notify(notifier), "The first notify after StartEvents should signal");
+
+    parcNotifier_Release(&notifier);
 }
 
 LONGBOW_TEST_CASE(Global, parcNotifier_Notify_First)
@@ -229,8 +267,8 @@ LONGBOW_TEST_CASE(Global, parcNotifier_Notify_First)
 
     bool success = parcNotifier_Notify(notifier);
     assertTrue(success, "Did not succeed on first notify");
-    assertTrue(notifier->paused == 1, "Not paused, got %d expected %d", notifier->paused, 1);
-    assertTrue(notifier->skippedNotify == 0, "Wrong skipped, got %d expected %d", notifier->skippedNotify, 0);
+    assertTrue(notifier->state == _PARCNotifierState_Signalled, "Not signalled, got %u expected %u",
+               notifier->state, _PARCNotifierState_Signalled);
 
     parcNotifier_Release(&notifier);
 }
@@ -244,12 +282,86 @@ LONGBOW_TEST_CASE(Global, parcNotifier_Notify_Twice)
 
     bool success = parcNotifier_Notify(notifier);
     assertFalse(success, "Should have failed on second notify");
-    assertTrue(notifier->paused == 1, "Not paused, got %d expected %d", notifier->paused, 1);
-    assertTrue(notifier->skippedNotify == 1, "Wrong skipped, got %d expected %d", notifier->skippedNotify, 1);
+    assertTrue(notifier->state == (_PARCNotifierState_Signalled | _PARCNotifierState_Pending),
+               "Wrong state, got %u expected %u",
+               notifier->state, _PARCNotifierState_Signalled | _PARCNotifierState_Pending);
+
+    parcNotifier_Release(&notifier);
+}
+
+LONGBOW_TEST_CASE(Global, parcNotifier_Notify_Readable)
+{
+    PARCNotifier *notifier = parcNotifier_Create();
+
+    for (int i = 0; i < 10; i++) {
+        parcNotifier_Notify(notifier);
+    }
+    assertTrue(_isReadable(notifier), "The socket should be readable after a notify");
+
+    // Coalesced notifications are consumed by a single pause.
+    parcNotifier_PauseEvents(notifier);
+    assertFalse(_isReadable(notifier), "The socket should not be readable after PauseEvents");
+
+    parcNotifier_Release(&notifier);
+}
+
+LONGBOW_TEST_CASE(Global, parcNotifier_PauseEvents_Drains)
+{
+    PARCNotifier *notifier = parcNotifier_Create();
+
+    parcNotifier_PauseEvents(notifier);
+    assertFalse(parcNotifier_Notify(notifier), "Notify while paused should not signal");
+    assertFalse(_isReadable(notifier), "Notify while paused should not write to the socket");
+
+    parcNotifier_Release(&notifier);
+}
+
+LONGBOW_TEST_CASE(Global, parcNotifier_StartEvents_Pending)
+{
+    PARCNotifier *notifier = parcNotifier_Create();
+
+    parcNotifier_Notify(notifier);
+    parcNotifier_PauseEvents(notifier);
+    parcNotifier_Notify(notifier);
+    parcNotifier_Notify(notifier);
+    parcNotifier_StartEvents(notifier);
+
+    assertTrue(_isReadable(notifier), "Notifications while paused should re-signal on StartEvents");
+    assertTrue(notifier->state == _PARCNotifierState_Signalled, "Wrong state, got %u expected %u",
+               notifier->state, _PARCNotifierState_Signalled);
 
     parcNotifier_Release(&notifier);
 }
 
+static void
+_eventSchedulerCallback(int fd, PARCEventType type, void *user_data)
+{
+    PARCNotifier *notifier = (PARCNotifier *) user_data;
+    parcNotifier_PauseEvents(notifier);
+    parcNotifier_StartEvents(notifier);
+}
+
+LONGBOW_TEST_CASE(Global, parcNotifier_EventScheduler)
+{
+    PARCNotifier *notifier = parcNotifier_Create();
+    PARCEventScheduler *scheduler = parcEventScheduler_Create();
+    PARCEvent *event = parcEvent_Create(scheduler, parcNotifier_Socket(notifier), PARCEventType_Read | PARCEventType_Persist,
+                                        _eventSchedulerCallback, notifier);
+    parcEvent_Start(event);
+
+    parcNotifier_Notify(notifier);
+    parcEventScheduler_Start(scheduler, PARCEventSchedulerDispatchType_NonBlocking);
+
+    // The callback paused and restarted the notifier, which drains and re-arms it.
+    assertFalse(_isReadable(notifier), "The scheduler did not dispatch the notification");
+    assertTrue(notifier->state == _PARCNotifierState_Armed, "Wrong state, got %u expected %u",
+               notifier->state, _PARCNotifierState_Armed);
+
+    parcEvent_Destroy(&event);
+    parcEventScheduler_Destroy(&scheduler);
+    parcNotifier_Release(&notifier);
+}
+
 // ===============================================================
 
 LONGBOW_TEST_FIXTURE(Local)
@@ -270,6 +382,59 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+// ===============================================================
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, Notify_Signalled);
+    LONGBOW_RUN_TEST_CASE(Performance, Notify_Armed);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Performance, Notify_Signalled)
+{
+    const int iterations = 10000000;
+    PARCNotifier *notifier = parcNotifier_Create();
+    parcNotifier_Notify(notifier);
+
+    uint64_t start = parcTime_NowNanoseconds();
+    for (int i = 0; i < iterations; i++) {
+        parcNotifier_Notify(notifier);
+    }
+    uint64_t elapsed = parcTime_NowNanoseconds() - start;
+
+    printf("Notify while signalled: %.2f ns per call\n", (double) elapsed / iterations);
+
+    parcNotifier_Release(&notifier);
+}
+
+LONGBOW_TEST_CASE(Performance, Notify_Armed)
+{
+    const int iterations = 1000000;
+    PARCNotifier *notifier = parcNotifier_Create();
+
+    uint64_t start = parcTime_NowNanoseconds();
+    for (int i = 0; i < iterations; i++) {
+        parcNotifier_Notify(notifier);
+        parcNotifier_PauseEvents(notifier);
+        parcNotifier_StartEvents(notifier);
+    }
+    uint64_t elapsed = parcTime_NowNanoseconds() - start;
+
+    printf("Notify, pause and start: %.2f ns per cycle\n", (double) elapsed / iterations);
+
+    parcNotifier_Release(&notifier);
+}
+
 int
 main(int argc, char *argv[])
 {
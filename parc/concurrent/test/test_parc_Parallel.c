@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_Parallel.c"
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_Time.h>
+
+#include <parc/testing/parc_MemoryTesting.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_Parallel)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_Parallel)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_Parallel)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For_Grains);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For_NoPool);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For_Nested);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_For_Shutdown);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_ForEachArrayList);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_ForEachLinkedList);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_MapReduce);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_MapReduce_Order);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_MapReduce_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_Sort);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_Sort_Small);
+    LONGBOW_RUN_TEST_CASE(Global, parcParallel_Sort_Records);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    longBowTestCase_Set(testCase, "pool", parcThreadPool_Create(3));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    parcThreadPool_Release(&pool);
+
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+typedef struct {
+    uint32_t *visits;
+    PARCThreadPool *pool;
+} _Visits;
+
+static void
+_visit(size_t begin, size_t end, void *context)
+{
+    _Visits *visits = context;
+    assertTrue(begin < end, "Expected a non-empty chunk, got [%zu, %zu)", begin, end);
+    for (size_t i = begin; i < end; i++) {
+        visits->visits[i]++;
+    }
+}
+
+static void
+_assertVisitedOnce(PARCThreadPool *pool, size_t count, size_t grain)
+{
+    _Visits visits = { .visits = parcMemory_AllocateAndClear(count * sizeof(uint32_t) + 1), .pool = pool };
+
+    parcParallel_For(pool, count, grain, _visit, &visits);
+
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(visits.visits[i] == 1, "Expected index %zu to be visited once with grain %zu, actual %u", i, grain, visits.visits[i]);
+    }
+    parcMemory_Deallocate(&visits.visits);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    _assertVisitedOnce(pool, 10000, 0);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For_Grains)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    size_t grains[] = { 1, 7, 100, 999, 1000, 5000 };
+    for (size_t i = 0; i < sizeof(grains) / sizeof(grains[0]); i++) {
+        _assertVisitedOnce(pool, 1000, grains[i]);
+    }
+    _assertVisitedOnce(pool, 1, 0);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For_NoPool)
+{
+    _assertVisitedOnce(NULL, 1000, 0);
+    _assertVisitedOnce(NULL, 1000, 3);
+}
+
+static void
+_unexpected(size_t begin, size_t end, void *context)
+{
+    assertTrue(false, "Expected no chunks, got [%zu, %zu)", begin, end);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For_Empty)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    parcParallel_For(pool, 0, 0, _unexpected, NULL);
+}
+
+// Each outer index runs an inner parallel loop on the same pool, from the pool's own threads.
+static void
+_visitNested(size_t begin, size_t end, void *context)
+{
+    _Visits *visits = context;
+    for (size_t i = begin; i < end; i++) {
+        _Visits inner = { .visits = visits->visits + i * 100, .pool = visits->pool };
+        parcParallel_For(visits->pool, 100, 10, _visit, &inner);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For_Nested)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    _Visits visits = { .visits = parcMemory_AllocateAndClear(20 * 100 * sizeof(uint32_t)), .pool = pool };
+
+    parcParallel_For(pool, 20, 1, _visitNested, &visits);
+
+    for (size_t i = 0; i < 20 * 100; i++) {
+        assertTrue(visits.visits[i] == 1, "Expected index %zu to be visited once, actual %u", i, visits.visits[i]);
+    }
+    parcMemory_Deallocate(&visits.visits);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_For_Shutdown)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(2);
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    // A pool that rejects the helpers leaves all the work to the calling thread.
+    _assertVisitedOnce(pool, 1000, 10);
+
+    parcThreadPool_Release(&pool);
+}
+
+static void
+_mark(void *element, void *context)
+{
+    parcBuffer_PutAtIndex(element, 0, parcBuffer_GetAtIndex(element, 0) + 1);
+}
+
+static PARCBuffer *
+_markableBuffer(void)
+{
+    PARCBuffer *result = parcBuffer_Allocate(1);
+    parcBuffer_PutAtIndex(result, 0, 0);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_ForEachArrayList)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    PARCArrayList *list = parcArrayList_Create((void (*)(void **))parcBuffer_Release);
+    for (int i = 0; i < 500; i++) {
+        parcArrayList_Add(list, _markableBuffer());
+    }
+
+    parcParallel_ForEachArrayList(pool, list, _mark, NULL);
+
+    for (size_t i = 0; i < parcArrayList_Size(list); i++) {
+        uint8_t marks = parcBuffer_GetAtIndex(parcArrayList_Get(list, i), 0);
+        assertTrue(marks == 1, "Expected element %zu to be visited once, actual %u", i, marks);
+    }
+    parcArrayList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_ForEachLinkedList)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    PARCLinkedList *list = parcLinkedList_Create();
+    for (int i = 0; i < 500; i++) {
+        PARCBuffer *buffer = _markableBuffer();
+        parcLinkedList_Append(list, buffer);
+        parcBuffer_Release(&buffer);
+    }
+
+    parcParallel_ForEachLinkedList(pool, list, _mark, NULL);
+
+    for (size_t i = 0; i < parcLinkedList_Size(list); i++) {
+        uint8_t marks = parcBuffer_GetAtIndex(parcLinkedList_GetAtIndex(list, i), 0);
+        assertTrue(marks == 1, "Expected element %zu to be visited once, actual %u", i, marks);
+    }
+    parcLinkedList_Release(&list);
+}
+
+static void *
+_sumRange(size_t begin, size_t end, void *context)
+{
+    uint64_t *result = parcMemory_Allocate(sizeof(uint64_t));
+    *result = 0;
+    for (size_t i = begin; i < end; i++) {
+        *result += i;
+    }
+    return result;
+}
+
+static void *
+_addSums(void *left, void *right, void *context)
+{
+    *(uint64_t *) left += *(uint64_t *) right;
+    parcMemory_Deallocate(&right);
+    return left;
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_MapReduce)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+    const uint64_t count = 100000;
+
+    uint64_t *sum = parcParallel_MapReduce(pool, count, 0, _sumRange, _addSums, NULL);
+
+    assertTrue(*sum == count * (count - 1) / 2, "Expected %" PRIu64 ", actual %" PRIu64, count * (count - 1) / 2, *sum);
+    parcMemory_Deallocate(&sum);
+}
+
+typedef struct {
+    size_t begin;
+    size_t end;
+} _Span;
+
+static void *
+_span(size_t begin, size_t end, void *context)
+{
+    _Span *result = parcMemory_Allocate(sizeof(_Span));
+    result->begin = begin;
+    result->end = end;
+    return result;
+}
+
+// Joining spans is associative but not commutative: the left span must end where the right one begins.
+static void *
+_joinSpans(void *left, void *right, void *context)
+{
+    _Span *l = left;
+    _Span *r = right;
+    assertTrue(l->end == r->begin, "Expected adjacent spans in order, got [%zu, %zu) then [%zu, %zu)", l->begin, l->end, r->begin, r->end);
+    l->end = r->end;
+    parcMemory_Deallocate(&right);
+    return left;
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_MapReduce_Order)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    _Span *span = parcParallel_MapReduce(pool, 1000, 3, _span, _joinSpans, NULL);
+
+    assertTrue(span->begin == 0 && span->end == 1000, "Expected [0, 1000), actual [%zu, %zu)", span->begin, span->end);
+    parcMemory_Deallocate(&span);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_MapReduce_Empty)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    void *result = parcParallel_MapReduce(pool, 0, 0, _sumRange, _addSums, NULL);
+
+    assertNull(result, "Expected NULL for no indexes, actual %p", result);
+}
+
+static int
+_compareUint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static void
+_assertSorts(PARCThreadPool *pool, size_t count)
+{
+    uint32_t *keys = parcMemory_Allocate(count * sizeof(uint32_t) + 1);
+    uint64_t sum = 0;
+    srandom(count);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = (uint32_t) random() % 1000;
+        sum += keys[i];
+    }
+
+    parcParallel_Sort(pool, keys, count, sizeof(uint32_t), _compareUint32);
+
+    uint64_t sorted = 0;
+    for (size_t i = 0; i < count; i++) {
+        sorted += keys[i];
+        if (i > 0) {
+            assertTrue(keys[i - 1] <= keys[i], "Expected a sorted array of %zu, %u precedes %u at %zu", count, keys[i - 1], keys[i], i);
+        }
+    }
+    assertTrue(sorted == sum, "Expected the same keys after sorting %zu", count);
+
+    parcMemory_Deallocate(&keys);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_Sort)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    // Sizes giving both an odd and an even number of merge rounds, and a short final run.
+    _assertSorts(pool, 4 * _PARCParallel_MinimumSortGrain);
+    _assertSorts(pool, 8 * _PARCParallel_MinimumSortGrain + 17);
+    _assertSorts(pool, 100000);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_Sort_Small)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+
+    _assertSorts(pool, 0);
+    _assertSorts(pool, 1);
+    _assertSorts(pool, 100);
+    _assertSorts(NULL, 10000);
+}
+
+typedef struct {
+    uint64_t key;
+    uint32_t value;
+} _Record;
+
+static int
+_compareRecords(const void *a, const void *b)
+{
+    const _Record *x = a;
+    const _Record *y = b;
+    return (x->key < y->key) ? -1 : (x->key > y->key);
+}
+
+LONGBOW_TEST_CASE(Global, parcParallel_Sort_Records)
+{
+    PARCThreadPool *pool = longBowTestCase_Get(testCase, "pool");
+    const size_t count = 50000;
+
+    _Record *records = parcMemory_Allocate(count * sizeof(_Record));
+    for (size_t i = 0; i < count; i++) {
+        records[i].key = (count - i) * 2654435761u % count;
+        records[i].value = (uint32_t) records[i].key ^ 0x5a5a5a5a;
+    }
+
+    parcParallel_Sort(pool, records, count, sizeof(_Record), _compareRecords);
+
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(records[i].value == ((uint32_t) records[i].key ^ 0x5a5a5a5a), "Expected records to move whole, at %zu", i);
+        if (i > 0) {
+            assertTrue(records[i - 1].key <= records[i].key, "Expected sorted records at %zu", i);
+        }
+    }
+    parcMemory_Deallocate(&records);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, Sort);
+    LONGBOW_RUN_TEST_CASE(Performance, MapReduce);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Performance, Sort)
+{
+    const size_t count = 4000000;
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+
+    uint32_t *keys = malloc(count * sizeof(uint32_t));
+    uint32_t *copy = malloc(count * sizeof(uint32_t));
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = (uint32_t) random();
+    }
+    memcpy(copy, keys, count * sizeof(uint32_t));
+
+    uint64_t start = parcTime_NowNanoseconds();
+    qsort(copy, count, sizeof(uint32_t), _compareUint32);
+    uint64_t sequential = parcTime_NowNanoseconds() - start;
+
+    start = parcTime_NowNanoseconds();
+    parcParallel_Sort(pool, keys, count, sizeof(uint32_t), _compareUint32);
+    uint64_t parallel = parcTime_NowNanoseconds() - start;
+
+    printf("Sort %zu keys: qsort %" PRIu64 " ms, parcParallel_Sort %" PRIu64 " ms\n", count, sequential / 1000000, parallel / 1000000);
+
+    free(keys);
+    free(copy);
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    parcThreadPool_Release(&pool);
+}
+
+// Sum a hash of each index, which the compiler cannot reduce to a formula.
+static void *
+_sumHashes(size_t begin, size_t end, void *context)
+{
+    uint64_t *result = parcMemory_Allocate(sizeof(uint64_t));
+    *result = 0;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t x = i * 0x9E3779B97F4A7C15ULL;
+        x ^= x >> 31;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        *result += x ^ (x >> 27);
+    }
+    return result;
+}
+
+LONGBOW_TEST_CASE(Performance, MapReduce)
+{
+    const size_t count = 100000000;
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+
+    uint64_t start = parcTime_NowNanoseconds();
+    uint64_t *expected = _sumHashes(0, count, NULL);
+    uint64_t sequential = parcTime_NowNanoseconds() - start;
+
+    start = parcTime_NowNanoseconds();
+    uint64_t *actual = parcParallel_MapReduce(pool, count, 0, _sumHashes, _addSums, NULL);
+    uint64_t parallel = parcTime_NowNanoseconds() - start;
+
+    assertTrue(*expected == *actual, "Expected the same sum");
+    printf("Sum %zu values: sequential %" PRIu64 " ms, parcParallel_MapReduce %" PRIu64 " ms\n", count, sequential / 1000000, parallel / 1000000);
+
+    parcMemory_Deallocate(&expected);
+    parcMemory_Deallocate(&actual);
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    parcThreadPool_Release(&pool);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_Parallel);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -34,6 +34,8 @@
 #include "../parc_RingBuffer_1x1.c"
 
 #include <sys/time.h>
+#include <sched.h>
+#include <inttypes.h>
 
 #include <parc/algol/parc_SafeMemory.h>
 #include <LongBow/unit-test.h>
@@ -45,6 +47,7 @@ LONGBOW_TEST_RUNNER(parc_RingBuffer_1x1)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -69,6 +72,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_Remaining_Half);
     LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_Remaining_Full);
     LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_Put_ToCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_PutBatch_GetBatch);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_PutBatch_ToCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_GetBatch_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_Batch_Threads);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_PutWait_GetWait);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_GetWait_Timeout);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBuffer1x1_PutWait_Timeout);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -269,6 +279,277 @@ LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_Put_ToCapacity)
     assertFalse(success, "Should have failed on final put because data structure is full\n");
 }
 
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_PutBatch_GetBatch)
+{
+    // Go around a small ring many times, mixing batch and single operations, so the indices wrap.
+    PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(16, NULL);
+
+    uintptr_t nextPut = 1;
+    uintptr_t nextGet = 1;
+    for (int round = 0; round < 1000; round++) {
+        void *items[7];
+        uint32_t count = round % 7 + 1;
+        for (uint32_t i = 0; i < count; i++) {
+            items[i] = (void *) (nextPut + i);
+        }
+        uint32_t put = parcRingBuffer1x1_PutBatch(ring, items, count);
+        assertTrue(put == count, "Expected to put %u items, put %u", count, put);
+        nextPut += put;
+
+        if (round % 2 == 0) {
+            void *data;
+            assertTrue(parcRingBuffer1x1_Get(ring, &data), "Expected Get to succeed");
+            assertTrue((uintptr_t) data == nextGet, "Got out of order item %p expected %" PRIuPTR, data, nextGet);
+            nextGet++;
+        }
+
+        void *output[5];
+        uint32_t got = parcRingBuffer1x1_GetBatch(ring, output, 5);
+        for (uint32_t i = 0; i < got; i++) {
+            assertTrue((uintptr_t) output[i] == nextGet, "Got out of order item %p expected %" PRIuPTR, output[i], nextGet);
+            nextGet++;
+        }
+    }
+
+    void *output[16];
+    uint32_t got;
+    while ((got = parcRingBuffer1x1_GetBatch(ring, output, 16)) > 0) {
+        for (uint32_t i = 0; i < got; i++) {
+            assertTrue((uintptr_t) output[i] == nextGet, "Got out of order item %p expected %" PRIuPTR, output[i], nextGet);
+            nextGet++;
+        }
+    }
+    assertTrue(nextGet == nextPut, "Expected every item back, put %" PRIuPTR " got %" PRIuPTR, nextPut - 1, nextGet - 1);
+
+    parcRingBuffer1x1_Release(&ring);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_PutBatch_ToCapacity)
+{
+    uint32_t capacity = 16;
+    PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(capacity, NULL);
+
+    void *items[20];
+    for (int i = 0; i < 20; i++) {
+        items[i] = &items[i];
+    }
+
+    uint32_t put = parcRingBuffer1x1_PutBatch(ring, items, 10);
+    uint32_t putPartial = parcRingBuffer1x1_PutBatch(ring, &items[10], 10);
+    uint32_t putFull = parcRingBuffer1x1_PutBatch(ring, items, 1);
+    uint32_t remaining = parcRingBuffer1x1_Remaining(ring);
+
+    void *output[20];
+    uint32_t got = parcRingBuffer1x1_GetBatch(ring, output, 20);
+
+    parcRingBuffer1x1_Release(&ring);
+
+    assertTrue(put == 10, "Expected to put 10 items, put %u", put);
+    assertTrue(putPartial == capacity - 1 - 10, "Expected to put %u items, put %u", capacity - 1 - 10, putPartial);
+    assertTrue(putFull == 0, "Expected to put nothing on a full ring, put %u", putFull);
+    assertTrue(remaining == 0, "Got wrong remaining, got %u expecting 0", remaining);
+    assertTrue(got == capacity - 1, "Expected to get %u items, got %u", capacity - 1, got);
+    for (uint32_t i = 0; i < got; i++) {
+        assertTrue(output[i] == items[i], "Got out of order item %u", i);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_GetBatch_Empty)
+{
+    PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(16, NULL);
+
+    void *output[4];
+    uint32_t got = parcRingBuffer1x1_GetBatch(ring, output, 4);
+    uint32_t put = parcRingBuffer1x1_PutBatch(ring, output, 0);
+
+    parcRingBuffer1x1_Release(&ring);
+
+    assertTrue(got == 0, "Expected nothing from an empty ring, got %u", got);
+    assertTrue(put == 0, "Expected an empty batch to put nothing, put %u", put);
+}
+
+typedef struct {
+    PARCRingBuffer1x1 *ring;
+    uint32_t itemsToWrite;
+    uint32_t batchSize;
+    volatile bool blocked;
+    uint32_t itemsRead;
+} _TestBatch;
+
+static void *
+_batchProducer(void *p)
+{
+    _TestBatch *test = p;
+    void *items[64];
+
+    while (test->blocked) {
+        // nothing to do
+    }
+
+    uintptr_t next = 0;
+    while (next < test->itemsToWrite) {
+        uint32_t count = test->batchSize;
+        if (count > test->itemsToWrite - next) {
+            count = (uint32_t) (test->itemsToWrite - next);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            items[i] = (void *) (next + i + 1);
+        }
+        uint32_t put = 0;
+        while (put < count) {
+            uint32_t n = (test->batchSize == 1)
+                ? (parcRingBuffer1x1_Put(test->ring, items[put]) ? 1 : 0)
+                : parcRingBuffer1x1_PutBatch(test->ring, &items[put], count - put);
+            if (n == 0) {
+                sched_yield();
+            }
+            put += n;
+        }
+        next += count;
+    }
+    return NULL;
+}
+
+static void *
+_batchConsumer(void *p)
+{
+    _TestBatch *test = p;
+    void *items[64];
+
+    while (test->blocked) {
+        // nothing to do
+    }
+
+    uintptr_t expected = 1;
+    while (test->itemsRead < test->itemsToWrite) {
+        uint32_t got = (test->batchSize == 1)
+            ? (parcRingBuffer1x1_Get(test->ring, &items[0]) ? 1 : 0)
+            : parcRingBuffer1x1_GetBatch(test->ring, items, test->batchSize);
+        if (got == 0) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < got; i++) {
+            assertTrue((uintptr_t) items[i] == expected, "Got out of order item %p expected %" PRIuPTR, items[i], expected);
+            expected++;
+        }
+        test->itemsRead += got;
+    }
+    return NULL;
+}
+
+/*
+ * Pass the items from one thread to another and return the elapsed time in seconds.
+ */
+static double
+_runBatch(_TestBatch *test)
+{
+    pthread_t producerThread;
+    pthread_t consumerThread;
+
+    test->blocked = true;
+    test->itemsRead = 0;
+    pthread_create(&consumerThread, NULL, _batchConsumer, test);
+    pthread_create(&producerThread, NULL, _batchProducer, test);
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    test->blocked = false;
+
+    pthread_join(producerThread, NULL);
+    pthread_join(consumerThread, NULL);
+    gettimeofday(&t1, NULL);
+
+    timersub(&t1, &t0, &t1);
+    return t1.tv_sec + t1.tv_usec * 1E-6;
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_Batch_Threads)
+{
+    _TestBatch test = {
+        .ring         = parcRingBuffer1x1_Create(128, NULL),
+        .itemsToWrite = 100000,
+        .batchSize    = 16
+    };
+
+    _runBatch(&test);
+    assertTrue(test.itemsRead == test.itemsToWrite, "Did not read all items got %u expected %u", test.itemsRead, test.itemsToWrite);
+
+    parcRingBuffer1x1_Release(&test.ring);
+}
+
+typedef struct {
+    PARCRingBuffer1x1 *ring;
+    PARCWaitStrategy *strategy;
+    uintptr_t itemsToWrite;
+} _TestWait;
+
+static void *
+_waitProducer(void *p)
+{
+    _TestWait *test = p;
+    for (uintptr_t i = 1; i <= test->itemsToWrite; i++) {
+        assertTrue(parcRingBuffer1x1_PutWait(test->ring, (void *) i, test->strategy, PARCTimeout_Never), "PutWait %" PRIuPTR " failed", i);
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_PutWait_GetWait)
+{
+    PARCWaitStrategyKind kinds[] = { PARCWaitStrategyKind_BusySpin, PARCWaitStrategyKind_SpinThenYield, PARCWaitStrategyKind_Park };
+
+    for (int k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        // A small ring makes both sides wait often.
+        _TestWait test = {
+            .ring         = parcRingBuffer1x1_Create(8, NULL),
+            .strategy     = parcWaitStrategy_Create(kinds[k]),
+            .itemsToWrite = 2000
+        };
+
+        pthread_t producerThread;
+        pthread_create(&producerThread, NULL, _waitProducer, &test);
+
+        for (uintptr_t expected = 1; expected <= test.itemsToWrite; expected++) {
+            void *data;
+            assertTrue(parcRingBuffer1x1_GetWait(test.ring, &data, test.strategy, PARCTimeout_Never), "GetWait failed");
+            assertTrue((uintptr_t) data == expected, "Got out of order item %p expected %" PRIuPTR, data, expected);
+        }
+        pthread_join(producerThread, NULL);
+
+        parcWaitStrategy_Release(&test.strategy);
+        parcRingBuffer1x1_Release(&test.ring);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_GetWait_Timeout)
+{
+    PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(8, NULL);
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+
+    void *data = NULL;
+    bool success = parcRingBuffer1x1_GetWait(ring, &data, strategy, parcTimeout_MilliSeconds(10));
+
+    parcWaitStrategy_Release(&strategy);
+    parcRingBuffer1x1_Release(&ring);
+
+    assertFalse(success, "Expected GetWait on an empty ring to time out");
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBuffer1x1_PutWait_Timeout)
+{
+    PARCRingBuffer1x1 *ring = parcRingBuffer1x1_Create(8, NULL);
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+
+    for (int i = 0; i < 7; i++) {
+        assertTrue(parcRingBuffer1x1_PutWait(ring, &ring, strategy, PARCTimeout_Immediate), "Expected room for item %d", i);
+    }
+    bool success = parcRingBuffer1x1_PutWait(ring, &ring, strategy, parcTimeout_MilliSeconds(10));
+
+    parcWaitStrategy_Release(&strategy);
+    parcRingBuffer1x1_Release(&ring);
+
+    assertFalse(success, "Expected PutWait on a full ring to time out");
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
     LONGBOW_RUN_TEST_CASE(Local, _create);
@@ -328,6 +609,37 @@ LONGBOW_TEST_CASE(Local, _isPowerOfTwo)
     }
 }
 
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcRingBuffer1x1_Throughput);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Performance, parcRingBuffer1x1_Throughput)
+{
+    for (uint32_t batchSize = 1; batchSize <= 64; batchSize *= 4) {
+        _TestBatch test = {
+            .ring         = parcRingBuffer1x1_Create(1024, NULL),
+            .itemsToWrite = 10000000,
+            .batchSize    = batchSize
+        };
+
+        double sec = _runBatch(&test);
+        printf("batch %2u: %.2f Mitems/sec\n", batchSize, test.itemsRead / sec * 1E-6);
+
+        parcRingBuffer1x1_Release(&test.ring);
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -29,6 +29,11 @@
 // This permits internal static functions to be visible to this Test Framework.
 #include "../parc_RingBuffer_NxM.c"
 
+#include <sys/time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+
 #include <parc/algol/parc_SafeMemory.h>
 #include <LongBow/unit-test.h>
 
@@ -39,6 +44,7 @@ LONGBOW_TEST_RUNNER(parc_RingBuffer_NxM)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -55,6 +61,15 @@ LONGBOW_TEST_RUNNER_TEARDOWN(parc_RingBuffer_NxM)
 
 LONGBOW_TEST_FIXTURE(Global)
 {
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Create_NonPower2);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Get_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Get_Put);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Put_ToCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Remaining_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Remaining_Full);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Concurrent);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_Concurrent_Wait);
+    LONGBOW_RUN_TEST_CASE(Global, parcRingBufferNxM_GetWait_Timeout);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -72,6 +87,300 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+LONGBOW_TEST_CASE_EXPECTS(Global, parcRingBufferNxM_Create_NonPower2, .event = &LongBowAssertEvent)
+{
+    // this will assert because the number of elements is not a power of 2
+    parcRingBufferNxM_Create(3, NULL);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Get_Empty)
+{
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(16, NULL);
+
+    void *data = NULL;
+    bool success = parcRingBufferNxM_Get(ring, &data);
+    parcRingBufferNxM_Release(&ring);
+
+    assertFalse(success, "Expected Get on an empty ring to fail");
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Get_Put)
+{
+    // Go around a small ring many times so the positions wrap over the cells.
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(8, NULL);
+
+    uintptr_t expected = 0;
+    for (uintptr_t i = 0; i < 1000; i++) {
+        assertTrue(parcRingBufferNxM_Put(ring, (void *) i), "Put %" PRIuPTR " failed", i);
+        if (i % 3 == 2) {
+            void *data;
+            while (parcRingBufferNxM_Get(ring, &data)) {
+                assertTrue((uintptr_t) data == expected, "Got out of order item %" PRIuPTR " expected %" PRIuPTR, (uintptr_t) data, expected);
+                expected++;
+            }
+        }
+    }
+    parcRingBufferNxM_Release(&ring);
+
+    assertTrue(expected == 999, "Expected 999 items, got %" PRIuPTR, expected);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Put_ToCapacity)
+{
+    uint32_t capacity = 128;
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(capacity, NULL);
+    for (int i = 0; i < capacity - 1; i++) {
+        assertTrue(parcRingBufferNxM_Put(ring, &i), "Put %d failed before the ring was full", i);
+    }
+
+    // this next put should fail
+    bool success = parcRingBufferNxM_Put(ring, &capacity);
+
+    // and after a get there is room for exactly one more
+    void *data;
+    parcRingBufferNxM_Get(ring, &data);
+    bool successAfterGet = parcRingBufferNxM_Put(ring, &capacity);
+    bool successWhenFull = parcRingBufferNxM_Put(ring, &capacity);
+
+    parcRingBufferNxM_Release(&ring);
+
+    assertFalse(success, "Should have failed on final put because data structure is full\n");
+    assertTrue(successAfterGet, "Should have succeeded after a get made room\n");
+    assertFalse(successWhenFull, "Should have failed because data structure is full again\n");
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Remaining_Empty)
+{
+    uint32_t capacity = 128;
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(capacity, NULL);
+    uint32_t remaining = parcRingBufferNxM_Remaining(ring);
+    parcRingBufferNxM_Release(&ring);
+
+    // -1 because the ring buffer is always -1
+    assertTrue(remaining == capacity - 1, "Got wrong remaining, got %u expecting %u\n", remaining, capacity - 1);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Remaining_Full)
+{
+    uint32_t capacity = 128;
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(capacity, NULL);
+    for (int i = 0; i < capacity - 1; i++) {
+        parcRingBufferNxM_Put(ring, &i);
+    }
+
+    uint32_t remaining = parcRingBufferNxM_Remaining(ring);
+    parcRingBufferNxM_Release(&ring);
+
+    assertTrue(remaining == 0, "Got wrong remaining, got %u expecting %u\n", remaining, 0);
+}
+
+// ------
+// Items carry their producer in the high bits and a per-producer sequence number in the low bits.
+#define _ProducerShift 24
+
+typedef struct {
+    bool (*put)(void *ring, void *data);
+    bool (*get)(void *ring, void **data);
+    void *ring;
+
+    unsigned producers;
+    unsigned consumers;
+    unsigned itemsPerProducer;
+    volatile bool blocked;
+    volatile unsigned itemsRead;
+    volatile uint64_t sum;
+} _TestContention;
+
+typedef struct {
+    _TestContention *test;
+    unsigned id;
+} _TestThread;
+
+static void *
+_producer(void *p)
+{
+    _TestThread *thread = p;
+    _TestContention *test = thread->test;
+
+    while (test->blocked) {
+        // nothing to do
+    }
+
+    for (uintptr_t i = 0; i < test->itemsPerProducer; i++) {
+        void *data = (void *) (((uintptr_t) thread->id << _ProducerShift) | i);
+        while (!test->put(test->ring, data)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *
+_consumer(void *p)
+{
+    _TestThread *thread = p;
+    _TestContention *test = thread->test;
+    unsigned totalItems = test->producers * test->itemsPerProducer;
+
+    // Items from any one producer must reach any one consumer in the order they were put.
+    uintptr_t *next = calloc(test->producers, sizeof(uintptr_t));
+    uint64_t sum = 0;
+
+    while (test->blocked) {
+        // nothing to do
+    }
+
+    while (__atomic_load_n(&test->itemsRead, __ATOMIC_RELAXED) < totalItems) {
+        void *data;
+        if (test->get(test->ring, &data)) {
+            uintptr_t producer = (uintptr_t) data >> _ProducerShift;
+            uintptr_t sequence = (uintptr_t) data & ((1 << _ProducerShift) - 1);
+            assertTrue(producer < test->producers, "Got an item from unknown producer %" PRIuPTR, producer);
+            assertTrue(sequence >= next[producer], "Got out of order item %" PRIuPTR " from producer %" PRIuPTR, sequence, producer);
+            next[producer] = sequence + 1;
+            sum += sequence;
+            __atomic_add_fetch(&test->itemsRead, 1, __ATOMIC_RELAXED);
+        } else {
+            sched_yield();
+        }
+    }
+
+    __atomic_add_fetch(&test->sum, sum, __ATOMIC_RELAXED);
+    free(next);
+    return NULL;
+}
+
+/*
+ * Run the producers and consumers to completion and return the elapsed time in seconds.
+ */
+static double
+_runContention(_TestContention *test)
+{
+    pthread_t producers[test->producers];
+    pthread_t consumers[test->consumers];
+    _TestThread producerThreads[test->producers];
+    _TestThread consumerThreads[test->consumers];
+
+    test->blocked = true;
+    test->itemsRead = 0;
+    test->sum = 0;
+
+    for (unsigned i = 0; i < test->consumers; i++) {
+        consumerThreads[i] = (_TestThread) { .test = test, .id = i };
+        pthread_create(&consumers[i], NULL, _consumer, &consumerThreads[i]);
+    }
+    for (unsigned i = 0; i < test->producers; i++) {
+        producerThreads[i] = (_TestThread) { .test = test, .id = i };
+        pthread_create(&producers[i], NULL, _producer, &producerThreads[i]);
+    }
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    test->blocked = false;
+
+    for (unsigned i = 0; i < test->producers; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (unsigned i = 0; i < test->consumers; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    gettimeofday(&t1, NULL);
+
+    timersub(&t1, &t0, &t1);
+    return t1.tv_sec + t1.tv_usec * 1E-6;
+}
+
+static void
+_assertContention(const _TestContention *test)
+{
+    uint64_t n = test->itemsPerProducer;
+    uint64_t expected = test->producers * (n * (n - 1) / 2);
+
+    assertTrue(test->itemsRead == test->producers * test->itemsPerProducer,
+               "Expected %u items read, got %u", test->producers * test->itemsPerProducer, test->itemsRead);
+    assertTrue(test->sum == expected, "Expected the items to sum to %" PRIu64 ", got %" PRIu64, expected, test->sum);
+}
+
+static bool
+_lockFreePut(void *ring, void *data)
+{
+    return parcRingBufferNxM_Put(ring, data);
+}
+
+static bool
+_lockFreeGet(void *ring, void **data)
+{
+    return parcRingBufferNxM_Get(ring, data);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Concurrent)
+{
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(64, NULL);
+
+    _TestContention test = {
+        .put              = _lockFreePut,
+        .get              = _lockFreeGet,
+        .ring             = ring,
+        .producers        = 4,
+        .consumers        = 4,
+        .itemsPerProducer = 20000
+    };
+    _runContention(&test);
+    _assertContention(&test);
+
+    assertTrue(parcRingBufferNxM_Remaining(ring) == 63, "Expected an empty ring, got %u remaining", parcRingBufferNxM_Remaining(ring));
+    parcRingBufferNxM_Release(&ring);
+}
+
+static PARCWaitStrategy *_testStrategy;
+
+static bool
+_waitPut(void *ring, void *data)
+{
+    return parcRingBufferNxM_PutWait(ring, data, _testStrategy, PARCTimeout_Never);
+}
+
+static bool
+_waitGet(void *ring, void **data)
+{
+    // A timeout lets a consumer notice that the other consumers have read the last item.
+    return parcRingBufferNxM_GetWait(ring, data, _testStrategy, parcTimeout_MilliSeconds(1));
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_Concurrent_Wait)
+{
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(8, NULL);
+    _testStrategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+
+    _TestContention test = {
+        .put              = _waitPut,
+        .get              = _waitGet,
+        .ring             = ring,
+        .producers        = 3,
+        .consumers        = 3,
+        .itemsPerProducer = 10000
+    };
+    _runContention(&test);
+    _assertContention(&test);
+
+    parcWaitStrategy_Release(&_testStrategy);
+    parcRingBufferNxM_Release(&ring);
+}
+
+LONGBOW_TEST_CASE(Global, parcRingBufferNxM_GetWait_Timeout)
+{
+    PARCRingBufferNxM *ring = parcRingBufferNxM_Create(8, NULL);
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_SpinThenYield);
+
+    void *data = NULL;
+    bool success = parcRingBufferNxM_GetWait(ring, &data, strategy, parcTimeout_MilliSeconds(10));
+
+    parcWaitStrategy_Release(&strategy);
+    parcRingBufferNxM_Release(&ring);
+
+    assertFalse(success, "Expected GetWait on an empty ring to time out");
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
     LONGBOW_RUN_TEST_CASE(Local, _destroy);
@@ -107,6 +416,86 @@ LONGBOW_TEST_CASE(Local, _destroy)
     assertTrue(parcMemory_Outstanding() == 0, "Memory imbalance, expected 0 got %u", parcMemory_Outstanding());
 }
 
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcRingBufferNxM_Contention);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The previous implementation: a PARCRingBuffer1x1 with a mutex for the producers and a mutex for the consumers.
+typedef struct {
+    PARCRingBuffer1x1 *onebyone;
+    pthread_mutex_t writer_mutex;
+    pthread_mutex_t reader_mutex;
+} _MutexRing;
+
+static bool
+_mutexPut(void *ring, void *data)
+{
+    _MutexRing *mutexRing = ring;
+    pthread_mutex_lock(&mutexRing->writer_mutex);
+    bool success = parcRingBuffer1x1_Put(mutexRing->onebyone, data);
+    pthread_mutex_unlock(&mutexRing->writer_mutex);
+    return success;
+}
+
+static bool
+_mutexGet(void *ring, void **data)
+{
+    _MutexRing *mutexRing = ring;
+    pthread_mutex_lock(&mutexRing->reader_mutex);
+    bool success = parcRingBuffer1x1_Get(mutexRing->onebyone, data);
+    pthread_mutex_unlock(&mutexRing->reader_mutex);
+    return success;
+}
+
+LONGBOW_TEST_CASE(Performance, parcRingBufferNxM_Contention)
+{
+    const unsigned totalItems = 1000000;
+
+    for (unsigned threads = 1; threads <= 16; threads *= 2) {
+        _MutexRing mutexRing;
+        mutexRing.onebyone = parcRingBuffer1x1_Create(1024, NULL);
+        pthread_mutex_init(&mutexRing.writer_mutex, NULL);
+        pthread_mutex_init(&mutexRing.reader_mutex, NULL);
+
+        _TestContention test = {
+            .put              = _mutexPut,
+            .get              = _mutexGet,
+            .ring             = &mutexRing,
+            .producers        = threads,
+            .consumers        = threads,
+            .itemsPerProducer = totalItems / threads
+        };
+        double mutexSeconds = _runContention(&test);
+        _assertContention(&test);
+
+        parcRingBuffer1x1_Release(&mutexRing.onebyone);
+        pthread_mutex_destroy(&mutexRing.writer_mutex);
+        pthread_mutex_destroy(&mutexRing.reader_mutex);
+
+        PARCRingBufferNxM *ring = parcRingBufferNxM_Create(1024, NULL);
+        test.put = _lockFreePut;
+        test.get = _lockFreeGet;
+        test.ring = ring;
+        double lockFreeSeconds = _runContention(&test);
+        _assertContention(&test);
+        parcRingBufferNxM_Release(&ring);
+
+        printf("%2ux%-2u mutex %.2f Mitems/sec, lock-free %.2f Mitems/sec\n", threads, threads,
+               totalItems / mutexSeconds * 1E-6, totalItems / lockFreeSeconds * 1E-6);
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
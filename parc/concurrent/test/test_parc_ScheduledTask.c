@@ -108,8 +108,24 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Object)
 
 LONGBOW_TEST_CASE(Object,  parcScheduledTask_Compare)
 {
-    testUnimplemented("");
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+
+    PARCScheduledTask *x = parcScheduledTask_Create(task, 2);
+    PARCScheduledTask *y = parcScheduledTask_Create(task, 2);
+    PARCScheduledTask *earlier = parcScheduledTask_Create(task, 1);
+    PARCScheduledTask *later = parcScheduledTask_Create(task, 3);
+
+    PARCScheduledTask *equivalent[] = { x, y, NULL };
+    PARCScheduledTask *lesser[] = { earlier, NULL };
+    PARCScheduledTask *greater[] = { later, NULL };
+
+    parcObjectTesting_AssertCompareTo(parcScheduledTask_Compare, x, equivalent, lesser, greater);
 
+    parcScheduledTask_Release(&x);
+    parcScheduledTask_Release(&y);
+    parcScheduledTask_Release(&earlier);
+    parcScheduledTask_Release(&later);
+    parcFutureTask_Release(&task);
 }
 
 LONGBOW_TEST_CASE(Object, parcScheduledTask_Copy)
@@ -11,14 +11,20 @@
  */
 #include "../parc_ScheduledThreadPool.c"
 
+#include <sys/time.h>
+#include <unistd.h>
+#include <inttypes.h>
+
 #include <LongBow/testing.h>
 #include <LongBow/debugging.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_StdlibMemory.h>
 #include <parc/algol/parc_DisplayIndented.h>
 
 #include <parc/testing/parc_MemoryTesting.h>
 #include <parc/testing/parc_ObjectTesting.h>
+#include <parc/concurrent/parc_AtomicUint64.h>
 
 LONGBOW_TEST_RUNNER(parc_ScheduledThreadPool)
 {
@@ -28,6 +34,7 @@ LONGBOW_TEST_RUNNER(parc_ScheduledThreadPool)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(Object);
     LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -210,6 +217,13 @@ LONGBOW_TEST_FIXTURE(Specialization)
     LONGBOW_RUN_TEST_CASE(Specialization, OneJob);
     LONGBOW_RUN_TEST_CASE(Specialization, Idle);
     LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_Order);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_Runs);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_AfterShutdown);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_Remove);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledTask_Cancel_Removes);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledTask_Cancel_RemoveOnCancelPolicy);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcScheduledThreadPool_GetQueue);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Specialization)
@@ -253,7 +267,8 @@ LONGBOW_TEST_CASE(Specialization, OneJob)
     
     PARCFutureTask *task = parcFutureTask_Create(_function, _function);
     
-    parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(2000));
+    PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(2000));
+    parcScheduledTask_Release(&scheduled);
     printf("references %lld\n", parcObject_GetReferenceCount(task));
     parcFutureTask_Release(&task);
     
@@ -270,7 +285,8 @@ LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule)
     
     PARCFutureTask *task = parcFutureTask_Create(_function, _function);
     
-    parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(2000));
+    PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(2000));
+    parcScheduledTask_Release(&scheduled);
     
     parcFutureTask_Release(&task);
     
@@ -285,6 +301,265 @@ LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule)
     parcScheduledThreadPool_Release(&pool);
 }
 
+static void
+_assertQueueIsValid(const PARCScheduledThreadPool *pool)
+{
+    for (size_t i = 0; i < pool->queueSize; i++) {
+        const _PARCScheduledThreadPoolEntry *entry = &pool->queue[i];
+        assertTrue(entry->link->index == i, "Expected entry %zu to record its position, actual %zu", i, entry->link->index);
+        assertTrue(entry->link->pool == pool, "Expected entry %zu to record its pool", i);
+        assertTrue(entry->executionTime == parcScheduledTask_GetExecutionTime(entry->task), "Expected entry %zu to cache its task's execution time", i);
+        if (i > 0) {
+            const _PARCScheduledThreadPoolEntry *parent = &pool->queue[(i - 1) / _PARCScheduledThreadPool_Arity];
+            assertTrue(parent->executionTime <= entry->executionTime, "Expected entry %zu to be no earlier than its parent", i);
+        }
+    }
+}
+
+// Far enough in the future that the timer thread never fires during a test.
+#define AN_HOUR (3600 * 1000000000ULL)
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_Order)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_NanoSeconds(AN_HOUR + (i * 7919) % 1000));
+        parcScheduledTask_Release(&scheduled);
+    }
+
+    if (parcObject_Lock(pool)) {
+        _assertQueueIsValid(pool);
+        assertTrue(pool->queueSize == 1000, "Expected 1000 queued tasks, actual %zu", pool->queueSize);
+
+        uint64_t previous = 0;
+        while (pool->queueSize > 0) {
+            PARCScheduledTask *first = _parcScheduledThreadPool_RemoveAt(pool, 0);
+            uint64_t executionTime = parcScheduledTask_GetExecutionTime(first);
+            assertTrue(executionTime >= previous, "Expected the tasks to leave the queue in order of execution time.");
+            previous = executionTime;
+            parcScheduledTask_Release(&first);
+            if (pool->queueSize % 97 == 0) {
+                _assertQueueIsValid(pool);
+            }
+        }
+        parcObject_Unlock(pool);
+    }
+
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+static void *
+_count(PARCFutureTask *task, void *parameter)
+{
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    return parameter;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_Runs)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(2);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    PARCFutureTask *task = parcFutureTask_Create(_count, counter);
+
+    for (int i = 0; i < 100; i++) {
+        PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_MilliSeconds(i % 20));
+        parcScheduledTask_Release(&scheduled);
+    }
+
+    for (int i = 0; i < 500 && parcAtomicUint64_GetValue(counter) < 100; i++) {
+        usleep(10000);
+    }
+    assertTrue(parcAtomicUint64_GetValue(counter) == 100, "Expected 100 tasks to run, actual %" PRIu64, parcAtomicUint64_GetValue(counter));
+
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcAtomicUint64_Release(&counter);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Schedule_AfterShutdown)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    parcScheduledThreadPool_ShutdownNow(pool);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, PARCTimeout_Immediate);
+    bool refused = (scheduled == NULL);
+    if (!refused) {
+        parcScheduledTask_Release(&scheduled);
+    }
+    assertTrue(refused, "Expected a shut down pool to refuse the task.");
+
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_Remove)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+
+    PARCScheduledTask *scheduled[500];
+    for (uint64_t i = 0; i < 500; i++) {
+        scheduled[i] = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_NanoSeconds(AN_HOUR + (i * 7919) % 500));
+    }
+
+    for (int i = 0; i < 500; i += 2) {
+        assertTrue(parcScheduledThreadPool_Remove(pool, scheduled[i]), "Expected task %d to be removed.", i);
+        assertFalse(parcScheduledThreadPool_Remove(pool, scheduled[i]), "Expected task %d to be removed only once.", i);
+    }
+
+    if (parcObject_Lock(pool)) {
+        assertTrue(pool->queueSize == 250, "Expected 250 queued tasks, actual %zu", pool->queueSize);
+        _assertQueueIsValid(pool);
+        parcObject_Unlock(pool);
+    }
+
+    for (int i = 0; i < 500; i++) {
+        parcScheduledTask_Release(&scheduled[i]);
+    }
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledTask_Cancel_Removes)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+
+    PARCFutureTask *cancelled = parcFutureTask_Create(_function, _function);
+    PARCReferenceCount poolReferences = parcObject_GetReferenceCount(pool);
+    PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, cancelled, parcTimeout_NanoSeconds(AN_HOUR));
+    PARCScheduledTask *other = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_NanoSeconds(AN_HOUR));
+    assertTrue(parcObject_GetReferenceCount(pool) == poolReferences + 2, "Expected each queued task to hold a reference to the pool.");
+
+    assertTrue(parcScheduledTask_Cancel(scheduled, false), "Expected the task to be cancelled.");
+    assertTrue(parcObject_GetReferenceCount(pool) == poolReferences + 1, "Expected the cancelled task to release its reference to the pool.");
+    assertTrue(parcScheduledTask_IsCancelled(scheduled), "Expected the task to be cancelled.");
+    assertNull(internal_parcScheduledTask_GetLink(scheduled)->pool, "Expected the task to have left the queue.");
+    assertTrue(parcObject_GetReferenceCount(scheduled) == 1, "Expected the pool to have released the cancelled task.");
+
+    if (parcObject_Lock(pool)) {
+        assertTrue(pool->queueSize == 1, "Expected only the other task to remain queued, actual %zu", pool->queueSize);
+        _assertQueueIsValid(pool);
+        parcObject_Unlock(pool);
+    }
+
+    parcScheduledTask_Release(&other);
+    parcScheduledTask_Release(&scheduled);
+    parcFutureTask_Release(&cancelled);
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledTask_Cancel_RemoveOnCancelPolicy)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    parcScheduledThreadPool_SetRemoveOnCancelPolicy(pool, false);
+    assertFalse(parcScheduledThreadPool_GetRemoveOnCancelPolicy(pool), "Expected the policy to be cleared.");
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+    PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_NanoSeconds(AN_HOUR));
+
+    assertTrue(parcScheduledTask_Cancel(scheduled, false), "Expected the task to be cancelled.");
+    assertTrue(internal_parcScheduledTask_GetLink(scheduled)->pool == pool, "Expected the cancelled task to stay queued.");
+
+    parcScheduledTask_Release(&scheduled);
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcScheduledThreadPool_GetQueue)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+    PARCFutureTask *task = parcFutureTask_Create(_function, _function);
+
+    for (uint64_t i = 0; i < 100; i++) {
+        PARCScheduledTask *scheduled = parcScheduledThreadPool_Schedule(pool, task, parcTimeout_NanoSeconds(AN_HOUR + (i * 37) % 100));
+        parcScheduledTask_Release(&scheduled);
+    }
+
+    PARCSortedList *queue = parcScheduledThreadPool_GetQueue(pool);
+    assertTrue(parcSortedList_Size(queue) == 100, "Expected 100 queued tasks, actual %zu", parcSortedList_Size(queue));
+    for (size_t i = 1; i < 100; i++) {
+        PARCScheduledTask *previous = parcSortedList_GetAtIndex(queue, i - 1);
+        PARCScheduledTask *next = parcSortedList_GetAtIndex(queue, i);
+        assertTrue(parcScheduledTask_GetExecutionTime(previous) <= parcScheduledTask_GetExecutionTime(next), "Expected the queue in order of execution time.");
+    }
+    parcSortedList_Release(&queue);
+
+    parcFutureTask_Release(&task);
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcScheduledThreadPool_ScheduleCancel_Rate);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcMemory_SetInterface(&PARCStdlibMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Performance, parcScheduledThreadPool_ScheduleCancel_Rate)
+{
+    PARCScheduledThreadPool *pool = parcScheduledThreadPool_Create(1);
+
+    for (size_t count = 1000; count <= 100000; count *= 10) {
+        // Each timer needs its own PARCFutureTask, since a PARCFutureTask can be cancelled only once.
+        PARCFutureTask **tasks = parcMemory_Allocate(count * sizeof(PARCFutureTask *));
+        PARCScheduledTask **scheduled = parcMemory_Allocate(count * sizeof(PARCScheduledTask *));
+        for (size_t i = 0; i < count; i++) {
+            tasks[i] = parcFutureTask_Create(_function, _function);
+        }
+
+        struct timeval start;
+        gettimeofday(&start, NULL);
+        for (size_t i = 0; i < count; i++) {
+            scheduled[i] = parcScheduledThreadPool_Schedule(pool, tasks[i], parcTimeout_NanoSeconds(AN_HOUR + (i * 7919) % count));
+        }
+        struct timeval scheduledTime;
+        gettimeofday(&scheduledTime, NULL);
+        for (size_t i = 0; i < count; i++) {
+            parcScheduledTask_Cancel(scheduled[i], false);
+        }
+        struct timeval end;
+        gettimeofday(&end, NULL);
+
+        timersub(&end, &scheduledTime, &end);
+        timersub(&scheduledTime, &start, &scheduledTime);
+        printf("%7zu timers: Schedule %.3f usec/op, Cancel %.3f usec/op\n", count,
+               (scheduledTime.tv_sec * 1000000.0 + scheduledTime.tv_usec) / count,
+               (end.tv_sec * 1000000.0 + end.tv_usec) / count);
+
+        for (size_t i = 0; i < count; i++) {
+            parcScheduledTask_Release(&scheduled[i]);
+            parcFutureTask_Release(&tasks[i]);
+        }
+        parcMemory_Deallocate(&scheduled);
+        parcMemory_Deallocate(&tasks);
+    }
+
+    parcScheduledThreadPool_ShutdownNow(pool);
+    parcScheduledThreadPool_Release(&pool);
+}
+
 int
 main(int argc, char *argv[argc])
 {
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_Thread.c"
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/concurrent/parc_AtomicUint64.h>
+
+#include <parc/testing/parc_MemoryTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_Thread)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_Thread)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_Thread)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_Start);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetName);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetName_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetName_Running);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_ToString);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetAffinity);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetAffinity_Running);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_SetAffinity_Offline);
+    LONGBOW_RUN_TEST_CASE(Global, parcThread_GetAffinity_NotStarted);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    longBowTestCase_SetInt(testCase, "initialAllocations", parcMemory_Outstanding());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    int initialAllocations = longBowTestCase_GetInt(testCase, "initialAllocations");
+    if (!parcMemoryTesting_ExpectedOutstanding(initialAllocations, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// What the thread under test saw of itself.
+static char _observedName[16];
+static int _observedCpuCount;
+static int _observedCpu;
+
+static void *
+_observe(PARCThread *thread, PARCObject *parameter)
+{
+    pthread_getname_np(pthread_self(), _observedName, sizeof(_observedName));
+#if __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    _observedCpuCount = CPU_COUNT(&set);
+    _observedCpu = sched_getcpu();
+#endif
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    return NULL;
+}
+
+/*
+ * Run until cancelled, so the test can act on a running thread.
+ */
+static void *
+_runUntilCancelled(PARCThread *thread, PARCObject *parameter)
+{
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    if (parcThread_Lock(thread)) {
+        while (parcThread_IsCancelled(thread) == false) {
+            parcThread_Wait(thread);
+        }
+        parcThread_Unlock(thread);
+    }
+    return NULL;
+}
+
+static void
+_awaitRunning(PARCAtomicUint64 *started)
+{
+    while (parcAtomicUint64_GetValue(started) == 0) {
+        sched_yield();
+    }
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_Start)
+{
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+    parcThread_Start(thread);
+    parcThread_Join(thread);
+
+    assertTrue(parcAtomicUint64_GetValue(ran) == 1, "Expected the run function to be called once.");
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetName)
+{
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+    assertNull(parcThread_GetName(thread), "Expected a new thread to have no name.");
+    parcThread_SetName(thread, "reactor");
+    assertTrue(strcmp(parcThread_GetName(thread), "reactor") == 0, "Expected 'reactor', actual '%s'", parcThread_GetName(thread));
+
+    parcThread_Start(thread);
+    parcThread_Join(thread);
+
+#if __linux__
+    assertTrue(strcmp(_observedName, "reactor") == 0, "Expected the thread to see its name 'reactor', actual '%s'", _observedName);
+#endif
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetName_Truncated)
+{
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+    parcThread_SetName(thread, "abcdefghijklmnopqrstuvwxyz");
+    assertTrue(strcmp(parcThread_GetName(thread), "abcdefghijklmno") == 0,
+               "Expected the name to be cut to 15 characters, actual '%s'", parcThread_GetName(thread));
+
+    parcThread_Start(thread);
+    parcThread_Join(thread);
+
+#if __linux__
+    assertTrue(strcmp(_observedName, "abcdefghijklmno") == 0, "Expected the truncated name to be applied, actual '%s'", _observedName);
+#endif
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetName_Running)
+{
+    PARCAtomicUint64 *started = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_runUntilCancelled, started);
+
+    parcThread_Start(thread);
+    _awaitRunning(started);
+    parcThread_SetName(thread, "stage-2");
+
+#if __linux__
+    char name[16];
+    pthread_getname_np(thread->thread, name, sizeof(name));
+    assertTrue(strcmp(name, "stage-2") == 0, "Expected the running thread to be renamed, actual '%s'", name);
+#endif
+
+    parcThread_Cancel(thread);
+    parcThread_Join(thread);
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&started);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_ToString)
+{
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+    parcThread_SetName(thread, "reactor");
+
+    char *string = parcThread_ToString(thread);
+    assertNotNull(strstr(string, ".name=\"reactor\""), "Expected the name in the string, actual %s", string);
+
+    parcMemory_Deallocate(&string);
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetAffinity)
+{
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    int cpu = parcBitVector_NextBitSet(online, 0);
+    parcBitVector_Release(&online);
+
+    PARCBitVector *cpus = parcBitVector_Create();
+    parcBitVector_Set(cpus, cpu);
+
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+#if __linux__
+    assertTrue(parcThread_SetAffinity(thread, cpus), "Expected the thread to accept an online CPU.");
+
+    parcThread_Start(thread);
+    parcThread_Join(thread);
+
+    assertTrue(_observedCpuCount == 1, "Expected the thread to run on one CPU, actual %d", _observedCpuCount);
+    assertTrue(_observedCpu == cpu, "Expected the thread to run on CPU %d, actual %d", cpu, _observedCpu);
+#else
+    assertFalse(parcThread_SetAffinity(thread, cpus), "Expected pinning to be unsupported.");
+#endif
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetAffinity_Running)
+{
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    int cpu = parcBitVector_NextBitSet(online, 0);
+    parcBitVector_Release(&online);
+
+    PARCBitVector *cpus = parcBitVector_Create();
+    parcBitVector_Set(cpus, cpu);
+
+    PARCAtomicUint64 *started = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_runUntilCancelled, started);
+    parcThread_Start(thread);
+    _awaitRunning(started);
+
+#if __linux__
+    assertTrue(parcThread_SetAffinity(thread, cpus), "Expected a running thread to be pinned.");
+
+    PARCBitVector *actual = parcThread_GetAffinity(thread);
+    assertTrue(parcBitVector_Equals(actual, cpus), "Expected the thread's CPUs to be %s, actual %s",
+               parcBitVector_ToString(cpus), parcBitVector_ToString(actual));
+    parcBitVector_Release(&actual);
+#endif
+
+    parcThread_Cancel(thread);
+    parcThread_Join(thread);
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&started);
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_SetAffinity_Offline)
+{
+    PARCBitVector *cpus = parcBitVector_Create();
+    parcBitVector_Set(cpus, 8000);
+
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+    assertFalse(parcThread_SetAffinity(thread, cpus), "Expected a set of offline CPUs to be refused.");
+    assertNull(parcThread_GetAffinity(thread), "Expected a refused set not to be kept.");
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+    parcBitVector_Release(&cpus);
+}
+
+LONGBOW_TEST_CASE(Global, parcThread_GetAffinity_NotStarted)
+{
+    PARCAtomicUint64 *ran = parcAtomicUint64_Create(0);
+    PARCThread *thread = parcThread_Create(_observe, ran);
+
+    assertNull(parcThread_GetAffinity(thread), "Expected no CPUs to be known for a thread that was neither started nor pinned.");
+
+#if __linux__
+    PARCBitVector *cpus = parcCpuTopology_ParseCpuList("0");
+    parcThread_SetAffinity(thread, cpus);
+
+    PARCBitVector *actual = parcThread_GetAffinity(thread);
+    assertTrue(parcBitVector_Equals(actual, cpus), "Expected the CPUs given to parcThread_SetAffinity.");
+    assertFalse(actual == cpus, "Expected a copy.");
+
+    parcBitVector_Release(&actual);
+    parcBitVector_Release(&cpus);
+#endif
+
+    parcThread_Release(&thread);
+    parcAtomicUint64_Release(&ran);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_Thread);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
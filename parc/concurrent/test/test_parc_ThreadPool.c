@@ -11,11 +11,17 @@
  */
 #include "../parc_ThreadPool.c"
 
+#include <sys/time.h>
+#include <unistd.h>
+#include <inttypes.h>
+
 #include <LongBow/testing.h>
 #include <LongBow/debugging.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_DisplayIndented.h>
+#include <parc/concurrent/parc_CpuTopology.h>
+#include <parc/algol/parc_Time.h>
 
 #include <parc/testing/parc_MemoryTesting.h>
 #include <parc/testing/parc_ObjectTesting.h>
@@ -28,6 +34,9 @@ LONGBOW_TEST_RUNNER(parc_ThreadPool)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(Object);
     LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Bounded);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -202,6 +211,13 @@ LONGBOW_TEST_CASE(Object, parcThreadPool_ToString)
 LONGBOW_TEST_FIXTURE(Specialization)
 {
     LONGBOW_RUN_TEST_CASE(Object, parcThreadPool_Execute);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_Execute_Many);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_Execute_Recursive);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_Execute_FromWorker);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_Execute_AfterShutdown);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_ShutdownNow_Pending);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_WorkerNames);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcThreadPool_CreateWithAffinity);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Specialization)
@@ -248,6 +264,810 @@ LONGBOW_TEST_CASE(Object, parcThreadPool_Execute)
     parcThreadPool_Release(&pool);
 }
 
+static void *
+_count(PARCFutureTask *task, void *parameter)
+{
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    return parameter;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_Execute_Many)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    for (int i = 0; i < 1000; i++) {
+        PARCFutureTask *task = parcFutureTask_Create(_count, counter);
+        assertTrue(parcThreadPool_Execute(pool, task), "Expected the task to be accepted.");
+        parcFutureTask_Release(&task);
+    }
+
+    parcThreadPool_Shutdown(pool);
+    assertTrue(parcThreadPool_AwaitTermination(pool, PARCTimeout_Never), "Expected the pool to terminate.");
+    assertTrue(parcThreadPool_IsTerminated(pool), "Expected the pool to be terminated.");
+
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1000, "Expected 1000 tasks to run, actual %" PRIu64, parcAtomicUint64_GetValue(counter));
+    assertTrue(parcThreadPool_GetCompletedTaskCount(pool) == 1000, "Expected 1000 completed tasks.");
+    assertTrue(parcThreadPool_GetTaskCount(pool) == 1000, "Expected 1000 tasks.");
+
+    parcAtomicUint64_Release(&counter);
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+static PARCThreadPool *_fanOutPool;
+static PARCAtomicUint64 *_fanOutCount;
+
+/*
+ * Each task counts itself and adds two children until the given depth is exhausted.
+ */
+static void *
+_fanOut(PARCFutureTask *task, void *parameter)
+{
+    uint64_t depth = parcAtomicUint64_GetValue((PARCAtomicUint64 *) parameter);
+    parcAtomicUint64_Increment(_fanOutCount);
+
+    if (depth > 0) {
+        for (int i = 0; i < 2; i++) {
+            PARCAtomicUint64 *childDepth = parcAtomicUint64_Create(depth - 1);
+            PARCFutureTask *child = parcFutureTask_Create(_fanOut, childDepth);
+            parcThreadPool_Execute(_fanOutPool, child);
+            parcFutureTask_Release(&child);
+            parcAtomicUint64_Release(&childDepth);
+        }
+    }
+    return NULL;
+}
+
+static uint64_t
+_fanOutRun(PARCThreadPool *pool, uint64_t depth, int roots)
+{
+    _fanOutPool = pool;
+    _fanOutCount = parcAtomicUint64_Create(0);
+
+    for (int i = 0; i < roots; i++) {
+        PARCAtomicUint64 *rootDepth = parcAtomicUint64_Create(depth);
+        PARCFutureTask *root = parcFutureTask_Create(_fanOut, rootDepth);
+        parcThreadPool_Execute(pool, root);
+        parcFutureTask_Release(&root);
+        parcAtomicUint64_Release(&rootDepth);
+    }
+
+    // Tasks that are running may still add children after the pool is shut down.
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    uint64_t result = parcAtomicUint64_GetValue(_fanOutCount);
+    parcAtomicUint64_Release(&_fanOutCount);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_Execute_Recursive)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+
+    uint64_t count = _fanOutRun(pool, 10, 1);
+    assertTrue(count == 2047, "Expected 2047 tasks to run, actual %" PRIu64, count);
+    assertTrue(parcThreadPool_GetCompletedTaskCount(pool) == 2047, "Expected 2047 completed tasks.");
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+static bool _executedLocally;
+
+static void *
+_executeFromWorker(PARCFutureTask *task, void *parameter)
+{
+    PARCThreadPool *pool = (PARCThreadPool *) parameter;
+    _PARCThreadPoolWorker *worker = _parcThreadPool_CurrentWorker;
+
+    PARCFutureTask *child = parcFutureTask_Create(_function, NULL);
+    parcThreadPool_Execute(pool, child);
+    parcFutureTask_Release(&child);
+
+    // With a single worker nothing can steal the child, so it must still be in this worker's deque.
+    _executedLocally = worker != NULL && worker->deque.bottom - worker->deque.top == 1 && parcLinkedList_Size(pool->workQueue) == 0;
+
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_Execute_FromWorker)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(1);
+    _executedLocally = false;
+
+    PARCFutureTask *task = parcFutureTask_Create(_executeFromWorker, pool);
+    parcThreadPool_Execute(pool, task);
+    parcFutureTask_Release(&task);
+
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+
+    assertTrue(_executedLocally, "Expected a task executed by a worker to go to the worker's own deque.");
+    assertTrue(parcThreadPool_GetCompletedTaskCount(pool) == 2, "Expected both tasks to run.");
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_Execute_AfterShutdown)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(2);
+
+    parcThreadPool_Shutdown(pool);
+    assertTrue(parcThreadPool_IsShutdown(pool), "Expected the pool to be shut down.");
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, NULL);
+    assertFalse(parcThreadPool_Execute(pool, task), "Expected a task from outside the pool to be rejected after shutdown.");
+    parcFutureTask_Release(&task);
+
+    assertTrue(parcThreadPool_AwaitTermination(pool, parcTimeout_MilliSeconds(1000)), "Expected an idle pool to terminate.");
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+static void *
+_sleep(PARCFutureTask *task, void *parameter)
+{
+    usleep(1000);
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_ShutdownNow_Pending)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(1);
+
+    for (int i = 0; i < 100; i++) {
+        PARCFutureTask *task = parcFutureTask_Create(_sleep, NULL);
+        parcThreadPool_Execute(pool, task);
+        parcFutureTask_Release(&task);
+    }
+
+    // The tasks not yet run are released, which the fixture's memory check verifies.
+    parcThreadPool_ShutdownNow(pool);
+    assertTrue(parcThreadPool_IsTerminated(pool), "Expected the pool to be terminated.");
+    assertTrue(parcThreadPool_GetCompletedTaskCount(pool) < 100, "Expected some tasks not to run.");
+
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_WorkerNames)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(3);
+
+    for (int i = 0; i < 3; i++) {
+        char expected[16];
+        snprintf(expected, sizeof(expected), "PARCPool-%d", i);
+        const char *actual = parcThread_GetName(pool->workers[i].thread);
+        assertTrue(strcmp(actual, expected) == 0, "Expected worker %d to be named '%s', actual '%s'", i, expected, actual);
+    }
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+static void *
+_recordCpu(PARCFutureTask *task, void *parameter)
+{
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    return (void *) (intptr_t) parcCpuTopology_GetCurrentCpu();
+}
+
+LONGBOW_TEST_CASE(Specialization, parcThreadPool_CreateWithAffinity)
+{
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    int cpu = parcBitVector_NextBitSet(online, 0);
+    parcBitVector_Release(&online);
+
+    PARCBitVector *cpus = parcBitVector_Create();
+    parcBitVector_Set(cpus, cpu);
+    PARCBitVector *cpuSets[] = { cpus, cpus };
+
+    PARCThreadPool *pool = parcThreadPool_CreateWithAffinity(2, cpuSets);
+    parcBitVector_Release(&cpus);
+
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    PARCFutureTask *tasks[100];
+    for (int i = 0; i < 100; i++) {
+        tasks[i] = parcFutureTask_Create(_recordCpu, counter);
+        parcThreadPool_Execute(pool, tasks[i]);
+    }
+    parcThreadPool_Shutdown(pool);
+    assertTrue(parcThreadPool_AwaitTermination(pool, PARCTimeout_Never), "Expected the pool to terminate.");
+
+#if __linux__
+    for (int i = 0; i < 100; i++) {
+        PARCFutureTaskResult result = parcFutureTask_Get(tasks[i], PARCTimeout_Immediate);
+        assertTrue(result.execution == PARCExecution_OK, "Expected task %d to have run.", i);
+        int actual = (int) (intptr_t) result.value;
+        assertTrue(actual == cpu, "Expected task %d to run on CPU %d, actual %d", i, cpu, actual);
+    }
+    for (int i = 0; i < 2; i++) {
+        assertTrue(pool->workers[i].isPinned, "Expected worker %d to be pinned.", i);
+        assertNotNull(pool->workers[i].deque.array->previous, "Expected worker %d to have relocated its deque.", i);
+    }
+#endif
+    for (int i = 0; i < 100; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+    assertTrue(parcAtomicUint64_GetValue(counter) == 100, "Expected 100 tasks to run.");
+
+    parcAtomicUint64_Release(&counter);
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_FIXTURE(Bounded)
+{
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_CreateBounded);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_Grow);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_Reject);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_Reject_Capacity);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_CallerRuns);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_DiscardOldest);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_Block);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_Execute_Block_Timeout);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_KeepAlive);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_SetAllowCoreThreadTimeOut);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_SetAllowCoreThreadTimeOut_Pinned);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_SetMaximumPoolSize);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_SetCorePoolSize);
+    LONGBOW_RUN_TEST_CASE(Bounded, parcThreadPool_PrestartCoreThread);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Bounded)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Bounded)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s mismanaged memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Hold a worker until the gate, the parameter, is opened.
+ */
+static void *
+_awaitGate(PARCFutureTask *task, void *parameter)
+{
+    while (parcAtomicUint64_GetValue((PARCAtomicUint64 *) parameter) == 0) {
+        usleep(1000);
+    }
+    return parameter;
+}
+
+static void
+_executeGate(PARCThreadPool *pool, PARCAtomicUint64 *gate)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_awaitGate, gate);
+    assertTrue(parcThreadPool_Execute(pool, task), "Expected the gate task to be accepted.");
+    parcFutureTask_Release(&task);
+}
+
+static bool
+_executeCount(PARCThreadPool *pool, PARCAtomicUint64 *counter)
+{
+    PARCFutureTask *task = parcFutureTask_Create(_count, counter);
+    bool result = parcThreadPool_Execute(pool, task);
+    parcFutureTask_Release(&task);
+    return result;
+}
+
+static void
+_shutdownAndRelease(PARCThreadPool **poolPtr)
+{
+    parcThreadPool_Shutdown(*poolPtr);
+    assertTrue(parcThreadPool_AwaitTermination(*poolPtr, parcTimeout_MilliSeconds(5000)), "Expected the pool to terminate.");
+    parcThreadPool_Release(poolPtr);
+}
+
+/*
+ * Poll until the pool has the given number of workers, or a few seconds pass.
+ */
+static int
+_awaitPoolSize(const PARCThreadPool *pool, int expected)
+{
+    for (int i = 0; i < 5000 && parcThreadPool_GetPoolSize(pool) != expected; i++) {
+        usleep(1000);
+    }
+    return parcThreadPool_GetPoolSize(pool);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_CreateBounded)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(2, 4, 10);
+
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 0, "Expected no workers before any task, actual %d", parcThreadPool_GetPoolSize(pool));
+    assertTrue(parcThreadPool_GetCorePoolSize(pool) == 2, "Expected a core pool size of 2.");
+    assertTrue(parcThreadPool_GetMaximumPoolSize(pool) == 4, "Expected a maximum pool size of 4.");
+    assertTrue(parcThreadPool_GetQueueCapacity(pool) == 10, "Expected a queue capacity of 10.");
+    assertTrue(parcThreadPool_GetRejectionPolicy(pool) == PARCThreadPoolRejectionPolicy_Reject, "Expected tasks to be rejected by default.");
+    assertTrue(parcTimeout_InNanoSeconds(parcThreadPool_GetKeepAliveTime(pool)) == 60000000000ULL, "Expected a keep-alive time of 60 seconds.");
+
+    parcThreadPool_SetKeepAliveTime(pool, PARCTimeout_Never);
+    assertTrue(parcTimeout_IsNever(parcThreadPool_GetKeepAliveTime(pool)), "Expected the keep-alive time to be Never.");
+
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    assertTrue(_executeCount(pool, counter), "Expected the task to be accepted.");
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 1, "Expected a worker to be started for the task, actual %d", parcThreadPool_GetPoolSize(pool));
+
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the task to run.");
+    parcAtomicUint64_Release(&counter);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_Grow)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 3, 1);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);                                  // The core worker.
+    assertTrue(_executeCount(pool, counter), "Expected the task to be queued.");
+    _executeGate(pool, gate);                                  // The queue is full, so a second worker starts.
+    _executeGate(pool, gate);                                  // And a third.
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 3, "Expected 3 workers, actual %d", parcThreadPool_GetPoolSize(pool));
+    assertFalse(_executeCount(pool, counter), "Expected the task to be rejected by a full pool.");
+    assertTrue(parcThreadPool_GetRejectedTaskCount(pool) == 1, "Expected 1 rejected task.");
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the queued task to run.");
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_Reject)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 1);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);
+    assertTrue(_executeCount(pool, counter), "Expected the task to be queued.");
+    assertFalse(_executeCount(pool, counter), "Expected the task to be rejected.");
+    assertTrue(parcThreadPool_GetLargestPoolSize(pool) == 1, "Expected no more than 1 worker.");
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected only the queued task to run, actual %" PRIu64, parcAtomicUint64_GetValue(counter));
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_Reject_Capacity)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 8);
+    PARCAtomicUint64 *first = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, first);
+    for (int i = 0; i < 8; i++) {
+        _executeGate(pool, gate);
+    }
+
+    // Let the only worker take from the full queue, after which it is held at the second gate.
+    parcAtomicUint64_Increment(first);
+    for (int i = 0; i < 5000 && parcLinkedList_Size(parcThreadPool_GetQueue(pool)) == 8; i++) {
+        usleep(1000);
+    }
+
+    // The tasks the worker took but has not started still count against the capacity.
+    int accepted = 0;
+    while (accepted < 100 && _executeCount(pool, counter)) {
+        accepted++;
+    }
+    assertTrue(accepted == 1, "Expected room for exactly 1 more task, actual %d", accepted);
+    assertTrue(parcThreadPool_GetRejectedTaskCount(pool) == 1, "Expected 1 rejected task.");
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the accepted task to run, actual %" PRIu64, parcAtomicUint64_GetValue(counter));
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+    parcAtomicUint64_Release(&first);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_CallerRuns)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 1);
+    parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_CallerRuns, PARCTimeout_Never);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);
+    PARCAtomicUint64 *queued = parcAtomicUint64_Create(0);
+    assertTrue(_executeCount(pool, queued), "Expected the task to be queued.");
+
+    // The only worker is held at the gate, so only this thread can have run the task.
+    assertTrue(_executeCount(pool, counter), "Expected the task to be run by its submitter.");
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the task to have run before parcThreadPool_Execute returned.");
+    assertTrue(parcThreadPool_GetRejectedTaskCount(pool) == 1, "Expected the task to be counted as rejected.");
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(queued) == 1, "Expected the queued task to run.");
+    parcAtomicUint64_Release(&queued);
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_DiscardOldest)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 1);
+    parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_DiscardOldest, PARCTimeout_Never);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *oldCounter = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *newCounter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);
+    PARCFutureTask *oldest = parcFutureTask_Create(_count, oldCounter);
+    assertTrue(parcThreadPool_Execute(pool, oldest), "Expected the task to be queued.");
+    assertTrue(_executeCount(pool, newCounter), "Expected the new task to take the place of the oldest.");
+    assertTrue(parcFutureTask_IsCancelled(oldest), "Expected the oldest task to be cancelled.");
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(oldCounter) == 0, "Expected the discarded task not to run.");
+    assertTrue(parcAtomicUint64_GetValue(newCounter) == 1, "Expected the new task to run.");
+    parcFutureTask_Release(&oldest);
+    parcAtomicUint64_Release(&oldCounter);
+    parcAtomicUint64_Release(&newCounter);
+    parcAtomicUint64_Release(&gate);
+}
+
+static void *
+_sleepThenCount(PARCFutureTask *task, void *parameter)
+{
+    usleep(50000);
+    parcAtomicUint64_Increment((PARCAtomicUint64 *) parameter);
+    return parameter;
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_Block)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 1);
+    parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_Block, parcTimeout_MilliSeconds(5000));
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    // The worker is busy for 50 milliseconds, and then takes the queued task, making room for the blocked one.
+    PARCFutureTask *task = parcFutureTask_Create(_sleepThenCount, counter);
+    parcThreadPool_Execute(pool, task);
+    parcFutureTask_Release(&task);
+    assertTrue(_executeCount(pool, counter), "Expected the task to be queued.");
+
+    uint64_t start = parcTime_NowNanoseconds();
+    assertTrue(_executeCount(pool, counter), "Expected the submitter to wait for room.");
+    uint64_t waited = parcTime_NowNanoseconds() - start;
+    assertTrue(waited >= 10000000, "Expected the submitter to be held back, it waited %" PRIu64 " nanoseconds", waited);
+
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 3, "Expected 3 tasks to run, actual %" PRIu64, parcAtomicUint64_GetValue(counter));
+    parcAtomicUint64_Release(&counter);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_Execute_Block_Timeout)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 1, 1);
+    parcThreadPool_SetRejectionPolicy(pool, PARCThreadPoolRejectionPolicy_Block, parcTimeout_MilliSeconds(50));
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);
+    assertTrue(_executeCount(pool, counter), "Expected the task to be queued.");
+
+    uint64_t start = parcTime_NowNanoseconds();
+    assertFalse(_executeCount(pool, counter), "Expected the task to be rejected when the timeout expires.");
+    uint64_t waited = parcTime_NowNanoseconds() - start;
+    assertTrue(waited >= 40000000, "Expected the submitter to wait for the timeout, it waited %" PRIu64 " nanoseconds", waited);
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected only the queued task to run.");
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_KeepAlive)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(0, 2, 10);
+    parcThreadPool_SetKeepAliveTime(pool, parcTimeout_MilliSeconds(10));
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    // With no core workers, a queued task still gets a worker.
+    assertTrue(_executeCount(pool, counter), "Expected the task to be accepted.");
+    int size = _awaitPoolSize(pool, 0);
+    assertTrue(size == 0, "Expected the idle worker to stop, actual pool size %d", size);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the task to run before the worker stopped.");
+
+    // And a new worker is started for the next task.
+    assertTrue(_executeCount(pool, counter), "Expected the task to be accepted.");
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 2, "Expected the second task to run.");
+    parcAtomicUint64_Release(&counter);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_SetAllowCoreThreadTimeOut)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(2);
+    parcThreadPool_SetKeepAliveTime(pool, parcTimeout_MilliSeconds(10));
+    usleep(30000);
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 2, "Expected core workers to stay, actual %d", parcThreadPool_GetPoolSize(pool));
+
+    parcThreadPool_SetAllowCoreThreadTimeOut(pool, true);
+    assertTrue(parcThreadPool_GetAllowsCoreThreadTimeOut(pool), "Expected core workers to be allowed to time out.");
+    int size = _awaitPoolSize(pool, 0);
+    assertTrue(size == 0, "Expected the idle core workers to stop, actual pool size %d", size);
+
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    assertTrue(_executeCount(pool, counter), "Expected the task to be accepted.");
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the task to run.");
+    parcAtomicUint64_Release(&counter);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_SetAllowCoreThreadTimeOut_Pinned)
+{
+    PARCBitVector *online = parcCpuTopology_GetOnlineCpus();
+    PARCBitVector *cpus = parcBitVector_Create();
+    parcBitVector_Set(cpus, parcBitVector_NextBitSet(online, 0));
+    parcBitVector_Release(&online);
+    PARCBitVector *cpuSets[] = { cpus };
+
+    PARCThreadPool *pool = parcThreadPool_CreateWithAffinity(1, cpuSets);
+    parcBitVector_Release(&cpus);
+    parcThreadPool_SetKeepAliveTime(pool, parcTimeout_MilliSeconds(10));
+    parcThreadPool_SetAllowCoreThreadTimeOut(pool, true);
+
+    // Each task starts a new thread in the same slot, which must not move the deque again.
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    for (int i = 0; i < 4; i++) {
+        int size = _awaitPoolSize(pool, 0);
+        assertTrue(size == 0, "Expected the idle worker to stop, actual pool size %d", size);
+        assertTrue(_executeCount(pool, counter), "Expected the task to be accepted.");
+    }
+    _awaitPoolSize(pool, 0);
+#if __linux__
+    assertTrue(pool->workers[0].isPinned, "Expected the worker to be pinned.");
+    assertNotNull(pool->workers[0].deque.array->previous, "Expected the worker to have relocated its deque.");
+    assertNull(pool->workers[0].deque.array->previous->previous, "Expected the deque to be relocated only once.");
+#endif
+
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 4, "Expected 4 tasks to run.");
+    parcAtomicUint64_Release(&counter);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_SetMaximumPoolSize)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(1, 3, 1);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+
+    _executeGate(pool, gate);
+    _executeCount(pool, counter);
+    _executeGate(pool, gate);
+    _executeGate(pool, gate);
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 3, "Expected 3 workers, actual %d", parcThreadPool_GetPoolSize(pool));
+
+    parcThreadPool_SetMaximumPoolSize(pool, 1);
+    assertTrue(parcThreadPool_GetMaximumPoolSize(pool) == 1, "Expected a maximum pool size of 1.");
+    parcAtomicUint64_Increment(gate);
+
+    int size = _awaitPoolSize(pool, 1);
+    assertTrue(size == 1, "Expected the workers beyond the maximum to stop, actual pool size %d", size);
+    assertTrue(parcThreadPool_GetLargestPoolSize(pool) == 3, "Expected the largest pool size to be 3.");
+
+    _shutdownAndRelease(&pool);
+    assertTrue(parcAtomicUint64_GetValue(counter) == 1, "Expected the queued task to run.");
+    parcAtomicUint64_Release(&counter);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_SetCorePoolSize)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(0, 4, 10);
+    parcThreadPool_SetKeepAliveTime(pool, PARCTimeout_Never);
+    PARCAtomicUint64 *gate = parcAtomicUint64_Create(0);
+
+    // The single worker started for the queue is held, so two more tasks wait in the queue.
+    _executeGate(pool, gate);
+    _executeGate(pool, gate);
+    _executeGate(pool, gate);
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 1, "Expected 1 worker, actual %d", parcThreadPool_GetPoolSize(pool));
+
+    parcThreadPool_SetCorePoolSize(pool, 3);
+    assertTrue(parcThreadPool_GetCorePoolSize(pool) == 3, "Expected a core pool size of 3.");
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 3, "Expected workers to be started for the queued tasks, actual %d", parcThreadPool_GetPoolSize(pool));
+
+    parcAtomicUint64_Increment(gate);
+    _shutdownAndRelease(&pool);
+    parcAtomicUint64_Release(&gate);
+}
+
+LONGBOW_TEST_CASE(Bounded, parcThreadPool_PrestartCoreThread)
+{
+    PARCThreadPool *pool = parcThreadPool_CreateBounded(3, 4, 10);
+
+    assertTrue(parcThreadPool_PrestartCoreThread(pool), "Expected a core worker to start.");
+    assertTrue(parcThreadPool_GetPoolSize(pool) == 1, "Expected 1 worker, actual %d", parcThreadPool_GetPoolSize(pool));
+    assertTrue(parcThreadPool_PrestartAllCoreThreads(pool) == 2, "Expected the 2 remaining core workers to start.");
+    assertFalse(parcThreadPool_PrestartCoreThread(pool), "Expected no worker beyond the core to be prestarted.");
+
+    _shutdownAndRelease(&pool);
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _parcThreadPoolDeque_TakeSteal);
+    LONGBOW_RUN_TEST_CASE(Local, _parcThreadPoolDeque_Grow);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s mismanaged memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _parcThreadPoolDeque_TakeSteal)
+{
+    _PARCThreadPoolDeque deque;
+    _parcThreadPoolDeque_Init(&deque);
+
+    PARCFutureTask *tasks[3];
+    for (int i = 0; i < 3; i++) {
+        tasks[i] = parcFutureTask_Create(_function, NULL);
+        _parcThreadPoolDeque_Push(&deque, tasks[i]);
+    }
+
+    assertTrue(_parcThreadPoolDeque_Steal(&deque) == tasks[0], "Expected a thief to take the oldest task.");
+    assertTrue(_parcThreadPoolDeque_Take(&deque) == tasks[2], "Expected the owner to take the newest task.");
+    assertTrue(_parcThreadPoolDeque_Take(&deque) == tasks[1], "Expected the owner to take the remaining task.");
+    assertNull(_parcThreadPoolDeque_Take(&deque), "Expected an empty deque.");
+    assertNull(_parcThreadPoolDeque_Steal(&deque), "Expected an empty deque.");
+
+    for (int i = 0; i < 3; i++) {
+        parcFutureTask_Release(&tasks[i]);
+    }
+    _parcThreadPoolDeque_Fini(&deque);
+}
+
+LONGBOW_TEST_CASE(Local, _parcThreadPoolDeque_Grow)
+{
+    _PARCThreadPoolDeque deque;
+    _parcThreadPoolDeque_Init(&deque);
+
+    PARCFutureTask *task = parcFutureTask_Create(_function, NULL);
+    size_t count = 10 * _PARCThreadPool_InitialDequeCapacity;
+
+    // Interleave steals so that the live range wraps around the array before it grows.
+    size_t stolen = 0;
+    for (size_t i = 0; i < count; i++) {
+        _parcThreadPoolDeque_Push(&deque, task);
+        if (i % 3 == 0) {
+            assertTrue(_parcThreadPoolDeque_Steal(&deque) == task, "Expected a task to steal.");
+            stolen++;
+        }
+    }
+    assertTrue(deque.array->mask + 1 > _PARCThreadPool_InitialDequeCapacity, "Expected the deque to grow.");
+
+    size_t taken = 0;
+    while (_parcThreadPoolDeque_Take(&deque) != NULL) {
+        taken++;
+    }
+    assertTrue(stolen + taken == count, "Expected %zu tasks, actual %zu", count, stolen + taken);
+
+    parcFutureTask_Release(&task);
+    _parcThreadPoolDeque_Fini(&deque);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcThreadPool_Execute_External);
+    LONGBOW_RUN_TEST_CASE(Performance, parcThreadPool_Execute_Recursive);
+    LONGBOW_RUN_TEST_CASE(Performance, parcThreadPool_Execute_Recursive_Pinned);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static double
+_elapsedSeconds(struct timeval *start)
+{
+    struct timeval end;
+    gettimeofday(&end, NULL);
+    timersub(&end, start, &end);
+    return end.tv_sec + end.tv_usec / 1000000.0;
+}
+
+LONGBOW_TEST_CASE(Performance, parcThreadPool_Execute_External)
+{
+    const int count = 20000;
+
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+    PARCAtomicUint64 *counter = parcAtomicUint64_Create(0);
+    PARCFutureTask *task = parcFutureTask_Create(_count, counter);
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < count; i++) {
+        parcThreadPool_Execute(pool, task);
+    }
+    parcThreadPool_Shutdown(pool);
+    parcThreadPool_AwaitTermination(pool, PARCTimeout_Never);
+    double seconds = _elapsedSeconds(&start);
+
+    printf("External: %d tasks in %.3f seconds, %.0f tasks/second\n", count, seconds, count / seconds);
+
+    parcFutureTask_Release(&task);
+    parcAtomicUint64_Release(&counter);
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Performance, parcThreadPool_Execute_Recursive)
+{
+    PARCThreadPool *pool = parcThreadPool_Create(4);
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    uint64_t count = _fanOutRun(pool, 17, 1);
+    double seconds = _elapsedSeconds(&start);
+
+    printf("Recursive: %" PRIu64 " tasks in %.3f seconds, %.0f tasks/second\n", count, seconds, count / seconds);
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Performance, parcThreadPool_Execute_Recursive_Pinned)
+{
+    // Keep every worker on the NUMA node of the thread that feeds the pool.
+    PARCBitVector *cpus = parcCpuTopology_GetNodeCpus(parcCpuTopology_GetNodeOfCpu(parcCpuTopology_GetCurrentCpu()));
+    PARCBitVector *cpuSets[] = { cpus, cpus, cpus, cpus };
+    PARCThreadPool *pool = parcThreadPool_CreateWithAffinity(4, cpuSets);
+    parcBitVector_Release(&cpus);
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    uint64_t count = _fanOutRun(pool, 17, 1);
+    double seconds = _elapsedSeconds(&start);
+
+    printf("Recursive, pinned: %" PRIu64 " tasks in %.3f seconds, %.0f tasks/second\n", count, seconds, count / seconds);
+
+    parcThreadPool_ShutdownNow(pool);
+    parcThreadPool_Release(&pool);
+}
+
 int
 main(int argc, char *argv[argc])
 {
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Glenn Scott, Computing Science Laboratory, PARC
+ * @copyright 2016, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include "../parc_WaitStrategy.c"
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/concurrent/parc_RingBuffer_1x1.h>
+
+#include <parc/testing/parc_MemoryTesting.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(parc_WaitStrategy)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
+    LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(parc_WaitStrategy)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(parc_WaitStrategy)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(CreateAcquireRelease)
+{
+    LONGBOW_RUN_TEST_CASE(CreateAcquireRelease, CreateRelease);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(CreateAcquireRelease)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(CreateAcquireRelease)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(CreateAcquireRelease, CreateRelease)
+{
+    PARCWaitStrategyKind kinds[] = { PARCWaitStrategyKind_BusySpin, PARCWaitStrategyKind_SpinThenYield, PARCWaitStrategyKind_Park };
+
+    for (int i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        PARCWaitStrategy *instance = parcWaitStrategy_Create(kinds[i]);
+        assertNotNull(instance, "Expected non-null result from parcWaitStrategy_Create();");
+        assertTrue(parcWaitStrategy_GetKind(instance) == kinds[i], "Expected kind %d, actual %d", kinds[i], parcWaitStrategy_GetKind(instance));
+
+        parcObjectTesting_AssertAcquireReleaseContract(parcWaitStrategy_Acquire, instance);
+
+        parcWaitStrategy_Release(&instance);
+        assertNull(instance, "Expected null result from parcWaitStrategy_Release();");
+    }
+}
+
+LONGBOW_TEST_FIXTURE(Specialization)
+{
+    LONGBOW_RUN_TEST_CASE(Specialization, parcWaitStrategy_Await_Immediate);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcWaitStrategy_Await_Timeout);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcWaitStrategy_Await_Signal);
+    LONGBOW_RUN_TEST_CASE(Specialization, parcWaitStrategy_Signal_NoSleepers);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Specialization)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Specialization)
+{
+    if (!parcMemoryTesting_ExpectedOutstanding(0, "%s leaked memory.", longBowTestCase_GetFullName(testCase))) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+typedef struct {
+    volatile bool ready;
+    volatile unsigned attempts;
+} _TestCondition;
+
+static bool
+_attempt(void *context)
+{
+    _TestCondition *condition = context;
+    condition->attempts++;
+    return __atomic_load_n(&condition->ready, __ATOMIC_ACQUIRE);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcWaitStrategy_Await_Immediate)
+{
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+
+    _TestCondition ready = { .ready = true };
+    assertTrue(parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _attempt, &ready, PARCTimeout_Never),
+               "Expected a successful attempt to return true");
+    assertTrue(ready.attempts == 1, "Expected a single attempt, actual %u", ready.attempts);
+
+    _TestCondition notReady = { .ready = false };
+    assertFalse(parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _attempt, &notReady, PARCTimeout_Immediate),
+                "Expected an immediate timeout to return false");
+    assertTrue(notReady.attempts == 1, "Expected a single attempt, actual %u", notReady.attempts);
+
+    parcWaitStrategy_Release(&strategy);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcWaitStrategy_Await_Timeout)
+{
+    PARCWaitStrategyKind kinds[] = { PARCWaitStrategyKind_BusySpin, PARCWaitStrategyKind_SpinThenYield, PARCWaitStrategyKind_Park };
+
+    for (int i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        PARCWaitStrategy *strategy = parcWaitStrategy_Create(kinds[i]);
+        _TestCondition condition = { .ready = false };
+
+        uint64_t start = parcTime_NowNanoseconds();
+        bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotFull, _attempt, &condition, parcTimeout_MilliSeconds(20));
+        uint64_t elapsed = parcTime_NowNanoseconds() - start;
+
+        assertFalse(result, "Expected kind %d to time out", kinds[i]);
+        assertTrue(elapsed >= 20000000, "Expected kind %d to wait at least 20 ms, actual %" PRIu64 " ns", kinds[i], elapsed);
+        assertTrue(elapsed < 2000000000, "Expected kind %d to stop soon after 20 ms, actual %" PRIu64 " ns", kinds[i], elapsed);
+
+        parcWaitStrategy_Release(&strategy);
+    }
+}
+
+typedef struct {
+    PARCWaitStrategy *strategy;
+    _TestCondition *condition;
+} _TestSignaller;
+
+static void *
+_signaller(void *context)
+{
+    _TestSignaller *signaller = context;
+
+    usleep(50000);
+    __atomic_store_n(&signaller->condition->ready, true, __ATOMIC_RELEASE);
+    parcWaitStrategy_Signal(signaller->strategy, PARCWaitStrategyCondition_NotEmpty);
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Specialization, parcWaitStrategy_Await_Signal)
+{
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+    _TestCondition condition = { .ready = false };
+    _TestSignaller signaller = { .strategy = strategy, .condition = &condition };
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, _signaller, &signaller);
+
+    bool result = parcWaitStrategy_Await(strategy, PARCWaitStrategyCondition_NotEmpty, _attempt, &condition, PARCTimeout_Never);
+    pthread_join(thread, NULL);
+
+    assertTrue(result, "Expected the signal to end the wait");
+    // Spinning or yielding for 50 ms would have made many thousands of attempts.
+    assertTrue(condition.attempts < 2 * (_PARCWaitStrategy_Spins + _PARCWaitStrategy_Yields),
+               "Expected the thread to have parked, but it made %u attempts", condition.attempts);
+
+    parcWaitStrategy_Release(&strategy);
+}
+
+LONGBOW_TEST_CASE(Specialization, parcWaitStrategy_Signal_NoSleepers)
+{
+    PARCWaitStrategy *strategy = parcWaitStrategy_Create(PARCWaitStrategyKind_Park);
+
+    parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotEmpty);
+    parcWaitStrategy_Signal(strategy, PARCWaitStrategyCondition_NotFull);
+
+    assertTrue(strategy->events[PARCWaitStrategyCondition_NotEmpty].sequence == 0, "Expected no wake-up without sleepers");
+    assertTrue(strategy->events[PARCWaitStrategyCondition_NotFull].sequence == 0, "Expected no wake-up without sleepers");
+
+    parcWaitStrategy_Release(&strategy);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, parcWaitStrategy_Latency);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+#define _LatencyItems 20000
+
+typedef struct {
+    PARCRingBuffer1x1 *ring;
+    PARCWaitStrategy *strategy;
+    uint64_t sent[_LatencyItems];
+    uint64_t latency[_LatencyItems];
+    uint64_t consumerCpu;
+} _TestLatency;
+
+static uint64_t
+_monotonicNanoseconds(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void *
+_latencyConsumer(void *context)
+{
+    _TestLatency *test = context;
+    uint64_t cpu = _monotonicNanoseconds(CLOCK_THREAD_CPUTIME_ID);
+
+    for (int i = 0; i < _LatencyItems; i++) {
+        uint64_t *sent;
+        parcRingBuffer1x1_GetWait(test->ring, (void **) &sent, test->strategy, PARCTimeout_Never);
+        test->latency[i] = _monotonicNanoseconds(CLOCK_MONOTONIC) - *sent;
+    }
+
+    test->consumerCpu = _monotonicNanoseconds(CLOCK_THREAD_CPUTIME_ID) - cpu;
+    return NULL;
+}
+
+static int
+_compareUint64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+LONGBOW_TEST_CASE(Performance, parcWaitStrategy_Latency)
+{
+    const char *names[] = { "BusySpin", "SpinThenYield", "Park" };
+
+    for (PARCWaitStrategyKind kind = PARCWaitStrategyKind_BusySpin; kind <= PARCWaitStrategyKind_Park; kind++) {
+        _TestLatency *test = malloc(sizeof(_TestLatency));
+        test->ring = parcRingBuffer1x1_Create(1024, NULL);
+        test->strategy = parcWaitStrategy_Create(kind);
+
+        pthread_t consumer;
+        pthread_create(&consumer, NULL, _latencyConsumer, test);
+
+        // Send an item every 20 microseconds or so, as a lightly loaded I/O thread would.
+        uint64_t start = _monotonicNanoseconds(CLOCK_MONOTONIC);
+        for (int i = 0; i < _LatencyItems; i++) {
+            usleep(20);
+            test->sent[i] = _monotonicNanoseconds(CLOCK_MONOTONIC);
+            parcRingBuffer1x1_PutWait(test->ring, &test->sent[i], test->strategy, PARCTimeout_Never);
+        }
+        pthread_join(consumer, NULL);
+        uint64_t elapsed = _monotonicNanoseconds(CLOCK_MONOTONIC) - start;
+
+        qsort(test->latency, _LatencyItems, sizeof(uint64_t), _compareUint64);
+        printf("%-13s latency usec p50 %8.1f  p90 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f  consumer CPU %5.1f%%\n",
+               names[kind],
+               test->latency[_LatencyItems / 2] / 1000.0,
+               test->latency[_LatencyItems * 9 / 10] / 1000.0,
+               test->latency[_LatencyItems * 99 / 100] / 1000.0,
+               test->latency[_LatencyItems * 999 / 1000] / 1000.0,
+               test->latency[_LatencyItems - 1] / 1000.0,
+               100.0 * test->consumerCpu / elapsed);
+
+        parcWaitStrategy_Release(&test->strategy);
+        parcRingBuffer1x1_Release(&test->ring);
+        free(test);
+    }
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(parc_WaitStrategy);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -39,6 +39,7 @@
 
 #include <config.h>
 #include <stdio.h>
+#include <pthread.h>
 
 #include <parc/security/parc_CryptoHasher.h>
 #include <parc/algol/parc_Buffer.h>
@@ -329,46 +330,6 @@ typedef struct crc32c_state {
     uint32_t crc32;
 } _CRC32CState;
 
-// =====================================
-// Hardware calculation
-
-#ifdef __SSE4_2__
-#include <nmmintrin.h>
-
-#ifdef __x86_64__
-// The length rounded to 8-bytes
-#define CRC_ROUNDING_MASK 0xFFFFFFFFFFFFFFF8ULL
-#define LARGEST_CRC_INTRINSIC _mm_crc32_u64
-#define CRC_CAST_TYPE uint64_t
-#else
-// The length rounded to 4-bytes
-#define CRC_ROUNDING_MASK 0xFFFFFFFCUL
-#define LARGEST_CRC_INTRINSIC _mm_crc32_u32
-#define CRC_CAST_TYPE uint32_t
-#endif //__x86_64__
-
-static uint32_t
-_crc32c_UpdateIntel(uint32_t crc, size_t len, uint8_t p[len])
-{
-    size_t blocks = len & CRC_ROUNDING_MASK;
-    size_t offset = 0;
-
-    while (offset < blocks) {
-        crc = (uint32_t) LARGEST_CRC_INTRINSIC((CRC_CAST_TYPE) crc, *(CRC_CAST_TYPE *) &p[offset]);
-        offset += sizeof(CRC_CAST_TYPE);
-    }
-
-    // now do the last bytes if it was not 8-byte aligned
-    size_t position = blocks;
-    while (position < len) {
-        crc = _mm_crc32_u8((uint32_t) crc, p[position]);
-        position++;
-    }
-
-    return crc;
-}
-#endif
-
 // =====================================
 // Software calculation
 
@@ -457,6 +418,211 @@ _crc32c_UpdateSoftware(uint32_t crc, size_t len, uint8_t p[len])
     return crc;
 }
 
+/*
+ * The tables for slicing-by-8.
+ * Entry [k][i] is the CRC of the byte i followed by k zero bytes, so eight table lookups consume eight bytes.
+ * The first table is `_crc32c_table`.
+ */
+static uint32_t _crc32c_slicingTable[8][256];
+
+static void
+_crc32c_InitializeSlicingTable(void)
+{
+    for (int i = 0; i < 256; i++) {
+        _crc32c_slicingTable[0][i] = _crc32c_table[i];
+    }
+    for (int k = 1; k < 8; k++) {
+        for (int i = 0; i < 256; i++) {
+            uint32_t previous = _crc32c_slicingTable[k - 1][i];
+            _crc32c_slicingTable[k][i] = (previous >> 8) ^ _crc32c_table[previous & 0xFF];
+        }
+    }
+}
+
+/*
+ * Update the CRC eight bytes at a time with table lookups (slicing-by-8).
+ * This is the calculation used when the processor has no CRC32C instruction.
+ */
+static uint32_t
+_crc32c_UpdateSlicing8(uint32_t crc, size_t len, uint8_t p[len])
+{
+    size_t position = 0;
+
+    while (len - position >= 8) {
+        const uint8_t *q = &p[position];
+        uint32_t low = crc ^ ((uint32_t) q[0] | ((uint32_t) q[1] << 8) | ((uint32_t) q[2] << 16) | ((uint32_t) q[3] << 24));
+        uint32_t high = (uint32_t) q[4] | ((uint32_t) q[5] << 8) | ((uint32_t) q[6] << 16) | ((uint32_t) q[7] << 24);
+
+        crc = _crc32c_slicingTable[7][low & 0xFF]
+              ^ _crc32c_slicingTable[6][(low >> 8) & 0xFF]
+              ^ _crc32c_slicingTable[5][(low >> 16) & 0xFF]
+              ^ _crc32c_slicingTable[4][low >> 24]
+              ^ _crc32c_slicingTable[3][high & 0xFF]
+              ^ _crc32c_slicingTable[2][(high >> 8) & 0xFF]
+              ^ _crc32c_slicingTable[1][(high >> 16) & 0xFF]
+              ^ _crc32c_slicingTable[0][high >> 24];
+        position += 8;
+    }
+
+    while (position < len) {
+        crc = (crc >> 8) ^ _crc32c_table[((uint8_t) (crc & 0xFF)) ^ p[position]];
+        position++;
+    }
+
+    return crc;
+}
+
+/*
+ * Return x^n modulo the CRC32C polynomial, in the bit-reflected representation of the CRC register.
+ */
+__attribute__((unused))
+static uint32_t
+_crc32c_PowerOfX(size_t n)
+{
+    uint32_t result = 0x80000000;   // x^0
+
+    for (size_t i = 0; i < n; i++) {
+        result = (result & 1) ? (result >> 1) ^ 0x82F63B78 : result >> 1;
+    }
+
+    return result;
+}
+
+// =====================================
+// Hardware calculation
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#include <string.h>
+
+#define _CRC32C_HARDWARE
+
+/*
+ * The interleaved calculation computes three independent CRCs over three adjacent lanes of the data,
+ * so that the latency of one crc32 instruction is hidden behind the other two.
+ * The three CRCs are then combined by shifting the earlier ones over the length of a lane with a carry-less multiply.
+ */
+#define _CRC32C_LONG_LANE 8192
+#define _CRC32C_SHORT_LANE 256
+
+static uint64_t _crc32c_longShift;
+static uint64_t _crc32c_shortShift;
+
+static inline uint64_t
+_crc32c_Load64(const uint8_t *p)
+{
+    uint64_t result;
+    memcpy(&result, p, sizeof(result));
+    return result;
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t
+_crc32c_UpdateIntel(uint32_t crc, size_t len, uint8_t p[len])
+{
+    size_t blocks = len & ~((size_t) 7);
+    size_t offset = 0;
+
+    uint64_t crc64 = crc;
+    while (offset < blocks) {
+        crc64 = _mm_crc32_u64(crc64, _crc32c_Load64(&p[offset]));
+        offset += sizeof(uint64_t);
+    }
+    crc = (uint32_t) crc64;
+
+    // now do the last bytes if it was not 8-byte aligned
+    size_t position = blocks;
+    while (position < len) {
+        crc = _mm_crc32_u8((uint32_t) crc, p[position]);
+        position++;
+    }
+
+    return crc;
+}
+
+/*
+ * Advance the CRC over a lane of zero bytes, given the shift constant for the lane's length.
+ *
+ * The carry-less product of the CRC and x^(8n - 33) is reduced by the crc32 instruction,
+ * which multiplies by a further x^33 (x^32 for the instruction, x for the reflected product).
+ */
+__attribute__((target("sse4.2,pclmul")))
+static inline uint32_t
+_crc32c_Shift(uint32_t crc, uint64_t shift)
+{
+    __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int) crc), _mm_cvtsi64_si128((long long) shift), 0x00);
+    return (uint32_t) _mm_crc32_u64(0, (uint64_t) _mm_cvtsi128_si64(product));
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static size_t
+_crc32c_UpdateLanes(uint32_t *crcPtr, const uint8_t *p, size_t len, size_t lane, uint64_t shift)
+{
+    size_t offset = 0;
+    uint64_t crc0 = *crcPtr;
+
+    while (len - offset >= 3 * lane) {
+        const uint8_t *q = &p[offset];
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        for (size_t i = 0; i < lane; i += 8) {
+            crc0 = _mm_crc32_u64(crc0, _crc32c_Load64(&q[i]));
+            crc1 = _mm_crc32_u64(crc1, _crc32c_Load64(&q[lane + i]));
+            crc2 = _mm_crc32_u64(crc2, _crc32c_Load64(&q[2 * lane + i]));
+        }
+        crc0 = _crc32c_Shift((uint32_t) crc0, shift) ^ crc1;
+        crc0 = _crc32c_Shift((uint32_t) crc0, shift) ^ crc2;
+        offset += 3 * lane;
+    }
+
+    *crcPtr = (uint32_t) crc0;
+    return offset;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t
+_crc32c_UpdateIntelInterleaved(uint32_t crc, size_t len, uint8_t p[len])
+{
+    if (len < 3 * _CRC32C_SHORT_LANE) {
+        return _crc32c_UpdateIntel(crc, len, p);
+    }
+
+    size_t offset = _crc32c_UpdateLanes(&crc, p, len, _CRC32C_LONG_LANE, _crc32c_longShift);
+    offset += _crc32c_UpdateLanes(&crc, &p[offset], len - offset, _CRC32C_SHORT_LANE, _crc32c_shortShift);
+
+    return _crc32c_UpdateIntel(crc, len - offset, &p[offset]);
+}
+#endif // __x86_64__ && __GNUC__
+
+static uint32_t (*_crc32c_UpdateImplementation)(uint32_t crc, size_t len, uint8_t p[len]);
+
+static pthread_once_t _crc32c_Once = PTHREAD_ONCE_INIT;
+
+/*
+ * Choose the fastest calculation the processor supports.
+ * Distribution builds are not compiled for a particular processor, so the choice is made at run time.
+ */
+static void
+_crc32c_Initialize(void)
+{
+    _crc32c_InitializeSlicingTable();
+    _crc32c_UpdateImplementation = _crc32c_UpdateSlicing8;
+
+#ifdef _CRC32C_HARDWARE
+    _crc32c_longShift = _crc32c_PowerOfX(8 * _CRC32C_LONG_LANE - 33);
+    _crc32c_shortShift = _crc32c_PowerOfX(8 * _CRC32C_SHORT_LANE - 33);
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        _crc32c_UpdateImplementation = _crc32c_UpdateIntel;
+        if (__builtin_cpu_supports("pclmul")) {
+            _crc32c_UpdateImplementation = _crc32c_UpdateIntelInterleaved;
+        }
+    }
+#endif
+}
+
 /**
  * Initializes the CRC32C value (init to 0xFFFFFFFF)
  */
@@ -484,12 +650,8 @@ _crc32c_Finalize(uint32_t crc)
 static uint32_t
 _crc32c_Update(uint32_t crc, size_t len, uint8_t p[len])
 {
-#ifdef __SSE4_2__
-    crc = _crc32c_UpdateIntel(crc, len, p);
-#else
-    crc = _crc32c_UpdateSoftware(crc, len, p);
-#endif
-    return crc;
+    pthread_once(&_crc32c_Once, _crc32c_Initialize);
+    return _crc32c_UpdateImplementation(crc, len, p);
 }
 
 /*
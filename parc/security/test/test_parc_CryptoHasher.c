@@ -76,7 +76,7 @@ LONGBOW_TEST_RUNNER(parc_CryptoHasher)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Local);
-//    LONGBOW_RUN_TEST_FIXTURE(Performance);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -308,6 +308,9 @@ LONGBOW_TEST_CASE(Global, parcCryptoHasher_CustomHasher)
 LONGBOW_TEST_FIXTURE(Local)
 {
     LONGBOW_RUN_TEST_CASE(Local, computeCrc32C_Software);
+    LONGBOW_RUN_TEST_CASE(Local, computeCrc32C_Slicing8);
+    LONGBOW_RUN_TEST_CASE(Local, computeCrc32C_Lengths);
+    LONGBOW_RUN_TEST_CASE(Local, computeCrc32C_Shift);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -338,12 +341,93 @@ LONGBOW_TEST_CASE(Local, computeCrc32C_Software)
     }
 }
 
+LONGBOW_TEST_CASE(Local, computeCrc32C_Slicing8)
+{
+    pthread_once(&_crc32c_Once, _crc32c_Initialize);
+
+    for (int i = 0; vectors[i].buffer != NULL; i++) {
+        uint32_t testCrc = _crc32c_Init();
+        testCrc = _crc32c_UpdateSlicing8(testCrc, vectors[i].length, vectors[i].buffer);
+        testCrc = _crc32c_Finalize(testCrc);
+
+        assertTrue(testCrc == vectors[i].crc32c,
+                   "CRC32C values wrong, index %d got 0x%08x expected 0x%08x\n",
+                   i, testCrc, vectors[i].crc32c);
+    }
+}
+
+/*
+ * Every calculation must agree with the byte-at-a-time software calculation,
+ * for lengths either side of each lane boundary and for unaligned data.
+ */
+LONGBOW_TEST_CASE(Local, computeCrc32C_Lengths)
+{
+    size_t lengths[] = {
+        0,                          1,                          7,                          8,                          9,
+        63,                         64,                         65,
+        3 * 256 - 1,                3 * 256,                    3 * 256 + 1,                3 * 256 + 8,
+        3 * 8192 - 1,               3 * 8192,                   3 * 8192 + 1,               3 * 8192 + 3 * 256 + 5,
+        2 * 3 * 8192 + 100
+    };
+    size_t maximum = 2 * 3 * 8192 + 100 + 8;
+
+    uint8_t *buffer = parcMemory_Allocate(maximum);
+    for (size_t i = 0; i < maximum; i++) {
+        buffer[i] = (uint8_t) (i * 33 + (i >> 8));
+    }
+
+    uint32_t (*implementations[])(uint32_t crc, size_t len, uint8_t p[len]) = {
+        _crc32c_Update,
+        _crc32c_UpdateSlicing8,
+#ifdef _CRC32C_HARDWARE
+        __builtin_cpu_supports("sse4.2") ? _crc32c_UpdateIntel : _crc32c_Update,
+        __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul") ? _crc32c_UpdateIntelInterleaved : _crc32c_Update,
+#endif
+    };
+
+    pthread_once(&_crc32c_Once, _crc32c_Initialize);
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        for (size_t offset = 0; offset < 8; offset += 3) {
+            uint32_t expected = _crc32c_UpdateSoftware(_crc32c_Init(), lengths[i], &buffer[offset]);
+            for (size_t j = 0; j < sizeof(implementations) / sizeof(implementations[0]); j++) {
+                uint32_t actual = implementations[j](_crc32c_Init(), lengths[i], &buffer[offset]);
+                assertTrue(actual == expected,
+                           "Implementation %zd wrong for length %zd at offset %zd, got 0x%08x expected 0x%08x",
+                           j, lengths[i], offset, actual, expected);
+            }
+        }
+    }
+
+    parcMemory_Deallocate(&buffer);
+}
+
+LONGBOW_TEST_CASE(Local, computeCrc32C_Shift)
+{
+#ifdef _CRC32C_HARDWARE
+    if (!__builtin_cpu_supports("sse4.2") || !__builtin_cpu_supports("pclmul")) {
+        testSkip("The processor does not support the CRC32 and PCLMULQDQ instructions.");
+    }
+
+    uint8_t zeros[64] = { 0 };
+
+    for (size_t length = 5; length <= sizeof(zeros); length++) {
+        uint32_t expected = _crc32c_UpdateSoftware(0x12345678, length, zeros);
+        uint32_t actual = _crc32c_Shift(0x12345678, _crc32c_PowerOfX(8 * length - 33));
+        assertTrue(actual == expected, "Shift over %zd zero bytes wrong, got 0x%08x expected 0x%08x", length, actual, expected);
+    }
+#else
+    testSkip("No hardware CRC32C calculation on this platform.");
+#endif
+}
+
 // =======================================================
 
-LONGBOW_TEST_FIXTURE(Performance)
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
 {
     LONGBOW_RUN_TEST_CASE(Performance, computeCrc32C);
     LONGBOW_RUN_TEST_CASE(Performance, computeCrc32C_Software);
+    LONGBOW_RUN_TEST_CASE(Performance, computeCrc32C_Throughput);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Performance)
@@ -408,6 +492,49 @@ LONGBOW_TEST_CASE(Performance, computeCrc32C_Software)
     printf("Best rate = %.3f for %d iterations\n", rate, maxreps);
 }
 
+static double
+runThroughput(size_t length, uint32_t (*update)(uint32_t crc, size_t len, uint8_t p[len]), uint8_t *buffer)
+{
+    size_t reps = (1024 * 1024 * 1024) / length;
+    uint32_t crc = _crc32c_Init();
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    for (size_t i = 0; i < reps; i++) {
+        crc = update(crc, length, buffer);
+    }
+    gettimeofday(&t1, NULL);
+    timersub(&t1, &t0, &t1);
+
+    double seconds = t1.tv_sec + t1.tv_usec * 1E-6;
+    return (double) reps * length / seconds / 1E9;
+}
+
+LONGBOW_TEST_CASE(Performance, computeCrc32C_Throughput)
+{
+    size_t lengths[] = { 64, 1024, 16 * 1024, 1024 * 1024 };
+    uint8_t *buffer = parcMemory_Allocate(1024 * 1024);
+    for (size_t i = 0; i < 1024 * 1024; i++) {
+        buffer[i] = (uint8_t) (i * 33);
+    }
+
+    pthread_once(&_crc32c_Once, _crc32c_Initialize);
+
+    printf("%10s %10s %10s %10s %12s (GB/s)\n", "length", "bytewise", "slicing-8", "crc32q", "interleaved");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        printf("%10zd %10.2f %10.2f", lengths[i],
+               runThroughput(lengths[i], _crc32c_UpdateSoftware, buffer),
+               runThroughput(lengths[i], _crc32c_UpdateSlicing8, buffer));
+#ifdef _CRC32C_HARDWARE
+        printf(" %10.2f %12.2f", runThroughput(lengths[i], _crc32c_UpdateIntel, buffer),
+               runThroughput(lengths[i], _crc32c_UpdateIntelInterleaved, buffer));
+#endif
+        printf("\n");
+    }
+
+    parcMemory_Deallocate(&buffer);
+}
+
 int
 main(int argc, char *argv[argc])
 {